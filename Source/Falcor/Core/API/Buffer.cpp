@@ -481,6 +481,9 @@ void* Buffer::map(MapType type)
             FALCOR_ASSERT(mBindFlags == BindFlags::None);
             void* pData = nullptr;
             FALCOR_GFX_CALL(mGfxBufferResource->map(nullptr, &pData));
+            // The null device never executes the copies into readback buffers, return zeros instead of stale host memory.
+            if (mpDevice->getType() == Device::Type::Null)
+                std::memset(pData, 0, mSize);
             return pData;
         }
         else
@@ -83,9 +83,13 @@ void CopyContext::flush(bool wait)
     }
 }
 
-CopyContext::ReadTextureTask::SharedPtr CopyContext::asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex)
+CopyContext::ReadTextureTask::SharedPtr CopyContext::asyncReadTextureSubresource(
+    const Texture* pTexture,
+    uint32_t subresourceIndex,
+    const Buffer::SharedPtr& pStagingBuffer
+)
 {
-    return CopyContext::ReadTextureTask::create(this, pTexture, subresourceIndex);
+    return CopyContext::ReadTextureTask::create(this, pTexture, subresourceIndex, pStagingBuffer);
 }
 
 std::vector<uint8_t> CopyContext::readTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex)
@@ -266,7 +270,8 @@ void CopyContext::updateTextureSubresources(
 CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(
     CopyContext* pCtx,
     const Texture* pTexture,
-    uint32_t subresourceIndex
+    uint32_t subresourceIndex,
+    const Buffer::SharedPtr& pStagingBuffer
 )
 {
     SharedPtr pThis = SharedPtr(new ReadTextureTask);
@@ -285,8 +290,11 @@ CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(
     uint64_t rowCount = (pTexture->getHeight(mipLevel) + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
     uint64_t size = pTexture->getDepth(mipLevel) * rowCount * pThis->mRowSize;
 
-    // Create buffer
-    pThis->mpBuffer = Buffer::create(pCtx->getDevice(), size, Buffer::BindFlags::None, Buffer::CpuAccess::Read, nullptr);
+    // Create buffer, unless the supplied staging buffer is large enough.
+    if (pStagingBuffer && pStagingBuffer->getCpuAccess() == Buffer::CpuAccess::Read && pStagingBuffer->getSize() >= size)
+        pThis->mpBuffer = pStagingBuffer;
+    else
+        pThis->mpBuffer = Buffer::create(pCtx->getDevice(), size, Buffer::BindFlags::None, Buffer::CpuAccess::Read, nullptr);
 
     // Copy from texture to buffer
     pCtx->resourceBarrier(pTexture, Resource::State::CopySource);
@@ -305,18 +313,23 @@ CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(
     );
     pCtx->setPendingCommands(true);
 
-    // Create a fence and signal
-    pThis->mpFence = GpuFence::create(pCtx->mpDevice);
+    // Submit the copy and remember the context fence value that signals its completion.
     pCtx->flush(false);
-    pThis->mpFence->gpuSignal(pCtx->getLowLevelData()->getCommandQueue());
+    pThis->mpFence = pCtx->getLowLevelData()->getFence();
+    pThis->mFenceValue = pThis->mpFence->getCpuValue() - 1;
     pThis->mRowCount = (uint32_t)rowCount;
     pThis->mDepth = pTexture->getDepth(mipLevel);
     return pThis;
 }
 
+bool CopyContext::ReadTextureTask::isReady() const
+{
+    return mpFence->getGpuValue() >= mFenceValue;
+}
+
 std::vector<uint8_t> CopyContext::ReadTextureTask::getData()
 {
-    mpFence->syncCpu();
+    mpFence->syncCpu(mFenceValue);
     // Get buffer data
     std::vector<uint8_t> result;
     result.resize((size_t)mRowCount * mActualRowSize);
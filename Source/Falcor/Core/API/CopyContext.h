@@ -48,12 +48,33 @@ public:
     {
     public:
         using SharedPtr = std::shared_ptr<ReadTextureTask>;
-        static SharedPtr create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex);
+        static SharedPtr create(
+            CopyContext* pCtx,
+            const Texture* pTexture,
+            uint32_t subresourceIndex,
+            const Buffer::SharedPtr& pStagingBuffer = nullptr
+        );
+
+        /**
+         * Check if the copy has completed, i.e. getData() will not block.
+         */
+        bool isReady() const;
+
+        /**
+         * Wait for the copy to complete and return the texel data, with rows tightly packed.
+         */
         std::vector<uint8_t> getData();
 
+        /**
+         * Get the staging buffer the texture is copied into.
+         * It can be passed to another task for reuse once getData() has returned.
+         */
+        const Buffer::SharedPtr& getStagingBuffer() const { return mpBuffer; }
+
     private:
         ReadTextureTask() = default;
         GpuFence::SharedPtr mpFence;
+        uint64_t mFenceValue;
         Buffer::SharedPtr mpBuffer;
         CopyContext* mpContext;
         uint32_t mRowCount;
@@ -164,8 +185,15 @@ public:
 
     /**
      * Read texture data Asynchronously
+     * @param[in] pTexture The texture to read.
+     * @param[in] subresourceIndex The subresource to read.
+     * @param[in] pStagingBuffer Optional readback buffer to copy into. A new buffer is created if it is null or too small.
      */
-    ReadTextureTask::SharedPtr asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex);
+    ReadTextureTask::SharedPtr asyncReadTextureSubresource(
+        const Texture* pTexture,
+        uint32_t subresourceIndex,
+        const Buffer::SharedPtr& pStagingBuffer = nullptr
+    );
 
     /**
      * Get the low-level context data
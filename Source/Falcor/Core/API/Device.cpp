@@ -297,6 +297,10 @@ inline gfx::DeviceType getGfxDeviceType(Device::Type deviceType)
         return gfx::DeviceType::DirectX12;
     case Device::Type::Vulkan:
         return gfx::DeviceType::Vulkan;
+    case Device::Type::CPU:
+    case Device::Type::Null:
+        // The null device uses the CPU backend for host memory resources, work is dropped before submission.
+        return gfx::DeviceType::CPU;
     default:
         throw RuntimeError("Unknown device type");
     }
@@ -479,16 +483,17 @@ bool Device::init()
     if (mDesc.enableDebugLayer)
         gfx::gfxEnableDebugLayer();
 
-    // Get list of available GPUs.
-    const auto gpus = getGPUs(mDesc.type);
+    // Get list of available GPUs. Host devices have no adapters to choose from.
+    const auto gpus = isHostDevice() ? std::vector<gfx::AdapterInfo>() : getGPUs(mDesc.type);
 
-    if (mDesc.gpu >= gpus.size())
+    if (!gpus.empty() && mDesc.gpu >= gpus.size())
     {
         logWarning("GPU index {} is out of range, using first GPU instead.", mDesc.gpu);
         mDesc.gpu = 0;
     }
 
     // Try to create device on specific GPU.
+    if (!gpus.empty())
     {
         desc.adapterLUID = &gpus[mDesc.gpu].luid;
         if (SLANG_FAILED(gfxCreateDevice(&desc, mGfxDevice.writeRef())))
@@ -533,7 +538,9 @@ bool Device::init()
 #endif
 
     mSupportedShaderModel = querySupportedShaderModel(mGfxDevice);
-    mGpuTimestampFrequency = 1000.0 / (double)mGfxDevice->getDeviceInfo().timestampFrequency;
+    // Host devices have no timestamp queries and reports a zero frequency.
+    const uint64_t timestampFrequency = mGfxDevice->getDeviceInfo().timestampFrequency;
+    mGpuTimestampFrequency = timestampFrequency > 0 ? 1000.0 / (double)timestampFrequency : 0.0;
 
 #if FALCOR_HAS_D3D12
     // Configure D3D12 validation layer.
@@ -880,6 +887,8 @@ FALCOR_SCRIPT_BINDING(Device)
     deviceType.value("Default", Device::Type::Default);
     deviceType.value("D3D12", Device::Type::D3D12);
     deviceType.value("Vulkan", Device::Type::Vulkan);
+    deviceType.value("CPU", Device::Type::CPU);
+    deviceType.value("Null", Device::Type::Null);
 
     ScriptBindings::SerializableStruct<Device::Desc> deviceDesc(m, "DeviceDesc");
 #define field(f_) field(#f_, &Device::Desc::f_)
@@ -78,12 +78,14 @@ public:
         Default, ///< Default device type, favors D3D12 over Vulkan.
         D3D12,
         Vulkan,
+        CPU, ///< Host device, runs compute programs on the CPU using Slang's host target. Graphics and ray tracing are not supported.
+        Null, ///< Host device that allocates resources in host memory and records commands without executing them. Readbacks return zeros.
     };
 
     /// Device descriptor.
     struct Desc
     {
-        /// The device type (D3D12/Vulkan).
+        /// The device type (D3D12/Vulkan/CPU/Null).
         Type type = Type::Default;
 
         /// GPU index (indexing into GPU list returned by getGPUList()).
@@ -207,6 +209,12 @@ public:
      */
     Type getType() const { return mDesc.type; }
 
+    /**
+     * Check if the device runs on the host (CPU or Null device type).
+     * Host devices support compute programs and resource operations only, there is no rasterization, ray tracing or presentation.
+     */
+    bool isHostDevice() const { return mDesc.type == Type::CPU || mDesc.type == Type::Null; }
+
     /**
      * Throws an exception if the device is not a D3D12 device.
      */
@@ -37,6 +37,14 @@ namespace Falcor
 GpuFence::GpuFence(std::shared_ptr<Device> pDevice, bool shared) : mpDevice(std::move(pDevice)), mCpuValue(1)
 {
     FALCOR_ASSERT(mpDevice);
+    // Host devices execute (or drop) command buffers synchronously on submission and have no fence objects.
+    // Fence values are tracked on the CPU only, see getGpuValue().
+    if (mpDevice->isHostDevice())
+    {
+        if (shared)
+            throw RuntimeError("Shared fences are not supported on host devices.");
+        return;
+    }
     gfx::IFence::Desc fenceDesc = {};
     fenceDesc.isShared = shared;
     FALCOR_GFX_CALL(mpDevice->getGfxDevice()->createFence(fenceDesc, mGfxFence.writeRef()));
@@ -58,6 +66,8 @@ uint64_t GpuFence::gpuSignal(CommandQueueHandle pQueue)
 
 void GpuFence::syncGpu(CommandQueueHandle pQueue)
 {
+    if (!mGfxFence)
+        return;
     gfx::IFence* fences[1]{mGfxFence.get()};
     auto waitValue = mCpuValue - 1;
     FALCOR_GFX_CALL(pQueue->waitForFenceValuesOnDevice(std::size(fences), fences, &waitValue));
@@ -65,6 +75,8 @@ void GpuFence::syncGpu(CommandQueueHandle pQueue)
 
 void GpuFence::syncCpu(std::optional<uint64_t> val)
 {
+    if (!mGfxFence)
+        return;
     auto waitValue = val ? val.value() : mCpuValue - 1;
     uint64_t currentValue = 0;
     FALCOR_GFX_CALL(mGfxFence->getCurrentValue(&currentValue));
@@ -77,6 +89,9 @@ void GpuFence::syncCpu(std::optional<uint64_t> val)
 
 uint64_t GpuFence::getGpuValue() const
 {
+    // Without a fence all submitted work has completed.
+    if (!mGfxFence)
+        return mCpuValue - 1;
     uint64_t currentValue = 0;
     FALCOR_GFX_CALL(mGfxFence->getCurrentValue(&currentValue));
     return currentValue;
@@ -84,11 +99,15 @@ uint64_t GpuFence::getGpuValue() const
 
 void GpuFence::setGpuValue(uint64_t val)
 {
+    if (!mGfxFence)
+        return;
     FALCOR_GFX_CALL(mGfxFence->setCurrentValue(val));
 }
 
 SharedResourceApiHandle GpuFence::getSharedApiHandle() const
 {
+    if (!mGfxFence)
+        return {};
     gfx::InteropHandle sharedHandle;
     FALCOR_GFX_CALL(mGfxFence->getSharedHandle(&sharedHandle));
     return (SharedResourceApiHandle)sharedHandle.handleValue;
@@ -96,6 +115,8 @@ SharedResourceApiHandle GpuFence::getSharedApiHandle() const
 
 NativeHandle GpuFence::getNativeHandle() const
 {
+    if (!mGfxFence)
+        return {};
     gfx::InteropHandle gfxNativeHandle = {};
     FALCOR_GFX_CALL(mGfxFence->getNativeHandle(&gfxNativeHandle));
 #if FALCOR_HAS_D3D12
@@ -58,7 +58,7 @@ public:
     static SharedPtr create(Device* pDevice, bool shared = false);
 
     /**
-     * Get the internal API handle
+     * Get the internal API handle. This is nullptr on host devices, which have no fence objects.
      */
     gfx::IFence* getGfxFence() const { return mGfxFence; }
 
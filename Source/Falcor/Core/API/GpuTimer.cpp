@@ -168,6 +168,7 @@ double GpuTimer::getElapsedTime()
         double end = (double)result[1];
         double range = end - start;
         mElapsedTime = range * mpDevice->getGpuTimestampFrequency();
+        mStartTime = start * mpDevice->getGpuTimestampFrequency();
         mDataPending = false;
     }
     return mElapsedTime;
@@ -81,6 +81,12 @@ public:
      */
     double getElapsedTime();
 
+    /**
+     * Get the GPU timestamp in milliseconds of the begin() call of the measurement last returned by getElapsedTime().
+     * Timestamps are only meaningful relative to other GPU timestamps of the same device.
+     */
+    double getStartTime() const { return mStartTime; }
+
 private:
     GpuTimer(std::shared_ptr<Device> pDevice);
 
@@ -97,6 +103,7 @@ private:
     uint32_t mStart = 0;
     uint32_t mEnd = 0;
     double mElapsedTime = 0.0;
+    double mStartTime = 0.0;
     bool mDataPending = false; ///< Set to true when resolved timings are available for readback.
 
     Buffer::SharedPtr mpResolveBuffer;        ///< GPU memory used as destination for resolving timestamp queries.
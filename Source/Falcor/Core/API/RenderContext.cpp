@@ -26,12 +26,14 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "RenderContext.h"
+#include "Device.h"
 #include "FBO.h"
 #include "Texture.h"
 #include "BlitContext.h"
 #include "RtAccelerationStructure.h"
 #include "GFXHelpers.h"
 #include "GFXAPI.h"
+#include "Core/Errors.h"
 #include "Core/State/GraphicsState.h"
 #include "Core/Program/ProgramVars.h"
 #include "Utils/Logger.h"
@@ -105,10 +107,17 @@ gfx::PrimitiveTopology getGFXPrimitiveTopology(Vao::Topology topology)
     }
 }
 
+/**
+ * Prepare a draw call and return the encoder to record it into.
+ * Returns nullptr on the null device, which has no graphics pipelines to record draws with.
+ */
 gfx::IRenderCommandEncoder* drawCallCommon(RenderContext* pContext, GraphicsState* pState, GraphicsVars* pVars)
 {
     static GraphicsStateObject* spLastGso = nullptr; // TODO: REMOVEGLOBAL
 
+    if (pContext->getDevice()->getType() == Device::Type::Null)
+        return nullptr;
+
     // Insert barriers for bound resources.
     pVars->prepareDescriptorSets(pContext);
 
@@ -190,7 +199,9 @@ gfx::AccelerationStructureCopyMode getGFXAcclerationStructureCopyMode(RenderCont
 
 RenderContext::RenderContext(Device* pDevice, gfx::ICommandQueue* pQueue) : ComputeContext(pDevice, pQueue)
 {
-    mpBlitContext = std::make_unique<BlitContext>(pDevice);
+    // Blits use a rasterization pass, which host devices don't support.
+    if (!pDevice->isHostDevice())
+        mpBlitContext = std::make_unique<BlitContext>(pDevice);
 }
 
 RenderContext::~RenderContext() {}
@@ -296,7 +307,13 @@ void RenderContext::blit(
     const float4 componentsTransform[4]
 )
 {
-    FALCOR_ASSERT(mpBlitContext);
+    if (!mpBlitContext)
+    {
+        // The null device drops blits like any other rasterization work.
+        if (mpDevice->getType() == Device::Type::Null)
+            return;
+        throw RuntimeError("Blits are not supported on the CPU device.");
+    }
     auto& blitCtx = *mpBlitContext;
 
     // Fetch textures from views.
@@ -503,6 +520,8 @@ void RenderContext::drawInstanced(
 )
 {
     auto encoder = drawCallCommon(this, pState, pVars);
+    if (!encoder)
+        return;
     encoder->drawInstanced(vertexCount, instanceCount, startVertexLocation, startInstanceLocation);
     mCommandsPending = true;
 }
@@ -510,6 +529,8 @@ void RenderContext::drawInstanced(
 void RenderContext::draw(GraphicsState* pState, GraphicsVars* pVars, uint32_t vertexCount, uint32_t startVertexLocation)
 {
     auto encoder = drawCallCommon(this, pState, pVars);
+    if (!encoder)
+        return;
     encoder->draw(vertexCount, startVertexLocation);
     mCommandsPending = true;
 }
@@ -525,6 +546,8 @@ void RenderContext::drawIndexedInstanced(
 )
 {
     auto encoder = drawCallCommon(this, pState, pVars);
+    if (!encoder)
+        return;
     encoder->drawIndexedInstanced(indexCount, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
     mCommandsPending = true;
 }
@@ -538,6 +561,8 @@ void RenderContext::drawIndexed(
 )
 {
     auto encoder = drawCallCommon(this, pState, pVars);
+    if (!encoder)
+        return;
     encoder->drawIndexed(indexCount, startIndexLocation, baseVertexLocation);
     mCommandsPending = true;
 }
@@ -554,6 +579,8 @@ void RenderContext::drawIndirect(
 {
     resourceBarrier(pArgBuffer, Resource::State::IndirectArg);
     auto encoder = drawCallCommon(this, pState, pVars);
+    if (!encoder)
+        return;
     encoder->drawIndirect(
         maxCommandCount, pArgBuffer->getGfxBufferResource(), argBufferOffset, pCountBuffer ? pCountBuffer->getGfxBufferResource() : nullptr,
         countBufferOffset
@@ -573,6 +600,8 @@ void RenderContext::drawIndexedIndirect(
 {
     resourceBarrier(pArgBuffer, Resource::State::IndirectArg);
     auto encoder = drawCallCommon(this, pState, pVars);
+    if (!encoder)
+        return;
     encoder->drawIndexedIndirect(
         maxCommandCount, pArgBuffer->getGfxBufferResource(), argBufferOffset, pCountBuffer ? pCountBuffer->getGfxBufferResource() : nullptr,
         countBufferOffset
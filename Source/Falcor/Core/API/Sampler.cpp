@@ -29,8 +29,12 @@
 #include "Device.h"
 #include "GFXAPI.h"
 #include "NativeHandleTraits.h"
+#include "Utils/Math/FNVHash.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
+#include <cmath>
+#include <limits>
+
 namespace Falcor
 {
 namespace
@@ -119,6 +123,38 @@ Sampler::~Sampler()
     mpDevice->releaseResource(mGfxSamplerState);
 }
 
+uint64_t Sampler::Desc::getHash() const
+{
+    // Hash the fields individually to not depend on padding bytes.
+    FNVHash64 hash;
+    auto insert = [&hash](const auto& value) { hash.insert(&value, sizeof(value)); };
+    // Floats compare equal for -0 and +0, so hash them by a canonical bit pattern. NaNs are canonicalized as well to
+    // keep the hash independent of the NaN payload.
+    auto insertFloat = [&insert](float value)
+    {
+        if (value == 0.f)
+            value = 0.f;
+        else if (std::isnan(value))
+            value = std::numeric_limits<float>::quiet_NaN();
+        insert(value);
+    };
+    insert(magFilter);
+    insert(minFilter);
+    insert(mipFilter);
+    insert(maxAnisotropy);
+    insertFloat(maxLod);
+    insertFloat(minLod);
+    insertFloat(lodBias);
+    insert(comparisonMode);
+    insert(reductionMode);
+    insert(addressModeU);
+    insert(addressModeV);
+    insert(addressModeW);
+    for (int i = 0; i < 4; ++i)
+        insertFloat(borderColor[i]);
+    return hash.get();
+}
+
 Sampler::SharedPtr Sampler::create(Device* pDevice, const Desc& desc)
 {
     return Sampler::SharedPtr(new Sampler(pDevice->shared_from_this(), desc));
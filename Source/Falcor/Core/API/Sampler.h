@@ -193,6 +193,11 @@ public:
          * Returns true if sampler descs are not identical.
          */
         bool operator!=(const Desc& other) const { return !(*this == other); }
+
+        /**
+         * Compute a hash of the sampler desc. Identical descs have the same hash.
+         */
+        uint64_t getHash() const;
     };
 
     Sampler(std::shared_ptr<Device> pDevice, const Desc& desc);
@@ -37,6 +37,7 @@
 #include "Utils/Threading.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/ImageIO.h"
+#include "Utils/Timing/Profiler.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "RenderGraph/BasePasses/FullScreenPass.h"
 
@@ -224,6 +225,8 @@ Texture::SharedPtr Texture::createFromFile(
     Texture::BindFlags bindFlags
 )
 {
+    FALCOR_PROFILE_CPU("Texture::createFromFile");
+
     std::filesystem::path fullPath;
     if (!findFileInDataDirectories(path, fullPath))
     {
@@ -0,0 +1,256 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FileWatcher.h"
+#include "Core/Assert.h"
+#include "Utils/Logger.h"
+
+#include <map>
+#include <set>
+#include <thread>
+
+#if FALCOR_LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace Falcor
+{
+
+namespace
+{
+
+/// Detects changes by comparing file modification times. Each watched file is checked once per query.
+class PollingFileWatcher : public FileWatcher
+{
+public:
+    bool watch(const std::filesystem::path& path) override
+    {
+        auto canonicalPath = getCanonicalPath(path);
+        mFiles.emplace(canonicalPath, queryState(canonicalPath));
+        return true;
+    }
+
+    void unwatch(const std::filesystem::path& path) override { mFiles.erase(getCanonicalPath(path)); }
+
+    std::vector<std::filesystem::path> getChangedFiles() override
+    {
+        std::vector<std::filesystem::path> changedFiles;
+        for (auto& [path, state] : mFiles)
+        {
+            FileState newState = queryState(path);
+            if (newState != state)
+            {
+                state = newState;
+                changedFiles.push_back(path);
+            }
+        }
+        return changedFiles;
+    }
+
+    void waitForChanges(std::chrono::milliseconds timeout) override { std::this_thread::sleep_for(timeout); }
+
+    Backend getBackend() const override { return Backend::Polling; }
+
+private:
+    struct FileState
+    {
+        bool exists = false;
+        std::filesystem::file_time_type time;
+
+        bool operator!=(const FileState& other) const { return exists != other.exists || time != other.time; }
+    };
+
+    static FileState queryState(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        FileState state;
+        state.time = std::filesystem::last_write_time(path, ec);
+        state.exists = !ec;
+        if (ec)
+            state.time = {};
+        return state;
+    }
+
+    std::map<std::filesystem::path, FileState> mFiles;
+};
+
+#if FALCOR_LINUX
+/**
+ * Uses inotify to get notified about changes. The parent directories of the watched files are watched,
+ * so that files replaced by a rename (as done by many editors when saving) are still reported.
+ */
+class InotifyFileWatcher : public FileWatcher
+{
+public:
+    InotifyFileWatcher() { mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC); }
+
+    ~InotifyFileWatcher() override
+    {
+        if (mFd >= 0)
+            close(mFd);
+    }
+
+    bool isValid() const { return mFd >= 0; }
+
+    bool watch(const std::filesystem::path& path) override
+    {
+        auto canonicalPath = getCanonicalPath(path);
+        if (mFiles.count(canonicalPath))
+            return true;
+
+        auto dir = canonicalPath.parent_path();
+        auto dirIt = mDirectories.find(dir);
+        if (dirIt == mDirectories.end())
+        {
+            int wd = inotify_add_watch(mFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+            if (wd < 0)
+            {
+                logWarning("FileWatcher: Failed to watch directory '{}' ({}).", dir, std::strerror(errno));
+                return false;
+            }
+            dirIt = mDirectories.emplace(dir, Directory{wd, 0}).first;
+            mWatchToDirectory[wd] = dir;
+        }
+        dirIt->second.fileCount++;
+        mFiles.insert(canonicalPath);
+        return true;
+    }
+
+    void unwatch(const std::filesystem::path& path) override
+    {
+        auto canonicalPath = getCanonicalPath(path);
+        if (mFiles.erase(canonicalPath) == 0)
+            return;
+
+        auto dirIt = mDirectories.find(canonicalPath.parent_path());
+        FALCOR_ASSERT(dirIt != mDirectories.end());
+        if (--dirIt->second.fileCount == 0)
+        {
+            inotify_rm_watch(mFd, dirIt->second.wd);
+            mWatchToDirectory.erase(dirIt->second.wd);
+            mDirectories.erase(dirIt);
+        }
+    }
+
+    std::vector<std::filesystem::path> getChangedFiles() override
+    {
+        std::set<std::filesystem::path> changedFiles;
+        bool overflow = false;
+
+        alignas(inotify_event) char buffer[16 * 1024];
+        while (true)
+        {
+            ssize_t length = read(mFd, buffer, sizeof(buffer));
+            if (length <= 0)
+                break; // EAGAIN when all events have been read.
+
+            for (char* ptr = buffer; ptr < buffer + length;)
+            {
+                const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + pEvent->len;
+
+                if (pEvent->mask & IN_Q_OVERFLOW)
+                {
+                    overflow = true;
+                    continue;
+                }
+                if (pEvent->mask & IN_IGNORED)
+                {
+                    // The directory was removed or unmounted. Its files can no longer be watched.
+                    mWatchToDirectory.erase(pEvent->wd);
+                    continue;
+                }
+                if (pEvent->len == 0)
+                    continue;
+
+                auto dirIt = mWatchToDirectory.find(pEvent->wd);
+                if (dirIt == mWatchToDirectory.end())
+                    continue;
+
+                auto path = dirIt->second / pEvent->name;
+                if (mFiles.count(path))
+                    changedFiles.insert(path);
+            }
+        }
+
+        // Events were lost, conservatively report all files.
+        if (overflow)
+            return std::vector<std::filesystem::path>(mFiles.begin(), mFiles.end());
+
+        return std::vector<std::filesystem::path>(changedFiles.begin(), changedFiles.end());
+    }
+
+    void waitForChanges(std::chrono::milliseconds timeout) override
+    {
+        pollfd fd = {mFd, POLLIN, 0};
+        poll(&fd, 1, (int)timeout.count());
+    }
+
+    Backend getBackend() const override { return Backend::Native; }
+
+private:
+    struct Directory
+    {
+        int wd;
+        uint32_t fileCount;
+    };
+
+    int mFd = -1;
+    std::set<std::filesystem::path> mFiles;
+    std::map<std::filesystem::path, Directory> mDirectories;
+    std::map<int, std::filesystem::path> mWatchToDirectory;
+};
+#endif // FALCOR_LINUX
+
+} // namespace
+
+FileWatcher::SharedPtr FileWatcher::create(Backend backend)
+{
+#if FALCOR_LINUX
+    if (backend != Backend::Polling)
+    {
+        auto pWatcher = std::make_shared<InotifyFileWatcher>();
+        if (pWatcher->isValid())
+            return pWatcher;
+        logWarning("FileWatcher: Failed to initialize inotify ({}). Falling back to polling.", std::strerror(errno));
+    }
+#endif
+    return std::make_shared<PollingFileWatcher>();
+}
+
+std::filesystem::path FileWatcher::getCanonicalPath(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    auto canonicalPath = std::filesystem::weakly_canonical(path, ec);
+    return ec ? path : canonicalPath;
+}
+
+} // namespace Falcor
@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include "Core/Macros.h"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Watches a set of files for modifications.
+ * Changes are queried with getChangedFiles(), which is cheap to call every frame.
+ * The native backend uses inotify on Linux and only does work when files actually change.
+ * The polling backend compares modification times and is available on all platforms.
+ */
+class FALCOR_API FileWatcher
+{
+public:
+    using SharedPtr = std::shared_ptr<FileWatcher>;
+
+    enum class Backend
+    {
+        Auto,    ///< Native backend if available on the platform, polling otherwise.
+        Native,  ///< Operating system file change notifications. Falls back to polling if not available.
+        Polling, ///< Compare file modification times when querying changes.
+    };
+
+    /**
+     * Create a file watcher.
+     * @param backend Backend to use.
+     * @return A new object.
+     */
+    static SharedPtr create(Backend backend = Backend::Auto);
+
+    virtual ~FileWatcher() = default;
+
+    /**
+     * Start watching a file. Watching a file more than once has no effect.
+     * @param path File path. Paths are made canonical, so different paths to the same file are reported under one name.
+     * @return True if successful.
+     */
+    virtual bool watch(const std::filesystem::path& path) = 0;
+
+    /**
+     * Stop watching a file.
+     * @param path File path.
+     */
+    virtual void unwatch(const std::filesystem::path& path) = 0;
+
+    /**
+     * Get the watched files that changed since the last call. A file is reported when its content was written,
+     * or when it was replaced, which is how many editors save files.
+     * @return List of canonical paths of changed files, without duplicates.
+     */
+    virtual std::vector<std::filesystem::path> getChangedFiles() = 0;
+
+    /**
+     * Block until changes may be available or the timeout elapses.
+     * @param timeout Maximum time to wait.
+     */
+    virtual void waitForChanges(std::chrono::milliseconds timeout) = 0;
+
+    /// Returns the backend used by this watcher (never Backend::Auto).
+    virtual Backend getBackend() const = 0;
+
+    /**
+     * Get the path under which a file is reported by getChangedFiles().
+     * @param path File path.
+     * @return Canonical path, or the path itself if it cannot be made canonical.
+     */
+    static std::filesystem::path getCanonicalPath(const std::filesystem::path& path);
+};
+
+} // namespace Falcor
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Core/Platform/OS.h"
+#include "Core/Platform/FileWatcher.h"
 #include "Core/Assert.h"
 #include "Core/GLFW.h"
 #include "Utils/Logger.h"
@@ -44,7 +45,10 @@
 #endif
 #include <dlfcn.h>
 
+#include <atomic>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -164,17 +168,61 @@ void terminateProcess(size_t processID)
     FALCOR_UNIMPLEMENTED();
 }
 
+struct FileMonitor
+{
+    std::thread thread;
+    std::atomic<bool> running{true};
+};
+
+static std::mutex sFileMonitorsMutex;
+static std::unordered_map<std::string, std::unique_ptr<FileMonitor>> sFileMonitors;
+
 void monitorFileUpdates(const std::filesystem::path& path, const std::function<void()>& callback)
 {
-    (void)path;
-    (void)callback;
-    FALCOR_UNIMPLEMENTED();
+    // Only have one thread watching a file.
+    closeSharedFile(path);
+
+    auto pMonitor = std::make_unique<FileMonitor>();
+    FileMonitor* pMonitorRaw = pMonitor.get();
+    pMonitor->thread = std::thread(
+        [pMonitorRaw, path, callback]()
+        {
+            auto pWatcher = FileWatcher::create(FileWatcher::Backend::Native);
+            if (!pWatcher->watch(path))
+            {
+                logError("Failed to monitor file '{}' for changes.", path);
+                return;
+            }
+
+            while (pMonitorRaw->running)
+            {
+                // Wake up regularly to check if monitoring was stopped.
+                pWatcher->waitForChanges(std::chrono::milliseconds(100));
+                if (!pWatcher->getChangedFiles().empty() && callback)
+                    callback();
+            }
+        }
+    );
+
+    std::lock_guard<std::mutex> lock(sFileMonitorsMutex);
+    sFileMonitors[path.string()] = std::move(pMonitor);
 }
 
 void closeSharedFile(const std::filesystem::path& path)
 {
-    (void)path;
-    FALCOR_UNIMPLEMENTED();
+    std::unique_ptr<FileMonitor> pMonitor;
+    {
+        std::lock_guard<std::mutex> lock(sFileMonitorsMutex);
+        auto it = sFileMonitors.find(path.string());
+        if (it == sFileMonitors.end())
+            return;
+        pMonitor = std::move(it->second);
+        sFileMonitors.erase(it);
+    }
+
+    pMonitor->running = false;
+    if (pMonitor->thread.joinable())
+        pMonitor->thread.join();
 }
 
 bool createJunction(const std::filesystem::path& link, const std::filesystem::path& target)
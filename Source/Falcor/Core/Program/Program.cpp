@@ -361,28 +361,6 @@ bool Program::setTypeConformances(const TypeConformanceList& conformances)
     return false;
 }
 
-bool Program::checkIfFilesChanged()
-{
-    if (mpActiveVersion == nullptr)
-    {
-        // We never linked, so nothing really changed
-        return false;
-    }
-
-    // Have any of the files we depend on changed?
-    for (auto& entry : mFileTimeMap)
-    {
-        auto& path = entry.first;
-        auto& modifiedTime = entry.second;
-
-        if (modifiedTime != getFileModifiedTime(path))
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
 const ProgramVersion::SharedConstPtr& Program::getActiveVersion() const
 {
     if (mLinkRequired)
@@ -390,16 +368,18 @@ const ProgramVersion::SharedConstPtr& Program::getActiveVersion() const
         const auto& it = mProgramVersions.find(mDefineList);
         if (it == mProgramVersions.end())
         {
+            // Use the version compiled in the background if there is one.
+            if (auto pVersion = mpDevice->getProgramManager()->takePrecompiledVersion(*this, mDefineList))
+            {
+                mpActiveVersion = pVersion;
+            }
             // Note that link() updates mActiveProgram only if the operation was successful.
             // On error we get false, and mActiveProgram points to the last successfully compiled version.
-            if (link() == false)
+            else if (link() == false)
             {
                 throw RuntimeError("Program linkage failed");
             }
-            else
-            {
-                mProgramVersions[mDefineList] = mpActiveVersion;
-            }
+            mProgramVersions[mDefineList] = mpActiveVersion;
         }
         else
         {
@@ -440,12 +420,34 @@ bool Program::link() const
     }
 }
 
+void Program::invalidateVersion(const ProgramVersion* pVersion)
+{
+    for (auto it = mProgramVersions.begin(); it != mProgramVersions.end();)
+    {
+        if (it->second.get() == pVersion)
+            it = mProgramVersions.erase(it);
+        else
+            ++it;
+    }
+
+    if (mpActiveVersion.get() == pVersion)
+    {
+        mpActiveVersion = nullptr;
+        mLinkRequired = true;
+    }
+
+    std::lock_guard<std::mutex> lock(mSourceHashMutex);
+    mSourceHash.clear();
+}
+
 void Program::reset()
 {
     mpActiveVersion = nullptr;
     mProgramVersions.clear();
-    mFileTimeMap.clear();
     mLinkRequired = true;
+
+    std::lock_guard<std::mutex> lock(mSourceHashMutex);
+    mSourceHash.clear();
 }
 
 FALCOR_SCRIPT_BINDING(Program)
@@ -35,6 +35,7 @@
 #include <string_view>
 #include <string>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -411,15 +412,19 @@ protected:
     mutable bool mLinkRequired = true;
     mutable std::map<DefineList, ProgramVersion::SharedConstPtr> mProgramVersions;
     mutable ProgramVersion::SharedConstPtr mpActiveVersion;
+
+    // Hash of the source files, computed by ProgramManager::getProgramCacheKey(). Cleared when the sources may have changed.
+    mutable std::string mSourceHash;
+    mutable std::mutex mSourceHashMutex;
+
     void markDirty() { mLinkRequired = true; }
 
     std::string getProgramDescString() const;
 
-    using string_time_map = std::unordered_map<std::string, time_t>;
-    mutable string_time_map mFileTimeMap;
-
-    bool checkIfFilesChanged();
     void reset();
+
+    /// Remove a compiled version, e.g. because its source files changed. It will be recompiled when used next.
+    void invalidateVersion(const ProgramVersion* pVersion);
 };
 
 } // namespace Falcor
@@ -28,13 +28,41 @@
 #include "ProgramManager.h"
 #include "Core/API/Device.h"
 #include "Core/Platform/OS.h"
+#include "Core/Platform/FileWatcher.h"
+#include "Utils/CryptoUtils.h"
 #include "Utils/Timing/CpuTimer.h"
 
 #include <slang.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <set>
 
 namespace Falcor
 {
 
+namespace
+{
+const char kVariantCacheFilename[] = "program_variants.json";
+const uint32_t kVariantCacheVersion = 2;
+const size_t kMaxCachedPrograms = 4096;
+const size_t kMaxCachedVariantsPerProgram = 256;
+
+/// Hash a string followed by a terminator, so that consecutive strings can't alias.
+void updateString(SHA1& sha1, std::string_view str)
+{
+    sha1.update(str);
+    sha1.update(uint8_t(0));
+}
+
+int64_t getUnixTime()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
 inline SlangStage getSlangStage(ShaderType type)
 {
     switch (type)
@@ -99,14 +127,42 @@ inline bool doSlangReflection(
     return true;
 }
 
-ProgramManager::ProgramManager(std::weak_ptr<Device> pDevice) : mpDevice(pDevice) {}
+ProgramManager::ProgramManager(std::weak_ptr<Device> pDevice) : mpDevice(pDevice), mpFileWatcher(FileWatcher::create())
+{
+    auto pLockedDevice = mpDevice.lock();
+    FALCOR_ASSERT(pLockedDevice);
+    const auto& shaderCachePath = pLockedDevice->getDesc().shaderCachePath;
+    if (!shaderCachePath.empty())
+    {
+        mVariantCachePath = std::filesystem::path(shaderCachePath) / kVariantCacheFilename;
+        loadVariantCache();
+    }
+}
+
+ProgramManager::~ProgramManager()
+{
+    waitForPrecompilation();
+    saveVariantCache();
+}
 
 ProgramVersion::SharedPtr ProgramManager::createProgramVersion(const Program& program, std::string& log) const
+{
+    auto pDevice = mpDevice.lock();
+    FALCOR_ASSERT(pDevice);
+    return createProgramVersion(program, program.getDefineList(), pDevice->getSlangGlobalSession(), log);
+}
+
+ProgramVersion::SharedPtr ProgramManager::createProgramVersion(
+    const Program& program,
+    const Program::DefineList& defineList,
+    slang::IGlobalSession* pSlangGlobalSession,
+    std::string& log
+) const
 {
     CpuTimer timer;
     timer.update();
 
-    auto pSlangRequest = createSlangCompileRequest(program);
+    auto pSlangRequest = createSlangCompileRequest(program, defineList, pSlangGlobalSession, log);
     if (pSlangRequest == nullptr)
         return nullptr;
 
@@ -148,12 +204,13 @@ ProgramVersion::SharedPtr ProgramManager::createProgramVersion(const Program& pr
     }
 
     // Extract list of files referenced, for dependency-tracking purposes.
+    std::vector<std::string> depFilePaths;
     int depFileCount = spGetDependencyFileCount(pSlangRequest);
     for (int ii = 0; ii < depFileCount; ++ii)
     {
         std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
         if (std::filesystem::exists(depFilePath))
-            program.mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
+            depFilePaths.push_back(std::move(depFilePath));
     }
 
     // Note: the `ProgramReflection` needs to be able to refer back to the
@@ -189,13 +246,19 @@ ProgramVersion::SharedPtr ProgramManager::createProgramVersion(const Program& pr
     }
 
     auto descStr = program.getProgramDescString();
-    pVersion->init(program.getDefineList(), pReflector, descStr, pSlangEntryPoints);
+    pVersion->init(defineList, pReflector, descStr, pSlangEntryPoints);
+
+    registerVersionDependencies(pVersion, depFilePaths);
+    recordProgramVariant(program, defineList);
 
     timer.update();
     double time = timer.delta();
-    mCompilationStats.programVersionCount++;
-    mCompilationStats.programVersionTotalTime += time;
-    mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
+    {
+        std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
+        mCompilationStats.programVersionCount++;
+        mCompilationStats.programVersionTotalTime += time;
+        mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
+    }
     logDebug("Created program version in {:.3f} s: {}", timer.delta(), descStr);
 
     return pVersion;
@@ -214,6 +277,9 @@ ProgramKernels::SharedPtr ProgramManager::createProgramKernels(
     CpuTimer timer;
     timer.update();
 
+    // Versions compiled on a worker thread share their Slang session with the workers.
+    auto slangSessionLock = programVersion.lockSlangSession();
+
     auto pSlangGlobalScope = programVersion.getSlangGlobalScope();
     auto pSlangSession = pSlangGlobalScope->getSession();
 
@@ -479,9 +545,12 @@ ProgramKernels::SharedPtr ProgramManager::createProgramKernels(
 
     timer.update();
     double time = timer.delta();
-    mCompilationStats.programKernelsCount++;
-    mCompilationStats.programKernelsTotalTime += time;
-    mCompilationStats.programKernelsMaxTime = std::max(mCompilationStats.programKernelsMaxTime, time);
+    {
+        std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
+        mCompilationStats.programKernelsCount++;
+        mCompilationStats.programKernelsTotalTime += time;
+        mCompilationStats.programKernelsMaxTime = std::max(mCompilationStats.programKernelsMaxTime, time);
+    }
     logDebug("Created program kernels in {:.3f} s: {}", time, descStr);
 
     return pProgramKernels;
@@ -530,12 +599,139 @@ EntryPointGroupKernels::SharedPtr ProgramManager::createEntryPointGroupKernels(
 void ProgramManager::registerProgramForReload(const Program::SharedPtr& pProg)
 {
     mLoadedPrograms.push_back(pProg);
+
+    // Start compiling the versions of the program that were used in previous runs.
+    if (!mVariantCachePath.empty() && Threading::isStarted())
+    {
+        auto key = getProgramCacheKey(*pProg);
+        std::vector<Program::DefineList> defineLists;
+        {
+            std::lock_guard<std::mutex> lock(mVariantCacheMutex);
+            auto it = mVariantCache.find(key);
+            if (it != mVariantCache.end())
+                defineLists = it->second.defineLists;
+        }
+        if (!defineLists.empty())
+        {
+            logDebug("Precompiling {} cached version(s) of program: {}", defineLists.size(), pProg->getProgramDescString());
+            precompileProgramVersions(pProg, defineLists);
+        }
+    }
+}
+
+void ProgramManager::registerVersionDependencies(const ProgramVersion::SharedPtr& pVersion, const std::vector<std::string>& files) const
+{
+    std::lock_guard<std::mutex> lock(mFileWatcherMutex);
+    for (const auto& file : files)
+    {
+        auto path = FileWatcher::getCanonicalPath(file);
+        auto& versions = mFileToVersions[path];
+        // Drop versions that have been deleted, so the list only grows with the number of live versions.
+        versions.erase(
+            std::remove_if(versions.begin(), versions.end(), [](const auto& pWeakVersion) { return pWeakVersion.expired(); }),
+            versions.end()
+        );
+        if (versions.empty())
+            mpFileWatcher->watch(path);
+        versions.push_back(pVersion);
+    }
+}
+
+void ProgramManager::pruneVersionDependencies() const
+{
+    for (auto it = mFileToVersions.begin(); it != mFileToVersions.end();)
+    {
+        auto& versions = it->second;
+        versions.erase(
+            std::remove_if(versions.begin(), versions.end(), [](const auto& pWeakVersion) { return pWeakVersion.expired(); }),
+            versions.end()
+        );
+        // Stop watching files that no live version depends on.
+        if (versions.empty())
+        {
+            mpFileWatcher->unwatch(it->first);
+            it = mFileToVersions.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool ProgramManager::reloadChangedPrograms()
+{
+    bool hasReloaded = false;
+    std::set<const ProgramVersion*> invalidatedVersions;
+    // Versions released here are destroyed after the locks are released, because destroying a version waits for its Slang
+    // session, which may be held by a worker that is waiting for mFileWatcherMutex.
+    std::vector<ProgramVersion::SharedConstPtr> releasedVersions;
+    std::vector<std::shared_ptr<PrecompiledVersion>> releasedEntries;
+
+    std::lock_guard<std::mutex> lock(mFileWatcherMutex);
+    auto changedFiles = mpFileWatcher->getChangedFiles();
+    if (changedFiles.empty())
+        return false;
+
+    for (const auto& path : changedFiles)
+    {
+        auto it = mFileToVersions.find(path);
+        if (it == mFileToVersions.end())
+            continue;
+
+        logInfo("Shader file changed: {}", path);
+
+        // Invalidate the versions that were compiled from the file. They register their dependencies again when recompiled.
+        for (const auto& pWeakVersion : it->second)
+        {
+            auto pVersion = pWeakVersion.lock();
+            if (!pVersion)
+                continue;
+            releasedVersions.push_back(pVersion);
+            if (auto pProgram = pVersion->getProgram())
+            {
+                pProgram->invalidateVersion(pVersion.get());
+                hasReloaded = true;
+            }
+            invalidatedVersions.insert(pVersion.get());
+        }
+        it->second.clear();
+    }
+
+    // Invalidated versions register again when recompiled. Forget everything else that is gone.
+    pruneVersionDependencies();
+
+    // Precompiled versions that have not been used yet are stale as well.
+    if (!invalidatedVersions.empty())
+    {
+        std::lock_guard<std::mutex> precompileLock(mPrecompileMutex);
+        auto it = std::stable_partition(
+            mPrecompiledVersions.begin(), mPrecompiledVersions.end(),
+            [&](const auto& pEntry) { return pEntry->task.isRunning() || invalidatedVersions.count(pEntry->pVersion.get()) == 0; }
+        );
+        releasedEntries.assign(std::make_move_iterator(it), std::make_move_iterator(mPrecompiledVersions.end()));
+        mPrecompiledVersions.erase(it, mPrecompiledVersions.end());
+    }
+
+    return hasReloaded;
 }
 
 bool ProgramManager::reloadAllPrograms(bool forceReload)
 {
+    // Only programs depending on changed files need to be reloaded, which the file watcher tracks for us.
+    if (!forceReload)
+        return reloadChangedPrograms();
+
     bool hasReloaded = false;
 
+    // Precompiled versions are compiled with the old settings.
+    discardPrecompiledVersions();
+
+    {
+        std::lock_guard<std::mutex> lock(mFileWatcherMutex);
+        pruneVersionDependencies();
+    }
+
     // The `mLoadedPrograms` array stores weak pointers, and we will
     // use this step as a chance to clean up the contents of
     // the array that might have changed to `nullptr` because
@@ -566,16 +762,7 @@ bool ProgramManager::reloadAllPrograms(bool forceReload)
         //
         *writeIter++ = pProgram;
 
-        // Next we check if any of the files that affected the
-        // compilation of `pProgram` has been changed. If not,
-        // we can skip further processing of this program
-        // (unless forceReload flag is set).
-        //
-        if (!(pProgram->checkIfFilesChanged() || forceReload))
-            continue;
-
-        // If any files have changed, then we need to reset
-        // the caches of compiled information for the program.
+        // Reset the caches of compiled information for the program.
         //
         pProgram->reset();
 
@@ -594,20 +781,341 @@ bool ProgramManager::reloadAllPrograms(bool forceReload)
     return hasReloaded;
 }
 
+void ProgramManager::precompileProgramVersions(const Program::SharedPtr& pProgram, const std::vector<Program::DefineList>& defineLists)
+{
+    FALCOR_ASSERT(pProgram);
+    if (!Threading::isStarted())
+        return;
+
+    std::lock_guard<std::mutex> lock(mPrecompileMutex);
+
+    // Drop versions of programs that have been deleted in the meantime.
+    mPrecompiledVersions.erase(
+        std::remove_if(
+            mPrecompiledVersions.begin(), mPrecompiledVersions.end(),
+            [](const auto& pEntry) { return pEntry->pProgram.expired() && !pEntry->task.isRunning(); }
+        ),
+        mPrecompiledVersions.end()
+    );
+
+    std::vector<std::shared_ptr<PrecompiledVersion>> entries;
+    for (const auto& defineList : defineLists)
+    {
+        if (pProgram->mProgramVersions.count(defineList) > 0)
+            continue;
+        auto isSame = [&](const auto& pEntry) { return pEntry->pProgram.lock() == pProgram && pEntry->defineList == defineList; };
+        if (std::any_of(mPrecompiledVersions.begin(), mPrecompiledVersions.end(), isSame) || std::any_of(entries.begin(), entries.end(), isSame))
+            continue;
+
+        auto pEntry = std::make_shared<PrecompiledVersion>();
+        pEntry->pProgram = pProgram;
+        pEntry->defineList = defineList;
+        entries.push_back(std::move(pEntry));
+    }
+    if (entries.empty())
+        return;
+
+    // All programs share one Slang global session per worker thread. Global sessions are expensive to create (they load the
+    // Slang standard library), so they are created on first use and kept for the lifetime of the program manager.
+    if (mWorkerSlangSessions.empty())
+        mWorkerSlangSessions.resize(std::max<size_t>(1, Threading::getThreadCount()));
+
+    for (auto& pEntry : entries)
+    {
+        const size_t preferredSession = mNextWorkerSlangSession++ % mWorkerSlangSessions.size();
+        pEntry->task = Threading::dispatchTask(
+            [this, pEntry, preferredSession]()
+            {
+                // Keep the program alive while compiling, but skip programs that have been deleted already.
+                auto pProgram = pEntry->pProgram.lock();
+                if (!pProgram)
+                    return;
+
+                // Slang sessions must not be used concurrently. Use an idle session if there is one, otherwise wait for one.
+                // The lock is also taken by the compiled versions when they use the session, e.g. for linking kernels.
+                WorkerSlangSession* pSession = nullptr;
+                std::unique_lock<std::mutex> lock;
+                for (auto& session : mWorkerSlangSessions)
+                {
+                    lock = std::unique_lock<std::mutex>(*session.pMutex, std::try_to_lock);
+                    if (lock.owns_lock())
+                    {
+                        pSession = &session;
+                        break;
+                    }
+                }
+                if (!pSession)
+                {
+                    pSession = &mWorkerSlangSessions[preferredSession];
+                    lock = std::unique_lock<std::mutex>(*pSession->pMutex);
+                }
+
+                try
+                {
+                    if (!pSession->pGlobalSession)
+                        pSession->pGlobalSession = createWorkerSlangSession();
+                    pEntry->pVersion = createProgramVersion(*pProgram, pEntry->defineList, pSession->pGlobalSession, pEntry->log);
+                    if (pEntry->pVersion)
+                        pEntry->pVersion->mpSlangSessionMutex = pSession->pMutex;
+                }
+                catch (const std::exception& e)
+                {
+                    pEntry->pVersion = nullptr;
+                    pEntry->log += e.what();
+                }
+            }
+        );
+        mPrecompiledVersions.push_back(pEntry);
+    }
+}
+
+void ProgramManager::waitForPrecompilation()
+{
+    std::vector<std::shared_ptr<PrecompiledVersion>> entries;
+    {
+        std::lock_guard<std::mutex> lock(mPrecompileMutex);
+        entries = mPrecompiledVersions;
+    }
+    for (const auto& pEntry : entries)
+        pEntry->task.finish();
+}
+
+ProgramVersion::SharedPtr ProgramManager::takePrecompiledVersion(const Program& program, const Program::DefineList& defineList)
+{
+    std::shared_ptr<PrecompiledVersion> pEntry;
+    {
+        std::lock_guard<std::mutex> lock(mPrecompileMutex);
+        auto it = std::find_if(
+            mPrecompiledVersions.begin(), mPrecompiledVersions.end(),
+            [&](const auto& pEntry) { return pEntry->pProgram.lock().get() == &program && pEntry->defineList == defineList; }
+        );
+        if (it == mPrecompiledVersions.end())
+            return nullptr;
+        pEntry = *it;
+        mPrecompiledVersions.erase(it);
+    }
+
+    pEntry->task.finish();
+
+    // On failure the program is compiled again on the calling thread, which reports the errors.
+    if (pEntry->pVersion && !pEntry->log.empty())
+    {
+        std::string warn = "Warnings in program:\n" + program.getProgramDescString() + "\n" + pEntry->log;
+        logWarning(warn);
+    }
+    return pEntry->pVersion;
+}
+
+void ProgramManager::discardPrecompiledVersions()
+{
+    std::vector<std::shared_ptr<PrecompiledVersion>> entries;
+    {
+        std::lock_guard<std::mutex> lock(mPrecompileMutex);
+        entries.swap(mPrecompiledVersions);
+    }
+    for (const auto& pEntry : entries)
+        pEntry->task.finish();
+}
+
+Slang::ComPtr<slang::IGlobalSession> ProgramManager::createWorkerSlangSession()
+{
+    Slang::ComPtr<slang::IGlobalSession> pSession;
+    if (SLANG_FAILED(slang::createGlobalSession(pSession.writeRef())))
+        throw RuntimeError("Failed to create Slang global session.");
+    return pSession;
+}
+
+std::string ProgramManager::getProgramCacheKey(const Program& program) const
+{
+    auto pDevice = mpDevice.lock();
+    FALCOR_ASSERT(pDevice);
+
+    SHA1 sha1;
+
+    const auto& desc = program.mDesc;
+    sha1.update(uint32_t(pDevice->getType()));
+    updateString(sha1, desc.mShaderModel);
+    sha1.update(uint32_t(desc.getCompilerFlags()));
+    updateString(sha1, desc.mLanguagePrelude);
+    for (const auto& arg : desc.mCompilerArguments)
+        updateString(sha1, arg);
+
+    // Hash the contents of the source files, so that editing a shader invalidates its cached variants.
+    // The files are only read once per program, until the program is reloaded.
+    {
+        std::lock_guard<std::mutex> lock(program.mSourceHashMutex);
+        if (program.mSourceHash.empty())
+        {
+            SHA1 sourceSha1;
+            for (const auto& src : desc.mSources)
+            {
+                sourceSha1.update(src.source.createTranslationUnit);
+                if (src.getType() == Program::ShaderModule::Type::File)
+                {
+                    updateString(sourceSha1, src.source.filePath.generic_string());
+                    std::filesystem::path fullPath;
+                    if (findFileInShaderDirectories(src.source.filePath, fullPath))
+                        updateString(sourceSha1, readFile(fullPath));
+                }
+                else
+                {
+                    updateString(sourceSha1, src.source.moduleName);
+                    updateString(sourceSha1, src.source.modulePath);
+                    updateString(sourceSha1, src.source.str);
+                }
+            }
+            program.mSourceHash = SHA1::toString(sourceSha1.finalize());
+        }
+        updateString(sha1, program.mSourceHash);
+    }
+
+    for (const auto& entryPoint : desc.mEntryPoints)
+    {
+        sha1.update(uint32_t(entryPoint.stage));
+        updateString(sha1, entryPoint.name);
+        updateString(sha1, entryPoint.exportName);
+        sha1.update(entryPoint.sourceIndex);
+        sha1.update(entryPoint.groupIndex);
+    }
+
+    // Settings applied to all programs.
+    for (const auto& [name, value] : mGlobalDefineList)
+    {
+        updateString(sha1, name);
+        updateString(sha1, value);
+    }
+    sha1.update(uint32_t(mForcedCompilerFlags.enabled));
+    sha1.update(uint32_t(mForcedCompilerFlags.disabled));
+    sha1.update(mGenerateDebugInfo);
+
+    return SHA1::toString(sha1.finalize());
+}
+
+void ProgramManager::recordProgramVariant(const Program& program, const Program::DefineList& defineList) const
+{
+    if (mVariantCachePath.empty())
+        return;
+
+    auto key = getProgramCacheKey(program);
+
+    std::lock_guard<std::mutex> lock(mVariantCacheMutex);
+    auto& variants = mVariantCache[key];
+    if (variants.name.empty())
+        variants.name = program.getProgramDescString();
+    variants.lastUsed = getUnixTime();
+    auto& defineLists = variants.defineLists;
+    if (std::find(defineLists.begin(), defineLists.end(), defineList) == defineLists.end() &&
+        defineLists.size() < kMaxCachedVariantsPerProgram)
+    {
+        defineLists.push_back(defineList);
+    }
+    mVariantCacheDirty = true;
+}
+
+void ProgramManager::loadVariantCache()
+{
+    if (!std::filesystem::exists(mVariantCachePath))
+        return;
+
+    try
+    {
+        std::ifstream ifs(mVariantCachePath);
+        auto json = nlohmann::json::parse(ifs);
+        if (json.value("version", 0u) != kVariantCacheVersion)
+            return;
+
+        for (const auto& jsonProgram : json.at("programs"))
+        {
+            CachedProgramVariants variants;
+            variants.name = jsonProgram.value("name", "");
+            variants.lastUsed = jsonProgram.value("lastUsed", int64_t(0));
+            for (const auto& jsonDefineList : jsonProgram.at("defines"))
+            {
+                Program::DefineList defineList;
+                for (const auto& [name, value] : jsonDefineList.items())
+                    defineList.add(name, value.get<std::string>());
+                variants.defineLists.push_back(std::move(defineList));
+            }
+            mVariantCache[jsonProgram.at("key").get<std::string>()] = std::move(variants);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to load program variant cache '{}': {}", mVariantCachePath, e.what());
+        mVariantCache.clear();
+    }
+}
+
+void ProgramManager::saveVariantCache() const
+{
+    std::lock_guard<std::mutex> lock(mVariantCacheMutex);
+    if (mVariantCachePath.empty() || !mVariantCacheDirty)
+        return;
+
+    // Only keep the most recently used programs.
+    std::vector<decltype(mVariantCache)::const_iterator> programs;
+    for (auto it = mVariantCache.begin(); it != mVariantCache.end(); ++it)
+        programs.push_back(it);
+    std::sort(programs.begin(), programs.end(), [](const auto& a, const auto& b) { return a->second.lastUsed > b->second.lastUsed; });
+    if (programs.size() > kMaxCachedPrograms)
+        programs.resize(kMaxCachedPrograms);
+
+    nlohmann::json jsonPrograms = nlohmann::json::array();
+    for (const auto& it : programs)
+    {
+        nlohmann::json jsonDefineLists = nlohmann::json::array();
+        for (const auto& defineList : it->second.defineLists)
+        {
+            nlohmann::json jsonDefineList = nlohmann::json::object();
+            for (const auto& [name, value] : defineList)
+                jsonDefineList[name] = value;
+            jsonDefineLists.push_back(std::move(jsonDefineList));
+        }
+        nlohmann::json jsonProgram = {
+            {"key", it->first}, {"name", it->second.name}, {"lastUsed", it->second.lastUsed}, {"defines", std::move(jsonDefineLists)}};
+        jsonPrograms.push_back(std::move(jsonProgram));
+    }
+    nlohmann::json json = {{"version", kVariantCacheVersion}, {"programs", std::move(jsonPrograms)}};
+
+    // Write to a temporary file first, so that an interrupted write doesn't leave a truncated cache behind.
+    auto tmpPath = mVariantCachePath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream ofs(tmpPath);
+        if (!ofs)
+        {
+            logWarning("Failed to write program variant cache '{}'.", tmpPath);
+            return;
+        }
+        ofs << json.dump(1);
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, mVariantCachePath, ec);
+    if (ec)
+    {
+        logWarning("Failed to write program variant cache '{}': {}", mVariantCachePath, ec.message());
+        return;
+    }
+    mVariantCacheDirty = false;
+}
+
 void ProgramManager::addGlobalDefines(const Program::DefineList& defineList)
 {
+    waitForPrecompilation();
     mGlobalDefineList.add(defineList);
     reloadAllPrograms(true);
 }
 
 void ProgramManager::removeGlobalDefines(const Program::DefineList& defineList)
 {
+    waitForPrecompilation();
     mGlobalDefineList.remove(defineList);
     reloadAllPrograms(true);
 }
 
 void ProgramManager::setGenerateDebugInfoEnabled(bool enabled)
 {
+    waitForPrecompilation();
     mGenerateDebugInfo = enabled;
 }
 
@@ -618,6 +1126,7 @@ bool ProgramManager::isGenerateDebugInfoEnabled()
 
 void ProgramManager::setForcedCompilerFlags(ForcedCompilerFlags forcedCompilerFlags)
 {
+    waitForPrecompilation();
     mForcedCompilerFlags = forcedCompilerFlags;
     reloadAllPrograms(true);
 }
@@ -627,12 +1136,15 @@ ProgramManager::ForcedCompilerFlags ProgramManager::getForcedCompilerFlags()
     return mForcedCompilerFlags;
 }
 
-SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& program) const
+SlangCompileRequest* ProgramManager::createSlangCompileRequest(
+    const Program& program,
+    const Program::DefineList& defineList,
+    slang::IGlobalSession* pSlangGlobalSession,
+    std::string& log
+) const
 {
     auto pDevice = mpDevice.lock();
     FALCOR_ASSERT(pDevice);
-
-    slang::IGlobalSession* pSlangGlobalSession = pDevice->getSlangGlobalSession();
     FALCOR_ASSERT(pSlangGlobalSession);
 
     slang::SessionDesc sessionDesc;
@@ -659,7 +1171,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
 
     if (targetDesc.profile == SLANG_PROFILE_UNKNOWN)
     {
-        reportError("Can't find Slang profile for shader model " + program.mDesc.mShaderModel);
+        log += "Can't find Slang profile for shader model " + program.mDesc.mShaderModel + "\n";
         return nullptr;
     }
 
@@ -703,6 +1215,13 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
         targetDesc.format = SLANG_SPIRV;
         targetMacroName = "FALCOR_VK";
         break;
+    case Device::Type::CPU:
+    case Device::Type::Null:
+        // Compute kernels are compiled to host C++ and loaded as callable functions by the CPU device.
+        // The null device never creates pipelines, so only reflection is generated for this target.
+        targetDesc.format = SLANG_SHADER_HOST_CALLABLE;
+        targetMacroName = "FALCOR_CPU";
+        break;
     default:
         FALCOR_UNREACHABLE();
     }
@@ -716,7 +1235,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     // Add global followed by program specific defines.
     for (const auto& shaderDefine : mGlobalDefineList)
         addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
-    for (const auto& shaderDefine : program.getDefineList())
+    for (const auto& shaderDefine : defineList)
         addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
 
     // Add a `#define`s based on the target and shader model.
@@ -742,8 +1261,6 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     pSlangGlobalSession->createSession(sessionDesc, pSlangSession.writeRef());
     FALCOR_ASSERT(pSlangSession);
 
-    program.mFileTimeMap.clear(); // TODO @skallweit
-
     if (!program.mDesc.mLanguagePrelude.empty())
     {
         if (targetDesc.format == SLANG_DXIL)
@@ -752,7 +1269,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
         }
         else
         {
-            reportError("Language prelude set for unsupported target " + std::string(targetMacroName));
+            log += "Language prelude set for unsupported target " + std::string(targetMacroName) + "\n";
             return nullptr;
         }
     }
@@ -830,7 +1347,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
             std::filesystem::path fullPath;
             if (!findFileInShaderDirectories(path, fullPath))
             {
-                reportError("Can't find file " + path.string());
+                log += "Can't find file " + path.string() + "\n";
                 spDestroyCompileRequest(pSlangRequest);
                 return nullptr;
             }
@@ -28,8 +28,14 @@
 #pragma once
 #include "Program.h"
 #include "Core/API/fwd.h"
+#include "Core/Platform/FileWatcher.h"
+#include "Utils/Threading.h"
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace Falcor
 {
@@ -38,6 +44,7 @@ class ProgramManager
 {
 public:
     ProgramManager(std::weak_ptr<Device> pDevice);
+    ~ProgramManager();
 
     /**
      * Defines flags that should be forcefully disabled or enabled on all shaders.
@@ -64,6 +71,21 @@ public:
 
     ProgramVersion::SharedPtr createProgramVersion(const Program& program, std::string& log) const;
 
+    /**
+     * Compile versions of a program for a list of define sets on worker threads.
+     * When the program's defines are later set to one of the define sets, the precompiled version is used
+     * instead of compiling the program on the calling thread. Define sets that are already compiled or pending are skipped.
+     * Does nothing if the thread pool is not running.
+     * @param[in] pProgram The program to compile.
+     * @param[in] defineLists The define sets to compile versions for.
+     */
+    void precompileProgramVersions(const Program::SharedPtr& pProgram, const std::vector<Program::DefineList>& defineLists);
+
+    /**
+     * Wait for all pending precompilation tasks to finish.
+     */
+    void waitForPrecompilation();
+
     ProgramKernels::SharedPtr ProgramManager::createProgramKernels(
         const Program& program,
         const ProgramVersion& programVersion,
@@ -77,7 +99,8 @@ public:
     ) const;
 
     /**
-     * Reload and relink all programs.
+     * Reload and relink programs.
+     * Without forceReload, only the program versions compiled from shader files that changed since the last call are reloaded.
      * @param[in] forceReload Force reloading all programs.
      * @return True if any program was reloaded, false otherwise.
      */
@@ -125,12 +148,94 @@ public:
     void resetCompilationStats() { mCompilationStats = {}; }
 
 private:
-    SlangCompileRequest* createSlangCompileRequest(const Program& program) const;
+    friend class Program;
+
+    /// Precompiled program version, owned by the precompilation task until it has finished.
+    struct PrecompiledVersion
+    {
+        std::weak_ptr<const Program> pProgram;
+        Program::DefineList defineList;
+        Threading::Task task;
+        ProgramVersion::SharedPtr pVersion;
+        std::string log;
+    };
+
+    /// Slang global session used for compiling program versions on worker threads.
+    struct WorkerSlangSession
+    {
+        Slang::ComPtr<slang::IGlobalSession> pGlobalSession; ///< Created on first use.
+        std::shared_ptr<std::mutex> pMutex = std::make_shared<std::mutex>(); ///< Held while in use. Shared with the compiled versions.
+    };
+
+    /// Define sets compiled for a program in previous runs, see getProgramCacheKey().
+    struct CachedProgramVariants
+    {
+        std::string name;
+        std::vector<Program::DefineList> defineLists;
+        int64_t lastUsed = 0;
+    };
+
+    ProgramVersion::SharedPtr createProgramVersion(
+        const Program& program,
+        const Program::DefineList& defineList,
+        slang::IGlobalSession* pSlangGlobalSession,
+        std::string& log
+    ) const;
+
+    SlangCompileRequest* createSlangCompileRequest(
+        const Program& program,
+        const Program::DefineList& defineList,
+        slang::IGlobalSession* pSlangGlobalSession,
+        std::string& log
+    ) const;
+
+    /// Take the precompiled version of a program for a define set, waiting for it if it is still being compiled.
+    /// Returns nullptr if the version was not precompiled or failed to compile.
+    ProgramVersion::SharedPtr takePrecompiledVersion(const Program& program, const Program::DefineList& defineList);
+
+    /// Drop precompiled versions that have not been taken yet.
+    void discardPrecompiledVersions();
+
+    /// Create a Slang global session for compiling on a worker thread.
+    static Slang::ComPtr<slang::IGlobalSession> createWorkerSlangSession();
+
+    /// Compute a key identifying the program sources and all compiler settings except the program defines.
+    std::string getProgramCacheKey(const Program& program) const;
+
+    /// Record that a version of a program was compiled, so it can be precompiled in the next run.
+    void recordProgramVariant(const Program& program, const Program::DefineList& defineList) const;
+
+    void loadVariantCache();
+    void saveVariantCache() const;
+
+    /// Watch the files a program version was compiled from, so it can be invalidated when they change.
+    void registerVersionDependencies(const ProgramVersion::SharedPtr& pVersion, const std::vector<std::string>& files) const;
+
+    /// Remove deleted program versions from the file dependencies and stop watching files without dependents. Requires mFileWatcherMutex.
+    void pruneVersionDependencies() const;
+
+    /// Invalidate the program versions that depend on changed files.
+    bool reloadChangedPrograms();
 
     std::weak_ptr<Device> mpDevice;
 
     std::vector<std::weak_ptr<Program>> mLoadedPrograms;
+
+    FileWatcher::SharedPtr mpFileWatcher;
+    mutable std::map<std::filesystem::path, std::vector<std::weak_ptr<const ProgramVersion>>> mFileToVersions; ///< Program versions by source file.
+    mutable std::mutex mFileWatcherMutex;
     mutable CompilationStats mCompilationStats;
+    mutable std::mutex mCompilationStatsMutex;
+
+    std::vector<std::shared_ptr<PrecompiledVersion>> mPrecompiledVersions;
+    std::vector<WorkerSlangSession> mWorkerSlangSessions; ///< Fixed size pool with one session per worker thread. Created on first use.
+    size_t mNextWorkerSlangSession = 0;
+    std::mutex mPrecompileMutex;
+
+    std::filesystem::path mVariantCachePath; ///< Empty if the variant cache is disabled.
+    mutable std::map<std::string, CachedProgramVariants> mVariantCache;
+    mutable bool mVariantCacheDirty = false;
+    mutable std::mutex mVariantCacheMutex;
 
     Program::DefineList mGlobalDefineList;
     bool mGenerateDebugInfo = false;
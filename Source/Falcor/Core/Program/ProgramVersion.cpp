@@ -173,6 +173,15 @@ ProgramVersion::ProgramVersion(Program* pProgram, slang::IComponentType* pSlangG
     FALCOR_ASSERT(pProgram);
 }
 
+ProgramVersion::~ProgramVersion()
+{
+    // Release the Slang objects while no worker compiles with the same session.
+    auto lock = lockSlangSession();
+    mpKernels.clear();
+    mpSlangEntryPoints.clear();
+    mpSlangGlobalScope = nullptr;
+}
+
 void ProgramVersion::init(
     const DefineList& defineList,
     const ProgramReflection::SharedPtr& pReflector,
@@ -257,6 +266,11 @@ ProgramKernels::SharedConstPtr ProgramVersion::getKernels(Device* pDevice, Progr
     }
 }
 
+std::unique_lock<std::mutex> ProgramVersion::lockSlangSession() const
+{
+    return mpSlangSessionMutex ? std::unique_lock<std::mutex>(*mpSlangSessionMutex) : std::unique_lock<std::mutex>();
+}
+
 slang::ISession* ProgramVersion::getSlangSession() const
 {
     return getSlangGlobalScope()->getSession();
@@ -32,6 +32,7 @@
 #include "Core/API/Shader.h"
 #include "Core/API/Handles.h"
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -171,6 +172,8 @@ public:
     using SharedConstPtr = std::shared_ptr<const ProgramVersion>;
     using DefineList = Shader::DefineList;
 
+    ~ProgramVersion();
+
     /**
      * Get the program that this version was created from
      */
@@ -222,12 +225,19 @@ protected:
         std::vector<ComPtr<slang::IComponentType>> const& pSlangEntryPoints
     );
 
+    /**
+     * Lock the Slang session of this version, if the session is shared with workers precompiling other versions.
+     * Slang sessions must not be used concurrently, so this is held while using the session, e.g. for linking kernels.
+     */
+    std::unique_lock<std::mutex> lockSlangSession() const;
+
     std::weak_ptr<Program> mpProgram;
     DefineList mDefines;
     ProgramReflection::SharedPtr mpReflector;
     std::string mName;
     ComPtr<slang::IComponentType> mpSlangGlobalScope;
     std::vector<ComPtr<slang::IComponentType>> mpSlangEntryPoints;
+    std::shared_ptr<std::mutex> mpSlangSessionMutex; ///< Mutex of the shared Slang session, or nullptr if the session isn't shared.
 
     // Cached version of compiled kernels for this program version
     mutable std::unordered_map<std::string, ProgramKernels::SharedPtr> mpKernels;
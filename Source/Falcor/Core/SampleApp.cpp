@@ -28,6 +28,7 @@
 #include "SampleApp.h"
 #include "Macros.h"
 #include "Version.h"
+#include "Core/Errors.h"
 #include "Core/Plugin.h"
 #include "Core/Program/Program.h"
 #include "Core/Program/ProgramManager.h"
@@ -52,7 +53,7 @@ SampleApp::SampleApp(const SampleAppConfig& config)
     logInfo("Falcor {}", getLongVersionString());
 
     OSServices::start();
-    Threading::start();
+    Threading::start(config.threadCount);
 
     mpSettings.reset(new Settings);
 
@@ -65,6 +66,10 @@ SampleApp::SampleApp(const SampleAppConfig& config)
     // Create GPU device
     mpDevice = Device::create(config.deviceDesc);
 
+    // Host devices (CPU/Null) only run compute programs and have nothing to present to.
+    if (mpDevice->isHostDevice() && !config.headless)
+        throw RuntimeError("Host devices (CPU/Null) can only be used in headless mode.");
+
     if (!config.headless)
     {
         auto windowDesc = config.windowDesc;
@@ -92,9 +97,13 @@ SampleApp::SampleApp(const SampleAppConfig& config)
         setShowMessageBoxOnError(true);
     }
 
-    // Create target frame buffer
+    // Create target frame buffer.
+    // Host devices need one as well, render graphs take the default size and format of their resources from it
+    // (see RenderGraph::onResize()).
+    // Nothing is rasterized on host devices, so the depth buffer is omitted.
     uint2 fboSize = mpWindow ? mpWindow->getClientAreaSize() : uint2(config.windowDesc.width, config.windowDesc.height);
-    mpTargetFBO = Fbo::create2D(mpDevice.get(), fboSize.x, fboSize.y, config.colorFormat, config.depthFormat);
+    ResourceFormat depthFormat = mpDevice->isHostDevice() ? ResourceFormat::Unknown : config.depthFormat;
+    mpTargetFBO = Fbo::create2D(mpDevice.get(), fboSize.x, fboSize.y, config.colorFormat, depthFormat);
 
     // Load settings.toml files
     getSettings().addOptions(getRuntimeDirectory() / "settings.json");
@@ -123,8 +132,11 @@ SampleApp::SampleApp(const SampleAppConfig& config)
     }
 
     // Init the UI
-    initUI();
-    mpPixelZoom = std::make_unique<PixelZoom>(mpDevice, mpTargetFBO.get());
+    if (!mpDevice->isHostDevice())
+    {
+        initUI();
+        mpPixelZoom = std::make_unique<PixelZoom>(mpDevice, mpTargetFBO.get());
+    }
 
     PluginManager::instance().loadAllPlugins();
 }
@@ -513,6 +525,16 @@ void SampleApp::renderFrame()
 
     RenderContext* pRenderContext = mpDevice->getRenderContext();
 
+    // On host devices there is no UI to render and nothing to capture or present.
+    if (mpDevice->isHostDevice())
+    {
+        onFrameRender(pRenderContext, mpTargetFBO);
+        mpDevice->endFrame();
+        mInputState.endFrame();
+        mConsole.flush();
+        return;
+    }
+
     // Render a frame.
     // If the renderer is paused, create a copy of the rendered output and copy that back each frame.
     if (mRendererPaused && mpPausedRenderOutput)
@@ -584,7 +606,8 @@ void SampleApp::resizeTargetFBO(uint32_t width, uint32_t height)
     // Resize target frame buffer.
     auto pPrevFBO = mpTargetFBO;
     mpTargetFBO = Fbo::create2D(mpDevice.get(), width, height, pPrevFBO->getDesc());
-    mpDevice->getRenderContext()->blit(pPrevFBO->getColorTexture(0)->getSRV(), mpTargetFBO->getRenderTargetView(0));
+    if (!mpDevice->isHostDevice())
+        mpDevice->getRenderContext()->blit(pPrevFBO->getColorTexture(0)->getSRV(), mpTargetFBO->getRenderTargetView(0));
 
     // Tell the GUI the swap-chain size changed
     if (mpGui)
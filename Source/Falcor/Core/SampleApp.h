@@ -67,6 +67,8 @@ struct SampleAppConfig
 
     bool generateShaderDebugInfo = false;
     bool shaderPreciseFloat = false;
+
+    uint32_t threadCount = 0; ///< Number of worker threads in the global thread pool (0 = logical thread count).
 };
 
 /**
@@ -92,9 +92,15 @@ void Testbed::frame()
 
     RenderContext* pRenderContext = mpDevice->getRenderContext();
 
+    // Host devices (CPU/Null) have no UI and nothing to present, so only the scene and render graph are updated.
+    const bool isHostDevice = mpDevice->isHostDevice();
+
     // Clear the frame buffer.
-    const float4 clearColor(1, 0, 1, 1);
-    pRenderContext->clearFbo(mpTargetFBO.get(), clearColor, 1.0f, 0, FboAttachmentType::All);
+    if (!isHostDevice)
+    {
+        const float4 clearColor(1, 0, 1, 1);
+        pRenderContext->clearFbo(mpTargetFBO.get(), clearColor, 1.0f, 0, FboAttachmentType::All);
+    }
 
     // Compile the render graph.
     if (mpRenderGraph)
@@ -115,7 +121,7 @@ void Testbed::frame()
         mpRenderGraph->execute(pRenderContext);
 
         // Blit main graph output to frame buffer.
-        if (mpRenderGraph->getOutputCount() > 0)
+        if (!isHostDevice && mpRenderGraph->getOutputCount() > 0)
         {
             Texture::SharedPtr pOutTex = std::dynamic_pointer_cast<Texture>(mpRenderGraph->getOutput(0));
             FALCOR_ASSERT(pOutTex);
@@ -123,10 +129,12 @@ void Testbed::frame()
         }
     }
 
-    renderUI();
+    if (mpGui)
+        renderUI();
 
 #if FALCOR_ENABLE_PROFILER
-    mpDevice->getProfiler()->endFrame(pRenderContext);
+    if (!isHostDevice)
+        mpDevice->getProfiler()->endFrame(pRenderContext);
 #endif
 
     // Copy framebuffer to swapchain image.
@@ -262,11 +270,15 @@ void Testbed::handleDroppedFile(const std::filesystem::path& path) {}
 void Testbed::internalInit(const Options& options)
 {
     OSServices::start();
-    Threading::start();
+    Threading::start(options.threadCount);
 
     // Create the device.
     mpDevice = Device::create(options.deviceDesc);
 
+    // Host devices (CPU/Null) only run compute programs and have nothing to present to.
+    if (mpDevice->isHostDevice() && options.createWindow)
+        throw RuntimeError("Host devices (CPU/Null) can only be used without a window.");
+
     // Create the window & swapchain.
     if (options.createWindow)
     {
@@ -282,9 +294,11 @@ void Testbed::internalInit(const Options& options)
         mpSwapchain = std::make_unique<Swapchain>(mpDevice, desc, mpWindow->getApiHandle());
     }
 
-    // Create target frame buffer
+    // Create target frame buffer.
+    // Nothing is rasterized on host devices, so the depth buffer is omitted.
     uint2 fboSize = mpWindow ? mpWindow->getClientAreaSize() : uint2(options.windowDesc.width, options.windowDesc.height);
-    mpTargetFBO = Fbo::create2D(mpDevice.get(), fboSize.x, fboSize.y, options.colorFormat, options.depthFormat);
+    ResourceFormat depthFormat = mpDevice->isHostDevice() ? ResourceFormat::Unknown : options.depthFormat;
+    mpTargetFBO = Fbo::create2D(mpDevice.get(), fboSize.x, fboSize.y, options.colorFormat, depthFormat);
 
     // Set global shader defines.
     Program::DefineList globalDefines = {
@@ -296,7 +310,8 @@ void Testbed::internalInit(const Options& options)
     mpDevice->getProgramManager()->addGlobalDefines(globalDefines);
 
     // Create the GUI.
-    mpGui = std::make_unique<Gui>(mpDevice, mpTargetFBO->getWidth(), mpTargetFBO->getHeight(), getDisplayScaleFactor());
+    if (!mpDevice->isHostDevice())
+        mpGui = std::make_unique<Gui>(mpDevice, mpTargetFBO->getWidth(), mpTargetFBO->getHeight(), getDisplayScaleFactor());
 
     mFrameRate.reset();
 }
@@ -334,7 +349,8 @@ void Testbed::resizeTargetFBO(uint32_t width, uint32_t height)
     // Resize target frame buffer.
     auto pPrevFBO = mpTargetFBO;
     mpTargetFBO = Fbo::create2D(mpDevice.get(), width, height, pPrevFBO->getDesc());
-    mpDevice->getRenderContext()->blit(pPrevFBO->getColorTexture(0)->getSRV(), mpTargetFBO->getRenderTargetView(0));
+    if (!mpDevice->isHostDevice())
+        mpDevice->getRenderContext()->blit(pPrevFBO->getColorTexture(0)->getSRV(), mpTargetFBO->getRenderTargetView(0));
 
     if (mpGui)
         mpGui->onWindowResize(width, height);
@@ -571,14 +587,17 @@ FALCOR_SCRIPT_BINDING(Testbed)
 {
     using namespace pybind11::literals;
 
+    FALCOR_SCRIPT_BINDING_DEPENDENCY(Device)
+
     pybind11::class_<Testbed, std::shared_ptr<Testbed>> testbed(m, "Testbed");
 
-    auto createTestbed = [](uint32_t width, uint32_t height, bool createWindow, uint32_t gpu)
+    auto createTestbed = [](uint32_t width, uint32_t height, bool createWindow, Device::Type deviceType, uint32_t gpu)
     {
         Testbed::Options options;
         options.windowDesc.width = width;
         options.windowDesc.height = height;
         options.createWindow = createWindow;
+        options.deviceDesc.type = deviceType;
         options.deviceDesc.gpu = gpu;
         return Testbed::create(options);
     };
@@ -586,7 +605,8 @@ FALCOR_SCRIPT_BINDING(Testbed)
     Testbed::Options defaultOptions;
     testbed.def(
         pybind11::init(createTestbed), "width"_a = defaultOptions.windowDesc.width, "height"_a = defaultOptions.windowDesc.height,
-        "createWindow"_a = defaultOptions.createWindow, "gpu"_a = defaultOptions.deviceDesc.gpu
+        "createWindow"_a = defaultOptions.createWindow, "deviceType"_a = defaultOptions.deviceDesc.type,
+        "gpu"_a = defaultOptions.deviceDesc.gpu
     );
     testbed.def("run", &Testbed::run);
     testbed.def("frame", &Testbed::frame);
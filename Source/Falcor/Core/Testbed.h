@@ -55,9 +55,10 @@ public:
     {
         Options() {} // Work around clang++ bug: "error: default member initializer for 'createWindow' needed within definition of enclosing
                      // class 'Testbed' outside of member functions"
-        Device::Desc deviceDesc;
+        Device::Desc deviceDesc; ///< Device settings. Host devices (CPU/Null) run without UI and can't be used with a window.
         Window::Desc windowDesc;
         bool createWindow = false;
+        uint32_t threadCount = 0; ///< Number of worker threads in the global thread pool (0 = logical thread count).
 
         ResourceFormat colorFormat = ResourceFormat::BGRA8UnormSrgb; ///< Color format of the frame buffer.
         ResourceFormat depthFormat = ResourceFormat::D32Float;       ///< Depth buffer format of the frame buffer.
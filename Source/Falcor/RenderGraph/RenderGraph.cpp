@@ -662,6 +662,13 @@ namespace Falcor
         mRecompile = true;
     }
 
+    void RenderGraph::setTransientResourceAliasing(bool enabled)
+    {
+        if (mCompilerDeps.defaultResourceProps.aliasTransientResources == enabled) return;
+        mCompilerDeps.defaultResourceProps.aliasTransientResources = enabled;
+        mRecompile = true;
+    }
+
     bool canFieldsConnect(const RenderPassReflection::Field& src, const RenderPassReflection::Field& dst)
     {
         FALCOR_ASSERT(is_set(src.getVisibility(), RenderPassReflection::Field::Visibility::Output) && is_set(dst.getVisibility(), RenderPassReflection::Field::Visibility::Input));
@@ -737,6 +744,7 @@ namespace Falcor
         renderGraph.def(RenderGraphIR::kRemoveEdge, pybind11::overload_cast<const std::string&, const std::string&>(&RenderGraph::removeEdge), "src"_a, "dst"_a);
         renderGraph.def(RenderGraphIR::kMarkOutput, &RenderGraph::markOutput, "name"_a, "mask"_a = TextureChannelFlags::RGB);
         renderGraph.def(RenderGraphIR::kUnmarkOutput, &RenderGraph::unmarkOutput, "name"_a);
+        renderGraph.def_property(RenderGraphIR::kAliasTransientResources, &RenderGraph::isTransientResourceAliasingEnabled, &RenderGraph::setTransientResourceAliasing);
         renderGraph.def("getPass", &RenderGraph::getPass, "name"_a);
         renderGraph.def("getOutput", pybind11::overload_cast<const std::string&>(&RenderGraph::getOutput), "name"_a);
         auto printGraph = [](RenderGraph::SharedPtr pGraph) { pybind11::print(RenderGraphExporter::getIR(pGraph)); };
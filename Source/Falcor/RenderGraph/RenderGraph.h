@@ -183,6 +183,15 @@ namespace Falcor
         */
         void onResize(const Fbo* pTargetFbo);
 
+        /** Enable/disable sharing of resources between transient fields with disjoint lifetimes. Disabled by default.
+            Passes that rely on the content of a non-persistent output surviving until the next frame require this to be disabled.
+        */
+        void setTransientResourceAliasing(bool enabled);
+
+        /** Check if transient resources are shared between fields with disjoint lifetimes.
+        */
+        bool isTransientResourceAliasingEnabled() const { return mCompilerDeps.defaultResourceProps.aliasTransientResources; }
+
         /** Get the attached scene.
         */
         const Scene::SharedPtr& getScene() const { return mpScene; }
@@ -244,13 +244,6 @@ namespace Falcor
 
     void RenderGraphCompiler::allocateResources(Device* pDevice, ResourceCache* pResourceCache)
     {
-        // Build list to look up execution order index from the pass
-        std::unordered_map<RenderPass*, uint32_t> passToIndex;
-        for (size_t i = 0; i < mExecutionList.size(); i++)
-        {
-            passToIndex.emplace(mExecutionList[i].pPass.get(), uint32_t(i));
-        }
-
         for (size_t i = 0; i < mExecutionList.size(); i++)
         {
             uint32_t nodeIndex = mExecutionList[i].index;
@@ -312,9 +305,8 @@ namespace Falcor
                 std::string srcFieldName = mGraph.mNodeData[pEdge->getSourceNode()].name + '.' + edgeData.srcField;
                 std::string dstFieldName = mGraph.mNodeData[nodeIndex].name + '.' + dstField.getName();
 
-                const auto& pSrcPass = mGraph.mNodeData[pEdge->getSourceNode()].pPass.get();
-                const auto& srcReflection = mExecutionList[passToIndex.at(pSrcPass)].reflector;
-                pResourceCache->registerField(dstFieldName, dstField, passToIndex[pSrcPass], srcFieldName);
+                // The consumer's time point extends the lifetime of the resource up to its last use
+                pResourceCache->registerField(dstFieldName, dstField, uint32_t(i), srcFieldName);
             }
         }
 
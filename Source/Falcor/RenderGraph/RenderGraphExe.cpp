@@ -36,7 +36,7 @@ namespace Falcor
 
         for (const auto& pass : mExecutionList)
         {
-            FALCOR_PROFILE(ctx.pRenderContext, pass.name);
+            FALCOR_PROFILE_DYNAMIC(ctx.pRenderContext, pass.name);
 
             RenderData renderData(pass.name, mpResourceCache, ctx.pGraphDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
             pass.pPass->execute(ctx.pRenderContext, renderData);
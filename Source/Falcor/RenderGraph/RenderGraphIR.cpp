@@ -43,6 +43,7 @@ namespace Falcor
     const char* RenderGraphIR::kLoadPassLibrary = "loadRenderPassLibrary";
     const char* RenderGraphIR::kCreatePass = "createPass";
     const char* RenderGraphIR::kRenderGraph = "RenderGraph";
+    const char* RenderGraphIR::kAliasTransientResources = "aliasTransientResources";
 
     std::string RenderGraphIR::getFuncName(const std::string& graphName)
     {
@@ -123,4 +124,9 @@ namespace Falcor
     {
         mIR += mIndentation + ScriptWriter::makeFunc(RenderGraphIR::kLoadPassLibrary, name);
     }
+
+    void RenderGraphIR::setTransientResourceAliasing(bool enabled)
+    {
+        mIR += mGraphPrefix + RenderGraphIR::kAliasTransientResources + " = " + ScriptWriter::getArgString(enabled) + "\n";
+    }
 }
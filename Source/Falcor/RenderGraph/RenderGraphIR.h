@@ -52,6 +52,7 @@ namespace Falcor
         void markOutput(const std::string& name, const TextureChannelFlags mask = TextureChannelFlags::RGB);
         void unmarkOutput(const std::string& name);
         void loadPassLibrary(const std::string& name);
+        void setTransientResourceAliasing(bool enabled);
 
         std::string getIR() { return mIR + mIndentation + (mIndentation.size() ? "return g\n" : "\n"); }
 
@@ -66,6 +67,7 @@ namespace Falcor
         static const char* kUpdatePass;
         static const char* kLoadPassLibrary;
         static const char* kCreatePass;
+        static const char* kAliasTransientResources;
     private:
         RenderGraphIR(const std::string& name, bool newGraph);
         std::string mName;
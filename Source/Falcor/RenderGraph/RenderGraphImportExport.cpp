@@ -152,6 +152,12 @@ namespace Falcor
             }
         }
 
+        // Graph options, only written if they differ from the defaults
+        if (pGraph->isTransientResourceAliasingEnabled())
+        {
+            pIR->setTransientResourceAliasing(true);
+        }
+
         return pIR->getIR();
     }
 
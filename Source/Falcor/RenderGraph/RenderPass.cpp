@@ -41,7 +41,10 @@ namespace Falcor
 
     const Resource::SharedPtr& RenderData::getResource(const std::string_view name) const
     {
-        return mpResources->getResource(fmt::format("{}.{}", mName, name));
+        // Reuse the key's storage between calls to avoid an allocation per lookup
+        thread_local std::string key;
+        key.assign(mName).append(1, '.').append(name);
+        return mpResources->getResource(key);
     }
 
     Texture::SharedPtr RenderData::getTexture(const std::string_view name) const
@@ -50,6 +53,22 @@ namespace Falcor
         return pResource ? pResource->asTexture() : nullptr;
     }
 
+    const Resource::SharedPtr& RenderData::getResource(const ResourceHandle& handle) const
+    {
+        if (handle.mCacheId != mpResources->getId())
+        {
+            handle.mHandle = mpResources->getResourceHandle(fmt::format("{}.{}", mName, handle.mName));
+            handle.mCacheId = mpResources->getId();
+        }
+        return mpResources->getResource(handle.mHandle);
+    }
+
+    Texture::SharedPtr RenderData::getTexture(const ResourceHandle& handle) const
+    {
+        auto pResource = getResource(handle);
+        return pResource ? pResource->asTexture() : nullptr;
+    }
+
     RenderPass::SharedPtr RenderPass::create(std::string_view type, std::shared_ptr<Device> pDevice, const Dictionary& dict, PluginManager& pm)
     {
         // Try to load a plugin of the same name, if render pass class is not registered yet.
@@ -49,6 +49,30 @@ namespace Falcor
     class FALCOR_API RenderData
     {
     public:
+        /** Handle to one of the pass' resources.
+            Render passes hold a handle per field they access every frame. The handle is resolved on first use after every
+            render graph compilation, subsequent lookups are allocation-free. The string-based getters remain available.
+        */
+        class ResourceHandle
+        {
+        public:
+            ResourceHandle() = default;
+
+            /** Create a handle.
+                \param[in] name The name of the pass' resource (i.e. "outputColor"). No need to specify the pass' name
+            */
+            explicit ResourceHandle(std::string name) : mName(std::move(name)) {}
+
+            const std::string& getName() const { return mName; }
+
+        private:
+            std::string mName;
+            mutable uint64_t mCacheId = 0;                      ///< Id of the resource cache the handle was resolved against. Zero if not resolved.
+            mutable ResourceCache::ResourceHandle mHandle;
+
+            friend class RenderData;
+        };
+
         /** Get a resource
             \param[in] name The name of the pass' resource (i.e. "outputColor"). No need to specify the pass' name
             \return If the name exists, a pointer to the resource. Otherwise, nullptr
@@ -67,6 +91,24 @@ namespace Falcor
         */
         Texture::SharedPtr getTexture(const std::string_view name) const;
 
+        /** Get a resource
+            \param[in] handle Handle to the pass' resource.
+            \return If the resource exists, a pointer to the resource. Otherwise, nullptr
+        */
+        const Resource::SharedPtr& operator[](const ResourceHandle& handle) const { return getResource(handle); }
+
+        /** Get a resource
+            \param[in] handle Handle to the pass' resource.
+            \return If the resource exists, a pointer to the resource. Otherwise, nullptr
+        */
+        const Resource::SharedPtr& getResource(const ResourceHandle& handle) const;
+
+        /** Get a texture
+            \param[in] handle Handle to the pass' texture.
+            \return If the texture exists, a pointer to the texture. Otherwise, nullptr
+        */
+        Texture::SharedPtr getTexture(const ResourceHandle& handle) const;
+
         /** Get the global dictionary. You can use it to pass data between different passes
         */
         InternalDictionary& getDictionary() const { return (*mpDictionary); }
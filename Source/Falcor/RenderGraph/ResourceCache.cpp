@@ -30,9 +30,25 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Buffer.h"
 #include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
+#include <algorithm>
+#include <atomic>
 
 namespace Falcor
 {
+    namespace
+    {
+        uint64_t generateCacheId()
+        {
+            static std::atomic<uint64_t> sNextId{ 1 };
+            return sNextId++;
+        }
+    }
+
+    ResourceCache::ResourceCache()
+        : mId(generateCacheId())
+    {}
+
     ResourceCache::SharedPtr ResourceCache::create()
     {
         return SharedPtr(new ResourceCache());
@@ -42,22 +58,37 @@ namespace Falcor
     {
         mNameToIndex.clear();
         mResourceData.clear();
+        mMemoryStats = {};
+        mId = generateCacheId();
     }
 
     const Resource::SharedPtr& ResourceCache::getResource(const std::string& name) const
     {
         static const Resource::SharedPtr pNull;
-        auto extIt = mExternalResources.find(name);
+        auto extIt = mExternalNameToIndex.find(name);
 
         // Search external resources if not found in render graph resources
-        if (extIt == mExternalResources.end())
+        if (extIt == mExternalNameToIndex.end() || !mExternalResources[extIt->second])
         {
             const auto& it = mNameToIndex.find(name);
             if (it == mNameToIndex.end()) return pNull;
             return mResourceData[it->second].pResource;
         }
 
-        return extIt->second;
+        return mExternalResources[extIt->second];
+    }
+
+    ResourceCache::ResourceHandle ResourceCache::getResourceHandle(const std::string& name)
+    {
+        ResourceHandle handle;
+        auto it = mNameToIndex.find(name);
+        if (it != mNameToIndex.end()) handle.index = it->second;
+
+        // Reserve an external slot so that external resources registered later are visible through the handle
+        auto [extIt, inserted] = mExternalNameToIndex.try_emplace(name, (uint32_t)mExternalResources.size());
+        if (inserted) mExternalResources.emplace_back();
+        handle.externalIndex = extIt->second;
+        return handle;
     }
 
     const RenderPassReflection::Field& ResourceCache::getResourceReflection(const std::string& name) const
@@ -68,17 +99,22 @@ namespace Falcor
 
     void ResourceCache::registerExternalResource(const std::string& name, const Resource::SharedPtr& pResource)
     {
-        if(pResource) mExternalResources[name] = pResource;
+        if (pResource)
+        {
+            auto [it, inserted] = mExternalNameToIndex.try_emplace(name, (uint32_t)mExternalResources.size());
+            if (inserted) mExternalResources.push_back(pResource);
+            else mExternalResources[it->second] = pResource;
+        }
         else
         {
-            auto it = mExternalResources.find(name);
-            if (it == mExternalResources.end())
+            auto it = mExternalNameToIndex.find(name);
+            if (it == mExternalNameToIndex.end() || !mExternalResources[it->second])
             {
                 logWarning("ResourceCache::registerExternalResource: '{}' does not exist.", name);
                 return;
             }
 
-            mExternalResources.erase(it);
+            mExternalResources[it->second] = nullptr;
         }
     }
 
@@ -117,78 +153,192 @@ namespace Falcor
         }
     }
 
-    inline Resource::SharedPtr createResourceForPass(Device* pDevice, const ResourceCache::DefaultProperties& params, const RenderPassReflection::Field& field, bool resolveBindFlags, const std::string& resourceName)
+    namespace
     {
-        uint32_t width = field.getWidth() ? field.getWidth() : params.dims.x;
-        uint32_t height = field.getHeight() ? field.getHeight() : params.dims.y;
-        uint32_t depth = field.getDepth() ? field.getDepth() : 1;
-        uint32_t sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
-        auto bindFlags = field.getBindFlags();
-        auto arraySize = field.getArraySize();
-        auto mipLevels = field.getMipCount();
+        /** Fully resolved properties of a resource. Two fields with equal descs can share the same resource.
+        */
+        struct ResourceDesc
+        {
+            RenderPassReflection::Field::Type type;
+            uint32_t width;
+            uint32_t height;
+            uint32_t depth;
+            uint32_t sampleCount;
+            uint32_t arraySize;
+            uint32_t mipLevels;
+            ResourceFormat format;
+            ResourceBindFlags bindFlags;
 
-        ResourceFormat format = ResourceFormat::Unknown;
+            bool operator==(const ResourceDesc& other) const
+            {
+                return type == other.type && width == other.width && height == other.height && depth == other.depth &&
+                    sampleCount == other.sampleCount && arraySize == other.arraySize && mipLevels == other.mipLevels &&
+                    format == other.format && bindFlags == other.bindFlags;
+            }
+        };
 
-        if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
+        ResourceDesc resolveResourceDesc(Device* pDevice, const ResourceCache::DefaultProperties& params, const RenderPassReflection::Field& field, bool resolveBindFlags)
         {
-            format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
-            if (resolveBindFlags)
+            ResourceDesc desc;
+            desc.type = field.getType();
+            desc.width = field.getWidth() ? field.getWidth() : params.dims.x;
+            desc.height = field.getHeight() ? field.getHeight() : params.dims.y;
+            desc.depth = field.getDepth() ? field.getDepth() : 1;
+            desc.sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
+            desc.arraySize = field.getArraySize();
+            desc.mipLevels = field.getMipCount();
+            desc.format = ResourceFormat::Unknown;
+            desc.bindFlags = field.getBindFlags();
+
+            if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
             {
-                ResourceBindFlags mask = Resource::BindFlags::UnorderedAccess | Resource::BindFlags::ShaderResource;
-                bool isOutput = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Output);
-                bool isInternal = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
-                if (isOutput || isInternal) mask |= Resource::BindFlags::DepthStencil | Resource::BindFlags::RenderTarget;
-                auto supported = pDevice->getFormatBindFlags(format);
-                mask &= supported;
-                bindFlags |= mask;
+                desc.format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
+                if (resolveBindFlags)
+                {
+                    ResourceBindFlags mask = Resource::BindFlags::UnorderedAccess | Resource::BindFlags::ShaderResource;
+                    bool isOutput = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Output);
+                    bool isInternal = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
+                    if (isOutput || isInternal) mask |= Resource::BindFlags::DepthStencil | Resource::BindFlags::RenderTarget;
+                    auto supported = pDevice->getFormatBindFlags(desc.format);
+                    mask &= supported;
+                    desc.bindFlags |= mask;
+                }
             }
-        }
-        else // RawBuffer
-        {
-            if (resolveBindFlags) bindFlags = Resource::BindFlags::UnorderedAccess | Resource::BindFlags::ShaderResource;
-        }
-        Resource::SharedPtr pResource;
-
-        switch (field.getType())
-        {
-        case RenderPassReflection::Field::Type::RawBuffer:
-            pResource = Buffer::create(pDevice, width, bindFlags, Buffer::CpuAccess::None);
-            break;
-        case RenderPassReflection::Field::Type::Texture1D:
-            pResource = Texture::create1D(pDevice, width, format, arraySize, mipLevels, nullptr, bindFlags);
-            break;
-        case RenderPassReflection::Field::Type::Texture2D:
-            if (sampleCount > 1)
+            else // RawBuffer
             {
-                pResource = Texture::create2DMS(pDevice, width, height, format, sampleCount, arraySize, bindFlags);
+                if (resolveBindFlags) desc.bindFlags = Resource::BindFlags::UnorderedAccess | Resource::BindFlags::ShaderResource;
             }
-            else
+            return desc;
+        }
+
+        Resource::SharedPtr createResource(Device* pDevice, const ResourceDesc& desc, const std::string& resourceName)
+        {
+            Resource::SharedPtr pResource;
+
+            switch (desc.type)
             {
-                pResource = Texture::create2D(pDevice, width, height, format, arraySize, mipLevels, nullptr, bindFlags);
+            case RenderPassReflection::Field::Type::RawBuffer:
+                pResource = Buffer::create(pDevice, desc.width, desc.bindFlags, Buffer::CpuAccess::None);
+                break;
+            case RenderPassReflection::Field::Type::Texture1D:
+                pResource = Texture::create1D(pDevice, desc.width, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
+                break;
+            case RenderPassReflection::Field::Type::Texture2D:
+                if (desc.sampleCount > 1)
+                {
+                    pResource = Texture::create2DMS(pDevice, desc.width, desc.height, desc.format, desc.sampleCount, desc.arraySize, desc.bindFlags);
+                }
+                else
+                {
+                    pResource = Texture::create2D(pDevice, desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
+                }
+                break;
+            case RenderPassReflection::Field::Type::Texture3D:
+                pResource = Texture::create3D(pDevice, desc.width, desc.height, desc.depth, desc.format, desc.mipLevels, nullptr, desc.bindFlags);
+                break;
+            case RenderPassReflection::Field::Type::TextureCube:
+                pResource = Texture::createCube(pDevice, desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
+                break;
+            default:
+                FALCOR_UNREACHABLE();
+                return nullptr;
             }
-            break;
-        case RenderPassReflection::Field::Type::Texture3D:
-            pResource = Texture::create3D(pDevice, width, height, depth, format, mipLevels, nullptr, bindFlags);
-            break;
-        case RenderPassReflection::Field::Type::TextureCube:
-            pResource = Texture::createCube(pDevice, width, height, format, arraySize, mipLevels, nullptr, bindFlags);
-            break;
-        default:
-            FALCOR_UNREACHABLE();
-            return nullptr;
+            pResource->setName(resourceName);
+            return pResource;
+        }
+
+        uint64_t getResourceSizeInBytes(const Resource* pResource)
+        {
+            if (auto pTexture = dynamic_cast<const Texture*>(pResource)) return pTexture->getTextureSizeInBytes();
+            return pResource->getSize();
         }
-        pResource->setName(resourceName);
-        return pResource;
     }
 
     void ResourceCache::allocateResources(Device* pDevice, const DefaultProperties& params)
     {
-        for (auto& data : mResourceData)
+        // A field is transient if its content is only needed between its first and last use within a single graph execution.
+        // Graph outputs are read after the graph has executed, internal and persistent fields must retain their content across frames.
+        auto isTransient = [](const ResourceData& data)
+        {
+            if (data.lifetime.second == uint32_t(-1)) return false;
+            if (is_set(data.field.getVisibility(), RenderPassReflection::Field::Visibility::Internal)) return false;
+            if (is_set(data.field.getFlags(), RenderPassReflection::Field::Flags::Persistent)) return false;
+            return true;
+        };
+
+        // Collect the resources that need to be created, in order of their first use.
+        std::vector<uint32_t> pending;
+        for (uint32_t i = 0; i < (uint32_t)mResourceData.size(); i++)
+        {
+            if ((mResourceData[i].pResource == nullptr) && (mResourceData[i].field.isValid())) pending.push_back(i);
+        }
+        std::stable_sort(pending.begin(), pending.end(), [this](uint32_t a, uint32_t b) { return mResourceData[a].lifetime.first < mResourceData[b].lifetime.first; });
+
+        // Resources available for sharing. A resource can be handed to another field once its last use precedes the field's first use.
+        struct SharedResource
+        {
+            ResourceDesc desc;
+            Resource::SharedPtr pResource;
+            uint32_t lastUse;
+        };
+        std::vector<SharedResource> sharedResources;
+
+        struct Allocation
+        {
+            std::pair<uint32_t, uint32_t> lifetime;
+            uint64_t size;
+        };
+        std::vector<Allocation> allocations;
+        allocations.reserve(pending.size());
+
+        mMemoryStats = {};
+
+        for (uint32_t index : pending)
+        {
+            auto& data = mResourceData[index];
+            ResourceDesc desc = resolveResourceDesc(pDevice, params, data.field, data.resolveBindFlags);
+            bool transient = params.aliasTransientResources && isTransient(data);
+
+            if (transient)
+            {
+                auto it = std::find_if(sharedResources.begin(), sharedResources.end(), [&](const SharedResource& r) { return r.lastUse < data.lifetime.first && r.desc == desc; });
+                if (it != sharedResources.end())
+                {
+                    data.pResource = it->pResource;
+                    it->lastUse = data.lifetime.second;
+                }
+            }
+
+            if (data.pResource == nullptr)
+            {
+                data.pResource = createResource(pDevice, desc, data.name);
+                mMemoryStats.allocationCount++;
+                mMemoryStats.allocatedBytes += getResourceSizeInBytes(data.pResource.get());
+                if (transient) sharedResources.push_back({ desc, data.pResource, data.lifetime.second });
+            }
+
+            uint64_t size = getResourceSizeInBytes(data.pResource.get());
+            mMemoryStats.fieldCount++;
+            mMemoryStats.requestedBytes += size;
+            allocations.push_back({ isTransient(data) ? data.lifetime : std::make_pair(0u, uint32_t(-1)), size });
+        }
+
+        // The peak is reached at the start of some resource's lifetime.
+        for (const auto& a : allocations)
         {
-            if ((data.pResource == nullptr) && (data.field.isValid()))
+            uint64_t liveBytes = 0;
+            for (const auto& b : allocations)
             {
-                data.pResource = createResourceForPass(pDevice, params, data.field, data.resolveBindFlags, data.name);
+                if (b.lifetime.first <= a.lifetime.first && a.lifetime.first <= b.lifetime.second) liveBytes += b.size;
             }
+            mMemoryStats.peakBytes = std::max(mMemoryStats.peakBytes, liveBytes);
+        }
+
+        if (mMemoryStats.fieldCount > 0)
+        {
+            logInfo("Render graph resources: {} fields in {} allocations, {} allocated ({} without aliasing, {} peak live memory).",
+                mMemoryStats.fieldCount, mMemoryStats.allocationCount, formatByteSize(mMemoryStats.allocatedBytes),
+                formatByteSize(mMemoryStats.requestedBytes), formatByteSize(mMemoryStats.peakBytes));
         }
     }
 }
@@ -54,6 +54,27 @@ namespace Falcor
         {
             uint2 dims;                                         ///< Width, height of the swap chain
             ResourceFormat format = ResourceFormat::Unknown;    ///< Format to use for texture creation
+            bool aliasTransientResources = false;               ///< Share resources between transient fields with disjoint lifetimes
+        };
+
+        /** Memory usage of the resources allocated by the cache.
+        */
+        struct MemoryStats
+        {
+            uint32_t fieldCount = 0;        ///< Number of resources requested by the graph (after merging aliased fields).
+            uint32_t allocationCount = 0;   ///< Number of resources actually created.
+            uint64_t requestedBytes = 0;    ///< Summed size of all requested resources, i.e. the memory needed without aliasing.
+            uint64_t allocatedBytes = 0;    ///< Size of all created resources.
+            uint64_t peakBytes = 0;         ///< Largest amount of memory live at any point of the execution order. Lower bound for allocatedBytes.
+        };
+
+        /** Handle to a resource in the cache, see getResourceHandle().
+        */
+        struct ResourceHandle
+        {
+            static constexpr uint32_t kInvalidIndex = uint32_t(-1);
+            uint32_t index = kInvalidIndex;         ///< Index of the graph resource, or kInvalidIndex if the name is not a registered field.
+            uint32_t externalIndex = kInvalidIndex; ///< Index of the external resource slot with the same name.
         };
 
         /** Add/Remove reference to a graph input resource not owned by the cache
@@ -75,21 +96,46 @@ namespace Falcor
         */
         const Resource::SharedPtr& getResource(const std::string& name) const;
 
+        /** Get a handle to a resource by name. The handle stays valid until the cache is reset.
+            Looking up resources by handle is allocation-free, which makes it the preferred way to query resources every frame.
+            \param[in] name String in the format of PassName.FieldName
+        */
+        ResourceHandle getResourceHandle(const std::string& name);
+
+        /** Get a resource by handle. External resources registered under the same name take precedence, as for getResource(name).
+        */
+        const Resource::SharedPtr& getResource(const ResourceHandle& handle) const
+        {
+            static const Resource::SharedPtr pNull;
+            if (handle.externalIndex != ResourceHandle::kInvalidIndex && mExternalResources[handle.externalIndex]) return mExternalResources[handle.externalIndex];
+            return handle.index != ResourceHandle::kInvalidIndex ? mResourceData[handle.index].pResource : pNull;
+        }
+
+        /** Get a unique identifier of the cache's current set of resources. It changes when the cache is reset, invalidating all handles.
+        */
+        uint64_t getId() const { return mId; }
+
         /** Get the field-reflection of a resource
         */
         const RenderPassReflection::Field& getResourceReflection(const std::string& name) const;
 
         /** Allocate all resources that need to be created/updated.
             This includes new resources, resources whose properties have been updated since last allocation call.
+            If params.aliasTransientResources is set, transient fields whose lifetimes don't overlap and whose resolved
+            properties are identical share a single resource. Graph outputs, internal and persistent fields always get a dedicated resource.
         */
         void allocateResources(Device* pDevice, const DefaultProperties& params);
 
+        /** Get the memory usage of the last allocateResources() call.
+        */
+        const MemoryStats& getMemoryStats() const { return mMemoryStats; }
+
         /** Clears all registered field/resource properties and allocated resources.
         */
         void reset();
 
     private:
-        ResourceCache() = default;
+        ResourceCache();
 
         struct ResourceData
         {
@@ -104,8 +150,14 @@ namespace Falcor
         std::unordered_map<std::string, uint32_t> mNameToIndex;
         std::vector<ResourceData> mResourceData;
 
-        // References to output resources not to be allocated by the render graph
-        ResourcesMap mExternalResources;
+        // References to output resources not to be allocated by the render graph.
+        // Resources are stored in slots which are never removed, so that handles to them stay valid. Unregistered slots are null.
+        std::unordered_map<std::string, uint32_t> mExternalNameToIndex;
+        std::vector<Resource::SharedPtr> mExternalResources;
+
+        uint64_t mId;
+
+        MemoryStats mMemoryStats;
     };
 
 }
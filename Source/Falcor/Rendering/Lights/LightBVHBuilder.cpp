@@ -29,6 +29,7 @@
 #include "Core/Assert.h"
 #include "Core/Errors.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 #include "Utils/Timing/Profiler.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include <algorithm>
@@ -45,6 +46,30 @@ namespace
     const uint32_t kMaxLeafTriangleCount = 1 << PackedNode::kTriangleCountBits;
     const uint32_t kMaxLeafTriangleOffset = 1 << PackedNode::kTriangleOffsetBits;
 
+    // Subtrees with at least this many triangles are built as separate tasks.
+    const uint32_t kParallelSubtreeTriangleCount = 1 << 14;
+
+    // Nodes with at least this many triangles evaluate the split candidates for each axis in parallel.
+    const uint32_t kParallelBinningTriangleCount = 1 << 16;
+
+    /** Offsets the node and triangle references of a node that was built into a separate subtree output.
+        Only the first dword is modified, so the packed node attributes are left bit-identical.
+    */
+    void relocateNode(PackedNode& node, uint32_t nodeOffset, uint32_t triangleOffset)
+    {
+        if (node.isLeaf())
+        {
+            const uint32_t offsetMask = kMaxLeafTriangleOffset - 1;
+            uint32_t offset = (node.data[0].x & offsetMask) + triangleOffset;
+            FALCOR_ASSERT(offset < kMaxLeafTriangleOffset);
+            node.data[0].x = (node.data[0].x & ~offsetMask) | offset;
+        }
+        else
+        {
+            node.data[0].x += nodeOffset;
+        }
+    }
+
     inline float safeACos(float v)
     {
         return std::acos(glm::clamp(v, -1.0f, 1.0f));
@@ -247,7 +272,7 @@ namespace Falcor
 
         // Create list of triangles that should be included in BVH.
         // For each triangle, precompute data we need for the build.
-        BuildingData data(bvh.mNodes);
+        BuildingData data;
         data.trianglesData.reserve(triangles.size());
 
         for (size_t i = 0; i < triangles.size(); i++)
@@ -286,17 +311,17 @@ namespace Falcor
         // To be grossly conservative, assume each triangle requires two nodes.
         // This is only system RAM and shouldn't be that much, so it's not worth being more careful about it.
         // TODO: Better estimate of how many nodes we will need.
-        data.nodes.clear();
-        data.nodes.reserve(2 * data.trianglesData.size());
-        data.triangleIndices.reserve(data.trianglesData.size());
+        BuildOutput output;
+        output.nodes.reserve(2 * data.trianglesData.size());
+        output.triangleIndices.reserve(data.trianglesData.size());
 
         const uint64_t invalidBitmask = std::numeric_limits<uint64_t>::max();
         data.triangleBitmasks.resize(triangles.size(), invalidBitmask); // This is sized based on input triangle count, as it's indexed by global triangle index.
 
         // Build the tree.
         SplitHeuristicFunction splitFunc = getSplitFunction(mOptions.splitHeuristicSelection);
-        buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data);
-        FALCOR_ASSERT(!data.nodes.empty());
+        buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data, output);
+        FALCOR_ASSERT(!output.nodes.empty());
 
         size_t numValid = 0;
         for (auto mask : data.triangleBitmasks)
@@ -305,12 +330,13 @@ namespace Falcor
 
         // Compute per-node light bounding cones.
         float cosConeAngle;
-        computeLightingConesInternal(0, data, cosConeAngle);
+        computeLightingConesInternal(0, output.nodes, cosConeAngle);
 
         // The BVH is ready, mark it as valid and upload the data.
+        bvh.mNodes = std::move(output.nodes);
         bvh.mIsValid = true;
         bvh.mMaxTriangleCountPerLeaf = mOptions.maxTriangleCountPerLeaf;
-        bvh.uploadCPUBuffers(data.triangleIndices, data.triangleBitmasks);
+        bvh.uploadCPUBuffers(output.triangleIndices, data.triangleBitmasks);
 
         // Computate metadata.
         bvh.finalize();
@@ -357,7 +383,7 @@ namespace Falcor
         return optionsChanged;
     }
 
-    uint32_t LightBVHBuilder::buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data)
+    uint32_t LightBVHBuilder::buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data, BuildOutput& output)
     {
         FALCOR_ASSERT(triangleRange.begin < triangleRange.end);
 
@@ -371,10 +397,8 @@ namespace Falcor
         }
         FALCOR_ASSERT(nodeBounds.valid());
 
-        data.currentNodeFlux = nodeFlux;
-
         bool trySplitting = triangleRange.length() > (options.createLeavesASAP ? options.maxTriangleCountPerLeaf : 1);
-        const SplitResult splitResult = trySplitting ? splitHeuristic(data, triangleRange, nodeBounds, options) : SplitResult();
+        const SplitResult splitResult = trySplitting ? splitHeuristic(data, triangleRange, nodeBounds, nodeFlux, options) : SplitResult();
 
         // If we should split, then create an internal node and split.
         if (splitResult.isValid())
@@ -386,9 +410,9 @@ namespace Falcor
             std::nth_element(std::begin(data.trianglesData) + triangleRange.begin, std::begin(data.trianglesData) + splitResult.triangleIndex, std::begin(data.trianglesData) + triangleRange.end, comp);
 
             // Allocate internal node.
-            FALCOR_ASSERT(data.nodes.size() < std::numeric_limits<uint32_t>::max());
-            const uint32_t nodeIndex = (uint32_t)data.nodes.size();
-            data.nodes.push_back({});
+            FALCOR_ASSERT(output.nodes.size() < std::numeric_limits<uint32_t>::max());
+            const uint32_t nodeIndex = (uint32_t)output.nodes.size();
+            output.nodes.push_back({});
 
             InternalNode node = {};
             node.attribs.setAABB(nodeBounds.minPoint, nodeBounds.maxPoint);
@@ -402,13 +426,52 @@ namespace Falcor
                 throw RuntimeError("BVH depth of {} reached. Maximum of {} allowed.", depth + 1, kMaxBVHDepth);
             }
 
-            uint32_t leftIndex = buildInternal(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, Range(triangleRange.begin, splitResult.triangleIndex), data);
-            uint32_t rightIndex = buildInternal(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, Range(splitResult.triangleIndex, triangleRange.end), data);
+            const Range leftRange(triangleRange.begin, splitResult.triangleIndex);
+            const Range rightRange(splitResult.triangleIndex, triangleRange.end);
+
+            uint32_t leftIndex;
+            uint32_t rightIndex;
+            if (Threading::isStarted() && rightRange.length() >= kParallelSubtreeTriangleCount)
+            {
+                // Build the right subtree in a separate task while the left subtree is built in place.
+                // The right subtree is then appended, which yields the same layout as the serial depth-first build.
+                BuildOutput rightOutput;
+                Threading::Task rightTask = Threading::dispatchTask([&]()
+                {
+                    buildInternal(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, rightRange, data, rightOutput);
+                });
+
+                try
+                {
+                    leftIndex = buildInternal(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, leftRange, data, output);
+                }
+                catch (...)
+                {
+                    // The task references local state, so it needs to finish before unwinding.
+                    try { rightTask.finish(); } catch (...) {}
+                    throw;
+                }
+                rightTask.finish();
+
+                FALCOR_ASSERT(output.nodes.size() + rightOutput.nodes.size() < std::numeric_limits<uint32_t>::max());
+                const uint32_t nodeOffset = (uint32_t)output.nodes.size();
+                const uint32_t triangleOffset = (uint32_t)output.triangleIndices.size();
+                for (auto& rightNode : rightOutput.nodes) relocateNode(rightNode, nodeOffset, triangleOffset);
+
+                output.nodes.insert(output.nodes.end(), rightOutput.nodes.begin(), rightOutput.nodes.end());
+                output.triangleIndices.insert(output.triangleIndices.end(), rightOutput.triangleIndices.begin(), rightOutput.triangleIndices.end());
+                rightIndex = nodeOffset;
+            }
+            else
+            {
+                leftIndex = buildInternal(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, leftRange, data, output);
+                rightIndex = buildInternal(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, rightRange, data, output);
+            }
 
             FALCOR_ASSERT(leftIndex == nodeIndex + 1); // The left node should always be placed immediately after the current node.
             node.rightChildIdx = rightIndex;
 
-            data.nodes[nodeIndex].setInternalNode(node);
+            output.nodes[nodeIndex].setInternalNode(node);
             return nodeIndex;
         }
         else // No split => create leaf node
@@ -416,9 +479,9 @@ namespace Falcor
             FALCOR_ASSERT(triangleRange.length() <= options.maxTriangleCountPerLeaf);
 
             // Allocate leaf node.
-            FALCOR_ASSERT(data.nodes.size() < std::numeric_limits<uint32_t>::max());
-            const uint32_t nodeIndex = (uint32_t)data.nodes.size();
-            data.nodes.push_back({});
+            FALCOR_ASSERT(output.nodes.size() < std::numeric_limits<uint32_t>::max());
+            const uint32_t nodeIndex = (uint32_t)output.nodes.size();
+            output.nodes.push_back({});
 
             LeafNode node = {};
             node.attribs.setAABB(nodeBounds.minPoint, nodeBounds.maxPoint);
@@ -428,36 +491,36 @@ namespace Falcor
             node.attribs.cosConeAngle = cosTheta;
 
             node.triangleCount = triangleRange.length();
-            node.triangleOffset = (uint32_t)data.triangleIndices.size();
+            node.triangleOffset = (uint32_t)output.triangleIndices.size();
             FALCOR_ASSERT(node.triangleCount < kMaxLeafTriangleCount);
             FALCOR_ASSERT(node.triangleOffset < kMaxLeafTriangleOffset);
 
             for (uint32_t triangleIdx = triangleRange.begin, index = 0; triangleIdx < triangleRange.end; ++triangleIdx, ++index)
             {
                 uint32_t globalTriangleIndex = data.trianglesData[triangleIdx].triangleIndex;
-                data.triangleIndices.push_back(globalTriangleIndex);
+                output.triangleIndices.push_back(globalTriangleIndex);
                 data.triangleBitmasks[globalTriangleIndex] = bitmask;
             }
-            FALCOR_ASSERT(data.triangleIndices.size() == node.triangleOffset + node.triangleCount);
+            FALCOR_ASSERT(output.triangleIndices.size() == node.triangleOffset + node.triangleCount);
 
-            data.nodes[nodeIndex].setLeafNode(node);
+            output.nodes[nodeIndex].setLeafNode(node);
             return nodeIndex;
         }
     }
 
-    float3 LightBVHBuilder::computeLightingConesInternal(const uint32_t nodeIndex, BuildingData& data, float& cosConeAngle)
+    float3 LightBVHBuilder::computeLightingConesInternal(const uint32_t nodeIndex, std::vector<PackedNode>& nodes, float& cosConeAngle)
     {
-        if (!data.nodes[nodeIndex].isLeaf())
+        if (!nodes[nodeIndex].isLeaf())
         {
-            auto node = data.nodes[nodeIndex].getInternalNode();
+            auto node = nodes[nodeIndex].getInternalNode();
 
             uint32_t leftIndex = nodeIndex + 1;
             uint32_t rightIndex = node.rightChildIdx;
 
             float leftNodeCosConeAngle = kInvalidCosConeAngle;
-            float3 leftNodeConeDirection = computeLightingConesInternal(leftIndex, data, leftNodeCosConeAngle);
+            float3 leftNodeConeDirection = computeLightingConesInternal(leftIndex, nodes, leftNodeCosConeAngle);
             float rightNodeCosConeAngle = kInvalidCosConeAngle;
-            float3 rightNodeConeDirection = computeLightingConesInternal(rightIndex, data, rightNodeCosConeAngle);
+            float3 rightNodeConeDirection = computeLightingConesInternal(rightIndex, nodes, rightNodeCosConeAngle);
 
             // TODO: Asserts in coneUnion
             //float3 coneDirection = coneUnion(leftNodeConeDirection, leftNodeCosConeAngle,
@@ -467,14 +530,14 @@ namespace Falcor
             // Update bounding cone.
             node.attribs.cosConeAngle = cosConeAngle;
             node.attribs.coneDirection = coneDirection;
-            data.nodes[nodeIndex].setNodeAttributes(node.attribs);
+            nodes[nodeIndex].setNodeAttributes(node.attribs);
 
             return coneDirection;
         }
         else
         {
             // Load bounding cone.
-            auto attribs = data.nodes[nodeIndex].getNodeAttributes();
+            auto attribs = nodes[nodeIndex].getNodeAttributes();
             cosConeAngle = attribs.cosConeAngle;
             return attribs.coneDirection;
         }
@@ -505,7 +568,7 @@ namespace Falcor
         return coneDirection;
     }
 
-    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithEqual(const BuildingData& /*data*/, const Range& triangleRange, const AABB& nodeBounds, const Options& /*parameters*/)
+    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithEqual(const BuildingData& /*data*/, const Range& triangleRange, const AABB& nodeBounds, float /*nodeFlux*/, const Options& /*parameters*/)
     {
         // Find the largest dimension.
         float3 dimensions = nodeBounds.extent();
@@ -520,6 +583,58 @@ namespace Falcor
         return result;
     }
 
+    const std::vector<uint32_t>& LightBVHBuilder::computeBinIds(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, uint32_t dimension, uint32_t binCount)
+    {
+        static thread_local std::vector<uint32_t> binIds;
+        binIds.resize(triangleRange.length());
+
+        float bmin = nodeBounds.minPoint[dimension], bmax = nodeBounds.maxPoint[dimension];
+        float w = bmax - bmin;
+        FALCOR_ASSERT(w >= 0.f); // The node bounds can be zero if all primitives are axis-aligned and coplanar
+        float scale = w > FLT_MIN ? (float)binCount / w : 0.f;
+
+        const TriangleSortData* pTriangles = data.trianglesData.data() + triangleRange.begin;
+        for (uint32_t i = 0; i < triangleRange.length(); ++i)
+        {
+            float p = pTriangles[i].bounds.center()[dimension];
+            FALCOR_ASSERT(bmin <= p && p <= bmax);
+            binIds[i] = std::min((uint32_t)((p - bmin) * scale), binCount - 1);
+        }
+
+        return binIds;
+    }
+
+    std::pair<float, LightBVHBuilder::SplitResult> LightBVHBuilder::computeBestAxisSplit(const Range& triangleRange, const Options& parameters, uint32_t largestDimension, const std::function<std::pair<float, SplitResult>(uint32_t)>& binAlongDimension)
+    {
+        std::pair<float, SplitResult> axisSplits[3];
+        for (auto& axisSplit : axisSplits) axisSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
+
+        if (parameters.splitAlongLargest)
+        {
+            axisSplits[largestDimension] = binAlongDimension(largestDimension);
+        }
+        else if (triangleRange.length() >= kParallelBinningTriangleCount)
+        {
+            Threading::parallelFor(0, 3, [&](size_t dimension) { axisSplits[dimension] = binAlongDimension((uint32_t)dimension); }, 1);
+        }
+        else
+        {
+            for (uint32_t dimension = 0; dimension < 3; ++dimension) axisSplits[dimension] = binAlongDimension(dimension);
+        }
+
+        // Select the cheapest split in dimension order, so the result does not depend on the evaluation order.
+        std::pair<float, SplitResult> overallBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
+        for (const auto& axisSplit : axisSplits)
+        {
+            if (axisSplit.second.isValid() && axisSplit.first < overallBestSplit.first)
+            {
+                overallBestSplit = axisSplit;
+                FALCOR_ASSERT(triangleRange.begin < overallBestSplit.second.triangleIndex && overallBestSplit.second.triangleIndex < triangleRange.end);
+            }
+        }
+        return overallBestSplit;
+    }
+
     /** Evaluates the SAH cost metric for a node.
         If the node is empty (invalid bounds), the cost evaluates to zero.
         See Eqn 15 in Moreau and Clarberg, "Importance Sampling of Many Lights on the GPU", Ray Tracing Gems, Ch. 18, 2019.
@@ -532,10 +647,9 @@ namespace Falcor
         return cost;
     }
 
-    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)
+    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float nodeFlux, const Options& parameters)
     {
-        std::pair<float, SplitResult> overallBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
-        FALCOR_ASSERT(!overallBestSplit.second.isValid());
+        using AxisSplit = std::pair<float, SplitResult>;
 
         struct Bin
         {
@@ -553,34 +667,22 @@ namespace Falcor
         };
 
         FALCOR_ASSERT(parameters.binCount > 1);
-        std::vector<Bin> bins(parameters.binCount);
-        std::vector<float> costs(parameters.binCount - 1);
 
         /** Helper function that computes the best split along the given dimension using the SAH metric.
             The triangles are binned to n bins, storing only the aggregate parameters (triangle count and bounds).
             Then the cost metric is evaluated for each of the n-1 potential splits.
+            Returns an invalid split if all lights fall on either side of the best split.
         */
-        const auto binAlongDimension = [&bins, &costs, &triangleRange, &data, &parameters, &overallBestSplit, &nodeBounds](uint32_t dimension)
+        const auto binAlongDimension = [&triangleRange, &data, &parameters, &nodeBounds](uint32_t dimension) -> AxisSplit
         {
-            // Helper to compute the bin id for a given triangle.
-            auto getBinId = [&](const TriangleSortData& td)
-            {
-                float bmin = nodeBounds.minPoint[dimension], bmax = nodeBounds.maxPoint[dimension];
-                FALCOR_ASSERT(bmin < bmax);
-                float scale = (float)parameters.binCount / (bmax - bmin);
-                float p = td.bounds.center()[dimension];
-                FALCOR_ASSERT(bmin <= p && p <= bmax);
-                return std::min((uint32_t)((p - bmin) * scale), parameters.binCount - 1);
-            };
-
-            // Reset the bins.
-            for (Bin& bin : bins) bin = Bin();
+            std::vector<Bin> bins(parameters.binCount);
+            std::vector<float> costs(parameters.binCount - 1);
 
             // Fill the bins with all triangles.
+            const std::vector<uint32_t>& binIds = computeBinIds(data, triangleRange, nodeBounds, dimension, parameters.binCount);
             for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
             {
-                const auto& td = data.trianglesData[i];
-                bins[getBinId(td)] |= td;
+                bins[binIds[i - triangleRange.begin]] |= data.trianglesData[i];
             }
 
             // First, compute A_j(L) * N_j(L) by sweeping over the bins from left to right.
@@ -601,7 +703,7 @@ namespace Falcor
             }
 
             // Compute the cheapest split along the current dimension.
-            std::pair<float, SplitResult> axisBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult{ dimension, 0 });
+            AxisSplit axisBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult{ dimension, 0 });
             for (uint32_t i = 0, triIdx = triangleRange.begin; i < costs.size(); ++i)
             {
                 triIdx += bins[i].triangleCount;
@@ -614,38 +716,24 @@ namespace Falcor
 
             // Early out if all lights fall on either side of the split.
             if (axisBestSplit.second.triangleIndex == triangleRange.begin ||
-                axisBestSplit.second.triangleIndex == triangleRange.end) return;
+                axisBestSplit.second.triangleIndex == triangleRange.end) return AxisSplit(std::numeric_limits<float>::infinity(), SplitResult());
 
-            if (axisBestSplit.first < overallBestSplit.first)
-            {
-                overallBestSplit = axisBestSplit;
-                FALCOR_ASSERT(triangleRange.begin < overallBestSplit.second.triangleIndex && overallBestSplit.second.triangleIndex < triangleRange.end);
-            }
+            return axisBestSplit;
         };
 
-        if (parameters.splitAlongLargest)
-        {
-            // Find the largest dimension.
-            float3 dimensions = nodeBounds.extent();
-            uint32_t largestDimension = dimensions[2] >= dimensions[0] && dimensions[2] >= dimensions[1] ?
-                2 : (dimensions[1] >= dimensions[0] && dimensions[1] >= dimensions[2] ? 1 : 0);
+        // Find the largest dimension.
+        float3 dimensions = nodeBounds.extent();
+        uint32_t largestDimension = dimensions[2] >= dimensions[0] && dimensions[2] >= dimensions[1] ?
+            2 : (dimensions[1] >= dimensions[0] && dimensions[1] >= dimensions[2] ? 1 : 0);
 
-            binAlongDimension(largestDimension);
-        }
-        else
-        {
-            for (uint32_t dimension = 0; dimension < 3; ++dimension)
-            {
-                binAlongDimension(dimension);
-            }
-        }
+        const AxisSplit overallBestSplit = computeBestAxisSplit(triangleRange, parameters, largestDimension, binAlongDimension);
 
         // If we couldn't find a valid split, create leaf node immediately if possible or revert to equal splitting.
         if (!overallBestSplit.second.isValid())
         {
             if (triangleRange.length() <= parameters.maxTriangleCountPerLeaf) return SplitResult();
             logWarning("LightBVHBuilder::computeSplitWithBinnedSAH() was not able to compute a proper split: reverting to LightBVHBuilder::computeSplitWithEqual()");
-            return computeSplitWithEqual(data, triangleRange, nodeBounds, parameters);
+            return computeSplitWithEqual(data, triangleRange, nodeBounds, nodeFlux, parameters);
         }
 
         // If the best split we found is more expensive than the cost of a leaf node (and we can create one), then create a leaf node.
@@ -687,10 +775,9 @@ namespace Falcor
         return cost;
     }
 
-    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)
+    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float nodeFlux, const Options& parameters)
     {
-        std::pair<float, SplitResult> overallBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
-        FALCOR_ASSERT(!overallBestSplit.second.isValid());
+        using AxisSplit = std::pair<float, SplitResult>;
 
         // Find the largest dimension.
         float3 dimensions = nodeBounds.extent();
@@ -719,8 +806,6 @@ namespace Falcor
         };
 
         FALCOR_ASSERT(parameters.binCount > 1);
-        std::vector<Bin> bins(parameters.binCount);
-        std::vector<float> costs(parameters.binCount - 1);
 
         /** Helper function that computes the best split along the given dimension using the SAOH metric.
             The triangles are binned to n bins, storing only the aggregate parameters (triangle count, bounds, flux, and cone direction).
@@ -728,29 +813,19 @@ namespace Falcor
             Note that while the bounds and flux are accurately represented by the aggregated parameters,
             the bounding cones are approximates based on the bins' bounding cones. This is less expensive,
             but also less precise than computing them directly from the triangles.
+            Returns an invalid split if all lights fall on either side of the best split.
         */
-        const auto binAlongDimension = [&bins, &costs, &triangleRange, &data, &parameters, &overallBestSplit, &nodeBounds, largestDimension, dimensions](uint32_t dimension)
+        const auto binAlongDimension = [&triangleRange, &data, &parameters, &nodeBounds, largestDimension, dimensions](uint32_t dimension) -> AxisSplit
         {
-            // Helper to compute the bin id for a given triangle.
-            auto getBinId = [&](const TriangleSortData& td)
-            {
-                float bmin = nodeBounds.minPoint[dimension], bmax = nodeBounds.maxPoint[dimension];
-                float w = bmax - bmin;
-                FALCOR_ASSERT(w >= 0.f); // The node bounds can be zero if all primitives are axis-aligned and coplanar
-                float scale = w > FLT_MIN ? (float)parameters.binCount / w : 0.f;
-                float p = td.bounds.center()[dimension];
-                FALCOR_ASSERT(bmin <= p && p <= bmax);
-                return std::min((uint32_t)((p - bmin) * scale), parameters.binCount - 1);
-            };
-
-            // Reset the bins.
-            for (Bin& bin : bins) bin = Bin();
+            std::vector<Bin> bins(parameters.binCount);
+            std::vector<float> costs(parameters.binCount - 1);
 
             // Fill the bins with all triangles.
+            // The bin ids are computed once and reused for the bounding cone pass below.
+            const std::vector<uint32_t>& binIds = computeBinIds(data, triangleRange, nodeBounds, dimension, parameters.binCount);
             for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
             {
-                const auto& td = data.trianglesData[i];
-                bins[getBinId(td)] |= td;
+                bins[binIds[i - triangleRange.begin]] |= data.trianglesData[i];
             }
 
             // Compute the lighting cones for each bin.
@@ -765,7 +840,7 @@ namespace Falcor
             for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
             {
                 const auto& td = data.trianglesData[i];
-                Bin& bin = bins[getBinId(td)];
+                Bin& bin = bins[binIds[i - triangleRange.begin]];
                 bin.cosConeAngle = computeCosConeAngle(bin.coneDirection, bin.cosConeAngle, td.coneDirection, td.cosConeAngle);
             }
 
@@ -813,7 +888,7 @@ namespace Falcor
             }
 
             // Compute the cheapest split along the current dimension.
-            std::pair<float, SplitResult> axisBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult{ dimension, 0 });
+            AxisSplit axisBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult{ dimension, 0 });
             for (uint32_t i = 0, triIdx = triangleRange.begin; i < costs.size(); ++i)
             {
                 triIdx += bins[i].triangleCount;
@@ -829,34 +904,20 @@ namespace Falcor
 
             // Early out if all lights fall on either side of the split.
             if (axisBestSplit.second.triangleIndex == triangleRange.begin ||
-                axisBestSplit.second.triangleIndex == triangleRange.end) return;
+                axisBestSplit.second.triangleIndex == triangleRange.end) return AxisSplit(std::numeric_limits<float>::infinity(), SplitResult());
 
-            if (axisBestSplit.first < overallBestSplit.first)
-            {
-                overallBestSplit = axisBestSplit;
-                FALCOR_ASSERT(triangleRange.begin < overallBestSplit.second.triangleIndex && overallBestSplit.second.triangleIndex < triangleRange.end);
-            }
+            return axisBestSplit;
         };
 
         // Compute the best split.
-        if (parameters.splitAlongLargest)
-        {
-            binAlongDimension(largestDimension);
-        }
-        else
-        {
-            for (uint32_t dimension = 0; dimension < 3; ++dimension)
-            {
-                binAlongDimension(dimension);
-            }
-        }
+        const AxisSplit overallBestSplit = computeBestAxisSplit(triangleRange, parameters, largestDimension, binAlongDimension);
 
         // If we couldn't find a valid split, create leaf node immediately if possible or revert to equal splitting.
         if (!overallBestSplit.second.isValid())
         {
             if (triangleRange.length() <= parameters.maxTriangleCountPerLeaf) return SplitResult();
             logWarning("LightBVHBuilder::computeSplitWithBinnedSAOH() was not able to compute a proper split: reverting to LightBVHBuilder::computeSplitWithEqual()");
-            return computeSplitWithEqual(data, triangleRange, nodeBounds, parameters);
+            return computeSplitWithEqual(data, triangleRange, nodeBounds, nodeFlux, parameters);
         }
 
         // If the best split we found is more expensive than the cost of a leaf node (and we can create one), then create a leaf node.
@@ -866,7 +927,7 @@ namespace Falcor
             // Evaluate the cost metric for the node. This requires us to first compute the cone angle.
             float cosTheta = kInvalidCosConeAngle;
             computeLightingCone(triangleRange, data, cosTheta);
-            float leafCost = evalSAOH(nodeBounds, data.currentNodeFlux, cosTheta, parameters);
+            float leafCost = evalSAOH(nodeBounds, nodeFlux, cosTheta, parameters);
             if (leafCost <= overallBestSplit.first) return SplitResult();
         }
 
@@ -34,6 +34,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace Falcor
@@ -122,44 +123,51 @@ namespace Falcor
 
         struct BuildingData
         {
-            std::vector<PackedNode>& nodes;                 ///< BVH nodes generated by the builder.
-            std::vector<TriangleSortData> trianglesData;    ///< Compact list of triangles to include in build.
-            std::vector<uint32_t> triangleIndices;          ///< Triangle indices sorted by leaf node. Each leaf node refers to a contiguous array of triangle indices.
+            std::vector<TriangleSortData> trianglesData;    ///< Compact list of triangles to include in build. Subtrees built in parallel operate on disjoint ranges.
             std::vector<uint64_t> triangleBitmasks;         ///< Array containing the per triangle bit pattern retracing the tree traversal to reach the triangle: 0=left child, 1=right child; this array gets filled in during the build process. Indexed by global triangle index.
-            float currentNodeFlux = 0.f;                    ///< Used by computeSAOHSplit() as the leaf creation cost.
+        };
 
-            BuildingData(std::vector<PackedNode>& bvhNodes) : nodes(bvhNodes) {}
+        /** Nodes and triangle indices generated for a subtree.
+            Subtrees that are built in parallel write to separate outputs, which are appended to the parent's output in depth-first order.
+        */
+        struct BuildOutput
+        {
+            std::vector<PackedNode> nodes;                  ///< BVH nodes generated by the builder.
+            std::vector<uint32_t> triangleIndices;          ///< Triangle indices sorted by leaf node. Each leaf node refers to a contiguous array of triangle indices.
         };
 
         /** Compute the split according to a specified heuristic.
             \param[in] data Prepared light data.
             \param[in] triangleRange Range of triangles to process.
             \param[in] nodeBounds Bounds for the node to be splitted.
+            \param[in] nodeFlux Total flux of the node to be splitted. Used by computeSplitWithBinnedSAOH() as the leaf creation cost.
             \param[in] parameters Various parameters defining how the building should occur.
         */
-        using SplitHeuristicFunction = std::function<SplitResult(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)>;
+        using SplitHeuristicFunction = std::function<SplitResult(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float nodeFlux, const Options& parameters)>;
 
         /** Renders the UI with builder options.
         */
         bool renderOptions(Gui::Widgets& widget, Options& options) const;
 
         /** Recursive BVH build.
+            Large subtrees are built in parallel. The resulting tree is identical to a serial depth-first build.
             \param[in] splitHeuristic The splitting heuristic to be used.
             \param[in] bitmask Bit pattern retracing the tree traversal to reach the node to be built: 0=left child, 1=right child.
             \param[in] depth Depth of the node to be built
             \param[in] triangleRange Range of triangles to process.
             \param[in,out] data Prepared light data.
+            \param[in,out] output Output for the generated nodes and triangle indices. Node and triangle offsets are relative to this output.
             \return Index of the allocated node.
         */
-        uint32_t buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data);
+        static uint32_t buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data, BuildOutput& output);
 
         /** Recursive computation of lighting cones for all internal nodes.
             \param[in] nodeIndex Index of the current node.
-            \param[in,out] data Updated node data.
+            \param[in,out] nodes Updated node data.
             \param[out] cosConeAngle Cosine of the cone angle of the lighting cone for the current node, or kInvalidCosConeAngle if the cone is invalid.
             \return direction of the lighting cone for the current node.
         */
-        float3 computeLightingConesInternal(const uint32_t nodeIndex, BuildingData& data, float& cosConeAngle);
+        float3 computeLightingConesInternal(const uint32_t nodeIndex, std::vector<PackedNode>& nodes, float& cosConeAngle);
 
         /** Compute lighting cone for a range of triangles.
             \param[in] triangleRange Range of triangles to process.
@@ -169,10 +177,31 @@ namespace Falcor
         */
         static float3 computeLightingCone(const Range& triangleRange, const BuildingData& data, float& cosTheta);
 
+        /** Compute the bin index of each triangle in a range along the given dimension.
+            The indices are computed in a separate pass so that the binning loops only need a table lookup.
+            \param[in] data Prepared light data.
+            \param[in] triangleRange Range of triangles to process.
+            \param[in] nodeBounds Bounds for the node to be splitted.
+            \param[in] dimension Dimension along which to bin.
+            \param[in] binCount Number of bins.
+            \return Thread-local array of bin indices, indexed relative to the start of the range. It is valid until the next call on the same thread.
+        */
+        static const std::vector<uint32_t>& computeBinIds(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, uint32_t dimension, uint32_t binCount);
+
+        /** Evaluate the split candidates along each dimension and return the cheapest valid split.
+            On equal cost, the lower dimension is selected. The dimensions are evaluated in parallel for large nodes.
+            \param[in] triangleRange Range of triangles to process.
+            \param[in] parameters Various parameters defining how the building should occur.
+            \param[in] largestDimension Largest dimension of the node bounds. Only this dimension is evaluated if 'splitAlongLargest' is set.
+            \param[in] binAlongDimension Function returning the cost and split for a dimension, or an invalid split if there is none.
+            \return Cost and split. The split is invalid if no dimension has a valid split.
+        */
+        static std::pair<float, SplitResult> computeBestAxisSplit(const Range& triangleRange, const Options& parameters, uint32_t largestDimension, const std::function<std::pair<float, SplitResult>(uint32_t)>& binAlongDimension);
+
         // See the documentation of SplitHeuristicFunction.
-        static SplitResult computeSplitWithEqual(const BuildingData& /*data*/, const Range& triangleRange, const AABB& nodeBounds, const Options& /*parameters*/);
-        static SplitResult computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters);
-        static SplitResult computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters);
+        static SplitResult computeSplitWithEqual(const BuildingData& /*data*/, const Range& triangleRange, const AABB& nodeBounds, float /*nodeFlux*/, const Options& /*parameters*/);
+        static SplitResult computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float /*nodeFlux*/, const Options& parameters);
+        static SplitResult computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float nodeFlux, const Options& parameters);
 
         static SplitHeuristicFunction getSplitFunction(SplitHeuristic heuristic);
 
@@ -139,11 +139,9 @@ namespace Falcor
             if (widget.var("roughness", roughness, .0f, 1.f, 0.001f)) setRoughness(roughness);
         }
 
-        const auto& profileN = scene->getSpectralProfile(getIORSpectralProfile().first.get());
-        const auto& profileK = scene->getSpectralProfile(getIORSpectralProfile().second.get());
         widget.text("index of refraction");
-        widget.graph("", BasicMaterial::UIHelpers::grapher, (void*)&profileN, BasicMaterial::UIHelpers::grapher_bins, 0);
-        widget.graph("", BasicMaterial::UIHelpers::grapher, (void*)&profileK, BasicMaterial::UIHelpers::grapher_bins, 0);
+        BasicMaterial::UIHelpers::graph(widget, "", scene, getIORSpectralProfile().first.get());
+        BasicMaterial::UIHelpers::graph(widget, "", scene, getIORSpectralProfile().second.get());
 
         float extIOR = getExtIndexOfRefraction();
         if (widget.var("ext IOR", extIOR, 1.f, 3.f, 0.1f)) setExtIndexOfRefraction(extIOR);
@@ -123,11 +123,9 @@ namespace Falcor
         float gamma = getGamma();
         if (widget.var("gamma", gamma, .125f, 5.f, 0.01f)) setGamma(gamma);
 
-        const auto& profileN = scene->getSpectralProfile(getIORSpectralProfile().first.get());
-        const auto& profileK = scene->getSpectralProfile(getIORSpectralProfile().second.get());
         widget.text("index of refraction");
-        widget.graph("", BasicMaterial::UIHelpers::grapher, (void*)&profileN, BasicMaterial::UIHelpers::grapher_bins, 0);
-        widget.graph("", BasicMaterial::UIHelpers::grapher, (void*)&profileK, BasicMaterial::UIHelpers::grapher_bins, 0);
+        BasicMaterial::UIHelpers::graph(widget, "", scene, getIORSpectralProfile().first.get());
+        BasicMaterial::UIHelpers::graph(widget, "", scene, getIORSpectralProfile().second.get());
 
         float extIOR = getExtIndexOfRefraction();
         if (widget.var("ext IOR", extIOR, 1.f, 3.f, 0.1f))
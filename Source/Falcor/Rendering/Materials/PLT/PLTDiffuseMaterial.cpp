@@ -114,8 +114,7 @@ namespace Falcor
         const float3& emission = isEmissive() ? scene->getSpectralProfile(getEmissionSpectralProfile().get()).rgb : float3(.0f);
         const float intensity = std::max(1.f,std::max(emission.r, std::max(emission.g, emission.b)));
         if (isEmissive()) {
-            const auto& profile = scene->getSpectralProfile(getEmissionSpectralProfile().get());
-            widget.graph("emission spectrum", BasicMaterial::UIHelpers::grapher, (void*)&profile, BasicMaterial::UIHelpers::grapher_bins, 0);
+            BasicMaterial::UIHelpers::graph(widget, "emission spectrum", scene, getEmissionSpectralProfile().get());
             widget.rgbColor("", emission/intensity);
         }
 
@@ -28,6 +28,7 @@
 #include "AnimatedVertexCache.h"
 #include "Animation.h"
 #include "Core/API/RenderContext.h"
+#include "Core/Platform/OS.h"
 #include "Scene/Scene.h"
 #include "Utils/Timing/Profiler.h"
 
@@ -39,6 +40,46 @@ namespace Falcor
         const std::string kUpdateCurveAABBsFilename = "Scene/Animation/UpdateCurveAABBs.slang";
         const std::string kUpdateCurvePolyTubeVerticesFilename = "Scene/Animation/UpdateCurvePolyTubeVertices.slang";
 
+        const uint32_t kResidentKeyframeCount = 2;  ///< Number of keyframes resident on the GPU per cache (the two bracketing the current time).
+        const uint32_t kPrefetchKeyframeCount = 2;  ///< Number of keyframes following the bracketing ones that are prefetched from the store.
+        const uint32_t kInvalidKeyframe = std::numeric_limits<uint32_t>::max();
+
+        uint32_t getNextKeyframe(uint32_t keyframe, uint32_t keyframeCount, bool loop)
+        {
+            if (keyframe + 1 < keyframeCount) return keyframe + 1;
+            return loop ? 0 : keyframe;
+        }
+
+        /** Assign the two bracketing keyframes to the two resident slots, keeping keyframes that are already resident.
+            \param[in,out] slotKeyframes Keyframe held by each slot.
+            \param[in] keyframes Bracketing keyframes.
+            \param[in] load Function called to load a keyframe into a slot.
+            \return Slot of each bracketing keyframe.
+        */
+        template<typename LoadFunc>
+        uint2 assignKeyframeSlots(uint2& slotKeyframes, uint2 keyframes, LoadFunc load)
+        {
+            auto findSlot = [&](uint32_t keyframe) { return slotKeyframes[0] == keyframe ? 0u : slotKeyframes[1] == keyframe ? 1u : kInvalidKeyframe; };
+
+            uint32_t slotX = findSlot(keyframes.x);
+            if (slotX == kInvalidKeyframe)
+            {
+                slotX = findSlot(keyframes.y) == 0 ? 1 : 0;
+                load(keyframes.x, slotX);
+                slotKeyframes[slotX] = keyframes.x;
+            }
+
+            uint32_t slotY = findSlot(keyframes.y);
+            if (slotY == kInvalidKeyframe)
+            {
+                slotY = 1 - slotX;
+                load(keyframes.y, slotY);
+                slotKeyframes[slotY] = keyframes.y;
+            }
+
+            return uint2(slotX, slotY);
+        }
+
         InterpolationInfo calculateInterpolation(double time, const std::vector<double>& timeSamples, Animation::Behavior preInfinityBehavior, Animation::Behavior postInfinityBehavior)
         {
             if (!std::isfinite(time))
@@ -96,15 +137,27 @@ namespace Falcor
         }
     }
 
-    AnimatedVertexCache::AnimatedVertexCache(std::shared_ptr<Device> pDevice, Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes)
+    AnimatedVertexCache::AnimatedVertexCache(std::shared_ptr<Device> pDevice, Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, VertexCacheStore::SharedPtr pStore)
         : mpDevice(std::move(pDevice))
         , mpScene(pScene)
         , mpPrevVertexData(pPrevVertexData)
-        , mCachedCurves(cachedCurves)
-        , mCachedMeshes(cachedMeshes)
+        , mpStore(std::move(pStore))
+        , mCachedCurves(std::move(cachedCurves))
+        , mCachedMeshes(std::move(cachedMeshes))
     {
         if (mCachedCurves.empty() && mCachedMeshes.empty()) return;
 
+        // Move keyframes that are still held in host memory to a temporary store.
+        if (!mpStore)
+        {
+            auto pWriter = VertexCacheStore::Writer::create(getTempFilePath(), true);
+            for (auto& cache : mCachedCurves) pWriter->addCachedCurve(cache);
+            for (auto& cache : mCachedMeshes) pWriter->addCachedMesh(cache);
+            mpStore = pWriter->finalize(true);
+        }
+
+        validateKeyframeChunks();
+
         if (!mCachedCurves.empty())
         {
             for (auto& cache : mCachedCurves)
@@ -140,19 +193,38 @@ namespace Falcor
         }
     }
 
-    AnimatedVertexCache::UniquePtr AnimatedVertexCache::create(std::shared_ptr<Device> pDevice, Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes)
+    AnimatedVertexCache::UniquePtr AnimatedVertexCache::create(std::shared_ptr<Device> pDevice, Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, VertexCacheStore::SharedPtr pStore)
     {
-        return UniquePtr(new AnimatedVertexCache(std::move(pDevice), pScene, pPrevVertexData, std::move(cachedCurves), std::move(cachedMeshes)));
+        return UniquePtr(new AnimatedVertexCache(std::move(pDevice), pScene, pPrevVertexData, std::move(cachedCurves), std::move(cachedMeshes), std::move(pStore)));
     }
 
     bool AnimatedVertexCache::animate(RenderContext* pRenderContext, double time)
     {
         if (!hasAnimations()) return false;
 
+        InterpolationInfo curveInterpolationInfo{ uint2(0), 0.f };
         if (!mCachedCurves.empty())
         {
             double curveTime = mLoopAnimations ? std::fmod(time, mGlobalCurveAnimationLength) : time;
-            InterpolationInfo interpolationInfo = calculateInterpolation(curveTime, mCurveKeyframeTimes, mPreInfinityBehavior, Animation::Behavior::Constant);
+            curveInterpolationInfo = calculateInterpolation(curveTime, mCurveKeyframeTimes, mPreInfinityBehavior, Animation::Behavior::Constant);
+        }
+
+        if (!mCachedMeshes.empty())
+        {
+            auto postInfinityBehavior = mLoopAnimations ? Animation::Behavior::Cycle : Animation::Behavior::Constant;
+            for (size_t i = 0; i < mMeshInterpolationInfo.size(); i++)
+            {
+                mMeshInterpolationInfo[i] = calculateInterpolation(time, mCachedMeshes[i].timeSamples, mPreInfinityBehavior, postInfinityBehavior);
+            }
+        }
+
+        // Start prefetching the following keyframes before uploading the bracketing ones.
+        updatePrefetchWindow(curveInterpolationInfo);
+
+        if (!mCachedCurves.empty())
+        {
+            // The shaders index the resident keyframe slots.
+            InterpolationInfo interpolationInfo{ makeCurveKeyframesResident(curveInterpolationInfo.keyframeIndices), curveInterpolationInfo.t };
 
             if (mCurveLSSCount > 0)
             {
@@ -170,7 +242,11 @@ namespace Falcor
 
         if (!mCachedMeshes.empty())
         {
-            executeMeshVertexUpdatePass(pRenderContext, time);
+            for (uint32_t i = 0; i < (uint32_t)mMeshInterpolationInfo.size(); i++)
+            {
+                mMeshInterpolationInfo[i].keyframeIndices = makeMeshKeyframesResident(i, mMeshInterpolationInfo[i].keyframeIndices);
+            }
+            executeMeshVertexUpdatePass(pRenderContext);
         }
 
         return true;
@@ -181,7 +257,7 @@ namespace Falcor
         executeCurveLSSVertexUpdatePass(pRenderContext, InterpolationInfo{ uint2(0), 0.f }, true);
         executeCurvePolyTubeVertexUpdatePass(pRenderContext, InterpolationInfo{ uint2(0), 0.f }, true);
 
-        executeMeshVertexUpdatePass(pRenderContext, 0.0f, true);
+        executeMeshVertexUpdatePass(pRenderContext, true);
     }
 
     bool AnimatedVertexCache::hasAnimations() const
@@ -201,6 +277,138 @@ namespace Falcor
         return m;
     }
 
+    void AnimatedVertexCache::validateKeyframeChunks() const
+    {
+        auto validate = [&](const std::vector<double>& timeSamples, uint32_t firstChunk, uint64_t keyframeSize)
+        {
+            if (timeSamples.empty()) throw RuntimeError("Vertex cache has no keyframes.");
+            if ((uint64_t)firstChunk + timeSamples.size() > mpStore->getChunkCount()) throw RuntimeError("Vertex cache keyframes are missing in the vertex cache store.");
+            for (uint32_t i = 0; i < (uint32_t)timeSamples.size(); i++)
+            {
+                if (mpStore->getChunkSize(firstChunk + i) != keyframeSize) throw RuntimeError("Vertex cache keyframe size mismatch.");
+            }
+        };
+
+        for (const auto& cache : mCachedCurves) validate(cache.timeSamples, cache.firstChunk, cache.vertexCount * sizeof(DynamicCurveVertexData));
+        for (const auto& cache : mCachedMeshes) validate(cache.timeSamples, cache.firstChunk, cache.vertexCount * sizeof(PackedStaticVertexData));
+    }
+
+    void AnimatedVertexCache::updatePrefetchWindow(const InterpolationInfo& curveInfo)
+    {
+        // Chunks are listed in priority order: the bracketing keyframes of all caches first, then the following keyframes.
+        mPrefetchChunks.clear();
+
+        for (const auto& cache : mCachedCurves)
+        {
+            getCurveKeyframeChunks(cache, curveInfo.keyframeIndices.x, mPrefetchChunks);
+            getCurveKeyframeChunks(cache, curveInfo.keyframeIndices.y, mPrefetchChunks);
+        }
+
+        std::vector<uint32_t> meshKeyframes(mCachedMeshes.size());
+        for (size_t i = 0; i < mCachedMeshes.size(); i++)
+        {
+            const uint2 keyframes = mMeshInterpolationInfo[i].keyframeIndices;
+            mPrefetchChunks.push_back(mCachedMeshes[i].firstChunk + keyframes.x);
+            mPrefetchChunks.push_back(mCachedMeshes[i].firstChunk + keyframes.y);
+            meshKeyframes[i] = keyframes.y;
+        }
+
+        uint32_t curveKeyframe = curveInfo.keyframeIndices.y;
+        for (uint32_t step = 0; step < kPrefetchKeyframeCount; step++)
+        {
+            if (!mCachedCurves.empty())
+            {
+                curveKeyframe = getNextKeyframe(curveKeyframe, (uint32_t)mCurveKeyframeTimes.size(), mLoopAnimations);
+                for (const auto& cache : mCachedCurves) getCurveKeyframeChunks(cache, curveKeyframe, mPrefetchChunks);
+            }
+
+            for (size_t i = 0; i < mCachedMeshes.size(); i++)
+            {
+                meshKeyframes[i] = getNextKeyframe(meshKeyframes[i], (uint32_t)mCachedMeshes[i].timeSamples.size(), mLoopAnimations);
+                mPrefetchChunks.push_back(mCachedMeshes[i].firstChunk + meshKeyframes[i]);
+            }
+        }
+
+        mpStore->setPrefetchWindow(mPrefetchChunks);
+    }
+
+    void AnimatedVertexCache::getCurveKeyframeChunks(const CachedCurve& cache, uint32_t keyframe, std::vector<uint32_t>& chunks) const
+    {
+        // Merged keyframes missing in a cache are interpolated from the surrounding keyframes (see uploadCurveKeyframe()).
+        const auto& timeSamples = cache.timeSamples;
+        const double time = mCurveKeyframeTimes[keyframe];
+        uint32_t k = std::min(uint32_t(std::lower_bound(timeSamples.begin(), timeSamples.end(), time) - timeSamples.begin()), (uint32_t)timeSamples.size() - 1);
+        if (timeSamples[k] != time && k > 0) chunks.push_back(cache.firstChunk + k - 1);
+        chunks.push_back(cache.firstChunk + k);
+    }
+
+    uint2 AnimatedVertexCache::makeCurveKeyframesResident(uint2 keyframeIndices)
+    {
+        return assignKeyframeSlots(mCurveSlotKeyframes, keyframeIndices, [&](uint32_t keyframe, uint32_t slot) { uploadCurveKeyframe(keyframe, slot); });
+    }
+
+    void AnimatedVertexCache::uploadCurveKeyframe(uint32_t keyframe, uint32_t slot)
+    {
+        uint32_t lssOffset = 0;
+        uint32_t polyTubeOffset = 0;
+        std::vector<DynamicCurveVertexData> interpVertices;
+
+        for (const auto& cache : mCachedCurves)
+        {
+            Buffer* pBuffer = nullptr;
+            uint32_t* pOffset = nullptr;
+            if (cache.tessellationMode == CurveTessellationMode::LinearSweptSphere)
+            {
+                pBuffer = mpCurveVertexBuffers[slot].get();
+                pOffset = &lssOffset;
+            }
+            else if (cache.tessellationMode == CurveTessellationMode::PolyTube)
+            {
+                pBuffer = mpCurvePolyTubeVertexBuffers[slot].get();
+                pOffset = &polyTubeOffset;
+            }
+            else continue;
+
+            uint32_t bufSize = uint32_t(cache.vertexCount * sizeof(DynamicCurveVertexData));
+            const auto& timeSamples = cache.timeSamples;
+            const double time = mCurveKeyframeTimes[keyframe];
+            uint32_t k = std::min(uint32_t(std::lower_bound(timeSamples.begin(), timeSamples.end(), time) - timeSamples.begin()), (uint32_t)timeSamples.size() - 1);
+
+            if (timeSamples[k] == time || k == 0)
+            {
+                auto pData = mpStore->getChunk(cache.firstChunk + k);
+                pBuffer->setBlob(pData->data(), *pOffset, bufSize);
+            }
+            else
+            {
+                // Linearly interpolate at the missing keyframe.
+                auto pData0 = mpStore->getChunk(cache.firstChunk + k - 1);
+                auto pData1 = mpStore->getChunk(cache.firstChunk + k);
+                const DynamicCurveVertexData* pVertices0 = reinterpret_cast<const DynamicCurveVertexData*>(pData0->data());
+                const DynamicCurveVertexData* pVertices1 = reinterpret_cast<const DynamicCurveVertexData*>(pData1->data());
+                float t = float((time - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
+                interpVertices.resize(cache.vertexCount);
+                for (size_t p = 0; p < cache.vertexCount; p++)
+                {
+                    interpVertices[p].position = lerp(pVertices0[p].position, pVertices1[p].position, t);
+                }
+                pBuffer->setBlob(interpVertices.data(), *pOffset, bufSize);
+            }
+
+            *pOffset += bufSize;
+        }
+    }
+
+    uint2 AnimatedVertexCache::makeMeshKeyframesResident(uint32_t meshIndex, uint2 keyframeIndices)
+    {
+        const auto& cache = mCachedMeshes[meshIndex];
+        return assignKeyframeSlots(mMeshSlotKeyframes[meshIndex], keyframeIndices, [&](uint32_t keyframe, uint32_t slot)
+        {
+            auto pData = mpStore->getChunk(cache.firstChunk + keyframe);
+            mpMeshVertexBuffers[meshIndex * kResidentKeyframeCount + slot]->setBlob(pData->data(), 0, pData->size());
+        });
+    }
+
     // We create a merged list of all timestamps and generate new frames for curves where those timestamps are missing.
     // This can lead to fairly heavy overhead if we have cached curves with vastly different total length.
     // Currently, our assets have cached curves with the same list of timestamps.
@@ -227,14 +435,14 @@ namespace Falcor
         {
             if (mCachedCurves[i].tessellationMode != CurveTessellationMode::LinearSweptSphere) continue;
 
-            mCurveVertexCount += (uint32_t)mCachedCurves[i].vertexData[0].size();
+            mCurveVertexCount += mCachedCurves[i].vertexCount;
             mCurveIndexCount += (uint32_t)mCachedCurves[i].indexData.size();
         }
 
-        // Create buffers for vertex positions in curve vertex caches.
+        // Create buffers for vertex positions of the resident keyframes. They are filled in animate().
         ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
-        mpCurveVertexBuffers.resize(mCurveKeyframeTimes.size());
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
+        mpCurveVertexBuffers.resize(kResidentKeyframeCount);
+        for (uint32_t i = 0; i < kResidentKeyframeCount; i++)
         {
             mpCurveVertexBuffers[i] = Buffer::createStructured(mpDevice.get(), sizeof(DynamicCurveVertexData), mCurveVertexCount, vbBindFlags, Buffer::CpuAccess::None, nullptr, false);
             mpCurveVertexBuffers[i]->setName("AnimatedVertexCache::mpCurveVertexBuffers[" + std::to_string(i) + "]");
@@ -244,40 +452,15 @@ namespace Falcor
         mpPrevCurveVertexBuffer = Buffer::createStructured(mpDevice.get(), sizeof(DynamicCurveVertexData), mCurveVertexCount, vbBindFlags, Buffer::CpuAccess::None, nullptr, false);
         mpPrevCurveVertexBuffer->setName("AnimatedVertexCache::mpPrevCurveVertexBuffer");
 
-        // Initialize vertex buffers with cached positions.
+        // Initialize previous vertex positions with positions at the first keyframe.
         uint32_t offset = 0;
         for (size_t i = 0; i < mCachedCurves.size(); i++)
         {
             if (mCachedCurves[i].tessellationMode != CurveTessellationMode::LinearSweptSphere) continue;
 
-            size_t vertexCount = mCachedCurves[i].vertexData[0].size();
-            uint32_t bufSize = uint32_t(vertexCount * sizeof(DynamicCurveVertexData));
-            uint32_t k = 0;
-            const auto& timeSamples = mCachedCurves[i].timeSamples;
-
-            for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
-            {
-                while (k + 1 < timeSamples.size() && timeSamples[k] < mCurveKeyframeTimes[j]) k++;
-
-                if (timeSamples[k] == mCurveKeyframeTimes[j])
-                {
-                    mpCurveVertexBuffers[j]->setBlob(mCachedCurves[i].vertexData[k].data(), offset, bufSize);
-                }
-                else
-                {
-                    // Linearly interpolate at the missing keyframe.
-                    float t = float((mCurveKeyframeTimes[j] - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
-                    std::vector<DynamicCurveVertexData> interpVertices(vertexCount);
-                    for (size_t p = 0; p < vertexCount; p++)
-                    {
-                        interpVertices[p].position = lerp(mCachedCurves[i].vertexData[k - 1][p].position, mCachedCurves[i].vertexData[k][p].position, t);
-                    }
-                    mpCurveVertexBuffers[j]->setBlob(interpVertices.data(), offset, bufSize);
-                }
-            }
-
-            // Initialize it with positions at the first keyframe.
-            mpPrevCurveVertexBuffer->setBlob(mCachedCurves[i].vertexData[0].data(), offset, bufSize);
+            uint32_t bufSize = uint32_t(mCachedCurves[i].vertexCount * sizeof(DynamicCurveVertexData));
+            auto pData = mpStore->getChunk(mCachedCurves[i].firstChunk);
+            mpPrevCurveVertexBuffer->setBlob(pData->data(), offset, bufSize);
 
             offset += bufSize;
         }
@@ -322,7 +505,7 @@ namespace Falcor
             PerCurveMetadata curveMeta;
             curveMeta.indexCount = (uint32_t)cache.indexData.size();
             curveMeta.indexOffset = mCurvePolyTubeIndexCount;
-            curveMeta.vertexCount = (uint32_t)cache.vertexData[0].size();
+            curveMeta.vertexCount = cache.vertexCount;
             curveMeta.vertexOffset = mCurvePolyTubeVertexCount;
             curveMetadata.push_back(curveMeta);
 
@@ -344,57 +527,22 @@ namespace Falcor
         mpCurvePolyTubeMeshMetadataBuffer = Buffer::createStructured(mpDevice.get(), sizeof(PerMeshMetadata), (uint32_t)meshMetadata.size(), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, meshMetadata.data(), false);
         mpCurvePolyTubeMeshMetadataBuffer->setName("AnimatedVertexCache::mpCurvePolyTubeMeshMetadataBuffer");
 
-        // Create buffers for vertex positions in curve vertex caches.
+        // Create buffers for vertex positions of the resident keyframes. They are filled in animate().
         ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
-        mpCurvePolyTubeVertexBuffers.resize(mCurveKeyframeTimes.size());
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
+        mpCurvePolyTubeVertexBuffers.resize(kResidentKeyframeCount);
+        for (uint32_t i = 0; i < kResidentKeyframeCount; i++)
         {
             mpCurvePolyTubeVertexBuffers[i] = Buffer::createStructured(mpDevice.get(), sizeof(DynamicCurveVertexData), mCurvePolyTubeVertexCount, vbBindFlags, Buffer::CpuAccess::None, nullptr, false);
             mpCurvePolyTubeVertexBuffers[i]->setName("AnimatedVertexCache::mpCurvePolyTubeVertexBuffers[" + std::to_string(i) + "]");
         }
 
-        // Initialize vertex buffers with cached positions.
-        uint32_t offset = 0;
-        for (size_t i = 0; i < mCachedCurves.size(); i++)
-        {
-            if (mCachedCurves[i].tessellationMode != CurveTessellationMode::PolyTube) continue;
-
-            size_t vertexCount = mCachedCurves[i].vertexData[0].size();
-            uint32_t bufSize = uint32_t(vertexCount * sizeof(DynamicCurveVertexData));
-            uint32_t k = 0;
-            const auto& timeSamples = mCachedCurves[i].timeSamples;
-
-            for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
-            {
-                while (k + 1 < timeSamples.size() && timeSamples[k] < mCurveKeyframeTimes[j]) k++;
-
-                if (timeSamples[k] == mCurveKeyframeTimes[j])
-                {
-                    mpCurvePolyTubeVertexBuffers[j]->setBlob(mCachedCurves[i].vertexData[k].data(), offset, bufSize);
-                }
-                else
-                {
-                    // Linearly interpolate at the missing keyframe.
-                    float t = float((mCurveKeyframeTimes[j] - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
-                    std::vector<DynamicCurveVertexData> interpVertices(vertexCount);
-                    for (size_t p = 0; p < vertexCount; p++)
-                    {
-                        interpVertices[p].position = lerp(mCachedCurves[i].vertexData[k - 1][p].position, mCachedCurves[i].vertexData[k][p].position, t);
-                    }
-                    mpCurvePolyTubeVertexBuffers[j]->setBlob(interpVertices.data(), offset, bufSize);
-                }
-            }
-
-            offset += bufSize;
-        }
-
         // Create curve strand index buffer.
         vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
         mpCurvePolyTubeStrandIndexBuffer = Buffer::create(mpDevice.get(), sizeof(uint32_t) * mCurvePolyTubeVertexCount, vbBindFlags);
         mpCurvePolyTubeStrandIndexBuffer->setName("AnimatedVertexCache::mpCurvePolyTubeStrandIndexBuffer");
 
         // Initialize strand index buffer.
-        offset = 0;
+        uint32_t offset = 0;
         const uint32_t strandLastVertexIndex = 0xffffffff;
         std::vector<uint32_t> strandIndexData(mCurvePolyTubeVertexCount);
         for (uint32_t i = 0; i < (uint32_t)mCachedCurves.size(); i++)
@@ -435,39 +583,38 @@ namespace Falcor
         for (const auto& cache : mCachedMeshes)
         {
             mGlobalMeshAnimationLength = std::max(mGlobalMeshAnimationLength, cache.timeSamples.back());
-            mMeshKeyframeCount += (uint32_t)cache.timeSamples.size();
-            mMaxMeshVertexCount = std::max((uint32_t)cache.vertexData.front().size(), mMaxMeshVertexCount);
+            mMaxMeshVertexCount = std::max(cache.vertexCount, mMaxMeshVertexCount);
         }
     }
 
     void AnimatedVertexCache::initMeshBuffers()
     {
-        mpMeshVertexBuffers.resize(mMeshKeyframeCount);
+        mpMeshVertexBuffers.resize(mCachedMeshes.size() * kResidentKeyframeCount);
+        mMeshSlotKeyframes.resize(mCachedMeshes.size(), uint2(kInvalidKeyframe));
         std::vector<PerMeshMetadata> meshMetadata;
         meshMetadata.reserve(mCachedMeshes.size());
 
         uint32_t keyframeOffset = 0;
         for (auto& cache : mCachedMeshes)
         {
-            FALCOR_ASSERT(cache.vertexData.front().size() == mpScene->getMesh(cache.meshID).vertexCount);
+            FALCOR_ASSERT(cache.vertexCount == mpScene->getMesh(cache.meshID).vertexCount);
 
             PerMeshMetadata meta;
             meta.keyframeBufferOffset = keyframeOffset;
-            meta.vertexCount = (uint32_t)cache.vertexData.front().size();
+            meta.vertexCount = cache.vertexCount;
             meta.sceneVbOffset = mpScene->getMesh(cache.meshID).vbOffset;
             meta.prevVbOffset = mpScene->getMesh(cache.meshID).prevVbOffset;
             meshMetadata.push_back(meta);
 
-            // Create vertex buffer for each keyframe on this mesh
-            for (size_t i = 0; i < cache.vertexData.size(); i++)
+            // Create vertex buffers for the resident keyframes of this mesh. They are filled in animate().
+            for (uint32_t i = 0; i < kResidentKeyframeCount; i++)
             {
-                auto& data = cache.vertexData[i];
                 size_t index = keyframeOffset + i;
-                mpMeshVertexBuffers[index] = Buffer::createStructured(mpDevice.get(), sizeof(PackedStaticVertexData), (uint32_t)data.size(), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, data.data(), false);
+                mpMeshVertexBuffers[index] = Buffer::createStructured(mpDevice.get(), sizeof(PackedStaticVertexData), cache.vertexCount, ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, nullptr, false);
                 mpMeshVertexBuffers[index]->setName("AnimatedVertexCache::mpMeshVertexBuffers[" + std::to_string(index) + "]");
             }
 
-            keyframeOffset += (uint32_t)cache.timeSamples.size();
+            keyframeOffset += kResidentKeyframeCount;
         }
 
         mpMeshMetadataBuffer = Buffer::createStructured(mpDevice.get(), sizeof(PerMeshMetadata), (uint32_t)meshMetadata.size(), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, meshMetadata.data(), false);
@@ -483,7 +630,7 @@ namespace Falcor
         FALCOR_ASSERT(!mCachedMeshes.empty());
 
         Program::DefineList defines;
-        defines.add("MESH_KEYFRAME_COUNT", std::to_string(mMeshKeyframeCount));
+        defines.add("MESH_KEYFRAME_COUNT", std::to_string(mpMeshVertexBuffers.size()));
         mpMeshVertexUpdatePass = ComputePass::create(mpDevice, "Scene/Animation/UpdateMeshVertices.slang", "main", defines);
 
         // Bind data
@@ -501,14 +648,14 @@ namespace Falcor
         FALCOR_ASSERT(mCurveLSSCount > 0);
 
         Program::DefineList defines;
-        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mCurveKeyframeTimes.size()));
+        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(kResidentKeyframeCount));
         mpCurveVertexUpdatePass = ComputePass::create(mpDevice, kUpdateCurveVerticesFilename, "main", defines);
 
         auto block = mpCurveVertexUpdatePass->getVars()["gCurveVertexUpdater"];
         auto var = block["curvePerKeyframe"];
 
         // Bind curve vertex data.
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++) var[i]["vertexData"] = mpCurveVertexBuffers[i];
+        for (uint32_t i = 0; i < kResidentKeyframeCount; i++) var[i]["vertexData"] = mpCurveVertexBuffers[i];
     }
 
     void AnimatedVertexCache::createCurveLSSAABBUpdatePass()
@@ -526,7 +673,7 @@ namespace Falcor
         FALCOR_ASSERT(mCurvePolyTubeCount > 0);
 
         Program::DefineList defines;
-        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mCurveKeyframeTimes.size()));
+        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(kResidentKeyframeCount));
         mpCurvePolyTubeVertexUpdatePass = ComputePass::create(mpDevice, kUpdateCurvePolyTubeVerticesFilename, "main", defines);
 
         auto block = mpCurvePolyTubeVertexUpdatePass->getVars()["gCurvePolyTubeVertexUpdater"];
@@ -536,24 +683,17 @@ namespace Falcor
         auto var = block["curvePerKeyframe"];
 
         // Bind curve vertex data.
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++) var[i]["vertexData"] = mpCurvePolyTubeVertexBuffers[i];
+        for (uint32_t i = 0; i < kResidentKeyframeCount; i++) var[i]["vertexData"] = mpCurvePolyTubeVertexBuffers[i];
     }
 
 
-    void AnimatedVertexCache::executeMeshVertexUpdatePass(RenderContext* pRenderContext, double t, bool copyPrev)
+    void AnimatedVertexCache::executeMeshVertexUpdatePass(RenderContext* pRenderContext, bool copyPrev)
     {
         if (!mpMeshVertexUpdatePass) return;
 
         FALCOR_PROFILE(pRenderContext, "update mesh vertices");
 
-        // Update interpolation
-        for (size_t i = 0; i < mMeshInterpolationInfo.size(); i++)
-        {
-            auto postInfinityBehavior = mLoopAnimations ? Animation::Behavior::Cycle : Animation::Behavior::Constant;
-            mMeshInterpolationInfo[i] = calculateInterpolation(t, mCachedMeshes[i].timeSamples, mPreInfinityBehavior, postInfinityBehavior);
-        }
-
-        mpMeshInterpolationBuffer->setBlob(mMeshInterpolationInfo.data(), 0, mpMeshInterpolationBuffer->getSize());
+        if (!copyPrev) mpMeshInterpolationBuffer->setBlob(mMeshInterpolationInfo.data(), 0, mpMeshInterpolationBuffer->getSize());
 
         auto block = mpMeshVertexUpdatePass->getVars()["gMeshVertexUpdater"];
         block["sceneVertexData"] = mpScene->getMeshVao()->getVertexBuffer(Scene::kStaticDataBufferIndex);
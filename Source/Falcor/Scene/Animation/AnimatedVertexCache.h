@@ -28,6 +28,7 @@
 #pragma once
 #include "Animation.h"
 #include "SharedTypes.slang"
+#include "VertexCacheStore.h"
 #include "Core/API/Buffer.h"
 #include "Scene/Curves/CurveConfig.h"
 #include "Scene/SceneTypes.slang"
@@ -58,7 +59,11 @@ namespace Falcor
         std::vector<uint32_t> indexData;
 
         // vertexData[i][j] represents at the i-th keyframe, the cache data of the j-th vertex.
+        // The keyframes are moved to a vertex cache store when the scene is built (see VertexCacheStore::Writer).
         std::vector<std::vector<DynamicCurveVertexData>> vertexData;
+
+        uint32_t vertexCount = 0;   ///< Vertex count of each keyframe in the vertex cache store.
+        uint32_t firstChunk = 0;    ///< Chunk index of the first keyframe in the vertex cache store.
     };
 
     struct CachedMesh
@@ -68,9 +73,17 @@ namespace Falcor
         std::vector<double> timeSamples;
 
         // vertexData[i][j] represents at the i-th keyframe, the cache data of the j-th vertex.
+        // The keyframes are moved to a vertex cache store when the scene is built (see VertexCacheStore::Writer).
         std::vector<std::vector<PackedStaticVertexData>> vertexData;
+
+        uint32_t vertexCount = 0;   ///< Vertex count of each keyframe in the vertex cache store.
+        uint32_t firstChunk = 0;    ///< Chunk index of the first keyframe in the vertex cache store.
     };
 
+    /** Vertex cache animation of curves and meshes.
+        The keyframes are streamed from a vertex cache store. Only the two keyframes bracketing the current time
+        are resident on the GPU, and the store prefetches the following keyframes in the background.
+    */
     class FALCOR_API AnimatedVertexCache
     {
     public:
@@ -78,7 +91,15 @@ namespace Falcor
         using UniqueConstPtr = std::unique_ptr<const AnimatedVertexCache>;
         ~AnimatedVertexCache() = default;
 
-        static UniquePtr create(std::shared_ptr<Device> pDevice, Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes);
+        /** Create the vertex cache animation.
+            \param[in] pDevice GPU device.
+            \param[in] pScene The scene.
+            \param[in] pPrevVertexData Previous vertex data buffer owned by the animation controller.
+            \param[in] cachedCurves Cached curves.
+            \param[in] cachedMeshes Cached meshes.
+            \param[in] pStore Store holding the keyframes. If nullptr, the keyframes of the caches are written to a temporary store.
+        */
+        static UniquePtr create(std::shared_ptr<Device> pDevice, Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, VertexCacheStore::SharedPtr pStore);
 
         void setIsLooped(bool looped) { mLoopAnimations = looped; }
 
@@ -102,8 +123,14 @@ namespace Falcor
 
         uint64_t getMemoryUsageInBytes() const;
 
+        /** Get the store the keyframes are streamed from.
+        */
+        const VertexCacheStore::SharedPtr& getVertexCacheStore() const { return mpStore; }
+
     private:
-        AnimatedVertexCache(std::shared_ptr<Device> pDevice, Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes);
+        AnimatedVertexCache(std::shared_ptr<Device> pDevice, Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, VertexCacheStore::SharedPtr pStore);
+
+        void validateKeyframeChunks() const;
 
         void initCurveKeyframes();
         void bindCurveLSSBuffers();
@@ -118,7 +145,20 @@ namespace Falcor
 
         void createMeshVertexUpdatePass();
 
-        void executeMeshVertexUpdatePass(RenderContext* pContext, double t, bool copyPrev = false);
+        // Set the prefetch window of the store to the bracketing and the following keyframes.
+        void updatePrefetchWindow(const InterpolationInfo& curveInfo);
+
+        // Make the bracketing keyframes resident and return their slots in the keyframe buffers.
+        uint2 makeCurveKeyframesResident(uint2 keyframeIndices);
+        void uploadCurveKeyframe(uint32_t keyframe, uint32_t slot);
+        uint2 makeMeshKeyframesResident(uint32_t meshIndex, uint2 keyframeIndices);
+
+        // Append the chunks needed to build a (merged) curve keyframe for one cached curve.
+        void getCurveKeyframeChunks(const CachedCurve& cache, uint32_t keyframe, std::vector<uint32_t>& chunks) const;
+
+        // Interpolate mesh vertices using the interpolation info in mMeshInterpolationInfo.
+        // When copyPrev is set to true, interpolation info is ignored and we just copy the current vertex data to the previous data.
+        void executeMeshVertexUpdatePass(RenderContext* pContext, bool copyPrev = false);
 
         // Interpolate vertex positions.
         // When copyPrev is set to true, interpolation info is ignored and we just copy the current vertex data to the previous data.
@@ -138,6 +178,8 @@ namespace Falcor
         Scene* mpScene = nullptr;
         Buffer::SharedPtr mpPrevVertexData; ///< Owned by AnimationController
         Animation::Behavior mPreInfinityBehavior = Animation::Behavior::Constant; // How the animation behaves before the first keyframe.
+        VertexCacheStore::SharedPtr mpStore;
+        std::vector<uint32_t> mPrefetchChunks;
 
         std::vector<CachedCurve> mCachedCurves;
         uint32_t mCurveLSSCount = 0;
@@ -152,7 +194,7 @@ namespace Falcor
         uint32_t mCurveIndexCount = 0;
         uint32_t mCurveAABBOffset = 0;
 
-        std::vector<Buffer::SharedPtr> mpCurveVertexBuffers;
+        std::vector<Buffer::SharedPtr> mpCurveVertexBuffers; ///< Resident keyframes, one buffer per slot.
         Buffer::SharedPtr mpPrevCurveVertexBuffer;
         Buffer::SharedPtr mpCurveIndexBuffer;
 
@@ -163,7 +205,8 @@ namespace Falcor
         uint32_t mCurvePolyTubeIndexCount = 0;
         uint32_t mMaxCurvePolyTubeVertexCount = 0; ///< Greatest vertex count a curve has
 
-        std::vector<Buffer::SharedPtr> mpCurvePolyTubeVertexBuffers;
+        std::vector<Buffer::SharedPtr> mpCurvePolyTubeVertexBuffers; ///< Resident keyframes, one buffer per slot.
+        uint2 mCurveSlotKeyframes{ std::numeric_limits<uint32_t>::max() }; ///< Keyframe held by each curve keyframe slot.
         Buffer::SharedPtr mpCurvePolyTubeStrandIndexBuffer;
         Buffer::SharedPtr mpCurvePolyTubeCurveMetadataBuffer;
         Buffer::SharedPtr mpCurvePolyTubeMeshMetadataBuffer;
@@ -174,10 +217,10 @@ namespace Falcor
 
         std::vector<CachedMesh> mCachedMeshes;
         std::vector<InterpolationInfo> mMeshInterpolationInfo;
-        uint32_t mMeshKeyframeCount = 0; ///< Total count of all keyframes for all meshes
         uint32_t mMaxMeshVertexCount = 0; ///< Greatest vertex count a mesh has
 
-        std::vector<Buffer::SharedPtr> mpMeshVertexBuffers;
+        std::vector<Buffer::SharedPtr> mpMeshVertexBuffers; ///< Resident keyframes, two slots per mesh.
+        std::vector<uint2> mMeshSlotKeyframes;      ///< Keyframes held by the slots of each mesh.
         Buffer::SharedPtr mpMeshInterpolationBuffer;
         Buffer::SharedPtr mpMeshMetadataBuffer;
     };
@@ -32,6 +32,7 @@
 #include "Scene/Transform.h"
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/transform.hpp>
+#include <algorithm>
 
 namespace Falcor
 {
@@ -121,28 +122,28 @@ namespace Falcor
     {
         // Calculate the sample time.
         double time = currentTime;
-        if (time < mKeyframes.front().time || time > mKeyframes.back().time)
+        if (time < mKeyframeTimes.front() || time > mKeyframeTimes.back())
         {
             time = calcSampleTime(currentTime);
         }
 
         // Determine if the animation behaves linearly outside of defined keyframes.
-        bool isLinearPostInfinity = time > mKeyframes.back().time && this->getPostInfinityBehavior() == Behavior::Linear;
-        bool isLinearPreInfinity = time < mKeyframes.front().time && this->getPreInfinityBehavior() == Behavior::Linear;
+        bool isLinearPostInfinity = time > mKeyframeTimes.back() && this->getPostInfinityBehavior() == Behavior::Linear;
+        bool isLinearPreInfinity = time < mKeyframeTimes.front() && this->getPreInfinityBehavior() == Behavior::Linear;
 
         Keyframe interpolated;
 
-        if (isLinearPreInfinity && mKeyframes.size() > 1)
+        if (isLinearPreInfinity && mKeyframeTimes.size() > 1)
         {
-            const auto& k0 = mKeyframes.front();
+            const auto k0 = getKeyframeByIndex(0);
             auto k1 = interpolate(mInterpolationMode, k0.time + kEpsilonTime);
             double segmentDuration = k1.time - k0.time;
             float t = (float)((time - k0.time) / segmentDuration);
             interpolated = interpolateLinear(k0, k1, t);
         }
-        else if (isLinearPostInfinity && mKeyframes.size() > 1)
+        else if (isLinearPostInfinity && mKeyframeTimes.size() > 1)
         {
-            const auto& k1 = mKeyframes.back();
+            const auto k1 = getKeyframeByIndex(mKeyframeTimes.size() - 1);
             auto k0 = interpolate(mInterpolationMode, k1.time - kEpsilonTime);
             double segmentDuration = k1.time - k0.time;
             float t = (float)((time - k0.time) / segmentDuration);
@@ -163,36 +164,24 @@ namespace Falcor
 
     Animation::Keyframe Animation::interpolate(InterpolationMode mode, double time) const
     {
-        FALCOR_ASSERT(!mKeyframes.empty());
+        FALCOR_ASSERT(!mKeyframeTimes.empty());
 
-        // Validate cached frame index.
-        size_t frameIndex = clamp(mCachedFrameIndex, (size_t)0, mKeyframes.size() - 1);
-        if (time < mKeyframes[frameIndex].time) frameIndex = 0;
-
-        // Find frame index.
-        while (frameIndex < mKeyframes.size() - 1)
-        {
-            if (mKeyframes[frameIndex + 1].time > time) break;
-            frameIndex++;
-        }
-
-        // Cache frame index;
-        mCachedFrameIndex = frameIndex;
+        size_t frameIndex = findKeyframe(time);
 
         // Compute index of adjacent frame including optional warping.
         auto adjacentFrame = [this] (size_t frame, int32_t offset = 1)
         {
-            size_t count = mKeyframes.size();
+            size_t count = mKeyframeTimes.size();
             return mEnableWarping ? (frame + count + offset) % count : clamp(frame + offset, (size_t)0, count - 1);
         };
 
-        if (mode == InterpolationMode::Linear || mKeyframes.size() < 4)
+        if (mode == InterpolationMode::Linear || mKeyframeTimes.size() < 4)
         {
             size_t i0 = frameIndex;
             size_t i1 = adjacentFrame(i0);
 
-            const Keyframe& k0 = mKeyframes[i0];
-            const Keyframe& k1 = mKeyframes[i1];
+            const Keyframe k0 = getKeyframeByIndex(i0);
+            const Keyframe k1 = getKeyframeByIndex(i1);
 
             double segmentDuration = k1.time - k0.time;
             if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
@@ -207,10 +196,10 @@ namespace Falcor
             size_t i2 = adjacentFrame(i1, 1);
             size_t i3 = adjacentFrame(i1, 2);
 
-            const Keyframe& k0 = mKeyframes[i0];
-            const Keyframe& k1 = mKeyframes[i1];
-            const Keyframe& k2 = mKeyframes[i2];
-            const Keyframe& k3 = mKeyframes[i3];
+            const Keyframe k0 = getKeyframeByIndex(i0);
+            const Keyframe k1 = getKeyframeByIndex(i1);
+            const Keyframe k2 = getKeyframeByIndex(i2);
+            const Keyframe k3 = getKeyframeByIndex(i3);
 
             double segmentDuration = k2.time - k1.time;
             if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
@@ -231,8 +220,8 @@ namespace Falcor
     double Animation::calcSampleTime(double currentTime)
     {
         double modifiedTime = currentTime;
-        double firstKeyframeTime = mKeyframes.front().time;
-        double lastKeyframeTime = mKeyframes.back().time;
+        double firstKeyframeTime = mKeyframeTimes.front();
+        double lastKeyframeTime = mKeyframeTimes.back();
         double duration = lastKeyframeTime - firstKeyframeTime;
 
         FALCOR_ASSERT(currentTime < firstKeyframeTime || currentTime > lastKeyframeTime);
@@ -259,63 +248,63 @@ namespace Falcor
         return modifiedTime;
     }
 
-    void Animation::addKeyframe(const Keyframe& keyframe)
+    size_t Animation::findKeyframe(double time) const
     {
-        FALCOR_ASSERT(keyframe.time <= mDuration);
+        FALCOR_ASSERT(!mKeyframeTimes.empty());
 
-        if (mKeyframes.size() == 0 || mKeyframes[0].time > keyframe.time)
+        // Fast path for playback, where the time is in the cached or the following segment.
+        const size_t count = mKeyframeTimes.size();
+        const size_t cached = mCachedFrameIndex;
+        if (cached < count && mKeyframeTimes[cached] <= time)
         {
-            mKeyframes.insert(mKeyframes.begin(), keyframe);
-        }
-        else if (mKeyframes.back().time < keyframe.time)
-        {
-            mKeyframes.push_back(keyframe);
-        }
-        else
-        {
-            for (size_t i = 0; i < mKeyframes.size(); i++)
-            {
-                auto& current = mKeyframes[i];
-                // If we already have a key-frame at the same time, replace it
-                if (current.time == keyframe.time)
-                {
-                    current = keyframe;
-                    return;
-                }
-
-                // If this is not the last frame, Check if we are in between frames
-                if (i < mKeyframes.size() - 1)
-                {
-                    auto& Next = mKeyframes[i + 1];
-                    if (current.time < keyframe.time && Next.time > keyframe.time)
-                    {
-                        mKeyframes.insert(mKeyframes.begin() + i + 1, keyframe);
-                        return;
-                    }
-                }
-            }
-
-            // If we got here, need to push it to the end of the list
-            mKeyframes.push_back(keyframe);
+            if (cached + 1 == count || time < mKeyframeTimes[cached + 1]) return cached;
+            if (cached + 2 == count || time < mKeyframeTimes[cached + 2]) return mCachedFrameIndex = cached + 1;
         }
+
+        // Find the last keyframe at or before the time.
+        auto it = std::upper_bound(mKeyframeTimes.begin(), mKeyframeTimes.end(), time);
+        mCachedFrameIndex = it == mKeyframeTimes.begin() ? 0 : (size_t)std::distance(mKeyframeTimes.begin(), it) - 1;
+        return mCachedFrameIndex;
     }
 
-    const Animation::Keyframe& Animation::getKeyframe(double time) const
+    Animation::Keyframe Animation::getKeyframeByIndex(size_t index) const
     {
-        for (const auto& k : mKeyframes)
+        FALCOR_ASSERT(index < mKeyframeTimes.size());
+        return Keyframe{ mKeyframeTimes[index], mKeyframeTranslations[index], mKeyframeScalings[index], mKeyframeRotations[index] };
+    }
+
+    void Animation::addKeyframe(const Keyframe& keyframe)
+    {
+        FALCOR_ASSERT(keyframe.time <= mDuration);
+
+        auto it = std::lower_bound(mKeyframeTimes.begin(), mKeyframeTimes.end(), keyframe.time);
+        const size_t index = (size_t)std::distance(mKeyframeTimes.begin(), it);
+
+        // If we already have a keyframe at the same time, replace it.
+        if (it != mKeyframeTimes.end() && *it == keyframe.time)
         {
-            if (k.time == time) return k;
+            mKeyframeTranslations[index] = keyframe.translation;
+            mKeyframeScalings[index] = keyframe.scaling;
+            mKeyframeRotations[index] = keyframe.rotation;
+            return;
         }
-        throw ArgumentError("'time' ({}) does not refer to an existing keyframe", time);
+
+        mKeyframeTimes.insert(it, keyframe.time);
+        mKeyframeTranslations.insert(mKeyframeTranslations.begin() + index, keyframe.translation);
+        mKeyframeScalings.insert(mKeyframeScalings.begin() + index, keyframe.scaling);
+        mKeyframeRotations.insert(mKeyframeRotations.begin() + index, keyframe.rotation);
+    }
+
+    Animation::Keyframe Animation::getKeyframe(double time) const
+    {
+        auto it = std::lower_bound(mKeyframeTimes.begin(), mKeyframeTimes.end(), time);
+        if (it == mKeyframeTimes.end() || *it != time) throw ArgumentError("'time' ({}) does not refer to an existing keyframe", time);
+        return getKeyframeByIndex((size_t)std::distance(mKeyframeTimes.begin(), it));
     }
 
     bool Animation::doesKeyframeExists(double time) const
     {
-        for (const auto& k : mKeyframes)
-        {
-            if (k.time == time) return true;
-        }
-        return false;
+        return std::binary_search(mKeyframeTimes.begin(), mKeyframeTimes.end(), time);
     }
 
     void Animation::renderUI(Gui::Widgets& widget)
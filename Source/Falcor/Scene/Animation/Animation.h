@@ -133,7 +133,11 @@ namespace Falcor
             \param[in] time Time of the keyframe.
             \return Returns the keyframe.
         */
-        const Keyframe& getKeyframe(double time) const;
+        Keyframe getKeyframe(double time) const;
+
+        /** Get the number of keyframes.
+        */
+        size_t getKeyframeCount() const { return mKeyframeTimes.size(); }
 
         /** Check if a keyframe exists at the specified time.
             \param[in] time Time of the keyframe.
@@ -142,6 +146,8 @@ namespace Falcor
         bool doesKeyframeExists(double time) const;
 
         /** Compute the animation.
+            Keyframes are located with a binary search, so arbitrary jumps in time are as cheap as regular playback.
+            Note: This function is not safe for calling on the same animation from multiple threads.
             \param time The current time in seconds. This can be larger then the animation time, in which case the animation will loop.
             \return Returns the animation's transform matrix for the specified time.
         */
@@ -156,6 +162,8 @@ namespace Falcor
 
         Keyframe interpolate(InterpolationMode mode, double time) const;
         double calcSampleTime(double currentTime);
+        size_t findKeyframe(double time) const;
+        Keyframe getKeyframeByIndex(size_t index) const;
 
         std::string mName;
         NodeID mNodeID;
@@ -167,7 +175,11 @@ namespace Falcor
         InterpolationMode mInterpolationMode = InterpolationMode::Linear;
         bool mEnableWarping = false;
 
-        std::vector<Keyframe> mKeyframes;
+        // Keyframes sorted by time, stored as structure of arrays so that searching only touches the times.
+        std::vector<double> mKeyframeTimes;
+        std::vector<float3> mKeyframeTranslations;
+        std::vector<float3> mKeyframeScalings;
+        std::vector<glm::quat> mKeyframeRotations;
         mutable size_t mCachedFrameIndex = 0;
 
         friend class SceneCache;
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "AnimationController.h"
 #include "Core/API/RenderContext.h"
+#include "Utils/Threading.h"
 #include "Utils/Timing/Profiler.h"
 #include "Scene/Scene.h"
 #include <fstream>
@@ -39,6 +40,15 @@ namespace Falcor
         const std::string kInverseTransposeWorldMatrices = "inverseTransposeWorldMatrices";
         const std::string kPrevWorldMatrices = "prevWorldMatrices";
         const std::string kPrevInverseTransposeWorldMatrices = "prevInverseTransposeWorldMatrices";
+
+        // Number of animations and scene graph nodes processed per task.
+        const size_t kAnimationGrainSize = 64;
+        const size_t kNodeGrainSize = 256;
+
+        float4x4 inverseTranspose(const float4x4& m)
+        {
+            return transpose(rmcv::isAffine(m) ? rmcv::affineInverse(m) : rmcv::inverse(m));
+        }
     }
 
     AnimationController::AnimationController(std::shared_ptr<Device> pDevice, Scene* pScene, const StaticVertexVector& staticVertexData, const SkinningVertexVector& skinningVertexData, uint32_t prevVertexCount, const std::vector<Animation::SharedPtr>& animations)
@@ -85,6 +95,8 @@ namespace Falcor
 
         createSkinningPass(staticVertexData, skinningVertexData);
 
+        initNodeLevels();
+
         // Determine length of global animation loop.
         for (const auto& pAnimation : mAnimations)
         {
@@ -97,7 +109,7 @@ namespace Falcor
         return UniquePtr(new AnimationController(std::move(pDevice), pScene, staticVertexData, skinningVertexData, prevVertexCount, animations));
     }
 
-    void AnimationController::addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, const StaticVertexVector& staticVertexData)
+    void AnimationController::addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, VertexCacheStore::SharedPtr pVertexCacheStore, const StaticVertexVector& staticVertexData)
     {
         size_t totalAnimatedMeshVertexCount = 0;
 
@@ -122,7 +134,8 @@ namespace Falcor
             for (auto& cache : cachedMeshes)
             {
                 uint32_t offset = mpScene->getMesh(cache.meshID).vbOffset;
-                for (size_t i = 0; i < cache.vertexData.front().size(); i++)
+                uint32_t vertexCount = mpScene->getMesh(cache.meshID).vertexCount;
+                for (size_t i = 0; i < vertexCount; i++)
                 {
                     prevVertexData.push_back({ staticVertexData[offset + i].position });
                 }
@@ -161,7 +174,7 @@ namespace Falcor
             mpPrevVertexData->setBlob(prevVertexData.data(), byteOffset, prevVertexData.size() * sizeof(PrevVertexData));
         }
 
-        mpVertexCache = AnimatedVertexCache::create(mpDevice, mpScene, mpPrevVertexData, std::move(cachedCurves), std::move(cachedMeshes));
+        mpVertexCache = AnimatedVertexCache::create(mpDevice, mpScene, mpPrevVertexData, std::move(cachedCurves), std::move(cachedMeshes), std::move(pVertexCacheStore));
 
         // Note: It is a workaround to have two pre-infinity behaviors for the cached animation.
         // We need `Cycle` behavior when the length of cached animation is smaller than the length of mesh animation (e.g., tiger forest).
@@ -195,11 +208,35 @@ namespace Falcor
         }
     }
 
+    void AnimationController::initNodeLevels()
+    {
+        // Compute the depth of each node. Parents are stored before their children in the scene graph.
+        const auto& sceneGraph = mpScene->mSceneGraph;
+        std::vector<uint32_t> levels(sceneGraph.size(), 0);
+        uint32_t levelCount = sceneGraph.empty() ? 0 : 1;
+        for (size_t i = 0; i < sceneGraph.size(); ++i)
+        {
+            if (sceneGraph[i].parent == NodeID::Invalid()) continue;
+            FALCOR_ASSERT(sceneGraph[i].parent.get() < i);
+            levels[i] = levels[sceneGraph[i].parent.get()] + 1;
+            levelCount = std::max(levelCount, levels[i] + 1);
+        }
+
+        // Sort the nodes by level, keeping them in scene graph order within each level.
+        mLevelOffsets.assign(levelCount + 1, 0);
+        for (uint32_t level : levels) mLevelOffsets[level + 1]++;
+        for (size_t level = 0; level < levelCount; ++level) mLevelOffsets[level + 1] += mLevelOffsets[level];
+
+        mLevelNodes.resize(sceneGraph.size());
+        std::vector<size_t> next(mLevelOffsets.begin(), mLevelOffsets.end() - 1);
+        for (size_t i = 0; i < sceneGraph.size(); ++i) mLevelNodes[next[levels[i]]++] = (uint32_t)i;
+    }
+
     bool AnimationController::animate(RenderContext* pRenderContext, double currentTime)
     {
         FALCOR_PROFILE(pRenderContext, "animate");
 
-        std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), false);
+        std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), (uint8_t)false);
 
         // Check for edited scene nodes and update local matrices.
         const auto& sceneGraph = mpScene->mSceneGraph;
@@ -293,43 +330,61 @@ namespace Falcor
 
     void AnimationController::updateLocalMatrices(double time)
     {
-        for (auto& pAnimation : mAnimations)
+        // Evaluate the animations in parallel, then write them in order so that the last animation of a node wins.
+        mAnimationMatrices.resize(mAnimations.size());
+        Threading::parallelFor(0, mAnimations.size(), [&](size_t i)
+        {
+            mAnimationMatrices[i] = mAnimations[i]->animate(time);
+        }, kAnimationGrainSize);
+
+        for (size_t i = 0; i < mAnimations.size(); ++i)
         {
-            NodeID nodeID = pAnimation->getNodeID();
+            NodeID nodeID = mAnimations[i]->getNodeID();
             FALCOR_ASSERT(nodeID.get() < mLocalMatrices.size());
-            mLocalMatrices[nodeID.get()] = pAnimation->animate(time);
+            mLocalMatrices[nodeID.get()] = mAnimationMatrices[i];
             mMatricesChanged[nodeID.get()] = true;
         }
     }
 
     void AnimationController::updateWorldMatrices(bool updateAll)
     {
-        const auto& sceneGraph = mpScene->mSceneGraph;
-
-        for (size_t i = 0; i < mGlobalMatrices.size(); i++)
+        // Process the scene graph level by level. All nodes of a level only depend on their parents
+        // in the previous level and are updated in parallel.
+        for (size_t level = 0; level + 1 < mLevelOffsets.size(); ++level)
         {
-            // Propagate matrix change flag to children.
-            if (sceneGraph[i].parent != NodeID::Invalid())
+            Threading::parallelForRange(mLevelOffsets[level], mLevelOffsets[level + 1], [&](size_t begin, size_t end)
             {
-                mMatricesChanged[i] = mMatricesChanged[i] || mMatricesChanged[sceneGraph[i].parent.get()];
-            }
+                for (size_t i = begin; i < end; ++i) updateWorldMatrix(mLevelNodes[i], updateAll);
+            }, kNodeGrainSize);
+        }
+    }
 
-            if (!mMatricesChanged[i] && !updateAll) continue;
+    void AnimationController::updateWorldMatrix(size_t nodeIndex, bool updateAll)
+    {
+        const auto& node = mpScene->mSceneGraph[nodeIndex];
+        const size_t i = nodeIndex;
 
-            mGlobalMatrices[i] = mLocalMatrices[i];
+        // Propagate matrix change flag to children.
+        if (node.parent != NodeID::Invalid())
+        {
+            mMatricesChanged[i] = mMatricesChanged[i] || mMatricesChanged[node.parent.get()];
+        }
 
-            if (mpScene->mSceneGraph[i].parent != NodeID::Invalid())
-            {
-                mGlobalMatrices[i] = mGlobalMatrices[sceneGraph[i].parent.get()] * mGlobalMatrices[i];
-            }
+        if (!mMatricesChanged[i] && !updateAll) return;
 
-            mInvTransposeGlobalMatrices[i] = transpose(inverse(mGlobalMatrices[i]));
+        mGlobalMatrices[i] = mLocalMatrices[i];
 
-            if (mpSkinningPass)
-            {
-                mSkinningMatrices[i] = mGlobalMatrices[i] * sceneGraph[i].localToBindSpace;
-                mInvTransposeSkinningMatrices[i] = transpose(inverse(mSkinningMatrices[i]));
-            }
+        if (node.parent != NodeID::Invalid())
+        {
+            mGlobalMatrices[i] = mGlobalMatrices[node.parent.get()] * mGlobalMatrices[i];
+        }
+
+        mInvTransposeGlobalMatrices[i] = inverseTranspose(mGlobalMatrices[i]);
+
+        if (mpSkinningPass)
+        {
+            mSkinningMatrices[i] = mGlobalMatrices[i] * node.localToBindSpace;
+            mInvTransposeSkinningMatrices[i] = inverseTranspose(mSkinningMatrices[i]);
         }
     }
 
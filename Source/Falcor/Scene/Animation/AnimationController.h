@@ -58,7 +58,7 @@ namespace Falcor
 
         /** Add animated vertex caches (curves and meshes) to the controller.
         */
-        void addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, const StaticVertexVector& staticVertexData);
+        void addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, VertexCacheStore::SharedPtr pVertexCacheStore, const StaticVertexVector& staticVertexData);
 
         /** Returns true if controller contains animations.
         */
@@ -151,8 +151,10 @@ namespace Falcor
         AnimationController(std::shared_ptr<Device> pDevice, Scene* pScene, const StaticVertexVector& staticVertexData, const SkinningVertexVector& skinningVertexData, uint32_t prevVertexCount, const std::vector<Animation::SharedPtr>& animations);
 
         void initLocalMatrices();
+        void initNodeLevels();
         void updateLocalMatrices(double time);
         void updateWorldMatrices(bool updateAll = false);
+        void updateWorldMatrix(size_t nodeIndex, bool updateAll);
         void uploadWorldMatrices(bool uploadAll = false);
 
         void bindBuffers();
@@ -168,7 +170,10 @@ namespace Falcor
         std::vector<float4x4> mLocalMatrices;
         std::vector<float4x4> mGlobalMatrices;
         std::vector<float4x4> mInvTransposeGlobalMatrices;
-        std::vector<bool> mMatricesChanged;         ///< Flag per matrix, true if matrix changed since last frame.
+        std::vector<uint8_t> mMatricesChanged;      ///< Flag per matrix, true if matrix changed since last frame. Stored as bytes so that nodes can be updated in parallel.
+        std::vector<float4x4> mAnimationMatrices;   ///< Transform per animation, evaluated in parallel before being written to the local matrices.
+        std::vector<uint32_t> mLevelNodes;          ///< Scene graph node indices sorted by their depth in the graph.
+        std::vector<size_t> mLevelOffsets;          ///< Offsets into mLevelNodes of the nodes of each level, plus the total node count.
 
         bool mFirstUpdate = true;       ///< True if this is the first update.
         bool mEnabled = true;           ///< True if animations are enabled.
@@ -0,0 +1,467 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexCacheStore.h"
+#include "AnimatedVertexCache.h"
+#include "Core/Errors.h"
+#include "Utils/Logger.h"
+#include "Utils/Threading.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <lz4.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kMagic[8] = { 'F', 'a', 'l', 'c', 'o', 'r', 'V', 'C' };
+        const uint32_t kVersion = 1;
+
+        /** Header of a vertex cache store.
+            The header is followed by the chunk data and the chunk table, which holds the offset, stored size and size
+            of each chunk. All offsets are relative to the start of the store. Chunks that don't compress are stored raw.
+        */
+        struct StoreHeader
+        {
+            char magic[8]{};
+            uint32_t version = 0;
+            uint32_t compressed = 0;
+            uint32_t chunkCount = 0;
+            uint32_t reserved = 0;
+            uint64_t tableOffset = 0;   ///< Offset of the chunk table in bytes.
+            uint64_t size = 0;          ///< Size of the store in bytes.
+        };
+
+        const size_t kCopyBlockSize = 1 * 1024 * 1024;
+    }
+
+    VertexCacheStore::Writer::UniquePtr VertexCacheStore::Writer::create(const std::filesystem::path& path, bool compress)
+    {
+        return UniquePtr(new Writer(path, compress));
+    }
+
+    VertexCacheStore::Writer::Writer(const std::filesystem::path& path, bool compress)
+        : mPath(path)
+        , mCompress(compress)
+        , mStream(path, std::ios_base::binary)
+    {
+        if (!mStream) throw RuntimeError("Failed to create vertex cache store '{}'.", path);
+
+        // Write a placeholder header. It is rewritten once the chunk table is written.
+        StoreHeader header;
+        mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        mOffset = sizeof(header);
+    }
+
+    VertexCacheStore::Writer::~Writer()
+    {
+        if (!mFinalized)
+        {
+            mStream.close();
+            std::error_code ec;
+            std::filesystem::remove(mPath, ec);
+        }
+    }
+
+    void VertexCacheStore::Writer::addCachedCurve(CachedCurve& cache)
+    {
+        checkArgument(!cache.vertexData.empty(), "Cached curve has no keyframes.");
+
+        cache.vertexCount = (uint32_t)cache.vertexData.front().size();
+        std::vector<const void*> data;
+        std::vector<size_t> sizes;
+        for (const auto& keyframe : cache.vertexData)
+        {
+            if (keyframe.size() != cache.vertexCount) throw ArgumentError("Cached curve keyframes have different vertex counts.");
+            data.push_back(keyframe.data());
+            sizes.push_back(keyframe.size() * sizeof(DynamicCurveVertexData));
+        }
+        cache.firstChunk = addChunks(data, sizes);
+        cache.vertexData = {};
+    }
+
+    void VertexCacheStore::Writer::addCachedMesh(CachedMesh& cache)
+    {
+        checkArgument(!cache.vertexData.empty(), "Cached mesh has no keyframes.");
+
+        cache.vertexCount = (uint32_t)cache.vertexData.front().size();
+        std::vector<const void*> data;
+        std::vector<size_t> sizes;
+        for (const auto& keyframe : cache.vertexData)
+        {
+            if (keyframe.size() != cache.vertexCount) throw ArgumentError("Cached mesh keyframes have different vertex counts.");
+            data.push_back(keyframe.data());
+            sizes.push_back(keyframe.size() * sizeof(PackedStaticVertexData));
+        }
+        cache.firstChunk = addChunks(data, sizes);
+        cache.vertexData = {};
+    }
+
+    uint32_t VertexCacheStore::Writer::addChunks(const std::vector<const void*>& data, const std::vector<size_t>& sizes)
+    {
+        FALCOR_ASSERT(data.size() == sizes.size());
+        FALCOR_ASSERT(mStream.is_open());
+
+        // Compress chunks in parallel. Chunks that don't compress are stored raw.
+        std::vector<std::vector<char>> compressed(data.size());
+        if (mCompress)
+        {
+            Threading::parallelFor(0, data.size(), [&](size_t i)
+            {
+                if (sizes[i] == 0 || sizes[i] > LZ4_MAX_INPUT_SIZE) return;
+                int srcSize = (int)sizes[i];
+                compressed[i].resize(LZ4_compressBound(srcSize));
+                int compressedSize = LZ4_compress_default(reinterpret_cast<const char*>(data[i]), compressed[i].data(), srcSize, (int)compressed[i].size());
+                if (compressedSize > 0 && compressedSize < srcSize) compressed[i].resize(compressedSize);
+                else compressed[i] = {};
+            }, 1);
+        }
+
+        uint32_t firstChunk = (uint32_t)(mChunkTable.size() / 3);
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            bool isCompressed = !compressed[i].empty();
+            const char* pData = isCompressed ? compressed[i].data() : reinterpret_cast<const char*>(data[i]);
+            uint64_t storedSize = isCompressed ? compressed[i].size() : sizes[i];
+            mStream.write(pData, storedSize);
+
+            mChunkTable.push_back(mOffset);
+            mChunkTable.push_back(storedSize);
+            mChunkTable.push_back(sizes[i]);
+            mOffset += storedSize;
+        }
+        if (!mStream) throw RuntimeError("Failed to write vertex cache store '{}'.", mPath);
+
+        return firstChunk;
+    }
+
+    VertexCacheStore::SharedPtr VertexCacheStore::Writer::finalize(bool deleteOnClose)
+    {
+        FALCOR_ASSERT(mStream.is_open());
+
+        StoreHeader header;
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.compressed = mCompress ? 1 : 0;
+        header.chunkCount = (uint32_t)(mChunkTable.size() / 3);
+        header.tableOffset = mOffset;
+        header.size = mOffset + mChunkTable.size() * sizeof(uint64_t);
+
+        mStream.write(reinterpret_cast<const char*>(mChunkTable.data()), mChunkTable.size() * sizeof(uint64_t));
+        mStream.seekp(0);
+        mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        mStream.close();
+        if (!mStream) throw RuntimeError("Failed to write vertex cache store '{}'.", mPath);
+
+        auto pStore = VertexCacheStore::open(mPath, 0, deleteOnClose);
+        mFinalized = true;
+        return pStore;
+    }
+
+    VertexCacheStore::SharedPtr VertexCacheStore::open(const std::filesystem::path& path, uint64_t offset, bool deleteOnClose)
+    {
+        return SharedPtr(new VertexCacheStore(path, offset, deleteOnClose));
+    }
+
+    VertexCacheStore::VertexCacheStore(const std::filesystem::path& path, uint64_t offset, bool deleteOnClose)
+        : mPath(path)
+        , mOffset(offset)
+        , mDeleteOnClose(deleteOnClose)
+        , mStream(path, std::ios_base::binary)
+    {
+        if (!mStream) throw RuntimeError("Failed to open vertex cache store '{}'.", path);
+
+        StoreHeader header;
+        mStream.seekg(offset);
+        mStream.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!mStream || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion)
+        {
+            throw RuntimeError("Invalid vertex cache store '{}'.", path);
+        }
+
+        std::vector<uint64_t> chunkTable((size_t)header.chunkCount * 3);
+        mStream.seekg(offset + header.tableOffset);
+        mStream.read(reinterpret_cast<char*>(chunkTable.data()), chunkTable.size() * sizeof(uint64_t));
+        if (!mStream) throw RuntimeError("Invalid chunk table in vertex cache store '{}'.", path);
+
+        mChunks.resize(header.chunkCount);
+        for (size_t i = 0; i < mChunks.size(); i++)
+        {
+            Chunk& c = mChunks[i];
+            c.offset = chunkTable[i * 3];
+            c.storedSize = chunkTable[i * 3 + 1];
+            c.size = chunkTable[i * 3 + 2];
+            if (c.offset + c.storedSize > header.tableOffset || c.storedSize > c.size) throw RuntimeError("Invalid chunk table in vertex cache store '{}'.", path);
+        }
+
+        mSize = header.size;
+        mCompressed = header.compressed != 0;
+    }
+
+    VertexCacheStore::~VertexCacheStore()
+    {
+        terminateWorker();
+
+        mStream.close();
+        if (mDeleteOnClose)
+        {
+            std::error_code ec;
+            std::filesystem::remove(mPath, ec);
+        }
+    }
+
+    uint64_t VertexCacheStore::getChunkSize(uint32_t chunk) const
+    {
+        checkArgument(chunk < getChunkCount(), "'chunk' ({}) is out of range", chunk);
+        return mChunks[chunk].size;
+    }
+
+    VertexCacheStore::ChunkData VertexCacheStore::getChunk(uint32_t chunk)
+    {
+        checkArgument(chunk < getChunkCount(), "'chunk' ({}) is out of range", chunk);
+
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        Chunk& c = mChunks[chunk];
+        if (c.state == ChunkState::Loaded)
+        {
+            mStats.hits++;
+        }
+        else
+        {
+            mStats.misses++;
+            auto startTime = CpuTimer::getCurrentTimePoint();
+
+            if (c.state == ChunkState::Loading)
+            {
+                mLoadCondition.wait(lock, [&] { return c.state != ChunkState::Loading; });
+            }
+
+            // Load the chunk on the calling thread instead of waiting for the worker to pick it up.
+            // This is also the fallback if the worker failed to load the chunk.
+            if (c.state != ChunkState::Loaded)
+            {
+                if (c.state == ChunkState::Queued) mPrefetchQueue.erase(std::find(mPrefetchQueue.begin(), mPrefetchQueue.end(), chunk));
+                c.state = ChunkState::Loading;
+                lock.unlock();
+                std::vector<uint8_t> data;
+                try
+                {
+                    data = readChunk(chunk);
+                }
+                catch (...)
+                {
+                    lock.lock();
+                    c.state = ChunkState::Unloaded;
+                    mLoadCondition.notify_all();
+                    throw;
+                }
+                lock.lock();
+                c.pData = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+                c.state = ChunkState::Loaded;
+                mLoadCondition.notify_all();
+            }
+
+            mStats.stallTime += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        }
+
+        // Chunks outside of the prefetch window are not kept loaded.
+        ChunkData pData = c.pData;
+        if (!c.inWindow)
+        {
+            c.pData.reset();
+            c.state = ChunkState::Unloaded;
+        }
+
+        return pData;
+    }
+
+    void VertexCacheStore::setPrefetchWindow(const std::vector<uint32_t>& chunks)
+    {
+        for (uint32_t chunk : chunks) checkArgument(chunk < getChunkCount(), "'chunk' ({}) is out of range", chunk);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (chunks == mWindow) return;
+
+        for (uint32_t chunk : mWindow) mChunks[chunk].inWindow = false;
+        for (uint32_t chunk : chunks) mChunks[chunk].inWindow = true;
+
+        // Release chunks that left the window. Only chunks in the window are loaded or queued.
+        for (uint32_t chunk : mWindow)
+        {
+            Chunk& c = mChunks[chunk];
+            if (c.inWindow) continue;
+            if (c.state == ChunkState::Loaded) c.pData.reset();
+            if (c.state != ChunkState::Loading) c.state = ChunkState::Unloaded;
+        }
+
+        // Queue the chunks that are not loaded yet in the new priority order.
+        for (uint32_t chunk : mPrefetchQueue)
+        {
+            if (mChunks[chunk].state == ChunkState::Queued) mChunks[chunk].state = ChunkState::Unloaded;
+        }
+        mPrefetchQueue.clear();
+        for (uint32_t chunk : chunks)
+        {
+            Chunk& c = mChunks[chunk];
+            if (c.state != ChunkState::Unloaded) continue;
+            c.state = ChunkState::Queued;
+            mPrefetchQueue.push_back(chunk);
+        }
+
+        mWindow = chunks;
+
+        if (!mPrefetchQueue.empty())
+        {
+            if (!mThread.joinable()) mThread = std::thread(&VertexCacheStore::runWorker, this);
+            mWorkerCondition.notify_all();
+        }
+    }
+
+    void VertexCacheStore::waitForPrefetch()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mLoadCondition.wait(lock, [&] { return mPrefetchQueue.empty() && mLoadingCount == 0; });
+    }
+
+    VertexCacheStore::Stats VertexCacheStore::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        Stats stats = mStats;
+        for (const auto& c : mChunks)
+        {
+            if (c.state == ChunkState::Loaded)
+            {
+                stats.loadedChunkCount++;
+                stats.loadedMemoryInBytes += c.size;
+            }
+        }
+        return stats;
+    }
+
+    void VertexCacheStore::copyTo(std::ostream& stream) const
+    {
+        std::ifstream fs(mPath, std::ios_base::binary);
+        if (!fs) throw RuntimeError("Failed to open vertex cache store '{}'.", mPath);
+        fs.seekg(mOffset);
+
+        std::vector<char> buffer(kCopyBlockSize);
+        for (uint64_t offset = 0; offset < mSize; offset += kCopyBlockSize)
+        {
+            size_t size = (size_t)std::min<uint64_t>(kCopyBlockSize, mSize - offset);
+            fs.read(buffer.data(), size);
+            if (!fs) throw RuntimeError("Failed to read vertex cache store '{}'.", mPath);
+            stream.write(buffer.data(), size);
+        }
+    }
+
+    std::vector<uint8_t> VertexCacheStore::readChunk(uint32_t chunk)
+    {
+        // The chunk table is immutable, so it can be accessed without locking.
+        const Chunk& c = mChunks[chunk];
+
+        std::vector<uint8_t> storedData(c.storedSize);
+        {
+            std::lock_guard<std::mutex> lock(mFileMutex);
+            mStream.seekg(mOffset + c.offset);
+            mStream.read(reinterpret_cast<char*>(storedData.data()), c.storedSize);
+            if (!mStream)
+            {
+                mStream.clear();
+                throw RuntimeError("Failed to read chunk {} from vertex cache store '{}'.", chunk, mPath);
+            }
+        }
+
+        if (c.storedSize == c.size) return storedData;
+
+        std::vector<uint8_t> data(c.size);
+        int size = LZ4_decompress_safe(reinterpret_cast<const char*>(storedData.data()), reinterpret_cast<char*>(data.data()), (int)c.storedSize, (int)c.size);
+        if (size != (int)c.size) throw RuntimeError("Failed to decompress chunk {} from vertex cache store '{}'.", chunk, mPath);
+        return data;
+    }
+
+    void VertexCacheStore::runWorker()
+    {
+        while (true)
+        {
+            uint32_t chunk;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWorkerCondition.wait(lock, [&] { return mTerminate || !mPrefetchQueue.empty(); });
+                if (mTerminate) break;
+
+                chunk = mPrefetchQueue.front();
+                mPrefetchQueue.pop_front();
+                mChunks[chunk].state = ChunkState::Loading;
+                mLoadingCount++;
+            }
+
+            ChunkData pData;
+            try
+            {
+                pData = std::make_shared<const std::vector<uint8_t>>(readChunk(chunk));
+            }
+            catch (const std::exception& e)
+            {
+                logWarning("Error when prefetching vertex cache keyframe: {}", e.what());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                Chunk& c = mChunks[chunk];
+                // Discard the chunk if it left the window while loading. Failed chunks are loaded again on request.
+                if (pData && c.inWindow)
+                {
+                    c.pData = std::move(pData);
+                    c.state = ChunkState::Loaded;
+                    mStats.prefetches++;
+                }
+                else
+                {
+                    c.state = ChunkState::Unloaded;
+                }
+                mLoadingCount--;
+            }
+            mLoadCondition.notify_all();
+        }
+    }
+
+    void VertexCacheStore::terminateWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTerminate = true;
+        }
+
+        mWorkerCondition.notify_all();
+
+        if (mThread.joinable()) mThread.join();
+    }
+}
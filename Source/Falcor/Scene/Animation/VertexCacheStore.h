@@ -0,0 +1,226 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+    struct CachedCurve;
+    struct CachedMesh;
+
+    /** On-disk store for the keyframes of vertex caches (cached curves and meshes).
+        Every keyframe of every cache is stored as an independent chunk, which is optionally LZ4 compressed.
+        Chunks are read on demand. A background thread loads the chunks of a prefetch window set by the caller,
+        and chunks outside of the window are released, so only a few keyframes are held in host memory at a time.
+        The store can be embedded in another file (e.g. the scene cache) at a given offset.
+    */
+    class FALCOR_API VertexCacheStore
+    {
+    public:
+        using SharedPtr = std::shared_ptr<VertexCacheStore>;
+        using ChunkData = std::shared_ptr<const std::vector<uint8_t>>;
+
+        /** Writes a vertex cache store file.
+            Keyframes are written as soon as they are added, so they can be released from host memory right away.
+        */
+        class FALCOR_API Writer
+        {
+        public:
+            using UniquePtr = std::unique_ptr<Writer>;
+
+            /** Create a writer.
+                \param[in] path File path of the store.
+                \param[in] compress Compress the chunks.
+                \return A new writer.
+            */
+            static UniquePtr create(const std::filesystem::path& path, bool compress);
+
+            /** Destroy the writer. The file is deleted if the store was not finalized, e.g. because loading the scene failed.
+            */
+            ~Writer();
+
+            /** Write the keyframes of a cached curve.
+                The keyframes are moved out of the cache and its vertex count and first chunk index are set.
+                \param[in,out] cache Cached curve.
+            */
+            void addCachedCurve(CachedCurve& cache);
+
+            /** Write the keyframes of a cached mesh.
+                The keyframes are moved out of the cache and its vertex count and first chunk index are set.
+                \param[in,out] cache Cached mesh.
+            */
+            void addCachedMesh(CachedMesh& cache);
+
+            /** Finish writing the store and open it for reading.
+                \param[in] deleteOnClose Delete the file when the returned store is destroyed.
+                \return The store.
+            */
+            SharedPtr finalize(bool deleteOnClose);
+
+        private:
+            Writer(const std::filesystem::path& path, bool compress);
+
+            /** Write chunks, compressing them in parallel.
+                \return Index of the first written chunk.
+            */
+            uint32_t addChunks(const std::vector<const void*>& data, const std::vector<size_t>& sizes);
+
+            std::filesystem::path mPath;
+            bool mCompress;
+            std::ofstream mStream;
+            uint64_t mOffset = 0;
+            std::vector<uint64_t> mChunkTable;  ///< Offset, stored size and size of each chunk.
+            bool mFinalized = false;
+        };
+
+        /** Streaming statistics.
+        */
+        struct Stats
+        {
+            uint64_t hits = 0;                      ///< Number of requests for chunks that were already loaded.
+            uint64_t misses = 0;                    ///< Number of requests for chunks that had to be loaded or waited for.
+            uint64_t prefetches = 0;                ///< Number of chunks loaded by the prefetch thread.
+            double stallTime = 0.0;                 ///< Total time in ms spent waiting for chunks on misses.
+            uint32_t loadedChunkCount = 0;          ///< Number of currently loaded chunks.
+            uint64_t loadedMemoryInBytes = 0;       ///< Memory in bytes used by the currently loaded chunks.
+        };
+
+        /** Open a vertex cache store.
+            \param[in] path File path.
+            \param[in] offset Offset of the store in the file in bytes.
+            \param[in] deleteOnClose Delete the file when the store is destroyed.
+            \return The store.
+        */
+        static SharedPtr open(const std::filesystem::path& path, uint64_t offset = 0, bool deleteOnClose = false);
+
+        /** Destructor.
+            Blocks until the prefetch thread has terminated.
+        */
+        ~VertexCacheStore();
+
+        /** Get the number of chunks.
+        */
+        uint32_t getChunkCount() const { return (uint32_t)mChunks.size(); }
+
+        /** Get the decompressed size of a chunk in bytes.
+        */
+        uint64_t getChunkSize(uint32_t chunk) const;
+
+        /** Check if the chunks are compressed.
+        */
+        bool isCompressed() const { return mCompressed; }
+
+        /** Get the size of the store in the file in bytes.
+        */
+        uint64_t getSizeInBytes() const { return mSize; }
+
+        /** Get a chunk.
+            Blocks if the chunk is not loaded yet. Chunks outside of the prefetch window are not kept loaded.
+            \param[in] chunk Chunk index.
+            \return The decompressed chunk data.
+        */
+        ChunkData getChunk(uint32_t chunk);
+
+        /** Set the chunks to keep loaded.
+            Chunks in the window that are not loaded yet are queued for prefetching in the given order,
+            loaded chunks outside of the window are released.
+            \param[in] chunks Chunk indices in priority order.
+        */
+        void setPrefetchWindow(const std::vector<uint32_t>& chunks);
+
+        /** Block until all queued prefetches have finished.
+        */
+        void waitForPrefetch();
+
+        /** Get the streaming statistics.
+        */
+        Stats getStats() const;
+
+        /** Copy the store to a stream (e.g. to embed it in another file).
+            \param[in] stream Output stream.
+        */
+        void copyTo(std::ostream& stream) const;
+
+    private:
+        VertexCacheStore(const std::filesystem::path& path, uint64_t offset, bool deleteOnClose);
+
+        enum class ChunkState
+        {
+            Unloaded,   ///< Chunk is not loaded.
+            Queued,     ///< Chunk is queued for prefetching.
+            Loading,    ///< Chunk is being loaded.
+            Loaded,     ///< Chunk is loaded.
+        };
+
+        struct Chunk
+        {
+            uint64_t offset = 0;        ///< Offset from the start of the store in bytes.
+            uint64_t storedSize = 0;    ///< Stored (compressed) size in bytes.
+            uint64_t size = 0;          ///< Decompressed size in bytes.
+            ChunkState state = ChunkState::Unloaded;
+            bool inWindow = false;
+            ChunkData pData;
+        };
+
+        std::vector<uint8_t> readChunk(uint32_t chunk);
+
+        void runWorker();
+        void terminateWorker();
+
+        std::filesystem::path mPath;
+        uint64_t mOffset = 0;
+        uint64_t mSize = 0;
+        bool mCompressed = false;
+        bool mDeleteOnClose = false;
+
+        std::mutex mFileMutex;                      ///< Mutex for synchronizing reads from the file.
+        std::ifstream mStream;
+
+        mutable std::mutex mMutex;                  ///< Mutex for synchronizing access to the chunk state.
+        std::condition_variable mWorkerCondition;   ///< Condition variable for the worker to wait on.
+        std::condition_variable mLoadCondition;     ///< Condition variable signaled when a chunk has finished loading.
+        std::thread mThread;                        ///< Prefetch thread.
+
+        // Internal state. Do not access outside of critical section.
+        std::vector<Chunk> mChunks;                 ///< Per-chunk state.
+        std::vector<uint32_t> mWindow;              ///< Current prefetch window.
+        std::deque<uint32_t> mPrefetchQueue;        ///< Chunks queued for prefetching, in priority order.
+        uint32_t mLoadingCount = 0;                 ///< Number of chunks currently loaded by the worker.
+        Stats mStats;
+        bool mTerminate = false;
+    };
+}
@@ -87,9 +87,15 @@ namespace Falcor
     }
 
     static constexpr std::size_t grapher_bins = 128;
+    struct GraphData
+    {
+        const float* pdf;
+        uint32_t bins;
+    };
     static float grapher(void* ptr, std::int32_t idx) {
-        const auto& profile = *(const SpectralProfile*)ptr;
-        return profile.pdf[(std::size_t)clamp(idx / float(grapher_bins - 1) * profile.bins, .0f, profile.bins - .5f)];
+        const auto& data = *(const GraphData*)ptr;
+        if (data.bins == 0) return 0.f;
+        return data.pdf[(std::size_t)clamp(idx / float(grapher_bins - 1) * data.bins, .0f, data.bins - .5f)];
     }
 
     void Light::renderUI(Gui::Widgets& widget, const Scene *scene)
@@ -102,7 +108,8 @@ namespace Falcor
         float3 intensity = intensitySpectrum.rgb;
         intensity /= std::max(1.f,std::max(intensity.r, std::max(intensity.g, intensity.b)));
         const auto& profile = scene->getSpectralProfile(mData.intensitySpectrumId);
-        widget.graph("emission spectrum", grapher, (void*)&profile, grapher_bins, 0);
+        GraphData data = { scene->getSpectralProfileData().data() + profile.pdfOffset, profile.bins };
+        widget.graph("emission spectrum", grapher, &data, grapher_bins, 0);
         widget.rgbColor("", intensity);
     }
 
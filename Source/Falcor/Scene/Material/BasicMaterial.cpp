@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "BasicMaterial.h"
 #include "MaterialSystem.h"
+#include "Scene/Scene.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Core/Program/GraphicsProgram.h"
@@ -273,6 +274,25 @@ namespace Falcor
         }
     }
 
+    void BasicMaterial::UIHelpers::graph(Gui::Widgets& widget, const char label[], const Scene* scene, uint32_t profileId)
+    {
+        struct GraphData
+        {
+            const float* pdf;
+            uint32_t bins;
+        };
+
+        const auto& profile = scene->getSpectralProfile(profileId);
+        GraphData data = { scene->getSpectralProfileData().data() + profile.pdfOffset, profile.bins };
+        auto grapher = [](void* ptr, std::int32_t idx) -> float
+        {
+            const auto& data = *(const GraphData*)ptr;
+            if (data.bins == 0) return 0.f;
+            return data.pdf[(std::size_t)clamp(idx / float(grapher_bins - 1) * data.bins, .0f, data.bins - .5f)];
+        };
+        widget.graph(label, grapher, &data, grapher_bins, 0);
+    }
+
     void BasicMaterial::setEmissionSpectralProfile(bool emissive, SpectralProfileID id)
     {
         if (!emissive)
@@ -672,6 +692,41 @@ namespace Falcor
         return true;
     }
 
+    uint64_t BasicMaterial::getHash() const
+    {
+        FNVHash64 hash;
+        hashBase(hash);
+
+        // Hash the same fields as operator==.
+#define hash_field(_a) hash.insert(&mData._a, sizeof(mData._a))
+        hash_field(flags);
+        hash_field(displacementScale);
+        hash_field(displacementOffset);
+        hash_field(baseColor);
+        hash_field(specular);
+        hash_field(data1);
+        hash_field(data2);
+        hash_field(emissionSpectralId);
+        hash_field(iorNSpectralId);
+        hash_field(iorKSpectralId);
+        hash_field(IoR);
+        hash_field(diffuseTransmission);
+        hash_field(specularTransmission);
+        hash_field(transmission);
+        hash_field(volumeAbsorption);
+        hash_field(volumeAnisotropy);
+        hash_field(volumeScattering);
+#undef hash_field
+
+        for (const auto& pSampler : { mpDefaultSampler, mpDisplacementMinSampler, mpDisplacementMaxSampler })
+        {
+            uint64_t samplerHash = pSampler->getDesc().getHash();
+            hash.insert(&samplerHash, sizeof(samplerHash));
+        }
+
+        return hash.get();
+    }
+
     void BasicMaterial::updateAlphaMode()
     {
         if (!isAlphaSupported())
@@ -46,10 +46,14 @@ namespace Falcor
     public:
         struct UIHelpers {
             static constexpr std::size_t grapher_bins = 128;
-            static float grapher(void* ptr, std::int32_t idx) {
-                const auto& profile = *(const SpectralProfile*)ptr;
-                return profile.pdf[(std::size_t)clamp(idx / float(grapher_bins - 1) * profile.bins, .0f, profile.bins - .5f)];
-            }
+
+            /** Draw a graph of a spectral profile's pdf.
+                \param[in] widget The widget to draw in.
+                \param[in] label Graph label.
+                \param[in] scene Scene holding the profile.
+                \param[in] profileId Spectral profile ID.
+            */
+            static void graph(Gui::Widgets& widget, const char label[], const Scene* scene, uint32_t profileId);
         };
 
         using SharedPtr = std::shared_ptr<BasicMaterial>;
@@ -75,6 +79,10 @@ namespace Falcor
         */
         bool isEqual(const Material::SharedPtr& pOther) const override;
 
+        /** Compute a hash of the material properties compared by isEqual().
+        */
+        uint64_t getHash() const override;
+
         /** Set the alpha mode.
         */
         void setAlphaMode(AlphaMode alphaMode) override;
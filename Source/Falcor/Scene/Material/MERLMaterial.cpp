@@ -150,6 +150,15 @@ namespace Falcor
         return true;
     }
 
+    uint64_t MERLMaterial::getHash() const
+    {
+        FNVHash64 hash;
+        hashBase(hash);
+        const auto& path = mPath.native();
+        hash.insert(path.data(), path.size() * sizeof(path[0]));
+        return hash.get();
+    }
+
     Program::ShaderModuleList MERLMaterial::getShaderModules() const
     {
         return { Program::ShaderModule(kShaderFile) };
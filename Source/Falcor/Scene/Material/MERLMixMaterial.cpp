@@ -240,6 +240,24 @@ namespace Falcor
         return true;
     }
 
+    uint64_t MERLMixMaterial::getHash() const
+    {
+        FNVHash64 hash;
+        hashBase(hash);
+
+        for (const auto& brdf : mBRDFs)
+        {
+            hash.insert(brdf.name.data(), brdf.name.size());
+            const auto& path = brdf.path.native();
+            hash.insert(path.data(), path.size() * sizeof(path[0]));
+        }
+
+        uint64_t samplerHash = mpDefaultSampler->getDesc().getHash();
+        hash.insert(&samplerHash, sizeof(samplerHash));
+
+        return hash.get();
+    }
+
     Program::ShaderModuleList MERLMixMaterial::getShaderModules() const
     {
         return { Program::ShaderModule(kShaderFile) };
@@ -306,6 +306,36 @@ namespace Falcor
         return true;
     }
 
+    void Material::hashBase(FNVHash64& hash) const
+    {
+        // This hashes the same data as isBaseEqual(). Floats are hashed by their bit patterns,
+        // so values that only differ in the sign of zero may miss being detected as duplicates.
+        auto insert = [&hash](const auto& value) { hash.insert(&value, sizeof(value)); };
+
+        insert(mHeader.packedData);
+        insert(mTextureTransform.getTranslation());
+        insert(mTextureTransform.getScaling());
+        insert(mTextureTransform.getRotation());
+
+        FALCOR_ASSERT(mTextureSlotInfo.size() == mTextureSlotData.size());
+        for (size_t i = 0; i < mTextureSlotInfo.size(); i++)
+        {
+            auto slot = (TextureSlot)i;
+            bool hasSlot = hasTextureSlot(slot);
+            insert(hasSlot);
+            if (hasSlot)
+            {
+                const auto& info = mTextureSlotInfo[i];
+                hash.insert(info.name.data(), info.name.size());
+                insert(info.mask);
+                insert(info.srgb);
+                // Textures are compared by pointer in isBaseEqual().
+                const Texture* pTexture = mTextureSlotData[i].pTexture.get();
+                insert(pTexture);
+            }
+        }
+    }
+
     NormalMapType Material::detectNormalMapType(const Texture::SharedPtr& pNormalMap)
     {
         NormalMapType type = NormalMapType::None;
@@ -35,6 +35,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Sampler.h"
 #include "Utils/Image/TextureAnalyzer.h"
+#include "Utils/Math/FNVHash.h"
 #include "Utils/UI/Gui.h"
 #include "Scene/Transform.h"
 #include "MaterialTypeRegistry.h"
@@ -160,6 +161,13 @@ namespace Falcor
         */
         virtual bool isEqual(const Material::SharedPtr& pOther) const = 0;
 
+        /** Compute a hash of the material properties compared by isEqual().
+            Materials that compare equal have the same hash, so the hash can be used to find duplicate candidates
+            without comparing all pairs of materials. Candidates need to be verified with isEqual().
+            \return Hash of all material properties *except* the name.
+        */
+        virtual uint64_t getHash() const = 0;
+
         /** Set the double-sided flag. This flag doesn't affect the cull state, just the shading.
         */
         virtual void setDoubleSided(bool doubleSided);
@@ -332,6 +340,10 @@ namespace Falcor
         void updateDefaultTextureSamplerID(MaterialSystem* pOwner, const Sampler::SharedPtr& pSampler);
         bool isBaseEqual(const Material& other) const;
 
+        /** Insert all data compared by isBaseEqual() into a hash.
+        */
+        void hashBase(FNVHash64& hash) const;
+
         static NormalMapType detectNormalMapType(const Texture::SharedPtr& pNormalMap);
 
         template<typename T>
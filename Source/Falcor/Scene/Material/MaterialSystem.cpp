@@ -30,6 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include "Utils/Threading.h"
 #include "MaterialTypeRegistry.h"
 #include <numeric>
 
@@ -136,14 +137,13 @@ namespace Falcor
     uint32_t MaterialSystem::addTextureSampler(const Sampler::SharedPtr& pSampler)
     {
         FALCOR_ASSERT(pSampler);
-        auto isEqual = [&pSampler](const Sampler::SharedPtr& pOther) {
-            return pSampler->getDesc() == pOther->getDesc();
-        };
 
-        // Reuse previously added samplers. We compare by sampler desc.
-        if (auto it = std::find_if(mTextureSamplers.begin(), mTextureSamplers.end(), isEqual); it != mTextureSamplers.end())
+        // Reuse previously added samplers. We compare by sampler desc, using the desc hash to find candidates.
+        const uint64_t hash = pSampler->getDesc().getHash();
+        auto& bucket = mTextureSamplersByHash[hash];
+        for (uint32_t samplerID : bucket)
         {
-            return (uint32_t)std::distance(mTextureSamplers.begin(), it);
+            if (pSampler->getDesc() == mTextureSamplers[samplerID]->getDesc()) return samplerID;
         }
 
         // Add sampler.
@@ -154,6 +154,7 @@ namespace Falcor
         const uint32_t samplerID = static_cast<uint32_t>(mTextureSamplers.size());
 
         mTextureSamplers.push_back(pSampler);
+        bucket.push_back(samplerID);
         mSamplersChanged = true;
 
         return samplerID;
@@ -290,20 +291,29 @@ namespace Falcor
         std::vector<Material::SharedPtr> uniqueMaterials;
         idMap.resize(mMaterials.size());
 
-        // Find unique set of materials.
+        // Hash all materials. Only materials with identical hashes need to be compared.
+        std::vector<uint64_t> hashes(mMaterials.size());
+        Threading::parallelFor(0, mMaterials.size(), [&](size_t i) { hashes[i] = mMaterials[i]->getHash(); });
+
+        // Find unique set of materials. Each bucket holds the indices of the unique materials with a given hash.
+        std::unordered_map<uint64_t, std::vector<size_t>> uniqueByHash;
+        uniqueByHash.reserve(mMaterials.size());
+
         for (MaterialID id{ 0 }; id.get() < mMaterials.size(); ++id)
         {
             const auto& pMaterial = mMaterials[id.get()];
-            auto it = std::find_if(uniqueMaterials.begin(), uniqueMaterials.end(), [&pMaterial](const auto& m) { return m->isEqual(pMaterial); });
-            if (it == uniqueMaterials.end())
+            auto& bucket = uniqueByHash[hashes[id.get()]];
+            auto it = std::find_if(bucket.begin(), bucket.end(), [&](size_t index) { return uniqueMaterials[index]->isEqual(pMaterial); });
+            if (it == bucket.end())
             {
                 idMap[id.get()] = MaterialID{ uniqueMaterials.size() };
+                bucket.push_back(uniqueMaterials.size());
                 uniqueMaterials.push_back(pMaterial);
             }
             else
             {
-                logInfo("Removing duplicate material '{}' (duplicate of '{}').", pMaterial->getName(), (*it)->getName());
-                idMap[id.get()] = MaterialID{ (size_t)std::distance(uniqueMaterials.begin(), it) };
+                logInfo("Removing duplicate material '{}' (duplicate of '{}').", pMaterial->getName(), uniqueMaterials[*it]->getName());
+                idMap[id.get()] = MaterialID{ *it };
             }
         }
 
@@ -553,6 +563,8 @@ namespace Falcor
         s.textureTexelCount = textureStats.textureTexelCount;
         s.textureTexelChannelCount = textureStats.textureTexelChannelCount;
         s.textureMemoryInBytes = textureStats.textureMemoryInBytes;
+        s.textureDeduplicatedCount = textureStats.textureDeduplicatedCount;
+        s.textureDeduplicatedMemoryInBytes = textureStats.textureDeduplicatedMemoryInBytes;
 
         return s;
     }
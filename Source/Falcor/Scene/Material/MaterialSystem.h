@@ -39,6 +39,7 @@
 #include <memory>
 #include <vector>
 #include <set>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -72,6 +73,8 @@ namespace Falcor
             uint64_t textureTexelCount = 0;             ///< Total number of texels in all textures.
             uint64_t textureTexelChannelCount = 0;      ///< Total number of texel channels in all textures.
             uint64_t textureMemoryInBytes = 0;          ///< Total memory in bytes used by the textures.
+            uint64_t textureDeduplicatedCount = 0;      ///< Number of texture files that share an already loaded texture with identical file content.
+            uint64_t textureDeduplicatedMemoryInBytes = 0; ///< Memory in bytes saved by sharing textures with identical file content.
         };
 
         /** Create a material system.
@@ -257,6 +260,7 @@ namespace Falcor
         Buffer::SharedPtr mpMaterialDataBuffer;                     ///< GPU buffer holding all material data.
         Sampler::SharedPtr mpDefaultTextureSampler;                 ///< Default texture sampler to use for all materials.
         std::vector<Sampler::SharedPtr> mTextureSamplers;           ///< Texture sampler states. These are indexed by ID in the materials.
+        std::unordered_map<uint64_t, std::vector<uint32_t>> mTextureSamplersByHash; ///< Sampler IDs bucketed by the hash of their sampler desc.
         std::vector<Buffer::SharedPtr> mBuffers;                    ///< Buffers used by the materials. These are indexed by ID in the materials.
 
         // UI variables
@@ -138,6 +138,15 @@ namespace Falcor
         return true;
     }
 
+    uint64_t RGLMaterial::getHash() const
+    {
+        FNVHash64 hash;
+        hashBase(hash);
+        const auto& path = mFilePath.native();
+        hash.insert(path.data(), path.size() * sizeof(path[0]));
+        return hash.get();
+    }
+
     Program::ShaderModuleList RGLMaterial::getShaderModules() const
     {
         return { Program::ShaderModule(kShaderFile) };
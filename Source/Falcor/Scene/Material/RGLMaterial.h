@@ -54,6 +54,7 @@ namespace Falcor
         bool renderUI(Gui::Widgets& widget, const Scene *scene) override;
         Material::UpdateFlags update(MaterialSystem* pOwner) override;
         bool isEqual(const Material::SharedPtr& pOther) const override;
+        uint64_t getHash() const override;
         MaterialDataBlob getDataBlob() const override { return prepareDataBlob(mData); }
         Program::ShaderModuleList getShaderModules() const override;
         Program::TypeConformanceList getTypeConformances() const override;
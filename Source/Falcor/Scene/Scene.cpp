@@ -155,6 +155,7 @@ namespace Falcor
         mCameraSpeed = sceneData.cameraSpeed;
         mLights = std::move(sceneData.lights);
         mSpectralProfiles = std::move(sceneData.spectralProfiles);
+        mSpectralProfileData = std::move(sceneData.spectralProfileData);
 
         mpMaterials = std::move(sceneData.pMaterials);
         mGridVolumes = std::move(sceneData.gridVolumes);
@@ -203,6 +204,18 @@ namespace Falcor
         // Setup volume grid -> id map.
         for (size_t i = 0; i < mGrids.size(); ++i) mGridIDs.emplace(mGrids[i], (uint32_t)i);
 
+        // Reserve a grid ID for each streamed grid slot.
+        for (size_t volumeIndex = 0; volumeIndex < mGridVolumes.size(); ++volumeIndex)
+        {
+            for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridVolume::GridSlot::Count; ++slotIndex)
+            {
+                const auto slot = (GridVolume::GridSlot)slotIndex;
+                if (!mGridVolumes[volumeIndex]->getGridStreamer(slot)) continue;
+                mStreamedGrids.push_back({ (uint32_t)volumeIndex, slot, SdfGridID{ mGrids.size() } });
+                mGrids.push_back(mGridVolumes[volumeIndex]->getGrid(slot));
+            }
+        }
+
         // Set default SDF grid config.
         setSDFGridConfig();
 
@@ -225,11 +238,12 @@ namespace Falcor
         for (const auto &mesh : sceneData.cachedMeshes)
         {
             if (!mMeshDesc[mesh.meshID.get()].isAnimated()) throw RuntimeError("Cached Mesh Animation: Referenced mesh ID is not dynamic");
-            if (mesh.timeSamples.size() != mesh.vertexData.size()) throw RuntimeError("Cached Mesh Animation: Time sample count mismatch.");
+            if (!mesh.vertexData.empty() && mesh.timeSamples.size() != mesh.vertexData.size()) throw RuntimeError("Cached Mesh Animation: Time sample count mismatch.");
             for (const auto &vertices : mesh.vertexData)
             {
                 if (vertices.size() != mMeshDesc[mesh.meshID.get()].vertexCount) throw RuntimeError("Cached Mesh Animation: Vertex count mismatch.");
             }
+            if (mesh.vertexData.empty() && mesh.vertexCount != mMeshDesc[mesh.meshID.get()].vertexCount) throw RuntimeError("Cached Mesh Animation: Vertex count mismatch.");
         }
         for (const auto& cache : sceneData.cachedCurves)
         {
@@ -240,7 +254,7 @@ namespace Falcor
         }
 
         // Must be placed after curve data/AABB creation.
-        mpAnimationController->addAnimatedVertexCaches(std::move(sceneData.cachedCurves), std::move(sceneData.cachedMeshes), sceneData.meshStaticData);
+        mpAnimationController->addAnimatedVertexCaches(std::move(sceneData.cachedCurves), std::move(sceneData.cachedMeshes), sceneData.pVertexCacheStore, sceneData.meshStaticData);
 
         // Finalize scene.
         finalize();
@@ -771,6 +785,13 @@ namespace Falcor
             mpSpectralProfilesBuffer->setName("Scene::mpSpectralProfilesBuffer");
         }
 
+        if (!mSpectralProfileData.empty() &&
+            (!mpSpectralProfileDataBuffer || mpSpectralProfileDataBuffer->getElementCount() < mSpectralProfileData.size()))
+        {
+            mpSpectralProfileDataBuffer = Buffer::createStructured(mpDevice.get(), mpSceneBlock[kSpectralProfileDataBufferName], (uint32_t)mSpectralProfileData.size(), Resource::BindFlags::ShaderResource, Buffer::CpuAccess::None, nullptr, false);
+            mpSpectralProfileDataBuffer->setName("Scene::mpSpectralProfileDataBuffer");
+        }
+
         if (!mLights.empty() &&
             (!mpLightsBuffer || mpLightsBuffer->getElementCount() < mLights.size()))
         {
@@ -790,6 +811,7 @@ namespace Falcor
         mpSceneBlock[kMeshBufferName] = mpMeshesBuffer;
         mpSceneBlock[kCurveBufferName] = mpCurvesBuffer;
         mpSceneBlock[kSpectralProfilesBufferName] = mpSpectralProfilesBuffer;
+        mpSceneBlock[kSpectralProfileDataBufferName] = mpSpectralProfileDataBuffer;
         mpSceneBlock[kLightsBufferName] = mpLightsBuffer;
         mpSceneBlock[kGridVolumesBufferName] = mpGridVolumesBuffer;
 
@@ -1505,6 +1527,7 @@ namespace Falcor
 
         for (const auto& pGrid : mGrids)
         {
+            if (!pGrid) continue;
             s.gridVoxelCount += pGrid->getVoxelCount();
             s.gridMemoryInBytes += pGrid->getGridSizeInBytes();
         }
@@ -1558,10 +1581,12 @@ namespace Falcor
 
     Scene::UpdateFlags Scene::updateSpectralProfiles(bool forceUpdate)
     {
-        if (!mpSpectralProfilesBuffer) return UpdateFlags::None;
+        // Spectral profiles are immutable after scene creation, only upload them once.
+        if (!forceUpdate || !mpSpectralProfilesBuffer) return UpdateFlags::None;
 
-        for (std::size_t idx=0; idx<mSpectralProfiles.size(); ++idx)
-            mpSpectralProfilesBuffer->setElement(idx, mSpectralProfiles[idx]);
+        mpSpectralProfilesBuffer->setBlob(mSpectralProfiles.data(), 0, mSpectralProfiles.size() * sizeof(SpectralProfile));
+        if (mpSpectralProfileDataBuffer)
+            mpSpectralProfileDataBuffer->setBlob(mSpectralProfileData.data(), 0, mSpectralProfileData.size() * sizeof(float));
 
         return UpdateFlags::None;
     }
@@ -1635,15 +1660,38 @@ namespace Falcor
         if (!forceUpdate && combinedUpdates == GridVolume::UpdateFlags::None) return UpdateFlags::None;
 
         // Upload grids.
+        auto var = mpSceneBlock["grids"];
         if (forceUpdate)
         {
-            auto var = mpSceneBlock["grids"];
             for (size_t i = 0; i < mGrids.size(); ++i)
             {
-                mGrids[i]->setShaderData(var[i]);
+                if (mGrids[i]) mGrids[i]->setShaderData(var[i]);
+            }
+        }
+
+        // Rebind streamed grids that changed with the grid frame.
+        for (const auto& streamedGrid : mStreamedGrids)
+        {
+            const auto& pGrid = mGridVolumes[streamedGrid.volumeIndex]->getGrid(streamedGrid.slot);
+            auto& pBoundGrid = mGrids[streamedGrid.gridID.get()];
+            if (pGrid && pGrid != pBoundGrid)
+            {
+                pBoundGrid = pGrid;
+                pGrid->setShaderData(var[streamedGrid.gridID.get()]);
             }
         }
 
+        auto getGridID = [&](uint32_t volumeIndex, GridVolume::GridSlot slot)
+        {
+            const auto& pGrid = mGridVolumes[volumeIndex]->getGrid(slot);
+            if (!pGrid) return SdfGridID::Invalid();
+            for (const auto& streamedGrid : mStreamedGrids)
+            {
+                if (streamedGrid.volumeIndex == volumeIndex && streamedGrid.slot == slot) return streamedGrid.gridID;
+            }
+            return mGridIDs.at(pGrid);
+        };
+
         // Upload volumes and clear updates.
         uint32_t volumeIndex = 0;
         for (const auto& pGridVolume : mGridVolumes)
@@ -1652,8 +1700,8 @@ namespace Falcor
             {
                 // Fetch copy of volume data.
                 auto data = pGridVolume->getData();
-                data.densityGrid = (pGridVolume->getDensityGrid() ? mGridIDs.at(pGridVolume->getDensityGrid()) : SdfGridID::Invalid()).getSlang();
-                data.emissionGrid = (pGridVolume->getEmissionGrid() ? mGridIDs.at(pGridVolume->getEmissionGrid()) : SdfGridID::Invalid()).getSlang();
+                data.densityGrid = getGridID(volumeIndex, GridVolume::GridSlot::Density).getSlang();
+                data.emissionGrid = getGridID(volumeIndex, GridVolume::GridSlot::Emission).getSlang();
                 // Merge grid and volume transforms.
                 const auto& densityGrid = pGridVolume->getDensityGrid();
                 if (densityGrid)
@@ -2125,6 +2173,8 @@ namespace Falcor
                 << "  Texture count (compressed): " << s.materials.textureCompressedCount << std::endl
                 << "  Texture texel count: " << s.materials.textureTexelCount << std::endl
                 << "  Texture memory: " << formatByteSize(s.materials.textureMemoryInBytes) << std::endl
+                << "  Texture count (deduplicated by content): " << s.materials.textureDeduplicatedCount << std::endl
+                << "  Texture memory saved by deduplication: " << formatByteSize(s.materials.textureDeduplicatedMemoryInBytes) << std::endl
                 << "  Bytes/texel (average): " << std::fixed << std::setprecision(2) << bytesPerTexel << std::endl
                 << "  Channels/texel (average): " << std::fixed << std::setprecision(2) << channelsPerTexel << std::endl
                 << std::endl;
@@ -4062,6 +4112,8 @@ namespace Falcor
         d["textureTexelCount"] = materials.textureTexelCount;
         d["textureTexelChannelCount"] = materials.textureTexelChannelCount;
         d["textureMemoryInBytes"] = materials.textureMemoryInBytes;
+        d["textureDeduplicatedCount"] = materials.textureDeduplicatedCount;
+        d["textureDeduplicatedMemoryInBytes"] = materials.textureDeduplicatedMemoryInBytes;
 
         // Raytracing stats
         d["blasGroupCount"] = blasGroupCount;
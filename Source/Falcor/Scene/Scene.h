@@ -313,6 +313,7 @@ namespace Falcor
             float cameraSpeed = 1.f;                                ///< Camera speed.
             std::vector<Light::SharedPtr> lights;                   ///< List of light sources.
             std::vector<SpectralProfile> spectralProfiles;          ///< Spectrum profiles
+            std::vector<float> spectralProfileData;                 ///< Packed pdf/icdf samples of all spectrum profiles.
             MaterialSystem::SharedPtr pMaterials;                   ///< Material system. This holds data and resources for all materials.
             std::vector<GridVolume::SharedPtr> gridVolumes;         ///< List of grid volumes.
             std::vector<Grid::SharedPtr> grids;                     ///< List of grids.
@@ -349,6 +350,7 @@ namespace Falcor
             std::vector<uint32_t> curveIndexData;                   ///< Vertex indices for all curves in 32-bit.
             std::vector<StaticCurveVertexData> curveStaticData;     ///< Vertex attributes for all curves.
             std::vector<CachedCurve> cachedCurves;                  ///< Vertex cache for dynamic (vertex animated) curves.
+            VertexCacheStore::SharedPtr pVertexCacheStore;          ///< Store holding the keyframes of the cached meshes and curves.
 
             // SDF grid data
             std::vector<SDFGrid::SharedPtr> sdfGrids;               ///< List of SDF grids.
@@ -1106,6 +1108,10 @@ namespace Falcor
 
         const auto& getSpectralProfile(std::size_t idx) const { return mSpectralProfiles[idx]; }
 
+        /** Get the packed pdf/icdf samples of all spectral profiles. Profiles reference their samples by offset.
+        */
+        const std::vector<float>& getSpectralProfileData() const { return mSpectralProfileData; }
+
     private:
         friend class AnimationController;
         friend class AnimatedVertexCache;
@@ -1301,10 +1307,18 @@ namespace Falcor
         // Lights
         std::vector<Light::SharedPtr> mLights;                      ///< All analytic lights. Note that not all may be active.
         std::vector<SpectralProfile> mSpectralProfiles;             ///< Spectrum profiles
+        std::vector<float> mSpectralProfileData;                    ///< Packed pdf/icdf samples of all spectrum profiles.
         std::vector<Light::SharedPtr> mActiveLights;                ///< All active analytic lights.
         std::vector<GridVolume::SharedPtr> mGridVolumes;            ///< All loaded grid volumes.
         std::vector<Grid::SharedPtr> mGrids;                        ///< All loaded grids.
         std::unordered_map<Grid::SharedPtr, SdfGridID> mGridIDs;    ///< Lookup table for grid IDs.
+        struct StreamedGrid
+        {
+            uint32_t volumeIndex;
+            GridVolume::GridSlot slot;
+            SdfGridID gridID;
+        };
+        std::vector<StreamedGrid> mStreamedGrids;                   ///< Streamed grid slots. Each uses a fixed grid ID, the grid bound to it follows the grid frame.
         LightCollection::SharedPtr mpLightCollection;               ///< Class for managing emissive geometry. This is created lazily upon first use.
         EnvMap::SharedPtr mpEnvMap;                                 ///< Environment map or nullptr if not loaded.
         bool mEnvMapChanged = false;                                ///< Flag indicating that the environment map has changed since last frame.
@@ -1334,6 +1348,7 @@ namespace Falcor
         Buffer::SharedPtr mpCustomPrimitivesBuffer;
         Buffer::SharedPtr mpLightsBuffer;
         Buffer::SharedPtr mpSpectralProfilesBuffer;
+        Buffer::SharedPtr mpSpectralProfileDataBuffer;
         Buffer::SharedPtr mpGridVolumesBuffer;
         ParameterBlock::SharedPtr mpSceneBlock;
 
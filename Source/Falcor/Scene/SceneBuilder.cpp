@@ -30,18 +30,24 @@
 #include "SceneCache.h"
 #include "Importer.h"
 #include "Curves/CurveConfig.h"
+#include "Core/Platform/OS.h"
 #include "Material/StandardMaterial.h"
 #include "Rendering/Materials/PLT/PLTDiffuseMaterial.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 #include "Utils/Math/Common.h"
+#include "Utils/Geometry/MeshOptimizer.h"
 #include "Utils/Image/TextureAnalyzer.h"
+#include "Utils/Timing/Profiler.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/Color/SpectrumUtils.h"
+#include "Utils/Color/SpectralTableLibrary.h"
 #include <mikktspace.h>
 #include <filesystem>
 #include <cmath>
+#include <cstring>
 #include <random>
 
 namespace Falcor
@@ -179,6 +185,35 @@ namespace Falcor
             return true;
         }
 
+        /** Hash the vertex attributes that compareVertices() requires to match exactly.
+            Attributes compared with a threshold are excluded so that vertices that compare equal always hash to the same value.
+        */
+        uint64_t hashVertex(const SceneBuilder::Mesh::Vertex& v)
+        {
+            uint64_t hash = 0xcbf29ce484222325ull;
+            auto combine = [&hash](uint32_t value) { hash = (hash ^ value) * 0x100000001b3ull; };
+            auto combineFloat = [&combine](float f)
+            {
+                if (f == 0.f) f = 0.f; // Map -0 to +0 as they compare equal.
+                uint32_t bits;
+                std::memcpy(&bits, &f, sizeof(bits));
+                combine(bits);
+            };
+
+            combineFloat(v.position.x);
+            combineFloat(v.position.y);
+            combineFloat(v.position.z);
+            combineFloat(v.tangent.w);
+            combineFloat(v.curveRadius);
+            for (uint32_t i = 0; i < 4; i++) combine(v.boneIDs[i]);
+
+            // Finalize so that the low bits used for the table lookup are well mixed.
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
         std::vector<uint32_t> compact16BitIndices(const std::vector<uint32_t>& indices)
         {
             if (indices.empty()) return {};
@@ -195,7 +230,7 @@ namespace Falcor
 
         SceneCache::Key computeSceneCacheKey(const std::filesystem::path& path, SceneBuilder::Flags buildFlags)
         {
-            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache));
+            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache | SceneBuilder::Flags::HashCacheDependencies));
             SHA1 sha1;
             auto pathStr = path.string();
             sha1.update(pathStr.data(), pathStr.size());
@@ -212,6 +247,8 @@ namespace Falcor
     {
         mpFence = GpuFence::create(mpDevice.get());
         mSceneData.pMaterials = MaterialSystem::create(mpDevice);
+        if (is_set(mFlags, Flags::DeduplicateTextures)) mSceneData.pMaterials->getTextureManager()->setDeduplicateByContent(true);
+        if (is_set(mFlags, Flags::UseTextureCache)) mSceneData.pMaterials->getTextureManager()->setTextureCache(TextureCache::create());
     }
 
     SceneBuilder::SharedPtr SceneBuilder::create(std::shared_ptr<Device> pDevice, const Settings& settings, Flags flags)
@@ -242,7 +279,8 @@ namespace Falcor
         {
             try
             {
-                pBuilder->mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, pBuilder->mSceneCacheKey));
+                auto pTextureCache = pBuilder->mSceneData.pMaterials->getTextureManager()->getTextureCache();
+                pBuilder->mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, pBuilder->mSceneCacheKey, pTextureCache));
                 return pBuilder;
             }
             catch (const std::exception& e)
@@ -257,6 +295,7 @@ namespace Falcor
 
     void SceneBuilder::import(const std::filesystem::path& path, const Dictionary& dict)
     {
+        FALCOR_PROFILE_CPU("SceneBuilder::import");
         logInfo("Importing scene: {}", path);
         std::filesystem::path fullPath;
         if (!findFileInDataDirectories(path, fullPath))
@@ -265,6 +304,7 @@ namespace Falcor
         }
 
         mSceneData.path = fullPath;
+        addDependency(fullPath);
         if (auto importer = Importer::create(getExtensionFromPath(fullPath)))
         {
             importer->importScene(fullPath, *this, dict);
@@ -275,10 +315,27 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::addDependency(const std::filesystem::path& path)
+    {
+        if (!mWriteSceneCache) return;
+
+        std::filesystem::path fullPath;
+        if (!findFileInDataDirectories(path, fullPath))
+        {
+            logWarning("Scene dependency '{}' not found. Changes to it will not invalidate the scene cache.", path);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mDependencyMutex);
+        mDependencies.insert(std::filesystem::canonical(fullPath));
+    }
+
     Scene::SharedPtr SceneBuilder::getScene()
     {
         if (mpScene) return mpScene;
 
+        FALCOR_PROFILE_CPU("SceneBuilder::getScene");
+
         // Finish loading textures. This blocks until all textures are loaded and assigned.
         mpMaterialTextureLoader.reset();
 
@@ -307,32 +364,43 @@ namespace Falcor
         prepareMeshes();
         removeUnusedMeshes();
         flattenStaticMeshInstances();
+        timeReport.measure("Preparing meshes");
+
         pretransformStaticMeshes();
         unifyTriangleWinding();
+        timeReport.measure("Pre-transforming static meshes");
+
         optimizeSceneGraph();
+        timeReport.measure("Optimizing scene graph");
+
         calculateMeshBoundingBoxes();
         createMeshGroups();
         optimizeGeometry();
         sortMeshes();
+        timeReport.measure("Creating mesh groups");
+
         createGlobalBuffers();
         createCurveGlobalBuffers();
+        timeReport.measure("Creating global buffers");
+
         collectVolumeGrids();
         removeDuplicateSDFGrids();
-
-        timeReport.measure("Post processing geometry");
+        timeReport.measure("Collecting grids");
 
         optimizeMaterials();
         removeDuplicateMaterials();
-        quantizeTexCoords();
-
         timeReport.measure("Optimizing materials");
 
+        quantizeTexCoords();
+        timeReport.measure("Quantizing texture coordinates");
+
         // Prepare scene resources.
         createSceneGraph();
         createMeshData();
         createMeshBoundingBoxes();
         createCurveData();
         calculateCurveBoundingBoxes();
+        timeReport.measure("Creating mesh and curve data");
 
         // Create instance data.
         uint32_t tlasInstanceIndex = 0;
@@ -340,13 +408,36 @@ namespace Falcor
         createCurveInstanceData(tlasInstanceIndex);
         // Adjust instance indices of SDF grid instances.
         for (auto& sdfInstanceData : mSceneData.sdfGridInstances) sdfInstanceData.instanceIndex = tlasInstanceIndex++;
+        timeReport.measure("Creating instance data");
 
         mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
 
+        // Finish the vertex cache store. The keyframes are streamed from it at runtime.
+        if (mpVertexCacheWriter)
+        {
+            mSceneData.pVertexCacheStore = mpVertexCacheWriter->finalize(true);
+            mpVertexCacheWriter.reset();
+        }
+
         // Write scene cache if requested.
         if (mWriteSceneCache)
         {
-            SceneCache::writeCache(mSceneData, mSceneCacheKey);
+            // Register textures that importers assigned to materials directly instead of using loadMaterialTexture().
+            for (uint32_t i = 0; i < mSceneData.pMaterials->getMaterialCount(); ++i)
+            {
+                const auto& pMaterial = mSceneData.pMaterials->getMaterial(MaterialID(i));
+                for (uint32_t slot = 0; slot < (uint32_t)Material::TextureSlot::Count; ++slot)
+                {
+                    auto pTexture = pMaterial->getTexture((Material::TextureSlot)slot);
+                    if (pTexture && !pTexture->getSourcePath().empty()) addDependency(pTexture->getSourcePath());
+                }
+            }
+
+            std::vector<std::filesystem::path> paths(mDependencies.begin(), mDependencies.end());
+            SceneCache::DependencyList dependencies(paths.size());
+            bool computeHash = is_set(mFlags, Flags::HashCacheDependencies);
+            Threading::parallelFor(0, paths.size(), [&](size_t i) { dependencies[i] = SceneCache::createDependency(paths[i], computeHash); });
+            SceneCache::writeCache(mSceneData, mSceneCacheKey, dependencies);
             timeReport.measure("Writing cache");
         }
 
@@ -402,11 +493,14 @@ namespace Falcor
 
     SceneBuilder::ProcessedMesh SceneBuilder::processMesh(const Mesh& mesh_, MeshAttributeIndices* pAttributeIndices) const
     {
+        FALCOR_PROFILE_CPU("SceneBuilder::processMesh");
+
         // This function preprocesses a mesh into the final runtime representation.
         // Note the function needs to be thread safe. The following steps are performed:
         //  - Error checking
         //  - Compute tangent space if needed
         //  - Merge identical vertices, compute new indices (optional)
+        //  - Reorder triangles and vertices for cache locality (optional)
         //  - Validate final vertex data
         //  - Compact vertices/indices into runtime format
 
@@ -500,7 +594,51 @@ namespace Falcor
             pAttributeIndices->reserve(mesh.vertexCount);
         }
 
-        if (mesh.mergeDuplicateVertices)
+        // The optimized layout is only applied to meshes that allow merging vertices, as the other meshes rely on the original vertex order.
+        const bool optimizeLayout = mesh.mergeDuplicateVertices && is_set(mFlags, Flags::OptimizeMeshLayout);
+
+        if (optimizeLayout && !pAttributeIndices)
+        {
+            // Merge identical vertices using a hash table keyed on the attributes that need to match exactly.
+            // Unlike the per-index lists below, this also merges vertices that were exported with separate position indices.
+            // Vertices with equal keys are distinguished using compareVertices() with linear probing.
+            // This path is not used when attribute indices are requested, as these are used to look up per-keyframe data
+            // where vertices with separate position indices may diverge.
+            vertices.reserve(mesh.vertexCount);
+
+            size_t tableSize = 16;
+            while (tableSize < 2 * (size_t)mesh.indexCount) tableSize *= 2;
+            const size_t tableMask = tableSize - 1;
+            std::vector<uint32_t> table(tableSize, invalidIndex);
+
+            for (uint32_t face = 0; face < mesh.faceCount; face++)
+            {
+                for (uint32_t vert = 0; vert < 3; vert++)
+                {
+                    const Mesh::Vertex v = mesh.getVertex(face, vert);
+
+                    size_t slot = hashVertex(v) & tableMask;
+                    uint32_t index = table[slot];
+                    while (index != invalidIndex && !compareVertices(v, vertices[index].first))
+                    {
+                        slot = (slot + 1) & tableMask;
+                        index = table[slot];
+                    }
+
+                    // Insert new vertex if we couldn't find it.
+                    if (index == invalidIndex)
+                    {
+                        FALCOR_ASSERT(vertices.size() < std::numeric_limits<uint32_t>::max());
+                        index = (uint32_t)vertices.size();
+                        vertices.push_back({ v, invalidIndex });
+                        table[slot] = index;
+                    }
+
+                    indices[face * 3 + vert] = index;
+                }
+            }
+        }
+        else if (mesh.mergeDuplicateVertices)
         {
             vertices.reserve(mesh.vertexCount);
 
@@ -585,6 +723,26 @@ namespace Falcor
             logDebug("Mesh with name '{}' had original vertex count {}, new vertex count {}.", mesh.name, mesh.vertexCount, vertices.size());
         }
 
+        // Reorder triangles for post-transform vertex cache locality, then reorder vertices by first use for vertex fetch locality.
+        // This improves rasterization throughput and also tends to produce spatially coherent primitive ranges for BLAS builds.
+        if (optimizeLayout)
+        {
+            const uint32_t uniqueVertexCount = (uint32_t)vertices.size();
+            MeshOptimizer::optimizeVertexCache(indices, uniqueVertexCount);
+            std::vector<uint32_t> remap = MeshOptimizer::optimizeVertexFetch(indices, uniqueVertexCount);
+
+            std::vector<std::pair<Mesh::Vertex, uint32_t>> remappedVertices(uniqueVertexCount);
+            for (uint32_t i = 0; i < uniqueVertexCount; i++) remappedVertices[remap[i]] = vertices[i];
+            vertices = std::move(remappedVertices);
+
+            if (pAttributeIndices)
+            {
+                MeshAttributeIndices remappedAttributeIndices(uniqueVertexCount);
+                for (uint32_t i = 0; i < uniqueVertexCount; i++) remappedAttributeIndices[remap[i]] = (*pAttributeIndices)[i];
+                *pAttributeIndices = std::move(remappedAttributeIndices);
+            }
+        }
+
         // Validate vertex data to check for invalid numbers and missing tangent frame.
         size_t invalidCount = 0;
         size_t zeroCount = 0;
@@ -705,6 +863,8 @@ namespace Falcor
     void SceneBuilder::setCachedMeshes(std::vector<CachedMesh>&& cachedMeshes)
     {
         mSceneData.cachedMeshes = std::move(cachedMeshes);
+        auto& writer = getVertexCacheWriter();
+        for (auto& cache : mSceneData.cachedMeshes) writer.addCachedMesh(cache);
     }
 
     void SceneBuilder::addCustomPrimitive(uint32_t userID, const AABB& aabb)
@@ -811,6 +971,13 @@ namespace Falcor
         return CurveID(mCurves.size() - 1);
     }
 
+    void SceneBuilder::setCachedCurves(std::vector<CachedCurve>&& cachedCurves)
+    {
+        mSceneData.cachedCurves = std::move(cachedCurves);
+        auto& writer = getVertexCacheWriter();
+        for (auto& cache : mSceneData.cachedCurves) writer.addCachedCurve(cache);
+    }
+
     // SDFs
 
     SdfDescID SceneBuilder::addSDFGrid(const SDFGrid::SharedPtr& pSDFGrid, const Material::SharedPtr& pMaterial)
@@ -851,10 +1018,12 @@ namespace Falcor
             mpMaterialTextureLoader.reset(new MaterialTextureLoader(mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
         }
         mpMaterialTextureLoader->loadTexture(pMaterial, slot, path);
+        addDependency(path);
     }
     void SceneBuilder::loadMaterialTexture(const StandardMaterialPLTWrapper::SharedPtr& mat, Material::TextureSlot slot, const std::filesystem::path& path)
     {
         mat->addTexture(slot, path);
+        addDependency(path);
     }
 
     void SceneBuilder::waitForMaterialTextureLoading()
@@ -908,61 +1077,151 @@ namespace Falcor
         return LightID(mSceneData.lights.size() - 1);
     }
 
-    inline SpectralProfile genSpectralProfile(const SampledSpectrum<float> &ss, bool computeICdf)
+    namespace
     {
-        SpectralProfile sp;
-        sp.rgb = SpectrumUtils::toRGB_D65(ss);
-        sp.intensity = 1.f;
+        /** Spectral profile with its samples, before packing into the scene's profile data.
+        */
+        struct SpectralProfileSamples
+        {
+            SpectralProfile header;
+            std::vector<float> pdf;
+            std::vector<float> icdf;
+        };
 
-        sp.minWavelength = std::max(ss.getWavelengthRange().x,SpectrumConstants::minWavelength);
-        sp.maxWavelength = std::min(ss.getWavelengthRange().y,SpectrumConstants::maxWavelength);
-        sp.bins = std::min<uint32_t>(SpectralProfile::kMaxBins,
-                                     uint32_t(ss.size() * (sp.maxWavelength-sp.minWavelength) / (ss.getWavelengthRange().y - ss.getWavelengthRange().x) + .5f));
+        /** Find the smallest number of bins for which linear interpolation between the samples reproduces
+            the spectrum sampled with 'bins' bins to within a small tolerance. Flat and smooth spectra need few bins.
+        */
+        uint32_t reduceSpectralProfileBins(const SampledSpectrum<float>& ss, float minWavelength, float maxWavelength, uint32_t bins)
+        {
+            const float kTolerance = 1e-3f;
+            if (bins <= 2) return bins;
 
-        std::memset(sp.pdf, 0, sizeof(sp.pdf));
-        std::memset(sp.icdf, 0, sizeof(sp.icdf));
+            std::vector<float> values(bins);
+            float maxValue = 0.f;
+            for (uint32_t i = 0; i < bins; ++i)
+            {
+                values[i] = ss.eval(lerp(minWavelength, maxWavelength, i / float(bins - 1)));
+                maxValue = std::max(maxValue, std::abs(values[i]));
+            }
 
-        if (sp.bins==0) return sp;
+            // Candidate bin counts 2, 3, 5, 9, 17, ... share their sample positions with all larger candidates.
+            std::vector<float> reduced;
+            for (uint32_t n = 2; n < bins; n = 2 * n - 1)
+            {
+                reduced.resize(n);
+                for (uint32_t j = 0; j < n; ++j) reduced[j] = ss.eval(lerp(minWavelength, maxWavelength, j / float(n - 1)));
 
-        const float r = sp.bins>1 ? 1.f/float(sp.bins-1) : 1.f;
+                bool accurate = true;
+                for (uint32_t i = 0; i < bins && accurate; ++i)
+                {
+                    const float x = i * float(n - 1) / float(bins - 1);
+                    const uint32_t j = std::min(n - 2, uint32_t(x));
+                    const float value = lerp(reduced[j], reduced[j + 1], x - j);
+                    accurate = std::abs(value - values[i]) <= kTolerance * maxValue;
+                }
+                if (accurate) return n;
+            }
+            return bins;
+        }
 
-        // PDF
-        float sum = .0f;
-        for (std::size_t i=0;i<sp.bins;++i)
+        SpectralProfileSamples genSpectralProfile(const SampledSpectrum<float>& ss, bool computeICdf)
         {
-            sp.pdf[i] = ss.eval(lerp(sp.minWavelength, sp.maxWavelength, i*r));
-            sum += sp.pdf[i];
-        }
+            SpectralProfileSamples samples;
+            SpectralProfile& sp = samples.header;
+            sp.rgb = SpectrumUtils::toRGB_D65(ss);
+            sp.intensity = 1.f;
 
-        if (sum < FLT_EPSILON || !computeICdf) return sp;
+            sp.minWavelength = std::max(ss.getWavelengthRange().x,SpectrumConstants::minWavelength);
+            sp.maxWavelength = std::min(ss.getWavelengthRange().y,SpectrumConstants::maxWavelength);
+            sp.bins = std::min<uint32_t>(SpectralProfile::kMaxBins,
+                                         uint32_t(ss.size() * (sp.maxWavelength-sp.minWavelength) / (ss.getWavelengthRange().y - ss.getWavelengthRange().x) + .5f));
 
-        for (std::size_t i=0;i<sp.bins;++i)
-            sp.pdf[i] /= sum;
-        sp.intensity = sum;
+            // Profiles without an inverse CDF are only evaluated pointwise and can use fewer bins without changing their values.
+            // The intensity of importance sampled profiles depends on the bin count, these are kept at full resolution.
+            if (!computeICdf) sp.bins = reduceSpectralProfileBins(ss, sp.minWavelength, sp.maxWavelength, sp.bins);
 
-        // Inverse CDF
-        float cdfa = .0f, cdfb=sp.pdf[0];
-        for (std::size_t pdfi=0,icdfi=0; icdfi<sp.bins; ++icdfi)
-        {
-            const float cdf = icdfi*r;
-            while (cdf>=cdfb && pdfi+1<sp.bins)
+            if (sp.bins==0) return samples;
+
+            const float r = sp.bins>1 ? 1.f/float(sp.bins-1) : 1.f;
+
+            // PDF
+            auto& pdf = samples.pdf;
+            pdf.resize(sp.bins);
+            float sum = .0f;
+            for (std::size_t i=0;i<sp.bins;++i)
+            {
+                pdf[i] = ss.eval(lerp(sp.minWavelength, sp.maxWavelength, i*r));
+                sum += pdf[i];
+            }
+
+            if (!computeICdf) return samples;
+
+            // Inverse CDF
+            auto& icdf = samples.icdf;
+            icdf.resize(sp.bins, 0.f);
+            if (sum < FLT_EPSILON) return samples;
+
+            for (std::size_t i=0;i<sp.bins;++i)
+                pdf[i] /= sum;
+            sp.intensity = sum;
+
+            float cdfa = .0f, cdfb=pdf[0];
+            for (std::size_t pdfi=0,icdfi=0; icdfi<sp.bins; ++icdfi)
             {
-                cdfa=cdfb;
-                ++pdfi;
-                cdfb+=sp.pdf[pdfi];
+                const float cdf = icdfi*r;
+                while (cdf>=cdfb && pdfi+1<sp.bins)
+                {
+                    cdfa=cdfb;
+                    ++pdfi;
+                    cdfb+=pdf[pdfi];
+                }
+
+                const float l = std::min(1.f, (cdf-cdfa) / (cdfb-cdfa));
+                icdf[icdfi] = lerp((float)std::max<uint32_t>(1,pdfi)-1.f, (float)pdfi, l) * r;
             }
 
-            const float l = std::min(1.f, (cdf-cdfa) / (cdfb-cdfa));
-            sp.icdf[icdfi] = lerp((float)std::max<uint32_t>(1,pdfi)-1.f, (float)pdfi, l) * r;
+            return samples;
         }
 
-        return sp;
+        SHA1::MD hashSpectralProfile(const SpectralProfileSamples& samples)
+        {
+            const auto& sp = samples.header;
+            SHA1 sha1;
+            sha1.update(&sp.rgb, sizeof(sp.rgb));
+            sha1.update(sp.intensity);
+            sha1.update(sp.bins);
+            sha1.update(sp.minWavelength);
+            sha1.update(sp.maxWavelength);
+            sha1.update(samples.pdf.data(), samples.pdf.size() * sizeof(float));
+            sha1.update(!samples.icdf.empty());
+            sha1.update(samples.icdf.data(), samples.icdf.size() * sizeof(float));
+            return sha1.finalize();
+        }
     }
 
     SpectralProfileID SceneBuilder::addSpectralProfile(SampledSpectrum<float> spectralProfile, bool computeICdf)
     {
-        mSceneData.spectralProfiles.emplace_back(genSpectralProfile(std::move(spectralProfile), computeICdf));
-        return SpectralProfileID(mSceneData.spectralProfiles.size()-1);
+        auto samples = genSpectralProfile(spectralProfile, computeICdf);
+
+        // Share identical profiles.
+        auto hash = hashSpectralProfile(samples);
+        if (auto it = mSpectralProfileIDs.find(hash); it != mSpectralProfileIDs.end()) return it->second;
+
+        // Pack samples into the profile data.
+        auto& data = mSceneData.spectralProfileData;
+        SpectralProfile sp = samples.header;
+        sp.pdfOffset = (uint32_t)data.size();
+        data.insert(data.end(), samples.pdf.begin(), samples.pdf.end());
+        if (!samples.icdf.empty())
+        {
+            sp.icdfOffset = (uint32_t)data.size();
+            data.insert(data.end(), samples.icdf.begin(), samples.icdf.end());
+        }
+
+        mSceneData.spectralProfiles.push_back(sp);
+        SpectralProfileID id(mSceneData.spectralProfiles.size()-1);
+        mSpectralProfileIDs[hash] = id;
+        return id;
     }
     SpectralProfileID SceneBuilder::addSpectralProfileRGB(float3 rgb)
     {
@@ -971,36 +1230,48 @@ namespace Falcor
 
     std::pair<SpectralProfileID, SpectralProfileID> SceneBuilder::addSpectralProfileFromMaterial(const std::string& name)
     {
+        // Materials referencing the same spectra share the profiles, avoid parsing the files again.
+        if (auto it = mMaterialSpectralProfiles.find(name); it != mMaterialSpectralProfiles.end()) return it->second;
+
         SampledSpectrum<float> n(1.f), k(.0f);
         if (name != "none")
         {
-            n = SampledSpectrum<float>{ PiecewiseLinearSpectrum::fromFile(std::filesystem::path(_PROJECT_DIR_) / "../Tables/ior/" / (name + ".eta.spd")) };
-            k = SampledSpectrum<float>{ PiecewiseLinearSpectrum::fromFile(std::filesystem::path(_PROJECT_DIR_) / "../Tables/ior" / (name + ".k.spd")) };
+            // Shipped tables are read from the precompiled archive if available, the text files are the fallback.
+            const auto& tables = SpectralTableLibrary::getDefault();
+            std::filesystem::path etaPath, kPath;
+            n = tables.load("ior/" + name + ".eta", etaPath);
+            k = tables.load("ior/" + name + ".k", kPath);
+            addDependency(etaPath);
+            addDependency(kPath);
         }
 
-        return std::make_pair(addSpectralProfile(n, false), addSpectralProfile(k, false));
+        auto ior = std::make_pair(addSpectralProfile(n, false), addSpectralProfile(k, false));
+        mMaterialSpectralProfiles[name] = ior;
+        return ior;
     }
     SpectralProfileID SceneBuilder::addSpectralProfileForEmitterType(const std::string& name, float scale)
     {
-        const auto dir = std::filesystem::path(_PROJECT_DIR_) / "../Tables/emission/";
-        for (auto const& file : std::filesystem::directory_iterator{ dir })
-        {
-            if (file.is_regular_file() && file.path().filename().string() == name + ".spd")
-            {
-                auto spectrum = PiecewiseLinearSpectrum::fromFile(file.path());
-                spectrum.scale(scale);
-                auto profile = SampledSpectrum<float>{ spectrum };
-                //profile.normalize();
-                return addSpectralProfile(std::move(profile));
-            }
-        }
+        checkArgument(scale >= 0.f, "'scale' ({}) needs to be positive.", scale);
 
-        throw RuntimeError("Emission profile '{}' not found.", name);
+        std::filesystem::path path;
+        auto profile = SpectralTableLibrary::getDefault().load("emission/" + name, path);
+        addDependency(path);
+        profile.scale(scale);
+        return addSpectralProfile(std::move(profile));
     }
 
     void SceneBuilder::loadLightProfile(const std::string& filename, bool normalize)
     {
         mSceneData.pLightProfile = LightProfile::createFromIesProfile(mpDevice, std::filesystem::path(filename), normalize);
+        addDependency(filename);
+    }
+
+    // Environment map
+
+    void SceneBuilder::setEnvMap(EnvMap::SharedPtr pEnvMap)
+    {
+        mSceneData.pEnvMap = pEnvMap;
+        if (pEnvMap && !pEnvMap->getPath().empty()) addDependency(pEnvMap->getPath());
     }
 
     // Cameras
@@ -1652,7 +1923,9 @@ namespace Falcor
         NodeID identityNodeID = addNode(Node{ "Identity", rmcv::identity<rmcv::mat4>(), rmcv::identity<rmcv::mat4>() });
         auto& identityNode = mSceneGraph[identityNodeID.get()];
 
-        size_t transformedMeshCount = 0;
+        // The scene graph is updated serially. The meshes that need their vertices transformed are collected
+        // and processed in parallel afterwards, as that is where the bulk of the work is.
+        std::vector<std::pair<MeshID, rmcv::mat4>> transformedMeshes;
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
             auto& mesh = mMeshes[meshID.get()];
@@ -1684,25 +1957,7 @@ namespace Falcor
             // Transform vertices to world space if not already identity transform.
             if (transform != rmcv::identity<rmcv::mat4>())
             {
-                FALCOR_ASSERT(!mesh.staticData.empty());
-                FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
-
-                rmcv::mat3 invTranspose3x3 = (rmcv::mat3)rmcv::transpose(rmcv::inverse(transform));
-                rmcv::mat3 transform3x3 = (rmcv::mat3)transform;
-
-                for (auto& v : mesh.staticData)
-                {
-                    float4 p = transform * float4(v.position, 1.f);
-                    v.position = p.xyz;
-                    v.normal = glm::normalize(invTranspose3x3 * v.normal);
-                    v.tangent.xyz = glm::normalize(transform3x3 * float3(v.tangent.xyz)); // TODO: This cast shouldn't be necessary
-                    // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
-                    // Leaving that out for now for consistency with the shader code that needs the same fix.
-
-                    v.curveRadius = glm::length(transform3x3 * float3(v.curveRadius, 0.f, 0.f));
-                }
-
-                transformedMeshCount++;
+                transformedMeshes.emplace_back(meshID, transform);
             }
 
             // Unlink mesh from its previous transform node.
@@ -1719,7 +1974,30 @@ namespace Falcor
             mesh.instances.insert(identityNodeID);
         }
 
-        if (transformedMeshCount > 0) logInfo("Pre-transformed {} static meshes to world space.", transformedMeshCount);
+        Threading::parallelFor(0, transformedMeshes.size(), [&](size_t i)
+        {
+            const auto& [meshID, transform] = transformedMeshes[i];
+            auto& mesh = mMeshes[meshID.get()];
+            FALCOR_ASSERT(!mesh.staticData.empty());
+            FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
+
+            rmcv::mat3 invTranspose3x3 = (rmcv::mat3)rmcv::transpose(rmcv::inverse(transform));
+            rmcv::mat3 transform3x3 = (rmcv::mat3)transform;
+
+            for (auto& v : mesh.staticData)
+            {
+                float4 p = transform * float4(v.position, 1.f);
+                v.position = p.xyz;
+                v.normal = glm::normalize(invTranspose3x3 * v.normal);
+                v.tangent.xyz = glm::normalize(transform3x3 * float3(v.tangent.xyz)); // TODO: This cast shouldn't be necessary
+                // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
+                // Leaving that out for now for consistency with the shader code that needs the same fix.
+
+                v.curveRadius = glm::length(transform3x3 * float3(v.curveRadius, 0.f, 0.f));
+            }
+        });
+
+        if (!transformedMeshes.empty()) logInfo("Pre-transformed {} static meshes to world space.", transformedMeshes.size());
     }
 
     void SceneBuilder::flipTriangleWinding(MeshSpec& mesh)
@@ -1787,27 +2065,33 @@ namespace Falcor
         // Note that this pass needs to run *after* pre-transformation of static meshes to world space,
         // as those transforms may flip the winding.
 
-        size_t flippedMeshCount = 0;
-        for (uint32_t meshID = 0; meshID < (uint32_t)mMeshes.size(); meshID++)
-        {
-            auto& mesh = mMeshes[meshID];
+        size_t flippedMeshCount = Threading::parallelReduce(size_t(0), mMeshes.size(), size_t(0),
+            [&](size_t begin, size_t end, size_t count)
+            {
+                for (size_t meshID = begin; meshID < end; meshID++)
+                {
+                    auto& mesh = mMeshes[meshID];
 
-            // Skip meshes that are already front face counter-clockwise.
-            if (mesh.isFrontFaceCW == false) continue;
+                    // Skip meshes that are already front face counter-clockwise.
+                    if (mesh.isFrontFaceCW == false) continue;
 
-            flipTriangleWinding(mesh);
-            FALCOR_ASSERT(!mesh.isFrontFaceCW);
+                    flipTriangleWinding(mesh);
+                    FALCOR_ASSERT(!mesh.isFrontFaceCW);
 
-            flippedMeshCount++;
-        }
+                    count++;
+                }
+                return count;
+            },
+            std::plus<size_t>());
 
         if (flippedMeshCount > 0) logInfo("Flipped triangle winding for {} out of {} meshes.", flippedMeshCount, mMeshes.size());
     }
 
     void SceneBuilder::calculateMeshBoundingBoxes()
     {
-        for (auto& mesh : mMeshes)
+        Threading::parallelFor(0, mMeshes.size(), [&](size_t i)
         {
+            auto& mesh = mMeshes[i];
             FALCOR_ASSERT(!mesh.staticData.empty());
             FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
 
@@ -1818,7 +2102,7 @@ namespace Falcor
             }
 
             mesh.boundingBox = meshBB;
-        }
+        });
     }
 
     void SceneBuilder::createMeshGroups()
@@ -2391,16 +2675,22 @@ namespace Falcor
 
         const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
 
-        // Count total number of vertex and index data elements.
+        // Compute the offsets of each mesh in the global buffers (exclusive prefix sum over the mesh data sizes).
         size_t totalIndexDataCount = 0;
         size_t totalStaticVertexCount = 0;
         size_t totalSkinningVertexCount = 0;
 
-        for (const auto& mesh : mMeshes)
+        for (auto& mesh : mMeshes)
         {
-            totalIndexDataCount += mesh.indexData.size();
+            // The offsets are range checked below before any data is copied.
+            mesh.staticVertexOffset = (uint32_t)totalStaticVertexCount;
+            mesh.skinningVertexOffset = (uint32_t)totalSkinningVertexCount;
+            mesh.prevVertexOffset = mesh.skinningVertexOffset;
+            if (isIndexed) mesh.indexOffset = (uint32_t)totalIndexDataCount;
+
+            totalIndexDataCount += isIndexed ? mesh.indexData.size() : 0;
             totalStaticVertexCount += mesh.staticData.size();
-            totalSkinningVertexCount += mesh.skinningData.size();
+            totalSkinningVertexCount += mesh.isSkinned() ? mesh.skinningData.size() : 0;
             mSceneData.prevVertexCount += mesh.prevVertexCount;
         }
 
@@ -2412,31 +2702,29 @@ namespace Falcor
             throw RuntimeError("Trying to build a scene that exceeds supported mesh data size.");
         }
 
-        mSceneData.meshIndexData.reserve(totalIndexDataCount);
-        mSceneData.meshStaticData.reserve(totalStaticVertexCount);
-        mSceneData.meshSkinningData.reserve(totalSkinningVertexCount);
+        mSceneData.meshIndexData.resize(totalIndexDataCount);
+        mSceneData.meshStaticData.resize(totalStaticVertexCount);
+        mSceneData.meshSkinningData.resize(totalSkinningVertexCount);
 
         // Copy all vertex and index data into the global buffers.
-        for (auto& mesh : mMeshes)
+        // Each mesh writes to its own disjoint range so the meshes are processed in parallel.
+        Threading::parallelFor(0, mMeshes.size(), [&](size_t meshIdx)
         {
-            mesh.staticVertexOffset = (uint32_t)mSceneData.meshStaticData.size();
-            mesh.skinningVertexOffset = (uint32_t)mSceneData.meshSkinningData.size();
-            mesh.prevVertexOffset = mesh.skinningVertexOffset;
+            auto& mesh = mMeshes[meshIdx];
 
-            // Insert the static vertex data in the global array.
+            // Copy the static vertex data to the global array.
             // The vertices are automatically converted to their packed format in this step.
-            mSceneData.meshStaticData.insert(mSceneData.meshStaticData.end(), mesh.staticData.begin(), mesh.staticData.end());
+            std::copy(mesh.staticData.begin(), mesh.staticData.end(), mSceneData.meshStaticData.begin() + mesh.staticVertexOffset);
 
             if (isIndexed)
             {
-                mesh.indexOffset = (uint32_t)mSceneData.meshIndexData.size();
-                mSceneData.meshIndexData.insert(mSceneData.meshIndexData.end(), mesh.indexData.begin(), mesh.indexData.end());
+                std::copy(mesh.indexData.begin(), mesh.indexData.end(), mSceneData.meshIndexData.begin() + mesh.indexOffset);
             }
 
             if (mesh.isSkinned())
             {
                 FALCOR_ASSERT(!mesh.skinningData.empty());
-                mSceneData.meshSkinningData.insert(mSceneData.meshSkinningData.end(), mesh.skinningData.begin(), mesh.skinningData.end());
+                std::copy(mesh.skinningData.begin(), mesh.skinningData.end(), mSceneData.meshSkinningData.begin() + mesh.skinningVertexOffset);
 
                 // Patch vertex index references.
                 for (uint32_t i = 0; i < mesh.skinningData.size(); ++i)
@@ -2446,10 +2734,10 @@ namespace Falcor
             }
 
             // Free the mesh local data.
-            mesh.indexData.clear();
-            mesh.staticData.clear();
-            mesh.skinningData.clear();
-        }
+            mesh.indexData = {};
+            mesh.staticData = {};
+            mesh.skinningData = {};
+        });
 
         // Initialize offsets for prev vertex data for vertex-animated meshes
         uint32_t prevOffset = (uint32_t)mSceneData.meshSkinningData.size();
@@ -2570,49 +2858,69 @@ namespace Falcor
         // Match texture coordinate quantization for textured emissives to format of PackedEmissiveTriangle.
         // This is to avoid mismatch when sampling and evaluating emissive triangles.
         // Note that non-emissive meshes are unmodified and use full precision texcoords.
-        for (auto& mesh : mMeshes)
+        //
+        // The meshes are quantized in parallel. The per-mesh results are collected and warnings are
+        // logged afterwards in mesh order to keep the output deterministic.
+        struct QuantizationResult
+        {
+            bool quantized = false;
+            float2 minTexCrd = float2(std::numeric_limits<float>::infinity());
+            float2 maxTexCrd = float2(-std::numeric_limits<float>::infinity());
+            float2 maxError = float2(0);
+            uint2 maxTexDim = uint2(0);
+        };
+        std::vector<QuantizationResult> results(mMeshes.size());
+
+        Threading::parallelFor(0, mMeshes.size(), [&](size_t meshIdx)
         {
+            const auto& mesh = mMeshes[meshIdx];
             const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId)->toBasicMaterial();
             if (pMaterial && pMaterial->getEmissiveTexture() != nullptr)
             {
                 // Quantize texture coordinates to fp16. Also track the bounds and max error.
-                float2 minTexCrd = float2(std::numeric_limits<float>::infinity());
-                float2 maxTexCrd = float2(-std::numeric_limits<float>::infinity());
-                float2 maxError = float2(0);
+                auto& result = results[meshIdx];
+                result.quantized = true;
+                result.maxTexDim = pMaterial->getMaxTextureDimensions();
 
                 for (uint32_t i = 0; i < mesh.staticVertexCount; ++i)
                 {
                     auto& v = mSceneData.meshStaticData[mesh.staticVertexOffset + i];
                     float2 texCrd = v.texCrd;
-                    minTexCrd = min(minTexCrd, texCrd);
-                    maxTexCrd = max(maxTexCrd, texCrd);
+                    result.minTexCrd = min(result.minTexCrd, texCrd);
+                    result.maxTexCrd = max(result.maxTexCrd, texCrd);
                     v.texCrd = f16tof32(f32tof16(texCrd));
-                    maxError = max(maxError, abs(v.texCrd - texCrd));
+                    result.maxError = max(result.maxError, abs(v.texCrd - texCrd));
                 }
+            }
+        });
 
-                // Issue warning if quantization errors are too large.
-                float2 maxAbsCrd = max(abs(minTexCrd), abs(maxTexCrd));
-                if (maxAbsCrd.x > HLF_MAX || maxAbsCrd.y > HLF_MAX)
-                {
-                    logWarning("Texture coordinates for emissive textured mesh '{}' are outside the representable range, expect rendering errors.", mesh.name);
-                }
-                else
-                {
-                    // Compute maximum quantization error in texels.
-                    // The texcoords are used for all texture channels so taking the maximum dimensions.
-                    uint2 maxTexDim = pMaterial->getMaxTextureDimensions();
-                    maxError *= maxTexDim;
-                    float maxTexelError = std::max(maxError.x, maxError.y);
+        for (size_t meshIdx = 0; meshIdx < mMeshes.size(); ++meshIdx)
+        {
+            const auto& mesh = mMeshes[meshIdx];
+            const auto& result = results[meshIdx];
+            if (!result.quantized) continue;
 
-                    if (maxTexelError > kMaxTexelError)
-                    {
-                        logWarning(
-                            "Texture coordinates for emissive textured mesh '{}' have a large quantization error of {} texels."
-                            "The coordinate range is [{},{}] x [{},{}] for maximum texture dimensions ({},{}).",
-                            mesh.name, maxTexelError,
-                            minTexCrd.x, maxTexCrd.x, minTexCrd.y, maxTexCrd.y, maxTexDim.x, maxTexDim.y
-                        );
-                    }
+            // Issue warning if quantization errors are too large.
+            float2 maxAbsCrd = max(abs(result.minTexCrd), abs(result.maxTexCrd));
+            if (maxAbsCrd.x > HLF_MAX || maxAbsCrd.y > HLF_MAX)
+            {
+                logWarning("Texture coordinates for emissive textured mesh '{}' are outside the representable range, expect rendering errors.", mesh.name);
+            }
+            else
+            {
+                // Compute maximum quantization error in texels.
+                // The texcoords are used for all texture channels so taking the maximum dimensions.
+                float2 maxError = result.maxError * float2(result.maxTexDim);
+                float maxTexelError = std::max(maxError.x, maxError.y);
+
+                if (maxTexelError > kMaxTexelError)
+                {
+                    logWarning(
+                        "Texture coordinates for emissive textured mesh '{}' have a large quantization error of {} texels."
+                        "The coordinate range is [{},{}] x [{},{}] for maximum texture dimensions ({},{}).",
+                        mesh.name, maxTexelError,
+                        result.minTexCrd.x, result.maxTexCrd.x, result.minTexCrd.y, result.maxTexCrd.y, result.maxTexDim.x, result.maxTexDim.y
+                    );
                 }
             }
         }
@@ -2651,6 +2959,15 @@ namespace Falcor
         mSceneData.sdfGrids = std::move(uniqueSDFGrids);
     }
 
+    VertexCacheStore::Writer& SceneBuilder::getVertexCacheWriter()
+    {
+        if (!mpVertexCacheWriter)
+        {
+            mpVertexCacheWriter = VertexCacheStore::Writer::create(getTempFilePath(), !is_set(mFlags, Flags::DontCompressVertexCache));
+        }
+        return *mpVertexCacheWriter;
+    }
+
     void SceneBuilder::createMeshData()
     {
         FALCOR_ASSERT(mSceneData.meshDesc.empty());
@@ -2737,21 +3054,42 @@ namespace Falcor
         FALCOR_ASSERT(mSceneData.meshGroups.empty());
 
         auto& instanceData = mSceneData.meshInstanceData;
+
+        // Compute the first mesh instance and TLAS instance index of each mesh group (exclusive prefix sum).
+        // This allows the instance data of the mesh groups to be written in parallel with a deterministic layout.
+        std::vector<size_t> groupInstanceOffsets(mMeshGroups.size());
+        std::vector<uint32_t> groupTlasInstanceIndices(mMeshGroups.size());
         size_t drawCount = 0;
 
-        for (const auto& meshGroup : mMeshGroups)
+        for (size_t groupIdx = 0; groupIdx < mMeshGroups.size(); ++groupIdx)
         {
-            const auto& meshList = meshGroup.meshList;
+            const auto& meshList = mMeshGroups[groupIdx].meshList;
 
             // If mesh group is instanced, all meshes have identical lists of instances.
             // This is a requirement for ray tracing and ensured by createMeshGroups().
             // For non-instanced static mesh groups, we allow the meshes to have different nodes.
             // This case is handled by pre-transforming the vertices in the BLAS build.
             FALCOR_ASSERT(!meshList.empty());
+            size_t instanceCount = mMeshes[meshList[0].get()].instances.size();
+            FALCOR_ASSERT(instanceCount > 0);
+
+            groupInstanceOffsets[groupIdx] = drawCount;
+            groupTlasInstanceIndices[groupIdx] = tlasInstanceIndex;
+            tlasInstanceIndex += (uint32_t)instanceCount;
+            drawCount += instanceCount * meshList.size();
+        }
+
+        instanceData.resize(drawCount, GeometryInstanceData(GeometryType::TriangleMesh));
+
+        Threading::parallelFor(0, mMeshGroups.size(), [&](size_t groupIdx)
+        {
+            const auto& meshGroup = mMeshGroups[groupIdx];
+            const auto& meshList = meshGroup.meshList;
             const auto& firstMesh = mMeshes[meshList[0].get()];
             size_t instanceCount = firstMesh.instances.size();
 
-            FALCOR_ASSERT(instanceCount > 0);
+            size_t instanceOffset = groupInstanceOffsets[groupIdx];
+            uint32_t groupTlasInstanceIndex = groupTlasInstanceIndices[groupIdx];
             auto instIter = firstMesh.instances.cbegin();
             for (size_t instanceIdx = 0; instanceIdx < instanceCount; instanceIdx++, instIter++)
             {
@@ -2782,18 +3120,14 @@ namespace Falcor
                     instance.ibOffset = mesh.indexOffset;
                     instance.flags |= mesh.use16BitIndices ? (uint32_t)GeometryInstanceFlags::Use16BitIndices : 0;
                     instance.flags |= mesh.isDynamic() ? (uint32_t)GeometryInstanceFlags::IsDynamic : 0;
-                    instance.instanceIndex = tlasInstanceIndex;
+                    instance.instanceIndex = groupTlasInstanceIndex + (uint32_t)instanceIdx;
                     instance.geometryIndex = blasGeometryIndex;
-                    instanceData.push_back(instance);
+                    instanceData[instanceOffset++] = instance;
 
                     blasGeometryIndex++;
                 }
-
-                tlasInstanceIndex++;
             }
-
-            drawCount += instanceCount * meshList.size();
-        }
+        });
 
         // Create mapping of mesh IDs to their instance IDs.
         mSceneData.meshIdToInstanceIds.resize(mMeshes.size());
@@ -2887,7 +3221,7 @@ namespace Falcor
     {
         // Calculate curve bounding boxes.
         mSceneData.curveBBs.resize(mCurves.size());
-        for (size_t i = 0; i < mCurves.size(); i++)
+        Threading::parallelFor(0, mCurves.size(), [&](size_t i)
         {
             const auto& curve = mCurves[i];
             AABB curveBB;
@@ -2901,7 +3235,7 @@ namespace Falcor
             }
 
             mSceneData.curveBBs[i] = curveBB;
-        }
+        });
     }
 
     static SceneBuilder* spActivePythonSceneBuilder; // TODO: REMOVEGLOBAL
@@ -2958,8 +3292,13 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("OptimizeMeshLayout", SceneBuilder::Flags::OptimizeMeshLayout);
+        flags.value("DontCompressVertexCache", SceneBuilder::Flags::DontCompressVertexCache);
+        flags.value("DeduplicateTextures", SceneBuilder::Flags::DeduplicateTextures);
+        flags.value("UseTextureCache", SceneBuilder::Flags::UseTextureCache);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
+        flags.value("HashCacheDependencies", SceneBuilder::Flags::HashCacheDependencies);
         ScriptBindings::addEnumBinaryOperators(flags);
 
         pybind11::class_<SceneBuilder, SceneBuilder::SharedPtr> sceneBuilder(m, "SceneBuilder");
@@ -38,6 +38,7 @@
 
 #include "Core/Macros.h"
 #include "Core/API/VAO.h"
+#include "Utils/CryptoUtils.h"
 #include "Utils/Math/AABB.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
@@ -45,7 +46,10 @@
 #include "Utils/Settings.h"
 
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -78,9 +82,14 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            OptimizeMeshLayout              = 0x20000,  ///< Merge vertices using a hash table regardless of their original indices, and reorder triangles and vertices for vertex cache and fetch locality.
+            DontCompressVertexCache         = 0x40000,  ///< Store the keyframes of vertex-animated meshes and curves uncompressed. By default, they are compressed in the vertex cache store they are streamed from.
+            DeduplicateTextures             = 0x80000,  ///< Hash the content of texture files and share one texture between files with identical content (e.g. copies of an image stored under different names).
+            UseTextureCache                 = 0x100000, ///< Load textures from the cache of preprocessed textures (see TextureCacheBuilder) if available, instead of decoding them and generating mips at runtime.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
+            HashCacheDependencies           = 0x40000000, ///< Store content hashes of all dependencies in the scene cache. A dependency with a changed write time does not invalidate the cache if its content is unchanged.
 
             Default = None
         };
@@ -341,6 +350,14 @@ namespace Falcor
         */
         void import(const std::filesystem::path& path, const Dictionary& dict = Dictionary());
 
+        /** Register a file the scene depends on.
+            Importers should call this for every file they read (included files, meshes, textures etc.).
+            The files are recorded in the scene cache and changes to any of them invalidate the cache.
+            This function is thread-safe.
+            \param[in] path File path. Relative paths are resolved using the data directories.
+        */
+        void addDependency(const std::filesystem::path& path);
+
         /** Get the scene. Make sure to add all the objects before calling this function
             \return nullptr if something went wrong, otherwise a new Scene object
         */
@@ -416,7 +433,8 @@ namespace Falcor
         MeshID addProcessedMesh(const ProcessedMesh& mesh);
 
         /** Set mesh vertex cache for animation.
-            \param[in] cachedCurves The mesh vertex cache data (will be moved from).
+            The keyframes are moved to the vertex cache store right away to release them from host memory.
+            \param[in] cachedMeshes The mesh vertex cache data (will be moved from).
         */
         void setCachedMeshes(std::vector<CachedMesh>&& cachedMeshes);
 
@@ -451,9 +469,10 @@ namespace Falcor
         CurveID addProcessedCurve(const ProcessedCurve& curve);
 
         /** Set curve vertex cache for animation.
-            \param[in] cachedCurves The dynamic curve vertex cache data.
+            The keyframes are moved to the vertex cache store right away to release them from host memory.
+            \param[in] cachedCurves The dynamic curve vertex cache data (will be moved from).
         */
-        void setCachedCurves(std::vector<CachedCurve>&& cachedCurves) { mSceneData.cachedCurves = std::move(cachedCurves); }
+        void setCachedCurves(std::vector<CachedCurve>&& cachedCurves);
 
         // SDFs
 
@@ -541,6 +560,11 @@ namespace Falcor
         */
         LightID addLight(const Light::SharedPtr& pLight);
 
+        /** Add a spectral profile. Identical profiles are only stored once.
+            \param[in] spectralProfile Sampled spectrum.
+            \param[in] computeICdf Compute the inverse CDF for importance sampling. Profiles without it are stored with as few bins as needed to represent the spectrum.
+            \return The ID of the new or an identical existing profile.
+        */
         SpectralProfileID addSpectralProfile(SampledSpectrum<float> spectralProfile, bool computeICdf = true);
         SpectralProfileID addSpectralProfileRGB(float3 rgb);
         std::pair<SpectralProfileID, SpectralProfileID> addSpectralProfileFromMaterial(const std::string& name);
@@ -560,7 +584,7 @@ namespace Falcor
         /** Set the environment map.
             \param[in] pEnvMap Environment map. Can be nullptr.
         */
-        void setEnvMap(EnvMap::SharedPtr pEnvMap) { mSceneData.pEnvMap = pEnvMap; }
+        void setEnvMap(EnvMap::SharedPtr pEnvMap);
 
         // Cameras
 
@@ -748,6 +772,9 @@ namespace Falcor
         Scene::SharedPtr mpScene;
         SceneCache::Key mSceneCacheKey;
         bool mWriteSceneCache = false;  ///< True if scene cache should be written after import.
+        std::set<std::filesystem::path> mDependencies;  ///< Files the scene depends on (only tracked if the scene cache is written).
+        std::mutex mDependencyMutex;
+        VertexCacheStore::Writer::UniquePtr mpVertexCacheWriter;  ///< Writer for the keyframes of vertex caches (created on first use).
 
         SceneGraph mSceneGraph;
 
@@ -759,6 +786,9 @@ namespace Falcor
         std::unique_ptr<MaterialTextureLoader> mpMaterialTextureLoader;
         GpuFence::SharedPtr mpFence;
 
+        std::map<SHA1::MD, SpectralProfileID> mSpectralProfileIDs;  ///< Spectral profiles by content hash, used to share identical profiles.
+        std::map<std::string, std::pair<SpectralProfileID, SpectralProfileID>> mMaterialSpectralProfiles; ///< IOR profiles by material name.
+
         // Helpers
         bool doesNodeHaveAnimation(NodeID nodeID) const;
         void updateLinkedObjects(NodeID oldNodeID, NodeID newNodeID);
@@ -803,6 +833,7 @@ namespace Falcor
         void collectVolumeGrids();
         void quantizeTexCoords();
         void removeDuplicateSDFGrids();
+        VertexCacheStore::Writer& getVertexCacheWriter();
 
         // Scene setup
         void createMeshData();
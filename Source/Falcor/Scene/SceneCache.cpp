@@ -28,11 +28,14 @@
 #include "SceneCache.h"
 #include "Material/StandardMaterial.h"
 #include "Material/MaterialTextureLoader.h"
+#include "Core/Platform/MemoryMappedFile.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 
-#include <lz4_stream/lz4_stream.h>
+#include <lz4.h>
 
-#include <sstream>
+#include <array>
+#include <atomic>
 #include <fstream>
 
 namespace Falcor
@@ -42,37 +45,93 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 32;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
         const std::string kDirectory = "NVIDIA/Falcor/SceneCache";
 
+        /** Size of the independently compressed blocks of a section.
+        */
         const size_t kBlockSize = 1 * 1024 * 1024;
 
+        /** Sections of the cache file.
+            Each section is compressed in independent blocks, so all sections can be decompressed in parallel.
+            Sections holding large POD arrays are decompressed directly into their destination.
+        */
+        enum class Section : uint32_t
+        {
+            General,
+            Grids,
+            Materials,
+            Animations,
+            Meshes,
+            MeshIndexData,
+            MeshStaticData,
+            MeshSkinningData,
+            CachedMeshes,
+            Curves,
+            CurveIndexData,
+            CurveStaticData,
+            CachedCurves,
+            CustomPrimitives,
+            Count
+        };
+
+        const size_t kSectionCount = (size_t)Section::Count;
+
         const char* kMagic = "FalcorS$";
         struct Header
         {
             uint8_t magic[8]{};
             uint32_t version{};
+            uint32_t sectionCount{};
+            uint64_t vertexCacheOffset{};   ///< Offset of the embedded vertex cache store in bytes.
+            uint64_t vertexCacheSize{};     ///< Size of the embedded vertex cache store in bytes (0 if there is none).
 
             bool isValid() const
             {
-                return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
+                return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion && sectionCount == kSectionCount;
             }
         };
+
+        /** Entry in the section table following the header.
+            The section table is followed by the dependency list (uncompressed, prefixed by its size in bytes),
+            so dependencies can be validated without touching the sections. A section starts with a table of the stored (compressed) size of each block followed by the block data.
+            Blocks are kBlockSize bytes when decompressed (except the last one). Blocks that don't compress are stored raw.
+            The sections are followed by the vertex cache store (see VertexCacheStore), which is streamed from the file at runtime.
+        */
+        struct SectionDesc
+        {
+            uint64_t offset = 0;        ///< Offset of the section from the start of the file in bytes.
+            uint64_t size = 0;          ///< Uncompressed size in bytes.
+            uint32_t blockCount = 0;    ///< Number of blocks.
+            uint32_t reserved = 0;
+        };
+
+        uint32_t getBlockCount(uint64_t size)
+        {
+            return (uint32_t)((size + kBlockSize - 1) / kBlockSize);
+        }
+
+        size_t getBlockSize(uint64_t size, uint32_t blockIndex)
+        {
+            return (size_t)std::min<uint64_t>(kBlockSize, size - (uint64_t)blockIndex * kBlockSize);
+        }
     }
 
-    /** Wrapper around std::ostream to ease serialization of basic types.
+    /** Serializes basic types into a memory buffer.
     */
     class SceneCache::OutputStream
     {
     public:
-        OutputStream(std::ostream& stream) : mStream(stream) {}
+        OutputStream(std::vector<uint8_t>& buffer) : mBuffer(buffer) {}
 
         void write(const void* data, size_t len)
         {
-            mStream.write(reinterpret_cast<const char*>(data), len);
+            size_t offset = mBuffer.size();
+            mBuffer.resize(offset + len);
+            if (len > 0) std::memcpy(mBuffer.data() + offset, data, len);
         }
 
         template<typename T>
@@ -119,19 +178,21 @@ namespace Falcor
         }
 
     private:
-        std::ostream& mStream;
+        std::vector<uint8_t>& mBuffer;
     };
 
-    /** Wrapper around std::istream to ease serialization of basic types.
+    /** Deserializes basic types from a memory buffer.
     */
     class SceneCache::InputStream
     {
     public:
-        InputStream(std::istream& stream) : mStream(stream) {}
+        InputStream(const std::vector<uint8_t>& buffer) : mpData(buffer.data()), mSize(buffer.size()) {}
 
         void read(void* data, size_t len)
         {
-            mStream.read(reinterpret_cast<char*>(data), len);
+            if (len > mSize - mOffset) throw RuntimeError("Unexpected end of scene cache data.");
+            if (len > 0) std::memcpy(data, mpData + mOffset, len);
+            mOffset += len;
         }
 
         template<typename T>
@@ -187,9 +248,284 @@ namespace Falcor
         }
 
     private:
-        std::istream& mStream;
+        const uint8_t* mpData;
+        size_t mSize;
+        size_t mOffset = 0;
     };
 
+    /** Collects the sections of a cache file and writes them to disk.
+        The blocks of each section are compressed in parallel.
+    */
+    class SceneCache::CacheWriter
+    {
+    public:
+        /** Create a stream writing into a section's own buffer.
+        */
+        OutputStream createStream(Section section)
+        {
+            return OutputStream(mSections[(size_t)section].buffer);
+        }
+
+        /** Set the list of dependencies stored in the cache.
+        */
+        void setDependencies(const DependencyList& dependencies)
+        {
+            mDependencyData.clear();
+            OutputStream stream(mDependencyData);
+            stream.write((uint32_t)dependencies.size());
+            for (const auto& dependency : dependencies)
+            {
+                stream.write(dependency.path);
+                stream.write(dependency.size);
+                stream.write(dependency.lastWriteTime);
+                stream.write(dependency.hash);
+            }
+        }
+
+        /** Set the vertex cache store to embed in the cache file.
+        */
+        void setVertexCacheStore(const VertexCacheStore::SharedPtr& pStore)
+        {
+            mpVertexCacheStore = pStore;
+        }
+
+        /** Reference raw data as the content of a section. The data must stay alive until write() returns.
+        */
+        template<typename T>
+        void setRawSection(Section section, const std::vector<T>& vec)
+        {
+            static_assert(std::is_trivially_copyable<T>::value);
+            mSections[(size_t)section].pData = reinterpret_cast<const uint8_t*>(vec.data());
+            mSections[(size_t)section].size = vec.size() * sizeof(T);
+        }
+
+        void write(const std::filesystem::path& path)
+        {
+            std::ofstream fs(path.c_str(), std::ios_base::binary);
+            if (fs.bad()) throw RuntimeError("Failed to create scene cache file '{}'.", path);
+
+            // Write header and a placeholder section table. The table is rewritten once all offsets are known.
+            Header header;
+            std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+            header.version = kVersion;
+            header.sectionCount = (uint32_t)kSectionCount;
+            std::array<SectionDesc, kSectionCount> sectionDescs;
+            fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            fs.write(reinterpret_cast<const char*>(sectionDescs.data()), sizeof(sectionDescs));
+
+            // Write dependency list.
+            uint64_t dependencyDataSize = mDependencyData.size();
+            fs.write(reinterpret_cast<const char*>(&dependencyDataSize), sizeof(dependencyDataSize));
+            fs.write(reinterpret_cast<const char*>(mDependencyData.data()), dependencyDataSize);
+
+            uint64_t offset = sizeof(header) + sizeof(sectionDescs) + sizeof(dependencyDataSize) + dependencyDataSize;
+            std::vector<std::vector<char>> blocks;
+            std::vector<uint32_t> blockSizes;
+
+            for (size_t i = 0; i < kSectionCount; ++i)
+            {
+                const uint8_t* pData = mSections[i].pData ? mSections[i].pData : mSections[i].buffer.data();
+                uint64_t size = mSections[i].pData ? mSections[i].size : mSections[i].buffer.size();
+                uint32_t blockCount = getBlockCount(size);
+
+                // Compress blocks in parallel. Blocks that don't compress are stored raw.
+                blocks.resize(blockCount);
+                blockSizes.resize(blockCount);
+                Threading::parallelFor(0, blockCount, [&](size_t b)
+                {
+                    const char* pSrc = reinterpret_cast<const char*>(pData + b * kBlockSize);
+                    int srcSize = (int)getBlockSize(size, (uint32_t)b);
+                    blocks[b].resize(LZ4_compressBound(srcSize));
+                    int compressedSize = LZ4_compress_default(pSrc, blocks[b].data(), srcSize, (int)blocks[b].size());
+                    if (compressedSize <= 0 || compressedSize >= srcSize)
+                    {
+                        blocks[b].assign(pSrc, pSrc + srcSize);
+                        compressedSize = srcSize;
+                    }
+                    blocks[b].resize(compressedSize);
+                    blockSizes[b] = (uint32_t)compressedSize;
+                }, 1);
+
+                sectionDescs[i].offset = offset;
+                sectionDescs[i].size = size;
+                sectionDescs[i].blockCount = blockCount;
+
+                fs.write(reinterpret_cast<const char*>(blockSizes.data()), blockCount * sizeof(uint32_t));
+                offset += blockCount * sizeof(uint32_t);
+                for (const auto& block : blocks)
+                {
+                    fs.write(block.data(), block.size());
+                    offset += block.size();
+                }
+            }
+
+            // Append the vertex cache store. Its chunks are already compressed individually.
+            if (mpVertexCacheStore)
+            {
+                header.vertexCacheOffset = offset;
+                header.vertexCacheSize = mpVertexCacheStore->getSizeInBytes();
+                mpVertexCacheStore->copyTo(fs);
+            }
+
+            fs.seekp(0);
+            fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            fs.write(reinterpret_cast<const char*>(sectionDescs.data()), sizeof(sectionDescs));
+            if (fs.bad()) throw RuntimeError("Failed to write scene cache file to '{}'.", path);
+        }
+
+    private:
+        struct SectionData
+        {
+            std::vector<uint8_t> buffer;        ///< Serialized section data.
+            const uint8_t* pData = nullptr;     ///< External raw section data (used instead of buffer if set).
+            uint64_t size = 0;                  ///< Size of external raw section data in bytes.
+        };
+
+        std::array<SectionData, kSectionCount> mSections;
+        std::vector<uint8_t> mDependencyData;
+        VertexCacheStore::SharedPtr mpVertexCacheStore;
+    };
+
+    /** Memory-maps a cache file and decompresses its sections.
+        Destinations for raw sections are registered first, then all blocks of all sections are decompressed in parallel.
+    */
+    class SceneCache::CacheReader
+    {
+    public:
+        CacheReader(const std::filesystem::path& path)
+            : mPath(path)
+            , mFile(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan)
+        {
+            if (!mFile.isOpen()) throw RuntimeError("Failed to open scene cache file '{}'.", path);
+
+            // Read header and section table.
+            Header header;
+            if (mFile.getSize() < sizeof(header) + sizeof(mSectionDescs)) throw RuntimeError("Invalid scene cache file '{}'.", path);
+            const uint8_t* pFileData = static_cast<const uint8_t*>(mFile.getData());
+            std::memcpy(&header, pFileData, sizeof(header));
+            if (!header.isValid()) throw RuntimeError("Invalid header in scene cache file '{}'.", path);
+            if (header.vertexCacheOffset + header.vertexCacheSize > mFile.getSize()) throw RuntimeError("Invalid vertex cache in scene cache file '{}'.", path);
+            std::memcpy(mSectionDescs.data(), pFileData + sizeof(header), sizeof(mSectionDescs));
+            mVertexCacheOffset = header.vertexCacheOffset;
+            mVertexCacheSize = header.vertexCacheSize;
+        }
+
+        /** Open the embedded vertex cache store.
+            \return The store, or nullptr if the cache file has none.
+        */
+        VertexCacheStore::SharedPtr openVertexCacheStore() const
+        {
+            if (mVertexCacheSize == 0) return nullptr;
+            return VertexCacheStore::open(mPath, mVertexCacheOffset);
+        }
+
+        /** Decompress a raw section directly into a vector. Must be called before decode().
+        */
+        template<typename T>
+        void setRawSectionDestination(Section section, std::vector<T>& vec)
+        {
+            static_assert(std::is_trivially_copyable<T>::value);
+            uint64_t size = mSectionDescs[(size_t)section].size;
+            if (size % sizeof(T) != 0) throw RuntimeError("Invalid section size in scene cache file '{}'.", mPath);
+            vec.resize(size / sizeof(T));
+            mDestinations[(size_t)section] = reinterpret_cast<uint8_t*>(vec.data());
+        }
+
+        /** Decompress all sections in parallel.
+        */
+        void decode()
+        {
+            const uint8_t* pFileData = static_cast<const uint8_t*>(mFile.getData());
+            const uint64_t fileSize = mFile.getSize();
+
+            struct Block
+            {
+                uint64_t srcOffset;
+                uint32_t srcSize;
+                uint32_t dstSize;
+                uint8_t* pDst;
+            };
+            std::vector<Block> blocks;
+
+            for (size_t i = 0; i < kSectionCount; ++i)
+            {
+                const SectionDesc& desc = mSectionDescs[i];
+                if (desc.blockCount != getBlockCount(desc.size)) throw RuntimeError("Invalid section table in scene cache file '{}'.", mPath);
+
+                uint8_t* pDst = mDestinations[i];
+                if (!pDst)
+                {
+                    mBuffers[i].resize(desc.size);
+                    pDst = mBuffers[i].data();
+                }
+
+                uint64_t srcOffset = desc.offset + desc.blockCount * sizeof(uint32_t);
+                if (srcOffset > fileSize) throw RuntimeError("Invalid section table in scene cache file '{}'.", mPath);
+                const uint8_t* pBlockSizes = pFileData + desc.offset;
+                for (uint32_t b = 0; b < desc.blockCount; ++b)
+                {
+                    Block block;
+                    std::memcpy(&block.srcSize, pBlockSizes + b * sizeof(uint32_t), sizeof(uint32_t));
+                    block.srcOffset = srcOffset;
+                    block.dstSize = (uint32_t)getBlockSize(desc.size, b);
+                    block.pDst = pDst + (uint64_t)b * kBlockSize;
+                    srcOffset += block.srcSize;
+                    if (block.srcSize > block.dstSize || srcOffset > fileSize) throw RuntimeError("Invalid block table in scene cache file '{}'.", mPath);
+                    blocks.push_back(block);
+                }
+            }
+
+            Threading::parallelFor(0, blocks.size(), [&](size_t i)
+            {
+                const Block& block = blocks[i];
+                const uint8_t* pSrc = pFileData + block.srcOffset;
+                if (block.srcSize == block.dstSize)
+                {
+                    std::memcpy(block.pDst, pSrc, block.dstSize);
+                }
+                else
+                {
+                    int size = LZ4_decompress_safe(reinterpret_cast<const char*>(pSrc), reinterpret_cast<char*>(block.pDst), (int)block.srcSize, (int)block.dstSize);
+                    if (size != (int)block.dstSize) throw RuntimeError("Failed to decompress scene cache file '{}'.", mPath);
+                }
+            }, 1);
+
+            mFile.close();
+        }
+
+        /** Create a stream reading from a decompressed section. Must be called after decode().
+        */
+        InputStream createStream(Section section) const
+        {
+            FALCOR_ASSERT(mDestinations[(size_t)section] == nullptr);
+            return InputStream(mBuffers[(size_t)section]);
+        }
+
+    private:
+        std::filesystem::path mPath;
+        MemoryMappedFile mFile;
+        std::array<SectionDesc, kSectionCount> mSectionDescs;
+        uint64_t mVertexCacheOffset = 0;
+        uint64_t mVertexCacheSize = 0;
+        std::array<uint8_t*, kSectionCount> mDestinations{};
+        std::array<std::vector<uint8_t>, kSectionCount> mBuffers;
+    };
+
+    SceneCache::Dependency SceneCache::createDependency(const std::filesystem::path& path, bool computeHash)
+    {
+        Dependency dependency;
+        dependency.path = path;
+        dependency.size = std::filesystem::file_size(path);
+        dependency.lastWriteTime = std::filesystem::last_write_time(path).time_since_epoch().count();
+        if (computeHash)
+        {
+            MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+            if (!file.isOpen()) throw RuntimeError("Failed to open '{}' for hashing.", path);
+            dependency.hash = SHA1::compute(file.getData(), file.getSize());
+        }
+        return dependency;
+    }
+
     bool SceneCache::hasValidCache(const Key& key)
     {
         auto cachePath = getCachePath(key);
@@ -202,10 +538,65 @@ namespace Falcor
         // Verify header.
         Header header;
         fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        return !fs.eof() && header.isValid();
+        if (fs.eof() || !header.isValid()) return false;
+
+        // Read dependency list.
+        fs.seekg(sizeof(Header) + kSectionCount * sizeof(SectionDesc));
+        uint64_t dependencyDataSize = 0;
+        fs.read(reinterpret_cast<char*>(&dependencyDataSize), sizeof(dependencyDataSize));
+        if (!fs.good()) return false;
+        std::vector<uint8_t> dependencyData(dependencyDataSize);
+        fs.read(reinterpret_cast<char*>(dependencyData.data()), dependencyDataSize);
+        if (!fs.good()) return false;
+
+        try
+        {
+            InputStream stream(dependencyData);
+            DependencyList dependencies(stream.read<uint32_t>());
+            for (auto& dependency : dependencies)
+            {
+                stream.read(dependency.path);
+                stream.read(dependency.size);
+                stream.read(dependency.lastWriteTime);
+                stream.read(dependency.hash);
+            }
+
+            // Validate dependencies in parallel as validation may need to hash file contents.
+            std::atomic<bool> valid = true;
+            Threading::parallelFor(0, dependencies.size(), [&](size_t i)
+            {
+                if (valid && !isDependencyValid(dependencies[i])) valid = false;
+            });
+            return valid;
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("Failed to read dependencies from scene cache '{}': {}", cachePath, e.what());
+            return false;
+        }
     }
 
-    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key)
+    bool SceneCache::isDependencyValid(const Dependency& dependency)
+    {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(dependency.path, ec);
+        if (ec || size != dependency.size)
+        {
+            logInfo("Scene cache is out of date: '{}' was changed or removed.", dependency.path);
+            return false;
+        }
+
+        auto lastWriteTime = std::filesystem::last_write_time(dependency.path, ec);
+        if (!ec && lastWriteTime.time_since_epoch().count() == dependency.lastWriteTime) return true;
+
+        // Write time changed. Fall back to comparing content hashes if available.
+        if (dependency.hash && createDependency(dependency.path, true).hash == dependency.hash) return true;
+
+        logInfo("Scene cache is out of date: '{}' was changed.", dependency.path);
+        return false;
+    }
+
+    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key, const DependencyList& dependencies)
     {
         auto cachePath = getCachePath(key);
 
@@ -214,44 +605,20 @@ namespace Falcor
         // Create directories if not existing.
         std::filesystem::create_directories(cachePath.parent_path());
 
-        // Open file.
-        std::ofstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) throw RuntimeError("Failed to create scene cache file '{}'.", cachePath);
-
-        // Write header (uncompressed).
-        Header header;
-        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
-        header.version = kVersion;
-        fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
-
-        // Write cache (compressed).
-        lz4_stream::basic_ostream<kBlockSize> zs(fs);
-        OutputStream stream(zs);
-        writeSceneData(stream, sceneData);
-        if (fs.bad()) throw RuntimeError("Failed to write scene cache file to '{}'.", cachePath);
+        CacheWriter writer;
+        writer.setDependencies(dependencies);
+        writeSceneData(writer, sceneData);
+        writer.write(cachePath);
     }
 
-    Scene::SceneData SceneCache::readCache(std::shared_ptr<Device> pDevice, const Key& key)
+    Scene::SceneData SceneCache::readCache(std::shared_ptr<Device> pDevice, const Key& key, const TextureCache::SharedPtr& pTextureCache)
     {
         auto cachePath = getCachePath(key);
 
         logInfo("Loading scene cache from '{}'.", cachePath);
 
-        // Open file.
-        std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) throw RuntimeError("Failed to open scene cache file '{}'.", cachePath);
-
-        // Read header (uncompressed).
-        Header header;
-        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        if (!header.isValid()) throw RuntimeError("Invalid header in scene cache file '{}'.", cachePath);
-
-        // Read cache (compressed).
-        lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
-        InputStream stream(zs);
-        auto sceneData = readSceneData(stream, pDevice);
-        if (fs.bad()) throw RuntimeError("Failed to read scene cache file from '{}'.", cachePath);
-        return sceneData;
+        CacheReader reader(cachePath);
+        return readSceneData(reader, pDevice, pTextureCache);
     }
 
     std::filesystem::path SceneCache::getCachePath(const Key& key)
@@ -261,159 +628,241 @@ namespace Falcor
 
     // SceneData
 
-    void SceneCache::writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData)
+    void SceneCache::writeSceneData(CacheWriter& writer, const Scene::SceneData& sceneData)
     {
-        writeMarker(stream, "Path");
-        stream.write(sceneData.path);
+        {
+            OutputStream stream = writer.createStream(Section::General);
 
-        writeMarker(stream, "RenderSettings");
-        stream.write(sceneData.renderSettings);
+            writeMarker(stream, "Path");
+            stream.write(sceneData.path);
 
-        writeMarker(stream, "Cameras");
-        stream.write((uint32_t)sceneData.cameras.size());
-        for (const auto& pCamera : sceneData.cameras) writeCamera(stream, pCamera);
-        stream.write(sceneData.selectedCamera);
-        stream.write(sceneData.cameraSpeed);
+            writeMarker(stream, "RenderSettings");
+            stream.write(sceneData.renderSettings);
 
-        writeMarker(stream, "Lights");
-        stream.write((uint32_t)sceneData.lights.size());
-        for (const auto& pLight : sceneData.lights) writeLight(stream, pLight);
+            writeMarker(stream, "Cameras");
+            stream.write((uint32_t)sceneData.cameras.size());
+            for (const auto& pCamera : sceneData.cameras) writeCamera(stream, pCamera);
+            stream.write(sceneData.selectedCamera);
+            stream.write(sceneData.cameraSpeed);
 
-        writeMarker(stream, "SpectralProfiles");
-        stream.write((uint32_t)sceneData.spectralProfiles.size());
-        for (const auto& SP : sceneData.spectralProfiles) writeSpectralProfile(stream, SP);
+            writeMarker(stream, "Lights");
+            stream.write((uint32_t)sceneData.lights.size());
+            for (const auto& pLight : sceneData.lights) writeLight(stream, pLight);
 
-        writeMarker(stream, "Grids");
-        stream.write((uint32_t)sceneData.grids.size());
-        for (const auto& pGrid : sceneData.grids) writeGrid(stream, pGrid);
+            writeMarker(stream, "SpectralProfiles");
+            stream.write((uint32_t)sceneData.spectralProfiles.size());
+            for (const auto& SP : sceneData.spectralProfiles) writeSpectralProfile(stream, SP);
+            stream.write(sceneData.spectralProfileData);
 
-        writeMarker(stream, "GridVolumes");
-        stream.write((uint32_t)sceneData.gridVolumes.size());
-        for (const auto& pGridVolume : sceneData.gridVolumes) writeGridVolume(stream, pGridVolume, sceneData.grids);
+            writeMarker(stream, "EnvMap");
+            bool hasEnvMap = sceneData.pEnvMap != nullptr;
+            stream.write(hasEnvMap);
+            if (hasEnvMap) writeEnvMap(stream, sceneData.pEnvMap);
+
+            writeMarker(stream, "SceneGraph");
+            stream.write((uint32_t)sceneData.sceneGraph.size());
+            for (const auto& node : sceneData.sceneGraph)
+            {
+                stream.write(node.name);
+                stream.write(node.parent);
+                stream.write(node.transform);
+                stream.write(node.meshBind);
+                stream.write(node.localToBindSpace);
+            }
 
-        writeMarker(stream, "EnvMap");
-        bool hasEnvMap = sceneData.pEnvMap != nullptr;
-        stream.write(hasEnvMap);
-        if (hasEnvMap) writeEnvMap(stream, sceneData.pEnvMap);
+            writeMarker(stream, "Metadata");
+            writeMetadata(stream, sceneData.metadata);
 
-        writeMarker(stream, "Materials");
-        writeMaterials(stream, sceneData.pMaterials);
+            writeMarker(stream, "End");
+        }
 
-        writeMarker(stream, "SceneGraph");
-        stream.write((uint32_t)sceneData.sceneGraph.size());
-        for (const auto& node : sceneData.sceneGraph)
         {
-            stream.write(node.name);
-            stream.write(node.parent);
-            stream.write(node.transform);
-            stream.write(node.meshBind);
-            stream.write(node.localToBindSpace);
+            OutputStream stream = writer.createStream(Section::Grids);
+
+            writeMarker(stream, "Grids");
+            stream.write((uint32_t)sceneData.grids.size());
+            for (const auto& pGrid : sceneData.grids) writeGrid(stream, pGrid);
+
+            writeMarker(stream, "GridVolumes");
+            stream.write((uint32_t)sceneData.gridVolumes.size());
+            for (const auto& pGridVolume : sceneData.gridVolumes) writeGridVolume(stream, pGridVolume, sceneData.grids);
         }
 
-        writeMarker(stream, "Animations");
-        stream.write((uint32_t)sceneData.animations.size());
-        for (const auto& pAnimation : sceneData.animations)
         {
-            writeAnimation(stream, pAnimation);
+            OutputStream stream = writer.createStream(Section::Materials);
+
+            writeMarker(stream, "Materials");
+            writeMaterials(stream, sceneData.pMaterials);
         }
 
-        writeMarker(stream, "Metadata");
-        writeMetadata(stream, sceneData.metadata);
+        {
+            OutputStream stream = writer.createStream(Section::Animations);
+
+            writeMarker(stream, "Animations");
+            stream.write((uint32_t)sceneData.animations.size());
+            for (const auto& pAnimation : sceneData.animations)
+            {
+                writeAnimation(stream, pAnimation);
+            }
+        }
 
-        writeMarker(stream, "Meshes");
-        stream.write(sceneData.meshDesc);
-        stream.write(sceneData.meshNames);
-        stream.write(sceneData.meshBBs);
-        stream.write(sceneData.meshInstanceData);
-        stream.write((uint32_t)sceneData.meshIdToInstanceIds.size());
-        for (const auto& item : sceneData.meshIdToInstanceIds)
         {
-            stream.write(item);
+            OutputStream stream = writer.createStream(Section::Meshes);
+
+            writeMarker(stream, "Meshes");
+            stream.write(sceneData.meshDesc);
+            stream.write(sceneData.meshNames);
+            stream.write(sceneData.meshBBs);
+            stream.write(sceneData.meshInstanceData);
+            stream.write((uint32_t)sceneData.meshIdToInstanceIds.size());
+            for (const auto& item : sceneData.meshIdToInstanceIds)
+            {
+                stream.write(item);
+            }
+            stream.write((uint32_t)sceneData.meshGroups.size());
+            for (const auto& group : sceneData.meshGroups)
+            {
+                stream.write(group.meshList);
+                stream.write(group.isStatic);
+                stream.write(group.isDisplaced);
+            }
+            stream.write(sceneData.useCompressedHitInfo);
+            stream.write(sceneData.has16BitIndices);
+            stream.write(sceneData.has32BitIndices);
+            stream.write(sceneData.meshDrawCount);
         }
-        stream.write((uint32_t)sceneData.meshGroups.size());
-        for (const auto& group : sceneData.meshGroups)
+
+        writer.setRawSection(Section::MeshIndexData, sceneData.meshIndexData);
+        writer.setRawSection(Section::MeshStaticData, sceneData.meshStaticData);
+        writer.setRawSection(Section::MeshSkinningData, sceneData.meshSkinningData);
+
         {
-            stream.write(group.meshList);
-            stream.write(group.isStatic);
-            stream.write(group.isDisplaced);
+            OutputStream stream = writer.createStream(Section::CachedMeshes);
+
+            writeMarker(stream, "CachedMeshes");
+            stream.write((uint32_t)sceneData.cachedMeshes.size());
+            for (const auto& cachedMesh : sceneData.cachedMeshes)
+            {
+                // Keyframes are stored in the vertex cache store.
+                if (!cachedMesh.vertexData.empty()) throw RuntimeError("Cached mesh keyframes must be moved to a vertex cache store before writing the scene cache.");
+                stream.write(cachedMesh.meshID);
+                stream.write(cachedMesh.timeSamples);
+                stream.write(cachedMesh.vertexCount);
+                stream.write(cachedMesh.firstChunk);
+            }
         }
-        stream.write((uint32_t)sceneData.cachedMeshes.size());
-        for (const auto& cachedMesh : sceneData.cachedMeshes)
+
         {
-            stream.write(cachedMesh.meshID);
-            stream.write(cachedMesh.timeSamples);
-            stream.write((uint32_t)cachedMesh.vertexData.size());
-            for (const auto& data : cachedMesh.vertexData) stream.write(data);
+            OutputStream stream = writer.createStream(Section::Curves);
+
+            writeMarker(stream, "Curves");
+            stream.write(sceneData.curveDesc);
+            stream.write(sceneData.curveBBs);
+            stream.write(sceneData.curveInstanceData);
         }
-        stream.write(sceneData.useCompressedHitInfo);
-        stream.write(sceneData.has16BitIndices);
-        stream.write(sceneData.has32BitIndices);
-        stream.write(sceneData.meshDrawCount);
-        stream.write(sceneData.meshIndexData);
-        stream.write(sceneData.meshStaticData);
-        stream.write(sceneData.meshSkinningData);
 
-        writeMarker(stream, "Curves");
-        stream.write(sceneData.curveDesc);
-        stream.write(sceneData.curveBBs);
-        stream.write(sceneData.curveInstanceData);
-        stream.write(sceneData.curveIndexData);
-        stream.write(sceneData.curveStaticData);
+        writer.setRawSection(Section::CurveIndexData, sceneData.curveIndexData);
+        writer.setRawSection(Section::CurveStaticData, sceneData.curveStaticData);
 
-        stream.write((uint32_t)sceneData.cachedCurves.size());
-        for (const auto& cachedCurve : sceneData.cachedCurves)
         {
-            stream.write(cachedCurve.tessellationMode);
-            stream.write(cachedCurve.geometryID);
-            stream.write(cachedCurve.timeSamples);
-            stream.write(cachedCurve.indexData);
-            stream.write((uint32_t)cachedCurve.vertexData.size());
-            for (const auto& data : cachedCurve.vertexData) stream.write(data);
+            OutputStream stream = writer.createStream(Section::CachedCurves);
+
+            writeMarker(stream, "CachedCurves");
+            stream.write((uint32_t)sceneData.cachedCurves.size());
+            for (const auto& cachedCurve : sceneData.cachedCurves)
+            {
+                stream.write(cachedCurve.tessellationMode);
+                stream.write(cachedCurve.geometryID);
+                stream.write(cachedCurve.timeSamples);
+                stream.write(cachedCurve.indexData);
+                if (!cachedCurve.vertexData.empty()) throw RuntimeError("Cached curve keyframes must be moved to a vertex cache store before writing the scene cache.");
+                stream.write(cachedCurve.vertexCount);
+                stream.write(cachedCurve.firstChunk);
+            }
+            writer.setVertexCacheStore(sceneData.pVertexCacheStore);
         }
 
-        writeMarker(stream, "CustomPrimitives");
-        stream.write(sceneData.customPrimitiveDesc);
-        stream.write(sceneData.customPrimitiveAABBs);
+        {
+            OutputStream stream = writer.createStream(Section::CustomPrimitives);
+
+            writeMarker(stream, "CustomPrimitives");
+            stream.write(sceneData.customPrimitiveDesc);
+            stream.write(sceneData.customPrimitiveAABBs);
 
-        writeMarker(stream, "End");
+            writeMarker(stream, "End");
+        }
     }
 
-    Scene::SceneData SceneCache::readSceneData(InputStream& stream, std::shared_ptr<Device> pDevice)
+    Scene::SceneData SceneCache::readSceneData(CacheReader& reader, std::shared_ptr<Device> pDevice, const TextureCache::SharedPtr& pTextureCache)
     {
         Scene::SceneData sceneData;
         sceneData.pMaterials = MaterialSystem::create(pDevice);
+        sceneData.pMaterials->getTextureManager()->setTextureCache(pTextureCache);
 
-        readMarker(stream, "Path");
-        stream.read(sceneData.path);
+        // Decompress all sections in parallel. Large POD arrays are decompressed directly into the scene data.
+        reader.setRawSectionDestination(Section::MeshIndexData, sceneData.meshIndexData);
+        reader.setRawSectionDestination(Section::MeshStaticData, sceneData.meshStaticData);
+        reader.setRawSectionDestination(Section::MeshSkinningData, sceneData.meshSkinningData);
+        reader.setRawSectionDestination(Section::CurveIndexData, sceneData.curveIndexData);
+        reader.setRawSectionDestination(Section::CurveStaticData, sceneData.curveStaticData);
+        reader.decode();
 
-        readMarker(stream, "RenderSettings");
-        stream.read(sceneData.renderSettings);
+        {
+            InputStream stream = reader.createStream(Section::General);
 
-        readMarker(stream, "Cameras");
-        sceneData.cameras.resize(stream.read<uint32_t>());
-        for (auto& pCamera : sceneData.cameras) pCamera = readCamera(stream);
-        stream.read(sceneData.selectedCamera);
-        stream.read(sceneData.cameraSpeed);
+            readMarker(stream, "Path");
+            stream.read(sceneData.path);
 
-        readMarker(stream, "Lights");
-        sceneData.lights.resize(stream.read<uint32_t>());
-        for (auto& pLight : sceneData.lights) pLight = readLight(stream);
+            readMarker(stream, "RenderSettings");
+            stream.read(sceneData.renderSettings);
 
-        readMarker(stream, "SpectralProfiles");
-        sceneData.spectralProfiles.resize(stream.read<uint32_t>());
-        for (auto& SP : sceneData.spectralProfiles) SP = readSpectralProfile(stream);
+            readMarker(stream, "Cameras");
+            sceneData.cameras.resize(stream.read<uint32_t>());
+            for (auto& pCamera : sceneData.cameras) pCamera = readCamera(stream);
+            stream.read(sceneData.selectedCamera);
+            stream.read(sceneData.cameraSpeed);
 
-        readMarker(stream, "Grids");
-        sceneData.grids.resize(stream.read<uint32_t>());
-        for (auto& pGrid : sceneData.grids) pGrid = readGrid(stream, pDevice);
+            readMarker(stream, "Lights");
+            sceneData.lights.resize(stream.read<uint32_t>());
+            for (auto& pLight : sceneData.lights) pLight = readLight(stream);
 
-        readMarker(stream, "GridVolumes");
-        sceneData.gridVolumes.resize(stream.read<uint32_t>());
-        for (auto& pGridVolume : sceneData.gridVolumes) pGridVolume = readGridVolume(stream, sceneData.grids, pDevice);
+            readMarker(stream, "SpectralProfiles");
+            sceneData.spectralProfiles.resize(stream.read<uint32_t>());
+            for (auto& SP : sceneData.spectralProfiles) SP = readSpectralProfile(stream);
+            stream.read(sceneData.spectralProfileData);
 
-        readMarker(stream, "EnvMap");
-        auto hasEnvMap = stream.read<bool>();
-        if (hasEnvMap) sceneData.pEnvMap = readEnvMap(stream, pDevice);
+            readMarker(stream, "EnvMap");
+            auto hasEnvMap = stream.read<bool>();
+            if (hasEnvMap) sceneData.pEnvMap = readEnvMap(stream, pDevice);
+
+            readMarker(stream, "SceneGraph");
+            sceneData.sceneGraph.resize(stream.read<uint32_t>());
+            for (auto &node : sceneData.sceneGraph)
+            {
+                stream.read(node.name);
+                stream.read(node.parent);
+                stream.read(node.transform);
+                stream.read(node.meshBind);
+                stream.read(node.localToBindSpace);
+            }
+
+            readMarker(stream, "Metadata");
+            sceneData.metadata = readMetadata(stream);
+
+            readMarker(stream, "End");
+        }
+
+        {
+            InputStream stream = reader.createStream(Section::Grids);
+
+            readMarker(stream, "Grids");
+            sceneData.grids.resize(stream.read<uint32_t>());
+            for (auto& pGrid : sceneData.grids) pGrid = readGrid(stream, pDevice);
+
+            readMarker(stream, "GridVolumes");
+            sceneData.gridVolumes.resize(stream.read<uint32_t>());
+            for (auto& pGridVolume : sceneData.gridVolumes) pGridVolume = readGridVolume(stream, sceneData.grids, pDevice);
+        }
 
         // Material textures are loaded asynchronously to allow loading other data
         // in parallel while loading textures from files and uploading them to the GPU.
@@ -424,83 +873,96 @@ namespace Falcor
         // further down which blocks until all textures are loaded.
         auto pMaterialTextureLoader = std::make_unique<MaterialTextureLoader>(sceneData.pMaterials->getTextureManager(), true);
 
-        readMarker(stream, "Materials");
-        readMaterials(stream, sceneData.pMaterials, *pMaterialTextureLoader, pDevice);
-
-        readMarker(stream, "SceneGraph");
-        sceneData.sceneGraph.resize(stream.read<uint32_t>());
-        for (auto &node : sceneData.sceneGraph)
         {
-            stream.read(node.name);
-            stream.read(node.parent);
-            stream.read(node.transform);
-            stream.read(node.meshBind);
-            stream.read(node.localToBindSpace);
+            InputStream stream = reader.createStream(Section::Materials);
+
+            readMarker(stream, "Materials");
+            readMaterials(stream, sceneData.pMaterials, *pMaterialTextureLoader, pDevice);
         }
 
-        readMarker(stream, "Animations");
-        sceneData.animations.resize(stream.read<uint32_t>());
-        for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(stream);
+        {
+            InputStream stream = reader.createStream(Section::Animations);
 
-        readMarker(stream, "Metadata");
-        sceneData.metadata = readMetadata(stream);
+            readMarker(stream, "Animations");
+            sceneData.animations.resize(stream.read<uint32_t>());
+            for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(stream);
+        }
 
-        readMarker(stream, "Meshes");
-        stream.read(sceneData.meshDesc);
-        stream.read(sceneData.meshNames);
-        stream.read(sceneData.meshBBs);
-        stream.read(sceneData.meshInstanceData);
-        sceneData.meshIdToInstanceIds.resize(stream.read<uint32_t>());
-        for (auto& item : sceneData.meshIdToInstanceIds)
         {
-            stream.read(item);
+            InputStream stream = reader.createStream(Section::Meshes);
+
+            readMarker(stream, "Meshes");
+            stream.read(sceneData.meshDesc);
+            stream.read(sceneData.meshNames);
+            stream.read(sceneData.meshBBs);
+            stream.read(sceneData.meshInstanceData);
+            sceneData.meshIdToInstanceIds.resize(stream.read<uint32_t>());
+            for (auto& item : sceneData.meshIdToInstanceIds)
+            {
+                stream.read(item);
+            }
+            sceneData.meshGroups.resize(stream.read<uint32_t>());
+            for (auto& group : sceneData.meshGroups)
+            {
+                stream.read(group.meshList);
+                stream.read(group.isStatic);
+                stream.read(group.isDisplaced);
+            }
+            stream.read(sceneData.useCompressedHitInfo);
+            stream.read(sceneData.has16BitIndices);
+            stream.read(sceneData.has32BitIndices);
+            stream.read(sceneData.meshDrawCount);
         }
-        sceneData.meshGroups.resize(stream.read<uint32_t>());
-        for (auto& group : sceneData.meshGroups)
+
         {
-            stream.read(group.meshList);
-            stream.read(group.isStatic);
-            stream.read(group.isDisplaced);
+            InputStream stream = reader.createStream(Section::CachedMeshes);
+
+            readMarker(stream, "CachedMeshes");
+            sceneData.cachedMeshes.resize(stream.read<uint32_t>());
+            for (auto& cachedMesh : sceneData.cachedMeshes)
+            {
+                stream.read(cachedMesh.meshID);
+                stream.read(cachedMesh.timeSamples);
+                stream.read(cachedMesh.vertexCount);
+                stream.read(cachedMesh.firstChunk);
+            }
         }
-        sceneData.cachedMeshes.resize(stream.read<uint32_t>());
-        for (auto& cachedMesh : sceneData.cachedMeshes)
+
         {
-            stream.read(cachedMesh.meshID);
-            stream.read(cachedMesh.timeSamples);
-            cachedMesh.vertexData.resize(stream.read<uint32_t>());
-            for (auto& data : cachedMesh.vertexData) stream.read(data);
-        }
-        stream.read(sceneData.useCompressedHitInfo);
-        stream.read(sceneData.has16BitIndices);
-        stream.read(sceneData.has32BitIndices);
-        stream.read(sceneData.meshDrawCount);
-        stream.read(sceneData.meshIndexData);
-        stream.read(sceneData.meshStaticData);
-        stream.read(sceneData.meshSkinningData);
+            InputStream stream = reader.createStream(Section::Curves);
 
-        readMarker(stream, "Curves");
-        stream.read(sceneData.curveDesc);
-        stream.read(sceneData.curveBBs);
-        stream.read(sceneData.curveInstanceData);
-        stream.read(sceneData.curveIndexData);
-        stream.read(sceneData.curveStaticData);
+            readMarker(stream, "Curves");
+            stream.read(sceneData.curveDesc);
+            stream.read(sceneData.curveBBs);
+            stream.read(sceneData.curveInstanceData);
+        }
 
-        sceneData.cachedCurves.resize(stream.read<uint32_t>());
-        for (auto& cachedCurve : sceneData.cachedCurves)
         {
-            stream.read(cachedCurve.tessellationMode);
-            stream.read(cachedCurve.geometryID);
-            stream.read(cachedCurve.timeSamples);
-            stream.read(cachedCurve.indexData);
-            cachedCurve.vertexData.resize(stream.read<uint32_t>());
-            for (auto& data : cachedCurve.vertexData) stream.read(data);
+            InputStream stream = reader.createStream(Section::CachedCurves);
+
+            readMarker(stream, "CachedCurves");
+            sceneData.cachedCurves.resize(stream.read<uint32_t>());
+            for (auto& cachedCurve : sceneData.cachedCurves)
+            {
+                stream.read(cachedCurve.tessellationMode);
+                stream.read(cachedCurve.geometryID);
+                stream.read(cachedCurve.timeSamples);
+                stream.read(cachedCurve.indexData);
+                stream.read(cachedCurve.vertexCount);
+                stream.read(cachedCurve.firstChunk);
+            }
+            sceneData.pVertexCacheStore = reader.openVertexCacheStore();
         }
 
-        readMarker(stream, "CustomPrimitives");
-        stream.read(sceneData.customPrimitiveDesc);
-        stream.read(sceneData.customPrimitiveAABBs);
+        {
+            InputStream stream = reader.createStream(Section::CustomPrimitives);
 
-        readMarker(stream, "End");
+            readMarker(stream, "CustomPrimitives");
+            stream.read(sceneData.customPrimitiveDesc);
+            stream.read(sceneData.customPrimitiveAABBs);
+
+            readMarker(stream, "End");
+        }
 
         pMaterialTextureLoader.reset();
 
@@ -832,6 +1294,19 @@ namespace Falcor
                 stream.write(id);
             }
         }
+        for (const auto& pStreamer : pGridVolume->mGridStreamers)
+        {
+            stream.write(pStreamer != nullptr);
+            if (!pStreamer) continue;
+            stream.write(pStreamer->getPaths());
+            stream.write(pStreamer->getGridname());
+            const auto& options = pStreamer->getOptions();
+            stream.write(options.framesAhead);
+            stream.write(options.framesBehind);
+            stream.write(options.memoryBudget);
+            stream.write(options.threadCount);
+            stream.write(options.cacheBricks);
+        }
         stream.write(pGridVolume->mGridFrame);
         stream.write(pGridVolume->mGridFrameCount);
         stream.write(pGridVolume->mBounds);
@@ -856,10 +1331,24 @@ namespace Falcor
                 pGrid = id == uint32_t(-1) ? nullptr : grids[id];
             }
         }
+        for (auto& pStreamer : pGridVolume->mGridStreamers)
+        {
+            if (!stream.read<bool>()) continue;
+            auto paths = stream.read<std::vector<std::filesystem::path>>();
+            auto gridname = stream.read<std::string>();
+            GridStreamer::Options options;
+            stream.read(options.framesAhead);
+            stream.read(options.framesBehind);
+            stream.read(options.memoryBudget);
+            stream.read(options.threadCount);
+            stream.read(options.cacheBricks);
+            pStreamer = GridStreamer::create(pGridVolume->mpDevice, paths, gridname, options);
+        }
         stream.read(pGridVolume->mGridFrame);
         stream.read(pGridVolume->mGridFrameCount);
         stream.read(pGridVolume->mBounds);
         stream.read(pGridVolume->mData);
+        pGridVolume->updateStreamedGrids();
 
         return pGridVolume;
     }
@@ -878,7 +1367,7 @@ namespace Falcor
         uint64_t size = stream.read<uint64_t>();
         auto buffer = nanovdb::HostBuffer::create(size);
         stream.read(buffer.data(), buffer.size());
-        return Grid::SharedPtr(new Grid(std::move(pDevice), nanovdb::GridHandle<nanovdb::HostBuffer>(std::move(buffer))));
+        return Grid::create(std::move(pDevice), Grid::createHostData(nanovdb::GridHandle<nanovdb::HostBuffer>(std::move(buffer))));
     }
 
     // EnvMap
@@ -930,7 +1419,10 @@ namespace Falcor
         stream.write(pAnimation->mPostInfinityBehavior);
         stream.write(pAnimation->mInterpolationMode);
         stream.write(pAnimation->mEnableWarping);
-        stream.write(pAnimation->mKeyframes);
+        stream.write(pAnimation->mKeyframeTimes);
+        stream.write(pAnimation->mKeyframeTranslations);
+        stream.write(pAnimation->mKeyframeScalings);
+        stream.write(pAnimation->mKeyframeRotations);
     }
 
     Animation::SharedPtr SceneCache::readAnimation(InputStream& stream)
@@ -943,7 +1435,10 @@ namespace Falcor
         stream.read(pAnimation->mPostInfinityBehavior);
         stream.read(pAnimation->mInterpolationMode);
         stream.read(pAnimation->mEnableWarping);
-        stream.read(pAnimation->mKeyframes);
+        stream.read(pAnimation->mKeyframeTimes);
+        stream.read(pAnimation->mKeyframeTranslations);
+        stream.read(pAnimation->mKeyframeScalings);
+        stream.read(pAnimation->mKeyframeRotations);
         return pAnimation;
     }
 
@@ -42,6 +42,7 @@
 #include "Utils/CryptoUtils.h"
 
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -50,13 +51,37 @@ namespace Falcor
     /** Helper class for reading and writing scene cache files.
         The scene cache is used to heavily reduce load times of more complex assets.
         The cache stores a binary representation of `Scene::SceneData` which contains everything to re-create a `Scene`.
+        The data is split into sections (meshes, index data, vertex data, curves, materials, grids, animations etc.)
+        that are compressed in independent blocks. On load, the file is memory-mapped and all blocks are decompressed
+        in parallel, with large POD arrays decompressed directly into their destination.
     */
     class FALCOR_API SceneCache
     {
     public:
         using Key = SHA1::MD;
 
+        /** A file the cached scene was created from.
+            Dependencies are stored in the cache header. The cache is only valid if all dependencies are unchanged.
+        */
+        struct Dependency
+        {
+            std::filesystem::path path;         ///< Absolute file path.
+            uint64_t size = 0;                  ///< File size in bytes.
+            int64_t lastWriteTime = 0;          ///< Last write time in file clock ticks.
+            std::optional<SHA1::MD> hash;       ///< Optional content hash. If set, a file with changed write time is still valid if the content is unchanged.
+        };
+
+        using DependencyList = std::vector<Dependency>;
+
+        /** Create a dependency record for a file.
+            \param[in] path Absolute file path.
+            \param[in] computeHash If true, the SHA-1 hash of the file content is computed and stored.
+            \return Returns the dependency record.
+        */
+        static Dependency createDependency(const std::filesystem::path& path, bool computeHash);
+
         /** Check if there is a valid scene cache for a given cache key.
+            The cache is only valid if none of the dependencies stored in the cache changed.
             \param[in] key Cache key.
             \return Returns true if a valid cache exists.
         */
@@ -65,24 +90,28 @@ namespace Falcor
         /** Write a scene cache.
             \param[in] sceneData Scene data.
             \param[in] key Cache key.
+            \param[in] dependencies List of files the scene depends on.
         */
-        static void writeCache(const Scene::SceneData& sceneData, const Key& key);
+        static void writeCache(const Scene::SceneData& sceneData, const Key& key, const DependencyList& dependencies = {});
 
         /** Read a scene cache.
             \param[in] pDevice GPU device.
             \param[in] key Cache key.
+            \param[in] pTextureCache Optional cache of preprocessed textures to load material textures from.
             \return Returns the loaded scene data.
         */
-        static Scene::SceneData readCache(std::shared_ptr<Device> pDevice, const Key& key);
+        static Scene::SceneData readCache(std::shared_ptr<Device> pDevice, const Key& key, const TextureCache::SharedPtr& pTextureCache = nullptr);
 
     private:
         class OutputStream;
         class InputStream;
+        class CacheWriter;
+        class CacheReader;
 
         static std::filesystem::path getCachePath(const Key& key);
 
-        static void writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData);
-        static Scene::SceneData readSceneData(InputStream& stream, std::shared_ptr<Device> pDevice);
+        static void writeSceneData(CacheWriter& writer, const Scene::SceneData& sceneData);
+        static Scene::SceneData readSceneData(CacheReader& reader, std::shared_ptr<Device> pDevice, const TextureCache::SharedPtr& pTextureCache);
 
         static void writeMetadata(OutputStream& stream, const Scene::Metadata& metadata);
         static Scene::Metadata readMetadata(InputStream& stream);
@@ -121,6 +150,8 @@ namespace Falcor
         static void writeAnimation(OutputStream& stream, const Animation::SharedPtr& pAnimation);
         static Animation::SharedPtr readAnimation(InputStream& stream);
 
+        static bool isDependencyValid(const Dependency& dependency);
+
         static void writeMarker(OutputStream& stream, const std::string& id);
         static void readMarker(InputStream& stream, const std::string& id);
     };
@@ -30,8 +30,9 @@
 #include <cstdint>
 #include <climits>
 
-// this file exposes a single function, CompressAlphaDxt5, which encodes a 4x4 set of uint8 alpha values into a single 64 bit BC4 encoded block
-static void CompressAlphaDxt5(uint8_t* tile, void* block);
+// This file exposes encodeBC4Block(), which encodes a 4x4 set of uint8 values into a single 64 bit BC4 block.
+// The encoder produces the same blocks as libsquish's CompressAlphaDxt5, but is written branch-free over the 16 texels
+// so that the code book fitting vectorizes.
 
 // derived from libsquish, alpha.cpp
 /* -----------------------------------------------------------------------------
@@ -54,193 +55,141 @@ static void CompressAlphaDxt5(uint8_t* tile, void* block);
     SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
    -------------------------------------------------------------------------- */
 
-static void FixRange(int& min, int& max, int steps)
+namespace Falcor
 {
-    if (max - min < steps)
-        max = std::min(min + steps, 255);
-    if (max - min < steps)
-        min = std::max(0, max - steps);
-}
-
-static int FitCodes(uint8_t const* tile, uint8_t const* codes, uint8_t* indices)
-{
-    // fit each alpha value to the codebook
-    int err = 0;
-    for (int i = 0; i < 16; ++i)
+    namespace BC4Encode
     {
-        // find the least error and corresponding index
-        int value = (int)(tile[i]);
-        int least = INT_MAX;
-        int index = 0;
-        for (int j = 0; j < 8; ++j)
+        inline void fixRange(int& min, int& max, int steps)
         {
-            // get the squared error from this code
-            int dist = (int)value - (int)codes[j];
-            dist *= dist;
+            if (max - min < steps)
+                max = std::min(min + steps, 255);
+            if (max - min < steps)
+                min = std::max(0, max - steps);
+        }
 
-            // compare with the best so far
-            if (dist < least)
+        // Fit each value to the code book, returns the total squared error.
+        // The loops run over the texels in the inner loop with selects instead of branches, which compilers vectorize.
+        inline int fitCodes(const uint8_t* tile, const uint8_t* codes, uint8_t* indices)
+        {
+            int least[16];
+            for (int i = 0; i < 16; ++i)
             {
-                least = dist;
-                index = j;
+                least[i] = INT_MAX;
+                indices[i] = 0;
             }
-        }
-
-        // save this index and accumulate the error
-        indices[i] = (uint8_t)index;
-        err += least;
-    }
-
-    // return the total error
-    return err;
-}
 
-static void WriteAlphaBlock(int alpha0, int alpha1, uint8_t const* indices, void* block)
-{
-    uint8_t* bytes = reinterpret_cast<uint8_t*>(block);
+            for (int j = 0; j < 8; ++j)
+            {
+                const int code = codes[j];
+                for (int i = 0; i < 16; ++i)
+                {
+                    int dist = (int)tile[i] - code;
+                    dist *= dist;
+                    const bool closer = dist < least[i];
+                    least[i] = closer ? dist : least[i];
+                    indices[i] = closer ? (uint8_t)j : indices[i];
+                }
+            }
 
-    // write the first two bytes
-    bytes[0] = (uint8_t)alpha0;
-    bytes[1] = (uint8_t)alpha1;
+            int err = 0;
+            for (int i = 0; i < 16; ++i) err += least[i];
+            return err;
+        }
 
-    // pack the indices with 3 bits each
-    uint8_t* dest = bytes + 2;
-    uint8_t const* src = indices;
-    for (int i = 0; i < 2; ++i)
-    {
-        // pack 8 3-bit values
-        int value = 0;
-        for (int j = 0; j < 8; ++j)
+        // Pack the two end points and 16 3-bit indices into a block.
+        inline uint64_t packBlock(int alpha0, int alpha1, const uint8_t* indices)
         {
-            int index = *src++;
-            value |= (index << 3 * j);
+            uint64_t block = (uint64_t)alpha0 | ((uint64_t)alpha1 << 8);
+            for (int i = 0; i < 16; ++i) block |= (uint64_t)indices[i] << (16 + 3 * i);
+            return block;
         }
 
-        // store in 3 bytes
-        for (int j = 0; j < 3; ++j)
+        inline uint64_t packBlock5(int alpha0, int alpha1, uint8_t* indices)
         {
-            int byte = (value >> 8 * j) & 0xff;
-            *dest++ = (uint8_t)byte;
+            // The 5-alpha mode requires alpha0 <= alpha1, swap the end points and remap the indices otherwise.
+            if (alpha0 > alpha1)
+            {
+                for (int i = 0; i < 16; ++i)
+                {
+                    const uint8_t index = indices[i];
+                    indices[i] = index <= 1 ? uint8_t(1 - index) : index <= 5 ? uint8_t(7 - index) : index;
+                }
+                return packBlock(alpha1, alpha0, indices);
+            }
+            return packBlock(alpha0, alpha1, indices);
         }
-    }
-}
 
-static void WriteAlphaBlock5(int alpha0, int alpha1, uint8_t const* indices, void* block)
-{
-    // check the relative values of the endpoints
-    if (alpha0 > alpha1)
-    {
-        // swap the indices
-        uint8_t swapped[16];
-        for (int i = 0; i < 16; ++i)
+        inline uint64_t packBlock7(int alpha0, int alpha1, uint8_t* indices)
         {
-            uint8_t index = indices[i];
-            if (index == 0)
-                swapped[i] = 1;
-            else if (index == 1)
-                swapped[i] = 0;
-            else if (index <= 5)
-                swapped[i] = 7 - index;
-            else
-                swapped[i] = index;
+            // The 7-alpha mode requires alpha0 >= alpha1, swap the end points and remap the indices otherwise.
+            if (alpha0 < alpha1)
+            {
+                for (int i = 0; i < 16; ++i)
+                {
+                    const uint8_t index = indices[i];
+                    indices[i] = index <= 1 ? uint8_t(1 - index) : uint8_t(9 - index);
+                }
+                return packBlock(alpha1, alpha0, indices);
+            }
+            return packBlock(alpha0, alpha1, indices);
         }
-
-        // write the block
-        WriteAlphaBlock(alpha1, alpha0, swapped, block);
     }
-    else
-    {
-        // write the block
-        WriteAlphaBlock(alpha0, alpha1, indices, block);
-    }
-}
 
-static void WriteAlphaBlock7(int alpha0, int alpha1, uint8_t const* indices, void* block)
-{
-    // check the relative values of the endpoints
-    if (alpha0 < alpha1)
+    /** Encode a 4x4 tile of values into a BC4 block.
+        \param[in] tile 16 values in row-major order.
+        \return The BC4 block.
+    */
+    inline uint64_t encodeBC4Block(const uint8_t* tile)
     {
-        // swap the indices
-        uint8_t swapped[16];
+        using namespace BC4Encode;
+
+        // Get the range for 5-alpha and 7-alpha interpolation.
+        int min5 = 255;
+        int max5 = 0;
+        int min7 = 255;
+        int max7 = 0;
         for (int i = 0; i < 16; ++i)
         {
-            uint8_t index = indices[i];
-            if (index == 0)
-                swapped[i] = 1;
-            else if (index == 1)
-                swapped[i] = 0;
-            else
-                swapped[i] = 9 - index;
+            const int value = tile[i];
+            min7 = std::min(min7, value);
+            max7 = std::max(max7, value);
+            min5 = std::min(min5, value != 0 ? value : 255);
+            max5 = std::max(max5, value != 255 ? value : 0);
         }
 
-        // write the block
-        WriteAlphaBlock(alpha1, alpha0, swapped, block);
+        // Handle the case that no valid range was found.
+        if (min5 > max5)
+            min5 = max5;
+        if (min7 > max7)
+            min7 = max7;
+
+        // Fix the range to be the minimum in each case.
+        fixRange(min5, max5, 5);
+        fixRange(min7, max7, 7);
+
+        // Set up the 5-alpha code book.
+        uint8_t codes5[8];
+        codes5[0] = (uint8_t)min5;
+        codes5[1] = (uint8_t)max5;
+        for (int i = 1; i < 5; ++i)
+            codes5[1 + i] = (uint8_t)(((5 - i) * min5 + i * max5) / 5);
+        codes5[6] = 0;
+        codes5[7] = 255;
+
+        // Set up the 7-alpha code book.
+        uint8_t codes7[8];
+        codes7[0] = (uint8_t)min7;
+        codes7[1] = (uint8_t)max7;
+        for (int i = 1; i < 7; ++i)
+            codes7[1 + i] = (uint8_t)(((7 - i) * min7 + i * max7) / 7);
+
+        // Fit the data to both code books.
+        uint8_t indices5[16];
+        uint8_t indices7[16];
+        const int err5 = fitCodes(tile, codes5, indices5);
+        const int err7 = fitCodes(tile, codes7, indices7);
+
+        // Return the block with least error.
+        return err5 <= err7 ? packBlock5(min5, max5, indices5) : packBlock7(min7, max7, indices7);
     }
-    else
-    {
-        // write the block
-        WriteAlphaBlock(alpha0, alpha1, indices, block);
-    }
-}
-
-
-static void CompressAlphaDxt5(uint8_t* tile, void* block)
-{
-    // get the range for 5-alpha and 7-alpha interpolation
-    int min5 = 255;
-    int max5 = 0;
-    int min7 = 255;
-    int max7 = 0;
-    for (int i = 0; i < 16; ++i)
-    {
-        // incorporate into the min/max
-        int value = (int)(tile[i]);
-        if (value < min7)
-            min7 = value;
-        if (value > max7)
-            max7 = value;
-        if (value != 0 && value < min5)
-            min5 = value;
-        if (value != 255 && value > max5)
-            max5 = value;
-    }
-
-    // handle the case that no valid range was found
-    if (min5 > max5)
-        min5 = max5;
-    if (min7 > max7)
-        min7 = max7;
-
-    // fix the range to be the minimum in each case
-    FixRange(min5, max5, 5);
-    FixRange(min7, max7, 7);
-
-    // set up the 5-alpha code book
-    uint8_t codes5[8];
-    codes5[0] = (uint8_t)min5;
-    codes5[1] = (uint8_t)max5;
-    for (int i = 1; i < 5; ++i)
-        codes5[1 + i] = (uint8_t)(((5 - i) * min5 + i * max5) / 5);
-    codes5[6] = 0;
-    codes5[7] = 255;
-
-    // set up the 7-alpha code book
-    uint8_t codes7[8];
-    codes7[0] = (uint8_t)min7;
-    codes7[1] = (uint8_t)max7;
-    for (int i = 1; i < 7; ++i)
-        codes7[1 + i] = (uint8_t)(((7 - i) * min7 + i * max7) / 7);
-
-    // fit the data to both code books
-    uint8_t indices5[16];
-    uint8_t indices7[16];
-    int err5 = FitCodes(tile, codes5, indices5);
-    int err7 = FitCodes(tile, codes7, indices7);
-
-    // save the block with least error
-    if (err5 <= err7)
-        WriteAlphaBlock5(min5, max5, indices5, block);
-    else
-        WriteAlphaBlock7(min7, max7, indices7, block);
 }
-
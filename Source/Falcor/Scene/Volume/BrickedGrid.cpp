@@ -0,0 +1,139 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BrickedGrid.h"
+#include "Utils/Logger.h"
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kMagic[4] = { 'F', 'B', 'G', 'D' };
+        const uint32_t kVersion = 1;
+
+        struct Header
+        {
+            char magic[4];
+            uint32_t version;
+            SHA1::MD key;
+            uint3 leafDim;
+            uint3 atlasSize;
+            uint32_t atlasFormat;
+            uint32_t brickCount;
+            uint32_t reserved;
+            uint64_t rangeCount;
+            uint64_t indirectionCount;
+            uint64_t atlasByteSize;
+        };
+
+        static_assert(sizeof(Header) == 88);
+    }
+
+    BrickedGrid BrickedGridData::createTextures(Device* pDevice) const
+    {
+        BrickedGrid bricks;
+        bricks.range = Texture::create3D(pDevice, leafDim.x, leafDim.y, leafDim.z, ResourceFormat::RG16Float, 4, range.data(), ResourceBindFlags::ShaderResource, false);
+        bricks.indirection = Texture::create3D(pDevice, leafDim.x, leafDim.y, leafDim.z, ResourceFormat::RGBA8Uint, 1, indirection.data(), ResourceBindFlags::ShaderResource, false);
+        bricks.atlas = Texture::create3D(pDevice, atlasSize.x, atlasSize.y, atlasSize.z, atlasFormat, 1, atlas.data(), ResourceBindFlags::ShaderResource, false);
+        return bricks;
+    }
+
+    bool BrickedGridData::write(const std::filesystem::path& path, const SHA1::MD& key) const
+    {
+        Header header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.key = key;
+        header.leafDim = leafDim;
+        header.atlasSize = atlasSize;
+        header.atlasFormat = (uint32_t)atlasFormat;
+        header.brickCount = brickCount;
+        header.rangeCount = range.size();
+        header.indirectionCount = indirection.size();
+        header.atlasByteSize = atlas.size();
+
+        // Write to a temporary file first, so that an interrupted write or concurrent readers never see a partial file.
+        auto tempPath = path;
+        tempPath += ".tmp";
+        {
+            std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+            os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            os.write(reinterpret_cast<const char*>(range.data()), range.size() * sizeof(uint32_t));
+            os.write(reinterpret_cast<const char*>(indirection.data()), indirection.size() * sizeof(uint32_t));
+            os.write(reinterpret_cast<const char*>(atlas.data()), atlas.size());
+            if (!os)
+            {
+                logWarning("Failed to write bricked grid cache '{}'.", tempPath);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec)
+        {
+            logWarning("Failed to write bricked grid cache '{}': {}", path, ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<BrickedGridData> BrickedGridData::read(const std::filesystem::path& path, const SHA1::MD& key)
+    {
+        std::ifstream is(path, std::ios::binary);
+        if (!is) return {};
+
+        Header header;
+        if (!is.read(reinterpret_cast<char*>(&header), sizeof(header))) return {};
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.key != key) return {};
+
+        const uint64_t expectedSize = sizeof(header) + (header.rangeCount + header.indirectionCount) * sizeof(uint32_t) + header.atlasByteSize;
+        std::error_code ec;
+        if (std::filesystem::file_size(path, ec) != expectedSize || ec)
+        {
+            logWarning("Bricked grid cache '{}' is truncated.", path);
+            return {};
+        }
+
+        BrickedGridData data;
+        data.leafDim = header.leafDim;
+        data.atlasSize = header.atlasSize;
+        data.atlasFormat = (ResourceFormat)header.atlasFormat;
+        data.brickCount = header.brickCount;
+        data.range.resize(header.rangeCount);
+        data.indirection.resize(header.indirectionCount);
+        data.atlas.resize(header.atlasByteSize);
+        is.read(reinterpret_cast<char*>(data.range.data()), data.range.size() * sizeof(uint32_t));
+        is.read(reinterpret_cast<char*>(data.indirection.data()), data.indirection.size() * sizeof(uint32_t));
+        is.read(reinterpret_cast<char*>(data.atlas.data()), data.atlas.size());
+        if (!is) return {};
+        return data;
+    }
+}
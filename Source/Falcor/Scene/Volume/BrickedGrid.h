@@ -26,7 +26,14 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
 #include "Core/API/Texture.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/Math/Vector.h"
+#include <filesystem>
+#include <optional>
+#include <vector>
 
 namespace Falcor
 {
@@ -36,4 +43,37 @@ namespace Falcor
         Texture::SharedPtr indirection;
         Texture::SharedPtr atlas;
     };
+
+    /** CPU side data of a bricked grid, as produced by NanoVDBToBricksConverter.
+    */
+    struct FALCOR_API BrickedGridData
+    {
+        uint3 leafDim = uint3(0);           ///< Size of the range and indirection textures in bricks.
+        uint3 atlasSize = uint3(0);         ///< Size of the atlas texture in voxels.
+        ResourceFormat atlasFormat = ResourceFormat::Unknown;
+        uint32_t brickCount = 0;            ///< Number of bricks stored in the atlas.
+        std::vector<uint32_t> range;        ///< Range texture data (RG16Float, 4 mip levels).
+        std::vector<uint32_t> indirection;  ///< Indirection texture data (RGBA8Uint).
+        std::vector<uint8_t> atlas;         ///< Atlas texture data.
+
+        /** Create the GPU textures.
+            \param[in] pDevice GPU device.
+            \return The bricked grid.
+        */
+        BrickedGrid createTextures(Device* pDevice) const;
+
+        /** Write the data to a file.
+            \param[in] path File path.
+            \param[in] key Key identifying the source grid and conversion settings.
+            \return True if successful.
+        */
+        bool write(const std::filesystem::path& path, const SHA1::MD& key) const;
+
+        /** Read the data from a file.
+            \param[in] path File path.
+            \param[in] key Key identifying the source grid and conversion settings.
+            \return The data, or an empty optional if the file does not exist, is invalid or was written with a different key.
+        */
+        static std::optional<BrickedGridData> read(const std::filesystem::path& path, const SHA1::MD& key);
+    };
 }
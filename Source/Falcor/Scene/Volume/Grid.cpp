@@ -30,6 +30,7 @@
 #include "Core/API/Device.h"
 #include "Core/Program/ShaderVar.h"
 #include "Utils/StringUtils.h"
+#include "Utils/CryptoUtils.h"
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/Common.h"
@@ -76,40 +77,62 @@ namespace Falcor
         }
     }
 
+    uint64_t Grid::HostData::getSizeInBytes() const
+    {
+        return gridHandle.size() + brickedGrid.range.size() * sizeof(uint32_t) + brickedGrid.indirection.size() * sizeof(uint32_t) + brickedGrid.atlas.size();
+    }
+
     Grid::SharedPtr Grid::createSphere(std::shared_ptr<Device> pDevice, float radius, float voxelSize, float blendRange)
     {
         auto handle = nanovdb::createFogVolumeSphere<float>(radius, nanovdb::Vec3f(0.f), voxelSize, blendRange);
-        return SharedPtr(new Grid(std::move(pDevice), std::move(handle)));
+        return create(std::move(pDevice), createHostData(std::move(handle)));
     }
 
     Grid::SharedPtr Grid::createBox(std::shared_ptr<Device> pDevice, float width, float height, float depth, float voxelSize, float blendRange)
     {
         auto handle = nanovdb::createFogVolumeBox<float>(width, height, depth, nanovdb::Vec3f(0.f), voxelSize, blendRange);
-        return SharedPtr(new Grid(std::move(pDevice), std::move(handle)));
+        return create(std::move(pDevice), createHostData(std::move(handle)));
     }
 
-    Grid::SharedPtr Grid::createFromFile(std::shared_ptr<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    Grid::SharedPtr Grid::createFromFile(std::shared_ptr<Device> pDevice, const std::filesystem::path& path, const std::string& gridname, bool cacheBricks)
+    {
+        auto hostData = loadHostDataFromFile(path, gridname, cacheBricks);
+        return hostData ? create(std::move(pDevice), std::move(*hostData)) : nullptr;
+    }
+
+    std::optional<Grid::HostData> Grid::loadHostDataFromFile(const std::filesystem::path& path, const std::string& gridname, bool cacheBricks)
     {
         std::filesystem::path fullPath;
         if (!findFileInDataDirectories(path, fullPath))
         {
             logWarning("Error when loading grid. Can't find grid file '{}'.", path);
-            return nullptr;
+            return {};
         }
 
+        std::optional<nanovdb::GridHandle<nanovdb::HostBuffer>> handle;
         if (hasExtension(fullPath, "nvdb"))
         {
-            return createFromNanoVDBFile(std::move(pDevice), fullPath, gridname);
+            handle = readNanoVDBFile(fullPath, gridname);
         }
         else if (hasExtension(fullPath, "vdb"))
         {
-            return createFromOpenVDBFile(std::move(pDevice), fullPath, gridname);
+            handle = readOpenVDBFile(fullPath, gridname);
         }
         else
         {
             logWarning("Error when loading grid. Unsupported grid file '{}'.", fullPath);
-            return nullptr;
         }
+        if (!handle) return {};
+
+        std::filesystem::path brickCachePath;
+        if (cacheBricks) brickCachePath = fullPath.string() + "." + gridname + ".bricks";
+
+        return createHostData(std::move(*handle), brickCachePath);
+    }
+
+    Grid::SharedPtr Grid::create(std::shared_ptr<Device> pDevice, HostData hostData)
+    {
+        return SharedPtr(new Grid(std::move(pDevice), std::move(hostData)));
     }
 
     void Grid::renderUI(Gui::Widgets& widget)
@@ -202,17 +225,12 @@ namespace Falcor
         return rmcv::translate(rmcv::mat4(invAffine), -translation);
     }
 
-    Grid::Grid(std::shared_ptr<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle)
+    Grid::Grid(std::shared_ptr<Device> pDevice, HostData hostData)
         : mpDevice(std::move(pDevice))
-        , mGridHandle(std::move(gridHandle))
+        , mGridHandle(std::move(hostData.gridHandle))
         , mpFloatGrid(mGridHandle.grid<float>())
         , mAccessor(mpFloatGrid->getAccessor())
     {
-        if (!mpFloatGrid->hasMinMax())
-        {
-            nanovdb::gridStats(*mpFloatGrid);
-        }
-
         // Keep both NanoVDB and brick textures resident in GPU memory for simplicity for now (~15% increased footprint).
         mpBuffer = Buffer::createStructured(
             mpDevice.get(),
@@ -222,42 +240,76 @@ namespace Falcor
             Buffer::CpuAccess::None,
             mGridHandle.data()
         );
+        mBrickedGrid = hostData.brickedGrid.createTextures(mpDevice.get());
+    }
+
+    Grid::HostData Grid::createHostData(nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle, const std::filesystem::path& brickCachePath)
+    {
+        HostData hostData;
+        hostData.gridHandle = std::move(gridHandle);
+
+        nanovdb::FloatGrid* pFloatGrid = hostData.gridHandle.grid<float>();
+        if (!pFloatGrid->hasMinMax())
+        {
+            nanovdb::gridStats(*pFloatGrid);
+        }
+
         using NanoVDBGridConverter = NanoVDBConverterBC4;
-        mBrickedGrid = NanoVDBGridConverter(mpFloatGrid).convert(mpDevice.get());
+        if (brickCachePath.empty())
+        {
+            hostData.brickedGrid = NanoVDBGridConverter(pFloatGrid).convertToData();
+            return hostData;
+        }
+
+        // The cached bricks are keyed by the grid contents and the conversion settings.
+        SHA1 sha1;
+        sha1.update(hostData.gridHandle.data(), hostData.gridHandle.size());
+        sha1.update(NanoVDBGridConverter::kVersion);
+        sha1.update((uint32_t)NanoVDBGridConverter::getAtlasFormat());
+        const SHA1::MD key = sha1.finalize();
+
+        auto data = BrickedGridData::read(brickCachePath, key);
+        if (!data)
+        {
+            data = NanoVDBGridConverter(pFloatGrid).convertToData();
+            data->write(brickCachePath, key);
+        }
+        hostData.brickedGrid = std::move(*data);
+        return hostData;
     }
 
-    Grid::SharedPtr Grid::createFromNanoVDBFile(std::shared_ptr<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    std::optional<nanovdb::GridHandle<nanovdb::HostBuffer>> Grid::readNanoVDBFile(const std::filesystem::path& path, const std::string& gridname)
     {
         if (!nanovdb::io::hasGrid(path.string(), gridname))
         {
             logWarning("Error when loading grid. Can't find grid '{}' in '{}'.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         auto handle = nanovdb::io::readGrid(path.string(), gridname);
         if (!handle)
         {
             logWarning("Error when loading grid.");
-            return nullptr;
+            return {};
         }
 
         auto floatGrid = handle.grid<float>();
         if (!floatGrid || floatGrid->gridType() != nanovdb::GridType::Float)
         {
             logWarning("Error when loading grid. Grid '{}' in '{}' is not of type float.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (floatGrid->isEmpty())
         {
             logWarning("Grid '{}' in '{}' is empty.", gridname, path);
-            return nullptr;
+            return {};
         }
 
-        return SharedPtr(new Grid(std::move(pDevice), std::move(handle)));
+        return handle;
     }
 
-    Grid::SharedPtr Grid::createFromOpenVDBFile(std::shared_ptr<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    std::optional<nanovdb::GridHandle<nanovdb::HostBuffer>> Grid::readOpenVDBFile(const std::filesystem::path& path, const std::string& gridname)
     {
         openvdb::initialize();
 
@@ -279,25 +331,23 @@ namespace Falcor
         if (!baseGrid)
         {
             logWarning("Error when loading grid. Can't find grid '{}' in '{}'.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (!baseGrid->isType<openvdb::FloatGrid>())
         {
             logWarning("Error when loading grid. Grid '{}' in '{}' is not of type float.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (baseGrid->empty())
         {
             logWarning("Grid '{}' in '{}' is empty.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         openvdb::FloatGrid::Ptr floatGrid = openvdb::gridPtrCast<openvdb::FloatGrid>(baseGrid);
-        auto handle = nanovdb::openToNanoVDB(floatGrid);
-
-        return SharedPtr(new Grid(std::move(pDevice), std::move(handle)));
+        return nanovdb::openToNanoVDB(floatGrid);
     }
 
 
@@ -326,10 +376,10 @@ namespace Falcor
         };
         grid.def_static("createBox", createBox, "width"_a, "height"_a, "depth"_a, "voxelSize"_a, "blendRange"_a = 3.f); // PYTHONDEPRECATED
 
-        auto createFromFile = [] (const std::filesystem::path& path, const std::string& gridname)
+        auto createFromFile = [] (const std::filesystem::path& path, const std::string& gridname, bool cacheBricks)
         {
-            return Grid::createFromFile(getActivePythonSceneBuilder().getDevice(), path, gridname);
+            return Grid::createFromFile(getActivePythonSceneBuilder().getDevice(), path, gridname, cacheBricks);
         };
-        grid.def_static("createFromFile", createFromFile, "path"_a, "gridname"_a); // PYTHONDEPRECATED
+        grid.def_static("createFromFile", createFromFile, "path"_a, "gridname"_a, "cacheBricks"_a = false); // PYTHONDEPRECATED
     }
 }
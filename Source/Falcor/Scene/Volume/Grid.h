@@ -47,6 +47,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace Falcor
@@ -60,6 +61,19 @@ namespace Falcor
     public:
         using SharedPtr = std::shared_ptr<Grid>;
 
+        /** Host-side data of a grid, i.e. the NanoVDB grid and its converted bricks.
+            This is everything needed to create a grid and can be prepared without accessing the GPU device.
+        */
+        struct HostData
+        {
+            nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle;
+            BrickedGridData brickedGrid;
+
+            /** Get the size of the host data in bytes.
+            */
+            uint64_t getSizeInBytes() const;
+        };
+
         /** Create a sphere voxel grid.
             \param[in] pDevice GPU device.
             \param[in] radius Radius of the sphere in world units.
@@ -85,9 +99,27 @@ namespace Falcor
             \param[in] pDevice GPU device.
             \param[in] path File path of the grid. Can also include a full path or relative path from a data directory.
             \param[in] gridname Name of the grid to load.
+            \param[in] cacheBricks Cache the converted bricks in a file next to the grid file ('<file>.<gridname>.bricks').
+                The cache is keyed by a hash of the grid contents and reconverted if the grid changes.
             \return A new grid, or nullptr if the grid failed to load.
         */
-        static SharedPtr createFromFile(std::shared_ptr<Device> pDevice, const std::filesystem::path& path, const std::string& gridname);
+        static SharedPtr createFromFile(std::shared_ptr<Device> pDevice, const std::filesystem::path& path, const std::string& gridname, bool cacheBricks = false);
+
+        /** Load the host-side data of a grid from a file.
+            This does not access the GPU device and is safe to call from multiple threads concurrently.
+            \param[in] path File path of the grid. Can also include a full path or relative path from a data directory.
+            \param[in] gridname Name of the grid to load.
+            \param[in] cacheBricks Cache the converted bricks in a file next to the grid file (see createFromFile()).
+            \return The host data, or an empty optional if the grid failed to load.
+        */
+        static std::optional<HostData> loadHostDataFromFile(const std::filesystem::path& path, const std::string& gridname, bool cacheBricks = false);
+
+        /** Create a grid from host data.
+            \param[in] pDevice GPU device.
+            \param[in] hostData Host data, for example loaded with loadHostDataFromFile().
+            \return A new grid.
+        */
+        static SharedPtr create(std::shared_ptr<Device> pDevice, HostData hostData);
 
         /** Render the UI.
         */
@@ -145,10 +177,11 @@ namespace Falcor
         rmcv::mat4 getInvTransform() const;
 
     private:
-        Grid(std::shared_ptr<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle);
+        Grid(std::shared_ptr<Device> pDevice, HostData hostData);
 
-        static SharedPtr createFromNanoVDBFile(std::shared_ptr<Device>, const std::filesystem::path& path, const std::string& gridname);
-        static SharedPtr createFromOpenVDBFile(std::shared_ptr<Device>, const std::filesystem::path& path, const std::string& gridname);
+        static HostData createHostData(nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle, const std::filesystem::path& brickCachePath = {});
+        static std::optional<nanovdb::GridHandle<nanovdb::HostBuffer>> readNanoVDBFile(const std::filesystem::path& path, const std::string& gridname);
+        static std::optional<nanovdb::GridHandle<nanovdb::HostBuffer>> readOpenVDBFile(const std::filesystem::path& path, const std::string& gridname);
 
         std::shared_ptr<Device> mpDevice;
 
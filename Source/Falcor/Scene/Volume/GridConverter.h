@@ -31,7 +31,7 @@
 #include "Core/API/Formats.h"
 #include "Utils/Logger.h"
 #include "Utils/HostDeviceShared.slangh"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Timing/CpuTimer.h"
 
@@ -45,8 +45,6 @@
 #endif
 
 #include <algorithm>
-#include <atomic>
-#include <execution>
 #include <vector>
 
 namespace Falcor
@@ -60,23 +58,23 @@ namespace Falcor
     struct NanoVDBToBricksConverter
     {
     public:
+        /** Version of the conversion. Increment when the output changes, this invalidates cached bricks.
+        */
+        static constexpr uint32_t kVersion = 2;
+
         NanoVDBToBricksConverter(const nanovdb::FloatGrid* grid);
         NanoVDBToBricksConverter(const NanoVDBToBricksConverter& rhs) = delete;
 
-        BrickedGrid convert(Device* pDevice);
-
-    private:
-        const static uint32_t kBrickSize = 8; // Must be 8, to match both NanoVDB leaf size.
-        const static int32_t kBC4Compress = kBitsPerTexel == 4;
+        /** Convert the grid to bricks on the CPU.
+            The bricks are stored in the atlas in the order of the leaves (x fastest, then y, then z),
+            so the output is deterministic and independent of the number of threads.
+        */
+        BrickedGridData convertToData();
 
-        void convertSlice(int z);
-        void computeMip(int mip);
-
-        inline uint3 getAtlasSizeBricks() const { return mAtlasSizeBricks; }
-        inline uint3 getAtlasSizePixels() const { return mAtlasSizeBricks * kBrickSize; }
-        inline uint32_t getAtlasMaxBrick() const { return mAtlasSizeBricks.x * mAtlasSizeBricks.y * mAtlasSizeBricks.z; }
+        BrickedGrid convert(Device* pDevice) { return convertToData().createTextures(pDevice); }
 
-        inline ResourceFormat getAtlasFormat() {
+        static ResourceFormat getAtlasFormat()
+        {
             switch (kBitsPerTexel) {
             case 4: return ResourceFormat::BC4Unorm;
             case 8: return ResourceFormat::R8Unorm;
@@ -85,6 +83,18 @@ namespace Falcor
             }
         }
 
+    private:
+        const static uint32_t kBrickSize = 8; // Must be 8, to match both NanoVDB leaf size.
+        const static int32_t kBC4Compress = kBitsPerTexel == 4;
+
+        uint32_t computeSliceRanges(int z);
+        void fillSliceBricks(int z, uint32_t firstBrick);
+        void computeMipSlice(int mip, int z);
+
+        inline uint3 getAtlasSizeBricks() const { return mAtlasSizeBricks; }
+        inline uint3 getAtlasSizePixels() const { return mAtlasSizeBricks * kBrickSize; }
+        inline uint32_t getAtlasMaxBrick() const { return mAtlasSizeBricks.x * mAtlasSizeBricks.y * mAtlasSizeBricks.z; }
+
         inline float2 combineMajMin(float2 a, float2 b)
         {
             return float2(std::max(a.x, b.x), std::min(a.y, b.y));
@@ -107,16 +117,15 @@ namespace Falcor
         int3 mLeafDim[4];
         int3 mBBMin, mBBMax, mPixDim;
         uint32_t mLeafCount[4];
+        uint32_t mBrickCount = 0;
         std::vector<uint32_t> mRangeData;
         std::vector<uint32_t> mPtrData;
-        std::vector<TexelType> mAtlasData;
-        std::atomic_uint32_t mNonEmptyCount;
+        std::vector<uint8_t> mAtlasData;
     };
 
     template <typename TexelType, unsigned int kBitsPerTexel>
     NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::NanoVDBToBricksConverter(const nanovdb::FloatGrid* grid)
     {
-        mNonEmptyCount.store(0);
         mpFloatGrid = grid;
         auto& voxelbox = mpFloatGrid->indexBBox();
         mBBMin = (int3(voxelbox.min().x(), voxelbox.min().y(), voxelbox.min().z())) & (~7);
@@ -133,23 +142,21 @@ namespace Falcor
         uint lastdim = (leafCount + approxdim * approxdim - 1) / (approxdim * approxdim);
         mAtlasSizeBricks = uint3(approxdim, approxdim, lastdim);
         uint3 atlasSizePixels = getAtlasSizePixels();
-        uint leafTexelCount = atlasSizePixels.x * atlasSizePixels.y * atlasSizePixels.z;
+        size_t leafTexelCount = size_t(atlasSizePixels.x) * atlasSizePixels.y * atlasSizePixels.z;
         mRangeData.resize(mLeafCount[3]);
         mPtrData.resize(mLeafCount[0]);
-        mAtlasData.resize(kBC4Compress ? (leafTexelCount / 16) : leafTexelCount);
+        mAtlasData.resize(kBC4Compress ? (leafTexelCount / 16) * sizeof(uint64_t) : leafTexelCount * sizeof(TexelType));
     }
 
     template <typename TexelType, unsigned int kBitsPerTexel>
-    void NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::convertSlice(int z)
+    uint32_t NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::computeSliceRanges(int z)
     {
-        uint3 atlasSizePixels = getAtlasSizePixels();
-        uint brickMax = getAtlasMaxBrick();
-        uint bricksPerSlice = mAtlasSizeBricks.x * mAtlasSizeBricks.y;
-        uint pixelsPerSlice = atlasSizePixels.x * atlasSizePixels.y;
-
+        // First pass: compute the value range of all leaves in the slice and mark the ones that need a brick (pointer 1).
+        // Bricks are allocated in the second pass, after the bricks per slice are known.
         size_t offset = z * mLeafDim[0].x * mLeafDim[0].y;
         uint32_t* rangedst = mRangeData.data() + offset;
         uint32_t* ptrdst = mPtrData.data() + offset;
+        uint32_t brickCount = 0;
         auto a = mpFloatGrid->getAccessor();
         for (int y = 0; y < mLeafDim[0].y; ++y)
         {
@@ -159,7 +166,6 @@ namespace Falcor
                 auto val = a.getValue(ijk);
                 auto leaf = a.probeLeaf(ijk);
                 float minorant = val, majorant = val;
-                uint myleaf = 0;
                 if (leaf)
                 {
                     // Nanovdb only stores minorant/majorant for active voxels, but we need all of them... Grab the central 8x8x8 first the quick way.
@@ -176,82 +182,111 @@ namespace Falcor
                     for (int j = -1; j <= kBrickSize; ++j) expandMinorantMajorant(a.getValue(ijk + nanovdb::Coord(kBrickSize, j, -1)), minorant, majorant);
                     for (int j = -1; j <= kBrickSize; ++j) expandMinorantMajorant(a.getValue(ijk + nanovdb::Coord(-1, j, kBrickSize)), minorant, majorant);
                     for (int j = -1; j <= kBrickSize; ++j) expandMinorantMajorant(a.getValue(ijk + nanovdb::Coord(kBrickSize, j, kBrickSize)), minorant, majorant);
-
-                    if (minorant != majorant) myleaf = mNonEmptyCount.fetch_add(1);
                 }
-                if (majorant == minorant || myleaf >= brickMax || leaf == nullptr)
+                if (majorant == minorant || leaf == nullptr)
                 {
                     *rangedst++ = f32tof16(majorant) + (f32tof16(majorant) << 16); // force identical major and minor
                     *ptrdst++ = 0;
                 }
                 else
                 {
-                    const float* data = leaf->data()->mValues;
-                    majorant = f16tof32(f32tof16(majorant) + 1);
-                    minorant = f16tof32(f32tof16(minorant));
-                    *rangedst++ = f32tof16(majorant) + (f32tof16(minorant) << 16);
-                    uint32_t atlasx = myleaf % mAtlasSizeBricks.x;
-                    uint32_t atlasy = (myleaf / mAtlasSizeBricks.x) % mAtlasSizeBricks.y;
-                    uint32_t atlasz = myleaf / bricksPerSlice;
-                    *ptrdst++ = (atlasx + (atlasy << 8) + (atlasz << 16));
-
-                    if (!kBC4Compress) {
-                        float invRange = ((1 << kBitsPerTexel) - 1.f) / (majorant - minorant);
-                        TexelType* atlasdst = (TexelType*)mAtlasData.data() + atlasx * kBrickSize + atlasy * (atlasSizePixels.x * kBrickSize) + atlasz * (pixelsPerSlice * kBrickSize);
-                        for (int pixz = 0; pixz < kBrickSize; ++pixz)
+                    // Round the range outwards to half precision. The second pass quantizes the voxels to the rounded range.
+                    *rangedst++ = (f32tof16(majorant) + 1) + (f32tof16(minorant) << 16);
+                    *ptrdst++ = 1;
+                    brickCount++;
+                }
+            } // x brick loop
+        } // y brick loop
+        return brickCount;
+    }
+
+    template <typename TexelType, unsigned int kBitsPerTexel>
+    void NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::fillSliceBricks(int z, uint32_t firstBrick)
+    {
+        uint3 atlasSizePixels = getAtlasSizePixels();
+        uint brickMax = getAtlasMaxBrick();
+        uint bricksPerSlice = mAtlasSizeBricks.x * mAtlasSizeBricks.y;
+        size_t pixelsPerSlice = size_t(atlasSizePixels.x) * atlasSizePixels.y;
+
+        size_t offset = z * mLeafDim[0].x * mLeafDim[0].y;
+        uint32_t* rangedst = mRangeData.data() + offset;
+        uint32_t* ptrdst = mPtrData.data() + offset;
+        uint32_t myleaf = firstBrick;
+        auto a = mpFloatGrid->getAccessor();
+        for (int y = 0; y < mLeafDim[0].y; ++y)
+        {
+            for (int x = 0; x < mLeafDim[0].x; ++x, ++rangedst, ++ptrdst)
+            {
+                if (*ptrdst == 0) continue;
+
+                if (myleaf >= brickMax)
+                {
+                    // Out of atlas space, store the brick as a constant (undo the rounding of the majorant).
+                    uint32_t majorant16 = (*rangedst & 0xffff) - 1;
+                    *rangedst = majorant16 + (majorant16 << 16);
+                    *ptrdst = 0;
+                    continue;
+                }
+
+                nanovdb::Coord ijk = { x * 8 + mBBMin.x, y * 8 + mBBMin.y, z * 8 + mBBMin.z };
+                const float* data = a.probeLeaf(ijk)->data()->mValues;
+                float majorant = f16tof32(*rangedst & 0xffff);
+                float minorant = f16tof32(*rangedst >> 16);
+                uint32_t atlasx = myleaf % mAtlasSizeBricks.x;
+                uint32_t atlasy = (myleaf / mAtlasSizeBricks.x) % mAtlasSizeBricks.y;
+                uint32_t atlasz = myleaf / bricksPerSlice;
+                *ptrdst = (atlasx + (atlasy << 8) + (atlasz << 16));
+                myleaf++;
+
+                if (!kBC4Compress) {
+                    float invRange = ((1 << kBitsPerTexel) - 1.f) / (majorant - minorant);
+                    TexelType* atlasdst = (TexelType*)mAtlasData.data() + atlasx * kBrickSize + atlasy * (atlasSizePixels.x * kBrickSize) + atlasz * (pixelsPerSlice * kBrickSize);
+                    for (int pixz = 0; pixz < kBrickSize; ++pixz)
+                    {
+                        for (int pixy = 0; pixy < kBrickSize; ++pixy)
                         {
-                            for (int pixy = 0; pixy < kBrickSize; ++pixy)
+                            for (int pixx = 0; pixx < kBrickSize; ++pixx)
                             {
-                                for (int pixx = 0; pixx < kBrickSize; ++pixx)
-                                {
-                                    float f = data[pixx * kBrickSize * kBrickSize + pixy * kBrickSize + pixz];
-                                    *atlasdst++ = TexelType((f - minorant) * invRange);
-                                }
-                                atlasdst += (atlasSizePixels.x - kBrickSize); // next scanline
+                                float f = data[pixx * kBrickSize * kBrickSize + pixy * kBrickSize + pixz];
+                                *atlasdst++ = TexelType((f - minorant) * invRange);
                             }
-                            atlasdst += (pixelsPerSlice - (atlasSizePixels.x * kBrickSize)); // next slice
+                            atlasdst += (atlasSizePixels.x - kBrickSize); // next scanline
                         }
+                        atlasdst += (pixelsPerSlice - (atlasSizePixels.x * kBrickSize)); // next slice
                     }
-                    else {
-                        // BC4 compression:
-                        float invRange = (255.f) / (majorant - minorant);
-                        uint64_t* atlasdst = ((uint64_t*)mAtlasData.data() + atlasx * (kBrickSize / 4) + atlasy * ((atlasSizePixels.x / 4) * kBrickSize / 4) + atlasz * (pixelsPerSlice / 16 * kBrickSize));
-                        for (int pixz = 0; pixz < kBrickSize; ++pixz)
+                }
+                else {
+                    // BC4 compression:
+                    float invRange = (255.f) / (majorant - minorant);
+                    uint64_t* atlasdst = ((uint64_t*)mAtlasData.data() + atlasx * (kBrickSize / 4) + atlasy * ((atlasSizePixels.x / 4) * kBrickSize / 4) + atlasz * (pixelsPerSlice / 16 * kBrickSize));
+                    for (int pixz = 0; pixz < kBrickSize; ++pixz)
+                    {
+                        for (int tiley = 0; tiley < kBrickSize; tiley += 4)
                         {
-                            for (int tiley = 0; tiley < kBrickSize; tiley += 4)
-                            {
-                                for (int tilex = 0; tilex < kBrickSize; tilex += 4) {
-                                    uint8_t tilevals[4][4];
-                                    uint8_t tileminorant = 255, tilemajorant = 0;
-                                    for (int pixy = 0; pixy < 4; ++pixy)
+                            for (int tilex = 0; tilex < kBrickSize; tilex += 4) {
+                                uint8_t tilevals[4][4];
+                                for (int pixy = 0; pixy < 4; ++pixy)
+                                {
+                                    for (int pixx = 0; pixx < 4; ++pixx)
                                     {
-                                        for (int pixx = 0; pixx < 4; ++pixx)
-                                        {
-                                            float f = data[(pixx + tilex) * (kBrickSize * kBrickSize) + (pixy + tiley) * kBrickSize + pixz];
-                                            uint8_t voxel = uint8_t((f - minorant) * invRange);
-                                            tileminorant = std::min(tileminorant, voxel);
-                                            tilemajorant = std::max(tilemajorant, voxel);
-                                            tilevals[pixy][pixx] = voxel;
-                                        }
+                                        float f = data[(pixx + tilex) * (kBrickSize * kBrickSize) + (pixy + tiley) * kBrickSize + pixz];
+                                        tilevals[pixy][pixx] = uint8_t((f - minorant) * invRange);
                                     }
-                                    CompressAlphaDxt5((uint8_t*)&tilevals[0][0], atlasdst);
-                                    atlasdst++;
                                 }
-                                atlasdst += (atlasSizePixels.x / 4 - kBrickSize / 4); // next scanline
+                                *atlasdst++ = encodeBC4Block(&tilevals[0][0]);
                             }
-                            atlasdst += (pixelsPerSlice / 16 - (atlasSizePixels.x / 4 * kBrickSize / 4)); // next slice
-                        } // z slice loop
-                    } // bc4 compress?
-                } // non empty brick?
+                            atlasdst += (atlasSizePixels.x / 4 - kBrickSize / 4); // next scanline
+                        }
+                        atlasdst += (pixelsPerSlice / 16 - (atlasSizePixels.x / 4 * kBrickSize / 4)); // next slice
+                    } // z slice loop
+                } // bc4 compress?
             } // x brick loop
         } // y brick loop
     }
 
     template <typename TexelType, unsigned int kBitsPerTexel>
-    void NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::computeMip(int mip)
+    void NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::computeMipSlice(int mip, int z)
     {
-        uint32_t* rangedst = mRangeData.data() + mLeafCount[mip - 1];
-        uint32_t* rangesrc = mRangeData.data() + ((mip > 1) ? mLeafCount[mip - 2] : 0);
         int3 leafdim_src = mLeafDim[mip - 1];
         uint32_t rowstride_src = leafdim_src.x;
         uint32_t slicestride_src = leafdim_src.y * rowstride_src;
@@ -260,42 +295,65 @@ namespace Falcor
         uint32_t rowstride_tgt = leafdim_tgt.x;
         uint32_t slicestride_tgt = leafdim_tgt.y * rowstride_tgt;
 
-        for (int z = 0; z < leafdim_tgt.z; ++z, rangesrc += slicestride_src)
+        // Each target slice reduces two source slices.
+        uint32_t* rangedst = mRangeData.data() + mLeafCount[mip - 1] + z * slicestride_tgt;
+        const uint32_t* rangesrc = mRangeData.data() + ((mip > 1) ? mLeafCount[mip - 2] : 0) + 2 * z * slicestride_src;
+
+        for (int y = 0; y < leafdim_tgt.y; ++y, rangesrc += rowstride_src)
         {
-            for (int y = 0; y < leafdim_tgt.y; ++y, rangesrc += rowstride_src)
+            for (int x = 0; x < leafdim_tgt.x; ++x, rangesrc += 2)
             {
-                for (int x = 0; x < leafdim_tgt.x; ++x, rangesrc += 2)
-                {
-                    float2 majmin_dst = combineMajMin(
-                        combineMajMin(
-                            combineMajMin(unpackMajMin(rangesrc), unpackMajMin(rangesrc + 1)),
-                            combineMajMin(unpackMajMin(rangesrc + rowstride_src), unpackMajMin(rangesrc + 1 + rowstride_src))
-                        ),
-                        combineMajMin(
-                            combineMajMin(unpackMajMin(rangesrc + slicestride_src), unpackMajMin(rangesrc + slicestride_src + 1)),
-                            combineMajMin(unpackMajMin(rangesrc + slicestride_src + rowstride_src), unpackMajMin(rangesrc + slicestride_src + 1 + rowstride_src))
-                        )
-                    );
-                    *rangedst++ = f32tof16(majmin_dst.x) + (f32tof16(majmin_dst.y) << 16);
-                } // x
-            } // y
-        } // z
+                float2 majmin_dst = combineMajMin(
+                    combineMajMin(
+                        combineMajMin(unpackMajMin(rangesrc), unpackMajMin(rangesrc + 1)),
+                        combineMajMin(unpackMajMin(rangesrc + rowstride_src), unpackMajMin(rangesrc + 1 + rowstride_src))
+                    ),
+                    combineMajMin(
+                        combineMajMin(unpackMajMin(rangesrc + slicestride_src), unpackMajMin(rangesrc + slicestride_src + 1)),
+                        combineMajMin(unpackMajMin(rangesrc + slicestride_src + rowstride_src), unpackMajMin(rangesrc + slicestride_src + 1 + rowstride_src))
+                    )
+                );
+                *rangedst++ = f32tof16(majmin_dst.x) + (f32tof16(majmin_dst.y) << 16);
+            } // x
+        } // y
     }
 
     template <typename TexelType, unsigned int kBitsPerTexel>
-    BrickedGrid NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::convert(Device* pDevice)
+    BrickedGridData NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::convertToData()
     {
         auto t0 = CpuTimer::getCurrentTimePoint();
-        auto range = NumericRange<int>(0, mLeafDim[0].z);
-        std::for_each(std::execution::par, range.begin(), range.end(), [&](int z) { convertSlice(z); });
-        for (int mip = 1; mip < 4; ++mip) computeMip(mip);
+
+        // Compute leaf ranges and count the bricks in each slice in parallel.
+        std::vector<uint32_t> sliceBricks(mLeafDim[0].z);
+        Threading::parallelFor(0, mLeafDim[0].z, [&](size_t z) { sliceBricks[z] = computeSliceRanges((int)z); }, 1);
+
+        // Allocate bricks in leaf order, which makes the atlas layout deterministic.
+        std::vector<uint32_t> firstBrick(mLeafDim[0].z);
+        uint32_t brickCount = 0;
+        for (size_t z = 0; z < sliceBricks.size(); ++z)
+        {
+            firstBrick[z] = brickCount;
+            brickCount += sliceBricks[z];
+        }
+        mBrickCount = std::min(brickCount, getAtlasMaxBrick());
+
+        Threading::parallelFor(0, mLeafDim[0].z, [&](size_t z) { fillSliceBricks((int)z, firstBrick[z]); }, 1);
+        for (int mip = 1; mip < 4; ++mip)
+        {
+            Threading::parallelFor(0, mLeafDim[mip].z, [&](size_t z) { computeMipSlice(mip, (int)z); }, 1);
+        }
+
         double dt = CpuTimer::calcDuration(t0, CpuTimer::getCurrentTimePoint());
-        logInfo("converted in {}ms: mNonEmptyCount {} vs max {}", dt, mNonEmptyCount, getAtlasMaxBrick());
+        logInfo("converted in {}ms: brick count {} vs max {}", dt, brickCount, getAtlasMaxBrick());
 
-        BrickedGrid bricks;
-        bricks.range = Texture::create3D(pDevice, mLeafDim[0].x, mLeafDim[0].y, mLeafDim[0].z, ResourceFormat::RG16Float, 4, mRangeData.data(), ResourceBindFlags::ShaderResource, false);
-        bricks.indirection = Texture::create3D(pDevice, mLeafDim[0].x, mLeafDim[0].y, mLeafDim[0].z, ResourceFormat::RGBA8Uint, 1, mPtrData.data(), ResourceBindFlags::ShaderResource, false);
-        bricks.atlas = Texture::create3D(pDevice, getAtlasSizePixels().x, getAtlasSizePixels().y, getAtlasSizePixels().z, getAtlasFormat(), 1, mAtlasData.data(), ResourceBindFlags::ShaderResource, false);
-        return bricks;
+        BrickedGridData data;
+        data.leafDim = uint3(mLeafDim[0]);
+        data.atlasSize = getAtlasSizePixels();
+        data.atlasFormat = getAtlasFormat();
+        data.brickCount = mBrickCount;
+        data.range = std::move(mRangeData);
+        data.indirection = std::move(mPtrData);
+        data.atlas = std::move(mAtlasData);
+        return data;
     }
 }
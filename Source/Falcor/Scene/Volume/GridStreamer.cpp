@@ -0,0 +1,346 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GridStreamer.h"
+#include "Core/Errors.h"
+#include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        std::optional<Grid::HostData> loadHostData(const std::filesystem::path& path, const std::string& gridname, bool cacheBricks)
+        {
+            try
+            {
+                return Grid::loadHostDataFromFile(path, gridname, cacheBricks);
+            }
+            catch (const std::exception& e)
+            {
+                logWarning("Error when streaming grid '{}' from '{}': {}", gridname, path, e.what());
+                return {};
+            }
+        }
+    }
+
+    GridStreamer::SharedPtr GridStreamer::create(std::shared_ptr<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const Options& options)
+    {
+        return SharedPtr(new GridStreamer(std::move(pDevice), paths, gridname, options));
+    }
+
+    GridStreamer::GridStreamer(std::shared_ptr<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const Options& options)
+        : mpDevice(std::move(pDevice))
+        , mPaths(paths)
+        , mGridname(gridname)
+        , mOptions(options)
+        , mFrames(paths.size())
+    {
+        checkArgument(!mPaths.empty(), "'paths' must not be empty");
+
+        runWorkers(mOptions.threadCount);
+    }
+
+    GridStreamer::~GridStreamer()
+    {
+        terminateWorkers();
+    }
+
+    void GridStreamer::renderUI(Gui::Widgets& widget)
+    {
+        const Stats stats = getStats();
+
+        std::ostringstream oss;
+        oss << "Frames: " << getFrameCount() << std::endl
+            << "Loaded frames: " << stats.loadedFrameCount << std::endl
+            << "Loaded memory: " << formatByteSize(stats.loadedMemoryInBytes) << " / " << formatByteSize(mOptions.memoryBudget) << std::endl
+            << "Hits: " << stats.hits << std::endl
+            << "Misses: " << stats.misses << std::endl
+            << "Prefetches: " << stats.prefetches << std::endl
+            << "Failures: " << stats.failures << std::endl
+            << "Evictions: " << stats.evictions << std::endl
+            << "Stall time: " << std::fixed << std::setprecision(1) << stats.stallTime << " ms" << std::endl;
+        widget.text(oss.str());
+    }
+
+    Grid::SharedPtr GridStreamer::getGrid(uint32_t frame)
+    {
+        checkArgument(frame < getFrameCount(), "'frame' ({}) is out of range", frame);
+
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        mCurrentFrame = frame;
+        Frame& f = mFrames[frame];
+        f.lastUsed = ++mRequestCounter;
+
+        if (f.state == FrameState::Loaded || f.state == FrameState::Resident)
+        {
+            mStats.hits++;
+        }
+        else if (f.state != FrameState::Failed)
+        {
+            mStats.misses++;
+            auto startTime = CpuTimer::getCurrentTimePoint();
+
+            if (f.state == FrameState::Loading)
+            {
+                mLoadCondition.wait(lock, [&] { return f.state != FrameState::Loading; });
+            }
+            else
+            {
+                // Load the frame on the calling thread instead of waiting for a worker to pick it up.
+                if (f.state == FrameState::Queued) mPrefetchQueue.erase(std::find(mPrefetchQueue.begin(), mPrefetchQueue.end(), frame));
+                f.state = FrameState::Loading;
+                lock.unlock();
+                auto hostData = loadHostData(mPaths[frame], mGridname, mOptions.cacheBricks);
+                lock.lock();
+                finishLoad(frame, std::move(hostData));
+            }
+
+            mStats.stallTime += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        }
+
+        // Create the GPU resources. Frames in the loaded state are only accessed from this thread.
+        if (f.state == FrameState::Loaded)
+        {
+            Grid::HostData hostData = std::move(*f.hostData);
+            f.hostData.reset();
+            lock.unlock();
+            auto pGrid = Grid::create(mpDevice, std::move(hostData));
+            lock.lock();
+            f.pGrid = pGrid;
+            f.sizeInBytes = pGrid->getGridHandle().size() + pGrid->getGridSizeInBytes();
+            f.state = FrameState::Resident;
+        }
+
+        Grid::SharedPtr pGrid = f.pGrid;
+
+        evictFrames();
+        schedulePrefetch();
+
+        return pGrid;
+    }
+
+    void GridStreamer::waitForPrefetch()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mLoadCondition.wait(lock, [&] { return mPrefetchQueue.empty() && mLoadingCount == 0; });
+    }
+
+    GridStreamer::Stats GridStreamer::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        Stats stats = mStats;
+        for (const auto& f : mFrames)
+        {
+            if (f.state == FrameState::Loaded || f.state == FrameState::Resident)
+            {
+                stats.loadedFrameCount++;
+                stats.loadedMemoryInBytes += f.sizeInBytes;
+            }
+        }
+        return stats;
+    }
+
+    void GridStreamer::runWorkers(uint32_t threadCount)
+    {
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            mThreads.emplace_back(&GridStreamer::runWorker, this);
+        }
+    }
+
+    void GridStreamer::runWorker()
+    {
+        while (true)
+        {
+            uint32_t frame;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWorkerCondition.wait(lock, [&] { return mTerminate || !mPrefetchQueue.empty(); });
+                if (mTerminate) break;
+
+                frame = mPrefetchQueue.front();
+                mPrefetchQueue.pop_front();
+                mFrames[frame].state = FrameState::Loading;
+                mLoadingCount++;
+            }
+
+            auto hostData = loadHostData(mPaths[frame], mGridname, mOptions.cacheBricks);
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (finishLoad(frame, std::move(hostData))) mStats.prefetches++;
+                mLoadingCount--;
+            }
+            mLoadCondition.notify_all();
+        }
+    }
+
+    void GridStreamer::terminateWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTerminate = true;
+        }
+
+        mWorkerCondition.notify_all();
+
+        for (auto& thread : mThreads) thread.join();
+        mThreads.clear();
+    }
+
+    bool GridStreamer::finishLoad(uint32_t frame, std::optional<Grid::HostData> hostData)
+    {
+        Frame& f = mFrames[frame];
+        if (hostData)
+        {
+            f.sizeInBytes = hostData->getSizeInBytes();
+            f.hostData = std::move(hostData);
+            f.state = FrameState::Loaded;
+            mLoadedSizeSum += f.sizeInBytes;
+            mLoadedSizeCount++;
+            return true;
+        }
+        else
+        {
+            f.state = FrameState::Failed;
+            mStats.failures++;
+            return false;
+        }
+    }
+
+    bool GridStreamer::isInWindow(uint32_t frame) const
+    {
+        // Playback wraps around, so the window does as well.
+        const uint32_t frameCount = getFrameCount();
+        const uint32_t distance = (frame + frameCount - mCurrentFrame) % frameCount;
+        return distance <= mOptions.framesAhead || frameCount - distance <= mOptions.framesBehind;
+    }
+
+    void GridStreamer::evictFrames()
+    {
+        auto isLoaded = [] (const Frame& f) { return f.state == FrameState::Loaded || f.state == FrameState::Resident; };
+
+        uint64_t loadedSize = 0;
+        for (const auto& f : mFrames) if (isLoaded(f)) loadedSize += f.sizeInBytes;
+
+        const uint32_t frameCount = getFrameCount();
+        while (loadedSize > mOptions.memoryBudget)
+        {
+            // Evict the least recently used frame outside of the window first.
+            // Frames in the window are evicted furthest ahead first, as they are needed last during playback.
+            std::optional<uint32_t> victim;
+            std::pair<uint32_t, uint64_t> victimOrder;
+            for (uint32_t frame = 0; frame < frameCount; ++frame)
+            {
+                if (frame == mCurrentFrame || !isLoaded(mFrames[frame])) continue;
+                const uint32_t distance = (frame + frameCount - mCurrentFrame) % frameCount;
+                auto order = isInWindow(frame) ? std::make_pair(1u, (uint64_t)(frameCount - distance)) : std::make_pair(0u, mFrames[frame].lastUsed);
+                if (!victim || order < victimOrder)
+                {
+                    victim = frame;
+                    victimOrder = order;
+                }
+            }
+            if (!victim) break;
+
+            Frame& f = mFrames[*victim];
+            loadedSize -= f.sizeInBytes;
+            f = Frame();
+            mStats.evictions++;
+        }
+    }
+
+    void GridStreamer::schedulePrefetch()
+    {
+        if (mThreads.empty()) return;
+
+        // Rebuild the queue for the current window.
+        for (uint32_t frame : mPrefetchQueue) mFrames[frame].state = FrameState::Unloaded;
+        mPrefetchQueue.clear();
+
+        // Collect the window in priority order, frames ahead first.
+        const uint32_t frameCount = getFrameCount();
+        std::vector<uint32_t> window;
+        for (uint32_t i = 0; i <= mOptions.framesAhead && i < frameCount; ++i) window.push_back((mCurrentFrame + i) % frameCount);
+        for (uint32_t i = 1; i <= mOptions.framesBehind && i < frameCount; ++i)
+        {
+            uint32_t frame = (mCurrentFrame + frameCount - i) % frameCount;
+            if (std::find(window.begin(), window.end(), frame) == window.end()) window.push_back(frame);
+        }
+
+        // Only queue as many frames as are expected to fit into the memory budget.
+        // The size of frames that were not loaded yet is estimated from the frames loaded so far.
+        const uint64_t estimatedSize = mLoadedSizeCount > 0 ? mLoadedSizeSum / mLoadedSizeCount : 0;
+        uint64_t windowSize = 0;
+        for (uint32_t frame : window)
+        {
+            const Frame& f = mFrames[frame];
+            if (f.state == FrameState::Loaded || f.state == FrameState::Resident) windowSize += f.sizeInBytes;
+            else if (f.state == FrameState::Loading) windowSize += estimatedSize;
+        }
+
+        for (uint32_t frame : window)
+        {
+            Frame& f = mFrames[frame];
+            if (f.state != FrameState::Unloaded) continue;
+            if (estimatedSize == 0 && !mPrefetchQueue.empty()) break;
+            if (windowSize + estimatedSize > mOptions.memoryBudget) break;
+            f.state = FrameState::Queued;
+            mPrefetchQueue.push_back(frame);
+            windowSize += estimatedSize;
+        }
+
+        if (!mPrefetchQueue.empty()) mWorkerCondition.notify_all();
+    }
+
+    FALCOR_SCRIPT_BINDING(GridStreamer)
+    {
+        pybind11::class_<GridStreamer::Stats> stats(m, "GridStreamerStats");
+        stats.def_readonly("hits", &GridStreamer::Stats::hits);
+        stats.def_readonly("misses", &GridStreamer::Stats::misses);
+        stats.def_readonly("prefetches", &GridStreamer::Stats::prefetches);
+        stats.def_readonly("failures", &GridStreamer::Stats::failures);
+        stats.def_readonly("evictions", &GridStreamer::Stats::evictions);
+        stats.def_readonly("stallTime", &GridStreamer::Stats::stallTime);
+        stats.def_readonly("loadedFrameCount", &GridStreamer::Stats::loadedFrameCount);
+        stats.def_readonly("loadedMemoryInBytes", &GridStreamer::Stats::loadedMemoryInBytes);
+
+        pybind11::class_<GridStreamer, GridStreamer::SharedPtr> streamer(m, "GridStreamer");
+        streamer.def_property_readonly("frameCount", &GridStreamer::getFrameCount);
+        streamer.def_property_readonly("gridname", &GridStreamer::getGridname);
+        streamer.def_property_readonly("stats", &GridStreamer::getStats);
+        streamer.def("waitForPrefetch", &GridStreamer::waitForPrefetch);
+    }
+}
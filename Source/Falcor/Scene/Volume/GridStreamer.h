@@ -0,0 +1,184 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Grid.h"
+#include "Core/Macros.h"
+#include "Utils/UI/Gui.h"
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+    /** Streams a sequence of grids from files.
+        Frames are loaded lazily on request. Worker threads prefetch a window of frames around the
+        last requested frame, and frames are evicted in least-recently-used order to stay within a memory budget.
+        The host-side work (reading and converting grids) runs on the worker threads, GPU resources are
+        created on the thread calling getGrid().
+    */
+    class FALCOR_API GridStreamer
+    {
+    public:
+        using SharedPtr = std::shared_ptr<GridStreamer>;
+
+        /** Streaming options.
+        */
+        struct Options
+        {
+            uint32_t framesAhead = 4;               ///< Number of frames after the requested frame to prefetch.
+            uint32_t framesBehind = 1;              ///< Number of frames before the requested frame to keep resident.
+            uint64_t memoryBudget = 4ull << 30;     ///< Memory budget in bytes for loaded frames (host and GPU). The requested frame is always kept.
+            uint32_t threadCount = 2;               ///< Number of worker threads. Frames are only loaded on request if zero.
+            bool cacheBricks = false;               ///< Cache the converted bricks in files next to the grid files (see Grid::createFromFile()).
+        };
+
+        /** Streaming statistics.
+        */
+        struct Stats
+        {
+            uint64_t hits = 0;                      ///< Number of requests for frames that were already loaded.
+            uint64_t misses = 0;                    ///< Number of requests for frames that had to be loaded or waited for.
+            uint64_t prefetches = 0;                ///< Number of frames successfully loaded by the worker threads.
+            uint64_t failures = 0;                  ///< Number of frames that failed to load.
+            uint64_t evictions = 0;                 ///< Number of frames evicted to stay within the memory budget.
+            double stallTime = 0.0;                 ///< Total time in ms spent waiting for frames on misses.
+            uint32_t loadedFrameCount = 0;          ///< Number of currently loaded frames.
+            uint64_t loadedMemoryInBytes = 0;       ///< Memory in bytes used by the currently loaded frames.
+        };
+
+        /** Create a grid streamer.
+            \param[in] pDevice GPU device.
+            \param[in] paths File paths of the grids, one per frame. Can also include full paths or relative paths from a data directory.
+            \param[in] gridname Name of the grid to load.
+            \param[in] options Streaming options.
+            \return A new grid streamer.
+        */
+        static SharedPtr create(std::shared_ptr<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const Options& options = Options());
+
+        /** Destructor.
+            Blocks until all worker threads have terminated.
+        */
+        ~GridStreamer();
+
+        /** Render the UI.
+        */
+        void renderUI(Gui::Widgets& widget);
+
+        /** Get the grid of a frame.
+            Blocks if the frame is not loaded yet and schedules prefetching of the frames around it.
+            Must be called from the thread owning the GPU device.
+            \param[in] frame Frame index.
+            \return The grid, or nullptr if the grid failed to load.
+        */
+        Grid::SharedPtr getGrid(uint32_t frame);
+
+        /** Block until all scheduled prefetches have finished.
+        */
+        void waitForPrefetch();
+
+        /** Get the number of frames in the sequence.
+        */
+        uint32_t getFrameCount() const { return (uint32_t)mPaths.size(); }
+
+        /** Get the file paths of the grids.
+        */
+        const std::vector<std::filesystem::path>& getPaths() const { return mPaths; }
+
+        /** Get the name of the streamed grid.
+        */
+        const std::string& getGridname() const { return mGridname; }
+
+        /** Get the streaming options.
+        */
+        const Options& getOptions() const { return mOptions; }
+
+        /** Get the streaming statistics.
+        */
+        Stats getStats() const;
+
+    private:
+        GridStreamer(std::shared_ptr<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const Options& options);
+
+        enum class FrameState
+        {
+            Unloaded,   ///< Frame is not loaded.
+            Queued,     ///< Frame is queued for prefetching.
+            Loading,    ///< Frame is being loaded.
+            Loaded,     ///< Host data is loaded, the grid is created on the next request.
+            Resident,   ///< Grid is created.
+            Failed,     ///< Frame failed to load.
+        };
+
+        struct Frame
+        {
+            FrameState state = FrameState::Unloaded;
+            std::optional<Grid::HostData> hostData;
+            Grid::SharedPtr pGrid;
+            uint64_t sizeInBytes = 0;
+            uint64_t lastUsed = 0;
+        };
+
+        void runWorkers(uint32_t threadCount);
+        void runWorker();
+        void terminateWorkers();
+
+        /** Store the loaded host data of a frame. Returns false if the frame failed to load.
+        */
+        bool finishLoad(uint32_t frame, std::optional<Grid::HostData> hostData);
+        bool isInWindow(uint32_t frame) const;
+        void evictFrames();
+        void schedulePrefetch();
+
+        std::shared_ptr<Device> mpDevice;
+        std::vector<std::filesystem::path> mPaths;
+        std::string mGridname;
+        Options mOptions;
+
+        mutable std::mutex mMutex;                  ///< Mutex for synchronizing access to shared resources.
+        std::condition_variable mWorkerCondition;   ///< Condition variable for workers to wait on.
+        std::condition_variable mLoadCondition;     ///< Condition variable signaled when a frame has finished loading.
+        std::vector<std::thread> mThreads;          ///< Worker threads.
+
+        // Internal state. Do not access outside of critical section.
+        std::vector<Frame> mFrames;                 ///< Per-frame state.
+        std::deque<uint32_t> mPrefetchQueue;        ///< Frames queued for prefetching, in priority order.
+        uint32_t mLoadingCount = 0;                 ///< Number of frames currently loaded by the workers.
+        uint32_t mCurrentFrame = 0;                 ///< Last requested frame.
+        uint64_t mRequestCounter = 0;               ///< Counter for tracking least recently used frames.
+        uint64_t mLoadedSizeSum = 0;                ///< Sum of the sizes of all frames loaded so far, used to estimate frame sizes.
+        uint64_t mLoadedSizeCount = 0;              ///< Number of frames loaded so far.
+        Stats mStats;
+        bool mTerminate = false;                    ///< Flag to terminate worker threads.
+    };
+}
@@ -31,8 +31,10 @@
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Scene/SceneBuilderAccess.h"
-#include <set>
+#include <algorithm>
 #include <filesystem>
+#include <optional>
+#include <set>
 
 namespace Falcor
 {
@@ -49,6 +51,39 @@ namespace Falcor
         const float kMaxAnisotropy = 0.99f;
         const double kMinFrameRate = 1.0;
         const double kMaxFrameRate = 1000.0;
+
+        std::optional<std::vector<std::filesystem::path>> findGridFiles(const std::filesystem::path& path)
+        {
+            std::filesystem::path fullPath;
+            if (!findFileInDataDirectories(path, fullPath))
+            {
+                logWarning("Cannot find directory '{}'.", path);
+                return {};
+            }
+            if (!std::filesystem::is_directory(fullPath))
+            {
+                logWarning("'{}' is not a directory.", path);
+                return {};
+            }
+
+            // Enumerate grid files.
+            std::vector<std::filesystem::path> paths;
+            for (auto p : std::filesystem::directory_iterator(fullPath))
+            {
+                const auto& path = p.path();
+                if (hasExtension(path, "nvdb") || hasExtension(path, "vdb")) paths.push_back(path);
+            }
+
+            // Sort by length first, then alpha-numerically.
+            auto cmp = [](const std::filesystem::path& a, const std::filesystem::path& b) {
+                auto sa = a.string();
+                auto sb = b.string();
+                return sa.length() != sb.length() ? sa.length() < sb.length() : sa < sb;
+            };
+            std::sort(paths.begin(), paths.end(), cmp);
+
+            return paths;
+        }
     }
 
     static_assert(sizeof(GridVolumeData) % 16 == 0, "GridVolumeData size should be a multiple of 16");
@@ -88,6 +123,10 @@ namespace Falcor
         if (const auto& densityGrid = getDensityGrid())
         {
             if (auto group = widget.group("Density Grid")) densityGrid->renderUI(group);
+            if (const auto& pStreamer = getGridStreamer(GridSlot::Density))
+            {
+                if (auto group = widget.group("Density Grid Streaming")) pStreamer->renderUI(group);
+            }
 
             float densityScale = getDensityScale();
             if (widget.var("Density scale", densityScale, 0.f, std::numeric_limits<float>::max(), 0.01f)) setDensityScale(densityScale);
@@ -96,6 +135,10 @@ namespace Falcor
         if (const auto& emissionGrid = getEmissionGrid())
         {
             if (auto group = widget.group("Emission Grid")) emissionGrid->renderUI(group);
+            if (const auto& pStreamer = getGridStreamer(GridSlot::Emission))
+            {
+                if (auto group = widget.group("Emission Grid Streaming")) pStreamer->renderUI(group);
+            }
 
             float emissionScale = getEmissionScale();
             if (widget.var("Emission scale", emissionScale, 0.f, std::numeric_limits<float>::max(), 0.01f)) setEmissionScale(emissionScale);
@@ -123,56 +166,48 @@ namespace Falcor
         return changed;
     }
 
-    bool GridVolume::loadGrid(GridSlot slot, const std::filesystem::path& path, const std::string& gridname)
+    bool GridVolume::loadGrid(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool cacheBricks)
     {
-        auto grid = Grid::createFromFile(mpDevice, path, gridname);
+        auto grid = Grid::createFromFile(mpDevice, path, gridname, cacheBricks);
         if (grid) setGrid(slot, grid);
         return grid != nullptr;
     }
 
-    uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty)
+    uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty, bool cacheBricks)
     {
         GridSequence grids;
         for (const auto& path : paths)
         {
-            auto grid = Grid::createFromFile(mpDevice, path, gridname);
+            auto grid = Grid::createFromFile(mpDevice, path, gridname, cacheBricks);
             if (keepEmpty || grid) grids.push_back(grid);
         }
         setGridSequence(slot, grids);
         return (uint32_t)grids.size();
     }
 
-    uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty)
+    uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty, bool cacheBricks)
     {
-        std::filesystem::path fullPath;
-        if (!findFileInDataDirectories(path, fullPath))
-        {
-            logWarning("Cannot find directory '{}'.", path);
-            return 0;
-        }
-        if (!std::filesystem::is_directory(fullPath))
-        {
-            logWarning("'{}' is not a directory.", path);
-            return 0;
-        }
+        auto paths = findGridFiles(path);
+        if (!paths) return 0;
+        return loadGridSequence(slot, *paths, gridname, keepEmpty, cacheBricks);
+    }
 
-        // Enumerate grid files.
-        std::vector<std::filesystem::path> paths;
-        for (auto p : std::filesystem::directory_iterator(fullPath))
+    uint32_t GridVolume::streamGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const GridStreamer::Options& options)
+    {
+        if (paths.empty())
         {
-            const auto& path = p.path();
-            if (hasExtension(path, "nvdb") || hasExtension(path, "vdb")) paths.push_back(path);
+            setGridSequence(slot, {});
+            return 0;
         }
+        setGridStreamer(slot, GridStreamer::create(mpDevice, paths, gridname, options));
+        return (uint32_t)paths.size();
+    }
 
-        // Sort by length first, then alpha-numerically.
-        auto cmp = [](const std::filesystem::path& a, const std::filesystem::path& b) {
-            auto sa = a.string();
-            auto sb = b.string();
-            return sa.length() != sb.length() ? sa.length() < sb.length() : sa < sb;
-        };
-        std::sort(paths.begin(), paths.end(), cmp);
-
-        return loadGridSequence(slot, paths, gridname, keepEmpty);
+    uint32_t GridVolume::streamGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, const GridStreamer::Options& options)
+    {
+        auto paths = findGridFiles(path);
+        if (!paths) return 0;
+        return streamGridSequence(slot, *paths, gridname, options);
     }
 
     void GridVolume::setGridSequence(GridSlot slot, const GridSequence& grids)
@@ -180,9 +215,11 @@ namespace Falcor
         uint32_t slotIndex = (uint32_t)slot;
         FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
 
-        if (mGrids[slotIndex] != grids)
+        if (mGrids[slotIndex] != grids || mGridStreamers[slotIndex])
         {
             mGrids[slotIndex] = grids;
+            mGridStreamers[slotIndex] = nullptr;
+            mStreamedGrids[slotIndex] = nullptr;
             updateSequence();
             updateBounds();
             markUpdates(UpdateFlags::GridsChanged);
@@ -197,6 +234,31 @@ namespace Falcor
         return mGrids[slotIndex];
     }
 
+    void GridVolume::setGridStreamer(GridSlot slot, const GridStreamer::SharedPtr& pStreamer)
+    {
+        uint32_t slotIndex = (uint32_t)slot;
+        FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
+
+        if (mGridStreamers[slotIndex] != pStreamer)
+        {
+            mGrids[slotIndex].clear();
+            mGridStreamers[slotIndex] = pStreamer;
+            mStreamedGrids[slotIndex] = nullptr;
+            updateSequence();
+            updateStreamedGrids();
+            updateBounds();
+            markUpdates(UpdateFlags::GridsChanged);
+        }
+    }
+
+    const GridStreamer::SharedPtr& GridVolume::getGridStreamer(GridSlot slot) const
+    {
+        uint32_t slotIndex = (uint32_t)slot;
+        FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
+
+        return mGridStreamers[slotIndex];
+    }
+
     void GridVolume::setGrid(GridSlot slot, const Grid::SharedPtr& grid)
     {
         setGridSequence(slot, grid ? GridSequence{grid} : GridSequence{});
@@ -209,6 +271,8 @@ namespace Falcor
         uint32_t slotIndex = (uint32_t)slot;
         FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
 
+        if (mGridStreamers[slotIndex]) return mStreamedGrids[slotIndex];
+
         const auto& gridSequence = mGrids[slotIndex];
         uint32_t gridIndex = std::min(mGridFrame, (uint32_t)gridSequence.size() - 1);
         return gridSequence.empty() ? kNullGrid : gridSequence[gridIndex];
@@ -230,6 +294,7 @@ namespace Falcor
         {
             mGridFrame = gridFrame;
             markUpdates(UpdateFlags::GridsChanged);
+            updateStreamedGrids();
             updateBounds();
         }
     }
@@ -330,9 +395,21 @@ namespace Falcor
     {
         mGridFrameCount = 1;
         for (const auto& grids : mGrids) mGridFrameCount = std::max(mGridFrameCount, (uint32_t)grids.size());
+        for (const auto& pStreamer : mGridStreamers) if (pStreamer) mGridFrameCount = std::max(mGridFrameCount, pStreamer->getFrameCount());
         setGridFrame(std::min(mGridFrame, mGridFrameCount - 1));
     }
 
+    void GridVolume::updateStreamedGrids()
+    {
+        for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridSlot::Count; ++slotIndex)
+        {
+            if (const auto& pStreamer = mGridStreamers[slotIndex])
+            {
+                mStreamedGrids[slotIndex] = pStreamer->getGrid(std::min(mGridFrame, pStreamer->getFrameCount() - 1));
+            }
+        }
+    }
+
     void GridVolume::updateBounds()
     {
         AABB bounds;
@@ -372,6 +449,7 @@ namespace Falcor
 
         FALCOR_SCRIPT_BINDING_DEPENDENCY(Animatable)
         FALCOR_SCRIPT_BINDING_DEPENDENCY(Grid)
+        FALCOR_SCRIPT_BINDING_DEPENDENCY(GridStreamer)
 
         pybind11::class_<GridVolume, Animatable, GridVolume::SharedPtr> volume(m, "GridVolume");
         volume.def_property("name", &GridVolume::getName, &GridVolume::setName);
@@ -392,13 +470,32 @@ namespace Falcor
             return GridVolume::create(getActivePythonSceneBuilder().getDevice(), name);
         };
         volume.def(pybind11::init(create), "name"_a); // PYTHONDEPRECATED
-        volume.def("loadGrid", &GridVolume::loadGrid, "slot"_a, "path"_a, "gridname"_a);
+        volume.def("loadGrid", &GridVolume::loadGrid, "slot"_a, "path"_a, "gridname"_a, "cacheBricks"_a = false);
         volume.def("loadGridSequence",
-            pybind11::overload_cast<GridVolume::GridSlot, const std::vector<std::filesystem::path>&, const std::string&, bool>(&GridVolume::loadGridSequence),
-            "slot"_a, "paths"_a, "gridname"_a, "keepEmpty"_a = true);
+            pybind11::overload_cast<GridVolume::GridSlot, const std::vector<std::filesystem::path>&, const std::string&, bool, bool>(&GridVolume::loadGridSequence),
+            "slot"_a, "paths"_a, "gridname"_a, "keepEmpty"_a = true, "cacheBricks"_a = false);
         volume.def("loadGridSequence",
-            pybind11::overload_cast<GridVolume::GridSlot, const std::filesystem::path&, const std::string&, bool>(&GridVolume::loadGridSequence),
-            "slot"_a, "path"_a, "gridnames"_a, "keepEmpty"_a = true);
+            pybind11::overload_cast<GridVolume::GridSlot, const std::filesystem::path&, const std::string&, bool, bool>(&GridVolume::loadGridSequence),
+            "slot"_a, "path"_a, "gridnames"_a, "keepEmpty"_a = true, "cacheBricks"_a = false);
+
+        auto streamGridSequence = [] (GridVolume& volume, GridVolume::GridSlot slot, const pybind11::object& paths, const std::string& gridname,
+            uint32_t framesAhead, uint32_t framesBehind, uint64_t memoryBudget, uint32_t threadCount, bool cacheBricks)
+        {
+            GridStreamer::Options options;
+            options.framesAhead = framesAhead;
+            options.framesBehind = framesBehind;
+            options.memoryBudget = memoryBudget;
+            options.threadCount = threadCount;
+            options.cacheBricks = cacheBricks;
+            if (pybind11::isinstance<pybind11::list>(paths)) return volume.streamGridSequence(slot, paths.cast<std::vector<std::filesystem::path>>(), gridname, options);
+            return volume.streamGridSequence(slot, paths.cast<std::filesystem::path>(), gridname, options);
+        };
+        const GridStreamer::Options kDefaultStreamerOptions;
+        volume.def("streamGridSequence", streamGridSequence, "slot"_a, "path"_a, "gridname"_a,
+            "framesAhead"_a = kDefaultStreamerOptions.framesAhead, "framesBehind"_a = kDefaultStreamerOptions.framesBehind,
+            "memoryBudget"_a = kDefaultStreamerOptions.memoryBudget, "threadCount"_a = kDefaultStreamerOptions.threadCount,
+            "cacheBricks"_a = kDefaultStreamerOptions.cacheBricks);
+        volume.def("getGridStreamer", &GridVolume::getGridStreamer, "slot"_a);
 
         pybind11::enum_<GridVolume::GridSlot> gridSlot(volume, "GridSlot");
         gridSlot.value("Density", GridVolume::GridSlot::Density);
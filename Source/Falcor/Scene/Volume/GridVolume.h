@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Grid.h"
+#include "GridStreamer.h"
 #include "GridVolumeData.slang"
 #include "Core/Macros.h"
 #include "Utils/Math/AABB.h"
@@ -115,9 +116,10 @@ namespace Falcor
             \param[in] slot Grid slot.
             \param[in] path File path of the grid. Can also include a full path or relative path from a data directory.
             \param[in] gridname Name of the grid to load.
+            \param[in] cacheBricks Cache the converted bricks in a file next to the grid file (see Grid::createFromFile()).
             \return Returns true if grid was loaded successfully.
         */
-        bool loadGrid(GridSlot slot, const std::filesystem::path& path, const std::string& gridname);
+        bool loadGrid(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool cacheBricks = false);
 
         /** Load a sequence of grids from files to a grid slot.
             Note: This will replace any existing grid sequence for that slot.
@@ -125,9 +127,10 @@ namespace Falcor
             \param[in] paths File paths of the grids. Can also include a full path or relative path from a data directory.
             \param[in] gridname Name of the grid to load.
             \param[in] keepEmpty Add empty (nullptr) grids to the sequence if one cannot be loaded from the file.
+            \param[in] cacheBricks Cache the converted bricks in files next to the grid files (see Grid::createFromFile()).
             \return Returns the length of the loaded sequence.
         */
-        uint32_t loadGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty = true);
+        uint32_t loadGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty = true, bool cacheBricks = false);
 
         /** Load a sequence of grids from a directory to a grid slot.
             Note: This will replace any existing grid sequence for that slot.
@@ -135,18 +138,51 @@ namespace Falcor
             \param[in] path Directory containing grid files. Can also include a full path or relative path from a data directory.
             \param[in] gridname Name of the grid to load.
             \param[in] keepEmpty Add empty (nullptr) grids to the sequence if one cannot be loaded from the file.
+            \param[in] cacheBricks Cache the converted bricks in files next to the grid files (see Grid::createFromFile()).
             \return Returns the length of the loaded sequence.
         */
-        uint32_t loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty = true);
+        uint32_t loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty = true, bool cacheBricks = false);
+
+        /** Stream a sequence of grids from files to a grid slot.
+            Instead of loading all grids upfront, grids are loaded on demand and prefetched in the background around the current grid frame (see GridStreamer).
+            Note: This will replace any existing grid sequence for that slot.
+            \param[in] slot Grid slot.
+            \param[in] paths File paths of the grids. Can also include a full path or relative path from a data directory.
+            \param[in] gridname Name of the grid to load.
+            \param[in] options Streaming options.
+            \return Returns the length of the streamed sequence.
+        */
+        uint32_t streamGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const GridStreamer::Options& options = GridStreamer::Options());
+
+        /** Stream a sequence of grids from a directory to a grid slot.
+            Note: This will replace any existing grid sequence for that slot.
+            \param[in] slot Grid slot.
+            \param[in] path Directory containing grid files. Can also include a full path or relative path from a data directory.
+            \param[in] gridname Name of the grid to load.
+            \param[in] options Streaming options.
+            \return Returns the length of the streamed sequence.
+        */
+        uint32_t streamGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, const GridStreamer::Options& options = GridStreamer::Options());
 
         /** Set the grid sequence for the specified slot.
         */
         void setGridSequence(GridSlot slot, const GridSequence& grids);
 
         /** Get the grid sequence for the specified slot.
+            Note: This is empty for streamed grid sequences.
         */
         const GridSequence& getGridSequence(GridSlot slot) const;
 
+        /** Set the grid streamer for the specified slot.
+            Note: This will replace any existing grid sequence for that slot.
+        */
+        void setGridStreamer(GridSlot slot, const GridStreamer::SharedPtr& pStreamer);
+
+        /** Get the grid streamer for the specified slot.
+            \return The grid streamer, or nullptr if the slot is not streamed.
+        */
+        const GridStreamer::SharedPtr& getGridStreamer(GridSlot slot) const;
+
         /** Set the grid for the specified slot.
             Note: This will replace any existing grid sequence for that slot with just a single grid.
         */
@@ -157,6 +193,7 @@ namespace Falcor
         const Grid::SharedPtr& getGrid(GridSlot slot) const;
 
         /** Get a list of all grids used for this volume.
+            Note: Streamed grids are not included.
         */
         std::vector<Grid::SharedPtr> getAllGrids() const;
 
@@ -271,6 +308,7 @@ namespace Falcor
         GridVolume(std::shared_ptr<Device> pDevice, const std::string& name);
 
         void updateSequence();
+        void updateStreamedGrids();
         void updateBounds();
 
         void markUpdates(UpdateFlags updates);
@@ -279,6 +317,8 @@ namespace Falcor
         std::shared_ptr<Device> mpDevice;
         std::string mName;
         std::array<GridSequence, (size_t)GridSlot::Count> mGrids;
+        std::array<GridStreamer::SharedPtr, (size_t)GridSlot::Count> mGridStreamers;
+        std::array<Grid::SharedPtr, (size_t)GridSlot::Count> mStreamedGrids;    ///< Streamed grids of the current frame.
         uint32_t mGridFrame = 0;
         uint32_t mGridFrameCount = 1;
         double mFrameRate = 30.f;
@@ -33,10 +33,14 @@
 #include "Utils/Logger.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/Vector.h"
+#include "Utils/Timing/CpuTimer.h"
 #include <fmt/format.h>
 #include <fmt/color.h>
+#include <nlohmann/json.hpp>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <fstream>
 #include <regex>
 #include <inttypes.h>
 
@@ -48,7 +52,7 @@ namespace
 {
 struct Test
 {
-    std::string getTitle() const
+    std::string getTag() const
     {
         std::string tag;
         if (cpuFunc)
@@ -66,19 +70,30 @@ struct Test
             case Device::Type::Vulkan:
                 tag += " Vulkan";
                 break;
+            case Device::Type::CPU:
+                tag += " CPU";
+                break;
+            case Device::Type::Null:
+                tag += " Null";
+                break;
             }
         }
-
-        return fmt::format("{}/{} ({})", path.filename(), name, tag);
+        if (benchmark)
+            tag += " Benchmark";
+        return tag;
     }
 
+    std::string getTitle() const { return fmt::format("{}/{} ({})", path.filename(), name, getTag()); }
+
     std::filesystem::path path;
     std::string name;
     std::string skipMessage;
+    std::string cpuSkipMessage;
     CPUTestFunc cpuFunc;
     GPUTestFunc gpuFunc;
     UnitTestDeviceFlags supportedDevices;
     Device::Type deviceType;
+    bool benchmark = false;
 };
 
 struct TestResult
@@ -94,6 +109,15 @@ struct TestResult
     std::vector<std::string> messages;
     std::string extraMessage;
     uint64_t elapsedMS = 0;
+    std::vector<BenchmarkResult> benchmarks;
+};
+
+/// Benchmark result as stored in the JSON report.
+struct BenchmarkEntry
+{
+    std::string name;
+    std::string tag;
+    BenchmarkResult result;
 };
 
 static std::vector<Test>& getTestRegistry()
@@ -126,18 +150,50 @@ void registerGPUTest(
     const std::string& name,
     const std::string& skipMessage,
     GPUTestFunc func,
-    UnitTestDeviceFlags supportedDevices
+    UnitTestDeviceFlags supportedDevices,
+    const std::string& cpuSkipMessage
 )
 {
     Test test;
     test.path = path;
     test.name = name;
     test.skipMessage = skipMessage;
+    test.cpuSkipMessage = cpuSkipMessage;
     test.gpuFunc = std::move(func);
     test.supportedDevices = supportedDevices;
     getTestRegistry().push_back(test);
 }
 
+void registerCPUBenchmark(const std::filesystem::path& path, const std::string& name, const std::string& skipMessage, CPUBenchmarkFunc func)
+{
+    // Benchmarks run with benchmark contexts, see runTest().
+    Test test;
+    test.path = path;
+    test.name = name;
+    test.skipMessage = skipMessage;
+    test.cpuFunc = [func = std::move(func)](CPUUnitTestContext& ctx) { func(static_cast<CPUBenchmarkContext&>(ctx)); };
+    test.benchmark = true;
+    getTestRegistry().push_back(test);
+}
+
+void registerGPUBenchmark(
+    const std::filesystem::path& path,
+    const std::string& name,
+    const std::string& skipMessage,
+    GPUBenchmarkFunc func,
+    UnitTestDeviceFlags supportedDevices
+)
+{
+    Test test;
+    test.path = path;
+    test.name = name;
+    test.skipMessage = skipMessage;
+    test.gpuFunc = [func = std::move(func)](GPUUnitTestContext& ctx) { func(static_cast<GPUBenchmarkContext&>(ctx)); };
+    test.supportedDevices = supportedDevices;
+    test.benchmark = true;
+    getTestRegistry().push_back(test);
+}
+
 /// Prints the UnitTest report line, making sure it is always printed to the console once.
 template<typename... Args>
 void reportLine(const std::string_view format, Args&&... args)
@@ -191,6 +247,64 @@ inline void writeXmlReport(const std::filesystem::path& path, const std::vector<
     doc.save_file(path.native().c_str());
 }
 
+/**
+ * Write benchmark results in JSON format.
+ * @param[in] path File path.
+ * @param[in] entries List of benchmark results.
+ */
+inline void writeBenchmarkReport(const std::filesystem::path& path, const std::vector<BenchmarkEntry>& entries)
+{
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (const auto& entry : entries)
+    {
+        const auto& result = entry.result;
+        benchmarks.push_back({
+            {"name", entry.name},
+            {"tag", entry.tag},
+            {"timer", result.gpuTime ? "gpu" : "cpu"},
+            {"iterations", result.iterations},
+            {"min_ms", result.min},
+            {"median_ms", result.median},
+            {"p95_ms", result.p95},
+            {"mean_ms", result.mean},
+            {"ci95_ms", result.confidence},
+        });
+    }
+
+    std::ofstream ofs(path);
+    if (!ofs.good())
+    {
+        reportLine("Failed to write benchmark report to '{}'.", path);
+        return;
+    }
+    ofs << nlohmann::json({{"benchmarks", benchmarks}}).dump(4) << std::endl;
+}
+
+/**
+ * Read the median times of a benchmark report written by writeBenchmarkReport().
+ * @param[in] path File path.
+ * @return Map from benchmark name and tag to median time in milliseconds.
+ */
+inline std::map<std::pair<std::string, std::string>, double> readBenchmarkBaseline(const std::filesystem::path& path)
+{
+    std::map<std::pair<std::string, std::string>, double> baseline;
+    std::ifstream ifs(path);
+    if (!ifs.good())
+        throw RuntimeError("Failed to open benchmark baseline '{}'.", path);
+
+    try
+    {
+        auto json = nlohmann::json::parse(ifs);
+        for (const auto& entry : json.at("benchmarks"))
+            baseline[{entry.at("name").get<std::string>(), entry.at("tag").get<std::string>()}] = entry.at("median_ms").get<double>();
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        throw RuntimeError("Failed to parse benchmark baseline '{}': {}", path, e.what());
+    }
+    return baseline;
+}
+
 inline TestResult runTest(const Test& test, std::shared_ptr<Device> pDevice, Fbo* pTargetFbo)
 {
     if (!test.skipMessage.empty())
@@ -202,14 +316,19 @@ inline TestResult runTest(const Test& test, std::shared_ptr<Device> pDevice, Fbo
             return {TestResult::Status::Skipped, {"Not supported on D3D12."}};
         if (pDevice->getType() == Device::Type::Vulkan && !is_set(test.supportedDevices, UnitTestDeviceFlags::Vulkan))
             return {TestResult::Status::Skipped, {"Not supported on Vulkan."}};
+        if (pDevice->getType() == Device::Type::CPU && !is_set(test.supportedDevices, UnitTestDeviceFlags::CPU))
+            return {TestResult::Status::Skipped, {test.cpuSkipMessage.empty() ? "Not supported on CPU." : test.cpuSkipMessage}};
+        if (pDevice->getType() == Device::Type::Null && !is_set(test.supportedDevices, UnitTestDeviceFlags::Null))
+            return {TestResult::Status::Skipped, {"Not supported on the null device."}};
     }
 
     TestResult result{TestResult::Status::Passed};
 
     auto startTime = std::chrono::steady_clock::now();
 
-    CPUUnitTestContext cpuCtx;
-    GPUUnitTestContext gpuCtx(pDevice, pTargetFbo);
+    // The benchmark contexts derive from the test contexts, so they are used for both tests and benchmarks.
+    CPUBenchmarkContext cpuCtx;
+    GPUBenchmarkContext gpuCtx(pDevice, pTargetFbo);
 
     try
     {
@@ -245,6 +364,7 @@ inline TestResult runTest(const Test& test, std::shared_ptr<Device> pDevice, Fbo
     }
 
     result.messages = test.cpuFunc ? cpuCtx.getFailureMessages() : gpuCtx.getFailureMessages();
+    result.benchmarks = test.cpuFunc ? cpuCtx.getResults() : gpuCtx.getResults();
 
     if (!result.messages.empty())
         result.status = TestResult::Status::Failed;
@@ -268,7 +388,9 @@ int32_t runTests(
     UnitTestCategoryFlags categoryFlags,
     const std::string& testFilter,
     const std::filesystem::path& xmlReportPath,
-    uint32_t repeatCount
+    uint32_t repeatCount,
+    UnitTestKindFlags kindFlags,
+    const BenchmarkOptions& benchmarkOptions
 )
 {
     // Abort on Ctrl-C.
@@ -285,6 +407,11 @@ int32_t runTests(
     std::map<std::string, std::vector<Test>> tests;
     std::vector<std::pair<Test, TestResult>> report;
     std::map<std::string, std::vector<Test>> failedTests;
+    std::vector<BenchmarkEntry> benchmarkEntries;
+
+    std::map<std::pair<std::string, std::string>, double> benchmarkBaseline;
+    if (!benchmarkOptions.baselinePath.empty() && is_set(kindFlags, UnitTestKindFlags::Benchmark))
+        benchmarkBaseline = readBenchmarkBaseline(benchmarkOptions.baselinePath);
 
     // Filter tests.
     std::regex testFilterRegex(testFilter, std::regex::icase | std::regex::basic);
@@ -294,6 +421,8 @@ int32_t runTests(
             continue;
         if (it.gpuFunc && !is_set(categoryFlags, UnitTestCategoryFlags::GPU))
             continue;
+        if (!is_set(kindFlags, it.benchmark ? UnitTestKindFlags::Benchmark : UnitTestKindFlags::Test))
+            continue;
 
         it.deviceType = pDevice->getType();
 
@@ -340,6 +469,40 @@ int32_t runTests(
                     repeats = fmt::format("[{}/{}]", repeatIndex + 1, repeatCount);
                 reportLine("[ RUN      ] {}:{}{}", suiteName, test.name, repeats);
                 TestResult result = runTest(test, pDevice, pTargetFbo);
+
+                for (const auto& benchmark : result.benchmarks)
+                {
+                    std::string name = fmt::format("{}:{}", suiteName, test.name);
+                    if (!benchmark.name.empty())
+                        name += "/" + benchmark.name;
+                    reportLine(
+                        "[ BENCH    ] {}: median {:.4f} ms, min {:.4f} ms, p95 {:.4f} ms, +-{:.4f} ms ({} iterations, {} time)", name,
+                        benchmark.median, benchmark.min, benchmark.p95, benchmark.confidence, benchmark.iterations,
+                        benchmark.gpuTime ? "GPU" : "CPU"
+                    );
+
+                    // Compare against the baseline.
+                    auto baselineIt = benchmarkBaseline.find({name, test.getTag()});
+                    if (baselineIt != benchmarkBaseline.end())
+                    {
+                        double ratio = baselineIt->second > 0.0 ? benchmark.median / baselineIt->second : 1.0;
+                        reportLine(
+                            "[ BENCH    ] {}: {:+.1f}% relative to baseline ({:.4f} ms)", name, (ratio - 1.0) * 100.0, baselineIt->second
+                        );
+                        if (ratio > 1.0 + benchmarkOptions.tolerance)
+                        {
+                            result.status = TestResult::Status::Failed;
+                            result.messages.push_back(fmt::format(
+                                "{}: median {:.4f} ms exceeds baseline {:.4f} ms by more than {:.1f}%.", name, benchmark.median,
+                                baselineIt->second, benchmarkOptions.tolerance * 100.0
+                            ));
+                            reportLine("{}", result.messages.back());
+                        }
+                    }
+
+                    benchmarkEntries.push_back({name, test.getTag(), benchmark});
+                }
+
                 report.emplace_back(test, result);
 
                 std::string statusTag;
@@ -383,6 +546,8 @@ int32_t runTests(
 
     if (!xmlReportPath.empty())
         writeXmlReport(xmlReportPath, report);
+    if (!benchmarkOptions.reportPath.empty() && is_set(kindFlags, UnitTestKindFlags::Benchmark))
+        writeBenchmarkReport(benchmarkOptions.reportPath, benchmarkEntries);
 
     reportLine(
         "[==========] {} test{} from {} test suite{} ran. ({} ms total)", totalTestCount, plural(totalTestCount, "s"), tests.size(),
@@ -515,6 +680,107 @@ const void* GPUUnitTestContext::mapRawRead(const char* bufferName)
     return mStructuredBuffers[bufferName].pBuffer->map(Buffer::MapType::Read);
 }
 
+///////////////////////////////////////////////////////////////////////////
+
+void BenchmarkContext::measure(const std::string& name, bool gpuTime, const std::function<double()>& iteration)
+{
+    for (uint32_t i = 0; i < mConfig.warmupIterations; ++i)
+        iteration();
+
+    // Repeat until the confidence interval is small enough or a limit is reached.
+    std::vector<double> samples;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    double totalTime = 0.0;
+    double confidence = 0.0;
+    while (samples.size() < mConfig.maxIterations)
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        double time = iteration();
+        totalTime += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+
+        samples.push_back(time);
+        sum += time;
+        sumSquares += time * time;
+
+        size_t n = samples.size();
+        if (n > 1)
+        {
+            double mean = sum / n;
+            double variance = std::max(0.0, (sumSquares - n * mean * mean) / (n - 1));
+            confidence = 1.96 * std::sqrt(variance / n);
+            if (n >= mConfig.minIterations && (confidence <= mConfig.targetConfidence * mean || totalTime >= mConfig.maxTimeMS))
+                break;
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+
+    BenchmarkResult result;
+    result.name = name;
+    result.gpuTime = gpuTime;
+    result.iterations = (uint32_t)n;
+    if (n > 0)
+    {
+        result.min = samples.front();
+        result.median = n % 2 ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+        result.p95 = samples[std::min(n - 1, (size_t)std::ceil(0.95 * n) - 1)];
+        result.mean = sum / n;
+        result.confidence = confidence;
+    }
+    mResults.push_back(result);
+}
+
+void CPUBenchmarkContext::benchmark(const std::string& name, const std::function<void()>& func)
+{
+    measure(
+        name, false,
+        [&func]()
+        {
+            auto startTime = CpuTimer::getCurrentTimePoint();
+            func();
+            return CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        }
+    );
+}
+
+void GPUBenchmarkContext::benchmark(const std::string& name, const std::function<void()>& func)
+{
+    const auto& pDevice = getDevice();
+
+    if (pDevice->isHostDevice())
+    {
+        measure(
+            name, false,
+            [&]()
+            {
+                auto startTime = CpuTimer::getCurrentTimePoint();
+                func();
+                pDevice->flushAndSync();
+                return CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+            }
+        );
+        return;
+    }
+
+    if (!mpTimer)
+        mpTimer = GpuTimer::create(pDevice.get());
+
+    measure(
+        name, true,
+        [&]()
+        {
+            mpTimer->begin();
+            func();
+            mpTimer->end();
+            mpTimer->resolve();
+            pDevice->flushAndSync();
+            return mpTimer->getElapsedTime();
+        }
+    );
+}
+
 /**
  * Simple tests of the testing framework. How meta.
  */
@@ -569,4 +835,30 @@ GPU_TEST(TestGPUTest)
 
     ctx.unmapBuffer("result");
 }
+
+CPU_BENCHMARK(TestCPUBenchmark)
+{
+    std::vector<float> values(1 << 16);
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = float(i);
+
+    float sum = 0.f;
+    ctx.config().maxIterations = 100;
+    ctx.benchmark(
+        [&]()
+        {
+            sum = 0.f;
+            for (float v : values)
+                sum += v;
+        }
+    );
+    EXPECT_GT(sum, 0.f);
+
+    const auto& results = ctx.getResults();
+    ASSERT_EQ(results.size(), size_t(1));
+    EXPECT_GE(results[0].iterations, ctx.config().minIterations);
+    EXPECT_LE(results[0].iterations, 100);
+    EXPECT_LE(results[0].min, results[0].median);
+    EXPECT_LE(results[0].median, results[0].p95);
+}
 } // namespace Falcor
@@ -32,6 +32,7 @@
 #include "Core/Program/ComputeProgram.h"
 #include "Core/Program/ProgramVars.h"
 #include "Core/Program/ShaderVar.h"
+#include "Core/API/GpuTimer.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/StringFormatters.h"
 
@@ -60,6 +61,8 @@ class RenderContext;
 
 class CPUUnitTestContext;
 class GPUUnitTestContext;
+class CPUBenchmarkContext;
+class GPUBenchmarkContext;
 
 static constexpr int kMaxTestFailures = 25;
 
@@ -88,6 +91,8 @@ public:
 
 using CPUTestFunc = std::function<void(CPUUnitTestContext& ctx)>;
 using GPUTestFunc = std::function<void(GPUUnitTestContext& ctx)>;
+using CPUBenchmarkFunc = std::function<void(CPUBenchmarkContext& ctx)>;
+using GPUBenchmarkFunc = std::function<void(GPUBenchmarkContext& ctx)>;
 
 enum class UnitTestCategoryFlags
 {
@@ -103,11 +108,33 @@ enum class UnitTestDeviceFlags
 {
     D3D12 = 0x1,
     Vulkan = 0x2,
+    CPU = 0x4,
+    Null = 0x8,
     All = D3D12 | Vulkan,
 };
 
 FALCOR_ENUM_CLASS_OPERATORS(UnitTestDeviceFlags);
 
+enum class UnitTestKindFlags
+{
+    None = 0x0,
+    Test = 0x1,
+    Benchmark = 0x2,
+    All = Test | Benchmark,
+};
+
+FALCOR_ENUM_CLASS_OPERATORS(UnitTestKindFlags);
+
+/**
+ * Options for running benchmarks.
+ */
+struct BenchmarkOptions
+{
+    std::filesystem::path reportPath;   ///< JSON report output file. No report is written if empty.
+    std::filesystem::path baselinePath; ///< JSON report of a previous run to compare against. Results are not compared if empty.
+    double tolerance = 0.1;             ///< Relative increase of the median time over the baseline that fails a benchmark.
+};
+
 FALCOR_API void registerCPUTest(
     const std::filesystem::path& path,
     const std::string& name,
@@ -119,6 +146,20 @@ FALCOR_API void registerGPUTest(
     const std::string& name,
     const std::string& skipMessage,
     GPUTestFunc func,
+    UnitTestDeviceFlags supportedDevices,
+    const std::string& cpuSkipMessage = ""
+);
+FALCOR_API void registerCPUBenchmark(
+    const std::filesystem::path& path,
+    const std::string& name,
+    const std::string& skipMessage,
+    CPUBenchmarkFunc func
+);
+FALCOR_API void registerGPUBenchmark(
+    const std::filesystem::path& path,
+    const std::string& name,
+    const std::string& skipMessage,
+    GPUBenchmarkFunc func,
     UnitTestDeviceFlags supportedDevices
 );
 FALCOR_API int32_t runTests(
@@ -127,7 +168,9 @@ FALCOR_API int32_t runTests(
     UnitTestCategoryFlags categoryFlags,
     const std::string& testFilterRegexp,
     const std::filesystem::path& xmlReportPath,
-    uint32_t repeatCount = 1
+    uint32_t repeatCount = 1,
+    UnitTestKindFlags kindFlags = UnitTestKindFlags::Test,
+    const BenchmarkOptions& benchmarkOptions = {}
 );
 
 class FALCOR_API UnitTestContext
@@ -291,6 +334,92 @@ private:
     std::map<std::string, ParameterBuffer> mStructuredBuffers;
 };
 
+/**
+ * Configuration of benchmark measurements.
+ * A measurement runs the warm-up iterations and then repeats until the 95% confidence interval of the mean
+ * time is within targetConfidence of the mean, or until the iteration or time limit is reached.
+ */
+struct BenchmarkConfig
+{
+    uint32_t warmupIterations = 3;  ///< Number of iterations run before measuring.
+    uint32_t minIterations = 10;    ///< Minimum number of measured iterations.
+    uint32_t maxIterations = 1000;  ///< Maximum number of measured iterations.
+    double maxTimeMS = 5000.0;      ///< Maximum total time of the measured iterations in milliseconds.
+    double targetConfidence = 0.02; ///< Target half-width of the 95% confidence interval relative to the mean.
+};
+
+/**
+ * Timing statistics of a benchmark measurement. All times are in milliseconds.
+ */
+struct BenchmarkResult
+{
+    std::string name;        ///< Measurement name, empty for an unnamed measurement.
+    bool gpuTime = false;    ///< True if measured with GPU timestamps, false if measured with the wall clock.
+    uint32_t iterations = 0; ///< Number of measured iterations.
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double mean = 0.0;
+    double confidence = 0.0; ///< Half-width of the 95% confidence interval of the mean.
+};
+
+class FALCOR_API BenchmarkContext
+{
+public:
+    /**
+     * Returns the configuration used by subsequent measurements.
+     */
+    BenchmarkConfig& config() { return mConfig; }
+
+    const std::vector<BenchmarkResult>& getResults() const { return mResults; }
+
+protected:
+    /**
+     * Run a measurement and record its statistics.
+     * @param[in] name Measurement name.
+     * @param[in] gpuTime True if the iteration function returns GPU times.
+     * @param[in] iteration Function running a single iteration and returning its time in milliseconds.
+     */
+    void measure(const std::string& name, bool gpuTime, const std::function<double()>& iteration);
+
+private:
+    BenchmarkConfig mConfig;
+    std::vector<BenchmarkResult> mResults;
+};
+
+class FALCOR_API CPUBenchmarkContext : public CPUUnitTestContext, public BenchmarkContext
+{
+public:
+    /**
+     * Measure the wall-clock time of a function. Code outside of the function (setup) is not measured.
+     * @param[in] name Name distinguishing multiple measurements in the same benchmark.
+     * @param[in] func Function to measure.
+     */
+    void benchmark(const std::string& name, const std::function<void()>& func);
+
+    void benchmark(const std::function<void()>& func) { benchmark("", func); }
+};
+
+class FALCOR_API GPUBenchmarkContext : public GPUUnitTestContext, public BenchmarkContext
+{
+public:
+    GPUBenchmarkContext(std::shared_ptr<Device> pDevice, Fbo* pTargetFbo) : GPUUnitTestContext(std::move(pDevice), pTargetFbo) {}
+
+    /**
+     * Measure the GPU time of the work a function records on the render context.
+     * The device is synchronized after every iteration. Host devices have no timestamp queries,
+     * on these the wall-clock time of the iteration including the synchronization is measured instead.
+     * @param[in] name Name distinguishing multiple measurements in the same benchmark.
+     * @param[in] func Function to measure.
+     */
+    void benchmark(const std::string& name, const std::function<void()>& func);
+
+    void benchmark(const std::function<void()>& func) { benchmark("", func); }
+
+private:
+    GpuTimer::SharedPtr mpTimer;
+};
+
 namespace unittest
 {
 /**
@@ -466,19 +595,22 @@ inline std::optional<std::string> createBinaryMessage(std::string_view lhsStr, s
  * disable the test from running without leading to a failure.
  * The macro works in the same ways as CPU_TEST().
  */
-#define GPU_TEST_INTERNAL(name, flags, ...)                                      \
-    static void GPUUnitTest##name(GPUUnitTestContext& ctx);                      \
-    struct GPUUnitTestRegisterer##name                                           \
-    {                                                                            \
-        GPUUnitTestRegisterer##name()                                            \
-        {                                                                        \
-            std::filesystem::path path = __FILE__;                               \
-            const char* skipMessage = "" __VA_ARGS__;                            \
-            registerGPUTest(path, #name, skipMessage, GPUUnitTest##name, flags); \
-        }                                                                        \
-    } RegisterGPUTest##name;                                                     \
+#define GPU_TEST_INTERNAL_EX(name, flags, skipMessageString, cpuSkipMessageString)               \
+    static void GPUUnitTest##name(GPUUnitTestContext& ctx);                                      \
+    struct GPUUnitTestRegisterer##name                                                           \
+    {                                                                                            \
+        GPUUnitTestRegisterer##name()                                                            \
+        {                                                                                        \
+            std::filesystem::path path = __FILE__;                                               \
+            const char* skipMessage = skipMessageString;                                         \
+            const char* cpuSkipMessage = cpuSkipMessageString;                                   \
+            registerGPUTest(path, #name, skipMessage, GPUUnitTest##name, flags, cpuSkipMessage); \
+        }                                                                                        \
+    } RegisterGPUTest##name;                                                                     \
     static void GPUUnitTest##name(GPUUnitTestContext& ctx) /* over to the user for the braces */
 
+#define GPU_TEST_INTERNAL(name, flags, ...) GPU_TEST_INTERNAL_EX(name, flags, "" __VA_ARGS__, "")
+
 #define GPU_TEST(name, ...) GPU_TEST_INTERNAL(name, UnitTestDeviceFlags::All, __VA_ARGS__)
 
 /**
@@ -491,6 +623,61 @@ inline std::optional<std::string> createBinaryMessage(std::string_view lhsStr, s
  */
 #define GPU_TEST_VULKAN(name, ...) GPU_TEST_INTERNAL(name, UnitTestDeviceFlags::Vulkan, __VA_ARGS__)
 
+/**
+ * Define COMPUTE_TEST macro that defines a GPU unit test which also runs on the CPU device.
+ * Only use it for tests that are limited to compute programs, buffers and textures.
+ */
+#define COMPUTE_TEST(name, ...) GPU_TEST_INTERNAL(name, UnitTestDeviceFlags::All | UnitTestDeviceFlags::CPU, __VA_ARGS__)
+
+/**
+ * Define GPU_TEST_NO_CPU macro that defines a GPU unit test which runs compute programs the CPU device cannot execute.
+ * The reason is reported when the test is skipped on the CPU device.
+ */
+#define GPU_TEST_NO_CPU(name, reason, ...) GPU_TEST_INTERNAL_EX(name, UnitTestDeviceFlags::All, "" __VA_ARGS__, reason)
+
+/**
+ * Define GPU_TEST_NULL macro that defines a GPU unit test only supported on the null device.
+ * The null device records commands without executing them, so these tests check the CPU-side behavior only.
+ */
+#define GPU_TEST_NULL(name, ...) GPU_TEST_INTERNAL(name, UnitTestDeviceFlags::Null, __VA_ARGS__)
+
+/**
+ * Macro to define a CPU benchmark. Benchmarks are only run when requested
+ * (see runTests()) and time the functions passed to ctx.benchmark().
+ * The macro works in the same ways as CPU_TEST().
+ */
+#define CPU_BENCHMARK(name, ...)                                                \
+    static void CPUBenchmark##name(CPUBenchmarkContext& ctx);                   \
+    struct CPUBenchmarkRegisterer##name                                         \
+    {                                                                           \
+        CPUBenchmarkRegisterer##name()                                          \
+        {                                                                       \
+            std::filesystem::path path = __FILE__;                              \
+            const char* skipMessage = "" __VA_ARGS__;                           \
+            registerCPUBenchmark(path, #name, skipMessage, CPUBenchmark##name); \
+        }                                                                       \
+    } RegisterCPUBenchmark##name;                                               \
+    static void CPUBenchmark##name(CPUBenchmarkContext& ctx) /* over to the user for the braces */
+
+/**
+ * Macro to define a GPU benchmark.
+ * The macro works in the same ways as GPU_TEST().
+ */
+#define GPU_BENCHMARK_INTERNAL(name, flags, ...)                                       \
+    static void GPUBenchmark##name(GPUBenchmarkContext& ctx);                          \
+    struct GPUBenchmarkRegisterer##name                                                \
+    {                                                                                  \
+        GPUBenchmarkRegisterer##name()                                                 \
+        {                                                                              \
+            std::filesystem::path path = __FILE__;                                     \
+            const char* skipMessage = "" __VA_ARGS__;                                  \
+            registerGPUBenchmark(path, #name, skipMessage, GPUBenchmark##name, flags); \
+        }                                                                              \
+    } RegisterGPUBenchmark##name;                                                      \
+    static void GPUBenchmark##name(GPUBenchmarkContext& ctx) /* over to the user for the braces */
+
+#define GPU_BENCHMARK(name, ...) GPU_BENCHMARK_INTERNAL(name, UnitTestDeviceFlags::All, __VA_ARGS__)
+
 /**
  * Macro definitions for the GPU unit testing framework. Note that they
  * are all a single statement (including any additional << printed
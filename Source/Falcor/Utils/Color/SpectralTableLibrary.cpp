@@ -0,0 +1,217 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SpectralTableLibrary.h"
+#include "Core/Errors.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kMagic[4] = { 'F', 'S', 'P', 'T' };
+        const uint32_t kVersion = 1;
+
+        // Archive layout: header, entries sorted by name, name characters, sample data.
+        // All offsets are in bytes from the start of the archive, sample data is 4 byte aligned.
+        struct ArchiveHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t tableCount;
+            uint32_t reserved;
+        };
+
+        struct ArchiveEntry
+        {
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            uint32_t dataOffset;
+            uint32_t sampleCount;
+            float lambdaStart;
+            float lambdaEnd;
+        };
+
+        static_assert(sizeof(ArchiveHeader) == 16);
+        static_assert(sizeof(ArchiveEntry) == 24);
+    }
+
+    SpectralTableLibrary::SpectralTableLibrary(const std::filesystem::path& tablesDirectory, const std::filesystem::path& archivePath)
+        : mTablesDirectory(tablesDirectory)
+        , mArchivePath(archivePath.empty() ? tablesDirectory / kArchiveFilename : archivePath)
+    {
+        openArchive();
+    }
+
+    const SpectralTableLibrary& SpectralTableLibrary::getDefault()
+    {
+        static const SpectralTableLibrary library(getDefaultTablesDirectory(), getDefaultArchivePath());
+        return library;
+    }
+
+    std::filesystem::path SpectralTableLibrary::getDefaultTablesDirectory()
+    {
+        return std::filesystem::path(_PROJECT_DIR_) / "../Tables";
+    }
+
+    std::filesystem::path SpectralTableLibrary::getDefaultArchivePath()
+    {
+        return getRuntimeDirectory() / "data" / kArchiveFilename;
+    }
+
+    size_t SpectralTableLibrary::compile(const std::filesystem::path& tablesDirectory, const std::filesystem::path& archivePath)
+    {
+        struct Table
+        {
+            std::string name;
+            SampledSpectrum<float> spectrum;
+        };
+
+        std::vector<std::filesystem::path> paths;
+        for (const auto& file : std::filesystem::recursive_directory_iterator(tablesDirectory))
+        {
+            if (file.is_regular_file() && file.path().extension() == ".spd") paths.push_back(file.path());
+        }
+
+        std::vector<Table> tables;
+        tables.reserve(paths.size());
+        for (const auto& path : paths)
+        {
+            auto name = std::filesystem::relative(path, tablesDirectory).replace_extension().generic_string();
+            tables.push_back({ std::move(name), SampledSpectrum<float>{ PiecewiseLinearSpectrum::fromFile(path) } });
+        }
+        std::sort(tables.begin(), tables.end(), [](const Table& a, const Table& b) { return a.name < b.name; });
+
+        // Lay out the archive.
+        std::vector<ArchiveEntry> entries(tables.size());
+        size_t offset = sizeof(ArchiveHeader) + entries.size() * sizeof(ArchiveEntry);
+        for (size_t i = 0; i < tables.size(); ++i)
+        {
+            entries[i].nameOffset = (uint32_t)offset;
+            entries[i].nameLength = (uint32_t)tables[i].name.size();
+            offset += tables[i].name.size();
+        }
+        const size_t padding = (4 - offset % 4) % 4;
+        offset += padding;
+        for (size_t i = 0; i < tables.size(); ++i)
+        {
+            const auto range = tables[i].spectrum.getWavelengthRange();
+            entries[i].dataOffset = (uint32_t)offset;
+            entries[i].sampleCount = (uint32_t)tables[i].spectrum.size();
+            entries[i].lambdaStart = range.x;
+            entries[i].lambdaEnd = range.y;
+            offset += tables[i].spectrum.size() * sizeof(float);
+        }
+        if (offset > std::numeric_limits<uint32_t>::max()) throw RuntimeError("Spectral table archive exceeds 4 GB.");
+
+        if (archivePath.has_parent_path()) std::filesystem::create_directories(archivePath.parent_path());
+        std::ofstream os(archivePath, std::ios::binary | std::ios::trunc);
+        if (!os) throw RuntimeError("Failed to open '{}' for writing.", archivePath.string());
+
+        ArchiveHeader header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.tableCount = (uint32_t)tables.size();
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ArchiveEntry));
+        for (const auto& table : tables) os.write(table.name.data(), table.name.size());
+        const char zeros[4] = {};
+        os.write(zeros, padding);
+        for (const auto& table : tables) os.write(reinterpret_cast<const char*>(table.spectrum.get().data()), table.spectrum.size() * sizeof(float));
+
+        if (!os) throw RuntimeError("Failed to write '{}'.", archivePath.string());
+        return tables.size();
+    }
+
+    std::optional<SampledSpectrum<float>> SpectralTableLibrary::find(std::string_view name) const
+    {
+        auto it = mIndex.find(name);
+        if (it == mIndex.end()) return {};
+        const Entry& entry = it->second;
+        return SampledSpectrum<float>(entry.lambdaStart, entry.lambdaEnd, entry.sampleCount, entry.pSamples);
+    }
+
+    SampledSpectrum<float> SpectralTableLibrary::load(const std::string& name, std::filesystem::path& sourcePath) const
+    {
+        if (auto spectrum = find(name))
+        {
+            sourcePath = getArchivePath();
+            return *spectrum;
+        }
+
+        sourcePath = getTablePath(name);
+        if (!std::filesystem::exists(sourcePath)) throw RuntimeError("Spectral table '{}' not found.", name);
+        return SampledSpectrum<float>{ PiecewiseLinearSpectrum::fromFile(sourcePath) };
+    }
+
+    void SpectralTableLibrary::openArchive()
+    {
+        const auto path = getArchivePath();
+        if (!std::filesystem::exists(path)) return;
+        if (!mArchive.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess))
+        {
+            logWarning("Failed to open spectral table archive '{}'. Loading text tables instead.", path.string());
+            return;
+        }
+
+        const uint8_t* pData = static_cast<const uint8_t*>(mArchive.getData());
+        const size_t size = mArchive.getMappedSize();
+
+        auto invalid = [&](const char* reason)
+        {
+            logWarning("Spectral table archive '{}' is invalid ({}). Loading text tables instead.", path.string(), reason);
+            mIndex.clear();
+            mArchive.close();
+        };
+
+        ArchiveHeader header;
+        if (size < sizeof(header)) return invalid("truncated header");
+        std::memcpy(&header, pData, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return invalid("bad magic");
+        if (header.version != kVersion) return invalid("unsupported version");
+        if (sizeof(ArchiveHeader) + size_t(header.tableCount) * sizeof(ArchiveEntry) > size) return invalid("truncated entries");
+
+        const ArchiveEntry* pEntries = reinterpret_cast<const ArchiveEntry*>(pData + sizeof(ArchiveHeader));
+        mIndex.reserve(header.tableCount);
+        for (uint32_t i = 0; i < header.tableCount; ++i)
+        {
+            const ArchiveEntry& e = pEntries[i];
+            if (size_t(e.nameOffset) + e.nameLength > size) return invalid("name out of range");
+            if (e.sampleCount == 0 || e.dataOffset % 4 != 0 || size_t(e.dataOffset) + size_t(e.sampleCount) * sizeof(float) > size) return invalid("samples out of range");
+            if (!(e.lambdaEnd > e.lambdaStart)) return invalid("bad wavelength range");
+
+            std::string_view name(reinterpret_cast<const char*>(pData + e.nameOffset), e.nameLength);
+            mIndex[name] = { e.lambdaStart, e.lambdaEnd, e.sampleCount, reinterpret_cast<const float*>(pData + e.dataOffset) };
+        }
+    }
+}
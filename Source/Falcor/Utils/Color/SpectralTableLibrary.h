@@ -0,0 +1,125 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SampledSpectrum.h"
+#include "Core/Macros.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Falcor
+{
+    /** Library of the spectral tables shipped in the Tables directory.
+
+        The text tables (.spd files) are compiled by the SpectralTableCompiler tool into a single binary archive.
+        Each entry is named after its table path relative to the Tables directory without the .spd extension,
+        e.g. "ior/Ag.eta" or "emission/<name>", and stores the table resampled into a SampledSpectrum.
+        The archive is memory mapped once and looked up through an in-memory name index.
+        Tables missing from the archive (or all tables, if no archive was compiled) are loaded from the text files.
+    */
+    class FALCOR_API SpectralTableLibrary
+    {
+    public:
+        static constexpr const char* kArchiveFilename = "spectra.bin";
+
+        /** Open the library of the tables in a directory.
+            \param[in] tablesDirectory Directory containing the text tables.
+            \param[in] archivePath Path of the compiled archive. If empty, the archive is looked up in the tables directory.
+        */
+        SpectralTableLibrary(const std::filesystem::path& tablesDirectory, const std::filesystem::path& archivePath = {});
+
+        /** Get the library of the tables shipped with Falcor. The archive is opened on first use.
+        */
+        static const SpectralTableLibrary& getDefault();
+
+        /** Get the directory of the tables shipped with Falcor.
+        */
+        static std::filesystem::path getDefaultTablesDirectory();
+
+        /** Get the path of the archive compiled from the shipped tables by the build (in the runtime data directory).
+        */
+        static std::filesystem::path getDefaultArchivePath();
+
+        /** Compile all text tables in a directory (recursively) into a binary archive.
+            Throws a RuntimeError if a table cannot be parsed or the archive cannot be written.
+            \param[in] tablesDirectory Directory containing the text tables.
+            \param[in] archivePath Output archive path.
+            \return Number of compiled tables.
+        */
+        static size_t compile(const std::filesystem::path& tablesDirectory, const std::filesystem::path& archivePath);
+
+        /** Find a table in the archive.
+            \param[in] name Table name, e.g. "ior/Ag.eta".
+            \return The resampled spectrum or an empty optional if the archive does not contain the table.
+        */
+        std::optional<SampledSpectrum<float>> find(std::string_view name) const;
+
+        /** Load a table from the archive or from its text file.
+            Throws a RuntimeError if the table does not exist.
+            \param[in] name Table name, e.g. "ior/Ag.eta".
+            \param[out] sourcePath Path of the file the table was loaded from (archive or text file).
+            \return The resampled spectrum.
+        */
+        SampledSpectrum<float> load(const std::string& name, std::filesystem::path& sourcePath) const;
+
+        /** Get the path of the text file of a table.
+        */
+        std::filesystem::path getTablePath(const std::string& name) const { return mTablesDirectory / (name + ".spd"); }
+
+        /** Get the archive path.
+        */
+        const std::filesystem::path& getArchivePath() const { return mArchivePath; }
+
+        /** Check if the compiled archive is available.
+        */
+        bool hasArchive() const { return mArchive.isOpen(); }
+
+        /** Get the number of tables in the archive.
+        */
+        size_t getArchiveTableCount() const { return mIndex.size(); }
+
+    private:
+        struct Entry
+        {
+            float lambdaStart;
+            float lambdaEnd;
+            uint32_t sampleCount;
+            const float* pSamples;
+        };
+
+        void openArchive();
+
+        std::filesystem::path mTablesDirectory;
+        std::filesystem::path mArchivePath;
+        MemoryMappedFile mArchive;
+        std::unordered_map<std::string_view, Entry> mIndex;     ///< Table name to entry, names point into the mapped archive.
+    };
+}
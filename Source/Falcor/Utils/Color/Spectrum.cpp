@@ -31,7 +31,10 @@
 #include <fstd/span.h> // TODO C++20: Replace with <span>
 #include <unordered_map>
 #include <Utils/Color/SpectrumUtils.h>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 
 namespace Falcor
 {
@@ -78,35 +81,36 @@ namespace Falcor
         return spec;
     }
 
-    inline std::string trim(const std::string& str) {
-        std::string::size_type
-            start = str.find_first_not_of(" \t\r\n"),
-            end = str.find_last_not_of(" \t\r\n");
-
-        return str.substr(start == std::string::npos ? 0 : start,
-                end == std::string::npos ? str.length() - 1 : end - start + 1);
-    }
     PiecewiseLinearSpectrum PiecewiseLinearSpectrum::fromFile(const std::filesystem::path& path)
     {
-        std::ifstream is(path);
+        std::ifstream is(path, std::ios::binary);
         if (is.bad() || is.fail())
             throw RuntimeError("Path could not be read '{}'.", path.string());
 
-        std::string line;
+        // Read the whole file at once and parse it in place, stream parsing each line is slow for large tables.
+        std::string text{ std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
+
         std::vector<float> wvs, vals;
-        while (true) {
-            if (!std::getline(is, line))
-                break;
-            line = trim(line);
-            if (line.length() == 0 || line[0] == '#')
-                continue;
-            std::istringstream iss(line);
-            float lambda, value;
-            if (!(iss >> lambda >> value))
-                break;
-            wvs.push_back(lambda);
-            vals.push_back(value);
+        const char* p = text.c_str();
+        while (*p != '\0')
+        {
+            const char* lineEnd = p + std::strcspn(p, "\n");
+            p += std::strspn(p, " \t\r");
+            if (p < lineEnd && *p != '#')
+            {
+                char* end;
+                float lambda = std::strtof(p, &end);
+                if (end == p || end > lineEnd) break;
+                p = end;
+                float value = std::strtof(p, &end);
+                if (end == p || end > lineEnd) break;
+                wvs.push_back(lambda);
+                vals.push_back(value);
+            }
+            p = *lineEnd == '\n' ? lineEnd + 1 : lineEnd;
         }
+        if (wvs.empty())
+            throw RuntimeError("'{}' does not contain spectral data.", path.string());
 
         return PiecewiseLinearSpectrum{ wvs, vals };
     }
@@ -0,0 +1,207 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshOptimizer.h"
+#include "Core/Assert.h"
+
+namespace Falcor
+{
+    namespace MeshOptimizer
+    {
+        namespace
+        {
+            const uint32_t kInvalidIndex = 0xffffffff;
+
+            /** Vertex-to-triangle adjacency stored in compressed row format.
+            */
+            struct Adjacency
+            {
+                std::vector<uint32_t> offsets;      ///< Per-vertex offset into the triangle list. Size is vertexCount + 1.
+                std::vector<uint32_t> triangles;    ///< Triangles adjacent to each vertex.
+
+                Adjacency(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+                {
+                    offsets.assign(vertexCount + 1, 0);
+                    for (uint32_t index : indices) offsets[index + 1]++;
+                    for (uint32_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+
+                    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                    triangles.resize(indices.size());
+                    for (size_t i = 0; i < indices.size(); i++)
+                    {
+                        triangles[fill[indices[i]]++] = uint32_t(i / 3);
+                    }
+                }
+
+                uint32_t getCount(uint32_t v) const { return offsets[v + 1] - offsets[v]; }
+            };
+        }
+
+        void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+        {
+            FALCOR_ASSERT(indices.size() % 3 == 0);
+            FALCOR_ASSERT(cacheSize > 0);
+
+            const uint32_t triangleCount = uint32_t(indices.size() / 3);
+            if (triangleCount == 0 || vertexCount == 0) return;
+
+            const Adjacency adjacency(indices, vertexCount);
+
+            // Number of not yet emitted triangles referencing each vertex.
+            std::vector<uint32_t> liveCount(vertexCount);
+            for (uint32_t v = 0; v < vertexCount; v++) liveCount[v] = adjacency.getCount(v);
+
+            std::vector<uint32_t> cacheTime(vertexCount, 0);
+            std::vector<bool> emitted(triangleCount, false);
+            std::vector<uint32_t> deadEnd;
+            std::vector<uint32_t> candidates;
+            deadEnd.reserve(indices.size());
+            candidates.reserve(64);
+
+            std::vector<uint32_t> output;
+            output.reserve(indices.size());
+
+            uint32_t timeStamp = cacheSize + 1;
+            uint32_t cursor = 0;
+
+            // Find the next vertex with live triangles, first from the dead-end stack and then in input order.
+            auto skipDeadEnd = [&]() -> uint32_t
+            {
+                while (!deadEnd.empty())
+                {
+                    uint32_t v = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (liveCount[v] > 0) return v;
+                }
+                while (cursor < vertexCount)
+                {
+                    uint32_t v = cursor++;
+                    if (liveCount[v] > 0) return v;
+                }
+                return kInvalidIndex;
+            };
+
+            // Pick the candidate vertex that stays in the cache the longest while its remaining triangles are emitted.
+            auto getNextVertex = [&]() -> uint32_t
+            {
+                uint32_t best = kInvalidIndex;
+                int64_t bestPriority = -1;
+                for (uint32_t v : candidates)
+                {
+                    if (liveCount[v] == 0) continue;
+                    int64_t priority = 0;
+                    int64_t age = int64_t(timeStamp) - int64_t(cacheTime[v]);
+                    if (age + 2 * int64_t(liveCount[v]) <= int64_t(cacheSize)) priority = age;
+                    if (priority > bestPriority)
+                    {
+                        bestPriority = priority;
+                        best = v;
+                    }
+                }
+                return best != kInvalidIndex ? best : skipDeadEnd();
+            };
+
+            uint32_t fanning = skipDeadEnd();
+            while (fanning != kInvalidIndex)
+            {
+                candidates.clear();
+
+                // Emit all live triangles around the fanning vertex.
+                for (uint32_t i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; i++)
+                {
+                    uint32_t triangle = adjacency.triangles[i];
+                    if (emitted[triangle]) continue;
+
+                    for (uint32_t j = 0; j < 3; j++)
+                    {
+                        uint32_t v = indices[triangle * 3 + j];
+                        output.push_back(v);
+                        deadEnd.push_back(v);
+                        candidates.push_back(v);
+                        FALCOR_ASSERT(liveCount[v] > 0);
+                        liveCount[v]--;
+                        if (timeStamp - cacheTime[v] > cacheSize)
+                        {
+                            cacheTime[v] = timeStamp++;
+                        }
+                    }
+                    emitted[triangle] = true;
+                }
+
+                fanning = getNextVertex();
+            }
+
+            FALCOR_ASSERT(output.size() == indices.size());
+            indices = std::move(output);
+        }
+
+        std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount)
+        {
+            std::vector<uint32_t> remap(vertexCount, kInvalidIndex);
+            uint32_t nextIndex = 0;
+
+            for (uint32_t& index : indices)
+            {
+                FALCOR_ASSERT(index < vertexCount);
+                if (remap[index] == kInvalidIndex) remap[index] = nextIndex++;
+                index = remap[index];
+            }
+
+            // Place unreferenced vertices last, in their original order.
+            for (uint32_t& newIndex : remap)
+            {
+                if (newIndex == kInvalidIndex) newIndex = nextIndex++;
+            }
+
+            FALCOR_ASSERT(nextIndex == vertexCount);
+            return remap;
+        }
+
+        float computeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+        {
+            FALCOR_ASSERT(indices.size() % 3 == 0);
+            if (indices.empty()) return 0.f;
+
+            // Simulate a FIFO cache. A vertex is in the cache if it was inserted within the last 'cacheSize' insertions.
+            std::vector<uint64_t> insertTime(vertexCount, 0);
+            uint64_t time = cacheSize + 1;
+            uint64_t misses = 0;
+
+            for (uint32_t index : indices)
+            {
+                FALCOR_ASSERT(index < vertexCount);
+                if (time - insertTime[index] > cacheSize)
+                {
+                    insertTime[index] = time++;
+                    misses++;
+                }
+            }
+
+            return float(misses) / float(indices.size() / 3);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Helpers for optimizing the memory layout of indexed triangle meshes.
+        The functions operate on triangle list index buffers and are thread safe.
+    */
+    namespace MeshOptimizer
+    {
+        /** Default post-transform vertex cache size assumed by the optimizer.
+        */
+        static constexpr uint32_t kDefaultVertexCacheSize = 16;
+
+        /** Reorder triangles to improve post-transform vertex cache locality.
+            This implements the Tipsify algorithm (Sander et al. 2007), which runs in linear time.
+            The triangle winding is preserved, only the order of the triangles changes.
+            \param[in,out] indices Triangle list index buffer. The size must be a multiple of 3.
+            \param[in] vertexCount Number of vertices referenced by the index buffer.
+            \param[in] cacheSize Size of the simulated vertex cache.
+        */
+        FALCOR_API void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kDefaultVertexCacheSize);
+
+        /** Compute a vertex remapping that orders vertices by first use in the index buffer.
+            The index buffer is rewritten to use the new vertex order. Unreferenced vertices are placed last.
+            \param[in,out] indices Triangle list index buffer.
+            \param[in] vertexCount Number of vertices referenced by the index buffer.
+            \return Mapping from old to new vertex index.
+        */
+        FALCOR_API std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+        /** Compute the average cache miss ratio (ACMR), i.e. the number of vertex shader invocations per triangle, using a FIFO cache.
+            \param[in] indices Triangle list index buffer.
+            \param[in] vertexCount Number of vertices referenced by the index buffer.
+            \param[in] cacheSize Size of the simulated FIFO vertex cache.
+            \return Average number of cache misses per triangle.
+        */
+        FALCOR_API float computeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kDefaultVertexCacheSize);
+    }
+}
@@ -28,6 +28,7 @@
 #include "AsyncTextureLoader.h"
 #include "Core/API/Device.h"
 #include "Utils/Threading.h"
+#include "Utils/Timing/Profiler.h"
 
 namespace Falcor
 {
@@ -79,6 +80,8 @@ namespace Falcor
         // To avoid the upload heap growing too large, we synchronize the threads and
         // issue a global GPU flush at regular intervals.
 
+        TraceRecorder::setThreadName("Texture loader");
+
         while (true)
         {
             // Wait on condition until more work is ready.
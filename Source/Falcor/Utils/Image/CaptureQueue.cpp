@@ -0,0 +1,188 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CaptureQueue.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+
+namespace Falcor
+{
+    CaptureQueue::CaptureQueue(const Desc& desc)
+        : mDesc(desc)
+    {
+        startWorkers();
+    }
+
+    CaptureQueue::~CaptureQueue()
+    {
+        flush();
+        stopWorkers();
+    }
+
+    void CaptureQueue::setDesc(const Desc& desc)
+    {
+        flush();
+        stopWorkers();
+        mDesc = desc;
+        mFreeStagingBuffers.clear();
+        startWorkers();
+    }
+
+    void CaptureQueue::enqueue(RenderContext* pRenderContext, const Texture::SharedPtr& pTexture, const std::filesystem::path& path, Bitmap::FileFormat fileFormat, Bitmap::ExportFlags exportFlags)
+    {
+        FALCOR_ASSERT(pRenderContext && pTexture);
+        if (fileFormat == Bitmap::FileFormat::DdsFile) throw RuntimeError("CaptureQueue does not support saving to DDS.");
+        if (pTexture->getType() != Texture::Type::Texture2D) throw RuntimeError("CaptureQueue only supports 2D textures.");
+
+        // Hand over finished readbacks first, then wait for the oldest one if the ring is exhausted.
+        poll();
+        while (!mReadbacks.empty() && mReadbacks.size() >= std::max(1u, mDesc.readbackCount)) retireReadback();
+
+        Readback readback;
+        readback.image.width = pTexture->getWidth();
+        readback.image.height = pTexture->getHeight();
+        readback.image.format = pTexture->getFormat();
+        readback.image.path = path;
+        readback.image.fileFormat = fileFormat;
+        readback.image.exportFlags = exportFlags;
+
+        // HDR textures with less than 3 channels are expanded to RGBA32Float, as in Texture::captureToFile().
+        Texture::SharedPtr pSrc = pTexture;
+        if (getFormatType(pTexture->getFormat()) == FormatType::Float && getFormatChannelCount(pTexture->getFormat()) < 3)
+        {
+            pSrc = Texture::create2D(pTexture->getDevice().get(), pTexture->getWidth(), pTexture->getHeight(), ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::RenderTarget | ResourceBindFlags::ShaderResource);
+            pRenderContext->blit(pTexture->getSRV(0, 1, 0, 1), pSrc->getRTV(0, 0, 1));
+            readback.image.format = ResourceFormat::RGBA32Float;
+        }
+
+        Buffer::SharedPtr pStagingBuffer;
+        if (!mFreeStagingBuffers.empty())
+        {
+            pStagingBuffer = std::move(mFreeStagingBuffers.back());
+            mFreeStagingBuffers.pop_back();
+        }
+        readback.pTask = pRenderContext->asyncReadTextureSubresource(pSrc.get(), 0, pStagingBuffer);
+        mReadbacks.push_back(std::move(readback));
+    }
+
+    void CaptureQueue::poll()
+    {
+        while (!mReadbacks.empty() && mReadbacks.front().pTask->isReady()) retireReadback();
+    }
+
+    void CaptureQueue::flush()
+    {
+        while (!mReadbacks.empty()) retireReadback();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdle.wait(lock, [this] { return mJobs.empty() && mActiveJobCount == 0; });
+    }
+
+    uint32_t CaptureQueue::getPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return (uint32_t)(mReadbacks.size() + mJobs.size()) + mActiveJobCount;
+    }
+
+    void CaptureQueue::retireReadback()
+    {
+        FALCOR_ASSERT(!mReadbacks.empty());
+        Readback readback = std::move(mReadbacks.front());
+        mReadbacks.pop_front();
+
+        EncodeJob job;
+        job.image = std::move(readback.image);
+        job.data = readback.pTask->getData();
+
+        // Return the staging buffer to the ring.
+        if (mFreeStagingBuffers.size() < mDesc.readbackCount) mFreeStagingBuffers.push_back(readback.pTask->getStagingBuffer());
+
+        pushJob(std::move(job));
+    }
+
+    void CaptureQueue::pushJob(EncodeJob&& job)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mQueueNotFull.wait(lock, [this] { return mJobs.size() < std::max(1u, mDesc.queueSize); });
+        mJobs.push_back(std::move(job));
+        mJobAvailable.notify_one();
+    }
+
+    void CaptureQueue::workerMain()
+    {
+        while (true)
+        {
+            EncodeJob job;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mJobAvailable.wait(lock, [this] { return mTerminate || !mJobs.empty(); });
+                if (mJobs.empty()) return;
+                job = std::move(mJobs.front());
+                mJobs.pop_front();
+                mActiveJobCount++;
+            }
+            mQueueNotFull.notify_one();
+
+            const Image& image = job.image;
+            try
+            {
+                Bitmap::saveImage(image.path, image.width, image.height, image.fileFormat, image.exportFlags, image.format, true, job.data.data());
+            }
+            catch (const std::exception& e)
+            {
+                logError("Failed to write capture '{}': {}", image.path.string(), e.what());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mActiveJobCount--;
+                if (mJobs.empty() && mActiveJobCount == 0) mIdle.notify_all();
+            }
+        }
+    }
+
+    void CaptureQueue::startWorkers()
+    {
+        FALCOR_ASSERT(mWorkers.empty());
+        mTerminate = false;
+        for (uint32_t i = 0; i < std::max(1u, mDesc.workerCount); i++) mWorkers.emplace_back(&CaptureQueue::workerMain, this);
+    }
+
+    void CaptureQueue::stopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTerminate = true;
+        }
+        mJobAvailable.notify_all();
+        for (auto& worker : mWorkers) worker.join();
+        mWorkers.clear();
+    }
+}
@@ -0,0 +1,140 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Core/API/fwd.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/CopyContext.h"
+#include "Core/API/Formats.h"
+#include "Core/API/Texture.h"
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+    /** Pipelined capture of textures to image files.
+
+        Textures are copied into a ring of readback buffers and completed readbacks are handed to a pool of
+        encoder threads, so that capturing neither waits for the GPU nor for image encoding on the main thread.
+        When all readback buffers are in flight or the encoder queue is full, enqueue() blocks on the oldest
+        readback or on the encoders respectively, which bounds the memory used by pending images.
+    */
+    class FALCOR_API CaptureQueue
+    {
+    public:
+        struct Desc
+        {
+            uint32_t workerCount = 2;       ///< Number of encoder threads.
+            uint32_t readbackCount = 8;     ///< Number of readback buffers, i.e. the maximum number of copies in flight on the GPU.
+            uint32_t queueSize = 8;         ///< Maximum number of read back images waiting for an encoder thread.
+        };
+
+        CaptureQueue(const Desc& desc = Desc());
+
+        /** Destructor. Writes all pending images.
+        */
+        ~CaptureQueue();
+
+        /** Change the queue configuration. Pending images are written first.
+        */
+        void setDesc(const Desc& desc);
+        const Desc& getDesc() const { return mDesc; }
+
+        /** Queue a texture to be written to a file. Only 2D textures are supported.
+            \param[in] pRenderContext Render context used for the copy.
+            \param[in] pTexture The texture. Mip level 0 of array slice 0 is written.
+            \param[in] path The output file path.
+            \param[in] fileFormat Output file format.
+            \param[in] exportFlags Flags passed to Bitmap::saveImage().
+        */
+        void enqueue(RenderContext* pRenderContext, const Texture::SharedPtr& pTexture, const std::filesystem::path& path, Bitmap::FileFormat fileFormat, Bitmap::ExportFlags exportFlags);
+
+        /** Hand all completed readbacks to the encoder threads. Doesn't wait for the GPU.
+        */
+        void poll();
+
+        /** Block until all queued images have been written to disk.
+        */
+        void flush();
+
+        /** Get the number of images that have been queued but not yet written.
+        */
+        uint32_t getPendingCount() const;
+
+    private:
+        struct Image
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            ResourceFormat format = ResourceFormat::Unknown;
+            std::filesystem::path path;
+            Bitmap::FileFormat fileFormat;
+            Bitmap::ExportFlags exportFlags;
+        };
+
+        struct Readback
+        {
+            Image image;
+            CopyContext::ReadTextureTask::SharedPtr pTask;
+        };
+
+        struct EncodeJob
+        {
+            Image image;
+            std::vector<uint8_t> data;
+        };
+
+        void retireReadback();
+        void pushJob(EncodeJob&& job);
+        void workerMain();
+        void startWorkers();
+        void stopWorkers();
+
+        Desc mDesc;
+
+        // Main thread only.
+        std::deque<Readback> mReadbacks;
+        std::vector<Buffer::SharedPtr> mFreeStagingBuffers;
+
+        // Shared with the encoder threads, protected by mMutex.
+        mutable std::mutex mMutex;
+        std::condition_variable mJobAvailable;
+        std::condition_variable mQueueNotFull;
+        std::condition_variable mIdle;
+        std::deque<EncodeJob> mJobs;
+        uint32_t mActiveJobCount = 0;
+        bool mTerminate = false;
+
+        std::vector<std::thread> mWorkers;
+    };
+}
@@ -550,7 +550,7 @@ namespace Falcor
         return Bitmap::create(data.width, data.height, data.format, data.imageData.data());
     }
 
-    Texture::SharedPtr ImageIO::loadTextureFromDDS(Device* pDevice, const std::filesystem::path& path, bool loadAsSrgb)
+    Texture::SharedPtr ImageIO::loadTextureFromDDS(Device* pDevice, const std::filesystem::path& path, bool loadAsSrgb, Resource::BindFlags bindFlags)
     {
         ImportData data;
         try
@@ -568,16 +568,16 @@ namespace Falcor
         switch (data.type)
         {
         case Resource::Type::Texture1D:
-            pTex = Texture::create1D(pDevice, data.width, data.format, data.arraySize, data.mipLevels, data.imageData.data());
+            pTex = Texture::create1D(pDevice, data.width, data.format, data.arraySize, data.mipLevels, data.imageData.data(), bindFlags);
             break;
         case Resource::Type::Texture2D:
-            pTex = Texture::create2D(pDevice, data.width, data.height, data.format, data.arraySize, data.mipLevels, data.imageData.data());
+            pTex = Texture::create2D(pDevice, data.width, data.height, data.format, data.arraySize, data.mipLevels, data.imageData.data(), bindFlags);
             break;
         case Resource::Type::TextureCube:
-            pTex = Texture::createCube(pDevice, data.width, data.height, data.format, data.arraySize / 6, data.mipLevels, data.imageData.data());
+            pTex = Texture::createCube(pDevice, data.width, data.height, data.format, data.arraySize / 6, data.mipLevels, data.imageData.data(), bindFlags);
             break;
         case Resource::Type::Texture3D:
-            pTex = Texture::create3D(pDevice, data.width, data.height, data.depth, data.format, data.mipLevels, data.imageData.data());
+            pTex = Texture::create3D(pDevice, data.width, data.height, data.depth, data.format, data.mipLevels, data.imageData.data(), bindFlags);
             break;
         default:
             logWarning("Failed to load DDS image from '{}': Unrecognized texture type.", path);
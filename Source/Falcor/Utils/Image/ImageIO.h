@@ -91,9 +91,10 @@ namespace Falcor
             Throws an exception if the DDS file is malformed.
             \param[in] path Path of file to load.
             \param[in] loadAsSrgb If true, convert the image format property to a corresponding sRGB format if available. Image data is not changed.
+            \param[in] bindFlags The bind flags for the texture resource.
             \return Texture object containing image data if loading was successful. Otherwise, nullptr.
         */
-        static Texture::SharedPtr loadTextureFromDDS(Device* pDevice, const std::filesystem::path& path, bool loadAsSrgb);
+        static Texture::SharedPtr loadTextureFromDDS(Device* pDevice, const std::filesystem::path& path, bool loadAsSrgb, Resource::BindFlags bindFlags = Resource::BindFlags::ShaderResource);
 
         /** Saves a bitmap to a DDS file.
             Throws an exception if path is invalid or the image cannot be saved.
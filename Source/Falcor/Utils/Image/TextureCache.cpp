@@ -0,0 +1,290 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TextureCache.h"
+#include "Bitmap.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/API/Formats.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace Falcor
+{
+    namespace
+    {
+        const std::string kDirectory = "NVIDIA/Falcor/TextureCache";
+        const std::string kIndexDirectory = "index";
+
+        // Bump this version when the preprocessing changes in a way that invalidates existing cache entries.
+        const uint32_t kVersion = 1;
+
+        /** Entry in the index mapping a file path to the hash of its content.
+        */
+        struct IndexEntry
+        {
+            uint32_t version = 0;
+            uint32_t reserved = 0;
+            uint64_t size = 0;
+            int64_t lastWriteTime = 0;
+            SHA1::MD contentHash = {};
+        };
+
+        /** Returns a temporary path next to the given path that is unique to the calling thread.
+            Cache files are written to a temporary path and then renamed, so readers never see partially written files.
+        */
+        std::filesystem::path getTempPath(const std::filesystem::path& path)
+        {
+            auto tempPath = path;
+            size_t threadHash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+            tempPath.replace_filename(path.stem().string() + "." + std::to_string(threadHash) + ".tmp" + path.extension().string());
+            return tempPath;
+        }
+
+        bool isAlphaOpaque(const Bitmap& bitmap)
+        {
+            const ResourceFormat format = bitmap.getFormat();
+            FALCOR_ASSERT(getFormatChannelCount(format) == 4);
+            const uint32_t alphaBits = getNumChannelBits(format, 3);
+            const uint32_t alphaOffset = (getNumChannelBits(format, 0) + getNumChannelBits(format, 1) + getNumChannelBits(format, 2)) / 8;
+            const uint32_t bytesPerPixel = getFormatBytesPerBlock(format);
+
+            for (uint32_t y = 0; y < bitmap.getHeight(); y++)
+            {
+                const uint8_t* pRow = bitmap.getData() + (size_t)y * bitmap.getRowPitch();
+                for (uint32_t x = 0; x < bitmap.getWidth(); x++)
+                {
+                    const uint8_t* pAlpha = pRow + (size_t)x * bytesPerPixel + alphaOffset;
+                    if (alphaBits == 8)
+                    {
+                        if (*pAlpha != 0xff) return false;
+                    }
+                    else if (alphaBits == 16)
+                    {
+                        uint16_t alpha;
+                        std::memcpy(&alpha, pAlpha, sizeof(alpha));
+                        if (alpha != 0x3c00) return false; // 1.0 in half precision.
+                    }
+                    else if (alphaBits == 32)
+                    {
+                        float alpha;
+                        std::memcpy(&alpha, pAlpha, sizeof(alpha));
+                        if (alpha != 1.f) return false;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+    }
+
+    TextureCache::SharedPtr TextureCache::create(const std::filesystem::path& directory, const Settings& settings)
+    {
+        return SharedPtr(new TextureCache(directory, settings));
+    }
+
+    TextureCache::TextureCache(const std::filesystem::path& directory, const Settings& settings)
+        : mDirectory(directory)
+        , mSettings(settings)
+    {
+        std::filesystem::create_directories(mDirectory / kIndexDirectory);
+    }
+
+    std::filesystem::path TextureCache::getDefaultDirectory()
+    {
+        return getAppDataDirectory() / kDirectory;
+    }
+
+    std::filesystem::path TextureCache::findTexture(const std::filesystem::path& path, bool generateMipLevels) const
+    {
+        auto contentHash = getContentHash(path);
+        if (!contentHash) return {};
+
+        auto entryPath = getEntryPath(*contentHash, generateMipLevels);
+        if (!std::filesystem::exists(entryPath)) return {};
+
+        return entryPath;
+    }
+
+    Texture::SharedPtr TextureCache::loadTexture(Device* pDevice, const std::filesystem::path& path, bool generateMipLevels, bool loadAsSRGB, Resource::BindFlags bindFlags) const
+    {
+        // Cached textures may be block compressed, which only supports shader resource access.
+        if (bindFlags != Resource::BindFlags::ShaderResource) return nullptr;
+
+        auto entryPath = findTexture(path, generateMipLevels);
+        if (entryPath.empty()) return nullptr;
+
+        Texture::SharedPtr pTexture = ImageIO::loadTextureFromDDS(pDevice, entryPath, loadAsSRGB, bindFlags);
+        if (!pTexture)
+        {
+            logWarning("Failed to load cached texture '{}' for '{}'. Loading the texture file instead.", entryPath, path);
+            return nullptr;
+        }
+
+        // Report the original texture file as source so the texture is identified by it (e.g. in scene caches).
+        pTexture->setSourcePath(path);
+        return pTexture;
+    }
+
+    std::filesystem::path TextureCache::addTexture(const std::filesystem::path& path, bool generateMipLevels)
+    {
+        if (hasExtension(path, "dds"))
+        {
+            throw ArgumentError("Texture '{}' is a DDS file, which is loaded directly without preprocessing.", path);
+        }
+
+        auto contentHash = getContentHash(path);
+        if (!contentHash) throw RuntimeError("Failed to read texture file '{}'.", path);
+
+        auto entryPath = getEntryPath(*contentHash, generateMipLevels);
+        if (std::filesystem::exists(entryPath)) return entryPath;
+
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        if (!pBitmap) throw RuntimeError("Failed to load texture file '{}'.", path);
+
+        ImageIO::CompressionMode mode = chooseCompressionMode(*pBitmap, mSettings);
+
+        // Two channel images can only be stored block compressed. Others are not cached and are loaded from the texture file instead.
+        if (getFormatChannelCount(pBitmap->getFormat()) == 2 && mode != ImageIO::CompressionMode::BC5) return {};
+
+        std::filesystem::create_directories(entryPath.parent_path());
+        auto tempPath = getTempPath(entryPath);
+        try
+        {
+            ImageIO::saveToDDS(tempPath, *pBitmap, mode, generateMipLevels);
+            std::filesystem::rename(tempPath, entryPath);
+        }
+        catch (...)
+        {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            throw;
+        }
+
+        return entryPath;
+    }
+
+    ImageIO::CompressionMode TextureCache::chooseCompressionMode(const Bitmap& bitmap, const Settings& settings)
+    {
+        if (!settings.compress) return ImageIO::CompressionMode::None;
+
+        // Block compression requires the dimensions to be a multiple of 4. Store other images uncompressed instead of cropping them.
+        if (bitmap.getWidth() % 4 != 0 || bitmap.getHeight() % 4 != 0) return ImageIO::CompressionMode::None;
+
+        const ResourceFormat format = bitmap.getFormat();
+        const uint32_t channelCount = getFormatChannelCount(format);
+        const FormatType type = getFormatType(format);
+
+        if (type == FormatType::Float)
+        {
+            // BC6H stores RGB only, so images with alpha are only compressed if the alpha channel is constant one.
+            if (channelCount == 3 || (channelCount == 4 && isAlphaOpaque(bitmap))) return ImageIO::CompressionMode::BC6;
+            return ImageIO::CompressionMode::None;
+        }
+
+        if ((type != FormatType::Unorm && type != FormatType::UnormSrgb) || getNumChannelBits(format, 0) != 8) return ImageIO::CompressionMode::None;
+
+        switch (channelCount)
+        {
+        case 1:
+            return ImageIO::CompressionMode::BC4;
+        case 2:
+            return ImageIO::CompressionMode::BC5;
+        default:
+        {
+            bool isOpaque = channelCount == 3 || !doesFormatHaveAlpha(format) || isAlphaOpaque(bitmap);
+            return isOpaque && settings.compactColor ? ImageIO::CompressionMode::BC1 : ImageIO::CompressionMode::BC7;
+        }
+        }
+    }
+
+    std::optional<SHA1::MD> TextureCache::getContentHash(const std::filesystem::path& path) const
+    {
+        std::error_code ec;
+        const uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec) return {};
+        const int64_t lastWriteTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        if (ec) return {};
+
+        const std::string pathStr = path.string();
+        const auto indexPath = mDirectory / kIndexDirectory / SHA1::toString(SHA1::compute(pathStr.data(), pathStr.size()));
+
+        // Use the stored hash if the file is unchanged.
+        IndexEntry entry;
+        {
+            std::ifstream fs(indexPath, std::ios_base::binary);
+            if (fs.read(reinterpret_cast<char*>(&entry), sizeof(entry)) && entry.version == kVersion && entry.size == size && entry.lastWriteTime == lastWriteTime)
+            {
+                return entry.contentHash;
+            }
+        }
+
+        MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+        if (!file.isOpen()) return {};
+
+        entry = {};
+        entry.version = kVersion;
+        entry.size = size;
+        entry.lastWriteTime = lastWriteTime;
+        entry.contentHash = SHA1::compute(file.getData(), file.getSize());
+
+        // Update the index. Failing to do so only means the hash is recomputed next time.
+        auto tempPath = getTempPath(indexPath);
+        {
+            std::ofstream fs(tempPath, std::ios_base::binary);
+            fs.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+        std::filesystem::rename(tempPath, indexPath, ec);
+        if (ec) std::filesystem::remove(tempPath, ec);
+
+        return entry.contentHash;
+    }
+
+    std::filesystem::path TextureCache::getEntryPath(const SHA1::MD& contentHash, bool generateMipLevels) const
+    {
+        SHA1 sha1;
+        sha1.update(kVersion);
+        sha1.update(contentHash.data(), contentHash.size());
+        sha1.update(generateMipLevels);
+        // Caches with different settings can share a directory without using each other's entries.
+        sha1.update(mSettings.compress);
+        sha1.update(mSettings.compactColor);
+        auto key = SHA1::toString(sha1.finalize());
+
+        // Spread entries over subdirectories to keep directory sizes manageable.
+        return mDirectory / key.substr(0, 2) / (key + ".dds");
+    }
+}
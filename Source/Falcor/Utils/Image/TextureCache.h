@@ -0,0 +1,131 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "ImageIO.h"
+#include "Core/Macros.h"
+#include "Core/API/fwd.h"
+#include "Core/API/Resource.h"
+#include "Core/API/Texture.h"
+#include "Utils/CryptoUtils.h"
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+namespace Falcor
+{
+    /** Content-addressed cache of preprocessed textures.
+
+        Texture files are preprocessed into DDS files holding the full mip chain, optionally block compressed.
+        Cache entries are addressed by the hash of the source file content and the preprocessing settings, so an entry
+        is used for any file with identical content and becomes stale as soon as the source file changes.
+
+        The cache is populated offline with the TextureCacheBuilder tool (or addTexture()) and is used by
+        TextureManager to load textures without decoding the source image and generating mips at runtime.
+        All operations are thread-safe.
+    */
+    class FALCOR_API TextureCache
+    {
+    public:
+        using SharedPtr = std::shared_ptr<TextureCache>;
+
+        /** Settings for preprocessing textures in addTexture().
+        */
+        struct Settings
+        {
+            bool compress = true;           ///< Block compress textures (BC4 for one channel, BC5 for two channels, BC6H for HDR and BC7 for color).
+            bool compactColor = false;      ///< Use BC1 instead of BC7 for opaque color textures. Halves the memory at lower quality.
+        };
+
+        /** Create a texture cache.
+            \param[in] directory Cache directory. Created if it doesn't exist.
+            \param[in] settings Settings for preprocessing textures.
+            \return A new object.
+        */
+        static SharedPtr create(const std::filesystem::path& directory = getDefaultDirectory(), const Settings& settings = {});
+
+        /** Get the default cache directory.
+        */
+        static std::filesystem::path getDefaultDirectory();
+
+        /** Get the cache directory.
+        */
+        const std::filesystem::path& getDirectory() const { return mDirectory; }
+
+        /** Get the settings for preprocessing textures.
+        */
+        const Settings& getSettings() const { return mSettings; }
+
+        /** Find the cached preprocessed texture for a texture file.
+            \param[in] path Full path of the source texture file.
+            \param[in] generateMipLevels Whether the full mip-chain is needed.
+            \return Path of the cached DDS file, or an empty path if the texture is not cached.
+        */
+        std::filesystem::path findTexture(const std::filesystem::path& path, bool generateMipLevels) const;
+
+        /** Load a texture from the cache.
+            \param[in] pDevice GPU device.
+            \param[in] path Full path of the source texture file.
+            \param[in] generateMipLevels Whether the full mip-chain is needed.
+            \param[in] loadAsSRGB Load the texture as sRGB format if supported, otherwise linear color.
+            \param[in] bindFlags The bind flags for the texture resource.
+            \return The texture with its source path set to the source texture file, or nullptr if the texture is not cached.
+                    Textures are only loaded from the cache if bindFlags is ShaderResource.
+        */
+        Texture::SharedPtr loadTexture(Device* pDevice, const std::filesystem::path& path, bool generateMipLevels, bool loadAsSRGB, Resource::BindFlags bindFlags = Resource::BindFlags::ShaderResource) const;
+
+        /** Preprocess a texture file and add it to the cache.
+            Textures that are already cached are not preprocessed again.
+            Two channel images that are not block compressed can't be stored in the cache and are skipped.
+            \param[in] path Full path of the source texture file.
+            \param[in] generateMipLevels Whether the full mip-chain should be generated.
+            \return Path of the cached DDS file, or an empty path if the texture is skipped.
+                    Throws an exception if the texture can't be preprocessed.
+        */
+        std::filesystem::path addTexture(const std::filesystem::path& path, bool generateMipLevels);
+
+        /** Choose the block compression mode for a bitmap.
+            \param[in] bitmap Source image.
+            \param[in] settings Preprocessing settings.
+            \return Compression mode, or CompressionMode::None if the image is stored uncompressed.
+        */
+        static ImageIO::CompressionMode chooseCompressionMode(const Bitmap& bitmap, const Settings& settings);
+
+    private:
+        TextureCache(const std::filesystem::path& directory, const Settings& settings);
+
+        /** Get the content hash of a file. The hash is stored in an index keyed by the file path and
+            is only recomputed if the size or write time of the file changed.
+        */
+        std::optional<SHA1::MD> getContentHash(const std::filesystem::path& path) const;
+
+        std::filesystem::path getEntryPath(const SHA1::MD& contentHash, bool generateMipLevels) const;
+
+        std::filesystem::path mDirectory;
+        Settings mSettings;
+    };
+}
@@ -27,10 +27,13 @@
  **************************************************************************/
 #include "TextureManager.h"
 #include "Core/API/Device.h"
+#include "Core/Platform/MemoryMappedFile.h"
 #include "Utils/Logger.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 
-#include <execution>
+#include <atomic>
+#include <optional>
+#include <set>
 
 // Temporarily disable asynchronous texture loader until Falcor supports parallel GPU work submission.
 // Until then `TextureManager` should only called from the main thread.
@@ -42,6 +45,13 @@ namespace Falcor
     {
         const size_t kMaxTextureHandleCount = std::numeric_limits<uint32_t>::max();
         static_assert(TextureManager::TextureHandle::kInvalidID >= kMaxTextureHandleCount);
+
+        std::optional<SHA1::MD> computeFileContentHash(const std::filesystem::path& path)
+        {
+            MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+            if (!file.isOpen()) return {};
+            return SHA1::compute(file.getData(), file.getSize());
+        }
     }
 
     TextureManager::SharedPtr TextureManager::create(std::shared_ptr<Device> pDevice, size_t maxTextureCount, size_t threadCount)
@@ -107,6 +117,18 @@ namespace Falcor
         return handle;
     }
 
+    void TextureManager::setDeduplicateByContent(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDeduplicateByContent = enabled;
+    }
+
+    bool TextureManager::isDeduplicatingByContent() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mDeduplicateByContent;
+    }
+
     TextureManager::TextureHandle TextureManager::loadUdimTexture(const std::filesystem::path& path, bool generateMipLevels, bool loadAsSRGB, Resource::BindFlags bindFlags, bool async, const SearchDirectories* searchDirectories, size_t* loadedTextureCount)
     {
         std::string filename = path.filename().string();
@@ -193,11 +215,30 @@ namespace Falcor
         std::unique_lock<std::mutex> lock(mMutex);
         const TextureKey textureKey(fullPath, generateMipLevels, loadAsSRGB, bindFlags);
 
+        // If deduplicating by content, hash the file content of textures that are not already managed.
+        // The hashing is done outside the critical section, so the maps are searched again afterwards.
+        std::optional<ContentKey> contentKey;
+        if (mDeduplicateByContent && mKeyToHandle.find(textureKey) == mKeyToHandle.end())
+        {
+            lock.unlock();
+            if (auto contentHash = computeFileContentHash(fullPath)) contentKey.emplace(*contentHash, generateMipLevels, loadAsSRGB, bindFlags);
+            lock.lock();
+        }
+        auto contentIt = contentKey ? mContentToHandle.find(*contentKey) : mContentToHandle.end();
+
         if (auto it = mKeyToHandle.find(textureKey); it != mKeyToHandle.end())
         {
             // Texture is already managed. Return its handle.
             handle = it->second;
         }
+        else if (contentIt != mContentToHandle.end())
+        {
+            // Texture with identical file content is already managed. Share its handle.
+            handle = contentIt->second;
+            mKeyToHandle[textureKey] = handle;
+            mDuplicateCount[handle.getID()]++;
+            logDebug("Texture '{}' has identical content to an already managed texture, sharing it.", fullPath);
+        }
         else
         {
             if (mUseDeferredLoading)
@@ -208,6 +249,7 @@ namespace Falcor
 
                 // Add to key-to-handle map.
                 mKeyToHandle[textureKey] = handle;
+                if (contentKey) mContentToHandle[*contentKey] = handle;
 
                 // Return early.
                 return handle;
@@ -222,6 +264,7 @@ namespace Falcor
 
             // Add to key-to-handle map.
             mKeyToHandle[textureKey] = handle;
+            if (contentKey) mContentToHandle[*contentKey] = handle;
 
             // Function called by the async texture loader when loading finishes.
             // It's called by a worker thread so needs to acquire the mutex before changing any state.
@@ -245,7 +288,7 @@ namespace Falcor
             mAsyncTextureLoader.loadFromFile(fullPath, generateMipLevels, loadAsSRGB, bindFlags, callback);
 #else
             // Load texture from main thread.
-            Texture::SharedPtr pTexture = Texture::createFromFile(mpDevice.get(), fullPath, generateMipLevels, loadAsSRGB, bindFlags);
+            Texture::SharedPtr pTexture = loadTextureFromFile(fullPath, generateMipLevels, loadAsSRGB, bindFlags);
 
             // Add new texture desc.
             TextureDesc desc = { TextureState::Loaded, pTexture };
@@ -253,6 +296,7 @@ namespace Falcor
 
             // Add to key-to-handle map.
             mKeyToHandle[textureKey] = handle;
+            if (contentKey) mContentToHandle[*contentKey] = handle;
 
             // Add to texture-to-handle map.
             if (pTexture) mTextureToHandle[pTexture.get()] = handle;
@@ -304,23 +348,24 @@ namespace Falcor
         };
 
         // Get a list of textures to load.
+        // A handle can be referenced by multiple keys when deduplicating by content, so only queue it once.
         std::vector<Job> jobs;
+        std::set<uint32_t> queuedIDs;
         for (auto& [key, handle] : mKeyToHandle)
         {
             auto& desc = getDesc(handle);
-            if (desc.state == TextureState::Referenced)
+            if (desc.state == TextureState::Referenced && queuedIDs.insert(handle.getID()).second)
                 jobs.push_back(Job{key, handle});
         }
 
         // Load textures in parallel.
         std::atomic<size_t> texturesLoaded;
-        NumericRange<size_t> jobRange(0, jobs.size());
-        std::for_each(std::execution::par_unseq, jobRange.begin(), jobRange.end(),
+        Threading::parallelFor(0, jobs.size(),
             [&](size_t i)
             {
                 const auto& job = jobs[i];
                 auto& desc = getDesc(job.handle);
-                desc.pTexture = Texture::createFromFile(mpDevice.get(), job.key.fullPath, job.key.generateMipLevels, job.key.loadAsSRGB, job.key.bindFlags);
+                desc.pTexture = loadTextureFromFile(job.key.fullPath, job.key.generateMipLevels, job.key.loadAsSRGB, job.key.bindFlags);
                 logDebug("Loading texture from '{}'", job.key.fullPath);
                 if (texturesLoaded.fetch_add(1) % 10 == 9)
                 {
@@ -328,7 +373,7 @@ namespace Falcor
                     std::lock_guard<std::mutex> lock(mpDevice->getGlobalGfxMutex());
                     mpDevice->flushAndSync();
                 }
-            }
+            }, 1
         );
         mpDevice->flushAndSync();
 
@@ -361,8 +406,18 @@ namespace Falcor
 
         // Remove handle from maps.
         // Note not all handles exist in key-to-handle map so search for it. This can be optimized if needed.
-        auto it = std::find_if(mKeyToHandle.begin(), mKeyToHandle.end(), [handle](const auto& keyVal) { return keyVal.second == handle; });
-        if (it != mKeyToHandle.end()) mKeyToHandle.erase(it);
+        // A handle can be referenced by multiple keys when deduplicating by content.
+        auto eraseHandle = [handle](auto& map)
+        {
+            for (auto it = map.begin(); it != map.end();)
+            {
+                if (it->second == handle) it = map.erase(it);
+                else ++it;
+            }
+        };
+        eraseHandle(mKeyToHandle);
+        eraseHandle(mContentToHandle);
+        mDuplicateCount.erase(handle.getID());
 
         if (desc.pTexture)
         {
@@ -451,9 +506,31 @@ namespace Falcor
             s.textureMemoryInBytes += t.pTexture->getTextureSizeInBytes();
             if (isCompressedFormat(t.pTexture->getFormat())) s.textureCompressedCount++;
         }
+        for (const auto& [id, count] : mDuplicateCount)
+        {
+            const auto& pTexture = mTextureDescs[id].pTexture;
+            if (!pTexture)
+                continue;
+            s.textureDeduplicatedCount += count;
+            s.textureDeduplicatedMemoryInBytes += count * pTexture->getTextureSizeInBytes();
+        }
         return s;
     }
 
+    Texture::SharedPtr TextureManager::loadTextureFromFile(const std::filesystem::path& fullPath, bool generateMipLevels, bool loadAsSRGB, Resource::BindFlags bindFlags) const
+    {
+        if (mpTextureCache)
+        {
+            if (auto pTexture = mpTextureCache->loadTexture(mpDevice.get(), fullPath, generateMipLevels, loadAsSRGB, bindFlags))
+            {
+                logDebug("Loaded texture '{}' from texture cache.", fullPath);
+                return pTexture;
+            }
+        }
+
+        return Texture::createFromFile(mpDevice.get(), fullPath, generateMipLevels, loadAsSRGB, bindFlags);
+    }
+
     TextureManager::TextureHandle TextureManager::addDesc(const TextureDesc& desc)
     {
         TextureHandle handle;
@@ -27,11 +27,13 @@
  **************************************************************************/
 #pragma once
 #include "AsyncTextureLoader.h"
+#include "TextureCache.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
 #include "Core/Program/ShaderVar.h"
+#include "Utils/CryptoUtils.h"
 #include <condition_variable>
 #include <limits>
 #include <map>
@@ -75,6 +77,8 @@ namespace Falcor
             uint64_t textureTexelCount = 0;             ///< Total number of texels in all textures.
             uint64_t textureTexelChannelCount = 0;      ///< Total number of texel channels in all textures.
             uint64_t textureMemoryInBytes = 0;          ///< Total memory in bytes used by the textures.
+            uint64_t textureDeduplicatedCount = 0;      ///< Number of texture files that share an already loaded texture with identical file content.
+            uint64_t textureDeduplicatedMemoryInBytes = 0; ///< Memory in bytes saved by sharing textures with identical file content.
         };
 
         /** Handle to a managed texture.
@@ -135,6 +139,29 @@ namespace Falcor
         */
         TextureHandle addTexture(const Texture::SharedPtr& pTexture);
 
+        /** Enable/disable deduplication of textures by file content.
+            When enabled, loadTexture() hashes the content of texture files. Files with identical content that are loaded
+            with the same settings (e.g. copies of an image stored under different names) share one texture and handle.
+            This only affects subsequent calls to loadTexture().
+            \param[in] enabled True to enable deduplication by content.
+        */
+        void setDeduplicateByContent(bool enabled);
+
+        /** Returns true if textures are deduplicated by file content.
+        */
+        bool isDeduplicatingByContent() const;
+
+        /** Set the cache of preprocessed textures.
+            When set, loadTexture() loads textures from the cache if available, instead of decoding the texture file
+            and generating mips at runtime. Should be set before loading textures.
+            \param[in] pTextureCache Texture cache, or nullptr to disable.
+        */
+        void setTextureCache(const TextureCache::SharedPtr& pTextureCache) { mpTextureCache = pTextureCache; }
+
+        /** Get the cache of preprocessed textures, or nullptr if not used.
+        */
+        const TextureCache::SharedPtr& getTextureCache() const { return mpTextureCache; }
+
         /** Requst loading a texture from file.
             This will add the texture to the set of managed textures. The function returns a handle immediately.
             If asynchronous loading is requested, the texture data will not be available until loading completes.
@@ -246,6 +273,32 @@ namespace Falcor
             }
         };
 
+        /** Key to identify a texture by its file content.
+        */
+        struct ContentKey
+        {
+            SHA1::MD contentHash;
+            bool generateMipLevels;
+            bool loadAsSRGB;
+            Resource::BindFlags bindFlags;
+
+            ContentKey(const SHA1::MD& hash, bool mips, bool srgb, Resource::BindFlags flags)
+                : contentHash(hash), generateMipLevels(mips), loadAsSRGB(srgb), bindFlags(flags)
+            {}
+
+            bool operator<(const ContentKey& rhs) const
+            {
+                if (contentHash != rhs.contentHash) return contentHash < rhs.contentHash;
+                else if (generateMipLevels != rhs.generateMipLevels) return generateMipLevels < rhs.generateMipLevels;
+                else if (loadAsSRGB != rhs.loadAsSRGB) return loadAsSRGB < rhs.loadAsSRGB;
+                else return bindFlags < rhs.bindFlags;
+            }
+        };
+
+        /** Load a texture from file, using the texture cache if available.
+        */
+        Texture::SharedPtr loadTextureFromFile(const std::filesystem::path& fullPath, bool generateMipLevels, bool loadAsSRGB, Resource::BindFlags bindFlags) const;
+
         TextureHandle addDesc(const TextureDesc& desc);
         TextureDesc& getDesc(const TextureHandle& handle);
 
@@ -259,6 +312,8 @@ namespace Falcor
         std::vector<TextureHandle> mFreeList;                       ///< List of unused handles.
         std::map<TextureKey, TextureHandle> mKeyToHandle;           ///< Map from texture key to handle.
         std::map<const Texture*, TextureHandle> mTextureToHandle;   ///< Map from texture ptr to handle.
+        std::map<ContentKey, TextureHandle> mContentToHandle;       ///< Map from texture file content to handle. Only used when deduplicating by content.
+        std::map<uint32_t, uint32_t> mDuplicateCount;               ///< Number of additional texture files sharing a texture due to identical content, indexed by handle ID.
         /// Map from UDIM-1001 to an actual textureID, -1 if the texture does not exist (e.g., there is 1001 and 1003, so 1002 [1] == -1)
         std::vector<int32_t> mUdimIndirection;
         /// For each udim indirection range, writes (at the first element), how long that range is (there is 0 everywhere else)
@@ -270,7 +325,9 @@ namespace Falcor
         mutable Buffer::SharedPtr mpUdimIndirection;
 
         bool mUseDeferredLoading = false;
+        bool mDeduplicateByContent = false;
 
+        TextureCache::SharedPtr mpTextureCache;                     ///< Cache of preprocessed textures, or nullptr if not used.
         AsyncTextureLoader mAsyncTextureLoader;                     ///< Utility for asynchronous texture loading.
         size_t mLoadRequestsInProgress = 0;                         ///< Number of load requests currently in progress.
 
@@ -38,6 +38,7 @@
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtx/matrix_operation.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 #include <fmt/format.h>
 #include "glm/packing.hpp"
 #include "Utils/Math/Vector.h"
@@ -288,6 +289,23 @@ namespace rmcv
         return toRMCV(glm::inverse(toGLM(m)));
     }
 
+    /** Inverse of an affine transform, i.e. a matrix whose last row is (0, 0, 0, 1).
+        Only the upper 3x3 part is inverted, which is cheaper than inverse().
+    */
+    template<typename T>
+    matrix<4, 4, T> affineInverse(const matrix<4, 4, T>& m)
+    {
+        return toRMCV(glm::affineInverse(toGLM(m)));
+    }
+
+    /** Returns true if the matrix is an affine transform, i.e. the last row is (0, 0, 0, 1).
+    */
+    template<typename T>
+    bool isAffine(const matrix<4, 4, T>& m)
+    {
+        return m[3] == vec<4, T>(T(0), T(0), T(0), T(1));
+    }
+
     template<typename Matrix>
     Matrix identity()
     {
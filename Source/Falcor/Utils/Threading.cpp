@@ -27,68 +27,366 @@
  **************************************************************************/
 #include "Threading.h"
 #include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Utils/Timing/Profiler.h"
+#include <atomic>
+#include <deque>
+#include <exception>
 
 namespace Falcor
 {
+    struct Threading::TaskState
+    {
+        std::function<void(void)> func;
+        std::atomic<bool> done = false;
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<std::shared_ptr<TaskState>> continuations;
+    };
+
     namespace
     {
+        using TaskStatePtr = std::shared_ptr<Threading::TaskState>;
+
+        class ThreadPool
+        {
+        public:
+            ThreadPool(uint32_t threadCount)
+            {
+                mWorkers.resize(threadCount);
+                for (auto& pWorker : mWorkers) pWorker = std::make_unique<Worker>();
+                for (uint32_t i = 0; i < threadCount; ++i) mWorkers[i]->thread = std::thread(&ThreadPool::workerMain, this, i);
+            }
+
+            ~ThreadPool()
+            {
+                waitIdle();
+                {
+                    std::lock_guard<std::mutex> lock(mWakeMutex);
+                    mTerminate = true;
+                }
+                mWakeCondition.notify_all();
+                for (auto& pWorker : mWorkers) pWorker->thread.join();
+            }
+
+            uint32_t getThreadCount() const { return (uint32_t)mWorkers.size(); }
+
+            bool isWorkerThread() const { return sCurrentPool == this; }
+
+            /** Register a task that will be enqueued now or later (as a continuation).
+            */
+            void addPending() { mPendingCount.fetch_add(1); }
+
+            /** Push a task to the current worker's queue, or to the shared queue if called from a non-worker thread.
+            */
+            void enqueue(TaskStatePtr pTask)
+            {
+                // Count the task before publishing it so a worker popping it right away can never decrement first.
+                {
+                    std::lock_guard<std::mutex> lock(mWakeMutex);
+                    mQueuedCount.fetch_add(1);
+                }
+
+                if (isWorkerThread())
+                {
+                    Worker& worker = *mWorkers[sWorkerIndex];
+                    std::lock_guard<std::mutex> lock(worker.mutex);
+                    worker.queue.push_back(std::move(pTask));
+                }
+                else
+                {
+                    std::lock_guard<std::mutex> lock(mSharedMutex);
+                    mSharedQueue.push_back(std::move(pTask));
+                }
+
+                mWakeCondition.notify_one();
+            }
+
+            /** Try to execute a single pending task on the calling worker thread.
+                \return True if a task was executed.
+            */
+            bool runOne()
+            {
+                FALCOR_ASSERT(isWorkerThread());
+                TaskStatePtr pTask = pop(sWorkerIndex);
+                if (!pTask) return false;
+                execute(pTask);
+                return true;
+            }
+
+            void waitIdle()
+            {
+                FALCOR_ASSERT(!isWorkerThread());
+                std::unique_lock<std::mutex> lock(mIdleMutex);
+                mIdleCondition.wait(lock, [this]() { return mPendingCount.load() == 0; });
+            }
+
+        private:
+            struct Worker
+            {
+                std::mutex mutex;
+                std::deque<TaskStatePtr> queue;
+                std::thread thread;
+            };
+
+            TaskStatePtr pop(uint32_t workerIndex)
+            {
+                TaskStatePtr pTask;
+
+                // Own queue first (LIFO for locality), then the shared queue, then steal from other workers (FIFO).
+                {
+                    Worker& worker = *mWorkers[workerIndex];
+                    std::lock_guard<std::mutex> lock(worker.mutex);
+                    if (!worker.queue.empty())
+                    {
+                        pTask = std::move(worker.queue.back());
+                        worker.queue.pop_back();
+                    }
+                }
+                if (!pTask)
+                {
+                    std::lock_guard<std::mutex> lock(mSharedMutex);
+                    if (!mSharedQueue.empty())
+                    {
+                        pTask = std::move(mSharedQueue.front());
+                        mSharedQueue.pop_front();
+                    }
+                }
+                for (size_t i = 1; !pTask && i < mWorkers.size(); ++i)
+                {
+                    Worker& victim = *mWorkers[(workerIndex + i) % mWorkers.size()];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (!victim.queue.empty())
+                    {
+                        pTask = std::move(victim.queue.front());
+                        victim.queue.pop_front();
+                    }
+                }
+
+                if (pTask) mQueuedCount.fetch_sub(1);
+                return pTask;
+            }
+
+            void execute(const TaskStatePtr& pTask)
+            {
+                try
+                {
+                    pTask->func();
+                }
+                catch (...)
+                {
+                    pTask->exception = std::current_exception();
+                }
+                pTask->func = nullptr;
+
+                std::vector<TaskStatePtr> continuations;
+                {
+                    std::lock_guard<std::mutex> lock(pTask->mutex);
+                    pTask->done = true;
+                    continuations.swap(pTask->continuations);
+                }
+                pTask->condition.notify_all();
+
+                for (auto& pContinuation : continuations) enqueue(std::move(pContinuation));
+
+                if (mPendingCount.fetch_sub(1) == 1)
+                {
+                    std::lock_guard<std::mutex> lock(mIdleMutex);
+                    mIdleCondition.notify_all();
+                }
+            }
+
+            void workerMain(uint32_t workerIndex)
+            {
+                sCurrentPool = this;
+                sWorkerIndex = workerIndex;
+                TraceRecorder::setThreadName(fmt::format("Worker {}", workerIndex));
+
+                while (true)
+                {
+                    if (TaskStatePtr pTask = pop(workerIndex))
+                    {
+                        execute(pTask);
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(mWakeMutex);
+                    mWakeCondition.wait(lock, [this]() { return mTerminate || mQueuedCount.load() > 0; });
+                    if (mTerminate && mQueuedCount.load() == 0) break;
+                }
+
+                sCurrentPool = nullptr;
+            }
+
+            std::vector<std::unique_ptr<Worker>> mWorkers;
+
+            std::mutex mSharedMutex;
+            std::deque<TaskStatePtr> mSharedQueue;
+
+            std::mutex mWakeMutex;
+            std::condition_variable mWakeCondition;
+            std::atomic<size_t> mQueuedCount = 0;   ///< Number of tasks currently sitting in any queue.
+            bool mTerminate = false;
+
+            std::mutex mIdleMutex;
+            std::condition_variable mIdleCondition;
+            std::atomic<size_t> mPendingCount = 0;  ///< Number of dispatched tasks (including continuations) that have not finished yet.
+
+            static thread_local ThreadPool* sCurrentPool;
+            static thread_local uint32_t sWorkerIndex;
+        };
+
+        thread_local ThreadPool* ThreadPool::sCurrentPool = nullptr;
+        thread_local uint32_t ThreadPool::sWorkerIndex = 0;
+
         struct ThreadingData
         {
-            bool initialized = false;
-            std::vector<std::thread> threads;
-            uint32_t current;
+            std::unique_ptr<ThreadPool> pPool;
         } gData; // TODO: REMOVEGLOBAL
+
+        TaskStatePtr createTaskState(const std::function<void(void)>& func)
+        {
+            auto pState = std::make_shared<Threading::TaskState>();
+            pState->func = func;
+            return pState;
+        }
     }
 
     void Threading::start(uint32_t threadCount)
     {
-        if (gData.initialized) return;
+        if (gData.pPool) return;
 
-        gData.threads.resize(threadCount);
-        gData.initialized = true;
+        if (threadCount == 0) threadCount = getLogicalThreadCount();
+        gData.pPool = std::make_unique<ThreadPool>(threadCount);
     }
 
     void Threading::shutdown()
     {
-        for (auto& t : gData.threads)
-        {
-            if (t.joinable()) t.join();
-        }
+        gData.pPool.reset();
+    }
 
-        gData.initialized = false;
+    bool Threading::isStarted()
+    {
+        return gData.pPool != nullptr;
     }
 
-    Threading::Task Threading::dispatchTask(const std::function<void(void)>& func)
+    uint32_t Threading::getThreadCount()
     {
-        FALCOR_ASSERT(gData.initialized);
+        return gData.pPool ? gData.pPool->getThreadCount() : 0;
+    }
+
+    bool Threading::isWorkerThread()
+    {
+        return gData.pPool && gData.pPool->isWorkerThread();
+    }
 
-        std::thread& t = gData.threads[gData.current];
-        if (t.joinable()) t.join();
-        t = std::thread(func);
-        gData.current = (gData.current + 1) % gData.threads.size();
+    Threading::Task Threading::dispatchTask(const std::function<void(void)>& func)
+    {
+        if (!gData.pPool) throw RuntimeError("Threading::dispatchTask() called before Threading::start().");
 
-        return Task();
+        TaskStatePtr pState = createTaskState(func);
+        gData.pPool->addPending();
+        gData.pPool->enqueue(pState);
+        return Task(pState);
     }
 
     void Threading::finish()
     {
-        for (auto& t : gData.threads)
+        if (gData.pPool) gData.pPool->waitIdle();
+    }
+
+    void Threading::parallelForRange(size_t begin, size_t end, const std::function<void(size_t, size_t)>& func, size_t grainSize)
+    {
+        if (begin >= end) return;
+
+        const size_t count = end - begin;
+        const uint32_t threadCount = getThreadCount();
+        if (grainSize == 0) grainSize = std::max<size_t>(1, count / (std::max(1u, threadCount) * 4));
+        const size_t chunkCount = (count + grainSize - 1) / grainSize;
+
+        if (threadCount == 0 || chunkCount == 1)
         {
-            if (t.joinable()) t.join();
+            for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize) func(chunkBegin, std::min(end, chunkBegin + grainSize));
+            return;
         }
+
+        // Helper tasks and the calling thread grab chunks from a shared counter until all chunks are done.
+        std::atomic<size_t> nextChunk = 0;
+        std::mutex exceptionMutex;
+        std::exception_ptr exception;
+
+        auto runChunks = [&]()
+        {
+            size_t chunk;
+            while ((chunk = nextChunk.fetch_add(1)) < chunkCount)
+            {
+                const size_t chunkBegin = begin + chunk * grainSize;
+                try
+                {
+                    func(chunkBegin, std::min(end, chunkBegin + grainSize));
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!exception) exception = std::current_exception();
+                }
+            }
+        };
+
+        const size_t helperCount = std::min<size_t>(threadCount, chunkCount - 1);
+        std::vector<Task> helpers;
+        helpers.reserve(helperCount);
+        for (size_t i = 0; i < helperCount; ++i) helpers.push_back(dispatchTask(runChunks));
+
+        runChunks();
+        for (auto& helper : helpers) helper.finish();
+
+        if (exception) std::rethrow_exception(exception);
     }
 
-    Threading::Task::Task()
+    bool Threading::Task::isRunning() const
     {
+        return mpState && !mpState->done.load();
     }
 
-    bool Threading::Task::isRunning()
+    void Threading::Task::finish()
     {
-        FALCOR_UNIMPLEMENTED();
+        if (!mpState) return;
+
+        if (isWorkerThread())
+        {
+            // Execute other pending work instead of blocking the worker.
+            while (!mpState->done.load())
+            {
+                if (!gData.pPool->runOne()) std::this_thread::yield();
+            }
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(mpState->mutex);
+            mpState->condition.wait(lock, [this]() { return mpState->done.load(); });
+        }
+
+        if (mpState->exception) std::rethrow_exception(mpState->exception);
     }
 
-    void Threading::Task::finish()
+    Threading::Task Threading::Task::then(const std::function<void(void)>& func)
     {
-        FALCOR_UNIMPLEMENTED();
+        FALCOR_ASSERT(mpState);
+        if (!gData.pPool) throw RuntimeError("Threading::Task::then() called before Threading::start().");
+
+        TaskStatePtr pContinuation = createTaskState(func);
+        gData.pPool->addPending();
+
+        bool dispatchNow = false;
+        {
+            std::lock_guard<std::mutex> lock(mpState->mutex);
+            if (mpState->done) dispatchNow = true;
+            else mpState->continuations.push_back(pContinuation);
+        }
+        if (dispatchNow) gData.pPool->enqueue(pContinuation);
+
+        return Task(pContinuation);
     }
 }
@@ -27,60 +27,159 @@
  **************************************************************************/
 #pragma once
 #include "Core/Macros.h"
+#include <algorithm>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <cstdint>
 
 namespace Falcor
 {
+    /** Global work-stealing thread pool.
+
+        Each worker thread owns a task queue. Tasks dispatched from a worker are pushed onto its own queue
+        and executed in LIFO order, tasks dispatched from other threads go into a shared queue. Idle workers
+        steal from the other workers' queues. Waiting on a task from a worker thread executes pending tasks
+        in the meantime, so tasks can safely dispatch and wait for nested work.
+    */
     class FALCOR_API Threading
     {
     public:
-        const static uint32_t kDefaultThreadCount = 16;
+        struct TaskState;
 
-        /** Handle to a dispatched task
-
-            TODO: Implementation
+        /** Handle to a dispatched task.
         */
-        class Task
+        class FALCOR_API Task
         {
         public:
-            /** Check if task is still executing
+            /** Create an empty task handle. An empty task is never running.
+            */
+            Task() = default;
+
+            /** Check if the handle refers to a dispatched task.
+            */
+            bool isValid() const { return mpState != nullptr; }
+
+            /** Check if task is still executing (or waiting to be executed).
             */
-            bool isRunning();
+            bool isRunning() const;
 
-            /** Wait for task to finish executing
+            /** Wait for task to finish executing.
+                If the task threw an exception, it is rethrown here.
             */
             void finish();
 
+            /** Schedule a continuation that is dispatched once this task has finished.
+                \param[in] func Continuation function.
+                \return Handle to the continuation task.
+            */
+            Task then(const std::function<void(void)>& func);
+
         private:
-            Task();
+            Task(std::shared_ptr<TaskState> pState) : mpState(std::move(pState)) {}
+
+            std::shared_ptr<TaskState> mpState;
             friend class Threading;
         };
 
         /** Initializes the global thread pool
-            \param[in] threadCount Number of threads in the pool
+            \param[in] threadCount Number of worker threads in the pool. If zero, the logical thread count is used.
         */
-        static void start(uint32_t threadCount = kDefaultThreadCount);
+        static void start(uint32_t threadCount = 0);
 
-        /** Waits for all currently executing threads to finish
+        /** Waits for all dispatched tasks (including continuations) to finish.
+            Must not be called from a worker thread.
         */
         static void finish();
 
-        /** Waits for all currently executing threads to finish and shuts down the thread pool
+        /** Waits for all dispatched tasks to finish and shuts down the thread pool
         */
         static void shutdown();
 
+        /** Returns true if the thread pool is running.
+        */
+        static bool isStarted();
+
+        /** Returns the number of worker threads in the pool (zero if the pool is not running).
+        */
+        static uint32_t getThreadCount();
+
+        /** Returns true if the calling thread is one of the pool's worker threads.
+        */
+        static bool isWorkerThread();
+
         /** Returns the maximum number of concurrent threads supported by the hardware
         */
-        static uint32_t getLogicalThreadCount() { return std::thread::hardware_concurrency(); }
+        static uint32_t getLogicalThreadCount() { return std::max(1u, std::thread::hardware_concurrency()); }
 
         /** Starts a task on an available thread.
             \return Handle to the task
         */
         static Task dispatchTask(const std::function<void(void)>& func);
+
+        /** Execute a function over sub-ranges of [begin, end) in parallel.
+            The calling thread participates in the work. Runs serially if the pool is not running.
+            Exceptions thrown by the function are rethrown on the calling thread once all work has finished.
+            \param[in] begin First index.
+            \param[in] end One past the last index.
+            \param[in] func Function called as func(rangeBegin, rangeEnd) for each sub-range.
+            \param[in] grainSize Maximum number of indices per sub-range. If zero, a size is picked based on the thread count.
+        */
+        static void parallelForRange(size_t begin, size_t end, const std::function<void(size_t, size_t)>& func, size_t grainSize = 0);
+
+        /** Execute a function for each index in [begin, end) in parallel.
+            \param[in] begin First index.
+            \param[in] end One past the last index.
+            \param[in] func Function called as func(index).
+            \param[in] grainSize Maximum number of indices per task. If zero, a size is picked based on the thread count.
+        */
+        template<typename Func>
+        static void parallelFor(size_t begin, size_t end, Func&& func, size_t grainSize = 0)
+        {
+            parallelForRange(begin, end, [&func](size_t rangeBegin, size_t rangeEnd)
+            {
+                for (size_t i = rangeBegin; i < rangeEnd; ++i) func(i);
+            }, grainSize);
+        }
+
+        /** Reduce over [begin, end) in parallel.
+            The range is split into fixed size chunks that only depend on the range and grain size, and the partial
+            results are combined in order. The result is therefore deterministic and independent of the thread count.
+            \param[in] begin First index.
+            \param[in] end One past the last index.
+            \param[in] identity Identity value of the reduction.
+            \param[in] map Function called as map(rangeBegin, rangeEnd, identity) returning the partial result of a chunk.
+            \param[in] reduce Function called as reduce(a, b) combining two partial results.
+            \param[in] grainSize Number of indices per chunk. If zero, the range is split into at most 256 chunks.
+            \return The reduced value.
+        */
+        template<typename T, typename MapFunc, typename ReduceFunc>
+        static T parallelReduce(size_t begin, size_t end, const T& identity, MapFunc&& map, ReduceFunc&& reduce, size_t grainSize = 0)
+        {
+            if (begin >= end) return identity;
+
+            const size_t count = end - begin;
+            const size_t chunkSize = grainSize > 0 ? grainSize : std::max<size_t>(1, (count + 255) / 256);
+            const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+            // Each partial result gets its own cache line. This avoids false sharing between threads and keeps
+            // std::vector<bool> from packing the partials of different chunks into the same bytes.
+            struct alignas(64) Partial { T value; };
+            std::vector<Partial> partials(chunkCount, Partial{identity});
+            parallelFor(0, chunkCount, [&](size_t chunk)
+            {
+                const size_t chunkBegin = begin + chunk * chunkSize;
+                const size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+                partials[chunk].value = map(chunkBegin, chunkEnd, identity);
+            }, 1);
+
+            T result = identity;
+            for (const auto& partial : partials) result = reduce(result, partial.value);
+            return result;
+        }
     };
 
     /** Simple thread barrier class.
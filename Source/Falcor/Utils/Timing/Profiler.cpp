@@ -30,7 +30,15 @@
 #include "Core/API/GpuTimer.h"
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <fstream>
+#include <limits>
+#include <mutex>
 
 namespace Falcor
 {
@@ -44,6 +52,245 @@ namespace Falcor
         // Size of the event history. The event history is keeping track of event times to allow
         // for computing statistics (min, max, mean, stddev) over the recent history.
         const size_t kMaxHistorySize = 512;
+
+        // Trace events of a single thread. Events are appended by the owning thread only, and are published
+        // to readers by the release store of 'count'. Storage is allocated in chunks that are never moved or freed.
+        struct TraceEvent
+        {
+            TraceRecorder::NameId nameId;
+            bool gpu;
+            uint64_t startTime;
+            uint64_t endTime;
+        };
+
+        struct TraceThreadBuffer
+        {
+            static constexpr size_t kChunkSize = 4096;
+            static constexpr size_t kMaxChunks = 1024;
+
+            uint32_t threadId = 0;
+            std::string name;                                           // Protected by the registry mutex.
+            std::atomic<uint64_t> recordingId{ 0 };                     // Recording the events in the buffer belong to.
+            std::atomic<size_t> count{ 0 };
+            std::array<std::unique_ptr<TraceEvent[]>, kMaxChunks> chunks;
+        };
+
+        // Interned names. Names are stored in chunks that are never moved or freed, so they can be read without taking the lock.
+        struct TraceNames
+        {
+            static constexpr size_t kChunkSize = 1024;
+            static constexpr size_t kMaxChunks = 1024;
+
+            std::unordered_map<std::string, TraceRecorder::NameId> nameToId; // Protected by the registry mutex.
+            std::array<std::unique_ptr<std::string[]>, kMaxChunks> chunks;
+            std::atomic<size_t> count{ 0 };
+        };
+
+        struct TraceRegistry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<TraceThreadBuffer>> threadBuffers;
+            TraceNames names;
+            std::atomic<bool> recording{ false };
+            std::atomic<uint64_t> recordingId{ 0 };
+            std::atomic<uint64_t> droppedEvents{ 0 };
+        };
+
+        TraceRegistry& getTraceRegistry()
+        {
+            static TraceRegistry registry;
+            return registry;
+        }
+
+        TraceThreadBuffer& getTraceThreadBuffer()
+        {
+            thread_local TraceThreadBuffer* pBuffer = nullptr;
+            if (!pBuffer)
+            {
+                auto& registry = getTraceRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.threadBuffers.push_back(std::make_unique<TraceThreadBuffer>());
+                pBuffer = registry.threadBuffers.back().get();
+                pBuffer->threadId = (uint32_t)registry.threadBuffers.size() - 1;
+            }
+            return *pBuffer;
+        }
+
+        void appendTraceEvent(const TraceEvent& event)
+        {
+            auto& registry = getTraceRegistry();
+            if (!registry.recording.load(std::memory_order_relaxed)) return;
+
+            auto& buffer = getTraceThreadBuffer();
+
+            // Drop the events of previous recordings on first use within a new recording.
+            uint64_t recordingId = registry.recordingId.load(std::memory_order_acquire);
+            if (buffer.recordingId.load(std::memory_order_relaxed) != recordingId)
+            {
+                buffer.count.store(0, std::memory_order_relaxed);
+                buffer.recordingId.store(recordingId, std::memory_order_release);
+            }
+
+            size_t index = buffer.count.load(std::memory_order_relaxed);
+            size_t chunk = index / TraceThreadBuffer::kChunkSize;
+            if (chunk >= TraceThreadBuffer::kMaxChunks)
+            {
+                registry.droppedEvents.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (!buffer.chunks[chunk]) buffer.chunks[chunk] = std::make_unique<TraceEvent[]>(TraceThreadBuffer::kChunkSize);
+            buffer.chunks[chunk][index % TraceThreadBuffer::kChunkSize] = event;
+            buffer.count.store(index + 1, std::memory_order_release);
+        }
+
+        void appendJsonString(fmt::memory_buffer& out, std::string_view str)
+        {
+            out.push_back('"');
+            for (char c : str)
+            {
+                if (c == '"' || c == '\\') { out.push_back('\\'); out.push_back(c); }
+                else if ((unsigned char)c < 0x20) fmt::format_to(std::back_inserter(out), "\\u{:04x}", (unsigned)c);
+                else out.push_back(c);
+            }
+            out.push_back('"');
+        }
+
+        // JSON has no representation for NaN and infinity, so they are written as null.
+        void appendJsonNumber(fmt::memory_buffer& out, float value)
+        {
+            if (std::isfinite(value)) fmt::format_to(std::back_inserter(out), "{}", value);
+            else fmt::format_to(std::back_inserter(out), "null");
+        }
+
+        const uint32_t kTraceCpuProcessId = 0;
+        const uint32_t kTraceGpuProcessId = 1;
+    }
+
+    // TraceRecorder
+
+    TraceRecorder::NameId TraceRecorder::internName(std::string_view name)
+    {
+        auto& names = getTraceRegistry().names;
+        std::lock_guard<std::mutex> lock(getTraceRegistry().mutex);
+        std::string key(name);
+        auto it = names.nameToId.find(key);
+        if (it != names.nameToId.end()) return it->second;
+
+        size_t index = names.count.load(std::memory_order_relaxed);
+        size_t chunk = index / TraceNames::kChunkSize;
+        if (chunk >= TraceNames::kMaxChunks) throw RuntimeError("TraceRecorder: Too many event names ({}).", index);
+        if (!names.chunks[chunk]) names.chunks[chunk] = std::make_unique<std::string[]>(TraceNames::kChunkSize);
+        names.chunks[chunk][index % TraceNames::kChunkSize] = key;
+        names.count.store(index + 1, std::memory_order_release);
+
+        NameId id = (NameId)index;
+        names.nameToId.emplace(std::move(key), id);
+        return id;
+    }
+
+    const std::string& TraceRecorder::getName(NameId id)
+    {
+        const auto& names = getTraceRegistry().names;
+        FALCOR_ASSERT(id < names.count.load(std::memory_order_acquire));
+        return names.chunks[id / TraceNames::kChunkSize][id % TraceNames::kChunkSize];
+    }
+
+    void TraceRecorder::setThreadName(std::string_view name)
+    {
+        auto& buffer = getTraceThreadBuffer();
+        std::lock_guard<std::mutex> lock(getTraceRegistry().mutex);
+        buffer.name = name;
+    }
+
+    bool TraceRecorder::isRecording()
+    {
+        return getTraceRegistry().recording.load(std::memory_order_relaxed);
+    }
+
+    void TraceRecorder::start()
+    {
+        auto& registry = getTraceRegistry();
+        registry.droppedEvents = 0;
+        registry.recordingId.fetch_add(1, std::memory_order_acq_rel);
+        registry.recording = true;
+    }
+
+    void TraceRecorder::stop()
+    {
+        auto& registry = getTraceRegistry();
+        registry.recording = false;
+        if (uint64_t dropped = registry.droppedEvents.load())
+        {
+            logWarning("TraceRecorder: {} events were dropped because a thread exceeded the maximum number of events per recording.", dropped);
+        }
+    }
+
+    std::string TraceRecorder::toJsonString()
+    {
+        auto& registry = getTraceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        uint64_t recordingId = registry.recordingId.load(std::memory_order_acquire);
+
+        fmt::memory_buffer out;
+        auto it = std::back_inserter(out);
+        bool first = true;
+        auto separator = [&]() { fmt::format_to(it, "{}\n", first ? "" : ","); first = false; };
+
+        fmt::format_to(it, "{{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+        separator();
+        fmt::format_to(it, "{{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": {}, \"args\": {{\"name\": \"CPU\"}}}}", kTraceCpuProcessId);
+        separator();
+        fmt::format_to(it, "{{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": {}, \"args\": {{\"name\": \"GPU\"}}}}", kTraceGpuProcessId);
+
+        for (const auto& pBuffer : registry.threadBuffers)
+        {
+            if (pBuffer->recordingId.load(std::memory_order_acquire) != recordingId) continue;
+            size_t count = pBuffer->count.load(std::memory_order_acquire);
+            if (count == 0) continue;
+
+            separator();
+            fmt::format_to(it, "{{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": {}, \"tid\": {}, \"args\": {{\"name\": ", kTraceCpuProcessId, pBuffer->threadId);
+            appendJsonString(out, pBuffer->name.empty() ? fmt::format("Thread {}", pBuffer->threadId) : pBuffer->name);
+            fmt::format_to(it, "}}}}");
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const TraceEvent& event = pBuffer->chunks[i / TraceThreadBuffer::kChunkSize][i % TraceThreadBuffer::kChunkSize];
+                separator();
+                fmt::format_to(it, "{{\"name\": ");
+                appendJsonString(out, getName(event.nameId));
+                fmt::format_to(it, ", \"ph\": \"X\", \"ts\": {:.3f}, \"dur\": {:.3f}, \"pid\": {}, \"tid\": {}}}",
+                    event.startTime * 1e-3, (event.endTime - event.startTime) * 1e-3,
+                    event.gpu ? kTraceGpuProcessId : kTraceCpuProcessId, event.gpu ? 0 : pBuffer->threadId);
+            }
+        }
+
+        fmt::format_to(it, "\n]}}\n");
+        return fmt::to_string(out);
+    }
+
+    void TraceRecorder::writeToFile(const std::filesystem::path& path)
+    {
+        auto json = toJsonString();
+        std::ofstream ofs(path);
+        ofs.write(json.data(), json.size());
+    }
+
+    uint64_t TraceRecorder::getCurrentTime()
+    {
+        // Offset the time base so that a valid time is never zero.
+        static const auto kEpoch = std::chrono::steady_clock::now() - std::chrono::nanoseconds(1);
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kEpoch).count();
+    }
+
+    void TraceRecorder::recordCpuEvent(NameId id, uint64_t startTime, uint64_t endTime)
+    {
+        appendTraceEvent({ id, false, startTime, endTime });
+    }
+
+    void TraceRecorder::recordGpuEvent(NameId id, uint64_t startTime, uint64_t endTime)
+    {
+        appendTraceEvent({ id, true, startTime, endTime });
     }
 
     // Profiler::Stats
@@ -90,6 +337,7 @@ namespace Falcor
 
     Profiler::Event::Event(const std::string& name)
         : mName(name)
+        , mNameId(TraceRecorder::internName(name.substr(name.find_last_of('/') + 1)))
         , mCpuTimeHistory(kMaxHistorySize, 0.f)
         , mGpuTimeHistory(kMaxHistorySize, 0.f)
     {}
@@ -126,6 +374,8 @@ namespace Falcor
         }
         frameData.pActiveTimer = frameData.pTimers[frameData.currentTimer++].get();
         frameData.pActiveTimer->begin();
+        frameData.cpuStartTimes.resize(frameData.currentTimer);
+        frameData.cpuStartTimes.back() = TraceRecorder::getCurrentTime();
         frameData.valid = false;
     }
 
@@ -145,7 +395,7 @@ namespace Falcor
         frameData.valid = true;
     }
 
-    void Profiler::Event::endFrame(uint32_t frameIndex)
+    void Profiler::Event::endFrame(Profiler& profiler, uint32_t frameIndex)
     {
         // Resolve GPU timers for the current frame measurements.
         // This is necessary before we readback of results next frame.
@@ -165,7 +415,13 @@ namespace Falcor
 
         mCpuTime = frameData.cpuTotalTime;
         mGpuTime = 0.f;
-        for (size_t i = 0; i < frameData.currentTimer; ++i) mGpuTime += (float)frameData.pTimers[i]->getElapsedTime();
+        bool recording = TraceRecorder::isRecording();
+        for (size_t i = 0; i < frameData.currentTimer; ++i)
+        {
+            double elapsedTime = frameData.pTimers[i]->getElapsedTime();
+            mGpuTime += (float)elapsedTime;
+            if (recording) profiler.mGpuTraceRecords.push_back({ mNameId, frameData.cpuStartTimes[i], frameData.pTimers[i]->getStartTime(), elapsedTime });
+        }
         frameData.cpuTotalTime = 0.f;
         frameData.currentTimer = 0;
 
@@ -206,12 +462,36 @@ namespace Falcor
 
     std::string Profiler::Capture::toJsonString() const
     {
-        using namespace pybind11::literals;
+        // Written directly instead of going through python's JSON encoder, so captures can be saved without holding the GIL.
+        fmt::memory_buffer out;
+        auto it = std::back_inserter(out);
 
-        // We use pythons JSON encoder to encode the python dictionary to a JSON string.
-        pybind11::module json = pybind11::module::import("json");
-        pybind11::object dumps = json.attr("dumps");
-        return pybind11::cast<std::string>(dumps(toPython(), "indent"_a = 2));
+        fmt::format_to(it, "{{\n  \"frameCount\": {},\n  \"events\": {{", mFrameCount);
+        for (size_t i = 0; i < mLanes.size(); ++i)
+        {
+            const auto& lane = mLanes[i];
+            fmt::format_to(it, "{}\n    ", i > 0 ? "," : "");
+            appendJsonString(out, lane.name);
+            fmt::format_to(it, ": {{\n      \"name\": ");
+            appendJsonString(out, lane.name);
+            fmt::format_to(it, ",\n      \"stats\": {{\n        \"min\": ");
+            appendJsonNumber(out, lane.stats.min);
+            fmt::format_to(it, ",\n        \"max\": ");
+            appendJsonNumber(out, lane.stats.max);
+            fmt::format_to(it, ",\n        \"mean\": ");
+            appendJsonNumber(out, lane.stats.mean);
+            fmt::format_to(it, ",\n        \"stdDev\": ");
+            appendJsonNumber(out, lane.stats.stdDev);
+            fmt::format_to(it, "\n      }},\n      \"records\": [");
+            for (size_t j = 0; j < lane.records.size(); ++j)
+            {
+                fmt::format_to(it, "{}\n        ", j > 0 ? "," : "");
+                appendJsonNumber(out, lane.records[j]);
+            }
+            fmt::format_to(it, "{}]\n    }}", lane.records.empty() ? "" : "\n      ");
+        }
+        fmt::format_to(it, "{}}}\n}}", mLanes.empty() ? "" : "\n  ");
+        return fmt::to_string(out);
     }
 
     void Profiler::Capture::writeToFile(const std::filesystem::path& path) const
@@ -285,47 +565,70 @@ namespace Falcor
         mpFence = GpuFence::create(mpDevice);
     }
 
-    void Profiler::startEvent(RenderContext* pRenderContext, const std::string& name, Flags flags)
+    void Profiler::startEvent(RenderContext* pRenderContext, TraceRecorder::NameId nameId, Flags flags)
     {
         if (mEnabled && is_set(flags, Flags::Internal))
         {
-            // '/' is used as a "path delimiter", so it cannot be used in the event name.
-            if (name.find('/') != std::string::npos)
+            // Look up the nested event by interned name. The full event name is only built when the event is first encountered.
+            auto& children = mEventStack.empty() ? mRootEvents : mEventStack.back().pEvent->mChildren;
+            auto it = children.find(nameId);
+            Event* pEvent = nullptr;
+            if (it != children.end())
             {
-                logWarning("Profiler event names must not contain '/'. Ignoring this profiler event.");
-                return;
+                pEvent = it->second;
+            }
+            else
+            {
+                const std::string& name = TraceRecorder::getName(nameId);
+                // '/' is used as a "path delimiter", so it cannot be used in the event name.
+                if (name.find('/') != std::string::npos)
+                {
+                    if (mInvalidNameIds.insert(nameId).second) logWarning("Profiler event name '{}' must not contain '/'. Ignoring this profiler event.", name);
+                }
+                else
+                {
+                    pEvent = getEvent((mEventStack.empty() ? std::string() : mEventStack.back().pEvent->mName) + "/" + name);
+                }
+                children.emplace(nameId, pEvent);
             }
 
-            mCurrentEventName = mCurrentEventName + "/" + name;
-
-            Event* pEvent = getEvent(mCurrentEventName);
-            FALCOR_ASSERT(pEvent != nullptr);
-            if (!mPaused) pEvent->start(*this, mFrameIndex);
-
-            if (std::find(mCurrentFrameEvents.begin(), mCurrentFrameEvents.end(), pEvent) == mCurrentFrameEvents.end())
+            if (pEvent)
             {
-                mCurrentFrameEvents.push_back(pEvent);
+                if (!mPaused) pEvent->start(*this, mFrameIndex);
+                mEventStack.push_back({ pEvent, nameId, TraceRecorder::isRecording() ? TraceRecorder::getCurrentTime() : 0 });
+
+                if (pEvent->mRegisteredFrameIndex != mFrameIndex)
+                {
+                    pEvent->mRegisteredFrameIndex = mFrameIndex;
+                    mCurrentFrameEvents.push_back(pEvent);
+                }
             }
         }
         if (is_set(flags, Flags::Pix))
         {
             FALCOR_ASSERT(pRenderContext);
-            pRenderContext->getLowLevelData()->beginDebugEvent(name.c_str());
+            pRenderContext->getLowLevelData()->beginDebugEvent(TraceRecorder::getName(nameId).c_str());
         }
     }
 
-    void Profiler::endEvent(RenderContext* pRenderContext, const std::string& name, Flags flags)
+    void Profiler::endEvent(RenderContext* pRenderContext, TraceRecorder::NameId nameId, Flags flags)
     {
         if (mEnabled && is_set(flags, Flags::Internal))
         {
-            // '/' is used as a "path delimiter", so it cannot be used in the event name.
-            if (name.find('/') != std::string::npos) return;
+            // Ignore events started before the profiler was enabled.
+            if (mEventStack.empty()) return;
 
-            Event* pEvent = getEvent(mCurrentEventName);
-            FALCOR_ASSERT(pEvent != nullptr);
-            if (!mPaused) pEvent->end(mFrameIndex);
+            ActiveEvent activeEvent = mEventStack.back();
+            if (activeEvent.nameId != nameId)
+            {
+                // Events with invalid names are never started.
+                if (mInvalidNameIds.count(nameId) > 0) return;
+                FALCOR_ASSERT_MSG(false, "Profiler::endEvent() name does not match the open event. Events must be ended in reverse order.");
+            }
+            mEventStack.pop_back();
+            if (!mPaused) activeEvent.pEvent->end(mFrameIndex);
 
-            mCurrentEventName.erase(mCurrentEventName.find_last_of("/"));
+            if (activeEvent.cpuStartTime != 0) TraceRecorder::recordCpuEvent(activeEvent.pEvent->mNameId, activeEvent.cpuStartTime, TraceRecorder::getCurrentTime());
         }
 
         if (is_set(flags, Flags::Pix))
@@ -352,7 +655,21 @@ namespace Falcor
 
         for (Event* pEvent : mCurrentFrameEvents)
         {
-            pEvent->endFrame(mFrameIndex);
+            pEvent->endFrame(*this, mFrameIndex);
+        }
+
+        // Add last frame's GPU measurements to the trace. GPU timestamps use a different clock, so they are shifted
+        // by the smallest offset that places every measurement at or after the time it was issued on the CPU.
+        if (!mGpuTraceRecords.empty())
+        {
+            double offset = std::numeric_limits<double>::lowest();
+            for (const auto& record : mGpuTraceRecords) offset = std::max(offset, record.cpuStartTime - record.gpuStartTime * 1e6);
+            for (const auto& record : mGpuTraceRecords)
+            {
+                double startTime = record.gpuStartTime * 1e6 + offset;
+                TraceRecorder::recordGpuEvent(record.nameId, (uint64_t)startTime, (uint64_t)(startTime + record.gpuDuration * 1e6));
+            }
+            mGpuTraceRecords.clear();
         }
 
         // Flush and insert signal for synchronization of GPU timings.
@@ -421,18 +738,22 @@ namespace Falcor
     }
 
 
-    ScopedProfilerEvent::ScopedProfilerEvent(RenderContext* pRenderContext, const std::string& name, Profiler::Flags flags)
+    ScopedProfilerEvent::ScopedProfilerEvent(RenderContext* pRenderContext, TraceRecorder::NameId nameId, Profiler::Flags flags)
         : mpRenderContext(pRenderContext)
-        , mName(name)
+        , mNameId(nameId)
         , mFlags(flags)
     {
         FALCOR_ASSERT(mpRenderContext);
-        mpRenderContext->getProfiler()->startEvent(mpRenderContext, mName, mFlags);
+        mpRenderContext->getProfiler()->startEvent(mpRenderContext, mNameId, mFlags);
     }
 
+    ScopedProfilerEvent::ScopedProfilerEvent(RenderContext* pRenderContext, const std::string& name, Profiler::Flags flags)
+        : ScopedProfilerEvent(pRenderContext, TraceRecorder::internName(name), flags)
+    {}
+
     ScopedProfilerEvent::~ScopedProfilerEvent()
     {
-        mpRenderContext->getProfiler()->endEvent(mpRenderContext, mName, mFlags);
+        mpRenderContext->getProfiler()->endEvent(mpRenderContext, mNameId, mFlags);
     }
 
     FALCOR_SCRIPT_BINDING(Profiler)
@@ -453,5 +774,7 @@ namespace Falcor
         profiler.def_property_readonly("events", &Profiler::getPythonEvents);
         profiler.def("startCapture", &Profiler::startCapture, "reservedFrames"_a = 1000);
         profiler.def("endCapture", endCapture);
+        profiler.def("startTrace", [] (Profiler*) { TraceRecorder::start(); });
+        profiler.def("endTrace", [] (Profiler*, const std::filesystem::path& path) { TraceRecorder::stop(); TraceRecorder::writeToFile(path); }, "path"_a);
     }
 }
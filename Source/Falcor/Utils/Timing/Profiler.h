@@ -30,16 +30,102 @@
 #include "Core/Macros.h"
 #include "Core/API/GpuTimer.h"
 #include <pybind11/pytypes.h>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Falcor
 {
     class RenderContext;
 
+    /** Records timed CPU events from any thread and exports them in the Chrome trace event format,
+        which can be viewed in chrome://tracing or https://ui.perfetto.dev.
+        Each thread appends to its own event buffer without taking locks. Event names are interned once into
+        integer IDs, so recording an event does not touch any strings.
+        While recording, the Profiler also emits its events, including GPU timings on a separate GPU track.
+    */
+    class FALCOR_API TraceRecorder
+    {
+    public:
+        using NameId = uint32_t;
+
+        /** Get the ID of an event name, registering the name on first use. Thread-safe.
+        */
+        static NameId internName(std::string_view name);
+
+        /** Get the name for an ID returned by internName(). Thread-safe.
+        */
+        static const std::string& getName(NameId id);
+
+        /** Set the name of the calling thread in the exported trace.
+        */
+        static void setThreadName(std::string_view name);
+
+        /** Check if events are currently being recorded.
+        */
+        static bool isRecording();
+
+        /** Start recording. Discards events of previous recordings.
+        */
+        static void start();
+
+        /** Stop recording. The recorded events remain available for export until the next call to start().
+        */
+        static void stop();
+
+        /** Get the recorded events as a JSON string in the Chrome trace event format.
+        */
+        static std::string toJsonString();
+
+        /** Write the recorded events to a JSON file in the Chrome trace event format.
+        */
+        static void writeToFile(const std::filesystem::path& path);
+
+        /** Get the current time in nanoseconds in the time base used for trace events.
+        */
+        static uint64_t getCurrentTime();
+
+        /** Record a CPU event on the calling thread. Ignored if not recording.
+            \param[in] id Interned event name.
+            \param[in] startTime Start time in nanoseconds, see getCurrentTime().
+            \param[in] endTime End time in nanoseconds, see getCurrentTime().
+        */
+        static void recordCpuEvent(NameId id, uint64_t startTime, uint64_t endTime);
+
+        /** Record a GPU event. The times must be converted to the CPU time base by the caller. Ignored if not recording.
+            \param[in] id Interned event name.
+            \param[in] startTime Start time in nanoseconds, see getCurrentTime().
+            \param[in] endTime End time in nanoseconds, see getCurrentTime().
+        */
+        static void recordGpuEvent(NameId id, uint64_t startTime, uint64_t endTime);
+    };
+
+    /** Helper class for recording a CPU trace event using RAII.
+        Use the FALCOR_PROFILE_CPU macro instead of creating objects directly.
+    */
+    class FALCOR_API ScopedTraceEvent
+    {
+    public:
+        ScopedTraceEvent(TraceRecorder::NameId id)
+            : mId(id)
+            , mStartTime(TraceRecorder::isRecording() ? TraceRecorder::getCurrentTime() : 0)
+        {}
+
+        ~ScopedTraceEvent()
+        {
+            if (mStartTime != 0) TraceRecorder::recordCpuEvent(mId, mStartTime, TraceRecorder::getCurrentTime());
+        }
+
+    private:
+        TraceRecorder::NameId mId;
+        uint64_t mStartTime;
+    };
+
     /** Container class for CPU/GPU profiling.
         This class uses the most accurately available CPU and GPU timers to profile given events.
         It automatically creates event hierarchies based on the order and nesting of the calls made.
@@ -89,9 +175,12 @@ namespace Falcor
 
             void start(Profiler& profiler, uint32_t frameIndex);
             void end(uint32_t frameIndex);
-            void endFrame(uint32_t frameIndex);
+            void endFrame(Profiler& profiler, uint32_t frameIndex);
 
             std::string mName;                              ///< Nested event name.
+            TraceRecorder::NameId mNameId;                  ///< Interned name of the event, without the names of its parents.
+            std::unordered_map<TraceRecorder::NameId, Event*> mChildren; ///< Nested events by interned name.
+            uint32_t mRegisteredFrameIndex = uint32_t(-1);  ///< Frame index the event was last added to the list of frame events.
 
             float mCpuTime = 0.0;                           ///< CPU time (previous frame).
             float mGpuTime = 0.0;                           ///< GPU time (previous frame).
@@ -112,6 +201,7 @@ namespace Falcor
                 float cpuTotalTime = 0.0;                   ///< Total accumulated CPU time.
 
                 std::vector<GpuTimer::SharedPtr> pTimers;   ///< Pool of GPU timers.
+                std::vector<uint64_t> cpuStartTimes;        ///< CPU start time of the measurement of each used GPU timer (trace time base).
                 size_t currentTimer = 0;                    ///< Next GPU timer to use from the pool.
                 GpuTimer *pActiveTimer = nullptr;           ///< Currently active GPU timer.
 
@@ -204,17 +294,26 @@ namespace Falcor
 
         /** Start profiling a new event and update the events hierarchies.
             \param[in] pRenderContext Render context for measuring GPU time.
-            \param[in] name The event name.
+            \param[in] nameId The interned event name, see TraceRecorder::internName().
             \param[in] flags The event flags.
         */
-        void startEvent(RenderContext* pRenderContext, const std::string& name, Flags flags = Flags::Default);
+        void startEvent(RenderContext* pRenderContext, TraceRecorder::NameId nameId, Flags flags = Flags::Default);
 
-        /** Finish profiling a new event and update the events hierarchies.
+        /** Finish profiling an event and update the events hierarchies.
+            Events must be ended in the reverse order they were started.
             \param[in] pRenderContext Render context for measuring GPU time.
-            \param[in] name The event name.
+            \param[in] nameId The interned event name, must match the innermost open event.
             \param[in] flags The event flags.
         */
-        void endEvent(RenderContext* pRenderContext, const std::string& name, Flags flags = Flags::Default);
+        void endEvent(RenderContext* pRenderContext, TraceRecorder::NameId nameId, Flags flags = Flags::Default);
+
+        /** Start profiling a new event. Convenience overload that interns the name on every call, prefer the NameId overload in frequently executed code.
+        */
+        void startEvent(RenderContext* pRenderContext, const std::string& name, Flags flags = Flags::Default) { startEvent(pRenderContext, TraceRecorder::internName(name), flags); }
+
+        /** Finish profiling an event. Convenience overload that interns the name on every call, prefer the NameId overload in frequently executed code.
+        */
+        void endEvent(RenderContext* pRenderContext, const std::string& name, Flags flags = Flags::Default) { endEvent(pRenderContext, TraceRecorder::internName(name), flags); }
 
         /** Get the event, or create a new one if the event does not yet exist.
             This is a public interface to facilitate more complicated construction of event names and finegrained control over the profiled region.
@@ -249,11 +348,28 @@ namespace Falcor
         bool mEnabled = false;
         bool mPaused = false;
 
+        struct ActiveEvent
+        {
+            Event* pEvent;
+            TraceRecorder::NameId nameId;                   ///< Interned name passed to startEvent().
+            uint64_t cpuStartTime;                          ///< Start time in the trace time base, zero if not recording a trace.
+        };
+
+        struct GpuTraceRecord
+        {
+            TraceRecorder::NameId nameId;
+            uint64_t cpuStartTime;                          ///< Time the measurement was issued on the CPU (trace time base).
+            double gpuStartTime;                            ///< GPU timestamp of the start of the measurement in ms.
+            double gpuDuration;                             ///< Duration of the measurement in ms.
+        };
+
         std::unordered_map<std::string, std::shared_ptr<Event>> mEvents; ///< Events by name.
+        std::unordered_map<TraceRecorder::NameId, Event*> mRootEvents; ///< Top level events by interned name.
+        std::unordered_set<TraceRecorder::NameId> mInvalidNameIds; ///< Interned names that are not valid event names (contain '/').
         std::vector<Event*> mCurrentFrameEvents;            ///< Events registered for current frame.
         std::vector<Event*> mLastFrameEvents;               ///< Events from last frame.
-        std::string mCurrentEventName;                      ///< Current nested event name.
-        uint32_t mCurrentLevel = 0;                         ///< Current nesting level.
+        std::vector<ActiveEvent> mEventStack;               ///< Currently running nested events.
+        std::vector<GpuTraceRecord> mGpuTraceRecords;       ///< GPU measurements of the previous frame to be added to the trace.
         uint32_t mFrameIndex = 0;                           ///< Current frame index.
 
         Capture::SharedPtr mpCapture;                       ///< Currently active capture.
@@ -272,20 +388,37 @@ namespace Falcor
     class FALCOR_API ScopedProfilerEvent
     {
     public:
+        ScopedProfilerEvent(RenderContext* pRenderContext, TraceRecorder::NameId nameId, Profiler::Flags flags = Profiler::Flags::Default);
         ScopedProfilerEvent(RenderContext* pRenderContext, const std::string& name, Profiler::Flags flags = Profiler::Flags::Default);
         ~ScopedProfilerEvent();
 
     private:
         RenderContext* mpRenderContext;
-        const std::string mName;
+        const TraceRecorder::NameId mNameId;
         Profiler::Flags mFlags;
     };
 }
 
 #if FALCOR_ENABLE_PROFILER
-#define FALCOR_PROFILE(_pRenderContext, _name) Falcor::ScopedProfilerEvent _profileEvent##__LINE__(_pRenderContext, _name)
-#define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags) Falcor::ScopedProfilerEvent _profileEvent##__LINE__(_pRenderContext, _name, _flags)
+/** Profile the current scope. The name must be a constant, as it is interned only once per call site.
+*/
+#define FALCOR_PROFILE(_pRenderContext, _name) \
+    static const Falcor::TraceRecorder::NameId _profileEventName##__LINE__ = Falcor::TraceRecorder::internName(_name); \
+    Falcor::ScopedProfilerEvent _profileEvent##__LINE__(_pRenderContext, _profileEventName##__LINE__)
+#define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags) \
+    static const Falcor::TraceRecorder::NameId _profileEventName##__LINE__ = Falcor::TraceRecorder::internName(_name); \
+    Falcor::ScopedProfilerEvent _profileEvent##__LINE__(_pRenderContext, _profileEventName##__LINE__, _flags)
+/** Profile the current scope using a name that is only known at runtime. The name is interned on every call.
+*/
+#define FALCOR_PROFILE_DYNAMIC(_pRenderContext, _name) Falcor::ScopedProfilerEvent _profileEvent##__LINE__(_pRenderContext, std::string(_name))
+/** Record a CPU trace event for the current scope. Can be used from any thread. The name must be a constant, as it is interned only once.
+*/
+#define FALCOR_PROFILE_CPU(_name) \
+    static const Falcor::TraceRecorder::NameId _traceEventName##__LINE__ = Falcor::TraceRecorder::internName(_name); \
+    Falcor::ScopedTraceEvent _traceEvent##__LINE__(_traceEventName##__LINE__)
 #else
 #define FALCOR_PROFILE(_pRenderContext, _name)
 #define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags)
+#define FALCOR_PROFILE_DYNAMIC(_pRenderContext, _name)
+#define FALCOR_PROFILE_CPU(_name)
 #endif
@@ -240,6 +240,25 @@ namespace Falcor
             if (ImGui::Button("Start Capture")) mpProfiler->startCapture();
         }
 
+        ImGui::SameLine();
+        if (TraceRecorder::isRecording())
+        {
+            if (ImGui::Button("End Trace"))
+            {
+                TraceRecorder::stop();
+                FileDialogFilterVec filters {{ "json", "Chrome trace" }};
+                std::filesystem::path path;
+                if (saveFileDialog(filters, path))
+                {
+                    TraceRecorder::writeToFile(path);
+                }
+            }
+        }
+        else
+        {
+            if (ImGui::Button("Start Trace")) TraceRecorder::start();
+        }
+
         ImGui::Separator();
     }
 
@@ -26,8 +26,10 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TimeReport.h"
+#include "Profiler.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include <algorithm>
 #include <numeric>
 
 namespace Falcor
@@ -64,6 +66,14 @@ namespace Falcor
         std::chrono::duration<double> duration = currentTime - mLastMeasureTime;
         mLastMeasureTime = currentTime;
         mMeasurements.push_back({name, duration.count()});
+
+        // Add the measured interval to the CPU trace, so that the stages of e.g. scene loading show up in it.
+        if (TraceRecorder::isRecording())
+        {
+            uint64_t endTime = TraceRecorder::getCurrentTime();
+            uint64_t startTime = endTime - std::min(endTime - 1, (uint64_t)(duration.count() * 1e9));
+            TraceRecorder::recordCpuEvent(TraceRecorder::internName(name), startTime, endTime);
+        }
     }
 
     void TimeReport::addTotal(const std::string name)
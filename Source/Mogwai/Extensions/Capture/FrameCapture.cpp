@@ -41,6 +41,7 @@ namespace Mogwai
         const std::string kUI = "ui";
         const std::string kOutputs = "outputs";
         const std::string kCapture = "capture";
+        const std::string kFlush = "flush";
 
         template<typename T>
         std::vector<typename T::value_type::first_type> getFirstOfPair(const T& pair)
@@ -63,6 +64,7 @@ namespace Mogwai
         : CaptureTrigger(pRenderer, "Frame Capture")
     {
         mpImageProcessing = std::make_unique<ImageProcessing>(pRenderer->getDevice());
+        mpCaptureQueue = std::make_unique<CaptureQueue>();
     }
 
     void FrameCapture::renderUI(Gui* pGui)
@@ -77,6 +79,16 @@ namespace Mogwai
             w.tooltip("Capture all available outputs instead of the marked ones only.");
 
             if (w.button("Capture Current Frame")) capture();
+
+            CaptureQueue::Desc desc = mpCaptureQueue->getDesc();
+            bool changed = w.var("Encoder Threads", desc.workerCount, 1u, 64u);
+            w.tooltip("Number of threads writing captured images to disk.");
+            changed |= w.var("Readback Buffers", desc.readbackCount, 1u, 64u);
+            w.tooltip("Maximum number of images being copied from the GPU at once. Capturing blocks on the oldest copy when all buffers are in use.");
+            changed |= w.var("Encoder Queue Size", desc.queueSize, 1u, 64u);
+            w.tooltip("Maximum number of images waiting for an encoder thread. Capturing blocks when the queue is full.");
+            if (changed) mpCaptureQueue->setDesc(desc);
+            w.text("Pending images: " + std::to_string(mpCaptureQueue->getPendingCount()));
         }
     }
 
@@ -95,6 +107,7 @@ namespace Mogwai
         auto printGraph = [](FrameCapture* pFC, RenderGraph* pGraph) { pybind11::print(pFC->graphFramesStr(pGraph)); };
         frameCapture.def(kPrintFrames.c_str(), printGraph, "graph"_a);
         frameCapture.def(kCapture.c_str(), &FrameCapture::capture);
+        frameCapture.def(kFlush.c_str(), &FrameCapture::flush);
         auto printAllGraphs = [](FrameCapture* pFC)
         {
             std::string s;
@@ -111,6 +124,22 @@ namespace Mogwai
         frameCapture.def_property("captureAllOutputs",
             [](FrameCapture* pFC){ return pFC->mCaptureAllOutputs;},
             [](FrameCapture* pFC, bool all){ pFC->mCaptureAllOutputs = all; });
+
+        auto setQueueDesc = [](FrameCapture* pFC, auto member, uint32_t value)
+        {
+            auto desc = pFC->mpCaptureQueue->getDesc();
+            desc.*member = value;
+            pFC->mpCaptureQueue->setDesc(desc);
+        };
+        frameCapture.def_property("encoderThreads",
+            [](FrameCapture* pFC) { return pFC->mpCaptureQueue->getDesc().workerCount; },
+            [setQueueDesc](FrameCapture* pFC, uint32_t count) { setQueueDesc(pFC, &CaptureQueue::Desc::workerCount, count); });
+        frameCapture.def_property("readbackBuffers",
+            [](FrameCapture* pFC) { return pFC->mpCaptureQueue->getDesc().readbackCount; },
+            [setQueueDesc](FrameCapture* pFC, uint32_t count) { setQueueDesc(pFC, &CaptureQueue::Desc::readbackCount, count); });
+        frameCapture.def_property("encoderQueueSize",
+            [](FrameCapture* pFC) { return pFC->mpCaptureQueue->getDesc().queueSize; },
+            [setQueueDesc](FrameCapture* pFC, uint32_t count) { setQueueDesc(pFC, &CaptureQueue::Desc::queueSize, count); });
     }
 
     std::string FrameCapture::getScriptVar() const
@@ -134,6 +163,8 @@ namespace Mogwai
 
     void FrameCapture::triggerFrame(RenderContext* pRenderContext, RenderGraph* pGraph, uint64_t frameID)
     {
+        mpCaptureQueue->poll();
+
         std::vector<std::string> unmarkedOutputs;
 
         if (mCaptureAllOutputs)
@@ -248,10 +279,25 @@ namespace Mogwai
             Bitmap::ExportFlags flags = Bitmap::ExportFlags::None;
             if (mask == TextureChannelFlags::RGBA) flags |= Bitmap::ExportFlags::ExportAlpha;
 
-            pTex->captureToFile(0, 0, filename, fileformat, flags);
+            mpCaptureQueue->enqueue(pRenderContext, pTex, filename, fileformat, flags);
         }
     }
 
+    void FrameCapture::endRange(RenderGraph* pGraph, const Range& r)
+    {
+        mpCaptureQueue->poll();
+    }
+
+    void FrameCapture::onShutdown()
+    {
+        flush();
+    }
+
+    void FrameCapture::flush()
+    {
+        mpCaptureQueue->flush();
+    }
+
     void FrameCapture::addFrames(const RenderGraph* pGraph, const uint64_vec& frames)
     {
         for (auto f : frames) addRange(pGraph, f, 1);
@@ -28,6 +28,7 @@
 #pragma once
 #include "../../Mogwai.h"
 #include "CaptureTrigger.h"
+#include "Utils/Image/CaptureQueue.h"
 #include "Utils/Image/ImageProcessing.h"
 
 namespace Mogwai
@@ -41,8 +42,14 @@ namespace Mogwai
         virtual std::string getScriptVar() const override;
         virtual std::string getScript(const std::string& var) const override;
         virtual void triggerFrame(RenderContext* pRenderContext, RenderGraph* pGraph, uint64_t frameID) override;
+        virtual void endRange(RenderGraph* pGraph, const Range& r) override;
+        virtual void onShutdown() override;
         void capture();
 
+        /** Block until all captured images have been written to disk.
+        */
+        void flush();
+
     private:
         FrameCapture(Renderer* pRenderer);
 
@@ -54,5 +61,6 @@ namespace Mogwai
 
         bool mCaptureAllOutputs = false;
         std::unique_ptr<ImageProcessing> mpImageProcessing;
+        std::unique_ptr<CaptureQueue> mpCaptureQueue;
     };
 }
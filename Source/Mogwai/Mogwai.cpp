@@ -80,6 +80,7 @@ namespace Mogwai
 
     void Renderer::onShutdown()
     {
+        for (auto& pe : mpExtensions) pe->onShutdown();
         resetEditor();
         getDevice()->flushAndSync(); // Need to do that because clearing the graphs will try to release some state objects which might be in use
         mGraphs.clear();
@@ -691,7 +692,7 @@ namespace Mogwai
             executeActiveGraph(pRenderContext);
 
             // Blit main graph output to frame buffer.
-            if (mGraphs[mActiveGraph].mainOutput.size())
+            if (mGraphs[mActiveGraph].mainOutput.size() && !getDevice()->isHostDevice())
             {
                 Texture::SharedPtr pOutTex = std::dynamic_pointer_cast<Texture>(pGraph->getOutput(mGraphs[mActiveGraph].mainOutput));
                 FALCOR_ASSERT(pOutTex);
@@ -809,7 +810,7 @@ int main(int argc, char** argv)
     args::ArgumentParser parser("Mogwai render application.");
     parser.helpParams.programName = "Mogwai";
     args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
-    args::ValueFlag<std::string> deviceTypeFlag(parser, "d3d12|vulkan", "Graphics device type.", {'d', "device-type"});
+    args::ValueFlag<std::string> deviceTypeFlag(parser, "d3d12|vulkan|null", "Graphics device type. The null device does no GPU work (requires --headless).", {'d', "device-type"});
     args::Flag listGPUsFlag(parser, "", "List available GPUs", {"list-gpus"});
     args::ValueFlag<uint32_t> gpuFlag(parser, "index", "Select specific GPU to use", {"gpu"});
     args::Flag headlessFlag(parser, "", "Start without opening a window and handling user input.", {"headless"});
@@ -828,6 +829,7 @@ int main(int argc, char** argv)
     args::Flag generateShaderDebugInfoFlag(parser, "", "Generate shader debug info.", {"debug-shaders"});
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag preciseProgramFlag(parser, "", "Force all slang programs to run in precise mode", { "precise" });
+    args::ValueFlag<uint32_t> threadsFlag(parser, "N", "Number of worker threads (default: logical thread count).", {"threads"});
 
     args::CompletionFlag completionFlag(parser, {"complete"});
 
@@ -881,9 +883,11 @@ int main(int argc, char** argv)
             config.deviceDesc.type = Device::Type::D3D12;
         else if (args::get(deviceTypeFlag) == "vulkan")
             config.deviceDesc.type = Device::Type::Vulkan;
+        else if (args::get(deviceTypeFlag) == "null")
+            config.deviceDesc.type = Device::Type::Null;
         else
         {
-            std::cerr << "Invalid device type, use 'd3d12' or 'vulkan'" << std::endl;
+            std::cerr << "Invalid device type, use 'd3d12', 'vulkan' or 'null'" << std::endl;
             return 1;
         }
     }
@@ -906,6 +910,8 @@ int main(int argc, char** argv)
         config.generateShaderDebugInfo = true;
     if (preciseProgramFlag)
         config.shaderPreciseFloat = true;
+    if (threadsFlag)
+        config.threadCount = args::get(threadsFlag);
 
     config.windowDesc.title = "Mogwai";
     if (widthFlag)
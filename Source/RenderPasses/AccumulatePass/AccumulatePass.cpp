@@ -92,6 +92,8 @@ AccumulatePass::SharedPtr AccumulatePass::create(std::shared_ptr<Device> pDevice
 
 AccumulatePass::AccumulatePass(std::shared_ptr<Device> pDevice, const Dictionary& dict)
     : RenderPass(std::move(pDevice))
+    , mSrcHandle(kInputChannel)
+    , mDstHandle(kOutputChannel)
 {
     // Deserialize pass from dictionary.
     for (const auto& [key, value] : dict)
@@ -190,8 +192,8 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
     }
 
     // Grab our input/output buffers.
-    Texture::SharedPtr pSrc = renderData.getTexture(kInputChannel);
-    Texture::SharedPtr pDst = renderData.getTexture(kOutputChannel);
+    Texture::SharedPtr pSrc = renderData.getTexture(mSrcHandle);
+    Texture::SharedPtr pDst = renderData.getTexture(mDstHandle);
     FALCOR_ASSERT(pSrc && pDst);
 
     const uint2 resolution = uint2(pSrc->getWidth(), pSrc->getHeight());
@@ -93,6 +93,8 @@ protected:
     std::map<Precision, ComputeProgram::SharedPtr> mpProgram;   ///< Accumulation programs, one per mode.
     ComputeVars::SharedPtr      mpVars;                         ///< Program variables.
     ComputeState::SharedPtr     mpState;
+    RenderData::ResourceHandle  mSrcHandle;                     ///< Handle to the input channel.
+    RenderData::ResourceHandle  mDstHandle;                     ///< Handle to the output channel.
     FormatType                  mSrcType;                       ///< Format type of the source that gets accumulated.
 
     uint32_t                    mFrameCount = 0;                ///< Number of accumulated frames. This is reset upon changes.
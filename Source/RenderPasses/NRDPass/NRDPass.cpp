@@ -988,7 +988,7 @@ void NRDPass::executeInternal(RenderContext* pRenderContext, const RenderData& r
     for (uint32_t i = 0; i < dispatchDescNum; i++)
     {
         const nrd::DispatchDesc& dispatchDesc = dispatchDescs[i];
-        FALCOR_PROFILE(pRenderContext, dispatchDesc.name);
+        FALCOR_PROFILE_DYNAMIC(pRenderContext, dispatchDesc.name);
         dispatch(pRenderContext, renderData, dispatchDesc);
     }
 
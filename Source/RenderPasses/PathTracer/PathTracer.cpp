@@ -1299,7 +1299,7 @@ void PathTracer::generatePaths(RenderContext* pRenderContext, const RenderData&
 
 void PathTracer::tracePass(RenderContext* pRenderContext, const RenderData& renderData, TracePass& tracePass)
 {
-    FALCOR_PROFILE(pRenderContext, tracePass.name);
+    FALCOR_PROFILE_DYNAMIC(pRenderContext, tracePass.name);
 
     FALCOR_ASSERT(tracePass.pProgram != nullptr && tracePass.pBindingTable != nullptr && tracePass.pVars != nullptr);
 
@@ -139,6 +139,8 @@ ToneMapper::SharedPtr ToneMapper::create(std::shared_ptr<Device> pDevice, const
 
 ToneMapper::ToneMapper(std::shared_ptr<Device> pDevice, const Dictionary& dict)
     : RenderPass(std::move(pDevice))
+    , mSrcHandle(kSrc)
+    , mDstHandle(kDst)
 {
     parseDictionary(dict);
 
@@ -217,8 +219,8 @@ RenderPassReflection ToneMapper::reflect(const CompileData& compileData)
 
 void ToneMapper::execute(RenderContext* pRenderContext, const RenderData& renderData)
 {
-    auto pSrc = renderData.getTexture(kSrc);
-    auto pDst = renderData.getTexture(kDst);
+    auto pSrc = renderData.getTexture(mSrcHandle);
+    auto pDst = renderData.getTexture(mDstHandle);
     FALCOR_ASSERT(pSrc && pDst);
 
     // Issue warning if image will be resampled. The render pass supports this but image quality may suffer.
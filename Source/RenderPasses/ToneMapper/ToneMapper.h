@@ -105,6 +105,8 @@ private:
     Fbo::SharedPtr mpLuminanceFbo;
     Sampler::SharedPtr mpPointSampler;
     Sampler::SharedPtr mpLinearSampler;
+    RenderData::ResourceHandle mSrcHandle;
+    RenderData::ResourceHandle mDstHandle;
 
     RenderPassHelpers::IOSize mOutputSizeSelection = RenderPassHelpers::IOSize::Default;    ///< Selected output size.
     ResourceFormat mOutputFormat = ResourceFormat::Unknown;                                 ///< Output format (uses default when set to ResourceFormat::Unknown).
@@ -43,8 +43,10 @@ FalcorTest::~FalcorTest() {}
 
 void FalcorTest::onFrameRender(RenderContext* pRenderContext, const Fbo::SharedPtr& pTargetFbo)
 {
-    int returnCode =
-        runTests(getDevice(), getTargetFbo().get(), mOptions.categoryFlags, mOptions.filter, mOptions.xmlReportPath, mOptions.repeat);
+    int returnCode = runTests(
+        getDevice(), getTargetFbo().get(), mOptions.categoryFlags, mOptions.filter, mOptions.xmlReportPath, mOptions.repeat,
+        mOptions.kindFlags, mOptions.benchmarkOptions
+    );
     shutdown(returnCode);
 }
 
@@ -54,12 +56,20 @@ int main(int argc, char** argv)
     parser.helpParams.programName = "FalcorTest";
     args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
     args::ValueFlag<std::string> categoryFlag(parser, "all,cpu,gpu", "Test categories to run (default: all).", {'c', "category"});
-    args::ValueFlag<std::string> deviceTypeFlag(parser, "d3d12|vulkan", "Graphics device type.", {'d', "device-type"});
+    args::ValueFlag<std::string> deviceTypeFlag(parser, "d3d12|vulkan|cpu|null", "Graphics device type.", {'d', "device-type"});
     args::Flag listGPUsFlag(parser, "", "List available GPUs", {"list-gpus"});
     args::ValueFlag<uint32_t> gpuFlag(parser, "index", "Select specific GPU to use", {"gpu"});
     args::ValueFlag<std::string> filterFlag(parser, "filter", "Regular expression for filtering tests to run.", {'f', "filter"});
     args::ValueFlag<std::string> xmlReportFlag(parser, "path", "XML report output file.", {'x', "xml-report"});
     args::ValueFlag<uint32_t> repeatFlag(parser, "N", "Number of times to repeat the test.", {'r', "repeat"});
+    args::ValueFlag<std::string> kindFlag(parser, "all,test,benchmark", "Kinds of tests to run (default: test).", {'k', "kind"});
+    args::ValueFlag<std::string> benchmarkReportFlag(parser, "path", "Benchmark JSON report output file.", {"benchmark-report"});
+    args::ValueFlag<std::string> benchmarkBaselineFlag(
+        parser, "path", "Benchmark JSON report to compare the benchmark results against.", {"benchmark-baseline"}
+    );
+    args::ValueFlag<double> benchmarkToleranceFlag(
+        parser, "tolerance", "Relative slowdown over the baseline that fails a benchmark (default: 0.1).", {"benchmark-tolerance"}
+    );
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::CompletionFlag completionFlag(parser, {"complete"});
 
@@ -99,9 +109,13 @@ int main(int argc, char** argv)
             config.deviceDesc.type = Device::Type::D3D12;
         else if (args::get(deviceTypeFlag) == "vulkan")
             config.deviceDesc.type = Device::Type::Vulkan;
+        else if (args::get(deviceTypeFlag) == "cpu")
+            config.deviceDesc.type = Device::Type::CPU;
+        else if (args::get(deviceTypeFlag) == "null")
+            config.deviceDesc.type = Device::Type::Null;
         else
         {
-            std::cerr << "Invalid device type, use 'd3d12' or 'vulkan'" << std::endl;
+            std::cerr << "Invalid device type, use 'd3d12', 'vulkan', 'cpu' or 'null'" << std::endl;
             return 1;
         }
     }
@@ -144,6 +158,31 @@ int main(int argc, char** argv)
         options.xmlReportPath = args::get(xmlReportFlag);
     if (repeatFlag)
         options.repeat = args::get(repeatFlag);
+    if (kindFlag)
+    {
+        options.kindFlags = UnitTestKindFlags::None;
+        std::vector<std::string> tokens = splitString(args::get(kindFlag), ",");
+        for (const auto& token : tokens)
+        {
+            if (token == "all")
+                options.kindFlags |= UnitTestKindFlags::All;
+            else if (token == "test")
+                options.kindFlags |= UnitTestKindFlags::Test;
+            else if (token == "benchmark")
+                options.kindFlags |= UnitTestKindFlags::Benchmark;
+            else
+            {
+                std::cerr << "Invalid test kind '" << token << "'" << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (benchmarkReportFlag)
+        options.benchmarkOptions.reportPath = args::get(benchmarkReportFlag);
+    if (benchmarkBaselineFlag)
+        options.benchmarkOptions.baselinePath = args::get(benchmarkBaselineFlag);
+    if (benchmarkToleranceFlag)
+        options.benchmarkOptions.tolerance = args::get(benchmarkToleranceFlag);
 
     // Disable logging to console, we don't want to clutter the test runner output with log messages.
     Logger::setOutputs(Logger::OutputFlags::File | Logger::OutputFlags::DebugWindow);
@@ -41,6 +41,8 @@ public:
         std::string filter;
         std::filesystem::path xmlReportPath;
         uint32_t repeat = 1;
+        UnitTestKindFlags kindFlags = UnitTestKindFlags::Test;
+        BenchmarkOptions benchmarkOptions;
     };
 
     FalcorTest(const SampleAppConfig& config, const Options& options);
@@ -120,22 +120,22 @@ void testBlit(GPUUnitTestContext& ctx, const uint2 srcDim, const uint32_t scale)
 }
 } // namespace
 
-GPU_TEST(BlitFloatNoFilter)
+GPU_TEST_NO_CPU(BlitFloatNoFilter, "Blits use a rasterization pass, which the CPU device does not support.")
 {
     testBlit<float>(ctx, uint2(33, 63), 1);
 }
 
-GPU_TEST(BlitFloatFilter)
+GPU_TEST_NO_CPU(BlitFloatFilter, "Blits use a rasterization pass, which the CPU device does not support.")
 {
     testBlit<float>(ctx, uint2(32, 64), 2);
 }
 
-GPU_TEST(BlitUintNoFilter)
+GPU_TEST_NO_CPU(BlitUintNoFilter, "Blits use a rasterization pass, which the CPU device does not support.")
 {
     testBlit<uint32_t>(ctx, uint2(33, 63), 1);
 }
 
-GPU_TEST(BlitUintFilter)
+GPU_TEST_NO_CPU(BlitUintFilter, "Blits use a rasterization pass, which the CPU device does not support.")
 {
     testBlit<uint32_t>(ctx, uint2(32, 64), 2);
 }
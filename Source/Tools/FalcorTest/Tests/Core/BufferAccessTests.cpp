@@ -70,7 +70,7 @@ void testBufferReadback(GPUUnitTestContext& ctx, Buffer::CpuAccess cpuAccess)
 /** Test that initialization of buffer with CPU write access works.
     The test copies the data to a staging buffer on the GPU.
 */
-GPU_TEST(CopyBufferCpuAccessWrite)
+GPU_TEST_NO_CPU(CopyBufferCpuAccessWrite, "Tests GPU memory heaps, the CPU device keeps all buffers in host memory.")
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -97,7 +97,11 @@ GPU_TEST(CopyBufferCpuAccessWrite)
 
 /** Test setBlob() into buffer with CPU write access.
  */
-GPU_TEST(SetBlobBufferCpuAccessWrite, "Disabled due to issue with SRV/UAVs for resources on the upload heap (#638)")
+GPU_TEST_NO_CPU(
+    SetBlobBufferCpuAccessWrite,
+    "Tests GPU memory heaps, the CPU device keeps all buffers in host memory.",
+    "Disabled due to issue with SRV/UAVs for resources on the upload heap (#638)"
+)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -125,14 +129,14 @@ GPU_TEST(SetBlobBufferCpuAccessWrite, "Disabled due to issue with SRV/UAVs for r
 
 /** Test that GPU reads from buffer created without CPU access works.
  */
-GPU_TEST(BufferCpuAccessNone)
+GPU_TEST_NO_CPU(BufferCpuAccessNone, "Tests GPU memory heaps, the CPU device keeps all buffers in host memory.")
 {
     testBufferReadback(ctx, Buffer::CpuAccess::None);
 }
 
 /** Test that GPU reads from buffer created with CPU read access works.
  */
-GPU_TEST(BufferCpuAccessRead)
+GPU_TEST_NO_CPU(BufferCpuAccessRead, "Tests GPU memory heaps, the CPU device keeps all buffers in host memory.")
 {
     testBufferReadback(ctx, Buffer::CpuAccess::Read);
 }
@@ -141,7 +145,11 @@ GPU_TEST(BufferCpuAccessRead)
 
 /** Test that GPU reads from buffer created with CPU write access works.
  */
-GPU_TEST(BufferCpuAccessWrite, "Disabled due to issue with SRV/UAVs for resources on the upload heap (#638)")
+GPU_TEST_NO_CPU(
+    BufferCpuAccessWrite,
+    "Tests GPU memory heaps, the CPU device keeps all buffers in host memory.",
+    "Disabled due to issue with SRV/UAVs for resources on the upload heap (#638)"
+)
 {
     testBufferReadback(ctx, Buffer::CpuAccess::Write);
 }
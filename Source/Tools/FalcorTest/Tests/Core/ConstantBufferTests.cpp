@@ -31,7 +31,7 @@ namespace Falcor
 {
 /** GPU test for builtin constant buffer using cbuffer syntax.
  */
-GPU_TEST(BuiltinConstantBuffer1)
+COMPUTE_TEST(BuiltinConstantBuffer1)
 {
     ctx.createProgram("Tests/Core/ConstantBufferTests.cs.slang", "testCbuffer1", Program::DefineList(), Shader::CompilerFlags::None);
     ctx.allocateStructuredBuffer("result", 3);
@@ -49,7 +49,7 @@ GPU_TEST(BuiltinConstantBuffer1)
 
 /** GPU test for builtin constant buffer using ConstantBuffer<> syntax.
  */
-GPU_TEST(BuiltinConstantBuffer2)
+COMPUTE_TEST(BuiltinConstantBuffer2)
 {
     ctx.createProgram("Tests/Core/ConstantBufferTests.cs.slang", "testCbuffer2", Program::DefineList(), Shader::CompilerFlags::None);
     ctx.allocateStructuredBuffer("result", 3);
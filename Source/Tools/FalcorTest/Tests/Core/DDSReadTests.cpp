@@ -181,7 +181,7 @@ DDS_TEST(BC7UnormOdd, ResourceFormat::BC7Unorm);
 DDS_TEST(BC7UnormSrgb, ResourceFormat::BC7UnormSrgb);
 DDS_TEST(BC7UnormTiny, ResourceFormat::BC7Unorm);
 
-GPU_TEST(BC7UnormBroken)
+GPU_TEST_NO_CPU(BC7UnormBroken, "Block-compressed texture formats are not supported on the CPU device.")
 {
     testDDS(ctx, std::string("BC7UnormBroken"), ResourceFormat::BC7Unorm, true);
 }
@@ -266,17 +266,17 @@ void testReadStructuredUint(GPUUnitTestContext& ctx, bool useRootDesc, size_t bu
     support >4GB buffers, but that does not currently seem to be the case.
 */
 
-GPU_TEST(LargeBufferCopyRegion1)
+GPU_TEST_NO_CPU(LargeBufferCopyRegion1, "Tests GPU size limits of buffers and buffer views.")
 {
     testCopyRegion(ctx, 3ull << 30); // 3GB
 }
 
-GPU_TEST(LargeBufferCopyRegion2)
+GPU_TEST_NO_CPU(LargeBufferCopyRegion2, "Tests GPU size limits of buffers and buffer views.")
 {
     testCopyRegion(ctx, 4ull << 30); // 4GB
 }
 
-GPU_TEST(LargeBufferCopyRegion3, "Disabled due to 4GB buffer limit")
+GPU_TEST_NO_CPU(LargeBufferCopyRegion3, "Tests GPU size limits of buffers and buffer views.", "Disabled due to 4GB buffer limit")
 {
     testCopyRegion(ctx, 5ull << 30); // 5GB
 }
@@ -285,7 +285,7 @@ GPU_TEST(LargeBufferCopyRegion3, "Disabled due to 4GB buffer limit")
     Raw buffers are addressed using a 32-bit offset so cannot exceed 4GB.
 */
 
-GPU_TEST(LargeBufferReadRawRoot1)
+GPU_TEST_NO_CPU(LargeBufferReadRawRoot1, "Tests GPU size limits of buffers and buffer views.")
 {
     testReadRaw(ctx, true, 3ull << 30); // 3GB
 }
@@ -308,7 +308,7 @@ GPU_TEST_D3D12(LargeBufferReadRawRoot3, "Disabled due to 4GB buffer limit")
     support >4GB buffers, but that does not currently seem to be the case.
 */
 
-GPU_TEST(LargeBufferReadStructuredRoot1)
+GPU_TEST_NO_CPU(LargeBufferReadStructuredRoot1, "Tests GPU size limits of buffers and buffer views.")
 {
     testReadStructured(ctx, true, 3ull << 30); // 3GB
 }
@@ -333,17 +333,21 @@ GPU_TEST_D3D12(LargeBufferReadStructuredRoot3, "Disabled due to 4GB buffer limit
     addresses >2GB gives unexpected results for both raw and structured buffers.
 */
 
-GPU_TEST(LargeBufferReadRawSRV1)
+GPU_TEST_NO_CPU(LargeBufferReadRawSRV1, "Tests GPU size limits of buffers and buffer views.")
 {
     testReadRaw(ctx, false, 2ull << 30); // 2GB
 }
 
-GPU_TEST(LargeBufferReadRawSRV2, "Disabled due to 2GB limit on raw buffer SRVs")
+GPU_TEST_NO_CPU(
+    LargeBufferReadRawSRV2, "Tests GPU size limits of buffers and buffer views.", "Disabled due to 2GB limit on raw buffer SRVs"
+)
 {
     testReadRaw(ctx, false, 3ull << 30); // 3GB
 }
 
-GPU_TEST(LargeBufferReadRawSRV3, "Disabled due to 2GB limit on raw buffer SRVs")
+GPU_TEST_NO_CPU(
+    LargeBufferReadRawSRV3, "Tests GPU size limits of buffers and buffer views.", "Disabled due to 2GB limit on raw buffer SRVs"
+)
 {
     testReadRaw(ctx, false, (4ull << 30) - 1024); // almost 4GB
 }
@@ -352,17 +356,17 @@ GPU_TEST(LargeBufferReadRawSRV3, "Disabled due to 2GB limit on raw buffer SRVs")
     SRVs have restrictions on the size.
 */
 
-GPU_TEST(LargeBufferReadStructuredSRV1)
+GPU_TEST_NO_CPU(LargeBufferReadStructuredSRV1, "Tests GPU size limits of buffers and buffer views.")
 {
     testReadStructured(ctx, false, 2ull << 30); // 2GB
 }
 
-GPU_TEST(LargeBufferReadStructuredSRV2)
+GPU_TEST_NO_CPU(LargeBufferReadStructuredSRV2, "Tests GPU size limits of buffers and buffer views.")
 {
     testReadStructured(ctx, false, 3ull << 30); // 3GB
 }
 
-GPU_TEST(LargeBufferReadStructuredSRV3)
+GPU_TEST_NO_CPU(LargeBufferReadStructuredSRV3, "Tests GPU size limits of buffers and buffer views.")
 {
     testReadStructured(ctx, false, (4ull << 30) - 1024); // almost 4GB
 }
@@ -371,17 +375,21 @@ GPU_TEST(LargeBufferReadStructuredSRV3)
     SRVs have restrictions on the size.
 */
 
-GPU_TEST(LargeBufferReadStructuredUintSRV1)
+GPU_TEST_NO_CPU(LargeBufferReadStructuredUintSRV1, "Tests GPU size limits of buffers and buffer views.")
 {
     testReadStructuredUint(ctx, false, 2ull << 30); // 2GB
 }
 
-GPU_TEST(LargeBufferReadStructuredUintSRV2, "Disabled due to 2GB limit on uint buffer SRVs")
+GPU_TEST_NO_CPU(
+    LargeBufferReadStructuredUintSRV2, "Tests GPU size limits of buffers and buffer views.", "Disabled due to 2GB limit on uint buffer SRVs"
+)
 {
     testReadStructuredUint(ctx, false, 3ull << 30); // 3GB
 }
 
-GPU_TEST(LargeBufferReadStructuredUintSRV3, "Disabled due to 2GB limit on uint buffer SRVs")
+GPU_TEST_NO_CPU(
+    LargeBufferReadStructuredUintSRV3, "Tests GPU size limits of buffers and buffer views.", "Disabled due to 2GB limit on uint buffer SRVs"
+)
 {
     testReadStructuredUint(ctx, false, (4ull << 30) - 1024); // almost 4GB
 }
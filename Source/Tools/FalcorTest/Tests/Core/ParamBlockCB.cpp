@@ -31,7 +31,7 @@ namespace Falcor
 {
 /** Minimal GPU test for constant buffer in ParameterBlock.
  */
-GPU_TEST(ParamBlockCB)
+COMPUTE_TEST(ParamBlockCB)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -0,0 +1,122 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Program/ProgramManager.h"
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kNumElems = 256;
+
+void runAndCheck(GPUUnitTestContext& ctx, uint32_t value)
+{
+    ctx.getProgram()->addDefine("VALUE", std::to_string(value));
+    ctx.createVars();
+    ctx.allocateStructuredBuffer("result", kNumElems);
+    ctx.runProgram(kNumElems, 1, 1);
+
+    const uint32_t* result = ctx.mapBuffer<const uint32_t>("result");
+    for (uint32_t i = 0; i < kNumElems; i++)
+    {
+        EXPECT_EQ(result[i], value * i) << "i = " << i << ", VALUE = " << value;
+    }
+    ctx.unmapBuffer("result");
+}
+} // namespace
+
+COMPUTE_TEST(ProgramPrecompile)
+{
+    if (!Threading::isStarted())
+        throw SkippingTestException("Thread pool is not running");
+
+    ProgramManager* pProgramManager = ctx.getDevice()->getProgramManager();
+
+    ctx.createProgram(
+        "Tests/Core/ProgramPrecompileTests.cs.slang", "main", Program::DefineList{{"VALUE", "1"}}, Shader::CompilerFlags::None, "", false
+    );
+    Program::SharedPtr pProgram = ctx.getProgram()->shared_from_this();
+
+    std::vector<Program::DefineList> defineLists;
+    for (uint32_t value = 2; value <= 5; value++)
+        defineLists.push_back(Program::DefineList{{"VALUE", std::to_string(value)}});
+
+    pProgramManager->precompileProgramVersions(pProgram, defineLists);
+    pProgramManager->waitForPrecompilation();
+
+    // Switching to a precompiled define set must not compile the program again.
+    size_t versionCount = pProgramManager->getCompilationStats().programVersionCount;
+    for (uint32_t value = 2; value <= 5; value++)
+        runAndCheck(ctx, value);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, versionCount);
+
+    // Define sets that have not been precompiled are compiled on demand.
+    runAndCheck(ctx, 7);
+}
+
+COMPUTE_TEST(ProgramPrecompileWhileLinking)
+{
+    bool startThreading = !Threading::isStarted();
+    if (startThreading)
+        Threading::start();
+
+    try
+    {
+        ProgramManager* pProgramManager = ctx.getDevice()->getProgramManager();
+
+        ctx.createProgram(
+            "Tests/Core/ProgramPrecompileTests.cs.slang", "main", Program::DefineList{{"VALUE", "1"}}, Shader::CompilerFlags::None, "", false
+        );
+        Program::SharedPtr pProgram = ctx.getProgram()->shared_from_this();
+
+        // Queue many more variants than there are workers, then link and run each one on this thread as soon as it is available,
+        // while the remaining variants are still being compiled. Linking uses the same pooled Slang sessions as the workers.
+        const uint32_t kVariantCount = 4 * Threading::getThreadCount() + 4;
+        std::vector<Program::DefineList> defineLists;
+        for (uint32_t value = 2; value < 2 + kVariantCount; value++)
+            defineLists.push_back(Program::DefineList{{"VALUE", std::to_string(value)}});
+        size_t versionCount = pProgramManager->getCompilationStats().programVersionCount;
+        pProgramManager->precompileProgramVersions(pProgram, defineLists);
+
+        for (uint32_t value = 2; value < 2 + kVariantCount; value++)
+            runAndCheck(ctx, value);
+
+        // Every variant was compiled exactly once, by the workers.
+        pProgramManager->waitForPrecompilation();
+        EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, versionCount + kVariantCount);
+    }
+    catch (...)
+    {
+        if (startThreading)
+            Threading::shutdown();
+        throw;
+    }
+    if (startThreading)
+        Threading::shutdown();
+}
+} // namespace Falcor
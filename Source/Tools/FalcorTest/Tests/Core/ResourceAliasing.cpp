@@ -29,7 +29,7 @@
 
 namespace Falcor
 {
-GPU_TEST(BufferAliasingRead)
+COMPUTE_TEST(BufferAliasingRead)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -60,7 +60,7 @@ GPU_TEST(BufferAliasingRead)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(BufferAliasingReadWrite)
+COMPUTE_TEST(BufferAliasingReadWrite)
 {
     Device* pDevice = ctx.getDevice().get();
 
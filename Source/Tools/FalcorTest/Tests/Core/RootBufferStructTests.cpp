@@ -101,22 +101,22 @@ void testRootBufferInStruct(GPUUnitTestContext& ctx, const std::string& shaderMo
 }
 } // namespace
 
-GPU_TEST(RootBufferStructSRV_6_0)
+GPU_TEST_NO_CPU(RootBufferStructSRV_6_0, "Root buffers are bound as root descriptors, which the CPU device does not have.")
 {
     testRootBufferInStruct(ctx, "6_0", false);
 }
 
-GPU_TEST(RootBufferStructUAV_6_0)
+GPU_TEST_NO_CPU(RootBufferStructUAV_6_0, "Root buffers are bound as root descriptors, which the CPU device does not have.")
 {
     testRootBufferInStruct(ctx, "6_0", true);
 }
 
-GPU_TEST(RootBufferStructSRV_6_3)
+GPU_TEST_NO_CPU(RootBufferStructSRV_6_3, "Root buffers are bound as root descriptors, which the CPU device does not have.")
 {
     testRootBufferInStruct(ctx, "6_3", false);
 }
 
-GPU_TEST(RootBufferStructUAV_6_3)
+GPU_TEST_NO_CPU(RootBufferStructUAV_6_3, "Root buffers are bound as root descriptors, which the CPU device does not have.")
 {
     testRootBufferInStruct(ctx, "6_3", true);
 }
@@ -172,22 +172,22 @@ void testRootBuffer(GPUUnitTestContext& ctx, const std::string& shaderModel, boo
 }
 } // namespace
 
-GPU_TEST(RootBufferSRV_6_0)
+GPU_TEST_NO_CPU(RootBufferSRV_6_0, "Root buffers are bound as root descriptors, which the CPU device does not have.")
 {
     testRootBuffer(ctx, "6_0", false);
 }
 
-GPU_TEST(RootBufferUAV_6_0)
+GPU_TEST_NO_CPU(RootBufferUAV_6_0, "Root buffers are bound as root descriptors, which the CPU device does not have.")
 {
     testRootBuffer(ctx, "6_0", true);
 }
 
-GPU_TEST(RootBufferSRV_6_3)
+GPU_TEST_NO_CPU(RootBufferSRV_6_3, "Root buffers are bound as root descriptors, which the CPU device does not have.")
 {
     testRootBuffer(ctx, "6_3", false);
 }
 
-GPU_TEST(RootBufferUAV_6_3)
+GPU_TEST_NO_CPU(RootBufferUAV_6_3, "Root buffers are bound as root descriptors, which the CPU device does not have.")
 {
     testRootBuffer(ctx, "6_3", true);
 }
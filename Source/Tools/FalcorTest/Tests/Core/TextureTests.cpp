@@ -32,7 +32,7 @@ namespace Falcor
 {
 /** GPU test for reading/writing a 3D texture.
  */
-GPU_TEST(RWTexture3D)
+COMPUTE_TEST(RWTexture3D)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -68,9 +68,88 @@ GPU_TEST(RWTexture3D)
     ctx.unmapBuffer("result");
 }
 
+namespace
+{
+/// Create a 4x4 texture with values that vary linearly over the texels, so bilinear filtering is exact.
+Texture::SharedPtr createLinearTexture2D(Device* pDevice)
+{
+    std::vector<float4> data;
+    for (uint32_t y = 0; y < 4; y++)
+        for (uint32_t x = 0; x < 4; x++)
+            data.push_back(float4(float(x), float(y), float(x + 4 * y), 1.f));
+    return Texture::create2D(pDevice, 4, 4, ResourceFormat::RGBA32Float, 1, 1, data.data(), ResourceBindFlags::ShaderResource);
+}
+
+void expectTexel(float4 value, float x, float y, const std::string& msg)
+{
+    EXPECT_EQ(value.x, x) << msg;
+    EXPECT_EQ(value.y, y) << msg;
+    EXPECT_EQ(value.z, x + 4.f * y) << msg;
+    EXPECT_EQ(value.w, 1.f) << msg;
+}
+} // namespace
+
+/** Test for loading texels from a 2D texture.
+ */
+COMPUTE_TEST(Texture2DLoad)
+{
+    ctx.createProgram("Tests/Core/TextureTests.cs.slang", "testTexture2DLoad");
+    ctx.allocateStructuredBuffer("result4", 32);
+    ctx["tex2D"] = createLinearTexture2D(ctx.getDevice().get());
+    ctx.runProgram(4, 4, 1);
+
+    const float4* result = ctx.mapBuffer<const float4>("result4");
+    for (uint32_t y = 0; y < 4; y++)
+    {
+        for (uint32_t x = 0; x < 4; x++)
+        {
+            uint32_t i = y * 4 + x;
+            expectTexel(result[2 * i + 0], float(x), float(y), fmt::format("operator[] at ({}, {})", x, y));
+            expectTexel(result[2 * i + 1], float(x), float(y), fmt::format("Load() at ({}, {})", x, y));
+        }
+    }
+    ctx.unmapBuffer("result4");
+}
+
+/** Test for sampling a 2D texture with point and linear filtering.
+ */
+COMPUTE_TEST(Texture2DSample)
+{
+    auto pTex = createLinearTexture2D(ctx.getDevice().get());
+
+    for (auto filter : {Sampler::Filter::Point, Sampler::Filter::Linear})
+    {
+        Sampler::Desc desc;
+        desc.setFilterMode(filter, filter, Sampler::Filter::Point);
+        desc.setAddressingMode(Sampler::AddressMode::Clamp, Sampler::AddressMode::Clamp, Sampler::AddressMode::Clamp);
+
+        ctx.createProgram("Tests/Core/TextureTests.cs.slang", "testTexture2DSample");
+        ctx.allocateStructuredBuffer("result4", 49);
+        ctx["tex2D"] = pTex;
+        ctx["texSampler"] = Sampler::create(ctx.getDevice().get(), desc);
+        ctx.runProgram(7, 7, 1);
+
+        const float4* result = ctx.mapBuffer<const float4>("result4");
+        for (uint32_t y = 0; y < 7; y++)
+        {
+            for (uint32_t x = 0; x < 7; x++)
+            {
+                std::string msg = fmt::format("{} filter at ({}, {})", filter == Sampler::Filter::Point ? "point" : "linear", x, y);
+                // Even positions are texel centers. Odd positions lie on texel edges, where point sampling is ambiguous
+                // and linear filtering averages the neighboring texels.
+                if (filter == Sampler::Filter::Linear)
+                    expectTexel(result[y * 7 + x], 0.5f * x, 0.5f * y, msg);
+                else if (x % 2 == 0 && y % 2 == 0)
+                    expectTexel(result[y * 7 + x], float(x / 2), float(y / 2), msg);
+            }
+        }
+        ctx.unmapBuffer("result4");
+    }
+}
+
 /** GPU test for creating a min/max MIP pyramid.
  */
-GPU_TEST(TextureMinMaxMip)
+GPU_TEST_NO_CPU(TextureMinMaxMip, "Mip generation uses blits, which require rasterization.")
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -176,7 +255,7 @@ GPU_TEST(TextureMinMaxMip)
 
 // Test loading texture data both in the native format returned by `Bitmap` for 8-bit textures (BGRX8Unorm),
 // and explicitly as an 8-bit integer format (RGBA8Uint).
-GPU_TEST(Texture_Load8Bit)
+GPU_TEST_NO_CPU(Texture_Load8Bit, "Reads a UNORM texture through a UINT view, which requires GPU texture format reinterpretation.")
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -30,7 +30,7 @@
 
 namespace Falcor
 {
-GPU_TEST(InvalidPixelDetectionPass)
+GPU_TEST_NO_CPU(InvalidPixelDetectionPass, "The pass uses a full-screen rasterization pass.")
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -0,0 +1,103 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/FileWatcher.h"
+
+#include <chrono>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+void writeFile(const std::filesystem::path& path, const std::string& content, std::chrono::hours timeOffset)
+{
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << content;
+    }
+    // Make sure the modification time changes for the polling backend.
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() + timeOffset);
+}
+
+void testFileWatcher(CPUUnitTestContext& ctx, FileWatcher::Backend backend)
+{
+    const std::filesystem::path dir = "test_file_watcher";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto pathA = dir / "a.txt";
+    const auto pathB = dir / "b.txt";
+    writeFile(pathA, "a", std::chrono::hours(0));
+    writeFile(pathB, "b", std::chrono::hours(0));
+
+    {
+        auto pWatcher = FileWatcher::create(backend);
+#if FALCOR_LINUX
+        EXPECT(pWatcher->getBackend() == backend);
+#endif
+
+        EXPECT(pWatcher->watch(pathA));
+        EXPECT(pWatcher->watch(pathB));
+        EXPECT(pWatcher->watch(dir / ".." / pathA)); // Same file, different path.
+        EXPECT(pWatcher->getChangedFiles().empty());
+
+        // Modify file in place.
+        writeFile(pathA, "a2", std::chrono::hours(1));
+        auto changedFiles = pWatcher->getChangedFiles();
+        ASSERT_EQ(changedFiles.size(), 1);
+        EXPECT(changedFiles[0] == FileWatcher::getCanonicalPath(pathA));
+        EXPECT(pWatcher->getChangedFiles().empty());
+
+        // Replace file by renaming a new file over it.
+        writeFile(dir / "b.tmp", "b2", std::chrono::hours(2));
+        std::filesystem::rename(dir / "b.tmp", pathB);
+        changedFiles = pWatcher->getChangedFiles();
+        ASSERT_EQ(changedFiles.size(), 1);
+        EXPECT(changedFiles[0] == FileWatcher::getCanonicalPath(pathB));
+
+        // Changes to files that are not watched are not reported.
+        pWatcher->unwatch(pathA);
+        writeFile(pathA, "a3", std::chrono::hours(3));
+        writeFile(dir / "c.txt", "c", std::chrono::hours(3));
+        EXPECT(pWatcher->getChangedFiles().empty());
+    }
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace
+
+CPU_TEST(FileWatcher_Polling)
+{
+    testFileWatcher(ctx, FileWatcher::Backend::Polling);
+}
+
+CPU_TEST(FileWatcher_Native)
+{
+    testFileWatcher(ctx, FileWatcher::Backend::Native);
+}
+} // namespace Falcor
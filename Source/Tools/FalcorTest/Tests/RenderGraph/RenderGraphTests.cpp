@@ -0,0 +1,332 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraph.h"
+#include "RenderGraph/RenderGraphImportExport.h"
+#include "RenderGraph/BasePasses/ComputePass.h"
+
+namespace Falcor
+{
+namespace
+{
+const char kShaderFile[] = "Tests/RenderGraph/RenderGraphTests.cs.slang";
+const std::string kSrc = "src";
+const std::string kDst = "dst";
+const ResourceFormat kFormat = ResourceFormat::RGBA32Float;
+
+/** Pass writing a constant value to its output.
+ */
+class ConstantPass : public RenderPass
+{
+public:
+    FALCOR_PLUGIN_CLASS(ConstantPass, "ConstantPass", "Test pass writing a constant value.");
+
+    using SharedPtr = std::shared_ptr<ConstantPass>;
+
+    static SharedPtr create(std::shared_ptr<Device> pDevice, float value) { return SharedPtr(new ConstantPass(std::move(pDevice), value)); }
+
+    RenderPassReflection reflect(const CompileData& compileData) override
+    {
+        RenderPassReflection reflector;
+        reflector.addOutput(kDst, "Constant value").format(kFormat).bindFlags(ResourceBindFlags::UnorderedAccess);
+        return reflector;
+    }
+
+    void execute(RenderContext* pRenderContext, const RenderData& renderData) override
+    {
+        pRenderContext->clearUAV(renderData.getTexture(kDst)->getUAV().get(), float4(mValue));
+    }
+
+private:
+    ConstantPass(std::shared_ptr<Device> pDevice, float value) : RenderPass(std::move(pDevice)), mValue(value) {}
+
+    float mValue;
+};
+
+/** Pass adding one to its input. Records the input resource it was given.
+ */
+class IncrementPass : public RenderPass
+{
+public:
+    FALCOR_PLUGIN_CLASS(IncrementPass, "IncrementPass", "Test pass adding one to its input.");
+
+    using SharedPtr = std::shared_ptr<IncrementPass>;
+
+    static SharedPtr create(std::shared_ptr<Device> pDevice) { return SharedPtr(new IncrementPass(std::move(pDevice))); }
+
+    RenderPassReflection reflect(const CompileData& compileData) override
+    {
+        RenderPassReflection reflector;
+        reflector.addInput(kSrc, "Input").format(kFormat);
+        reflector.addOutput(kDst, "Input plus one").format(kFormat).bindFlags(ResourceBindFlags::UnorderedAccess);
+        return reflector;
+    }
+
+    void execute(RenderContext* pRenderContext, const RenderData& renderData) override
+    {
+        auto pSrc = renderData.getTexture(kSrc);
+        auto pDst = renderData.getTexture(kDst);
+        mpLastInput = pSrc.get();
+
+        auto var = mpPass->getRootVar();
+        var["gSrc"] = pSrc;
+        var["gDst"] = pDst;
+        mpPass->execute(pRenderContext, pDst->getWidth(), pDst->getHeight());
+    }
+
+    const Resource* getLastInput() const { return mpLastInput; }
+
+private:
+    IncrementPass(std::shared_ptr<Device> pDevice) : RenderPass(std::move(pDevice))
+    {
+        mpPass = ComputePass::create(mpDevice, kShaderFile, "main");
+    }
+
+    ComputePass::SharedPtr mpPass;
+    const Resource* mpLastInput = nullptr;
+};
+
+/** Pass looking up its resources both by handle and by name.
+ */
+class HandlePass : public RenderPass
+{
+public:
+    FALCOR_PLUGIN_CLASS(HandlePass, "HandlePass", "Test pass looking up resources by handle.");
+
+    using SharedPtr = std::shared_ptr<HandlePass>;
+
+    /** Resource found for a handle and for the handle's name.
+     */
+    struct Lookup
+    {
+        const Resource* pByHandle = nullptr;
+        const Resource* pByName = nullptr;
+    };
+
+    static SharedPtr create(std::shared_ptr<Device> pDevice) { return SharedPtr(new HandlePass(std::move(pDevice))); }
+
+    RenderPassReflection reflect(const CompileData& compileData) override
+    {
+        RenderPassReflection reflector;
+        reflector.addInput(kSrc, "Input").format(kFormat);
+        reflector.addOutput(kDst, "Output").format(kFormat).bindFlags(ResourceBindFlags::UnorderedAccess);
+        return reflector;
+    }
+
+    void execute(RenderContext* pRenderContext, const RenderData& renderData) override
+    {
+        auto lookup = [&](const RenderData::ResourceHandle& handle) { return Lookup{ renderData[handle].get(), renderData[handle.getName()].get() }; };
+        mSrc = lookup(mSrcHandle);
+        mDst = lookup(mDstHandle);
+        mMissing = lookup(mMissingHandle);
+        mExecuteCount++;
+
+        pRenderContext->clearUAV(renderData.getTexture(mDstHandle)->getUAV().get(), float4(0.f));
+    }
+
+    const Lookup& getSrc() const { return mSrc; }
+    const Lookup& getDst() const { return mDst; }
+    const Lookup& getMissing() const { return mMissing; }
+    uint32_t getExecuteCount() const { return mExecuteCount; }
+
+private:
+    HandlePass(std::shared_ptr<Device> pDevice) : RenderPass(std::move(pDevice)) {}
+
+    RenderData::ResourceHandle mSrcHandle{ kSrc };
+    RenderData::ResourceHandle mDstHandle{ kDst };
+    RenderData::ResourceHandle mMissingHandle{ "missing" }; ///< Not a field of the pass.
+    Lookup mSrc;
+    Lookup mDst;
+    Lookup mMissing;
+    uint32_t mExecuteCount = 0;
+};
+
+/** Create the graph Constant(1) -> Increment -> Increment -> Increment, whose output is 4 everywhere.
+    The input of the first and the third increment pass have disjoint lifetimes and identical properties.
+*/
+RenderGraph::SharedPtr createIncrementChain(GPUUnitTestContext& ctx, std::vector<IncrementPass::SharedPtr>& incrementPasses)
+{
+    auto pGraph = RenderGraph::create(ctx.getDevice(), "IncrementChain");
+    pGraph->addPass(ConstantPass::create(ctx.getDevice(), 1.f), "Constant");
+
+    std::string prevPass = "Constant";
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        std::string passName = "Increment" + std::to_string(i);
+        incrementPasses.push_back(IncrementPass::create(ctx.getDevice()));
+        pGraph->addPass(incrementPasses.back(), passName);
+        pGraph->addEdge(prevPass + "." + kDst, passName + "." + kSrc);
+        prevPass = passName;
+    }
+    pGraph->markOutput(prevPass + "." + kDst);
+    pGraph->onResize(ctx.getTargetFbo());
+    return pGraph;
+}
+
+void checkOutput(GPUUnitTestContext& ctx, const RenderGraph::SharedPtr& pGraph, float expected)
+{
+    auto pOutput = pGraph->getOutput("Increment2.dst");
+    ASSERT(pOutput != nullptr);
+    auto pTexture = pOutput->asTexture();
+    std::vector<uint8_t> data = ctx.getRenderContext()->readTextureSubresource(pTexture.get(), 0);
+    ASSERT_EQ(data.size(), size_t(pTexture->getWidth()) * pTexture->getHeight() * sizeof(float4));
+
+    const float* pValues = reinterpret_cast<const float*>(data.data());
+    for (size_t i = 0; i < data.size() / sizeof(float); i++)
+    {
+        EXPECT_EQ(pValues[i], expected) << "i = " << i;
+    }
+}
+} // namespace
+
+GPU_TEST_NO_CPU(RenderGraphTransientResourceAliasing, "Texture clears and readbacks in render graphs are not validated on the CPU device.")
+{
+    for (bool alias : { false, true })
+    {
+        std::vector<IncrementPass::SharedPtr> passes;
+        auto pGraph = createIncrementChain(ctx, passes);
+        EXPECT(!pGraph->isTransientResourceAliasingEnabled()); // Aliasing is opt-in.
+        pGraph->setTransientResourceAliasing(alias);
+
+        // Run a couple of frames so that shared resources are reused in steady state.
+        for (uint32_t frame = 0; frame < 2; frame++)
+        {
+            pGraph->execute(ctx.getRenderContext());
+            checkOutput(ctx, pGraph, 4.f);
+        }
+
+        // Only the inputs of the first and the last increment pass have disjoint lifetimes.
+        EXPECT_EQ(passes[0]->getLastInput() == passes[2]->getLastInput(), alias);
+        EXPECT_NE(passes[0]->getLastInput(), passes[1]->getLastInput());
+        EXPECT_NE(passes[1]->getLastInput(), passes[2]->getLastInput());
+    }
+}
+
+GPU_TEST_NO_CPU(
+    RenderGraphExportTransientResourceAliasing, "Texture clears and readbacks in render graphs are not validated on the CPU device."
+)
+{
+    std::vector<IncrementPass::SharedPtr> passes;
+    auto pGraph = createIncrementChain(ctx, passes);
+
+    const std::string property = "g.aliasTransientResources = True";
+    EXPECT(RenderGraphExporter::getIR(pGraph).find(property) == std::string::npos);
+
+    pGraph->setTransientResourceAliasing(true);
+    EXPECT(RenderGraphExporter::getIR(pGraph).find(property) != std::string::npos);
+}
+GPU_TEST_NO_CPU(RenderGraphResourceHandles, "Texture clears and readbacks in render graphs are not validated on the CPU device.")
+{
+    auto pPass = HandlePass::create(ctx.getDevice());
+    auto pGraph = RenderGraph::create(ctx.getDevice(), "ResourceHandles");
+    pGraph->addPass(ConstantPass::create(ctx.getDevice(), 1.f), "Constant");
+    pGraph->addPass(pPass, "Handle");
+    pGraph->addEdge("Constant.dst", "Handle.src");
+    pGraph->markOutput("Handle.dst");
+    pGraph->onResize(ctx.getTargetFbo());
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        // The second iteration recompiles the graph, which creates a new resource cache the handles need to be resolved against.
+        if (i > 0) pGraph->onResize(ctx.getTargetFbo());
+        pGraph->execute(ctx.getRenderContext());
+        ASSERT_EQ(pPass->getExecuteCount(), i + 1);
+
+        EXPECT(pPass->getSrc().pByHandle != nullptr);
+        EXPECT_EQ(pPass->getSrc().pByHandle, pPass->getSrc().pByName);
+        EXPECT(pPass->getDst().pByHandle != nullptr);
+        EXPECT_EQ(pPass->getDst().pByHandle, pPass->getDst().pByName);
+        EXPECT_EQ(pPass->getDst().pByHandle, pGraph->getOutput("Handle.dst").get());
+        EXPECT(pPass->getMissing().pByHandle == nullptr);
+        EXPECT(pPass->getMissing().pByName == nullptr);
+    }
+}
+
+GPU_TEST_NO_CPU(RenderGraphResourceHandlesUnresolved, "Texture clears and readbacks in render graphs are not validated on the CPU device.")
+{
+    auto pPass = HandlePass::create(ctx.getDevice());
+    auto pGraph = RenderGraph::create(ctx.getDevice(), "ResourceHandlesUnresolved");
+    pGraph->addPass(pPass, "Handle");
+    pGraph->markOutput("Handle.dst");
+    pGraph->onResize(ctx.getTargetFbo());
+
+    // The required input is not connected, so the graph can't be compiled and the pass never resolves its handles.
+    std::string log;
+    EXPECT(!pGraph->compile(ctx.getRenderContext(), log));
+    EXPECT(!log.empty());
+    EXPECT_EQ(pPass->getExecuteCount(), 0u);
+
+    // Binding the input externally makes the graph valid. The handle resolves to the external resource.
+    const Fbo* pFbo = ctx.getTargetFbo();
+    auto pInput = Texture::create2D(ctx.getDevice().get(), pFbo->getWidth(), pFbo->getHeight(), kFormat, 1, 1, nullptr, ResourceBindFlags::ShaderResource);
+    pGraph->setInput("Handle.src", pInput);
+    EXPECT(pGraph->compile(ctx.getRenderContext(), log));
+    pGraph->execute(ctx.getRenderContext());
+    ASSERT_EQ(pPass->getExecuteCount(), 1u);
+
+    EXPECT_EQ(pPass->getSrc().pByHandle, static_cast<const Resource*>(pInput.get()));
+    EXPECT_EQ(pPass->getSrc().pByName, static_cast<const Resource*>(pInput.get()));
+    EXPECT(pPass->getMissing().pByHandle == nullptr);
+    EXPECT(pPass->getMissing().pByName == nullptr);
+
+    // Rebinding the input is visible through the already resolved handle.
+    auto pOtherInput = Texture::create2D(ctx.getDevice().get(), pFbo->getWidth(), pFbo->getHeight(), kFormat, 1, 1, nullptr, ResourceBindFlags::ShaderResource);
+    pGraph->setInput("Handle.src", pOtherInput);
+    pGraph->execute(ctx.getRenderContext());
+    EXPECT_EQ(pPass->getSrc().pByHandle, static_cast<const Resource*>(pOtherInput.get()));
+    EXPECT_EQ(pPass->getSrc().pByName, static_cast<const Resource*>(pOtherInput.get()));
+}
+
+GPU_TEST_NULL(RenderGraphNullDevice)
+{
+    const Fbo* pTargetFbo = ctx.getTargetFbo();
+    ASSERT(pTargetFbo != nullptr);
+
+    std::vector<IncrementPass::SharedPtr> passes;
+    auto pGraph = createIncrementChain(ctx, passes);
+    pGraph->setTransientResourceAliasing(true);
+
+    std::string log;
+    ASSERT(pGraph->compile(ctx.getRenderContext(), log)) << log;
+
+    // The graph is sized from the target FBO and its resources are planned as on a GPU device.
+    auto pOutput = pGraph->getOutput("Increment2.dst");
+    ASSERT(pOutput != nullptr);
+    EXPECT_EQ(pOutput->asTexture()->getWidth(), pTargetFbo->getWidth());
+    EXPECT_EQ(pOutput->asTexture()->getHeight(), pTargetFbo->getHeight());
+
+    // The passes execute and record their work, which is never submitted. Readbacks return zeros.
+    for (uint32_t frame = 0; frame < 2; frame++)
+    {
+        pGraph->execute(ctx.getRenderContext());
+        checkOutput(ctx, pGraph, 0.f);
+    }
+    EXPECT_EQ(passes[0]->getLastInput(), passes[2]->getLastInput());
+    EXPECT_NE(passes[0]->getLastInput(), passes[1]->getLastInput());
+}
+} // namespace Falcor
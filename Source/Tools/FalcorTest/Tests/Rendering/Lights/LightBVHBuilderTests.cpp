@@ -0,0 +1,622 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Lights/LightBVHBuilder.h"
+#include "Utils/Threading.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kTriangleCount = 100000; // Large enough to use parallel subtree builds and parallel binning at the top levels.
+const uint64_t kInvalidBitmask = std::numeric_limits<uint64_t>::max();
+
+// Helpers copied from the serial builder that the parallel builder replaced.
+
+inline float safeACos(float v)
+{
+    return std::acos(glm::clamp(v, -1.0f, 1.0f));
+}
+
+inline float sinFromCos(float cosAngle)
+{
+    return std::sqrt(std::max(0.f, 1.f - cosAngle * cosAngle));
+}
+
+float computeCosConeAngle(const float3& coneDir, const float cosTheta, const float3& otherConeDir, const float cosOtherTheta)
+{
+    float cosResult = kInvalidCosConeAngle;
+    if (cosTheta != kInvalidCosConeAngle && cosOtherTheta != kInvalidCosConeAngle)
+    {
+        const float cosDiffTheta = glm::dot(coneDir, otherConeDir);
+        const float sinDiffTheta = sinFromCos(cosDiffTheta);
+        const float sinOtherTheta = sinFromCos(cosOtherTheta);
+
+        float cosTotalTheta = cosOtherTheta * cosDiffTheta - sinOtherTheta * sinDiffTheta;
+        float sinTotalTheta = sinOtherTheta * cosDiffTheta + cosOtherTheta * sinDiffTheta;
+
+        if (sinTotalTheta > 0.f)
+        {
+            cosResult = std::min(cosTheta, cosTotalTheta);
+        }
+    }
+    return cosResult;
+}
+
+float3 coneUnionOld(float3 aDir, float aCosTheta, float3 bDir, float bCosTheta, float& cosResult)
+{
+    float3 dir = aDir + bDir;
+    if (aCosTheta == kInvalidCosConeAngle || bCosTheta == kInvalidCosConeAngle || dir == float3(0.0f))
+    {
+        cosResult = kInvalidCosConeAngle;
+        return float3(0.0f);
+    }
+
+    dir = glm::normalize(dir);
+
+    const float aDiff = safeACos(glm::dot(dir, aDir));
+    const float bDiff = safeACos(glm::dot(dir, bDir));
+    cosResult = std::cos(std::max(aDiff + std::acos(aCosTheta), bDiff + std::acos(bCosTheta)));
+    return dir;
+}
+
+float aabbVolume(const AABB& bb, float epsilon)
+{
+    if (bb.valid() == false)
+    {
+        return -std::numeric_limits<float>::infinity();
+    }
+    const float3 dims = glm::max(float3(epsilon), bb.extent());
+    return dims.x * dims.y * dims.z;
+}
+
+float evalSAH(const AABB& bounds, const uint32_t triangleCount, const LightBVHBuilder::Options& parameters)
+{
+    float aabbCost = bounds.valid() ? (parameters.useVolumeOverSA ? aabbVolume(bounds, parameters.volumeEpsilon) : bounds.area()) : 0.f;
+    return aabbCost * (float)triangleCount;
+}
+
+float computeOrientationCost(const float theta_o)
+{
+    float theta_w = std::min(theta_o + glm::half_pi<float>(), glm::pi<float>());
+    float sin_theta_o = std::sin(theta_o);
+    float cos_theta_o = std::cos(theta_o);
+    return glm::two_pi<float>() * (1.0f - cos_theta_o) + glm::half_pi<float>() * (2.0f * theta_w * sin_theta_o - std::cos(theta_o - 2.0f * theta_w) - 2.0f * theta_o * sin_theta_o + cos_theta_o);
+}
+
+float evalSAOH(const AABB& bounds, const float flux, const float cosTheta, const LightBVHBuilder::Options& parameters)
+{
+    float fluxCost = parameters.usePreintegration ? flux : 1.0f;
+    float aabbCost = bounds.valid() ? (parameters.useVolumeOverSA ? aabbVolume(bounds, parameters.volumeEpsilon) : bounds.area()) : 0.f;
+    float theta = cosTheta != kInvalidCosConeAngle ? safeACos(cosTheta) : glm::pi<float>();
+    float orientationCost = parameters.useLightingCones ? computeOrientationCost(theta) : 1.0f;
+    return fluxCost * aabbCost * orientationCost;
+}
+
+/** Exposes the builder internals and contains a copy of the serial builder it replaced.
+*/
+class LightBVHBuilderTester : public LightBVHBuilder
+{
+public:
+    using LightBVHBuilder::TriangleSortData;
+
+    struct Result
+    {
+        std::vector<PackedNode> nodes;
+        std::vector<uint32_t> triangleIndices;
+        std::vector<uint64_t> triangleBitmasks;
+    };
+
+    LightBVHBuilderTester(const Options& options) : LightBVHBuilder(options) {}
+
+    Result build(const std::vector<TriangleSortData>& triangles)
+    {
+        BuildingData data;
+        data.trianglesData = triangles;
+        data.triangleBitmasks.resize(triangles.size(), kInvalidBitmask);
+
+        BuildOutput output;
+        buildInternal(mOptions, getSplitFunction(mOptions.splitHeuristicSelection), 0ull, 0, Range(0, (uint32_t)triangles.size()), data, output);
+
+        float cosConeAngle;
+        computeLightingConesInternal(0, output.nodes, cosConeAngle);
+
+        return { std::move(output.nodes), std::move(output.triangleIndices), std::move(data.triangleBitmasks) };
+    }
+
+    Result buildReference(const std::vector<TriangleSortData>& triangles)
+    {
+        ReferenceData data;
+        data.trianglesData = triangles;
+        data.triangleBitmasks.resize(triangles.size(), kInvalidBitmask);
+
+        referenceBuild(mOptions, 0ull, 0, Range(0, (uint32_t)triangles.size()), data);
+
+        float cosConeAngle;
+        referenceComputeLightingCones(0, data, cosConeAngle);
+
+        return { std::move(data.nodes), std::move(data.triangleIndices), std::move(data.triangleBitmasks) };
+    }
+
+private:
+    struct ReferenceData
+    {
+        std::vector<TriangleSortData> trianglesData;
+        std::vector<PackedNode> nodes;
+        std::vector<uint32_t> triangleIndices;
+        std::vector<uint64_t> triangleBitmasks;
+        float currentNodeFlux = 0.f;
+    };
+
+    static uint32_t referenceBuild(const Options& options, uint64_t bitmask, uint32_t depth, const Range& triangleRange, ReferenceData& data)
+    {
+        float nodeFlux = 0.f;
+        AABB nodeBounds;
+        for (uint32_t dataIndex = triangleRange.begin; dataIndex < triangleRange.end; ++dataIndex)
+        {
+            nodeBounds |= data.trianglesData[dataIndex].bounds;
+            nodeFlux += data.trianglesData[dataIndex].flux;
+        }
+
+        data.currentNodeFlux = nodeFlux;
+
+        bool trySplitting = triangleRange.length() > (options.createLeavesASAP ? options.maxTriangleCountPerLeaf : 1);
+        SplitResult splitResult;
+        if (trySplitting)
+        {
+            splitResult = options.splitHeuristicSelection == SplitHeuristic::BinnedSAH
+                ? referenceSplitWithBinnedSAH(data, triangleRange, nodeBounds, options)
+                : referenceSplitWithBinnedSAOH(data, triangleRange, nodeBounds, options);
+        }
+
+        if (splitResult.isValid())
+        {
+            auto comp = [dim = splitResult.axis](const TriangleSortData& d1, const TriangleSortData& d2) { return d1.bounds.center()[dim] < d2.bounds.center()[dim]; };
+            std::nth_element(std::begin(data.trianglesData) + triangleRange.begin, std::begin(data.trianglesData) + splitResult.triangleIndex, std::begin(data.trianglesData) + triangleRange.end, comp);
+
+            const uint32_t nodeIndex = (uint32_t)data.nodes.size();
+            data.nodes.push_back({});
+
+            InternalNode node = {};
+            node.attribs.setAABB(nodeBounds.minPoint, nodeBounds.maxPoint);
+            node.attribs.flux = nodeFlux;
+
+            referenceBuild(options, bitmask | (0ull << depth), depth + 1, Range(triangleRange.begin, splitResult.triangleIndex), data);
+            uint32_t rightIndex = referenceBuild(options, bitmask | (1ull << depth), depth + 1, Range(splitResult.triangleIndex, triangleRange.end), data);
+            node.rightChildIdx = rightIndex;
+
+            data.nodes[nodeIndex].setInternalNode(node);
+            return nodeIndex;
+        }
+        else
+        {
+            const uint32_t nodeIndex = (uint32_t)data.nodes.size();
+            data.nodes.push_back({});
+
+            LeafNode node = {};
+            node.attribs.setAABB(nodeBounds.minPoint, nodeBounds.maxPoint);
+            node.attribs.flux = nodeFlux;
+            float cosTheta;
+            node.attribs.coneDirection = referenceComputeLightingCone(triangleRange, data, cosTheta);
+            node.attribs.cosConeAngle = cosTheta;
+
+            node.triangleCount = triangleRange.length();
+            node.triangleOffset = (uint32_t)data.triangleIndices.size();
+
+            for (uint32_t triangleIdx = triangleRange.begin; triangleIdx < triangleRange.end; ++triangleIdx)
+            {
+                uint32_t globalTriangleIndex = data.trianglesData[triangleIdx].triangleIndex;
+                data.triangleIndices.push_back(globalTriangleIndex);
+                data.triangleBitmasks[globalTriangleIndex] = bitmask;
+            }
+
+            data.nodes[nodeIndex].setLeafNode(node);
+            return nodeIndex;
+        }
+    }
+
+    static float3 referenceComputeLightingCones(const uint32_t nodeIndex, ReferenceData& data, float& cosConeAngle)
+    {
+        if (!data.nodes[nodeIndex].isLeaf())
+        {
+            auto node = data.nodes[nodeIndex].getInternalNode();
+
+            float leftNodeCosConeAngle = kInvalidCosConeAngle;
+            float3 leftNodeConeDirection = referenceComputeLightingCones(nodeIndex + 1, data, leftNodeCosConeAngle);
+            float rightNodeCosConeAngle = kInvalidCosConeAngle;
+            float3 rightNodeConeDirection = referenceComputeLightingCones(node.rightChildIdx, data, rightNodeCosConeAngle);
+
+            float3 coneDirection = coneUnionOld(leftNodeConeDirection, leftNodeCosConeAngle, rightNodeConeDirection, rightNodeCosConeAngle, cosConeAngle);
+
+            node.attribs.cosConeAngle = cosConeAngle;
+            node.attribs.coneDirection = coneDirection;
+            data.nodes[nodeIndex].setNodeAttributes(node.attribs);
+            return coneDirection;
+        }
+        else
+        {
+            auto attribs = data.nodes[nodeIndex].getNodeAttributes();
+            cosConeAngle = attribs.cosConeAngle;
+            return attribs.coneDirection;
+        }
+    }
+
+    static float3 referenceComputeLightingCone(const Range& triangleRange, const ReferenceData& data, float& cosTheta)
+    {
+        float3 coneDirection = float3(0.0f);
+        cosTheta = kInvalidCosConeAngle;
+
+        float3 coneDirectionSum = float3(0.0f);
+        for (uint32_t triangleIdx = triangleRange.begin; triangleIdx < triangleRange.end; ++triangleIdx)
+        {
+            coneDirectionSum += data.trianglesData[triangleIdx].coneDirection;
+        }
+        if (glm::length(coneDirectionSum) >= FLT_MIN)
+        {
+            coneDirection = glm::normalize(coneDirectionSum);
+            cosTheta = 1.f;
+            for (uint32_t triangleIdx = triangleRange.begin; triangleIdx < triangleRange.end; ++triangleIdx)
+            {
+                const TriangleSortData& td = data.trianglesData[triangleIdx];
+                cosTheta = computeCosConeAngle(coneDirection, cosTheta, td.coneDirection, td.cosConeAngle);
+            }
+        }
+        return coneDirection;
+    }
+
+    static SplitResult referenceSplitWithEqual(const Range& triangleRange, const AABB& nodeBounds)
+    {
+        float3 dimensions = nodeBounds.extent();
+        uint32_t dimension = dimensions[2] >= dimensions[0] && dimensions[2] >= dimensions[1] ?
+            2 : (dimensions[1] >= dimensions[0] ? 1 : 0);
+
+        SplitResult result;
+        result.axis = dimension;
+        result.triangleIndex = triangleRange.middle();
+        return result;
+    }
+
+    static SplitResult referenceSplitWithBinnedSAH(const ReferenceData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)
+    {
+        std::pair<float, SplitResult> overallBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
+
+        struct Bin
+        {
+            AABB bounds;
+            uint32_t triangleCount = 0;
+
+            Bin() = default;
+            Bin(const TriangleSortData& tri) : bounds(tri.bounds), triangleCount(1) {}
+            Bin& operator|= (const Bin& rhs)
+            {
+                bounds |= rhs.bounds;
+                triangleCount += rhs.triangleCount;
+                return *this;
+            }
+        };
+
+        std::vector<Bin> bins(parameters.binCount);
+        std::vector<float> costs(parameters.binCount - 1);
+
+        const auto binAlongDimension = [&](uint32_t dimension)
+        {
+            auto getBinId = [&](const TriangleSortData& td)
+            {
+                float bmin = nodeBounds.minPoint[dimension], bmax = nodeBounds.maxPoint[dimension];
+                float scale = (float)parameters.binCount / (bmax - bmin);
+                float p = td.bounds.center()[dimension];
+                return std::min((uint32_t)((p - bmin) * scale), parameters.binCount - 1);
+            };
+
+            for (Bin& bin : bins) bin = Bin();
+
+            for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
+            {
+                const auto& td = data.trianglesData[i];
+                bins[getBinId(td)] |= td;
+            }
+
+            Bin total = Bin();
+            for (std::size_t i = 0; i < costs.size(); ++i)
+            {
+                total |= bins[i];
+                costs[i] = evalSAH(total.bounds, total.triangleCount, parameters);
+            }
+
+            total = Bin();
+            for (std::size_t i = costs.size(); i > 0; --i)
+            {
+                total |= bins[i];
+                costs[i - 1] += evalSAH(total.bounds, total.triangleCount, parameters);
+            }
+
+            std::pair<float, SplitResult> axisBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult{ dimension, 0 });
+            for (uint32_t i = 0, triIdx = triangleRange.begin; i < costs.size(); ++i)
+            {
+                triIdx += bins[i].triangleCount;
+                if (costs[i] < axisBestSplit.first)
+                {
+                    axisBestSplit = std::make_pair(costs[i], SplitResult{ dimension, triIdx });
+                }
+            }
+
+            if (axisBestSplit.second.triangleIndex == triangleRange.begin ||
+                axisBestSplit.second.triangleIndex == triangleRange.end) return;
+
+            if (axisBestSplit.first < overallBestSplit.first) overallBestSplit = axisBestSplit;
+        };
+
+        if (parameters.splitAlongLargest)
+        {
+            float3 dimensions = nodeBounds.extent();
+            uint32_t largestDimension = dimensions[2] >= dimensions[0] && dimensions[2] >= dimensions[1] ?
+                2 : (dimensions[1] >= dimensions[0] && dimensions[1] >= dimensions[2] ? 1 : 0);
+            binAlongDimension(largestDimension);
+        }
+        else
+        {
+            for (uint32_t dimension = 0; dimension < 3; ++dimension) binAlongDimension(dimension);
+        }
+
+        if (!overallBestSplit.second.isValid())
+        {
+            if (triangleRange.length() <= parameters.maxTriangleCountPerLeaf) return SplitResult();
+            return referenceSplitWithEqual(triangleRange, nodeBounds);
+        }
+
+        if (parameters.useLeafCreationCost && triangleRange.length() <= parameters.maxTriangleCountPerLeaf)
+        {
+            float leafCost = evalSAH(nodeBounds, triangleRange.length(), parameters);
+            if (leafCost <= overallBestSplit.first) return SplitResult();
+        }
+
+        return overallBestSplit.second;
+    }
+
+    static SplitResult referenceSplitWithBinnedSAOH(const ReferenceData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)
+    {
+        std::pair<float, SplitResult> overallBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
+
+        float3 dimensions = nodeBounds.extent();
+        uint32_t largestDimension = dimensions[2] >= dimensions[0] && dimensions[2] >= dimensions[1] ?
+            2 : (dimensions[1] >= dimensions[0] && dimensions[1] >= dimensions[2] ? 1 : 0);
+
+        struct Bin
+        {
+            AABB bounds;
+            uint32_t triangleCount = 0;
+            float flux = 0.0f;
+            float3 coneDirection = float3(0.0f);
+            float cosConeAngle = 1.0f;
+
+            Bin() = default;
+            Bin(const TriangleSortData& tri) : bounds(tri.bounds), triangleCount(1), flux(tri.flux), coneDirection(tri.coneDirection), cosConeAngle(tri.cosConeAngle) {}
+            Bin& operator|= (const Bin& rhs)
+            {
+                bounds |= rhs.bounds;
+                triangleCount += rhs.triangleCount;
+                flux += rhs.flux;
+                coneDirection += rhs.coneDirection;
+                return *this;
+            }
+        };
+
+        std::vector<Bin> bins(parameters.binCount);
+        std::vector<float> costs(parameters.binCount - 1);
+
+        const auto binAlongDimension = [&](uint32_t dimension)
+        {
+            auto getBinId = [&](const TriangleSortData& td)
+            {
+                float bmin = nodeBounds.minPoint[dimension], bmax = nodeBounds.maxPoint[dimension];
+                float w = bmax - bmin;
+                float scale = w > FLT_MIN ? (float)parameters.binCount / w : 0.f;
+                float p = td.bounds.center()[dimension];
+                return std::min((uint32_t)((p - bmin) * scale), parameters.binCount - 1);
+            };
+
+            for (Bin& bin : bins) bin = Bin();
+
+            for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
+            {
+                const auto& td = data.trianglesData[i];
+                bins[getBinId(td)] |= td;
+            }
+
+            for (Bin& bin : bins)
+            {
+                bin.cosConeAngle = glm::length(bin.coneDirection) < FLT_MIN ? kInvalidCosConeAngle : 1.0f;
+                bin.coneDirection = glm::normalize(bin.coneDirection);
+            }
+            for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
+            {
+                const auto& td = data.trianglesData[i];
+                Bin& bin = bins[getBinId(td)];
+                bin.cosConeAngle = computeCosConeAngle(bin.coneDirection, bin.cosConeAngle, td.coneDirection, td.cosConeAngle);
+            }
+
+            Bin total = Bin();
+            for (std::size_t i = 0; i < costs.size(); ++i)
+            {
+                total |= bins[i];
+
+                float cosTheta = kInvalidCosConeAngle;
+                if (glm::length(total.coneDirection) >= FLT_MIN)
+                {
+                    cosTheta = 1.f;
+                    float3 coneDir = glm::normalize(total.coneDirection);
+                    for (std::size_t j = 0; j <= i; ++j)
+                    {
+                        cosTheta = computeCosConeAngle(coneDir, cosTheta, bins[j].coneDirection, bins[j].cosConeAngle);
+                    }
+                }
+
+                costs[i] = evalSAOH(total.bounds, total.flux, cosTheta, parameters);
+            }
+
+            total = Bin();
+            for (std::size_t i = costs.size(); i > 0; --i)
+            {
+                total |= bins[i];
+
+                float cosTheta = kInvalidCosConeAngle;
+                if (glm::length(total.coneDirection) >= FLT_MIN)
+                {
+                    cosTheta = 1.f;
+                    float3 coneDir = glm::normalize(total.coneDirection);
+                    for (std::size_t j = i; j <= costs.size(); ++j)
+                    {
+                        cosTheta = computeCosConeAngle(coneDir, cosTheta, bins[j].coneDirection, bins[j].cosConeAngle);
+                    }
+                }
+
+                costs[i - 1] += evalSAOH(total.bounds, total.flux, cosTheta, parameters);
+            }
+
+            std::pair<float, SplitResult> axisBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult{ dimension, 0 });
+            for (uint32_t i = 0, triIdx = triangleRange.begin; i < costs.size(); ++i)
+            {
+                triIdx += bins[i].triangleCount;
+                if (costs[i] < axisBestSplit.first)
+                {
+                    axisBestSplit = std::make_pair(costs[i], SplitResult{ dimension, triIdx });
+                }
+            }
+
+            axisBestSplit.first *= static_cast<float>(dimensions[largestDimension]) / static_cast<float>(dimensions[dimension]);
+
+            if (axisBestSplit.second.triangleIndex == triangleRange.begin ||
+                axisBestSplit.second.triangleIndex == triangleRange.end) return;
+
+            if (axisBestSplit.first < overallBestSplit.first) overallBestSplit = axisBestSplit;
+        };
+
+        if (parameters.splitAlongLargest)
+        {
+            binAlongDimension(largestDimension);
+        }
+        else
+        {
+            for (uint32_t dimension = 0; dimension < 3; ++dimension) binAlongDimension(dimension);
+        }
+
+        if (!overallBestSplit.second.isValid())
+        {
+            if (triangleRange.length() <= parameters.maxTriangleCountPerLeaf) return SplitResult();
+            return referenceSplitWithEqual(triangleRange, nodeBounds);
+        }
+
+        if (parameters.useLeafCreationCost && triangleRange.length() <= parameters.maxTriangleCountPerLeaf)
+        {
+            float cosTheta = kInvalidCosConeAngle;
+            referenceComputeLightingCone(triangleRange, data, cosTheta);
+            float leafCost = evalSAOH(nodeBounds, data.currentNodeFlux, cosTheta, parameters);
+            if (leafCost <= overallBestSplit.first) return SplitResult();
+        }
+
+        return overallBestSplit.second;
+    }
+};
+
+/** Generate a fixed set of emissive triangles, clustered so that the tree is not trivially balanced.
+*/
+std::vector<LightBVHBuilderTester::TriangleSortData> createTriangles()
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+
+    std::vector<float3> clusterCenters(32);
+    for (auto& c : clusterCenters) c = float3(u(rng), u(rng), u(rng)) * 100.f;
+
+    std::vector<LightBVHBuilderTester::TriangleSortData> triangles(kTriangleCount);
+    for (uint32_t i = 0; i < kTriangleCount; ++i)
+    {
+        const float3 center = clusterCenters[i % clusterCenters.size()] + float3(u(rng), u(rng), u(rng)) * 10.f;
+        float3 vtx[3];
+        for (auto& v : vtx) v = center + (float3(u(rng), u(rng), u(rng)) - 0.5f) * 0.2f;
+
+        auto& tri = triangles[i];
+        for (const auto& v : vtx) tri.bounds |= v;
+        tri.center = (vtx[0] + vtx[1] + vtx[2]) / 3.f;
+        float3 n = glm::cross(vtx[1] - vtx[0], vtx[2] - vtx[0]);
+        tri.coneDirection = glm::length(n) > 0.f ? glm::normalize(n) : float3(0.f, 0.f, 1.f);
+        tri.cosConeAngle = 1.f;
+        tri.flux = 0.1f + u(rng);
+        tri.triangleIndex = i;
+    }
+    return triangles;
+}
+
+void testBitIdentical(CPUUnitTestContext& ctx, const LightBVHBuilder::Options& options)
+{
+    // Run the builder with the thread pool running so the parallel code paths are exercised.
+    const bool startThreading = !Threading::isStarted();
+    if (startThreading) Threading::start();
+
+    const auto triangles = createTriangles();
+    LightBVHBuilderTester builder(options);
+    LightBVHBuilderTester::Result result;
+    try
+    {
+        result = builder.build(triangles);
+    }
+    catch (...)
+    {
+        if (startThreading) Threading::shutdown();
+        throw;
+    }
+    if (startThreading) Threading::shutdown();
+
+    const auto reference = builder.buildReference(triangles);
+
+    ASSERT_EQ(result.nodes.size(), reference.nodes.size());
+    EXPECT_EQ(std::memcmp(result.nodes.data(), reference.nodes.data(), result.nodes.size() * sizeof(PackedNode)), 0);
+    EXPECT(result.triangleIndices == reference.triangleIndices);
+    EXPECT(result.triangleBitmasks == reference.triangleBitmasks);
+    EXPECT(std::find(result.triangleBitmasks.begin(), result.triangleBitmasks.end(), kInvalidBitmask) == result.triangleBitmasks.end());
+}
+} // namespace
+
+CPU_TEST(LightBVHBuilderBinnedSAOHBitIdentical)
+{
+    LightBVHBuilder::Options options;
+    options.splitHeuristicSelection = LightBVHBuilder::SplitHeuristic::BinnedSAOH;
+    testBitIdentical(ctx, options);
+}
+
+CPU_TEST(LightBVHBuilderBinnedSAHBitIdentical)
+{
+    LightBVHBuilder::Options options;
+    options.splitHeuristicSelection = LightBVHBuilder::SplitHeuristic::BinnedSAH;
+    testBitIdentical(ctx, options);
+}
+} // namespace Falcor
@@ -44,7 +44,7 @@ const float3 kExpectedResults[] = {
 const float kMaxL2 = 1e-6f;
 } // namespace
 
-GPU_TEST(BSDFIntegrator)
+GPU_TEST_NO_CPU(BSDFIntegrator, "Scene materials are bound through descriptor arrays, which the CPU device does not support.")
 {
     // Create material.
     StandardMaterial::SharedPtr pMaterial = StandardMaterial::create(ctx.getDevice(), "testMaterial");
@@ -223,7 +223,7 @@ void testSampling(GPUUnitTestContext& ctx, const SamplingTestSpec& spec)
     }
 }
 
-GPU_TEST(MicrofacetSampling)
+COMPUTE_TEST(MicrofacetSampling)
 {
     std::vector<NDFConfig> ndfConfigs = {
         {
@@ -274,7 +274,7 @@ GPU_TEST(MicrofacetSampling)
     }
 }
 
-GPU_TEST(MicrofacetSigmaIntegration)
+COMPUTE_TEST(MicrofacetSigmaIntegration)
 {
     // Estimate the ground truth projected area (sigma) integral using Monte Carlo, see
     // "Additional Progress Towards the Unification of Microfacet and Microflake Theories"
@@ -312,7 +312,7 @@ GPU_TEST(MicrofacetSigmaIntegration)
     }
 }
 
-GPU_TEST(MicrofacetSigmaLambdaConsistency)
+COMPUTE_TEST(MicrofacetSigmaLambdaConsistency)
 {
     // Test the consistency of the projected area (sigma) and the Smith
     // Lambda function, see
@@ -362,7 +362,7 @@ GPU_TEST(MicrofacetSigmaLambdaConsistency)
     }
 }
 
-GPU_TEST(MicrofacetLambdaNonsymmetry)
+COMPUTE_TEST(MicrofacetLambdaNonsymmetry)
 {
     // Thest the non-symmetry of the Smith Lambda function, see
     // "Additional Progress Towards the Unification of Microfacet and Microflake Theories"
@@ -402,7 +402,7 @@ GPU_TEST(MicrofacetLambdaNonsymmetry)
     }
 }
 
-GPU_TEST(MicrofacetG1Symmetry)
+COMPUTE_TEST(MicrofacetG1Symmetry)
 {
     // Test the symmetry of the Smith bistatic shadowing function G1.
     for (uint32_t t = 0; t < kNdfs.size(); ++t)
@@ -32,7 +32,7 @@
 
 namespace Falcor
 {
-GPU_TEST(RGLAcquisition)
+GPU_TEST_NO_CPU(RGLAcquisition, "Scene materials are bound through descriptor arrays, which the CPU device does not support.")
 {
     // Create material.
     StandardMaterial::SharedPtr pMaterial = StandardMaterial::create(ctx.getDevice(), "testMaterial");
@@ -142,11 +142,35 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
 }
 } // namespace
 
-GPU_TEST(AliasTable)
+COMPUTE_TEST(AliasTable)
 {
     testAliasTable(ctx, 1, {1.f});
     testAliasTable(ctx, 2, {1.f, 2.f});
     testAliasTable(ctx, 100);
     testAliasTable(ctx, 1000);
 }
+
+GPU_BENCHMARK(AliasTableSample)
+{
+    const uint32_t N = 1 << 16;
+    const uint32_t resultCount = 1 << 20;
+
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> uniform;
+
+    std::vector<float> weights(N);
+    std::generate(weights.begin(), weights.end(), [&uniform, &rng]() { return uniform(rng); });
+    auto aliasTable = AliasTable::create(ctx.getDevice().get(), weights, rng);
+
+    std::vector<float> random(resultCount * 2);
+    std::generate(random.begin(), random.end(), [&uniform, &rng]() { return uniform(rng); });
+
+    ctx.createProgram("Tests/Sampling/AliasTableTests.cs.slang", "testAliasTableSample");
+    ctx.allocateStructuredBuffer("sampleResult", resultCount);
+    ctx.allocateStructuredBuffer("random", resultCount * 2, random.data());
+    aliasTable->setShaderData(ctx["CB"]["aliasTable"]);
+    ctx["CB"]["resultCount"] = resultCount;
+
+    ctx.benchmark([&]() { ctx.runProgram(resultCount); });
+}
 } // namespace Falcor
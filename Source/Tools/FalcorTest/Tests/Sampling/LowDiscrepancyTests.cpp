@@ -31,7 +31,7 @@
 namespace Falcor
 {
 // Just check the first four values.
-GPU_TEST(RadicalInverse)
+COMPUTE_TEST(RadicalInverse)
 {
     ctx.createProgram("Tests/Sampling/LowDiscrepancyTests.cs.slang", "testRadicalInverse");
     ctx.allocateStructuredBuffer("result", 4);
@@ -122,7 +122,7 @@ Buffer::SharedPtr createSeed(Device* pDevice, size_t elements, std::vector<uint3
 
 /** GPU test for Xoshiro pseudorandom number generator.
  */
-GPU_TEST(XoshiroPRNG)
+COMPUTE_TEST(XoshiroPRNG)
 {
     // Create random seed (128 bits per instance).
     std::vector<uint32_t> seed;
@@ -156,7 +156,7 @@ GPU_TEST(XoshiroPRNG)
 
 /** GPU test for SplitMix64 pseudorandom number generator.
  */
-GPU_TEST(SplitMixPRNG)
+COMPUTE_TEST(SplitMixPRNG)
 {
     // Create random seed (64 bits per instance).
     std::vector<uint32_t> seed;
@@ -187,7 +187,7 @@ GPU_TEST(SplitMixPRNG)
 
 /** GPU test for LCG pseudorandom number generator.
  */
-GPU_TEST(LCGPRNG)
+COMPUTE_TEST(LCGPRNG)
 {
     // Create random seed (32 bits per instance).
     std::vector<uint32_t> seed;
@@ -150,12 +150,12 @@ void testSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, const double me
     The values have been tweaked based on observed correlations at these sample counts.
 */
 
-GPU_TEST(SampleGenerator_TinyUniform)
+COMPUTE_TEST(SampleGenerator_TinyUniform)
 {
     testSampleGenerator(ctx, SAMPLE_GENERATOR_TINY_UNIFORM, 0.01, 0.0025, true);
 }
 
-GPU_TEST(SampleGenerator_Uniform)
+COMPUTE_TEST(SampleGenerator_Uniform)
 {
     testSampleGenerator(ctx, SAMPLE_GENERATOR_UNIFORM, 0.01, 0.002, true);
 }
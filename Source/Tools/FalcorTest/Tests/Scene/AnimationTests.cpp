@@ -0,0 +1,89 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Animation/Animation.h"
+
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+CPU_TEST(AnimationKeyframes)
+{
+    auto pAnimation = Animation::create("test", NodeID{ 0 }, 10.0);
+
+    // Add keyframes out of order and replace one.
+    for (double time : { 5.0, 1.0, 9.0, 3.0, 0.0, 7.0 })
+    {
+        Animation::Keyframe keyframe;
+        keyframe.time = time;
+        keyframe.translation = float3((float)time, 0.f, 0.f);
+        pAnimation->addKeyframe(keyframe);
+    }
+    Animation::Keyframe replaced;
+    replaced.time = 3.0;
+    replaced.translation = float3(3.f, 1.f, 0.f);
+    pAnimation->addKeyframe(replaced);
+
+    EXPECT_EQ(pAnimation->getKeyframeCount(), 6);
+    EXPECT(pAnimation->doesKeyframeExists(7.0));
+    EXPECT(!pAnimation->doesKeyframeExists(2.0));
+    EXPECT_EQ(pAnimation->getKeyframe(3.0).translation.y, 1.f);
+    EXPECT_EQ(pAnimation->getKeyframe(9.0).translation.x, 9.f);
+}
+
+CPU_TEST(AnimationScrubbing)
+{
+    std::mt19937 rng;
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    // Keyframes at irregular times with the x translation equal to the time.
+    const double duration = 100.0;
+    auto pAnimation = Animation::create("test", NodeID{ 0 }, duration);
+    double lastTime = 0.0;
+    for (double time = 0.0; time <= duration; time += 0.01 + dist(rng))
+    {
+        Animation::Keyframe keyframe;
+        keyframe.time = time;
+        keyframe.translation = float3((float)time, 0.f, 0.f);
+        pAnimation->addKeyframe(keyframe);
+        lastTime = time;
+    }
+
+    // Linear interpolation must reproduce the time, both when jumping around and when playing forward.
+    auto check = [&](double time)
+    {
+        rmcv::mat4 transform = pAnimation->animate(time);
+        EXPECT_LE(std::abs(transform[0][3] - (float)time), 1e-3f) << "time = " << time;
+    };
+
+    for (int i = 0; i < 1000; ++i) check(dist(rng) * lastTime);
+    for (double time = 0.0; time < lastTime; time += 0.05) check(time);
+    for (double time = lastTime; time > 0.0; time -= 0.05) check(time);
+}
+} // namespace Falcor
@@ -37,7 +37,7 @@ namespace
 const char kEnvMapFile[] = "LightProbes/20050806-03_hd.hdr";
 } // namespace
 
-GPU_TEST(EnvMap)
+GPU_TEST_NO_CPU(EnvMap, "Building the importance map generates mips with blits, which require rasterization.")
 {
     // Test loading a light probe.
     // This call runs setup code on the GPU to precompute the importance map.
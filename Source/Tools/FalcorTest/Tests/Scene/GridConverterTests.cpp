@@ -0,0 +1,335 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Volume/GridConverter.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4146 4244 4267 4275 4996)
+#endif
+// See Grid.cpp for why this is needed.
+#define result_of invoke_result
+#include <nanovdb/util/GridBuilder.h>
+#undef result_of
+#include <nanovdb/util/Primitives.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+uint8_t decodeBC4Texel(uint64_t block, int i)
+{
+    int alpha0 = int(block & 0xff);
+    int alpha1 = int((block >> 8) & 0xff);
+    int index = int((block >> (16 + 3 * i)) & 7);
+    if (index == 0)
+        return uint8_t(alpha0);
+    if (index == 1)
+        return uint8_t(alpha1);
+    if (alpha0 > alpha1)
+        return uint8_t(((8 - index) * alpha0 + (index - 1) * alpha1) / 7);
+    if (index == 6)
+        return 0;
+    if (index == 7)
+        return 255;
+    return uint8_t(((6 - index) * alpha0 + (index - 1) * alpha1) / 5);
+}
+
+/** Reference BC4 encoder, libsquish's CompressAlphaDxt5() (alpha.cpp, Copyright (c) 2006 Simon Brown, MIT license).
+    This is the encoder GridConverter used before encodeBC4Block(), kept in its original branching form.
+*/
+namespace squish
+{
+void fixRange(int& min, int& max, int steps)
+{
+    if (max - min < steps)
+        max = std::min(min + steps, 255);
+    if (max - min < steps)
+        min = std::max(0, max - steps);
+}
+
+int fitCodes(const uint8_t* tile, const uint8_t* codes, uint8_t* indices)
+{
+    int err = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int value = (int)tile[i];
+        int least = INT_MAX;
+        int index = 0;
+        for (int j = 0; j < 8; ++j)
+        {
+            int dist = value - (int)codes[j];
+            dist *= dist;
+            if (dist < least)
+            {
+                least = dist;
+                index = j;
+            }
+        }
+        indices[i] = (uint8_t)index;
+        err += least;
+    }
+    return err;
+}
+
+void writeAlphaBlock(int alpha0, int alpha1, const uint8_t* indices, uint8_t* bytes)
+{
+    bytes[0] = (uint8_t)alpha0;
+    bytes[1] = (uint8_t)alpha1;
+    uint8_t* dest = bytes + 2;
+    const uint8_t* src = indices;
+    for (int i = 0; i < 2; ++i)
+    {
+        int value = 0;
+        for (int j = 0; j < 8; ++j)
+            value |= (*src++ << 3 * j);
+        for (int j = 0; j < 3; ++j)
+            *dest++ = (uint8_t)((value >> 8 * j) & 0xff);
+    }
+}
+
+void writeAlphaBlock5(int alpha0, int alpha1, const uint8_t* indices, uint8_t* bytes)
+{
+    if (alpha0 > alpha1)
+    {
+        uint8_t swapped[16];
+        for (int i = 0; i < 16; ++i)
+        {
+            uint8_t index = indices[i];
+            if (index == 0)
+                swapped[i] = 1;
+            else if (index == 1)
+                swapped[i] = 0;
+            else if (index <= 5)
+                swapped[i] = 7 - index;
+            else
+                swapped[i] = index;
+        }
+        writeAlphaBlock(alpha1, alpha0, swapped, bytes);
+    }
+    else
+    {
+        writeAlphaBlock(alpha0, alpha1, indices, bytes);
+    }
+}
+
+void writeAlphaBlock7(int alpha0, int alpha1, const uint8_t* indices, uint8_t* bytes)
+{
+    if (alpha0 < alpha1)
+    {
+        uint8_t swapped[16];
+        for (int i = 0; i < 16; ++i)
+        {
+            uint8_t index = indices[i];
+            if (index == 0)
+                swapped[i] = 1;
+            else if (index == 1)
+                swapped[i] = 0;
+            else
+                swapped[i] = 9 - index;
+        }
+        writeAlphaBlock(alpha1, alpha0, swapped, bytes);
+    }
+    else
+    {
+        writeAlphaBlock(alpha0, alpha1, indices, bytes);
+    }
+}
+
+uint64_t compressAlphaDxt5(const uint8_t* tile)
+{
+    int min5 = 255;
+    int max5 = 0;
+    int min7 = 255;
+    int max7 = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int value = (int)tile[i];
+        if (value < min7)
+            min7 = value;
+        if (value > max7)
+            max7 = value;
+        if (value != 0 && value < min5)
+            min5 = value;
+        if (value != 255 && value > max5)
+            max5 = value;
+    }
+
+    if (min5 > max5)
+        min5 = max5;
+    if (min7 > max7)
+        min7 = max7;
+
+    fixRange(min5, max5, 5);
+    fixRange(min7, max7, 7);
+
+    uint8_t codes5[8];
+    codes5[0] = (uint8_t)min5;
+    codes5[1] = (uint8_t)max5;
+    for (int i = 1; i < 5; ++i)
+        codes5[1 + i] = (uint8_t)(((5 - i) * min5 + i * max5) / 5);
+    codes5[6] = 0;
+    codes5[7] = 255;
+
+    uint8_t codes7[8];
+    codes7[0] = (uint8_t)min7;
+    codes7[1] = (uint8_t)max7;
+    for (int i = 1; i < 7; ++i)
+        codes7[1 + i] = (uint8_t)(((7 - i) * min7 + i * max7) / 7);
+
+    uint8_t indices5[16];
+    uint8_t indices7[16];
+    int err5 = fitCodes(tile, codes5, indices5);
+    int err7 = fitCodes(tile, codes7, indices7);
+
+    uint8_t bytes[8];
+    if (err5 <= err7)
+        writeAlphaBlock5(min5, max5, indices5, bytes);
+    else
+        writeAlphaBlock7(min7, max7, indices7, bytes);
+
+    // BC4 blocks are stored little-endian.
+    uint64_t block = 0;
+    for (int i = 0; i < 8; ++i)
+        block |= (uint64_t)bytes[i] << (8 * i);
+    return block;
+}
+} // namespace squish
+} // namespace
+
+CPU_TEST(BC4Encode)
+{
+    std::mt19937 rng;
+    for (int t = 0; t < 1000; ++t)
+    {
+        // Alternate between smooth tiles and random tiles.
+        uint8_t tile[16];
+        int base = rng() % 256;
+        for (int i = 0; i < 16; ++i)
+            tile[i] = t % 2 ? uint8_t(rng() % 256) : uint8_t(std::clamp(base + int(rng() % 16) - 8, 0, 255));
+
+        uint64_t block = encodeBC4Block(tile);
+        int maxError = 0;
+        for (int i = 0; i < 16; ++i)
+            maxError = std::max(maxError, std::abs(int(decodeBC4Texel(block, i)) - int(tile[i])));
+        EXPECT_LE(maxError, t % 2 ? 40 : 2) << "t = " << t;
+    }
+
+    // Constant tiles are encoded exactly.
+    uint8_t tile[16];
+    std::fill(std::begin(tile), std::end(tile), uint8_t(77));
+    uint64_t block = encodeBC4Block(tile);
+    for (int i = 0; i < 16; ++i)
+        EXPECT_EQ(decodeBC4Texel(block, i), 77);
+}
+
+CPU_TEST(BC4EncodeMatchesReference)
+{
+    // encodeBC4Block() must produce the same blocks as the libsquish encoder it replaces.
+    std::mt19937 rng;
+    for (int t = 0; t < 100000; ++t)
+    {
+        // Cycle through random, smooth, saturated and two-valued tiles, which exercise both code books and the end point swaps.
+        uint8_t tile[16];
+        int base = rng() % 256;
+        for (int i = 0; i < 16; ++i)
+        {
+            switch (t % 4)
+            {
+            case 0:
+                tile[i] = uint8_t(rng() % 256);
+                break;
+            case 1:
+                tile[i] = uint8_t(std::clamp(base + int(rng() % 16) - 8, 0, 255));
+                break;
+            case 2:
+            {
+                int r = rng() % 4;
+                tile[i] = r == 0 ? 0 : r == 1 ? 255 : uint8_t(rng() % 256);
+                break;
+            }
+            default:
+                tile[i] = rng() % 2 ? uint8_t(base) : rng() % 3 == 0 ? 0 : 255;
+                break;
+            }
+        }
+
+        uint64_t block = encodeBC4Block(tile);
+        uint64_t reference = squish::compressAlphaDxt5(tile);
+        EXPECT_EQ(block, reference) << "t = " << t;
+        if (block != reference)
+            break;
+    }
+}
+
+CPU_TEST(GridConverterDeterministic)
+{
+    auto handle = nanovdb::createFogVolumeSphere<float>(20.f, nanovdb::Vec3f(0.f), 0.5f, 4.f);
+    const nanovdb::FloatGrid* pGrid = handle.grid<float>();
+    ASSERT(pGrid != nullptr);
+
+    BrickedGridData a = NanoVDBConverterBC4(pGrid).convertToData();
+    BrickedGridData b = NanoVDBConverterBC4(pGrid).convertToData();
+
+    EXPECT_GT(a.brickCount, 0u);
+    EXPECT_EQ(a.brickCount, b.brickCount);
+    EXPECT(a.range == b.range);
+    EXPECT(a.indirection == b.indirection);
+    EXPECT(a.atlas == b.atlas);
+
+    // Round trip through a brick cache file.
+    const std::filesystem::path path = std::filesystem::absolute("test_grid_converter.bricks");
+    const SHA1::MD key = SHA1::compute(handle.data(), handle.size());
+    ASSERT(a.write(path, key));
+
+    auto c = BrickedGridData::read(path, key);
+    ASSERT(c.has_value());
+    EXPECT(c->leafDim == a.leafDim);
+    EXPECT(c->atlasSize == a.atlasSize);
+    EXPECT(c->atlasFormat == a.atlasFormat);
+    EXPECT_EQ(c->brickCount, a.brickCount);
+    EXPECT(c->range == a.range);
+    EXPECT(c->indirection == a.indirection);
+    EXPECT(c->atlas == a.atlas);
+
+    // A different key invalidates the cache.
+    SHA1::MD otherKey = key;
+    otherKey[0] ^= 1;
+    EXPECT(!BrickedGridData::read(path, otherKey).has_value());
+
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
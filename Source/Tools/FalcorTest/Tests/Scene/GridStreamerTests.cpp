@@ -0,0 +1,163 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Volume/GridStreamer.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4146 4244 4267 4275 4996)
+#endif
+// See Grid.cpp for why this is needed.
+#define result_of invoke_result
+#include <nanovdb/util/GridBuilder.h>
+#undef result_of
+#include <nanovdb/util/Primitives.h>
+#include <nanovdb/util/IO.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <filesystem>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kFrameCount = 8;
+
+std::vector<std::filesystem::path> writeSequence(const std::filesystem::path& dir, std::string& gridname)
+{
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    std::vector<std::filesystem::path> paths;
+    for (uint32_t i = 0; i < kFrameCount; ++i)
+    {
+        auto handle = nanovdb::createFogVolumeSphere<float>(4.f + i, nanovdb::Vec3f(0.f), 0.5f, 2.f);
+        gridname = handle.gridMetaData()->shortGridName();
+        auto path = dir / ("frame" + std::to_string(i) + ".nvdb");
+        nanovdb::io::writeGrid(path.string(), handle);
+        paths.push_back(path);
+    }
+    return paths;
+}
+} // namespace
+
+GPU_TEST(GridStreamerPrefetch)
+{
+    const std::filesystem::path dir = std::filesystem::absolute("test_grid_streamer_prefetch");
+    std::string gridname;
+    auto paths = writeSequence(dir, gridname);
+
+    GridStreamer::Options options;
+    options.framesAhead = 2;
+    options.framesBehind = 1;
+    options.threadCount = 2;
+    auto pStreamer = GridStreamer::create(ctx.getDevice(), paths, gridname, options);
+    EXPECT_EQ(pStreamer->getFrameCount(), kFrameCount);
+
+    // Only the first request misses, all following frames are prefetched.
+    for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+    {
+        auto pGrid = pStreamer->getGrid(frame);
+        auto pReference = Grid::createFromFile(ctx.getDevice(), paths[frame], gridname);
+        EXPECT(pGrid != nullptr);
+        EXPECT(pReference != nullptr);
+        if (pGrid && pReference) EXPECT_EQ(pGrid->getVoxelCount(), pReference->getVoxelCount()) << "frame = " << frame;
+        pStreamer->waitForPrefetch();
+    }
+
+    auto stats = pStreamer->getStats();
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.hits, kFrameCount - 1);
+    EXPECT_EQ(stats.prefetches, kFrameCount - 1);
+    EXPECT_EQ(stats.failures, 0);
+    EXPECT_EQ(stats.evictions, 0);
+    EXPECT_EQ(stats.loadedFrameCount, kFrameCount);
+
+    pStreamer.reset();
+    std::filesystem::remove_all(dir);
+}
+
+GPU_TEST(GridStreamerLoadFailure)
+{
+    const std::filesystem::path dir = std::filesystem::absolute("test_grid_streamer_failure");
+    std::string gridname;
+    auto paths = writeSequence(dir, gridname);
+    std::filesystem::remove(paths[2]);
+
+    GridStreamer::Options options;
+    options.framesAhead = 2;
+    options.framesBehind = 0;
+    options.threadCount = 1;
+    auto pStreamer = GridStreamer::create(ctx.getDevice(), paths, gridname, options);
+
+    // Frames 1 and 2 are prefetched, but only frame 1 loads.
+    EXPECT(pStreamer->getGrid(0) != nullptr);
+    pStreamer->waitForPrefetch();
+    auto stats = pStreamer->getStats();
+    EXPECT_EQ(stats.prefetches, 1);
+    EXPECT_EQ(stats.failures, 1);
+
+    EXPECT(pStreamer->getGrid(2) == nullptr);
+
+    pStreamer.reset();
+    std::filesystem::remove_all(dir);
+}
+
+GPU_TEST(GridStreamerMemoryBudget)
+{
+    const std::filesystem::path dir = std::filesystem::absolute("test_grid_streamer_budget");
+    std::string gridname;
+    auto paths = writeSequence(dir, gridname);
+
+    // With a budget smaller than a frame only the requested frame is kept.
+    GridStreamer::Options options;
+    options.memoryBudget = 1;
+    options.threadCount = 0;
+    auto pStreamer = GridStreamer::create(ctx.getDevice(), paths, gridname, options);
+
+    for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+    {
+        EXPECT(pStreamer->getGrid(frame) != nullptr);
+        EXPECT_EQ(pStreamer->getStats().loadedFrameCount, 1);
+    }
+    EXPECT(pStreamer->getGrid(kFrameCount - 1) != nullptr);
+    EXPECT(pStreamer->getGrid(0) != nullptr);
+
+    auto stats = pStreamer->getStats();
+    EXPECT_EQ(stats.misses, kFrameCount + 1);
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.prefetches, 0);
+    EXPECT_EQ(stats.failures, 0);
+    EXPECT_EQ(stats.evictions, kFrameCount);
+
+    pStreamer.reset();
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
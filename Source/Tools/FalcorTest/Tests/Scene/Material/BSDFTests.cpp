@@ -316,7 +316,7 @@ void testSampling(GPUUnitTestContext& ctx, const SamplingTestSpec& spec)
 
 /// The OLD, pre-refactor BSDFs (from BxDF.slang), to be deleted
 
-GPU_TEST(TestBsdf_DiffuseReflectionLambert)
+COMPUTE_TEST(TestBsdf_DiffuseReflectionLambert)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -334,7 +334,7 @@ GPU_TEST(TestBsdf_DiffuseReflectionLambert)
     );
 }
 
-GPU_TEST(TestBsdf_DiffuseReflectionDisney)
+COMPUTE_TEST(TestBsdf_DiffuseReflectionDisney)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -352,7 +352,7 @@ GPU_TEST(TestBsdf_DiffuseReflectionDisney)
     );
 }
 
-GPU_TEST(TestBsdf_DiffuseReflectionFrostbite)
+COMPUTE_TEST(TestBsdf_DiffuseReflectionFrostbite)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -370,7 +370,7 @@ GPU_TEST(TestBsdf_DiffuseReflectionFrostbite)
     );
 }
 
-GPU_TEST(TestBsdf_DiffuseTransmissionLambert)
+COMPUTE_TEST(TestBsdf_DiffuseTransmissionLambert)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -388,7 +388,7 @@ GPU_TEST(TestBsdf_DiffuseTransmissionLambert)
     );
 }
 
-GPU_TEST(TestBsdf_SpecularReflectionMicrofacet)
+COMPUTE_TEST(TestBsdf_SpecularReflectionMicrofacet)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -409,7 +409,7 @@ GPU_TEST(TestBsdf_SpecularReflectionMicrofacet)
     );
 }
 
-GPU_TEST(TestBsdf_SpecularReflectionTransmissionMicrofacet, "Disabled, not passing")
+COMPUTE_TEST(TestBsdf_SpecularReflectionTransmissionMicrofacet, "Disabled, not passing")
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -438,7 +438,7 @@ GPU_TEST(TestBsdf_SpecularReflectionTransmissionMicrofacet, "Disabled, not passi
 
 /// The NEW, post-refactor BSDFs
 
-GPU_TEST(TestBsdf_DisneyDiffuseBRDF)
+COMPUTE_TEST(TestBsdf_DisneyDiffuseBRDF)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -456,7 +456,7 @@ GPU_TEST(TestBsdf_DisneyDiffuseBRDF)
     );
 }
 
-GPU_TEST(TestBsdf_FrostbiteDiffuseBRDF)
+COMPUTE_TEST(TestBsdf_FrostbiteDiffuseBRDF)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -474,7 +474,7 @@ GPU_TEST(TestBsdf_FrostbiteDiffuseBRDF)
     );
 }
 
-GPU_TEST(TestBsdf_LambertDiffuseBRDF)
+COMPUTE_TEST(TestBsdf_LambertDiffuseBRDF)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -492,7 +492,7 @@ GPU_TEST(TestBsdf_LambertDiffuseBRDF)
     );
 }
 
-GPU_TEST(TestBsdf_LambertDiffuseBTDF)
+COMPUTE_TEST(TestBsdf_LambertDiffuseBTDF)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -510,7 +510,7 @@ GPU_TEST(TestBsdf_LambertDiffuseBTDF)
     );
 }
 
-GPU_TEST(TestBsdf_OrenNayarBRDF)
+COMPUTE_TEST(TestBsdf_OrenNayarBRDF)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -528,7 +528,7 @@ GPU_TEST(TestBsdf_OrenNayarBRDF)
     );
 }
 
-GPU_TEST(TestBsdf_SimpleBTDF, "Disabled, sampling test makes no sense for diract BSDF")
+COMPUTE_TEST(TestBsdf_SimpleBTDF, "Disabled, sampling test makes no sense for diract BSDF")
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -546,7 +546,7 @@ GPU_TEST(TestBsdf_SimpleBTDF, "Disabled, sampling test makes no sense for diract
     );
 }
 
-GPU_TEST(TestBsdf_SpecularMicrofacetBRDF)
+COMPUTE_TEST(TestBsdf_SpecularMicrofacetBRDF)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -567,7 +567,7 @@ GPU_TEST(TestBsdf_SpecularMicrofacetBRDF)
     );
 }
 
-GPU_TEST(TestBsdf_SpecularMicrofacetBTDF, "Disabled, not passing")
+COMPUTE_TEST(TestBsdf_SpecularMicrofacetBTDF, "Disabled, not passing")
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -594,7 +594,7 @@ GPU_TEST(TestBsdf_SpecularMicrofacetBTDF, "Disabled, not passing")
     );
 }
 
-GPU_TEST(TestBsdf_SheenBSDF)
+COMPUTE_TEST(TestBsdf_SheenBSDF)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
@@ -612,7 +612,7 @@ GPU_TEST(TestBsdf_SheenBSDF)
     );
 }
 
-GPU_TEST(TestBsdf_DiffuseSpecularBRDF)
+COMPUTE_TEST(TestBsdf_DiffuseSpecularBRDF)
 {
     const float3 perp = normalize(float3(0.f, 0.f, 1.f));
     const float3 oblique = normalize(float3(0.5f, 0.f, 0.5f));
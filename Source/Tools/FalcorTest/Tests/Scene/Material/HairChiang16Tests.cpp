@@ -76,7 +76,7 @@ void testWhiteFurnace(GPUUnitTestContext& ctx, const std::string& funcName, cons
 }
 } // namespace
 
-GPU_TEST(HairChiang16_PbrtReference)
+COMPUTE_TEST(HairChiang16_PbrtReference)
 {
     uint32_t testCount = 50000;
 
@@ -139,17 +139,17 @@ GPU_TEST(HairChiang16_PbrtReference)
     ctx.unmapBuffer("gResultOurs");
 }
 
-GPU_TEST(HairChiang16_WhiteFurnaceUniform)
+COMPUTE_TEST(HairChiang16_WhiteFurnaceUniform)
 {
     testWhiteFurnace(ctx, "testWhiteFurnaceUniform", 0.05f);
 }
 
-GPU_TEST(HairChiang16_WhiteFurnaceImportanceSampling)
+COMPUTE_TEST(HairChiang16_WhiteFurnaceImportanceSampling)
 {
     testWhiteFurnace(ctx, "testWhiteFurnaceImportanceSampling", 0.01f);
 }
 
-GPU_TEST(HairChiang16_ImportanceSamplingWeights)
+COMPUTE_TEST(HairChiang16_ImportanceSamplingWeights)
 {
     uint32_t sampleCount = 10000;
     uint32_t testCount = 0;
@@ -199,7 +199,7 @@ GPU_TEST(HairChiang16_ImportanceSamplingWeights)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(HairChiang16_SamplingConsistency)
+COMPUTE_TEST(HairChiang16_SamplingConsistency)
 {
     uint32_t sampleCount = 300000;
     uint32_t testCount = 0;
@@ -0,0 +1,122 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Material/MaterialSystem.h"
+#include "Scene/Material/StandardMaterial.h"
+
+#include <limits>
+
+namespace Falcor
+{
+GPU_TEST(MaterialSystemRemoveDuplicates)
+{
+    auto pMaterialSystem = MaterialSystem::create(ctx.getDevice());
+
+    auto createMaterial = [&](const std::string& name, float4 baseColor, float roughness)
+    {
+        auto pMaterial = StandardMaterial::create(ctx.getDevice(), name);
+        pMaterial->setBaseColor(baseColor);
+        pMaterial->setRoughness(roughness);
+        return pMaterial;
+    };
+
+    std::vector<Material::SharedPtr> materials =
+    {
+        createMaterial("A", float4(1.f, 0.f, 0.f, 1.f), 0.5f),
+        createMaterial("B", float4(0.f, 1.f, 0.f, 1.f), 0.5f),
+        createMaterial("A2", float4(1.f, 0.f, 0.f, 1.f), 0.5f),
+        createMaterial("C", float4(1.f, 0.f, 0.f, 1.f), 0.25f),
+        createMaterial("B2", float4(0.f, 1.f, 0.f, 1.f), 0.5f),
+    };
+
+    for (const auto& pMaterial : materials) pMaterialSystem->addMaterial(pMaterial);
+
+    // Equal materials must hash equal.
+    EXPECT_EQ(materials[0]->getHash(), materials[2]->getHash());
+    EXPECT_EQ(materials[1]->getHash(), materials[4]->getHash());
+    EXPECT(materials[0]->isEqual(materials[2]));
+    EXPECT(!materials[0]->isEqual(materials[3]));
+
+    std::vector<MaterialID> idMap;
+    size_t removed = pMaterialSystem->removeDuplicateMaterials(idMap);
+    EXPECT_EQ(removed, (size_t)2);
+    EXPECT_EQ(pMaterialSystem->getMaterialCount(), 3u);
+
+    ASSERT_EQ(idMap.size(), materials.size());
+    EXPECT_EQ(idMap[0].get(), 0u);
+    EXPECT_EQ(idMap[1].get(), 1u);
+    EXPECT_EQ(idMap[2].get(), 0u);
+    EXPECT_EQ(idMap[3].get(), 2u);
+    EXPECT_EQ(idMap[4].get(), 1u);
+}
+
+CPU_TEST(SamplerDescHash)
+{
+    // Descs that compare equal must hash equal, including for floats that only differ in the sign of zero.
+    Sampler::Desc a;
+    a.setLodParams(0.f, 0.f, 0.f).setBorderColor(float4(0.f));
+    Sampler::Desc b;
+    b.setLodParams(-0.f, -0.f, -0.f).setBorderColor(float4(-0.f));
+    EXPECT(a == b);
+    EXPECT_EQ(a.getHash(), b.getHash());
+
+    // NaNs hash the same regardless of payload.
+    Sampler::Desc c = a;
+    c.lodBias = std::numeric_limits<float>::quiet_NaN();
+    Sampler::Desc d = a;
+    d.lodBias = -std::numeric_limits<float>::signaling_NaN();
+    EXPECT_EQ(c.getHash(), d.getHash());
+
+    b.setLodParams(0.f, 0.f, 1.f);
+    EXPECT_NE(a.getHash(), b.getHash());
+}
+
+GPU_TEST(MaterialSystemSamplerDedup)
+{
+    auto pMaterialSystem = MaterialSystem::create(ctx.getDevice());
+    uint32_t baseCount = pMaterialSystem->getTextureSamplerCount();
+
+    Sampler::Desc linear;
+    linear.setFilterMode(Sampler::Filter::Linear, Sampler::Filter::Linear, Sampler::Filter::Linear);
+    Sampler::Desc point;
+    point.setFilterMode(Sampler::Filter::Point, Sampler::Filter::Point, Sampler::Filter::Point);
+    point.setAddressingMode(Sampler::AddressMode::Clamp, Sampler::AddressMode::Clamp, Sampler::AddressMode::Clamp);
+
+    EXPECT_EQ(linear.getHash(), Sampler::Desc(linear).getHash());
+    EXPECT_NE(linear.getHash(), point.getHash());
+
+    uint32_t idLinear = pMaterialSystem->addTextureSampler(Sampler::create(ctx.getDevice().get(), linear));
+    uint32_t idPoint = pMaterialSystem->addTextureSampler(Sampler::create(ctx.getDevice().get(), point));
+    EXPECT_NE(idLinear, idPoint);
+
+    // Adding samplers with identical descs returns the existing IDs.
+    EXPECT_EQ(pMaterialSystem->addTextureSampler(Sampler::create(ctx.getDevice().get(), linear)), idLinear);
+    EXPECT_EQ(pMaterialSystem->addTextureSampler(Sampler::create(ctx.getDevice().get(), point)), idPoint);
+    EXPECT_LE(pMaterialSystem->getTextureSamplerCount(), baseCount + 2);
+}
+}
@@ -0,0 +1,76 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Utils/Color/SampledSpectrum.h"
+
+namespace Falcor
+{
+namespace
+{
+SampledSpectrum<float> createSpectrum(std::function<float(float)> func)
+{
+    const size_t sampleCount = 128;
+    std::vector<float> values(sampleCount);
+    for (size_t i = 0; i < sampleCount; ++i)
+        values[i] = func(i / float(sampleCount - 1));
+    return SampledSpectrum<float>(400.f, 700.f, values);
+}
+} // namespace
+
+GPU_TEST(SpectralProfileDedup)
+{
+    auto pBuilder = SceneBuilder::create(ctx.getDevice(), Settings());
+
+    auto ramp = createSpectrum([](float x) { return 1.f + x; });
+    auto wave = createSpectrum([](float x) { return 1.f + std::sin(4.f * x); });
+
+    // Identical spectra share a profile.
+    auto rampID = pBuilder->addSpectralProfile(ramp, false);
+    auto waveID = pBuilder->addSpectralProfile(wave, false);
+    EXPECT_NE(rampID, waveID);
+    EXPECT_EQ(pBuilder->addSpectralProfile(ramp, false), rampID);
+    EXPECT_EQ(pBuilder->addSpectralProfile(wave, false), waveID);
+
+    // The same spectrum with an inverse CDF is a different profile.
+    auto rampICdfID = pBuilder->addSpectralProfile(ramp, true);
+    EXPECT_NE(rampICdfID, rampID);
+    EXPECT_EQ(pBuilder->addSpectralProfile(ramp, true), rampICdfID);
+
+    // Smooth spectra without inverse CDF use fewer bins, importance sampled profiles keep all bins.
+    const auto& rampProfile = pBuilder->getSpectralProfile(rampID);
+    const auto& waveProfile = pBuilder->getSpectralProfile(waveID);
+    const auto& rampICdfProfile = pBuilder->getSpectralProfile(rampICdfID);
+    EXPECT_EQ(rampProfile.bins, 2u);
+    EXPECT_GT(waveProfile.bins, rampProfile.bins);
+    EXPECT_LT(waveProfile.bins, 128u);
+    EXPECT_EQ(rampICdfProfile.bins, 128u);
+    EXPECT_EQ(rampProfile.icdfOffset, SpectralProfile::kNoICdf);
+    EXPECT_NE(rampICdfProfile.icdfOffset, SpectralProfile::kNoICdf);
+}
+} // namespace Falcor
@@ -0,0 +1,186 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Animation/AnimatedVertexCache.h"
+#include "Scene/Animation/VertexCacheStore.h"
+#include <cstring>
+#include <filesystem>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kKeyframeCount = 6;
+const uint32_t kVertexCount = 1000;
+
+CachedMesh createCachedMesh()
+{
+    CachedMesh cache;
+    for (uint32_t i = 0; i < kKeyframeCount; ++i)
+    {
+        cache.timeSamples.push_back(1.0 + i);
+        std::vector<PackedStaticVertexData> vertices(kVertexCount);
+        for (uint32_t j = 0; j < kVertexCount; ++j)
+        {
+            vertices[j].position = float3((float)i, (float)j, 0.f);
+            vertices[j].packedNormalTangentCurveRadius = float3(0.f, 1.f, 0.f);
+            vertices[j].texCrd = float2(0.f);
+        }
+        cache.vertexData.push_back(std::move(vertices));
+    }
+    return cache;
+}
+
+CachedCurve createCachedCurve()
+{
+    CachedCurve cache;
+    for (uint32_t i = 0; i < kKeyframeCount; ++i)
+    {
+        cache.timeSamples.push_back(1.0 + i);
+        std::vector<DynamicCurveVertexData> vertices(kVertexCount);
+        for (uint32_t j = 0; j < kVertexCount; ++j) vertices[j].position = float3((float)j, (float)i, 1.f);
+        cache.vertexData.push_back(std::move(vertices));
+    }
+    return cache;
+}
+
+void testRoundTrip(CPUUnitTestContext& ctx, bool compress)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_vertex_cache_store.bin");
+
+    CachedMesh mesh = createCachedMesh();
+    CachedCurve curve = createCachedCurve();
+    const CachedMesh refMesh = mesh;
+    const CachedCurve refCurve = curve;
+
+    auto pWriter = VertexCacheStore::Writer::create(path, compress);
+    pWriter->addCachedMesh(mesh);
+    pWriter->addCachedCurve(curve);
+    auto pStore = pWriter->finalize(true);
+
+    // Keyframes are moved out of host memory.
+    EXPECT(mesh.vertexData.empty());
+    EXPECT(curve.vertexData.empty());
+    EXPECT_EQ(mesh.vertexCount, kVertexCount);
+    EXPECT_EQ(curve.vertexCount, kVertexCount);
+    EXPECT_EQ(mesh.firstChunk, 0u);
+    EXPECT_EQ(curve.firstChunk, kKeyframeCount);
+
+    EXPECT_EQ(pStore->getChunkCount(), 2 * kKeyframeCount);
+    EXPECT_EQ(pStore->isCompressed(), compress);
+    EXPECT_EQ(pStore->getSizeInBytes(), std::filesystem::file_size(path));
+    const uint64_t rawSize = kKeyframeCount * kVertexCount * (sizeof(PackedStaticVertexData) + sizeof(DynamicCurveVertexData));
+    if (compress) EXPECT_LT(pStore->getSizeInBytes(), rawSize);
+    else EXPECT_GT(pStore->getSizeInBytes(), rawSize);
+
+    for (uint32_t i = 0; i < kKeyframeCount; ++i)
+    {
+        auto pMeshData = pStore->getChunk(mesh.firstChunk + i);
+        EXPECT_EQ(pMeshData->size(), kVertexCount * sizeof(PackedStaticVertexData));
+        EXPECT(std::memcmp(pMeshData->data(), refMesh.vertexData[i].data(), pMeshData->size()) == 0) << "keyframe " << i;
+
+        auto pCurveData = pStore->getChunk(curve.firstChunk + i);
+        EXPECT_EQ(pCurveData->size(), kVertexCount * sizeof(DynamicCurveVertexData));
+        EXPECT(std::memcmp(pCurveData->data(), refCurve.vertexData[i].data(), pCurveData->size()) == 0) << "keyframe " << i;
+    }
+
+    // Chunks outside of the prefetch window are not kept loaded.
+    EXPECT_EQ(pStore->getStats().loadedChunkCount, 0u);
+
+    pStore.reset();
+    EXPECT(!std::filesystem::exists(path));
+}
+} // namespace
+
+CPU_TEST(VertexCacheStoreRoundTrip)
+{
+    testRoundTrip(ctx, true);
+    testRoundTrip(ctx, false);
+}
+
+CPU_TEST(VertexCacheStoreWriterCleanup)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_vertex_cache_store_cleanup.bin");
+
+    // A writer that is destroyed before it is finalized, e.g. because the scene build failed, deletes its file.
+    {
+        CachedMesh mesh = createCachedMesh();
+        auto pWriter = VertexCacheStore::Writer::create(path, true);
+        pWriter->addCachedMesh(mesh);
+        EXPECT(std::filesystem::exists(path));
+    }
+    EXPECT(!std::filesystem::exists(path));
+
+    // Finalized stores are owned by the returned store.
+    {
+        CachedMesh mesh = createCachedMesh();
+        auto pWriter = VertexCacheStore::Writer::create(path, true);
+        pWriter->addCachedMesh(mesh);
+        auto pStore = pWriter->finalize(true);
+        pWriter.reset();
+        EXPECT(std::filesystem::exists(path));
+    }
+    EXPECT(!std::filesystem::exists(path));
+}
+
+CPU_TEST(VertexCacheStorePrefetch)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_vertex_cache_store_prefetch.bin");
+
+    CachedMesh mesh = createCachedMesh();
+    auto pWriter = VertexCacheStore::Writer::create(path, true);
+    pWriter->addCachedMesh(mesh);
+    auto pStore = pWriter->finalize(true);
+
+    // Move a window of three keyframes over the sequence, as the animation does.
+    for (uint32_t i = 0; i + 2 < kKeyframeCount; ++i)
+    {
+        pStore->setPrefetchWindow({ i, i + 1, i + 2 });
+        pStore->waitForPrefetch();
+
+        auto stats = pStore->getStats();
+        EXPECT_EQ(stats.loadedChunkCount, 3u);
+        EXPECT_EQ(stats.loadedMemoryInBytes, 3 * kVertexCount * sizeof(PackedStaticVertexData));
+
+        auto pData = pStore->getChunk(i);
+        EXPECT_EQ(reinterpret_cast<const PackedStaticVertexData*>(pData->data())[0].position.x, (float)i);
+    }
+
+    auto stats = pStore->getStats();
+    EXPECT_EQ(stats.hits, kKeyframeCount - 2);
+    EXPECT_EQ(stats.misses, 0u);
+    EXPECT_EQ(stats.prefetches, kKeyframeCount);
+
+    // Requests outside of the window are loaded on the calling thread.
+    pStore->setPrefetchWindow({});
+    auto pData = pStore->getChunk(0);
+    EXPECT_EQ(pData->size(), kVertexCount * sizeof(PackedStaticVertexData));
+    EXPECT_EQ(pStore->getStats().misses, 1u);
+    EXPECT_EQ(pStore->getStats().loadedChunkCount, 0u);
+}
+} // namespace Falcor
@@ -38,7 +38,7 @@ std::mt19937 r;
 std::uniform_real_distribution u;
 } // namespace
 
-GPU_TEST(CastFloat16)
+GPU_TEST_NO_CPU(CastFloat16, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -73,13 +73,13 @@ void test(GPUUnitTestContext& ctx, const std::string& shaderModel, bool useUav)
 }
 } // namespace
 
-GPU_TEST(StructuredBufferLoadFloat16)
+GPU_TEST_NO_CPU(StructuredBufferLoadFloat16, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     for (auto sm : kShaderModels)
         test(ctx, sm, false);
 }
 
-GPU_TEST(RWStructuredBufferLoadFloat16)
+GPU_TEST_NO_CPU(RWStructuredBufferLoadFloat16, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     for (auto sm : kShaderModels)
         test(ctx, sm, true);
@@ -74,13 +74,13 @@ void test(GPUUnitTestContext& ctx, const std::string& shaderModel, bool useUav)
 }
 } // namespace
 
-GPU_TEST(StructuredBufferLoadFloat64)
+COMPUTE_TEST(StructuredBufferLoadFloat64)
 {
     for (auto sm : kShaderModels)
         test(ctx, sm, false);
 }
 
-GPU_TEST(RWStructuredBufferLoadFloat64)
+COMPUTE_TEST(RWStructuredBufferLoadFloat64)
 {
     for (auto sm : kShaderModels)
         test(ctx, sm, true);
@@ -59,7 +59,7 @@ std::uniform_int_distribution ui;
 
 } // namespace
 
-GPU_TEST(Inheritance_ManualCreate)
+COMPUTE_TEST(Inheritance_ManualCreate)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -111,7 +111,7 @@ GPU_TEST(Inheritance_ManualCreate)
     ctx.unmapBuffer("resultsFloat");
 }
 
-GPU_TEST(Inheritance_ConformanceCreate)
+COMPUTE_TEST(Inheritance_ConformanceCreate)
 {
     Device* pDevice = ctx.getDevice().get();
 
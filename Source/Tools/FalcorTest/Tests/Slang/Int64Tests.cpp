@@ -76,13 +76,13 @@ void test(GPUUnitTestContext& ctx, const std::string& shaderModel, bool useUav)
 }
 } // namespace
 
-GPU_TEST(StructuredBufferLoadUInt64)
+COMPUTE_TEST(StructuredBufferLoadUInt64)
 {
     for (auto sm : kShaderModels)
         test(ctx, sm, false);
 }
 
-GPU_TEST(RWStructuredBufferLoadUInt64)
+COMPUTE_TEST(RWStructuredBufferLoadUInt64)
 {
     for (auto sm : kShaderModels)
         test(ctx, sm, true);
@@ -34,7 +34,7 @@ namespace Falcor
     This makes sure Slang reflection is accurate and that assign-by-name
     works correctly for all basic types without manually added padding.
 */
-GPU_TEST(NestedStructs)
+COMPUTE_TEST(NestedStructs)
 {
     ctx.createProgram("Tests/Slang/NestedStructs.cs.slang", "main");
     ctx.allocateStructuredBuffer("result", 27);
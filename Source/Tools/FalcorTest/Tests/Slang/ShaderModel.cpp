@@ -48,32 +48,32 @@ void test(GPUUnitTestContext& ctx, const std::string& shaderModel)
 }
 } // namespace
 
-GPU_TEST(ShaderModel6_0)
+GPU_TEST_NO_CPU(ShaderModel6_0, "Shader models only apply to GPU targets.")
 {
     test(ctx, "6_0");
 }
 
-GPU_TEST(ShaderModel6_1)
+GPU_TEST_NO_CPU(ShaderModel6_1, "Shader models only apply to GPU targets.")
 {
     test(ctx, "6_1");
 }
 
-GPU_TEST(ShaderModel6_2)
+GPU_TEST_NO_CPU(ShaderModel6_2, "Shader models only apply to GPU targets.")
 {
     test(ctx, "6_2");
 }
 
-GPU_TEST(ShaderModel6_3)
+GPU_TEST_NO_CPU(ShaderModel6_3, "Shader models only apply to GPU targets.")
 {
     test(ctx, "6_3");
 }
 
-GPU_TEST(ShaderModel6_4)
+GPU_TEST_NO_CPU(ShaderModel6_4, "Shader models only apply to GPU targets.")
 {
     test(ctx, "6_4");
 }
 
-GPU_TEST(ShaderModel6_5)
+GPU_TEST_NO_CPU(ShaderModel6_5, "Shader models only apply to GPU targets.")
 {
     test(ctx, "6_5");
 }
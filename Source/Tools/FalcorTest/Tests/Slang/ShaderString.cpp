@@ -66,7 +66,7 @@ const char kShaderModuleD[] =
 const uint32_t kSize = 32;
 } // namespace
 
-GPU_TEST(ShaderStringInline)
+COMPUTE_TEST(ShaderStringInline)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -103,7 +103,7 @@ GPU_TEST(ShaderStringInline)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(ShaderStringModule)
+COMPUTE_TEST(ShaderStringModule)
 {
     // Create program with generated code placed in another translation unit.
     // The generated code is imported as a module using a relative path.
@@ -125,7 +125,7 @@ GPU_TEST(ShaderStringModule)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(ShaderStringImport)
+COMPUTE_TEST(ShaderStringImport)
 {
     // Create program with generated code placed inline in the same translation
     // unit as the entry point. The generated code imports another module using an absolute path.
@@ -147,7 +147,7 @@ GPU_TEST(ShaderStringImport)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(ShaderStringImportDuplicate, "Duplicate import not working")
+COMPUTE_TEST(ShaderStringImportDuplicate, "Duplicate import not working")
 {
     // Create program with generated code placed inline in the same translation
     // unit as the entry point. The generated code imports another module using an absolute path.
@@ -170,7 +170,7 @@ GPU_TEST(ShaderStringImportDuplicate, "Duplicate import not working")
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(ShaderStringImported)
+COMPUTE_TEST(ShaderStringImported)
 {
     // Create program with generated code placed in a new translation unit.
     // The program imports a module that imports the generated module.
@@ -192,7 +192,7 @@ GPU_TEST(ShaderStringImported)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(ShaderStringDynamicObject)
+COMPUTE_TEST(ShaderStringDynamicObject)
 {
     const uint32_t typeID = 55;
 
@@ -30,7 +30,7 @@
 
 namespace Falcor
 {
-GPU_TEST(SlangStructInheritanceReflection, "Not working yet")
+COMPUTE_TEST(SlangStructInheritanceReflection, "Not working yet")
 {
     ctx.createProgram("Tests/Slang/SlangInheritance.cs.slang", "main", Program::DefineList(), Shader::CompilerFlags::None, "6_5");
 
@@ -76,7 +76,7 @@ GPU_TEST(SlangStructInheritanceReflection, "Not working yet")
     }
 }
 
-GPU_TEST(SlangStructInheritanceLayout)
+COMPUTE_TEST(SlangStructInheritanceLayout)
 {
     Device* pDevice = ctx.getDevice().get();
 
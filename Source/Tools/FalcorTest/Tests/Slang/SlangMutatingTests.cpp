@@ -29,7 +29,7 @@
 
 namespace Falcor
 {
-GPU_TEST(SlangMutating)
+COMPUTE_TEST(SlangMutating)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -44,7 +44,7 @@ static_assert(sizeof(F) == 48, "Unpexected size of struct F");
 const uint32_t kElems = 128;
 } // namespace
 
-GPU_TEST(SlangReinterpretCast)
+GPU_TEST_NO_CPU(SlangReinterpretCast, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -78,7 +78,7 @@ uint64_t asuint64(double a)
     without unexpected results. Note in most cases it'd be fine if the enums differ,
     but certain uses (flags we OR together etc.) must match.
 */
-GPU_TEST(SlangEnum)
+COMPUTE_TEST(SlangEnum)
 {
     testEnum(ctx, ""); // Use default shader model for the unit test system
     testEnum(ctx, "6_0");
@@ -91,7 +91,7 @@ GPU_TEST(SlangEnum)
     flag by default in shader model 6.2.
     https://github.com/Microsoft/DirectXShaderCompiler/wiki/16-Bit-Scalar-Types
 */
-GPU_TEST(SlangScalarTypes)
+GPU_TEST_NO_CPU(SlangScalarTypes, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     const uint32_t maxTests = 100;
 
@@ -161,7 +161,7 @@ GPU_TEST(SlangScalarTypes)
 
 /** Test Slang default initializers for basic types and structs.
  */
-GPU_TEST(SlangDefaultInitializers)
+COMPUTE_TEST(SlangDefaultInitializers)
 {
     const uint32_t maxTests = 100, usedTests = 43;
     std::vector<uint32_t> initData(maxTests, -1);
@@ -200,7 +200,7 @@ GPU_TEST(SlangDefaultInitializers)
 #endif
 }
 
-GPU_TEST(SlangHashedStrings)
+COMPUTE_TEST(SlangHashedStrings)
 {
     ctx.createProgram("Tests/Slang/SlangTests.cs.slang", "testHashedStrings");
     ctx.allocateStructuredBuffer("result", 4);
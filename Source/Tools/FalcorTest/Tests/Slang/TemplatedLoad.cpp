@@ -69,22 +69,22 @@ void test(GPUUnitTestContext& ctx, const std::string& entryPoint, const size_t n
 }
 } // namespace
 
-GPU_TEST(TemplatedScalarLoad16)
+GPU_TEST_NO_CPU(TemplatedScalarLoad16, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     test(ctx, "testTemplatedScalarLoad16", 20);
 }
 
-GPU_TEST(TemplatedVectorLoad16)
+GPU_TEST_NO_CPU(TemplatedVectorLoad16, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     test(ctx, "testTemplatedVectorLoad16", 20);
 }
 
-GPU_TEST(TemplatedMatrixLoad16_2x4)
+GPU_TEST_NO_CPU(TemplatedMatrixLoad16_2x4, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     test(ctx, "testTemplatedMatrixLoad16_2x4", 8);
 }
 
-GPU_TEST(TemplatedMatrixLoad16_4x3)
+GPU_TEST_NO_CPU(TemplatedMatrixLoad16_4x3, "16-bit floating-point types are not supported by Slang's CPU target.")
 {
     test(ctx, "testTemplatedMatrixLoad16_4x3", 12);
 }
@@ -69,12 +69,12 @@ void testRayFlags(GPUUnitTestContext& ctx, bool useDXR_1_1)
 }
 } // namespace
 
-GPU_TEST(TraceRayFlagsDXR1_0)
+GPU_TEST_NO_CPU(TraceRayFlagsDXR1_0, "Ray tracing is not supported on the CPU device.")
 {
     testRayFlags(ctx, false);
 }
 
-GPU_TEST(TraceRayFlagsDXR1_1)
+GPU_TEST_NO_CPU(TraceRayFlagsDXR1_1, "Ray tracing is not supported on the CPU device.")
 {
     testRayFlags(ctx, true);
 }
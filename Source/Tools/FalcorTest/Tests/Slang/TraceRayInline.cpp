@@ -29,7 +29,7 @@
 
 namespace Falcor
 {
-GPU_TEST(testTraceRayInlineAPI)
+GPU_TEST_NO_CPU(testTraceRayInlineAPI, "Ray tracing is not supported on the CPU device.")
 {
     // We don't actually run the program, just make sure it compiles.
     ctx.createProgram(
@@ -29,7 +29,9 @@
 
 namespace Falcor
 {
-GPU_TEST(UnboundedDescriptorArray, "Unbounded arrays are not yet supported")
+GPU_TEST_NO_CPU(
+    UnboundedDescriptorArray, "Unbounded descriptor arrays are not supported on the CPU device.", "Unbounded arrays are not yet supported"
+)
 {
     Device* pDevice = ctx.getDevice().get();
 
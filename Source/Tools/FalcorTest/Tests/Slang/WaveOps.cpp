@@ -176,7 +176,7 @@ uint32_t queryLaneCount(GPUUnitTestContext& ctx)
 }
 } // namespace
 
-GPU_TEST(WaveGetLaneCount)
+GPU_TEST_NO_CPU(WaveGetLaneCount, "Wave intrinsics are not supported by Slang's CPU target.")
 {
     uint32_t laneCount = queryLaneCount(ctx);
     EXPECT_GE(laneCount, 4u);
@@ -224,17 +224,17 @@ GPU_TEST_D3D12(WaveMatch)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(WaveMinMax)
+GPU_TEST_NO_CPU(WaveMinMax, "Wave intrinsics are not supported by Slang's CPU target.")
 {
     testWaveMinMax(ctx, false);
 }
 
-GPU_TEST(WaveMinMaxConditional, "Disabled due to compiler issues")
+GPU_TEST_NO_CPU(WaveMinMaxConditional, "Wave intrinsics are not supported by Slang's CPU target.", "Disabled due to compiler issues")
 {
     testWaveMinMax(ctx, true);
 }
 
-GPU_TEST(WaveMaxSimpleFloat, "Disabled due to compiler issues")
+GPU_TEST_NO_CPU(WaveMaxSimpleFloat, "Wave intrinsics are not supported by Slang's CPU target.", "Disabled due to compiler issues")
 {
     // Minimal test for floating point WaveActiveMax inside control flow.
     // The max across all lanes with value <= -2 is computed, the rest are unmodified.
@@ -269,7 +269,7 @@ GPU_TEST(WaveMaxSimpleFloat, "Disabled due to compiler issues")
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(WaveMaxSimpleInt)
+GPU_TEST_NO_CPU(WaveMaxSimpleInt, "Wave intrinsics are not supported by Slang's CPU target.")
 {
     // Minimal test for integer WaveActiveMax inside control flow.
     // The max across all lanes with value <= -2 is computed, the rest are unmodified.
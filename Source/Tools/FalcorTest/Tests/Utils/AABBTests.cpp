@@ -40,7 +40,7 @@ const float3 kTestData[] = {
 };
 } // namespace
 
-GPU_TEST(AABB)
+COMPUTE_TEST(AABB)
 {
     const uint32_t resultSize = 100;
 
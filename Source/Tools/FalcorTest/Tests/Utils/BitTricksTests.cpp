@@ -46,7 +46,7 @@ uint32_t referenceBitInterleave(uint32_t x, uint32_t y, uint32_t m)
 }
 } // namespace
 
-GPU_TEST(BitInterleave)
+COMPUTE_TEST(BitInterleave)
 {
     Device* pDevice = ctx.getDevice().get();
 
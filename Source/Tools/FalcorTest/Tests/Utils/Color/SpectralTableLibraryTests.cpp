@@ -0,0 +1,121 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Color/SpectralTableLibrary.h"
+
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+void writeTable(const std::filesystem::path& path, const std::string& text)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+void expectEqual(CPUUnitTestContext& ctx, const SampledSpectrum<float>& a, const SampledSpectrum<float>& b)
+{
+    EXPECT_EQ(a.getWavelengthRange().x, b.getWavelengthRange().x);
+    EXPECT_EQ(a.getWavelengthRange().y, b.getWavelengthRange().y);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) EXPECT_EQ(a.get(i), b.get(i)) << "i = " << i;
+}
+} // namespace
+
+CPU_TEST(SpectralTableLibrary)
+{
+    const std::filesystem::path tablesDir = std::filesystem::absolute("test_spectral_tables");
+    const std::filesystem::path buildDir = std::filesystem::absolute("test_spectral_tables_build");
+    const std::filesystem::path archivePath = buildDir / "data" / SpectralTableLibrary::kArchiveFilename;
+    std::filesystem::remove_all(tablesDir);
+    std::filesystem::remove_all(buildDir);
+    writeTable(tablesDir / "ior/Test.eta.spd", "# comment\r\n\r\n  400.0 1.5\r\n500 1.25\n600 1.0 # trailing\n");
+    writeTable(tablesDir / "emission/Test.spd", "400 0\n450 2\n700 1\nend of data\n800 5\n");
+
+    // Text tables are used as long as there is no archive.
+    std::filesystem::path sourcePath;
+    {
+        SpectralTableLibrary library(tablesDir, archivePath);
+        EXPECT_EQ(library.getArchivePath(), archivePath);
+        EXPECT(!library.hasArchive());
+        EXPECT(!library.find("ior/Test.eta"));
+        auto spectrum = library.load("emission/Test", sourcePath);
+        EXPECT_EQ(sourcePath, tablesDir / "emission/Test.spd");
+        EXPECT_EQ(spectrum.getWavelengthRange().y, 700.f);
+    }
+
+    EXPECT_EQ(SpectralTableLibrary::compile(tablesDir, archivePath), 2);
+
+    {
+        SpectralTableLibrary library(tablesDir, archivePath);
+        EXPECT(library.hasArchive());
+        EXPECT_EQ(library.getArchiveTableCount(), 2);
+        for (const char* name : {"ior/Test.eta", "emission/Test"})
+        {
+            auto archived = library.find(name);
+            ASSERT(archived.has_value());
+            expectEqual(ctx, *archived, SampledSpectrum<float>{PiecewiseLinearSpectrum::fromFile(library.getTablePath(name))});
+            library.load(name, sourcePath);
+            EXPECT_EQ(sourcePath, library.getArchivePath());
+        }
+
+        // Tables added after compiling the archive are loaded from the text files.
+        writeTable(tablesDir / "ior/Test.k.spd", "400 0.5\n600 0.25\n");
+        library.load("ior/Test.k", sourcePath);
+        EXPECT_EQ(sourcePath, tablesDir / "ior/Test.k.spd");
+
+        bool caught = false;
+        try
+        {
+            library.load("ior/Missing.eta", sourcePath);
+        }
+        catch (const RuntimeError&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+    }
+
+    // Invalid archives are ignored.
+    writeTable(archivePath, "not an archive");
+    {
+        SpectralTableLibrary library(tablesDir, archivePath);
+        EXPECT(!library.hasArchive());
+        library.load("ior/Test.eta", sourcePath);
+        EXPECT_EQ(sourcePath, tablesDir / "ior/Test.eta.spd");
+    }
+
+    // Without an archive path, the archive is looked up in the tables directory.
+    EXPECT_EQ(SpectralTableLibrary(tablesDir).getArchivePath(), tablesDir / SpectralTableLibrary::kArchiveFilename);
+
+    std::filesystem::remove_all(tablesDir);
+    std::filesystem::remove_all(buildDir);
+}
+} // namespace Falcor
@@ -37,7 +37,7 @@ const float kTestMinWavelength = 300.f;
 const float kTestMaxWavelength = 900.f;
 } // namespace
 
-GPU_TEST(WavelengthToXYZ)
+COMPUTE_TEST(WavelengthToXYZ)
 {
     std::mt19937 rng;
     auto dist = std::uniform_real_distribution<float>();
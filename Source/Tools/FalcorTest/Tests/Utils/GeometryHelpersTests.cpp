@@ -250,12 +250,12 @@ GPU_TEST_D3D12(ComputeRayOrigin)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(BoxSubtendedConeAngleCenter)
+COMPUTE_TEST(BoxSubtendedConeAngleCenter)
 {
     testKnownBBoxes(ctx, "testBoundingConeAngleCenter");
 }
 
-GPU_TEST(BoxSubtendedConeAngleAverage)
+COMPUTE_TEST(BoxSubtendedConeAngleAverage)
 {
     testKnownBBoxes(ctx, "testBoundingConeAngleAverage");
 }
@@ -263,17 +263,17 @@ GPU_TEST(BoxSubtendedConeAngleAverage)
 // Disable this test for now: it turns out that this bounding method returns
 // cos(theta) = -1 for points that are close enough to the bounding box that
 // their cos(theta) value is < 0.
-GPU_TEST(BoxSubtendedConeAngleCenterRandoms, "Disabled as bounding cone is over-conservative (#699)")
+COMPUTE_TEST(BoxSubtendedConeAngleCenterRandoms, "Disabled as bounding cone is over-conservative (#699)")
 {
     testRandomBBoxes(ctx, "testBoundingConeAngleCenter");
 }
 
-GPU_TEST(BoxSubtendedConeAngleAverageRandoms)
+COMPUTE_TEST(BoxSubtendedConeAngleAverageRandoms)
 {
     testRandomBBoxes(ctx, "testBoundingConeAngleAverage");
 }
 
-GPU_TEST(SphereSubtendedAngle)
+COMPUTE_TEST(SphereSubtendedAngle)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -339,7 +339,7 @@ GPU_TEST(SphereSubtendedAngle)
     ctx.unmapBuffer("sinTheta");
 }
 
-GPU_TEST(ComputeClippedTriangleArea2D)
+COMPUTE_TEST(ComputeClippedTriangleArea2D)
 {
     Device* pDevice = ctx.getDevice().get();
 
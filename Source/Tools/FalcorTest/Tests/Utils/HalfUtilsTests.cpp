@@ -201,7 +201,7 @@ std::vector<float> generateFP16TestData(UnitTestContext& ctx)
 
 // This test currently fails due to difference in rounding modes for f32tof16() between CPU and GPU.
 // TODO: Currently disabled until we figure out the rounding modes and have a matching CPU library.
-GPU_TEST(FP32ToFP16Conversion, "Disabled due to lacking fp16 library (#391)")
+COMPUTE_TEST(FP32ToFP16Conversion, "Disabled due to lacking fp16 library (#391)")
 {
     std::vector<float> testData = generateFP16TestData(ctx);
 
@@ -223,7 +223,7 @@ GPU_TEST(FP32ToFP16Conversion, "Disabled due to lacking fp16 library (#391)")
     ctx.unmapBuffer("resultUint");
 }
 
-GPU_TEST(FP16ToFP32Conversion)
+COMPUTE_TEST(FP16ToFP32Conversion)
 {
     std::vector<uint32_t> testData = generateAllFiniteFP16();
 
@@ -317,7 +317,9 @@ GPU_TEST_D3D12(FP32ToFP16ConservativeRoundingGPU)
 
 // TODO: Currently disabled until we figure out the rounding modes and have a matching CPU library. See #391.
 // TODO: Look into the spec (is it even strictly spec'ed in HLSL?) and add utility function to detect the mode used.
-GPU_TEST(FP16RoundingModeGPU, "Disabled due to lacking fp16 library (#391)")
+GPU_TEST_NO_CPU(
+    FP16RoundingModeGPU, "Tests the rounding of GPU half-precision conversion instructions.", "Disabled due to lacking fp16 library (#391)"
+)
 {
     std::vector<float> input, expected;
     generateFP16RNETestData(input, expected);
@@ -51,7 +51,7 @@ uint32_t jenkinsHash(uint32_t a)
 }
 } // namespace
 
-GPU_TEST(JenkinsHash_CompareToCPU)
+COMPUTE_TEST(JenkinsHash_CompareToCPU)
 {
     Device* pDevice = ctx.getDevice().get();
 
@@ -93,9 +93,9 @@ CPU_TEST(JenkinsHash_PerfectHashCPU, "Disabled for performance reasons")
 }
 
 #ifdef RUN_PERFECT_HASH_TESTS
-GPU_TEST(JenkinsHash_PerfectHashGPU)
+COMPUTE_TEST(JenkinsHash_PerfectHashGPU)
 #else
-GPU_TEST(JenkinsHash_PerfectHashGPU, "Disabled for performance reasons")
+COMPUTE_TEST(JenkinsHash_PerfectHashGPU, "Disabled for performance reasons")
 #endif
 {
     Device* pDevice = ctx.getDevice().get();
@@ -0,0 +1,161 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/CaptureQueue.h"
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kWidth = 7;
+const uint32_t kHeight = 5;
+
+uint8_t getTexel(uint32_t image, uint32_t x, uint32_t y, uint32_t channel)
+{
+    return channel == 3 ? 255 : (uint8_t)(image * 31 + y * kWidth * 3 + x * 3 + channel);
+}
+
+Texture::SharedPtr createTestTexture(Device* pDevice, uint32_t image)
+{
+    std::vector<uint8_t> data(kWidth * kHeight * 4);
+    for (uint32_t y = 0; y < kHeight; y++)
+        for (uint32_t x = 0; x < kWidth; x++)
+            for (uint32_t c = 0; c < 4; c++)
+                data[(y * kWidth + x) * 4 + c] = getTexel(image, x, y, c);
+    return Texture::create2D(pDevice, kWidth, kHeight, ResourceFormat::RGBA8Unorm, 1, 1, data.data(), ResourceBindFlags::ShaderResource);
+}
+
+std::filesystem::path getCapturePath(uint32_t image)
+{
+    return getRuntimeDirectory() / fmt::format("test_capture_queue_{}.png", image);
+}
+
+void checkCapture(GPUUnitTestContext& ctx, uint32_t image)
+{
+    const auto path = getCapturePath(image);
+    ASSERT(std::filesystem::exists(path)) << path;
+
+    // 8-bit PNGs are loaded as BGRX.
+    auto bmp = Bitmap::createFromFile(path, true /* top-down */);
+    ASSERT(bmp != nullptr);
+    ASSERT_EQ(bmp->getWidth(), kWidth);
+    ASSERT_EQ(bmp->getHeight(), kHeight);
+    ASSERT_EQ(bmp->getSize(), kWidth * kHeight * 4);
+
+    const uint8_t* pData = bmp->getData();
+    for (uint32_t y = 0; y < kHeight; y++)
+    {
+        for (uint32_t x = 0; x < kWidth; x++)
+        {
+            const uint8_t* pTexel = pData + (y * kWidth + x) * 4;
+            EXPECT_EQ(pTexel[2], getTexel(image, x, y, 0)) << "image = " << image << " x = " << x << " y = " << y;
+            EXPECT_EQ(pTexel[1], getTexel(image, x, y, 1)) << "image = " << image << " x = " << x << " y = " << y;
+            EXPECT_EQ(pTexel[0], getTexel(image, x, y, 2)) << "image = " << image << " x = " << x << " y = " << y;
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+} // namespace
+
+GPU_TEST(CaptureQueue_Flush)
+{
+    // Use fewer readback buffers and queue slots than images, so that enqueue() has to wait for both.
+    CaptureQueue::Desc desc;
+    desc.workerCount = 2;
+    desc.readbackCount = 2;
+    desc.queueSize = 1;
+    CaptureQueue queue(desc);
+
+    const uint32_t kImageCount = 8;
+    for (uint32_t i = 0; i < kImageCount; i++)
+    {
+        auto pTexture = createTestTexture(ctx.getDevice().get(), i);
+        queue.enqueue(ctx.getRenderContext(), pTexture, getCapturePath(i), Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None);
+        EXPECT_LE(queue.getPendingCount(), desc.readbackCount + desc.queueSize + desc.workerCount);
+    }
+
+    queue.flush();
+    EXPECT_EQ(queue.getPendingCount(), 0u);
+
+    for (uint32_t i = 0; i < kImageCount; i++)
+        checkCapture(ctx, i);
+}
+
+GPU_TEST(CaptureQueue_SetDescAndDestroy)
+{
+    const uint32_t kImageCount = 4;
+    {
+        CaptureQueue queue;
+        queue.enqueue(
+            ctx.getRenderContext(), createTestTexture(ctx.getDevice().get(), 0), getCapturePath(0), Bitmap::FileFormat::PngFile,
+            Bitmap::ExportFlags::None
+        );
+
+        // Changing the configuration writes the pending images first.
+        CaptureQueue::Desc desc;
+        desc.workerCount = 1;
+        desc.readbackCount = 1;
+        desc.queueSize = 1;
+        queue.setDesc(desc);
+        EXPECT_EQ(queue.getPendingCount(), 0u);
+        EXPECT(std::filesystem::exists(getCapturePath(0)));
+
+        for (uint32_t i = 1; i < kImageCount; i++)
+        {
+            queue.enqueue(
+                ctx.getRenderContext(), createTestTexture(ctx.getDevice().get(), i), getCapturePath(i), Bitmap::FileFormat::PngFile,
+                Bitmap::ExportFlags::None
+            );
+        }
+        // The destructor writes the remaining images.
+    }
+
+    for (uint32_t i = 0; i < kImageCount; i++)
+        checkCapture(ctx, i);
+}
+
+GPU_TEST(CaptureQueue_Unsupported)
+{
+    CaptureQueue queue;
+    auto pTexture = createTestTexture(ctx.getDevice().get(), 0);
+
+    // DDS files are not supported.
+    bool caught = false;
+    try
+    {
+        queue.enqueue(ctx.getRenderContext(), pTexture, getCapturePath(0), Bitmap::FileFormat::DdsFile, Bitmap::ExportFlags::None);
+    }
+    catch (const RuntimeError&)
+    {
+        caught = true;
+    }
+    EXPECT(caught);
+    EXPECT_EQ(queue.getPendingCount(), 0u);
+}
+} // namespace Falcor
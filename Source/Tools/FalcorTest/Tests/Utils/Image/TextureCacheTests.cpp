@@ -0,0 +1,226 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/Bitmap.h"
+#include "Utils/Image/TextureCache.h"
+
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+template<typename T>
+Bitmap::UniqueConstPtr createBitmap(uint32_t width, uint32_t height, ResourceFormat format, T value, T alpha)
+{
+    const uint32_t channelCount = getFormatChannelCount(format);
+    std::vector<T> data(width * height * channelCount, value);
+    if (channelCount == 4)
+    {
+        for (size_t i = 3; i < data.size(); i += 4)
+            data[i] = alpha;
+    }
+    return Bitmap::create(width, height, format, reinterpret_cast<const uint8_t*>(data.data()));
+}
+
+/// Write a 16 bits per pixel BMP file. These are loaded as two channel RG8Unorm bitmaps.
+void writeBmp16(const std::filesystem::path& path, uint32_t width, uint32_t height)
+{
+    const uint32_t rowPitch = (width * 2 + 3) & ~3u;
+    const uint32_t dataOffset = 14 + 40;
+
+    std::vector<uint8_t> file;
+    auto write16 = [&](uint32_t value)
+    {
+        file.push_back(uint8_t(value));
+        file.push_back(uint8_t(value >> 8));
+    };
+    auto write32 = [&](uint32_t value)
+    {
+        write16(value & 0xffff);
+        write16(value >> 16);
+    };
+
+    // BITMAPFILEHEADER
+    write16('B' | ('M' << 8));
+    write32(dataOffset + rowPitch * height);
+    write32(0);
+    write32(dataOffset);
+    // BITMAPINFOHEADER
+    write32(40);
+    write32(width);
+    write32(height);
+    write16(1);  // Planes
+    write16(16); // Bits per pixel
+    write32(0);  // BI_RGB, i.e. 5:5:5 RGB
+    write32(rowPitch * height);
+    write32(2835); // Pixels per meter
+    write32(2835);
+    write32(0);
+    write32(0);
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+            write16((x + y * width) & 0x7fff);
+        file.resize(dataOffset + (y + 1) * rowPitch, 0);
+    }
+
+    std::ofstream(path, std::ios_base::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+}
+} // namespace
+
+CPU_TEST(TextureCache_ChooseCompressionMode)
+{
+    using Mode = ImageIO::CompressionMode;
+    TextureCache::Settings settings;
+    TextureCache::Settings compactSettings;
+    compactSettings.compactColor = true;
+    TextureCache::Settings uncompressedSettings;
+    uncompressedSettings.compress = false;
+
+    auto pOpaque = createBitmap<uint8_t>(16, 16, ResourceFormat::BGRA8Unorm, 100, 255);
+    auto pTransparent = createBitmap<uint8_t>(16, 16, ResourceFormat::BGRA8Unorm, 100, 128);
+    EXPECT(TextureCache::chooseCompressionMode(*pOpaque, settings) == Mode::BC7);
+    EXPECT(TextureCache::chooseCompressionMode(*pOpaque, compactSettings) == Mode::BC1);
+    EXPECT(TextureCache::chooseCompressionMode(*pTransparent, compactSettings) == Mode::BC7);
+    EXPECT(TextureCache::chooseCompressionMode(*pOpaque, uncompressedSettings) == Mode::None);
+
+    auto pTwoChannel = createBitmap<uint8_t>(16, 16, ResourceFormat::RG8Unorm, 100, 0);
+    EXPECT(TextureCache::chooseCompressionMode(*pTwoChannel, settings) == Mode::BC5);
+
+    auto pHdrOpaque = createBitmap<float>(16, 16, ResourceFormat::RGBA32Float, 2.f, 1.f);
+    auto pHdrTransparent = createBitmap<float>(16, 16, ResourceFormat::RGBA32Float, 2.f, 0.5f);
+    EXPECT(TextureCache::chooseCompressionMode(*pHdrOpaque, settings) == Mode::BC6);
+    EXPECT(TextureCache::chooseCompressionMode(*pHdrTransparent, settings) == Mode::None);
+
+    // Images with dimensions that are not multiples of 4 are stored uncompressed.
+    auto pOddSize = createBitmap<uint8_t>(18, 16, ResourceFormat::BGRA8Unorm, 100, 255);
+    EXPECT(TextureCache::chooseCompressionMode(*pOddSize, settings) == Mode::None);
+}
+
+CPU_TEST(TextureCache_Settings)
+{
+    const auto cacheDirectory = getRuntimeDirectory() / "test_texture_cache_settings";
+    const auto path = getRuntimeDirectory() / "test_texture_cache_settings.png";
+    std::filesystem::remove_all(cacheDirectory);
+
+    std::vector<uint8_t> data(16 * 16, 100);
+    Bitmap::saveImage(
+        path, 16, 16, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None, ResourceFormat::R8Uint, true /* top-down */, data.data()
+    );
+
+    // Caches with different settings sharing a directory don't use each other's entries.
+    TextureCache::Settings uncompressedSettings;
+    uncompressedSettings.compress = false;
+    auto pCompressedCache = TextureCache::create(cacheDirectory);
+    auto pUncompressedCache = TextureCache::create(cacheDirectory, uncompressedSettings);
+
+    auto compressedPath = pCompressedCache->addTexture(path, true);
+    EXPECT(pUncompressedCache->findTexture(path, true).empty());
+    auto uncompressedPath = pUncompressedCache->addTexture(path, true);
+    EXPECT(compressedPath != uncompressedPath);
+    EXPECT(pCompressedCache->findTexture(path, true) == compressedPath);
+    EXPECT(pUncompressedCache->findTexture(path, true) == uncompressedPath);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+CPU_TEST(TextureCache_TwoChannel)
+{
+    const auto cacheDirectory = getRuntimeDirectory() / "test_texture_cache_two_channel";
+    const auto path = getRuntimeDirectory() / "test_texture_cache_two_channel.bmp";
+    std::filesystem::remove_all(cacheDirectory);
+
+    writeBmp16(path, 16, 16);
+    auto pBitmap = Bitmap::createFromFile(path, true);
+    ASSERT(pBitmap != nullptr);
+    ASSERT(pBitmap->getFormat() == ResourceFormat::RG8Unorm);
+
+    // Two channel images are cached BC5 compressed.
+    auto pCompressedCache = TextureCache::create(cacheDirectory);
+    auto entryPath = pCompressedCache->addTexture(path, true);
+    EXPECT(std::filesystem::exists(entryPath));
+
+    // Two channel images that can't be block compressed are skipped.
+    TextureCache::Settings uncompressedSettings;
+    uncompressedSettings.compress = false;
+    auto pUncompressedCache = TextureCache::create(cacheDirectory, uncompressedSettings);
+    EXPECT(pUncompressedCache->addTexture(path, true).empty());
+    EXPECT(pUncompressedCache->findTexture(path, true).empty());
+
+    writeBmp16(path, 18, 16);
+    EXPECT(pCompressedCache->addTexture(path, true).empty());
+    EXPECT(pCompressedCache->findTexture(path, true).empty());
+
+    std::filesystem::remove(path);
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+GPU_TEST(TextureCache_AddAndLoad)
+{
+    const auto cacheDirectory = getRuntimeDirectory() / "test_texture_cache";
+    const auto path = getRuntimeDirectory() / "test_texture_cache.png";
+    std::filesystem::remove_all(cacheDirectory);
+
+    auto writeImage = [&](uint32_t size)
+    {
+        std::vector<uint8_t> data(size * size);
+        for (size_t i = 0; i < data.size(); i++)
+            data[i] = (uint8_t)i;
+        Bitmap::saveImage(path, size, size, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None, ResourceFormat::R8Uint, true /* top-down */, data.data());
+    };
+    writeImage(16);
+
+    auto pTextureCache = TextureCache::create(cacheDirectory);
+    EXPECT(pTextureCache->findTexture(path, true).empty());
+    EXPECT(pTextureCache->loadTexture(ctx.getDevice().get(), path, true, false) == nullptr);
+
+    auto entryPath = pTextureCache->addTexture(path, true);
+    EXPECT(std::filesystem::exists(entryPath));
+    EXPECT(pTextureCache->findTexture(path, true) == entryPath);
+    EXPECT(pTextureCache->findTexture(path, false).empty());
+
+    // The cached texture has baked mips and is block compressed. Single channel images use BC4, which has no sRGB variant.
+    auto pTexture = pTextureCache->loadTexture(ctx.getDevice().get(), path, true, true);
+    ASSERT(pTexture != nullptr);
+    EXPECT_EQ(pTexture->getWidth(), 16);
+    EXPECT_EQ(pTexture->getHeight(), 16);
+    EXPECT_EQ(pTexture->getMipCount(), 5);
+    EXPECT(pTexture->getFormat() == ResourceFormat::BC4Unorm);
+    EXPECT(pTexture->getSourcePath() == path);
+
+    // Changing the source file invalidates the cache entry.
+    writeImage(32);
+    EXPECT(pTextureCache->findTexture(path, true).empty());
+
+    std::filesystem::remove(path);
+    std::filesystem::remove_all(cacheDirectory);
+}
+} // namespace Falcor
@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/Bitmap.h"
+#include "Utils/Image/TextureManager.h"
+
+namespace Falcor
+{
+namespace
+{
+void writeTestImage(const std::filesystem::path& path, uint8_t offset)
+{
+    uint8_t data[16 * 16];
+    for (uint32_t i = 0; i < 16 * 16; i++)
+        data[i] = (uint8_t)(i + offset);
+    Bitmap::saveImage(path, 16, 16, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None, ResourceFormat::R8Uint, true /* top-down */, data);
+}
+} // namespace
+
+GPU_TEST(TextureManager_DeduplicateByContent)
+{
+    const auto pathA = getRuntimeDirectory() / "test_texture_dedup_a.png";
+    const auto pathB = getRuntimeDirectory() / "test_texture_dedup_b.png";
+    const auto pathC = getRuntimeDirectory() / "test_texture_dedup_c.png";
+
+    // Images A and B have identical content, C is different.
+    writeTestImage(pathA, 0);
+    std::filesystem::copy_file(pathA, pathB, std::filesystem::copy_options::overwrite_existing);
+    writeTestImage(pathC, 1);
+
+    auto load = [](TextureManager& textureManager, const std::filesystem::path& path)
+    { return textureManager.loadTexture(path, false, false, Resource::BindFlags::ShaderResource, false /* async */); };
+
+    // Without deduplication, each file gets its own texture.
+    {
+        auto pTextureManager = TextureManager::create(ctx.getDevice(), 16);
+        EXPECT(!pTextureManager->isDeduplicatingByContent());
+        auto handleA = load(*pTextureManager, pathA);
+        auto handleB = load(*pTextureManager, pathB);
+        EXPECT(handleA.isValid() && handleB.isValid());
+        EXPECT(!(handleA == handleB));
+        EXPECT_EQ(pTextureManager->getStats().textureDeduplicatedCount, 0);
+    }
+
+    // With deduplication, files with identical content share one texture and handle.
+    {
+        auto pTextureManager = TextureManager::create(ctx.getDevice(), 16);
+        pTextureManager->setDeduplicateByContent(true);
+        auto handleA = load(*pTextureManager, pathA);
+        auto handleB = load(*pTextureManager, pathB);
+        auto handleC = load(*pTextureManager, pathC);
+        EXPECT(handleA.isValid() && handleB.isValid() && handleC.isValid());
+        EXPECT(handleA == handleB);
+        EXPECT(!(handleA == handleC));
+
+        // Loading with other settings does not share the texture.
+        auto handleMips = pTextureManager->loadTexture(pathB, true, false, Resource::BindFlags::ShaderResource, false /* async */);
+        EXPECT(!(handleA == handleMips));
+
+        auto pTexture = pTextureManager->getTexture(handleA);
+        ASSERT(pTexture != nullptr);
+        auto stats = pTextureManager->getStats();
+        EXPECT_EQ(stats.textureCount, 3);
+        EXPECT_EQ(stats.textureDeduplicatedCount, 1);
+        EXPECT_EQ(stats.textureDeduplicatedMemoryInBytes, pTexture->getTextureSizeInBytes());
+
+        // Removing the shared texture removes it for all files.
+        pTextureManager->removeTexture(handleA);
+        EXPECT_EQ(pTextureManager->getStats().textureDeduplicatedCount, 0);
+        auto handleB2 = load(*pTextureManager, pathB);
+        EXPECT(handleB2.isValid());
+        EXPECT(pTextureManager->getTexture(handleB2) != nullptr);
+    }
+
+    std::filesystem::remove(pathA);
+    std::filesystem::remove(pathB);
+    std::filesystem::remove(pathC);
+}
+} // namespace Falcor
@@ -108,7 +108,7 @@ void testCopyColorChannel(
 }
 } // namespace
 
-GPU_TEST(CopyColorChannel)
+GPU_TEST_NO_CPU(CopyColorChannel, "Copies between 16-bit and normalized integer texture formats, which the CPU device cannot convert.")
 {
     uint32_t w = 15, h = 3;
     ImageProcessing imageProcessing(ctx.getDevice());
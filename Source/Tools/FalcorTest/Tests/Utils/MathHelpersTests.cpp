@@ -34,7 +34,7 @@
 
 namespace Falcor
 {
-GPU_TEST(MathHelpers_SphericalCoordinates)
+COMPUTE_TEST(MathHelpers_SphericalCoordinates)
 {
     ctx.createProgram("Tests/Utils/MathHelpersTests.cs.slang", "testSphericalCoordinates");
     constexpr int32_t n = 1024 * 1024;
@@ -55,7 +55,7 @@ GPU_TEST(MathHelpers_SphericalCoordinates)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(MathHelpers_SphericalCoordinatesRad)
+COMPUTE_TEST(MathHelpers_SphericalCoordinatesRad)
 {
     ctx.createProgram("Tests/Utils/MathHelpersTests.cs.slang", "testSphericalCoordinatesRad");
     constexpr int32_t n = 1024 * 1024;
@@ -76,7 +76,7 @@ GPU_TEST(MathHelpers_SphericalCoordinatesRad)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(MathHelpers_ErrorFunction)
+COMPUTE_TEST(MathHelpers_ErrorFunction)
 {
     // Test the approximate implementation of `erf` against
     // the C++ standard library.
@@ -107,7 +107,7 @@ GPU_TEST(MathHelpers_ErrorFunction)
     ctx.unmapBuffer("result");
 }
 
-GPU_TEST(MathHelpers_InverseErrorFunction)
+COMPUTE_TEST(MathHelpers_InverseErrorFunction)
 {
     // The C++ standard library does not have a reference for `erfinv`,
     // but we can test erf(erfinv(x)) = x instead.
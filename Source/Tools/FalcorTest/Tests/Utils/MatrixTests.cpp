@@ -29,6 +29,7 @@
 #include "Utils/Math/Matrix/Matrix.h"
 
 #include <fmt/format.h>
+#include <cmath>
 #include <iostream>
 
 namespace Falcor
@@ -50,4 +51,24 @@ CPU_TEST(Matrix_FloatFormatter)
     EXPECT_EQ(fmt::format("{:.2f}", test0), "{{1.10, 1.20, 1.30}, {2.10, 2.20, 2.30}, {3.10, 3.20, 3.30}}");
 }
 
+CPU_TEST(Matrix_AffineInverse)
+{
+    rmcv::mat4 m = rmcv::translate(float3(1.f, -2.f, 3.f)) * rmcv::rotate(0.7f, normalize(float3(1.f, 2.f, 3.f))) * rmcv::scale(float3(2.f, 0.5f, 3.f));
+    EXPECT(rmcv::isAffine(m));
+
+    rmcv::mat4 expected = rmcv::inverse(m);
+    rmcv::mat4 result = rmcv::affineInverse(m);
+    for (int r = 0; r < 4; ++r)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            EXPECT_LE(std::abs(result[r][c] - expected[r][c]), 1e-5f) << "r = " << r << ", c = " << c;
+        }
+    }
+
+    rmcv::mat4 projective = m;
+    projective[3][2] = 1.f;
+    EXPECT(!rmcv::isAffine(projective));
+}
+
 } // namespace Falcor
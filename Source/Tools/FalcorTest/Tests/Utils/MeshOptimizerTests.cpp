@@ -0,0 +1,137 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Geometry/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+
+namespace
+{
+
+// Create a regular grid of quads split into triangles, with the triangles in random order.
+std::vector<uint32_t> createShuffledGrid(uint32_t size, uint32_t& vertexCount)
+{
+    vertexCount = (size + 1) * (size + 1);
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            uint32_t i0 = y * (size + 1) + x;
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i0 + size + 1;
+            uint32_t i3 = i2 + 1;
+            triangles.push_back({ i0, i1, i2 });
+            triangles.push_back({ i1, i3, i2 });
+        }
+    }
+
+    std::mt19937 rng;
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+
+    std::vector<uint32_t> indices;
+    for (const auto& t : triangles)
+        indices.insert(indices.end(), t.begin(), t.end());
+    return indices;
+}
+
+// Return the triangles with each triangle rotated to start at its smallest index, preserving winding.
+std::vector<std::array<uint32_t, 3>> getCanonicalTriangles(const std::vector<uint32_t>& indices)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<uint32_t, 3> t = { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        triangles.push_back(t);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+} // namespace
+
+CPU_TEST(MeshOptimizer_VertexCache)
+{
+    uint32_t vertexCount = 0;
+    std::vector<uint32_t> indices = createShuffledGrid(64, vertexCount);
+    const std::vector<uint32_t> original = indices;
+
+    MeshOptimizer::optimizeVertexCache(indices, vertexCount);
+
+    // The optimized index buffer must contain the same triangles with the same winding.
+    ASSERT_EQ(indices.size(), original.size());
+    EXPECT(getCanonicalTriangles(indices) == getCanonicalTriangles(original));
+
+    // A regular grid has an ideal ACMR of 0.5. A randomly ordered one is close to 3.
+    float acmrBefore = MeshOptimizer::computeACMR(original, vertexCount);
+    float acmrAfter = MeshOptimizer::computeACMR(indices, vertexCount);
+    EXPECT_GT(acmrBefore, 2.f);
+    EXPECT_LT(acmrAfter, 1.f);
+}
+
+CPU_TEST(MeshOptimizer_VertexFetch)
+{
+    uint32_t vertexCount = 0;
+    std::vector<uint32_t> indices = createShuffledGrid(16, vertexCount);
+    const std::vector<uint32_t> original = indices;
+
+    // Add an unreferenced vertex, which should be placed last.
+    vertexCount++;
+    std::vector<uint32_t> remap = MeshOptimizer::optimizeVertexFetch(indices, vertexCount);
+    ASSERT_EQ(remap.size(), (size_t)vertexCount);
+    EXPECT_EQ(remap[vertexCount - 1], vertexCount - 1);
+
+    // The remapping must be a permutation that is consistent with the new index buffer.
+    std::vector<bool> used(vertexCount, false);
+    for (uint32_t newIndex : remap)
+    {
+        ASSERT_LT(newIndex, vertexCount);
+        EXPECT(!used[newIndex]);
+        used[newIndex] = true;
+    }
+    for (size_t i = 0; i < indices.size(); ++i)
+        EXPECT_EQ(indices[i], remap[original[i]]);
+
+    // Vertices are numbered in order of first use.
+    uint32_t nextIndex = 0;
+    for (uint32_t index : indices)
+    {
+        EXPECT_LE(index, nextIndex);
+        if (index == nextIndex)
+            nextIndex++;
+    }
+}
+
+} // namespace Falcor
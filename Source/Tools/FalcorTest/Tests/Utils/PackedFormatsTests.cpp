@@ -45,7 +45,7 @@ std::vector<float3> testData = {
 };
 }
 
-GPU_TEST(LogLuvHDR)
+COMPUTE_TEST(LogLuvHDR)
 {
     std::mt19937 rng;
     auto dist = std::uniform_real_distribution<float>();
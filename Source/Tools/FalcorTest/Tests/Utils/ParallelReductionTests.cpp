@@ -294,7 +294,7 @@ void testReduction(GPUUnitTestContext& ctx, ParallelReduction& reduction, Resour
 }
 } // namespace
 
-GPU_TEST(ParallelReduction)
+GPU_TEST_NO_CPU(ParallelReduction, "Uses wave intrinsics and group shared memory barriers, which Slang's CPU target does not support.")
 {
     // Quick test of the snorm/unorm data types we use.
     FALCOR_ASSERT((float)unorm8_t(163.499f / 255.f) == (163 / 255.f));
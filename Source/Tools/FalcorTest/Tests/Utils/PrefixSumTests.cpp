@@ -92,7 +92,7 @@ void testPrefixSum(GPUUnitTestContext& ctx, PrefixSum& prefixSum, uint32_t numEl
 }
 } // namespace
 
-GPU_TEST(PrefixSum)
+GPU_TEST_NO_CPU(PrefixSum, "Uses group shared memory barriers, which Slang's CPU target does not support.")
 {
     // Quick test of our reference function.
     std::vector<uint32_t> x({5, 17, 2, 9, 23});
@@ -120,7 +120,7 @@ const TextureAnalyzer::Result kExpectedResult[] = {
 };
 } // namespace
 
-GPU_TEST(TextureAnalyzer)
+GPU_TEST_NO_CPU(TextureAnalyzer, "Uses wave intrinsics, which Slang's CPU target does not support.")
 {
     Device* pDevice = ctx.getDevice().get();
 
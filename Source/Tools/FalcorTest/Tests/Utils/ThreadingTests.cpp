@@ -0,0 +1,137 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Threading.h"
+
+#include <atomic>
+#include <vector>
+
+namespace Falcor
+{
+
+CPU_TEST(Threading_DispatchTask)
+{
+    std::atomic<uint32_t> counter = 0;
+    std::vector<Threading::Task> tasks;
+    for (uint32_t i = 0; i < 1000; ++i)
+        tasks.push_back(Threading::dispatchTask([&]() { counter.fetch_add(1); }));
+    for (auto& task : tasks)
+        task.finish();
+
+    EXPECT_EQ(counter.load(), 1000u);
+    for (const auto& task : tasks)
+        EXPECT(!task.isRunning());
+}
+
+CPU_TEST(Threading_Continuation)
+{
+    std::vector<uint32_t> order;
+    auto first = Threading::dispatchTask([&]() { order.push_back(1); });
+    auto second = first.then([&]() { order.push_back(2); });
+    auto third = second.then([&]() { order.push_back(3); });
+    third.finish();
+
+    ASSERT_EQ(order.size(), 3u);
+    for (uint32_t i = 0; i < 3; ++i)
+        EXPECT_EQ(order[i], i + 1);
+
+    // Continuation of an already finished task.
+    bool ran = false;
+    first.then([&]() { ran = true; }).finish();
+    EXPECT(ran);
+}
+
+CPU_TEST(Threading_ParallelFor)
+{
+    const size_t count = 100000;
+    std::vector<uint32_t> visited(count, 0);
+    Threading::parallelFor(0, count, [&](size_t i) { visited[i]++; });
+    for (size_t i = 0; i < count; ++i)
+        EXPECT_EQ(visited[i], 1u) << fmt::format("i = {}", i);
+
+    // Nested parallel loops must not dead-lock.
+    std::atomic<uint32_t> nested = 0;
+    Threading::parallelFor(0, 64, [&](size_t) { Threading::parallelFor(0, 100, [&](size_t) { nested.fetch_add(1); }); }, 1);
+    EXPECT_EQ(nested.load(), 6400u);
+
+    // Exceptions are forwarded to the caller.
+    bool caught = false;
+    try
+    {
+        Threading::parallelFor(0, 100, [](size_t i) { if (i == 42) throw RuntimeError("Expected"); });
+    }
+    catch (const RuntimeError&)
+    {
+        caught = true;
+    }
+    EXPECT(caught);
+}
+
+CPU_TEST(Threading_ParallelReduce)
+{
+    const size_t count = 1000000;
+    auto map = [](size_t begin, size_t end, double sum)
+    {
+        for (size_t i = begin; i < end; ++i)
+            sum += 1.0 / double(i + 1);
+        return sum;
+    };
+    auto reduce = [](double a, double b) { return a + b; };
+
+    double result = Threading::parallelReduce(0, count, 0.0, map, reduce, 1000);
+
+    // The result must match a serial reduction using the same chunking bit by bit.
+    double reference = 0.0;
+    for (size_t begin = 0; begin < count; begin += 1000)
+        reference += map(begin, begin + 1000, 0.0);
+    EXPECT_EQ(result, reference);
+}
+
+CPU_TEST(Threading_ParallelReduceBool)
+{
+    // Partial results of adjacent chunks are written concurrently, which must work for bool as well.
+    const size_t count = 100000;
+    auto allBelow = [](size_t limit)
+    {
+        auto map = [limit](size_t begin, size_t end, bool result)
+        {
+            for (size_t i = begin; i < end; ++i)
+                result = result && i < limit;
+            return result;
+        };
+        return Threading::parallelReduce(0, count, true, map, [](bool a, bool b) { return a && b; }, 1);
+    };
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT(allBelow(count));
+        EXPECT(!allBelow(count - 1));
+    }
+}
+
+} // namespace Falcor
@@ -0,0 +1,133 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Threading.h"
+#include "Utils/Timing/Profiler.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+size_t countOccurrences(const std::string& str, const std::string& pattern)
+{
+    size_t count = 0;
+    for (size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+        count++;
+    return count;
+}
+} // namespace
+
+CPU_TEST(TraceRecorder_InternName)
+{
+    TraceRecorder::NameId a = TraceRecorder::internName("TraceRecorderTest_A");
+    TraceRecorder::NameId b = TraceRecorder::internName("TraceRecorderTest_B");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, TraceRecorder::internName(std::string("TraceRecorderTest_A")));
+    EXPECT_EQ(TraceRecorder::getName(b), "TraceRecorderTest_B");
+}
+
+CPU_TEST(TraceRecorder_InternNameConcurrent)
+{
+    // Intern enough names to span several storage chunks while other threads look them up.
+    const size_t count = 5000;
+    std::vector<TraceRecorder::NameId> ids(count);
+    std::vector<char> matched(count, 0);
+    Threading::parallelFor(0, count, [&](size_t i)
+    {
+        std::string name = "TraceRecorderTest_Concurrent_" + std::to_string(i);
+        ids[i] = TraceRecorder::internName(name);
+        matched[i] = TraceRecorder::getName(ids[i]) == name;
+    });
+
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT(matched[i]) << "i = " << i;
+        EXPECT_EQ(TraceRecorder::getName(ids[i]), "TraceRecorderTest_Concurrent_" + std::to_string(i));
+    }
+    std::sort(ids.begin(), ids.end());
+    EXPECT(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+}
+
+CPU_TEST(TraceRecorder_Record)
+{
+    const size_t count = 10000;
+    TraceRecorder::NameId id = TraceRecorder::internName("TraceRecorderTest_\"Event\"");
+
+    // Events outside of a recording are ignored.
+    TraceRecorder::recordCpuEvent(id, 1, 2);
+
+    TraceRecorder::start();
+    EXPECT(TraceRecorder::isRecording());
+    Threading::parallelFor(0, count, [&](size_t) { ScopedTraceEvent event(id); });
+    TraceRecorder::recordGpuEvent(id, 1000, 2000);
+    TraceRecorder::stop();
+    EXPECT(!TraceRecorder::isRecording());
+
+    std::string json = TraceRecorder::toJsonString();
+    EXPECT_EQ(countOccurrences(json, "\"name\": \"TraceRecorderTest_\\\"Event\\\"\""), count + 1);
+    EXPECT_EQ(countOccurrences(json, "\"ts\": 0.001, \"dur\": 0.001"), 0u);
+    EXPECT_EQ(countOccurrences(json, "\"ts\": 1.000, \"dur\": 1.000, \"pid\": 1"), 1u);
+
+    // Starting a new recording discards the previous events.
+    TraceRecorder::start();
+    TraceRecorder::stop();
+    EXPECT_EQ(countOccurrences(TraceRecorder::toJsonString(), "TraceRecorderTest_"), 0u);
+}
+
+GPU_TEST(Profiler_EventNames)
+{
+    Profiler profiler(ctx.getDevice().get());
+    profiler.setEnabled(true);
+
+    TraceRecorder::NameId outer = TraceRecorder::internName("ProfilerTest_Outer");
+    TraceRecorder::NameId inner = TraceRecorder::internName("ProfilerTest_Inner");
+    TraceRecorder::NameId invalid = TraceRecorder::internName("ProfilerTest/Invalid");
+
+    for (uint32_t frame = 0; frame < 2; frame++)
+    {
+        profiler.startEvent(ctx.getRenderContext(), outer, Profiler::Flags::Internal);
+        // Events with invalid names are ignored, and ending them does not end the enclosing event.
+        profiler.startEvent(ctx.getRenderContext(), invalid, Profiler::Flags::Internal);
+        profiler.endEvent(ctx.getRenderContext(), invalid, Profiler::Flags::Internal);
+        // The string overloads resolve to the same events as the interned names.
+        profiler.startEvent(ctx.getRenderContext(), "ProfilerTest_Inner", Profiler::Flags::Internal);
+        profiler.endEvent(ctx.getRenderContext(), inner, Profiler::Flags::Internal);
+        profiler.endEvent(ctx.getRenderContext(), outer, Profiler::Flags::Internal);
+        profiler.endFrame(ctx.getRenderContext());
+
+        const auto& events = profiler.getEvents();
+        ASSERT_EQ(events.size(), 2);
+        EXPECT_EQ(events[0]->getName(), "/ProfilerTest_Outer");
+        EXPECT_EQ(events[1]->getName(), "/ProfilerTest_Outer/ProfilerTest_Inner");
+    }
+}
+} // namespace Falcor
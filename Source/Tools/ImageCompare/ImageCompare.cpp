@@ -28,16 +28,25 @@
 #include <FreeImage.h>
 #include <args.hxx>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <fstream>
+#include <iomanip>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <stdexcept>
 #include <map>
+#include <set>
 #include <functional>
 #include <filesystem>
 
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 
 template<typename T>
@@ -58,6 +67,62 @@ T clamp(T x, T lo, T hi)
     return std::max(lo, std::min(hi, x));
 }
 
+static uint32_t getDefaultThreadCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Run func(i) for i in [0, count) on up to threadCount threads (including the calling thread).
+ * Work items are handed out dynamically. func must not throw.
+ */
+template<typename Func>
+void parallelFor(size_t count, uint32_t threadCount, Func&& func)
+{
+    threadCount = (uint32_t)std::min<size_t>(threadCount, count);
+    if (threadCount <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < count; i = next++)
+            func(i);
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+/// Number of image rows processed per work item.
+static constexpr uint32_t kRowsPerTask = 16;
+
+/**
+ * Run func(y) for all rows of an image, distributing blocks of rows over threads.
+ */
+template<typename Func>
+void parallelForRows(uint32_t height, uint32_t threadCount, Func&& func)
+{
+    size_t blockCount = (height + kRowsPerTask - 1) / kRowsPerTask;
+    parallelFor(
+        blockCount, threadCount,
+        [&](size_t block)
+        {
+            uint32_t end = std::min(height, uint32_t(block + 1) * kRowsPerTask);
+            for (uint32_t y = uint32_t(block) * kRowsPerTask; y < end; ++y)
+                func(y);
+        }
+    );
+}
+
 class Image
 {
 public:
@@ -68,6 +133,9 @@ public:
     const float* getData() const { return mData.get(); }
     float* getData() { return mData.get(); }
 
+    /// True if the pixel values are linear (floating-point formats), false if they are display encoded (sRGB).
+    bool isLinear() const { return mLinear; }
+
     static SharedPtr create(uint32_t width, uint32_t height) { return SharedPtr(new Image(width, height)); }
 
     static SharedPtr loadFromFile(const std::filesystem::path& path)
@@ -90,6 +158,10 @@ public:
         if (!srcBitmap)
             throw std::runtime_error("Cannot read image");
 
+        // Floating-point images are linear, integer formats are assumed to be sRGB encoded.
+        FREE_IMAGE_TYPE type = FreeImage_GetImageType(srcBitmap);
+        bool linear = type == FIT_FLOAT || type == FIT_DOUBLE || type == FIT_RGBF || type == FIT_RGBAF;
+
         // Convert to RGBA32F.
         FIBITMAP* floatBitmap = FreeImage_ConvertToRGBAF(srcBitmap);
         FreeImage_Unload(srcBitmap);
@@ -104,6 +176,7 @@ public:
             FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, true
         );
         FreeImage_Unload(floatBitmap);
+        image->mLinear = linear;
 
         return image;
     }
@@ -179,90 +252,531 @@ public:
 private:
     uint32_t mWidth;
     uint32_t mHeight;
+    bool mLinear = false;
     std::unique_ptr<float[]> mData;
 
-    Image(uint32_t width, uint32_t height) : mWidth(width), mHeight(height), mData(std::make_unique<float[]>(width * height * 4)) {}
+    Image(uint32_t width, uint32_t height) : mWidth(width), mHeight(height), mData(std::make_unique<float[]>(size_t(width) * height * 4)) {}
+};
+
+
+struct CompareOptions
+{
+    bool alpha = false;          ///< Include the alpha channel (per-channel metrics only).
+    float epsilon = 1e-3f;       ///< Epsilon used by the relative error metrics.
+    float pixelsPerDegree = 67.f; ///< Observer pixels per degree of visual angle (FLIP). The default is a 0.7 m wide 4K monitor viewed at 0.7 m.
+    uint32_t threadCount = 1;    ///< Number of threads used for the comparison.
 };
 
+/**
+ * A plane of floats, used for intermediate per-pixel data.
+ */
+using Plane = std::vector<float>;
+
+/**
+ * Per-channel metrics.
+ * Each operator returns the error of a single channel. The pixel error is the mean over the channels.
+ * The row loops below have a fixed channel count and no dependencies between pixels so that they vectorize.
+ */
 struct MSE
 {
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += sqr(a[i] - b[i]);
-        return error / count;
-    }
+    float operator()(float a, float b, float) const { return sqr(a - b); }
 };
 
 struct RMSE
 {
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += sqr(a[i] - b[i]) / (sqr(a[i]) + 1e-3);
-        return error / count;
-    }
+    float operator()(float a, float b, float eps) const { return sqr(a - b) / (sqr(a) + eps); }
 };
 
 struct MAE
 {
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += std::fabs(sqr(a[i] - b[i]));
-        return error / count;
-    }
+    float operator()(float a, float b, float) const { return std::fabs(a - b); }
 };
 
 struct MAPE
 {
-    double operator()(const float* a, const float* b, size_t count) const
+    float operator()(float a, float b, float eps) const { return 100.f * std::fabs((a - b) / (a + eps)); }
+};
+
+template<typename Op, int ChannelCount>
+void channelErrorRow(const float* a, const float* b, float* errors, uint32_t width, float eps)
+{
+    Op op;
+    for (uint32_t x = 0; x < width; ++x)
     {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += std::fabs((a[i] - b[i]) / (a[i] + 1e-3));
-        return 100.0 * error / count;
+        float error = 0.f;
+        for (int c = 0; c < ChannelCount; ++c)
+            error += op(a[4 * x + c], b[4 * x + c], eps);
+        errors[x] = error * (1.f / ChannelCount);
     }
+}
+
+template<typename Op>
+void computeChannelErrorMap(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap)
+{
+    const uint32_t width = imageA.getWidth();
+    parallelForRows(
+        imageA.getHeight(), options.threadCount,
+        [&](uint32_t y)
+        {
+            size_t offset = size_t(y) * width;
+            const float* a = imageA.getData() + 4 * offset;
+            const float* b = imageB.getData() + 4 * offset;
+            if (options.alpha)
+                channelErrorRow<Op, 4>(a, b, errorMap + offset, width, options.epsilon);
+            else
+                channelErrorRow<Op, 3>(a, b, errorMap + offset, width, options.epsilon);
+        }
+    );
+}
+
+/**
+ * Separable convolution with clamp-to-edge addressing.
+ * The kernels have odd size, centered on the middle element.
+ */
+static void convolve(
+    const float* src,
+    float* dst,
+    uint32_t width,
+    uint32_t height,
+    const std::vector<float>& kernelX,
+    const std::vector<float>& kernelY,
+    uint32_t threadCount
+)
+{
+    const int rx = int(kernelX.size() / 2);
+    const int ry = int(kernelY.size() / 2);
+    Plane tmp(size_t(width) * height);
+
+    parallelForRows(
+        height, threadCount,
+        [&](uint32_t y)
+        {
+            const float* srcRow = src + size_t(y) * width;
+            float* tmpRow = tmp.data() + size_t(y) * width;
+            for (int x = 0; x < int(width); ++x)
+            {
+                float sum = 0.f;
+                for (int i = -rx; i <= rx; ++i)
+                    sum += kernelX[i + rx] * srcRow[clamp(x + i, 0, int(width) - 1)];
+                tmpRow[x] = sum;
+            }
+        }
+    );
+
+    parallelForRows(
+        height, threadCount,
+        [&](uint32_t y)
+        {
+            float* dstRow = dst + size_t(y) * width;
+            std::fill(dstRow, dstRow + width, 0.f);
+            for (int i = -ry; i <= ry; ++i)
+            {
+                const float* tmpRow = tmp.data() + size_t(clamp(int(y) + i, 0, int(height) - 1)) * width;
+                const float w = kernelY[i + ry];
+                for (uint32_t x = 0; x < width; ++x)
+                    dstRow[x] += w * tmpRow[x];
+            }
+        }
+    );
+}
+
+static std::vector<float> gaussianKernel(float sigma, int radius)
+{
+    std::vector<float> kernel(2 * radius + 1);
+    float sum = 0.f;
+    for (int i = -radius; i <= radius; ++i)
+        sum += kernel[i + radius] = std::exp(-float(i * i) / (2.f * sigma * sigma));
+    for (float& w : kernel)
+        w /= sum;
+    return kernel;
+}
+
+/**
+ * Structural dissimilarity, 1 - SSIM, computed on luminance with the standard 11x11 Gaussian window (sigma 1.5).
+ */
+static void computeSSIMErrorMap(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap)
+{
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+    const size_t pixelCount = size_t(width) * height;
+    const float kC1 = sqr(0.01f);
+    const float kC2 = sqr(0.03f);
+
+    // Luminance and second moments.
+    Plane a(pixelCount), b(pixelCount), aa(pixelCount), bb(pixelCount), ab(pixelCount);
+    parallelForRows(
+        height, options.threadCount,
+        [&](uint32_t y)
+        {
+            for (size_t i = size_t(y) * width; i < size_t(y + 1) * width; ++i)
+            {
+                const float* pa = imageA.getData() + 4 * i;
+                const float* pb = imageB.getData() + 4 * i;
+                a[i] = 0.2126f * pa[0] + 0.7152f * pa[1] + 0.0722f * pa[2];
+                b[i] = 0.2126f * pb[0] + 0.7152f * pb[1] + 0.0722f * pb[2];
+                aa[i] = a[i] * a[i];
+                bb[i] = b[i] * b[i];
+                ab[i] = a[i] * b[i];
+            }
+        }
+    );
+
+    const auto kernel = gaussianKernel(1.5f, 5);
+    for (Plane* plane : {&a, &b, &aa, &bb, &ab})
+        convolve(plane->data(), plane->data(), width, height, kernel, kernel, options.threadCount);
+
+    parallelForRows(
+        height, options.threadCount,
+        [&](uint32_t y)
+        {
+            for (size_t i = size_t(y) * width; i < size_t(y + 1) * width; ++i)
+            {
+                float varA = aa[i] - a[i] * a[i];
+                float varB = bb[i] - b[i] * b[i];
+                float covAB = ab[i] - a[i] * b[i];
+                float ssim = ((2.f * a[i] * b[i] + kC1) * (2.f * covAB + kC2)) / ((a[i] * a[i] + b[i] * b[i] + kC1) * (varA + varB + kC2));
+                errorMap[i] = 1.f - ssim;
+            }
+        }
+    );
+}
+
+/**
+ * FLIP-style perceptual error for LDR images, following "FLIP: A Difference Evaluator for Alternating Images"
+ * (Andersson et al. 2020). Colors are filtered with contrast sensitivity functions in the YyCxCz opponent space
+ * and compared with the HyAB distance in Hunt-adjusted L*a*b*, edge and point differences of the luminance
+ * are used to amplify the color error. Display encoded images are decoded from sRGB, linear images are clamped to [0,1].
+ */
+namespace flip
+{
+struct Color
+{
+    float x, y, z;
 };
 
-template<typename Metric>
-double compare(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
+// Linear sRGB <-> XYZ (D65).
+static Color linearRGBToXYZ(Color c)
 {
-    Metric metric;
-    double sum = 0.0;
-    const float* a = imageA.getData();
-    const float* b = imageB.getData();
-    size_t count = imageA.getWidth() * imageA.getHeight();
-    for (size_t i = 0; i < count; ++i)
+    return {
+        0.4124564f * c.x + 0.3575761f * c.y + 0.1804375f * c.z,
+        0.2126729f * c.x + 0.7151522f * c.y + 0.0721750f * c.z,
+        0.0193339f * c.x + 0.1191920f * c.y + 0.9503041f * c.z,
+    };
+}
+
+static Color XYZToLinearRGB(Color c)
+{
+    return {
+        3.2404542f * c.x - 1.5371385f * c.y - 0.4985314f * c.z,
+        -0.9692660f * c.x + 1.8760108f * c.y + 0.0415560f * c.z,
+        0.0556434f * c.x - 0.2040259f * c.y + 1.0572252f * c.z,
+    };
+}
+
+static const Color kWhite = linearRGBToXYZ({1.f, 1.f, 1.f});
+
+static Color XYZToYCxCz(Color c)
+{
+    float y = c.y / kWhite.y;
+    return {116.f * y - 16.f, 500.f * (c.x / kWhite.x - y), 200.f * (y - c.z / kWhite.z)};
+}
+
+static Color YCxCzToXYZ(Color c)
+{
+    float y = (c.x + 16.f) / 116.f;
+    return {(c.y / 500.f + y) * kWhite.x, y * kWhite.y, (y - c.z / 200.f) * kWhite.z};
+}
+
+static Color XYZToHuntLab(Color c)
+{
+    auto f = [](float t)
+    {
+        const float delta = 6.f / 29.f;
+        return t > delta * delta * delta ? std::cbrt(t) : t / (3.f * delta * delta) + 4.f / 29.f;
+    };
+    float fx = f(c.x / kWhite.x), fy = f(c.y / kWhite.y), fz = f(c.z / kWhite.z);
+    float L = 116.f * fy - 16.f;
+    return {L, 0.01f * L * 500.f * (fx - fy), 0.01f * L * 200.f * (fy - fz)};
+}
+
+static float HyAB(Color a, Color b)
+{
+    return std::fabs(a.x - b.x) + std::sqrt(sqr(a.y - b.y) + sqr(a.z - b.z));
+}
+
+static float sRGBToLinear(float v)
+{
+    return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+constexpr float kQc = 0.7f;
+constexpr float kPc = 0.4f;
+constexpr float kPt = 0.95f;
+constexpr float kQf = 0.5f;
+constexpr float kGw = 0.082f;
+
+/**
+ * Contrast sensitivity function of one opponent channel, a sum of up to two Gaussians in visual degrees.
+ */
+struct CSF
+{
+    float a1, b1, a2, b2;
+};
+static const CSF kCSF[3] = {
+    {1.f, 0.0047f, 0.f, 1e-5f},    // Achromatic
+    {1.f, 0.0053f, 0.f, 1e-5f},    // Red-green
+    {34.1f, 0.04f, 13.5f, 0.025f}, // Blue-yellow
+};
+
+/**
+ * Filter a YyCxCz channel with its CSF. The 2D kernel is normalized to unit sum, a sum of two Gaussians is
+ * filtered as two separable passes blended with their relative weights.
+ */
+static void filterChannel(Plane& plane, const CSF& csf, float ppd, uint32_t width, uint32_t height, uint32_t threadCount)
+{
+    const float kPi = 3.14159265358979f;
+    const int radius = int(std::ceil(3.f * std::sqrt(0.04f / (2.f * kPi * kPi)) * ppd));
+
+    auto kernel1D = [&](float a, float b, float& weight)
     {
-        double error = metric(a, b, alpha ? 4 : 3);
-        if (errorMap)
-            *errorMap++ = float(error);
-        sum += error;
-        a += 4;
-        b += 4;
+        std::vector<float> kernel(2 * radius + 1);
+        float sum = 0.f;
+        for (int i = -radius; i <= radius; ++i)
+        {
+            float x = float(i) / ppd;
+            sum += kernel[i + radius] = std::sqrt(kPi / b) * std::exp(-kPi * kPi * x * x / b);
+        }
+        for (float& w : kernel)
+            w /= sum;
+        weight = a * sum * sum;
+        return kernel;
+    };
+
+    float w1 = 0.f, w2 = 0.f;
+    auto kernel1 = kernel1D(csf.a1, csf.b1, w1);
+    if (csf.a2 == 0.f)
+    {
+        convolve(plane.data(), plane.data(), width, height, kernel1, kernel1, threadCount);
+        return;
+    }
+
+    auto kernel2 = kernel1D(csf.a2, csf.b2, w2);
+    Plane other = plane;
+    convolve(plane.data(), plane.data(), width, height, kernel1, kernel1, threadCount);
+    convolve(other.data(), other.data(), width, height, kernel2, kernel2, threadCount);
+    const float t = w2 / (w1 + w2);
+    for (size_t i = 0; i < plane.size(); ++i)
+        plane[i] = lerp(plane[i], other[i], t);
+}
+
+/**
+ * Edge and point feature magnitudes of a normalized luminance plane.
+ */
+static void computeFeatures(const Plane& luminance, Plane& edges, Plane& points, float ppd, uint32_t width, uint32_t height, uint32_t threadCount)
+{
+    const float sigma = 0.5f * kGw * ppd;
+    const int radius = int(std::ceil(3.f * sigma));
+
+    std::vector<float> g(2 * radius + 1), dg(2 * radius + 1), ddg(2 * radius + 1);
+    float gSum = 0.f;
+    for (int i = -radius; i <= radius; ++i)
+    {
+        float x = float(i);
+        float v = std::exp(-x * x / (2.f * sigma * sigma));
+        g[i + radius] = v;
+        dg[i + radius] = -x * v;
+        ddg[i + radius] = (x * x / (sigma * sigma) - 1.f) * v;
+        gSum += v;
+    }
+    for (float& w : g)
+        w /= gSum;
+
+    // Normalize so that the positive and negative weights sum to 1 and -1 respectively.
+    auto normalizeSigned = [](std::vector<float>& kernel)
+    {
+        float pos = 0.f, neg = 0.f;
+        for (float w : kernel)
+            (w > 0.f ? pos : neg) += w;
+        for (float& w : kernel)
+            w = w > 0.f ? w / pos : w / -neg;
+    };
+    normalizeSigned(dg);
+    normalizeSigned(ddg);
+
+    const size_t pixelCount = size_t(width) * height;
+    Plane ex(pixelCount), ey(pixelCount), px(pixelCount), py(pixelCount);
+    convolve(luminance.data(), ex.data(), width, height, dg, g, threadCount);
+    convolve(luminance.data(), ey.data(), width, height, g, dg, threadCount);
+    convolve(luminance.data(), px.data(), width, height, ddg, g, threadCount);
+    convolve(luminance.data(), py.data(), width, height, g, ddg, threadCount);
+
+    edges.resize(pixelCount);
+    points.resize(pixelCount);
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        edges[i] = std::sqrt(ex[i] * ex[i] + ey[i] * ey[i]);
+        points[i] = std::sqrt(px[i] * px[i] + py[i] * py[i]);
     }
-    return sum / count;
+}
+} // namespace flip
+
+static void computeFLIPErrorMap(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap)
+{
+    using namespace flip;
+
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+    const size_t pixelCount = size_t(width) * height;
+    const float ppd = options.pixelsPerDegree;
+
+    struct Planes
+    {
+        Plane channels[3];   // YyCxCz, filtered in place.
+        Plane luminance;     // Normalized achromatic channel, unfiltered.
+        Plane edges, points;
+    };
+
+    auto preprocess = [&](const Image& image, Planes& planes)
+    {
+        for (auto& channel : planes.channels)
+            channel.resize(pixelCount);
+        planes.luminance.resize(pixelCount);
+
+        parallelForRows(
+            height, options.threadCount,
+            [&](uint32_t y)
+            {
+                for (size_t i = size_t(y) * width; i < size_t(y + 1) * width; ++i)
+                {
+                    const float* p = image.getData() + 4 * i;
+                    Color rgb = {clamp(p[0], 0.f, 1.f), clamp(p[1], 0.f, 1.f), clamp(p[2], 0.f, 1.f)};
+                    if (!image.isLinear())
+                        rgb = {sRGBToLinear(rgb.x), sRGBToLinear(rgb.y), sRGBToLinear(rgb.z)};
+                    Color c = XYZToYCxCz(linearRGBToXYZ(rgb));
+                    planes.channels[0][i] = c.x;
+                    planes.channels[1][i] = c.y;
+                    planes.channels[2][i] = c.z;
+                    planes.luminance[i] = (c.x + 16.f) / 116.f;
+                }
+            }
+        );
+
+        for (int c = 0; c < 3; ++c)
+            filterChannel(planes.channels[c], kCSF[c], ppd, width, height, options.threadCount);
+        computeFeatures(planes.luminance, planes.edges, planes.points, ppd, width, height, options.threadCount);
+    };
+
+    Planes planesA, planesB;
+    preprocess(imageA, planesA);
+    preprocess(imageB, planesB);
+
+    auto toHuntLab = [](const Planes& planes, size_t i)
+    {
+        Color rgb = XYZToLinearRGB(YCxCzToXYZ({planes.channels[0][i], planes.channels[1][i], planes.channels[2][i]}));
+        rgb = {clamp(rgb.x, 0.f, 1.f), clamp(rgb.y, 0.f, 1.f), clamp(rgb.z, 0.f, 1.f)};
+        return XYZToHuntLab(linearRGBToXYZ(rgb));
+    };
+
+    const float cmax = std::pow(HyAB(XYZToHuntLab(linearRGBToXYZ({0.f, 1.f, 0.f})), XYZToHuntLab(linearRGBToXYZ({0.f, 0.f, 1.f}))), kQc);
+
+    parallelForRows(
+        height, options.threadCount,
+        [&](uint32_t y)
+        {
+            for (size_t i = size_t(y) * width; i < size_t(y + 1) * width; ++i)
+            {
+                // Color difference, compressed and remapped to [0,1].
+                float colorError = std::pow(HyAB(toHuntLab(planesA, i), toHuntLab(planesB, i)), kQc);
+                if (colorError < kPc * cmax)
+                    colorError *= kPt / (kPc * cmax);
+                else
+                    colorError = kPt + (colorError - kPc * cmax) / (cmax - kPc * cmax) * (1.f - kPt);
+
+                // Feature difference.
+                float featureDiff = std::max(std::fabs(planesA.edges[i] - planesB.edges[i]), std::fabs(planesA.points[i] - planesB.points[i]));
+                float featureError = std::pow(featureDiff / std::sqrt(2.f), kQf);
+
+                errorMap[i] = std::pow(colorError, 1.f - featureError);
+            }
+        }
+    );
 }
 
 struct ErrorMetric
 {
     std::string name;
     std::string desc;
-    std::function<double(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)> compare;
+    std::function<void(const Image& imageA, const Image& imageB, const CompareOptions& options, float* errorMap)> computeErrorMap;
 };
 
 static const std::vector<ErrorMetric> errorMetrics = {
-    {"mse", "Mean Squared Error", compare<MSE>},
-    {"rmse", "Relative Mean Squared Error", compare<RMSE>},
-    {"mae", "Mean Absolute Error", compare<MAE>},
-    {"mape", "Mean Absolute Percentage Error", compare<MAPE>},
+    {"mse", "Mean Squared Error", computeChannelErrorMap<MSE>},
+    {"rmse", "Relative Mean Squared Error (uses epsilon)", computeChannelErrorMap<RMSE>},
+    {"mae", "Mean Absolute Error", computeChannelErrorMap<MAE>},
+    {"mape", "Mean Absolute Percentage Error (uses epsilon)", computeChannelErrorMap<MAPE>},
+    {"ssim", "Structural Dissimilarity (1 - SSIM) of luminance", computeSSIMErrorMap},
+    {"flip", "FLIP perceptual error (uses pixels per degree)", computeFLIPErrorMap},
+};
+
+/**
+ * Mean error of a rectangular tile of the error map.
+ */
+struct TileError
+{
+    uint32_t x, y, width, height;
+    double error;
+};
+
+struct CompareResult
+{
+    double error = 0.0;              ///< Mean error over all pixels.
+    std::vector<TileError> tiles;    ///< Mean error per tile, in row-major tile order.
 };
 
-static Image::SharedPtr generateHeatMap(uint32_t width, uint32_t height, const float* errorMap)
+/**
+ * Reduce the error map per tile. Tiles are summed independently and then in a fixed order,
+ * so the result doesn't depend on the thread count.
+ */
+static CompareResult reduceErrorMap(const float* errorMap, uint32_t width, uint32_t height, uint32_t tileSize, uint32_t threadCount)
+{
+    CompareResult result;
+    const uint32_t tilesX = (width + tileSize - 1) / tileSize;
+    const uint32_t tilesY = (height + tileSize - 1) / tileSize;
+    result.tiles.resize(size_t(tilesX) * tilesY);
+
+    std::vector<double> sums(result.tiles.size());
+    parallelFor(
+        result.tiles.size(), threadCount,
+        [&](size_t index)
+        {
+            TileError& tile = result.tiles[index];
+            tile.x = uint32_t(index % tilesX) * tileSize;
+            tile.y = uint32_t(index / tilesX) * tileSize;
+            tile.width = std::min(tileSize, width - tile.x);
+            tile.height = std::min(tileSize, height - tile.y);
+
+            double sum = 0.0;
+            for (uint32_t y = tile.y; y < tile.y + tile.height; ++y)
+            {
+                const float* row = errorMap + size_t(y) * width + tile.x;
+                float rowSum = 0.f;
+                for (uint32_t x = 0; x < tile.width; ++x)
+                    rowSum += row[x];
+                sum += rowSum;
+            }
+            sums[index] = sum;
+            tile.error = sum / (double(tile.width) * tile.height);
+        }
+    );
+
+    double sum = 0.0;
+    for (double s : sums)
+        sum += s;
+    result.error = sum / (double(width) * height);
+    return result;
+}
+
+static Image::SharedPtr generateHeatMap(uint32_t width, uint32_t height, const float* errorMap, uint32_t threadCount)
 {
     auto writeColor = [](float t, float* dst)
     {
@@ -280,92 +794,373 @@ static Image::SharedPtr generateHeatMap(uint32_t width, uint32_t height, const f
         *dst++ = 1.f;
     };
 
-    const auto [minValue, maxValue] = std::minmax_element(errorMap, errorMap + width * height);
+    const size_t pixelCount = size_t(width) * height;
+    const auto [minValue, maxValue] = std::minmax_element(errorMap, errorMap + pixelCount);
     const float range = std::max(1e-5f, *maxValue - *minValue);
     auto image = Image::create(width, height);
-    float* dst = image->getData();
-    for (size_t i = 0; i < width * height; ++i)
+    parallelForRows(
+        height, threadCount,
+        [&](uint32_t y)
+        {
+            for (size_t i = size_t(y) * width; i < size_t(y + 1) * width; ++i)
+            {
+                float t = clamp((errorMap[i] - *minValue) / range, 0.f, 1.f);
+                writeColor(t, image->getData() + 4 * i);
+            }
+        }
+    );
+
+    return image;
+}
+
+static Image::SharedPtr loadImage(const std::filesystem::path& path, std::string& errorMessage)
+{
+    try
+    {
+        return Image::loadFromFile(path);
+    }
+    catch (const std::runtime_error& e)
     {
-        float t = clamp((errorMap[i] - *minValue) / range, 0.f, 1.f);
-        writeColor(t, dst);
-        dst += 4;
+        errorMessage = "Cannot load image from '" + path.string() + "' (Error: " + e.what() + ").";
+        return nullptr;
     }
+}
 
-    return image;
+static void saveImage(const Image& image, const std::filesystem::path& path)
+{
+    try
+    {
+        image.saveToFile(path);
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "Cannot save image to '" << path.string() << "' (Error: " << e.what() << ")." << std::endl;
+    }
 }
 
+/**
+ * Compare two images.
+ * @param[in] pathA First image.
+ * @param[in] pathB Second image.
+ * @param[in] metric Error metric.
+ * @param[in] options Comparison options.
+ * @param[in] tileSize Size of the tiles in the result, 0 to disable tile errors.
+ * @param[in] heatMapPath Path of the heat map to write, or empty.
+ * @param[out] result Comparison result.
+ * @param[out] errorMessage Error message if the comparison failed.
+ * @return True if the images were compared, false if they could not be loaded or have different resolutions.
+ */
 static bool compareImages(
     const std::filesystem::path& pathA,
     const std::filesystem::path& pathB,
-    ErrorMetric metric,
-    float threshold,
-    bool alpha,
-    const std::filesystem::path& heatMapPath
+    const ErrorMetric& metric,
+    const CompareOptions& options,
+    uint32_t tileSize,
+    const std::filesystem::path& heatMapPath,
+    CompareResult& result,
+    std::string& errorMessage
 )
 {
-    auto loadImage = [](const std::filesystem::path& path)
-    {
-        try
-        {
-            return Image::loadFromFile(path);
-        }
-        catch (const std::runtime_error& e)
-        {
-            std::cerr << "Cannot load image from '" << path.string() << "' (Error: " << e.what() << ")." << std::endl;
-            return Image::SharedPtr();
-        }
-    };
-
-    auto saveImage = [](const Image& image, const std::filesystem::path& path)
-    {
-        try
-        {
-            image.saveToFile(path);
-        }
-        catch (const std::runtime_error& e)
-        {
-            std::cerr << "Cannot save image to '" << path.string() << "' (Error: " << e.what() << ")." << std::endl;
-        }
-    };
-
     // Load images.
-    auto imageA = loadImage(pathA);
+    auto imageA = loadImage(pathA, errorMessage);
     if (!imageA)
         return false;
-    auto imageB = loadImage(pathB);
+    auto imageB = loadImage(pathB, errorMessage);
     if (!imageB)
         return false;
 
     // Check resolution.
     if (imageA->getWidth() != imageB->getWidth() || imageA->getHeight() != imageB->getHeight())
     {
-        std::cerr << "Cannot compare images with different resolutions." << std::endl;
+        errorMessage = "Cannot compare images with different resolutions.";
         return false;
     }
 
     uint32_t width = imageA->getWidth();
-    uint32_t height = imageB->getHeight();
+    uint32_t height = imageA->getHeight();
 
     // Compare images.
-    std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(width * height);
-    double error = metric.compare(*imageA, *imageB, alpha, errorMap.get());
+    std::vector<float> errorMap(size_t(width) * height);
+    metric.computeErrorMap(*imageA, *imageB, options, errorMap.data());
+    result = reduceErrorMap(errorMap.data(), width, height, tileSize > 0 ? tileSize : std::max(width, height), options.threadCount);
+    if (tileSize == 0)
+        result.tiles.clear();
 
     // Generate heat map.
-    if (errorMap)
+    if (!heatMapPath.empty())
     {
-        auto heatMap = generateHeatMap(width, height, errorMap.get());
+        auto heatMap = generateHeatMap(width, height, errorMap.data(), options.threadCount);
         saveImage(*heatMap, heatMapPath);
     }
 
-    std::cout << error << std::endl;
+    return true;
+}
 
-    // Treat nans and infs as errors.
-    if (std::isnan(error) || std::isinf(error))
-        return false;
+/// Treat nans and infs as errors.
+static bool isPassing(double error, float threshold)
+{
+    return !std::isnan(error) && !std::isinf(error) && error <= threshold;
+}
+
+static void writeTileErrors(const std::filesystem::path& path, const std::vector<TileError>& tiles)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        std::cerr << "Cannot write tile errors to '" << path.string() << "'." << std::endl;
+        return;
+    }
+    file << std::setprecision(9) << "x,y,width,height,error\n";
+    for (const auto& tile : tiles)
+        file << tile.x << "," << tile.y << "," << tile.width << "," << tile.height << "," << tile.error << "\n";
+}
+
+/**
+ * Batch comparison of two directory trees.
+ * Images are matched by their path relative to the root directories.
+ */
+namespace batch
+{
+static const std::set<std::string> kImageExtensions = {".png", ".jpg", ".jpeg", ".bmp", ".tga", ".exr", ".hdr", ".pfm", ".tif", ".tiff"};
+
+struct Entry
+{
+    std::string path;       ///< Path relative to the root directories.
+    std::string status;     ///< One of "passed", "failed", "missing" (no image in B), "extra" (no image in A) or "error".
+    double error = 0.0;
+    double maxTileError = 0.0;
+    std::string message;
+};
+
+static bool endsWith(const std::string& str, const std::string& suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static std::set<std::string> collectImages(const std::filesystem::path& root, const std::string& excludeSuffix)
+{
+    std::set<std::string> images;
+    for (const auto& it : std::filesystem::recursive_directory_iterator(root))
+    {
+        if (!it.is_regular_file())
+            continue;
+        std::string ext = it.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) { return (char)std::tolower(c); });
+        if (kImageExtensions.count(ext) == 0)
+            continue;
+        std::string relPath = std::filesystem::relative(it.path(), root).generic_string();
+        if (!excludeSuffix.empty() && endsWith(relPath, excludeSuffix))
+            continue;
+        images.insert(relPath);
+    }
+    return images;
+}
+
+static std::string escapeJson(const std::string& str)
+{
+    std::string result;
+    for (char c : str)
+    {
+        switch (c)
+        {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\b':
+            result += "\\b";
+            break;
+        case '\f':
+            result += "\\f";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if ((unsigned char)c < 0x20)
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned int)(unsigned char)c);
+                result += buf;
+            }
+            else
+            {
+                result += c;
+            }
+        }
+    }
+    return result;
+}
+
+/// Quote a CSV field, doubling embedded quotes.
+static std::string escapeCsv(const std::string& str)
+{
+    std::string result = "\"";
+    for (char c : str)
+    {
+        if (c == '"')
+            result += '"';
+        result += c;
+    }
+    return result + "\"";
+}
+
+static std::string formatNumber(double value)
+{
+    if (std::isnan(value) || std::isinf(value))
+        return "null";
+    std::ostringstream ss;
+    ss << std::setprecision(9) << value;
+    return ss.str();
+}
+
+static void writeReport(
+    const std::filesystem::path& path,
+    const std::vector<Entry>& entries,
+    const ErrorMetric& metric,
+    float threshold
+)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        std::cerr << "Cannot write report to '" << path.string() << "'." << std::endl;
+        return;
+    }
 
-    return error <= threshold;
+    if (path.extension() == ".csv")
+    {
+        file << "path,status,error,maxTileError,message\n";
+        for (const auto& entry : entries)
+            file << escapeCsv(entry.path) << "," << entry.status << "," << formatNumber(entry.error) << ","
+                 << formatNumber(entry.maxTileError) << "," << escapeCsv(entry.message) << "\n";
+        return;
+    }
+
+    std::map<std::string, size_t> counts = {{"passed", 0}, {"failed", 0}, {"missing", 0}, {"extra", 0}, {"error", 0}};
+    for (const auto& entry : entries)
+        counts[entry.status]++;
+
+    file << "{\n";
+    file << "  \"metric\": \"" << metric.name << "\",\n";
+    file << "  \"threshold\": " << formatNumber(threshold) << ",\n";
+    file << "  \"summary\": {\"total\": " << entries.size();
+    for (const auto& [status, count] : counts)
+        file << ", \"" << status << "\": " << count;
+    file << "},\n";
+    file << "  \"images\": [";
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries[i];
+        file << (i > 0 ? ",\n" : "\n") << "    {\"path\": \"" << escapeJson(entry.path) << "\", \"status\": \"" << entry.status
+             << "\", \"error\": " << formatNumber(entry.error) << ", \"maxTileError\": " << formatNumber(entry.maxTileError)
+             << ", \"message\": \"" << escapeJson(entry.message) << "\"}";
+    }
+    file << "\n  ]\n}\n";
 }
 
+/**
+ * Compare all images in two directory trees. Images are compared in parallel. The thread count in the options is the total budget,
+ * threads left over when there are fewer images than threads are used within the comparisons.
+ * @return True if all images exist in both trees and pass.
+ */
+static bool compareDirectories(
+    const std::filesystem::path& dirA,
+    const std::filesystem::path& dirB,
+    const ErrorMetric& metric,
+    const CompareOptions& options,
+    float threshold,
+    uint32_t tileSize,
+    const std::string& heatMapSuffix,
+    const std::filesystem::path& reportPath
+)
+{
+    // Remove the report of a previous run, so that it isn't mistaken for the result of this run if we fail before writing it.
+    if (!reportPath.empty())
+    {
+        std::error_code ec;
+        std::filesystem::remove(reportPath, ec);
+    }
+
+    for (const auto& dir : {dirA, dirB})
+    {
+        if (!std::filesystem::is_directory(dir))
+        {
+            std::cerr << "Directory '" << dir.string() << "' does not exist." << std::endl;
+            return false;
+        }
+    }
+
+    auto imagesA = collectImages(dirA, heatMapSuffix);
+    auto imagesB = collectImages(dirB, heatMapSuffix);
+
+    std::vector<Entry> entries;
+    for (const auto& path : imagesA)
+        entries.push_back({path, imagesB.count(path) ? "" : "missing"});
+    for (const auto& path : imagesB)
+        if (!imagesA.count(path))
+            entries.push_back({path, "extra"});
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.path < b.path; });
+
+    // Split the thread budget between images and the work within each image, so that the total doesn't exceed it.
+    size_t compareCount = std::count_if(entries.begin(), entries.end(), [](const Entry& entry) { return entry.status.empty(); });
+    uint32_t imageThreadCount = (uint32_t)std::max<size_t>(1, std::min<size_t>(options.threadCount, compareCount));
+    CompareOptions imageOptions = options;
+    imageOptions.threadCount = std::max(1u, options.threadCount / imageThreadCount);
+
+    parallelFor(
+        entries.size(), imageThreadCount,
+        [&](size_t index)
+        {
+            Entry& entry = entries[index];
+            if (!entry.status.empty())
+                return;
+
+            std::filesystem::path heatMapPath;
+            if (!heatMapSuffix.empty())
+                heatMapPath = (dirB / entry.path).string() + heatMapSuffix;
+
+            CompareResult result;
+            if (!compareImages(dirA / entry.path, dirB / entry.path, metric, imageOptions, tileSize, heatMapPath, result, entry.message))
+            {
+                entry.status = "error";
+                return;
+            }
+
+            entry.error = result.error;
+            for (const auto& tile : result.tiles)
+                entry.maxTileError = std::max(entry.maxTileError, tile.error);
+            entry.status = isPassing(result.error, threshold) ? "passed" : "failed";
+        }
+    );
+
+    bool success = true;
+    for (const auto& entry : entries)
+    {
+        std::cout << entry.status << " " << entry.path;
+        if (entry.status == "passed" || entry.status == "failed")
+            std::cout << " " << entry.error;
+        if (!entry.message.empty())
+            std::cout << " (" << entry.message << ")";
+        std::cout << std::endl;
+        success &= entry.status == "passed";
+    }
+
+    if (!reportPath.empty())
+        writeReport(reportPath, entries, metric, threshold);
+
+    return success;
+}
+} // namespace batch
+
 static void printMetrics(std::ostream& stream = std::cout)
 {
     stream << "Available error metrics:" << std::endl;
@@ -385,6 +1180,17 @@ int main(int argc, char** argv)
     args::ValueFlag<float> thresholdFlag(parser, "threshold", "The error threshold.", {'t'});
     args::Flag alphaFlag(parser, "", "Include alpha channel.", {'a'});
     args::ValueFlag<std::string> heatMapFlag(parser, "filename", "Generate error heat map.", {'e'});
+    args::ValueFlag<float> epsilonFlag(parser, "epsilon", "Epsilon used by the relative error metrics (default 1e-3).", {"epsilon"});
+    args::ValueFlag<float> ppdFlag(parser, "ppd", "Pixels per degree of visual angle used by the FLIP metric (default 67).", {"ppd"});
+    args::ValueFlag<uint32_t> threadsFlag(parser, "count", "Number of threads (default 0 uses all hardware threads).", {'j', "threads"});
+    args::ValueFlag<uint32_t> tileSizeFlag(parser, "size", "Tile size used for tile errors (default 64).", {"tile-size"});
+    args::ValueFlag<std::string> tileErrorsFlag(parser, "filename", "Write per-tile errors to a CSV file.", {"tile-errors"});
+    args::Flag batchFlag(parser, "", "Compare all images in two directories (image1 and image2 are directories).", {"batch"});
+    args::ValueFlag<std::string> reportFlag(parser, "filename", "Write a batch report (.json or .csv).", {"report"});
+    args::ValueFlag<std::string> heatMapSuffixFlag(
+        parser, "suffix", "Generate heat maps in batch mode, named after the second image with this suffix appended. Files with the suffix are not compared.",
+        {"heat-map-suffix"}
+    );
     args::Positional<std::string> image1(parser, "image1", "The first image.", args::Options::Required);
     args::Positional<std::string> image2(parser, "image2", "The second image.", args::Options::Required);
     args::CompletionFlag completionFlag(parser, {"complete"});
@@ -437,9 +1243,42 @@ int main(int argc, char** argv)
         metric = *it;
     }
 
-    bool success = compareImages(
-        args::get(image1), args::get(image2), metric, thresholdFlag ? args::get(thresholdFlag) : 0.f,
-        alphaFlag ? args::get(alphaFlag) : false, heatMapFlag ? args::get(heatMapFlag) : ""
-    );
-    return success ? 0 : 1;
+    CompareOptions options;
+    options.alpha = alphaFlag ? args::get(alphaFlag) : false;
+    if (epsilonFlag)
+        options.epsilon = args::get(epsilonFlag);
+    if (ppdFlag)
+        options.pixelsPerDegree = args::get(ppdFlag);
+    uint32_t threadCount = threadsFlag ? args::get(threadsFlag) : 0;
+    options.threadCount = threadCount > 0 ? threadCount : getDefaultThreadCount();
+
+    float threshold = thresholdFlag ? args::get(thresholdFlag) : 0.f;
+    uint32_t tileSize = tileSizeFlag ? std::max(1u, args::get(tileSizeFlag)) : 64;
+
+    if (batchFlag)
+    {
+        bool success = batch::compareDirectories(
+            args::get(image1), args::get(image2), metric, options, threshold, tileSize,
+            heatMapSuffixFlag ? args::get(heatMapSuffixFlag) : "", reportFlag ? args::get(reportFlag) : ""
+        );
+        return success ? 0 : 1;
+    }
+
+    CompareResult result;
+    std::string errorMessage;
+    if (!compareImages(
+            args::get(image1), args::get(image2), metric, options, tileErrorsFlag ? tileSize : 0, heatMapFlag ? args::get(heatMapFlag) : "",
+            result, errorMessage
+        ))
+    {
+        std::cerr << errorMessage << std::endl;
+        return 1;
+    }
+
+    if (tileErrorsFlag)
+        writeTileErrors(args::get(tileErrorsFlag), result.tiles);
+
+    std::cout << result.error << std::endl;
+
+    return isPassing(result.error, threshold) ? 0 : 1;
 }
@@ -0,0 +1,89 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Utils/Color/SpectralTableLibrary.h"
+#include "Core/Errors.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <args.hxx>
+
+#include <iostream>
+#include <string>
+
+using namespace Falcor;
+
+int main(int argc, char** argv)
+{
+    args::ArgumentParser parser("Utility to compile spectral tables (.spd files) into a binary archive.");
+    parser.helpParams.programName = "SpectralTableCompiler";
+    args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
+    args::Positional<std::string> tablesDirectory(
+        parser, "tables", "Directory containing the spectral tables (default: the shipped tables directory)."
+    );
+    args::Positional<std::string> archivePath(parser, "archive", "Output archive (default: <runtime>/data/spectra.bin).");
+    args::CompletionFlag completionFlag(parser, {"complete"});
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Completion& e)
+    {
+        std::cout << e.what();
+        return 0;
+    }
+    catch (const args::Help&)
+    {
+        std::cout << parser;
+        return 0;
+    }
+    catch (const args::ParseError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::filesystem::path tables = tablesDirectory ? std::filesystem::path(args::get(tablesDirectory))
+                                                   : SpectralTableLibrary::getDefaultTablesDirectory();
+    std::filesystem::path archive =
+        archivePath ? std::filesystem::path(args::get(archivePath)) : SpectralTableLibrary::getDefaultArchivePath();
+
+    try
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        size_t count = SpectralTableLibrary::compile(tables, archive);
+        double duration = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        std::cout << "Compiled " << count << " spectral tables into '" << archive.string() << "' in " << duration << " ms." << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
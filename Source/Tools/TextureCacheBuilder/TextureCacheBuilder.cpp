@@ -0,0 +1,179 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Utils/Image/TextureCache.h"
+#include "Core/Errors.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Threading.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <args.hxx>
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace Falcor;
+
+namespace
+{
+const std::vector<std::string> kImageExtensions = {"png", "jpg", "jpeg", "tga", "bmp", "exr", "hdr", "tif", "tiff", "pfm", "psd"};
+
+bool isImageFile(const std::filesystem::path& path)
+{
+    for (const auto& ext : kImageExtensions)
+    {
+        if (hasExtension(path, ext))
+            return true;
+    }
+    return false;
+}
+
+/// Collect all image files from a list of files and directories. Directories are searched recursively.
+std::vector<std::filesystem::path> collectImageFiles(const std::vector<std::string>& inputs)
+{
+    std::vector<std::filesystem::path> paths;
+    for (const auto& input : inputs)
+    {
+        std::filesystem::path path(input);
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file() && isImageFile(entry.path()))
+                    paths.push_back(std::filesystem::canonical(entry.path()));
+            }
+        }
+        else if (std::filesystem::is_regular_file(path))
+        {
+            paths.push_back(std::filesystem::canonical(path));
+        }
+        else
+        {
+            throw RuntimeError("Can't find '{}'.", path);
+        }
+    }
+    return paths;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    args::ArgumentParser parser("Utility to populate the cache of preprocessed textures used by the texture manager.");
+    parser.helpParams.programName = "TextureCacheBuilder";
+    args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
+    args::ValueFlag<std::string> cacheFlag(parser, "directory", "Cache directory (default: the default texture cache directory).", {'c', "cache"});
+    args::Flag noCompressFlag(parser, "no-compress", "Store textures uncompressed.", {"no-compress"});
+    args::Flag compactColorFlag(parser, "compact-color", "Use BC1 instead of BC7 for opaque color textures.", {"compact-color"});
+    args::Flag noMipsFlag(parser, "no-mips", "Don't bake mips. Textures are loaded with mips by default, so this is rarely useful.", {"no-mips"});
+    args::ValueFlag<uint32_t> threadsFlag(parser, "threads", "Number of worker threads (default: hardware concurrency).", {'j', "threads"}, 0);
+    args::PositionalList<std::string> inputsList(parser, "inputs", "Texture files or directories to search for texture files.");
+    args::CompletionFlag completionFlag(parser, {"complete"});
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Completion& e)
+    {
+        std::cout << e.what();
+        return 0;
+    }
+    catch (const args::Help&)
+    {
+        std::cout << parser;
+        return 0;
+    }
+    catch (const args::ParseError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    if (!inputsList)
+    {
+        std::cerr << "No inputs specified." << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    TextureCache::Settings settings;
+    settings.compress = !noCompressFlag;
+    settings.compactColor = compactColorFlag;
+    const bool generateMipLevels = !noMipsFlag;
+
+    try
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+
+        std::filesystem::path directory = cacheFlag ? std::filesystem::path(args::get(cacheFlag)) : TextureCache::getDefaultDirectory();
+        auto pTextureCache = TextureCache::create(directory, settings);
+        auto paths = collectImageFiles(args::get(inputsList));
+
+        Threading::start(args::get(threadsFlag));
+
+        std::atomic<size_t> failedCount = 0;
+        std::atomic<size_t> skippedCount = 0;
+        std::mutex outputMutex;
+        Threading::parallelFor(
+            0, paths.size(),
+            [&](size_t i)
+            {
+                try
+                {
+                    if (pTextureCache->addTexture(paths[i], generateMipLevels).empty())
+                    {
+                        skippedCount++;
+                        std::lock_guard<std::mutex> lock(outputMutex);
+                        std::cout << "Skipping '" << paths[i].string() << "': Two channel images are only cached when block compressed."
+                                  << std::endl;
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    failedCount++;
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::cerr << "Skipping '" << paths[i].string() << "': " << e.what() << std::endl;
+                }
+            },
+            1
+        );
+        Threading::shutdown();
+
+        double duration = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        std::cout << "Cached " << (paths.size() - failedCount - skippedCount) << " of " << paths.size() << " textures in '"
+                  << directory.string() << "' in " << duration << " ms." << std::endl;
+        return failedCount > 0 ? 1 : 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
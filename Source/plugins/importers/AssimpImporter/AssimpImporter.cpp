@@ -30,7 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/FalcorMath.h"
@@ -44,7 +44,6 @@
 #include <assimp/scene.h>
 #include <assimp/pbrmaterial.h>
 
-#include <execution>
 #include <fstream>
 
 namespace Falcor
@@ -550,9 +549,8 @@ void createMeshes(ImporterData& data)
 
     // Pre-process meshes.
     std::vector<SceneBuilder::ProcessedMesh> processedMeshes(meshes.size());
-    auto range = NumericRange<size_t>(0, meshes.size());
-    std::for_each(
-        std::execution::par, range.begin(), range.end(),
+    Threading::parallelFor(
+        0, meshes.size(),
         [&](size_t i)
         {
             const aiMesh* pAiMesh = meshes[i];
@@ -614,7 +612,8 @@ void createMeshes(ImporterData& data)
             mesh.pMaterial = data.materialMap.at(pAiMesh->mMaterialIndex);
 
             processedMeshes[i] = data.builder.processMesh(mesh);
-        }
+        },
+        1
     );
 
     // Add meshes to the scene.
@@ -231,6 +231,7 @@ namespace Falcor
                 if (props.hasString("wrap_mode")) ctx.unsupportedParameter("wrap_mode");
 
                 texture.pTexture = Texture::createFromFile(ctx.builder.getDevice().get(), filename, true, !raw);
+                ctx.builder.addDependency(filename);
                 texture.transform = toUV;
             }
             else if (inst.type == "checkerboard")
@@ -595,6 +596,7 @@ namespace Falcor
                 if (props.hasBool("face_normals")) ctx.unsupportedParameter("face_normals");
 
                 shape.pMesh = TriangleMesh::createFromFile(filename, !faceNormals);
+                ctx.builder.addDependency(filename);
                 if (shape.pMesh) shape.pMesh->setName(inst.id);
                 if (shape.pMesh && !flipTexCoords) shape.pMesh->flipTexCoords();
                 shape.transform = toWorld;
@@ -610,6 +612,7 @@ namespace Falcor
                 // if (props.hasBool("face_normals")) ctx.unsupportedParameter("face_normals");
 
                 shape.pMesh = TriangleMesh::createFromFile(filename, !faceNormals);
+                ctx.builder.addDependency(filename);
                 if (shape.pMesh) shape.pMesh->setName(inst.id);
                 if (shape.pMesh && flipTexCoords) shape.pMesh->flipTexCoords();
                 shape.transform = toWorld;
@@ -677,6 +680,7 @@ namespace Falcor
             {
                 float radius = props.getFloat("radius", 0.025f);
                 shape.pHair = Hair::createFromFile(props.getString("filename"), radius);
+                ctx.builder.addDependency(props.getString("filename"));
 
                 if (props.hasFloat("angle_threshold")) ctx.unsupportedParameter("angle_threshold");
                 if (props.hasFloat("reduction")) ctx.unsupportedParameter("reduction");
@@ -718,6 +718,7 @@ Light createLight(BuilderContext& ctx, const LightSceneEntity& entity)
         {
             auto path = ctx.resolver(filename);
             auto pOctTexture = Falcor::Texture::createFromFile(ctx.builder.getDevice().get(), path, false, false);
+            ctx.builder.addDependency(path);
             // TODO: Use equal-area octahedral parametrization when env map supports it.
             logWarning(
                 entity.loc,
@@ -816,6 +817,7 @@ FloatTexture createFloatTexture(BuilderContext& ctx, const TextureSceneEntity& e
         bool sRGB = encoding == "sRGB";
 
         floatTexture.texture = Falcor::Texture::createFromFile(ctx.builder.getDevice().get(), path, generateMips, sRGB);
+        ctx.builder.addDependency(path);
     }
     else if (type == "checkerboard")
     {
@@ -933,6 +935,7 @@ SpectrumTexture createSpectrumTexture(BuilderContext& ctx, const TextureSceneEnt
         bool sRGB = encoding == "sRGB";
 
         spectrumTexture.texture = Falcor::Texture::createFromFile(ctx.builder.getDevice().get(), path, generateMips, sRGB);
+        ctx.builder.addDependency(path);
     }
     else if (type == "checkerboard")
     {
@@ -1248,6 +1251,7 @@ Falcor::Material::SharedPtr createMaterial(BuilderContext& ctx, const MaterialSc
         if (!normalmap.empty())
         {
             auto pNormalMap = Texture::createFromFile(ctx.builder.getDevice().get(), ctx.resolver(normalmap), true, false);
+            ctx.builder.addDependency(ctx.resolver(normalmap));
             pMaterial->setTexture(Material::TextureSlot::Normal, pNormalMap);
         }
     }
@@ -1498,6 +1502,7 @@ Shape createShape(BuilderContext& ctx, const ShapeSceneEntity& entity)
         auto path = ctx.resolver(filename);
 
         shape.pTriangleMesh = Falcor::TriangleMesh::createFromFile(path.string());
+        ctx.builder.addDependency(path);
         if (shape.pTriangleMesh)
             shape.pTriangleMesh->setName(filename);
         shape.transform = entity.transform;
@@ -1809,6 +1814,7 @@ void PBRTImporter::importScene(const std::filesystem::path& path, SceneBuilder&
         pbrt::BasicScene pbrtScene(path.parent_path());
         pbrt::BasicSceneBuilder pbrtBuilder(pbrtScene);
         pbrt::parseFile(pbrtBuilder, path);
+        for (const auto& includedFile : pbrtScene.getIncludedFiles()) builder.addDependency(includedFile);
         timeReport.measure("Parsing pbrt scene");
 
         pbrt::BuilderContext ctx{pbrtScene, builder};
@@ -633,6 +633,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 std::string filename = toString(dequoteString(filenameToken));
                 auto path = searchPath / filename;
                 std::unique_ptr<Tokenizer> includeTokenizer = Tokenizer::createFromFile(path);
+                target.onInclude(path, tok->loc);
                 logInfo("PBRTImporter: Started parsing '{}'.", includeTokenizer->getPath().string());
                 fileStack.push_back(std::move(includeTokenizer));
             }
@@ -28,7 +28,7 @@
 #include "ImporterContext.h"
 #include "USDHelpers.h"
 #include "Core/API/Device.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include "Scene/Importer.h"
 #include "Scene/Curves/CurveConfig.h"
 #include "Utils/Color/SpectrumUtils.h"
@@ -1184,13 +1184,12 @@ namespace Falcor
         void addMeshesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected mesh tasks.
-            NumericRange<size_t> meshRange(0, ctx.meshTasks.size());
-            std::for_each(std::execution::par, meshRange.begin(), meshRange.end(),
+            Threading::parallelFor(0, ctx.meshTasks.size(),
                 [&](size_t i)
                 {
                     FALCOR_ASSERT(ctx.meshTasks[i].sampleIdx == 0);
                     processMesh(ctx.meshes[ctx.meshTasks[i].meshId], ctx);
-                }
+                }, 1
             );
 
             // Add processed meshes to scene builder.
@@ -1220,13 +1219,12 @@ namespace Falcor
                 }
 
                 // Process time-sampled mesh keyframes
-                NumericRange<size_t> keyframeRange(0, ctx.meshKeyframeTasks.size());
-                std::for_each(std::execution::par, keyframeRange.begin(), keyframeRange.end(),
+                Threading::parallelFor(0, ctx.meshKeyframeTasks.size(),
                     [&](size_t i)
                     {
                         auto& task = ctx.meshKeyframeTasks[i];
                         processMeshKeyframe(ctx.meshes[task.meshId], task.meshId, task.sampleIdx, ctx);
-                    }
+                    }, 1
                 );
 
                 // Gather keyframe data from all meshes
@@ -1375,9 +1373,8 @@ namespace Falcor
         void addCurvesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected curves.
-            NumericRange<size_t> range(0, ctx.curves.size());
-            std::for_each(std::execution::par, range.begin(), range.end(),
-                [&](size_t i) { processCurve(ctx.curves[i], ctx); }
+            Threading::parallelFor(0, ctx.curves.size(),
+                [&](size_t i) { processCurve(ctx.curves[i], ctx); }, 1
             );
 
             // Add processed curves or meshes (of the first keyframe) to scene builder.
@@ -1895,12 +1892,13 @@ namespace Falcor
                 break;
             }
 
-            NumericRange<size_t> range(0, indexData.size());
-            std::for_each(std::execution::par, range.begin(), range.end(),
-                [&](size_t j)
+            isSameTopology = Threading::parallelReduce(0, indexData.size(), true,
+                [&](size_t begin, size_t end, bool same)
                 {
-                    isSameTopology |= (indexData[j] == refIndexData[j]);
-                }
+                    for (size_t j = begin; j < end && same; ++j) same = (indexData[j] == refIndexData[j]);
+                    return same;
+                },
+                [](bool a, bool b) { return a && b; }
             );
             if (!isSameTopology) break;
         }
@@ -50,7 +50,6 @@ END_DISABLE_USD_WARNINGS
 
 #include <glm/gtx/euler_angles.hpp>
 
-#include <execution>
 #include <filesystem>
 #include <limits>
 #include <memory>
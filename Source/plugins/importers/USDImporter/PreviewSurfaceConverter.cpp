@@ -740,9 +740,11 @@ Texture::SharedPtr PreviewSurfaceConverter::loadTexture(const StandardMaterialSp
             }
             {
                 std::scoped_lock lock(mMutex);
-                return Texture::create2D(
+                auto pTexture = Texture::create2D(
                     mpDevice.get(), pBitmap->getWidth(), pBitmap->getHeight(), format, 1, Texture::kMaxPossible, pBitmap->getData()
                 );
+                pTexture->setSourcePath(ci.texturePath);
+                return pTexture;
             }
         }
     }
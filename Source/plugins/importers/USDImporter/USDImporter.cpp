@@ -324,6 +324,12 @@ namespace Falcor
 
         timeReport.measure("Open stage");
 
+        // Register all layers used by the stage as scene dependencies.
+        for (const auto& layer : pStage->GetUsedLayers())
+        {
+            if (!layer->IsAnonymous() && !layer->GetRealPath().empty()) builder.addDependency(layer->GetRealPath());
+        }
+
         ImporterContext ctx(path, pStage, builder, dict, timeReport);
 
         // Falcor uses meter scene unit; scale if necessary. Note that Omniverse uses cm by default.
@@ -259,32 +259,47 @@ class Test:
         messages = []
         image_reports = []
 
-        # Compare every result image with the corresponding reference image and report missing references.
-        processes = {}
+        # Report result images with no corresponding reference image.
         for image in result_images:
             if not image in ref_images:
                 result = Test.Result.FAILED
                 messages.append(f'Test has generated image "{image}" with no corresponding reference image.')
-                continue
-
-            ref_file = ref_dir / image
-            result_file = result_dir / image
-            error_file = result_dir / (str(image) + config.ERROR_IMAGE_SUFFIX)
 
-            args = [str(image_compare_exe), '-m', 'mse', '-t', str(self.tolerance), str(ref_file), str(result_file)]
-            if error_file:
-                args += ['-e', str(error_file)]
-            processes[image] = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
-            if not self.process_controller.add_process(self.name + ":image:" + str(image), processes[image]):
-                return Test.Result.FAILED, ['Process killed due to global exit']
+        # Compare all result images with the corresponding reference images using a single ImageCompare process.
+        # Remove the report of a previous run, so that a failing ImageCompare doesn't leave it to be read as the result.
+        report_file = result_dir / 'image_compare.json'
+        report_file.unlink(missing_ok=True)
+        # Tests are compared in parallel, so each ImageCompare process gets its share of the hardware threads.
+        thread_count = max(1, multiprocessing.cpu_count() // self.process_controller.thread_count)
+        args = [
+            str(image_compare_exe), '-m', 'mse', '-t', str(self.tolerance), '-j', str(thread_count),
+            '--batch', '--report', str(report_file), '--heat-map-suffix', config.ERROR_IMAGE_SUFFIX,
+            str(ref_dir), str(result_dir)
+        ]
+        process = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        if not self.process_controller.add_process(self.name + ":compare", process):
+            return Test.Result.FAILED, ['Process killed due to global exit'], []
+        output = process.communicate()[0]
 
-        for image, process in processes.items():
+        try:
+            with open(report_file) as f:
+                compare_report = json.load(f)
+        except (OSError, ValueError):
+            errors = list(map(lambda l: l.rstrip(), output.decode('utf-8').splitlines()))
+            return Test.Result.FAILED, errors + [f'{image_compare_exe} did not write a report.'], []
+
+        for entry in compare_report['images']:
+            image = Path(entry['path'])
+            if not (image in ref_images and image in result_images):
+                continue
 
-            output = process.communicate()[0]
-            compare_success =  process.returncode == 0
-            compare_error = float(output.strip())
+            compare_success = entry['status'] == 'passed'
+            compare_error = entry['error'] if entry['error'] is not None else float('nan')
 
-            if not compare_success:
+            if entry['status'] == 'error':
+                result = Test.Result.FAILED
+                messages.append(f'Test image "{image}" could not be compared ({entry["message"]}).')
+            elif not compare_success:
                 result = Test.Result.FAILED
                 messages.append(f'Test image "{image}" failed with error {compare_error}.')
 